@@ -73,8 +73,8 @@
 /*******************************************************************************
 *                             LOCAL GLOBAL VARIABLES
 *******************************************************************************/
-unsigned char testString1[] = "Welcome to";
-unsigned char testString2[] = "Arizona!";
+const HD44780_ROM unsigned char testString1[] = "Welcome to";
+const HD44780_ROM unsigned char testString2[] = "Arizona!";
 
 
 /*******************************************************************************
@@ -124,8 +124,10 @@ void main (void)
     LCDIFOBJ            lcdIfOffBoardObj;
     unsigned char       readData=0;
     unsigned char       readAddress=0;
-    unsigned char       returnValue;
-    unsigned char     * pString;
+    HD44780INIT         initTable[2];
+    unsigned int        initWait;
+    unsigned char       counter;
+    const HD44780_ROM unsigned char * pString;
     
                                         /* Init modules                       */
     lcdifInit();
@@ -198,6 +200,9 @@ void main (void)
     lcdIfFuncPointers.pWriteInstr = lcdifWriteInstruction;
     lcdIfFuncPointers.pReadAddr = lcdifReadAddress;
     lcdIfFuncPointers.p4BitFunctionSet = lcdif4BitFunctionSet;
+    lcdIfFuncPointers.pWriteDataBlock = lcdifWriteDataBlock;
+    lcdIfFuncPointers.pWriteInstrBlock = lcdifWriteInstructionBlock;
+    lcdIfFuncPointers.pReadDataBlock = lcdifReadDataBlock;
 
                                         /* Create an HD44780 display object   */
                                         /* for the on-board LCD module        */
@@ -212,38 +217,36 @@ void main (void)
                                                            &hd44780ObjOffBoard);
                                         /* Open the off-board HD44780 object  */
     hHd44780OffBoard = hd44780Open(hd44780OffBoardNum);
+                                        /* Off-board LCD is a 16x2 display    */
+    hd44780AttachGeometry(hHd44780OffBoard, &hd44780Geometry16x2);
     
-                                        /* Perform software init of on-board  */
-                                        /* LCD display                        */
-    do
+                                        /* Perform software init of both LCD  */
+                                        /* displays together, so that their   */
+                                        /* power on waits overlap             */
+    initTable[0].hHd44780 = hHd44780OnBoard;
+    initTable[0].hd44780Clone = HD44780U;
+    initTable[1].hHd44780 = hHd44780OffBoard;
+    initTable[1].hd44780Clone = KS0066U;
+    for (counter = 0; counter < 2; counter++)
     {
-        returnValue = hd44780InstructionInit(hHd44780OnBoard, HD44780U, 
-                                             FS_5X8DOTS & FS_2LINE,
-                                             DOFC_BLINKINGOFF & DOFC_CURSOROFF & 
-                                             DOFC_DISPLAYOFF,
-                                             EMS_CURSORMOVE & EMS_INCREMENT);
-        if (returnValue > 1)
-        {
-            wait(returnValue);
-        }    
-    }    
-    while (returnValue != 0);    
+        initTable[counter].functionSet = FS_5X8DOTS & FS_2LINE;
+        initTable[counter].displayOnOffControl = DOFC_BLINKINGOFF & 
+                                                 DOFC_CURSOROFF & 
+                                                 DOFC_DISPLAYOFF;
+        initTable[counter].entryModeSet = EMS_CURSORMOVE & EMS_INCREMENT;
+        initTable[counter].initDone = 0;
+        initTable[counter].waitTime = 0;
+    }
 
-                                        /* Perform software init of off-board */
-                                        /* LCD display                        */
     do
     {
-        returnValue = hd44780InstructionInit(hHd44780OffBoard, KS0066U, 
-                                             FS_5X8DOTS & FS_2LINE,
-                                             DOFC_BLINKINGOFF & DOFC_CURSOROFF & 
-                                             DOFC_DISPLAYOFF,
-                                             EMS_CURSORMOVE & EMS_INCREMENT);
-        if (returnValue > 1)
+        initWait = hd44780InstructionInitAll(initTable, 2);
+        if (initWait > 1)
         {
-            wait(returnValue);
+            wait(initWait);
         }    
     }    
-    while (returnValue != 0);
+    while (initWait != 0);
     
     hd44780DisplayControl(hHd44780OnBoard,
                           DOFC_BLINKINGON & DOFC_CURSOROFF & DOFC_DISPLAYON);
@@ -270,16 +273,16 @@ void main (void)
     pString = testString1;
     do
     {
-        pString = hd44780WriteRAMString(hHd44780OffBoard, pString);
-    } while (pString != (unsigned char *) 0);
+        pString = hd44780WriteROMString(hHd44780OffBoard, pString);
+    } while (pString != (const HD44780_ROM unsigned char *) 0);
     
-    hd44780SetCursorAddr(hHd44780OffBoard, 0x40);
+    hd44780SetCursorPos(hHd44780OffBoard, 1, 0);
     
     pString = testString2;
     do
     {
-        pString = hd44780WriteRAMString(hHd44780OffBoard, pString);
-    } while (pString != (unsigned char *) 0);
+        pString = hd44780WriteROMString(hHd44780OffBoard, pString);
+    } while (pString != (const HD44780_ROM unsigned char *) 0);
 
     TRISBbits.TRISB0 = 0;
 
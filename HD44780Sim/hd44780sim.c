@@ -0,0 +1,986 @@
+/*******************************************************************************
+*
+* HD44780 CONTROLLER SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module models an HD44780 alphanumeric LCD controller and the following
+* clones, using the execution times given in their respective datasheets:
+*
+* Hitachi HD44780U
+* Sitronix ST7066U
+* Samsung S6A0069
+* Samsung KS0066U
+* Novatek NT7603
+*
+* Filename : hd44780sim.c
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. The model is driven one E strobe at a time. Callers are responsible for
+*    moving the simulated clock forward by the duration of each bus cycle they
+*    perform (see hd44780simAdvance()), which allows both the function level
+*    LCD interface (lcdif_host.c) and pin level models to share this module.
+* 2. Writes and data reads issued while the controller is busy are still
+*    executed, but are counted as violations so that test programs can detect
+*    them. Reading the busy flag and address is always allowed.
+* 3. Function Set instructions received while the interface is still in 8-bit
+*    mode form part of the "Initialising by Instruction" sequence. The
+*    datasheets state that the busy flag cannot be checked during this
+*    sequence and some clones expect the next nibble immediately, so these do
+*    not start a busy period.
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                      HD44780 CONTROLLER SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "hd44780sim.h"
+
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the address counter currently points to CGRAM
+*******************************************************************************/
+#define HD44780SIM_CGRAMSELECTED    (0x01 << 0)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the interface has been switched to 4-bit mode
+*******************************************************************************/
+#define HD44780SIM_4BITMODE         (0x01 << 1)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the first nibble of a 4-bit write has been received
+*******************************************************************************/
+#define HD44780SIM_WRITENIBBLE      (0x01 << 2)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the first nibble of a 4-bit read has been delivered
+*******************************************************************************/
+#define HD44780SIM_READNIBBLE       (0x01 << 3)
+
+/*******************************************************************************
+* Summary:
+*   Entry Mode Set bit I/D - address counter increments when set
+*******************************************************************************/
+#define HD44780SIM_EMS_INCREMENT    0x02
+
+/*******************************************************************************
+* Summary:
+*   Entry Mode Set bit S - display shifts on each data write when set
+*******************************************************************************/
+#define HD44780SIM_EMS_SHIFT        0x01
+
+/*******************************************************************************
+* Summary:
+*   Function Set bit DL - 8-bit interface when set
+*******************************************************************************/
+#define HD44780SIM_FS_8BIT          0x10
+
+/*******************************************************************************
+* Summary:
+*   Function Set bit N - 2-line display when set
+*******************************************************************************/
+#define HD44780SIM_FS_2LINE         0x08
+
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type HD44780SIMTIMING
+* Description:
+*   Holds the datasheet timing of one clone, all in nanoseconds. Members are:
+*   - powerOn   - time after power on before the first instruction
+*   - normal    - execution time of all other instructions and data accesses
+*   - clearHome - execution time of Clear Display and Return Home
+*******************************************************************************/
+typedef struct HD44780SIMTIMINGTYPE {
+    HD44780SIMTIME                  powerOn;
+    HD44780SIMTIME                  normal;
+    HD44780SIMTIME                  clearHome;
+} HD44780SIMTIMING;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Datasheet timing for each clone, indexed by HD44780CLONE value
+*******************************************************************************/
+static const HD44780SIMTIMING hd44780simTiming[] = {
+                                        /* Hitachi HD44780U                   */
+    { 15000000ULL,  37000ULL, 1520000ULL },
+                                        /* Sitronix ST7066U                   */
+    { 40000000ULL,  37000ULL, 1520000ULL },
+                                        /* Samsung S6A0069                    */
+    { 40000000ULL,  39000ULL, 1530000ULL },
+                                        /* Samsung KS0066U                    */
+    { 30000000ULL,  39000ULL, 1530000ULL },
+                                        /* Novatek NT7603                     */
+    { 30000000ULL,  40000ULL, 1640000ULL }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   The simulated clock shared by all simulated controllers
+*******************************************************************************/
+static HD44780SIMTIME simTime;
+
+/*******************************************************************************
+* Summary:
+*   Duration of one E cycle
+*******************************************************************************/
+static HD44780SIMTIME simCycleTime = HD44780SIM_DEFAULTCYCLETIME;
+
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+
+static void             executeInstruction(HD44780SIM * const sim,
+                                           unsigned char      instruction);
+static void             writeRam(HD44780SIM * const sim, unsigned char data);
+static unsigned char    readRam(HD44780SIM * const sim);
+static void             moveAddressCounter(HD44780SIM * const sim,
+                                           unsigned char      increment);
+static unsigned char    getTimingIndex(unsigned char clone);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* hd44780simInit()
+*
+* Summary:
+*   Powers on a simulated controller at the current simulated time
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sim             - simulated controller to initialise
+*   clone           - HD44780CLONE value of the chipset to model
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+* 1. The controller is left in the state described under "Initializing by
+*    Internal Reset Circuit" in the datasheets: 8-bit interface, 1-line
+*    display, display off, increment mode and DDRAM filled with spaces. It
+*    stays busy for the clone's power on time.
+*******************************************************************************/
+void hd44780simInit(HD44780SIM * const sim, unsigned char clone)
+{
+    unsigned char counter;
+
+    sim->clone = clone;
+    sim->simFlags = 0;
+    sim->addressCounter = 0;
+                                        /* Entry mode: increment, no shift    */
+    sim->entryMode = 0x04 | HD44780SIM_EMS_INCREMENT;
+                                        /* Display, cursor and blink off      */
+    sim->displayControl = 0x08;
+                                        /* 8-bit bus, 1 line, 5x8 dots        */
+    sim->functionSet = 0x20 | HD44780SIM_FS_8BIT;
+    sim->writeNibble = 0;
+    sim->readLatch = 0;
+    sim->displayShift = 0;
+
+    for (counter = 0; counter < HD44780SIM_DDRAMSIZE; counter++)
+    {
+        sim->ddram[counter] = ' ';
+    }
+    for (counter = 0; counter < HD44780SIM_CGRAMSIZE; counter++)
+    {
+        sim->cgram[counter] = 0;
+    }
+                                        /* Controller is busy until internal  */
+                                        /* reset has completed                */
+    sim->busyUntil = simTime + hd44780simTiming[getTimingIndex(clone)].powerOn;
+
+    hd44780simClearStats(sim);
+}
+
+/*******************************************************************************
+* hd44780simWrite()
+*
+* Summary:
+*   Performs one write strobe (RW low, falling edge of E) on the controller
+*
+* See also:
+*   hd44780simRead()
+*
+* Arguments:
+*   sim             - simulated controller being written
+*   rs              - state of the RS line (0 = instruction, !0 = data)
+*   dataLines       - state of DB7 to DB0. In 4-bit mode only DB7 to DB4 are
+*                     used
+*
+* Returns:
+*   void
+*
+* Callers:
+*   LCD interface models
+*
+* Notes :
+* 1. The simulated clock is not moved by this function
+*******************************************************************************/
+void hd44780simWrite(HD44780SIM * const sim,
+                     unsigned char      rs,
+                     unsigned char      dataLines)
+{
+    unsigned char value;
+
+    sim->stats.writeCycles++;
+                                        /* Note any write made while the      */
+                                        /* controller is still busy           */
+    if (hd44780simIsBusy(sim))
+    {
+        sim->stats.violations++;
+    }
+                                        /* A write always restarts the nibble */
+                                        /* sequence of a 4-bit read           */
+    sim->simFlags &= ~HD44780SIM_READNIBBLE;
+
+    if (sim->simFlags & HD44780SIM_4BITMODE)
+    {
+                                        /* First nibble is simply stored      */
+        if (!(sim->simFlags & HD44780SIM_WRITENIBBLE))
+        {
+            sim->writeNibble = dataLines & 0xF0;
+            sim->simFlags |= HD44780SIM_WRITENIBBLE;
+            return;
+        }
+                                        /* Second nibble completes the byte   */
+        value = sim->writeNibble | (dataLines >> 4);
+        sim->simFlags &= ~HD44780SIM_WRITENIBBLE;
+    }
+    else
+    {
+        value = dataLines;
+    }
+
+    if (rs)
+    {
+        writeRam(sim, value);
+    }
+    else
+    {
+        executeInstruction(sim, value);
+    }
+}
+
+/*******************************************************************************
+* hd44780simRead()
+*
+* Summary:
+*   Performs one read strobe (RW high, E high) on the controller and returns
+*   the value the controller drives onto the data lines
+*
+* See also:
+*   hd44780simWrite()
+*
+* Arguments:
+*   sim             - simulated controller being read
+*   rs              - state of the RS line (0 = busy flag and address,
+*                     !0 = data)
+*
+* Returns:
+*   State of DB7 to DB0. In 4-bit mode the nibble is returned on DB7 to DB4
+*
+* Callers:
+*   LCD interface models
+*
+* Notes :
+* 1. The simulated clock is not moved by this function
+*******************************************************************************/
+unsigned char hd44780simRead(HD44780SIM * const sim, unsigned char rs)
+{
+    unsigned char value;
+
+    sim->stats.readCycles++;
+                                        /* In 4-bit mode the second strobe    */
+                                        /* delivers the low nibble of the     */
+                                        /* byte latched by the first strobe   */
+    if ((sim->simFlags & HD44780SIM_4BITMODE) &&
+        (sim->simFlags & HD44780SIM_READNIBBLE))
+    {
+        sim->simFlags &= ~HD44780SIM_READNIBBLE;
+        return (unsigned char) (sim->readLatch << 4);
+    }
+
+    if (rs)
+    {
+                                        /* Note any data read made while the  */
+                                        /* controller is still busy           */
+        if (hd44780simIsBusy(sim))
+        {
+            sim->stats.violations++;
+        }
+        value = readRam(sim);
+    }
+    else
+    {
+        sim->stats.addressReads++;
+        value = sim->addressCounter & 0x7F;
+        if (hd44780simIsBusy(sim))
+        {
+            value |= HD44780SIM_BUSYFLAG;
+            sim->stats.busyReads++;
+        }
+    }
+
+    if (sim->simFlags & HD44780SIM_4BITMODE)
+    {
+        sim->readLatch = value;
+        sim->simFlags |= HD44780SIM_READNIBBLE;
+        return value & 0xF0;
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+* hd44780simIsBusy()
+*
+* Summary:
+*   Returns the state of the controller's busy flag at the current simulated
+*   time
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sim             - simulated controller
+*
+* Returns:
+*   - 1             - controller is busy
+*   - 0             - controller is ready for the next instruction
+*
+* Callers:
+*   LCD interface models, host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+unsigned char hd44780simIsBusy(HD44780SIM const * const sim)
+{
+    return simTime < sim->busyUntil;
+}
+
+/*******************************************************************************
+* hd44780simIs4BitMode()
+*
+* Summary:
+*   Returns whether the controller's interface is currently in 4-bit mode
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sim             - simulated controller
+*
+* Returns:
+*   - 1             - interface is 4 bits wide
+*   - 0             - interface is 8 bits wide
+*
+* Callers:
+*   LCD interface models, host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+unsigned char hd44780simIs4BitMode(HD44780SIM const * const sim)
+{
+    return (sim->simFlags & HD44780SIM_4BITMODE) ? 1 : 0;
+}
+
+/*******************************************************************************
+* hd44780simGetExecTime()
+*
+* Summary:
+*   Returns the datasheet execution time of an instruction or data access
+*
+* See also:
+*   None
+*
+* Arguments:
+*   clone           - HD44780CLONE value of the chipset
+*   rs              - 0 for an instruction, !0 for a data access
+*   value           - instruction (ignored for data accesses)
+*
+* Returns:
+*   Execution time in nanoseconds
+*
+* Callers:
+*   LCD interface models, host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+HD44780SIMTIME hd44780simGetExecTime(unsigned char clone,
+                                     unsigned char rs,
+                                     unsigned char value)
+{
+    const HD44780SIMTIMING * timing;
+
+    timing = &hd44780simTiming[getTimingIndex(clone)];
+                                        /* Clear Display is 0x01, Return Home */
+                                        /* is 0x02 or 0x03                    */
+    if (!rs && value != 0 && value < 0x04)
+    {
+        return timing->clearHome;
+    }
+
+    return timing->normal;
+}
+
+/*******************************************************************************
+* hd44780simClearStats()
+*
+* Summary:
+*   Clears the counters of a simulated controller
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sim             - simulated controller
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simClearStats(HD44780SIM * const sim)
+{
+    sim->stats.writeCycles = 0;
+    sim->stats.readCycles = 0;
+    sim->stats.instructions = 0;
+    sim->stats.dataWrites = 0;
+    sim->stats.dataReads = 0;
+    sim->stats.addressReads = 0;
+    sim->stats.busyReads = 0;
+    sim->stats.violations = 0;
+}
+
+/*******************************************************************************
+* hd44780simGetTime()
+*
+* Summary:
+*   Returns the current simulated time
+*
+* See also:
+*   hd44780simAdvance(), hd44780simDelay()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   Simulated time in nanoseconds
+*
+* Callers:
+*   LCD interface models, host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+HD44780SIMTIME hd44780simGetTime(void)
+{
+    return simTime;
+}
+
+/*******************************************************************************
+* hd44780simResetTime()
+*
+* Summary:
+*   Sets the simulated clock back to zero. Only to be used before any
+*   simulated controller is initialised
+*
+* See also:
+*   hd44780simGetTime()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simResetTime(void)
+{
+    simTime = 0;
+}
+
+/*******************************************************************************
+* hd44780simAdvance()
+*
+* Summary:
+*   Moves the simulated clock forward
+*
+* See also:
+*   hd44780simDelay()
+*
+* Arguments:
+*   duration        - number of nanoseconds to move forward
+*
+* Returns:
+*   void
+*
+* Callers:
+*   LCD interface models, host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simAdvance(HD44780SIMTIME duration)
+{
+    simTime += duration;
+}
+
+/*******************************************************************************
+* hd44780simDelay()
+*
+* Summary:
+*   Moves the simulated clock forward by a number of microseconds. This is
+*   what a host test program calls in place of the wait() busy loop used on
+*   the target
+*
+* See also:
+*   hd44780simAdvance()
+*
+* Arguments:
+*   microseconds    - number of microseconds to wait
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simDelay(unsigned long microseconds)
+{
+    simTime += (HD44780SIMTIME) microseconds * 1000ULL;
+}
+
+/*******************************************************************************
+* hd44780simGetCycleTime()
+*
+* Summary:
+*   Returns the duration of one E cycle used by the LCD interface models
+*
+* See also:
+*   hd44780simSetCycleTime()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   E cycle time in nanoseconds
+*
+* Callers:
+*   LCD interface models
+*
+* Notes :
+*   None
+*******************************************************************************/
+HD44780SIMTIME hd44780simGetCycleTime(void)
+{
+    return simCycleTime;
+}
+
+/*******************************************************************************
+* hd44780simSetCycleTime()
+*
+* Summary:
+*   Sets the duration of one E cycle used by the LCD interface models
+*
+* See also:
+*   hd44780simGetCycleTime()
+*
+* Arguments:
+*   cycleTime       - E cycle time in nanoseconds
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simSetCycleTime(HD44780SIMTIME cycleTime)
+{
+    simCycleTime = cycleTime;
+}
+
+/*******************************************************************************
+* executeInstruction() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Decodes and executes a complete instruction byte
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sim             - simulated controller
+*   instruction     - instruction byte received with RS low
+*
+* Returns:
+*   void
+*
+* Callers:
+*   hd44780simWrite()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void executeInstruction(HD44780SIM * const sim,
+                               unsigned char      instruction)
+{
+    unsigned char counter;
+    unsigned char timed = 1;
+
+    sim->stats.instructions++;
+                                        /* Set DDRAM address                  */
+    if (instruction & 0x80)
+    {
+        sim->addressCounter = instruction & 0x7F;
+        sim->simFlags &= ~HD44780SIM_CGRAMSELECTED;
+    }
+                                        /* Set CGRAM address                  */
+    else if (instruction & 0x40)
+    {
+        sim->addressCounter = instruction & 0x3F;
+        sim->simFlags |= HD44780SIM_CGRAMSELECTED;
+    }
+                                        /* Function set                       */
+    else if (instruction & 0x20)
+    {
+        if (!(sim->simFlags & HD44780SIM_4BITMODE))
+        {
+                                        /* Part of the initialisation by      */
+                                        /* instruction sequence - untimed     */
+            timed = 0;
+        }
+        sim->functionSet = instruction & 0x3C;
+        if (instruction & HD44780SIM_FS_8BIT)
+        {
+            sim->simFlags &= ~HD44780SIM_4BITMODE;
+        }
+        else
+        {
+            sim->simFlags |= HD44780SIM_4BITMODE;
+        }
+        sim->simFlags &= ~(HD44780SIM_WRITENIBBLE | HD44780SIM_READNIBBLE);
+    }
+                                        /* Cursor or display shift            */
+    else if (instruction & 0x10)
+    {
+        if (instruction & 0x08)
+        {
+            sim->displayShift += (instruction & 0x04) ? 1 : -1;
+        }
+        else
+        {
+            moveAddressCounter(sim, instruction & 0x04);
+        }
+    }
+                                        /* Display on/off control             */
+    else if (instruction & 0x08)
+    {
+        sim->displayControl = instruction;
+    }
+                                        /* Entry mode set                     */
+    else if (instruction & 0x04)
+    {
+        sim->entryMode = instruction;
+    }
+                                        /* Return home                        */
+    else if (instruction & 0x02)
+    {
+        sim->addressCounter = 0;
+        sim->simFlags &= ~HD44780SIM_CGRAMSELECTED;
+        sim->displayShift = 0;
+    }
+                                        /* Clear display                      */
+    else if (instruction & 0x01)
+    {
+        for (counter = 0; counter < HD44780SIM_DDRAMSIZE; counter++)
+        {
+            sim->ddram[counter] = ' ';
+        }
+        sim->addressCounter = 0;
+        sim->simFlags &= ~HD44780SIM_CGRAMSELECTED;
+        sim->displayShift = 0;
+        sim->entryMode |= HD44780SIM_EMS_INCREMENT;
+    }
+
+    if (timed)
+    {
+        sim->busyUntil = simTime +
+                        hd44780simGetExecTime(sim->clone, 0, instruction);
+    }
+}
+
+/*******************************************************************************
+* writeRam() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Writes a data byte to DDRAM or CGRAM at the address counter
+*
+* See also:
+*   readRam()
+*
+* Arguments:
+*   sim             - simulated controller
+*   data            - data byte received with RS high
+*
+* Returns:
+*   void
+*
+* Callers:
+*   hd44780simWrite()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void writeRam(HD44780SIM * const sim, unsigned char data)
+{
+    sim->stats.dataWrites++;
+
+    if (sim->simFlags & HD44780SIM_CGRAMSELECTED)
+    {
+        sim->cgram[sim->addressCounter & 0x3F] = data;
+    }
+    else
+    {
+        sim->ddram[sim->addressCounter & 0x7F] = data;
+        if (sim->entryMode & HD44780SIM_EMS_SHIFT)
+        {
+            sim->displayShift +=
+                        (sim->entryMode & HD44780SIM_EMS_INCREMENT) ? -1 : 1;
+        }
+    }
+    moveAddressCounter(sim, sim->entryMode & HD44780SIM_EMS_INCREMENT);
+
+    sim->busyUntil = simTime + hd44780simGetExecTime(sim->clone, 1, 0);
+}
+
+/*******************************************************************************
+* readRam() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Reads a data byte from DDRAM or CGRAM at the address counter
+*
+* See also:
+*   writeRam()
+*
+* Arguments:
+*   sim             - simulated controller
+*
+* Returns:
+*   Data byte read
+*
+* Callers:
+*   hd44780simRead()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned char readRam(HD44780SIM * const sim)
+{
+    unsigned char data;
+
+    sim->stats.dataReads++;
+
+    if (sim->simFlags & HD44780SIM_CGRAMSELECTED)
+    {
+        data = sim->cgram[sim->addressCounter & 0x3F];
+    }
+    else
+    {
+        data = sim->ddram[sim->addressCounter & 0x7F];
+    }
+    moveAddressCounter(sim, sim->entryMode & HD44780SIM_EMS_INCREMENT);
+
+    sim->busyUntil = simTime + hd44780simGetExecTime(sim->clone, 1, 0);
+
+    return data;
+}
+
+/*******************************************************************************
+* moveAddressCounter() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Increments or decrements the address counter, wrapping exactly as the
+*   controller does
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sim             - simulated controller
+*   increment       - !0 to increment, 0 to decrement
+*
+* Returns:
+*   void
+*
+* Callers:
+*   executeInstruction(), writeRam(), readRam()
+*
+* Notes :
+* 1. In 2-line mode DDRAM runs from 0x00 to 0x27 and 0x40 to 0x67 and the
+*    counter jumps from the end of one line to the start of the other. In
+*    1-line mode DDRAM runs from 0x00 to 0x4F.
+*******************************************************************************/
+static void moveAddressCounter(HD44780SIM * const sim,
+                               unsigned char      increment)
+{
+    unsigned char address = sim->addressCounter;
+
+    if (sim->simFlags & HD44780SIM_CGRAMSELECTED)
+    {
+        address = (unsigned char) (increment ? address + 1 : address - 1);
+        sim->addressCounter = address & 0x3F;
+    }
+    else if (sim->functionSet & HD44780SIM_FS_2LINE)
+    {
+        if (increment)
+        {
+            if (address == 0x27)
+            {
+                address = 0x40;
+            }
+            else if (address >= 0x67)
+            {
+                address = 0x00;
+            }
+            else
+            {
+                address++;
+            }
+        }
+        else
+        {
+            if (address == 0x00)
+            {
+                address = 0x67;
+            }
+            else if (address == 0x40)
+            {
+                address = 0x27;
+            }
+            else
+            {
+                address--;
+            }
+        }
+        sim->addressCounter = address;
+    }
+    else
+    {
+        if (increment)
+        {
+            address = (address >= 0x4F) ? 0x00 : address + 1;
+        }
+        else
+        {
+            address = (address == 0x00) ? 0x4F : address - 1;
+        }
+        sim->addressCounter = address;
+    }
+}
+
+/*******************************************************************************
+* getTimingIndex() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Makes sure a clone value can safely be used to index the timing table
+*
+* See also:
+*   None
+*
+* Arguments:
+*   clone           - HD44780CLONE value
+*
+* Returns:
+*   Index into hd44780simTiming[]
+*
+* Callers:
+*   hd44780simInit(), hd44780simGetExecTime()
+*
+* Notes :
+* 1. Unknown values are treated as the slowest clone (NT7603)
+*******************************************************************************/
+static unsigned char getTimingIndex(unsigned char clone)
+{
+    unsigned char entries;
+
+    entries = sizeof(hd44780simTiming) / sizeof(hd44780simTiming[0]);
+
+    if (clone >= entries)
+    {
+        return entries - 1;
+    }
+
+    return clone;
+}
+
+
+/*******************************************************************************
+*
+*                    HD44780 CONTROLLER SIMULATOR MODULE END
+*
+*******************************************************************************/
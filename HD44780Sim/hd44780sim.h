@@ -0,0 +1,204 @@
+/*******************************************************************************
+*
+* HD44780 CONTROLLER SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module models an HD44780 alphanumeric LCD controller, or one of the
+* clones supported by the HD44780 module, so that the driver can be exercised
+* and its bus throughput measured on a host PC without any hardware. The model
+* operates at the level of individual E strobes and contains the DDRAM, CGRAM,
+* address counter, 4-bit/8-bit interface logic and a busy flag that is driven
+* by the datasheet instruction execution times of the chosen clone.
+* All simulated controllers share one simulated clock, measured in nanoseconds,
+* which only moves forward when a bus cycle is performed or when the caller
+* explicitly waits.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : hd44780sim.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* This module is only intended for use on a host PC (gcc or similar) and is
+* not part of any target build
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                      HD44780 CONTROLLER SIMULATOR MODULE
+*
+*******************************************************************************/
+#ifndef __HD44780SIM_MODULE_PRESENT__
+#define __HD44780SIM_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Default duration of one E cycle (tcycE) in nanoseconds. This is the value
+*   given in the HD44780U datasheet for VCC = 2.7 to 4.5V
+* See also:
+*   <link hd44780simSetCycleTime>
+*******************************************************************************/
+#define HD44780SIM_DEFAULTCYCLETIME     1000
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Size of the modelled Display Data RAM address space
+*******************************************************************************/
+#define HD44780SIM_DDRAMSIZE            0x80
+
+/*******************************************************************************
+* Summary:
+*   Size of the modelled Character Generator RAM
+*******************************************************************************/
+#define HD44780SIM_CGRAMSIZE            0x40
+
+/*******************************************************************************
+* Summary:
+*   Busy flag bit as returned when the address counter is read
+*******************************************************************************/
+#define HD44780SIM_BUSYFLAG             0x80
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type HD44780SIMTIME
+* Description:
+*   Holds a simulated point in time or a duration in nanoseconds
+*******************************************************************************/
+typedef unsigned long long HD44780SIMTIME;
+
+/*******************************************************************************
+* New data type HD44780SIMSTATS
+* Description:
+*   Counters collected by a simulated controller. Members are:
+*   - writeCycles   - number of E strobes with RW low
+*   - readCycles    - number of E strobes with RW high
+*   - instructions  - number of complete instructions executed
+*   - dataWrites    - number of complete bytes written to DDRAM or CGRAM
+*   - dataReads     - number of complete bytes read from DDRAM or CGRAM
+*   - addressReads  - number of complete busy flag/address counter reads
+*   - busyReads     - number of those address reads that returned busy
+*   - violations    - number of write strobes and data reads issued while
+*                     the controller was still busy executing the previous
+*                     instruction
+*******************************************************************************/
+typedef struct HD44780SIMSTATSTYPE {
+    unsigned long                   writeCycles;
+    unsigned long                   readCycles;
+    unsigned long                   instructions;
+    unsigned long                   dataWrites;
+    unsigned long                   dataReads;
+    unsigned long                   addressReads;
+    unsigned long                   busyReads;
+    unsigned long                   violations;
+} HD44780SIMSTATS;
+
+/*******************************************************************************
+* New data type HD44780SIM
+* Description:
+*   Holds the complete state of one simulated controller. Members are:
+*   - clone             - HD44780CLONE value of the modelled chipset
+*   - simFlags          - interface and addressing state (private to module)
+*   - addressCounter    - the address counter (AC)
+*   - entryMode         - last Entry Mode Set instruction executed
+*   - displayControl    - last Display On/Off Control instruction executed
+*   - functionSet       - last Function Set instruction executed
+*   - writeNibble       - first nibble of a pending 4-bit write
+*   - readLatch         - byte being transferred by a 4-bit read
+*   - displayShift      - number of positions the display has been shifted
+*   - ddram             - Display Data RAM
+*   - cgram             - Character Generator RAM
+*   - busyUntil         - simulated time at which the busy flag clears
+*   - stats             - bus and instruction counters
+*******************************************************************************/
+typedef struct HD44780SIMTYPE {
+    unsigned char                   clone;
+    unsigned char                   simFlags;
+    unsigned char                   addressCounter;
+    unsigned char                   entryMode;
+    unsigned char                   displayControl;
+    unsigned char                   functionSet;
+    unsigned char                   writeNibble;
+    unsigned char                   readLatch;
+    signed char                     displayShift;
+    unsigned char                   ddram[HD44780SIM_DDRAMSIZE];
+    unsigned char                   cgram[HD44780SIM_CGRAMSIZE];
+    HD44780SIMTIME                  busyUntil;
+    HD44780SIMSTATS                 stats;
+} HD44780SIM;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            hd44780simInit(HD44780SIM             * const sim,
+                               unsigned char                  clone);
+
+void            hd44780simWrite(HD44780SIM            * const sim,
+                                unsigned char                 rs,
+                                unsigned char                 dataLines);
+unsigned char   hd44780simRead(HD44780SIM             * const sim,
+                               unsigned char                  rs);
+
+unsigned char   hd44780simIsBusy(HD44780SIM     const * const sim);
+unsigned char   hd44780simIs4BitMode(HD44780SIM const * const sim);
+HD44780SIMTIME  hd44780simGetExecTime(unsigned char           clone,
+                                      unsigned char           rs,
+                                      unsigned char           value);
+void            hd44780simClearStats(HD44780SIM       * const sim);
+
+HD44780SIMTIME  hd44780simGetTime(void);
+void            hd44780simResetTime(void);
+void            hd44780simAdvance(HD44780SIMTIME              duration);
+void            hd44780simDelay(unsigned long                 microseconds);
+HD44780SIMTIME  hd44780simGetCycleTime(void);
+void            hd44780simSetCycleTime(HD44780SIMTIME         cycleTime);
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*
+*                    HD44780 CONTROLLER SIMULATOR MODULE END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,304 @@
+/*******************************************************************************
+*
+* 74HC595 SHIFT REGISTER SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module models a 74HC595 shift register, loaded over SPI with RCLK
+* pulsed after every byte, whose outputs drive the RS, E and DB7 to DB4 pins
+* of a simulated HD44780 controller with R/W tied low.
+*
+* Filename : hd44780sim595.c
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. The outputs change once per byte, eight SPI clocks after the previous
+*    change, so the timing seen by the controller is only as fine as one byte
+* 2. The controller is written on the falling edge of E, with the RS and data
+*    lines as they were while E was high
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                    74HC595 SHIFT REGISTER SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "hd44780sim595.h"
+
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that E has fallen at least once since hd44780sim595Init()
+*******************************************************************************/
+#define HD44780SIM595_STROBED       (0x01 << 0)
+
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+
+static void             latchOutputs(HD44780SIM595 * const sr,
+                                     unsigned char         outputs);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* hd44780sim595Init()
+*
+* Summary:
+*   Powers on a simulated shift register with all its outputs low
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sr              - simulated shift register, with its wiring filled in
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780sim595Init(HD44780SIM595 * const sr)
+{
+    sr->outputs = 0;
+    sr->srFlags = 0;
+    sr->rsChangeTime = hd44780simGetTime();
+    sr->eRiseTime = sr->rsChangeTime;
+    sr->eFallTime = sr->rsChangeTime;
+
+    hd44780sim595ClearStats(sr);
+}
+
+/*******************************************************************************
+* hd44780sim595Write()
+*
+* Summary:
+*   Shifts a burst of bytes into the shift register, latching each onto the
+*   outputs as it completes. This has the prototype of the SPI write function
+*   of an LCDIFOBJ, apart from the first argument
+*
+* See also:
+*   hd44780sim595GetByteTime()
+*
+* Arguments:
+*   sr              - simulated shift register
+*   data            - bytes to send, most significant bit first
+*   length          - number of bytes to send
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs, from the SPI write function of an LCD interface
+*
+* Notes :
+* 1. The simulated clock is moved on by the burst overhead and then by the
+*    time taken to shift each byte
+*******************************************************************************/
+void hd44780sim595Write(HD44780SIM595       * const sr,
+                        const unsigned char       * data,
+                        unsigned int                length)
+{
+    HD44780SIMTIME byteTime;
+
+    byteTime = hd44780sim595GetByteTime(sr);
+
+    sr->stats.bursts++;
+    hd44780simAdvance(sr->burstOverhead);
+
+    while (length)
+    {
+        hd44780simAdvance(byteTime);
+        latchOutputs(sr, *data);
+        sr->stats.bytes++;
+        data++;
+        length--;
+    }
+}
+
+/*******************************************************************************
+* hd44780sim595GetByteTime()
+*
+* Summary:
+*   Returns the time taken to shift one byte into the shift register
+*
+* See also:
+*   hd44780sim595Write()
+*
+* Arguments:
+*   sr              - simulated shift register
+*
+* Returns:
+*   Eight SPI clock periods, in nanoseconds
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+HD44780SIMTIME hd44780sim595GetByteTime(HD44780SIM595 const * const sr)
+{
+    return (8000000ULL + sr->spiClockKHz - 1) / sr->spiClockKHz;
+}
+
+/*******************************************************************************
+* hd44780sim595ClearStats()
+*
+* Summary:
+*   Sets all the counters of a simulated shift register to zero
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sr              - simulated shift register
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780sim595ClearStats(HD44780SIM595 * const sr)
+{
+    sr->stats.bursts = 0;
+    sr->stats.bytes = 0;
+    sr->stats.changes = 0;
+    sr->stats.strobes = 0;
+    sr->stats.violations = 0;
+}
+
+/*******************************************************************************
+* latchOutputs() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Moves a byte to the outputs, checks the E timing that results and writes
+*   the controller on a falling edge of E
+*
+* See also:
+*   None
+*
+* Arguments:
+*   sr              - simulated shift register
+*   outputs         - new state of QH (bit 7) to QA (bit 0)
+*
+* Returns:
+*   void
+*
+* Callers:
+*   hd44780sim595Write()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void latchOutputs(HD44780SIM595 * const sr, unsigned char outputs)
+{
+    HD44780SIMTIME  now;
+    unsigned char   changed;
+    unsigned char   rsMask;
+    unsigned char   eMask;
+    unsigned char   dataMask;
+
+    now = hd44780simGetTime();
+    changed = sr->outputs ^ outputs;
+    rsMask = (unsigned char) (1u << sr->RS_BIT);
+    eMask = (unsigned char) (1u << sr->E_BIT);
+    dataMask = (unsigned char) (0x0Fu << sr->DATA_SHIFT);
+
+    if (changed)
+    {
+        sr->stats.changes++;
+    }
+    if (changed & rsMask)
+    {
+        sr->rsChangeTime = now;
+    }
+
+    if (sr->outputs & eMask)
+    {
+                                        /* RS and the data must hold while E  */
+                                        /* is high and as it falls            */
+        if (changed & (rsMask | dataMask))
+        {
+            sr->stats.violations++;
+        }
+        if (!(outputs & eMask))
+        {
+            if (now - sr->eRiseTime < HD44780SIM595_PWEH ||
+                ((sr->srFlags & HD44780SIM595_STROBED) &&
+                 now - sr->eFallTime < HD44780SIM595_TCYCE))
+            {
+                sr->stats.violations++;
+            }
+            sr->eFallTime = now;
+            sr->srFlags |= HD44780SIM595_STROBED;
+            sr->stats.strobes++;
+            hd44780simWrite(sr->hd44780Sim, sr->outputs & rsMask,
+                            (unsigned char) (((sr->outputs & dataMask) >>
+                                              sr->DATA_SHIFT) << 4));
+        }
+    }
+    else if (outputs & eMask)
+    {
+                                        /* RS must have settled before E rose */
+        if (now - sr->rsChangeTime < HD44780SIM595_TAS)
+        {
+            sr->stats.violations++;
+        }
+        sr->eRiseTime = now;
+    }
+
+    sr->outputs = outputs;
+}
+
+
+/*******************************************************************************
+*
+*                  74HC595 SHIFT REGISTER SIMULATOR MODULE END
+*
+*******************************************************************************/
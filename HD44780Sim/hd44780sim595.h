@@ -0,0 +1,153 @@
+/*******************************************************************************
+*
+* 74HC595 SHIFT REGISTER SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module models a 74HC595 shift register loaded over SPI, with its
+* outputs wired to the RS, E and DB7 to DB4 pins of a simulated HD44780
+* controller, so that the SPI shift register LCD interface module
+* (lcdif_spi595.c) can be run unmodified on a host PC. Every byte sent moves
+* the simulated clock on by eight SPI clocks and is then latched onto the
+* outputs. A falling edge on E becomes a write strobe on the controller, and
+* the E timing and RS set-up seen at the outputs are checked against the
+* HD44780U datasheet. The bytes and bursts sent are counted, so the cost of
+* each LCD interface call on the wire can be measured.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : hd44780sim595.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* This module is only intended for use on a host PC (gcc or similar) and is
+* not part of any target build
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                    74HC595 SHIFT REGISTER SIMULATOR MODULE
+*
+*******************************************************************************/
+#ifndef __HD44780SIM595_MODULE_PRESENT__
+#define __HD44780SIM595_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "hd44780sim.h"
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   HD44780U write timing at VCC = 4.5 to 5.5V, in nanoseconds: E cycle time
+*   (tcycE), E pulse width high (PWEH) and RS set-up time (tAS)
+*******************************************************************************/
+#define HD44780SIM595_TCYCE             500
+#define HD44780SIM595_PWEH              230
+#define HD44780SIM595_TAS               40
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type HD44780SIM595STATS
+* Description:
+*   Counters collected by a simulated shift register. Members are:
+*   - bursts        - number of SPI write calls
+*   - bytes         - number of bytes shifted in and latched
+*   - changes       - number of those bytes that changed the outputs
+*   - strobes       - number of falling edges of E
+*   - violations    - number of E edges that broke the HD44780U's tcycE,
+*                     PWEH or tAS, or where RS or the data changed while E
+*                     was high or as it fell
+*******************************************************************************/
+typedef struct HD44780SIM595STATSTYPE {
+    unsigned long                   bursts;
+    unsigned long                   bytes;
+    unsigned long                   changes;
+    unsigned long                   strobes;
+    unsigned long                   violations;
+} HD44780SIM595STATS;
+
+/*******************************************************************************
+* New data type HD44780SIM595
+* Description:
+*   Describes one simulated 74HC595 and how it is wired to a simulated
+* controller. The user must fill in:
+* - The simulated controller
+* - The output numbers (QA = 0 to QH = 7) wired to RS and E
+* - The output number wired to DB4; DB5 to DB7 follow on the next 3 outputs
+* - The SPI clock in kHz
+* - The time in nanoseconds taken to start each burst, standing in for the
+*   set-up of one SPI transaction on the target
+* and then call hd44780sim595Init(). The remaining members are private to
+* the module, apart from stats.
+*******************************************************************************/
+typedef struct HD44780SIM595TYPE {
+    HD44780SIM                    * hd44780Sim;
+    unsigned char                   RS_BIT;
+    unsigned char                   E_BIT;
+    unsigned char                   DATA_SHIFT;
+    unsigned int                    spiClockKHz;
+    HD44780SIMTIME                  burstOverhead;
+    unsigned char                   outputs;
+    unsigned char                   srFlags;
+    HD44780SIMTIME                  rsChangeTime;
+    HD44780SIMTIME                  eRiseTime;
+    HD44780SIMTIME                  eFallTime;
+    HD44780SIM595STATS              stats;
+} HD44780SIM595;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            hd44780sim595Init(HD44780SIM595       * const sr);
+void            hd44780sim595Write(HD44780SIM595      * const sr,
+                                   const unsigned char        * data,
+                                   unsigned int                 length);
+HD44780SIMTIME  hd44780sim595GetByteTime(HD44780SIM595 const * const sr);
+void            hd44780sim595ClearStats(HD44780SIM595 * const sr);
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*
+*                  74HC595 SHIFT REGISTER SIMULATOR MODULE END
+*
+*******************************************************************************/
+#endif
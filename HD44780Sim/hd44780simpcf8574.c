@@ -0,0 +1,432 @@
+/*******************************************************************************
+*
+* PCF8574 I2C BACKPACK SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module models an I2C bus carrying PCF8574 I/O expanders whose ports
+* drive the RS, R/W, E and DB7 to DB4 pins of simulated HD44780 controllers.
+*
+* Filename : hd44780simpcf8574.c
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. Only write transactions are modelled. The port changes at the
+*    acknowledge of each data byte, nine I2C clocks after the previous change
+* 2. The controller is written on the falling edge of E, with the RS and data
+*    lines as they were while E was high. With R/W high the strobe is a read
+*    and its result is dropped
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                     PCF8574 I2C BACKPACK SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "hd44780simpcf8574.h"
+
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that E has fallen at least once since the expander was
+*   connected
+*******************************************************************************/
+#define HD44780SIMPCF8574_STROBED   (0x01 << 0)
+
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   List of expanders connected to the bus
+*******************************************************************************/
+static HD44780SIMPCF8574 * startOfExpanders;
+
+/*******************************************************************************
+* Summary:
+*   Duration of one I2C clock in nanoseconds
+*******************************************************************************/
+static HD44780SIMTIME i2cClockPeriod;
+
+/*******************************************************************************
+* Summary:
+*   Counters collected by the bus model
+*******************************************************************************/
+static HD44780SIMPCF8574STATS busStats;
+
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+
+static void             writePort(HD44780SIMPCF8574 * const expander,
+                                  unsigned char             port);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* hd44780simPcf8574Init()
+*
+* Summary:
+*   Empties the simulated I2C bus and sets the default I2C clock
+*
+* See also:
+*   hd44780simPcf8574Connect()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPcf8574Init(void)
+{
+    startOfExpanders = (HD44780SIMPCF8574 *) 0;
+    hd44780simPcf8574SetClock(HD44780SIMPCF8574_DEFAULTCLOCK);
+    hd44780simPcf8574ClearStats();
+}
+
+/*******************************************************************************
+* hd44780simPcf8574Connect()
+*
+* Summary:
+*   Powers on a simulated expander, with its port high, and connects it to the
+*   simulated I2C bus
+*
+* See also:
+*   hd44780simPcf8574Init()
+*
+* Arguments:
+*   expander        - wiring description of the expander
+*
+* Returns:
+*   - 1             - expander connected
+*   - 0             - wiring description not valid, or its address is taken
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+* 1. The PCF8574's port powers up high, so the controller sees R/W high and
+*    E high until the first write
+*******************************************************************************/
+unsigned char hd44780simPcf8574Connect(HD44780SIMPCF8574 * const expander)
+{
+    HD44780SIMPCF8574 * other;
+
+    if (expander == (HD44780SIMPCF8574 *) 0 ||
+        expander->hd44780Sim == (HD44780SIM *) 0 ||
+        expander->address > 0x7F)
+    {
+        return 0;
+    }
+    for (other = startOfExpanders; other != (HD44780SIMPCF8574 *) 0;
+         other = other->nextExpander)
+    {
+        if (other == expander || other->address == expander->address)
+        {
+            return 0;
+        }
+    }
+
+    expander->port = 0xFF;
+    expander->expanderFlags = 0;
+    expander->rsChangeTime = hd44780simGetTime();
+    expander->eRiseTime = expander->rsChangeTime;
+    expander->eFallTime = expander->rsChangeTime;
+                                        /* Insert at start of the list        */
+    expander->nextExpander = startOfExpanders;
+    startOfExpanders = expander;
+
+    return 1;
+}
+
+/*******************************************************************************
+* hd44780simPcf8574SetClock()
+*
+* Summary:
+*   Sets the I2C clock that times each transaction
+*
+* See also:
+*   hd44780simPcf8574Write()
+*
+* Arguments:
+*   clockKHz        - I2C clock in kHz
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPcf8574SetClock(unsigned int clockKHz)
+{
+    i2cClockPeriod = (1000000ULL + clockKHz - 1) / clockKHz;
+}
+
+/*******************************************************************************
+* hd44780simPcf8574Write()
+*
+* Summary:
+*   Makes one I2C write transaction: START, address, data bytes and STOP.
+*   This has the prototype of the I2C write function of an LCDIFOBJ
+*
+* See also:
+*   hd44780simPcf8574SetClock()
+*
+* Arguments:
+*   address         - 7-bit address of the expander to write
+*   data            - bytes to put on its port, in order
+*   length          - number of bytes to send
+*
+* Returns:
+*   - 1             - an expander acknowledged the address
+*   - 0             - no expander has that address
+*
+* Callers:
+*   Host test programs, LCD interface module
+*
+* Notes :
+* 1. When no expander acknowledges the address the master sends STOP
+*    straight away, so only the START, address byte and STOP are counted
+*******************************************************************************/
+unsigned char hd44780simPcf8574Write(unsigned char          address,
+                                     const unsigned char  * data,
+                                     unsigned int           length)
+{
+    HD44780SIMPCF8574 * expander;
+
+    for (expander = startOfExpanders; expander != (HD44780SIMPCF8574 *) 0;
+         expander = expander->nextExpander)
+    {
+        if (expander->address == address)
+        {
+            break;
+        }
+    }
+                                        /* START and address byte             */
+    busStats.starts++;
+    busStats.bytes++;
+    busStats.bits += 1 + 9;
+    hd44780simAdvance((1 + 9) * i2cClockPeriod);
+
+    if (expander == (HD44780SIMPCF8574 *) 0)
+    {
+        busStats.nacks++;
+        length = 0;
+    }
+                                        /* Each byte reaches the port at its  */
+                                        /* acknowledge                        */
+    while (length)
+    {
+        busStats.bytes++;
+        busStats.bits += 9;
+        hd44780simAdvance(9 * i2cClockPeriod);
+        writePort(expander, *data);
+        data++;
+        length--;
+    }
+                                        /* STOP                               */
+    busStats.bits++;
+    hd44780simAdvance(i2cClockPeriod);
+
+    return (expander != (HD44780SIMPCF8574 *) 0);
+}
+
+/*******************************************************************************
+* hd44780simPcf8574GetStats()
+*
+* Summary:
+*   Returns the counters collected by the bus model
+*
+* See also:
+*   hd44780simPcf8574ClearStats()
+*
+* Arguments:
+*   stats           - where to copy the counters
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPcf8574GetStats(HD44780SIMPCF8574STATS * const stats)
+{
+    *stats = busStats;
+}
+
+/*******************************************************************************
+* hd44780simPcf8574ClearStats()
+*
+* Summary:
+*   Sets all the counters of the bus model to zero
+*
+* See also:
+*   hd44780simPcf8574GetStats()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPcf8574ClearStats(void)
+{
+    busStats.starts = 0;
+    busStats.bytes = 0;
+    busStats.bits = 0;
+    busStats.portWrites = 0;
+    busStats.nacks = 0;
+    busStats.violations = 0;
+}
+
+/*******************************************************************************
+* writePort() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Puts a byte on an expander's port, checks the E timing that results and
+*   writes the controller on a falling edge of E
+*
+* See also:
+*   None
+*
+* Arguments:
+*   expander        - simulated expander
+*   port            - new state of P7 (bit 7) to P0 (bit 0)
+*
+* Returns:
+*   void
+*
+* Callers:
+*   hd44780simPcf8574Write()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void writePort(HD44780SIMPCF8574 * const expander, unsigned char port)
+{
+    HD44780SIMTIME  now;
+    unsigned char   changed;
+    unsigned char   rsMask;
+    unsigned char   rwMask;
+    unsigned char   eMask;
+    unsigned char   dataMask;
+
+    now = hd44780simGetTime();
+    changed = expander->port ^ port;
+    rsMask = (unsigned char) (1u << expander->RS_BIT);
+    rwMask = (unsigned char) (1u << expander->RW_BIT);
+    eMask = (unsigned char) (1u << expander->E_BIT);
+    dataMask = (unsigned char) (0x0Fu << expander->DATA_SHIFT);
+
+    busStats.portWrites++;
+    if (changed & (rsMask | rwMask))
+    {
+        expander->rsChangeTime = now;
+    }
+
+    if ((expander->port & eMask) && (expander->port & rwMask))
+    {
+                                        /* A read cycle, as made from power   */
+                                        /* up until the first write; the      */
+                                        /* controller drives the data lines   */
+        if (!(port & eMask))
+        {
+            hd44780simRead(expander->hd44780Sim, expander->port & rsMask);
+        }
+    }
+    else if (expander->port & eMask)
+    {
+                                        /* RS, R/W and the data must hold     */
+                                        /* while E is high and as it falls    */
+        if (changed & (rsMask | rwMask | dataMask))
+        {
+            busStats.violations++;
+        }
+        if (!(port & eMask))
+        {
+            if (now - expander->eRiseTime < HD44780SIMPCF8574_PWEH ||
+                ((expander->expanderFlags & HD44780SIMPCF8574_STROBED) &&
+                 now - expander->eFallTime < HD44780SIMPCF8574_TCYCE))
+            {
+                busStats.violations++;
+            }
+            expander->eFallTime = now;
+            expander->expanderFlags |= HD44780SIMPCF8574_STROBED;
+            hd44780simWrite(expander->hd44780Sim, expander->port & rsMask,
+                            (unsigned char) (((expander->port & dataMask) >>
+                                              expander->DATA_SHIFT) << 4));
+        }
+    }
+    else if (port & eMask)
+    {
+                                        /* RS must have settled before E rose */
+        if (now - expander->rsChangeTime < HD44780SIMPCF8574_TAS ||
+            (changed & rwMask))
+        {
+            busStats.violations++;
+        }
+        expander->eRiseTime = now;
+    }
+
+    expander->port = port;
+}
+
+
+/*******************************************************************************
+*
+*                   PCF8574 I2C BACKPACK SIMULATOR MODULE END
+*
+*******************************************************************************/
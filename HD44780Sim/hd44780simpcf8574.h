@@ -0,0 +1,168 @@
+/*******************************************************************************
+*
+* PCF8574 I2C BACKPACK SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module models an I2C bus carrying one or more PCF8574 I/O expanders,
+* each with its port wired to the RS, R/W, E and DB7 to DB4 pins of a
+* simulated HD44780 controller as on the common LCD "I2C backpack". It lets
+* the PCF8574 LCD interface module (lcdif_pcf8574.c) run unmodified on a host
+* PC. Every write transaction moves the simulated clock on by the I2C clocks
+* it takes and each data byte acknowledged by an expander is put on its port.
+* A falling edge on E becomes a write strobe on the controller, and the E
+* timing and RS set-up seen at the port are checked against the HD44780U
+* datasheet. The START conditions, bytes and bits put on the wire are counted
+* so that the cost of each LCD interface call can be measured.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : hd44780simpcf8574.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* This module is only intended for use on a host PC (gcc or similar) and is
+* not part of any target build
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                     PCF8574 I2C BACKPACK SIMULATOR MODULE
+*
+*******************************************************************************/
+#ifndef __HD44780SIMPCF8574_MODULE_PRESENT__
+#define __HD44780SIMPCF8574_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "hd44780sim.h"
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Default I2C clock in kHz, the fastest the PCF8574 is specified for
+* See also:
+*   <link hd44780simPcf8574SetClock>
+*******************************************************************************/
+#define HD44780SIMPCF8574_DEFAULTCLOCK  100
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   HD44780U write timing at VCC = 4.5 to 5.5V, in nanoseconds: E cycle time
+*   (tcycE), E pulse width high (PWEH) and RS set-up time (tAS)
+*******************************************************************************/
+#define HD44780SIMPCF8574_TCYCE         500
+#define HD44780SIMPCF8574_PWEH          230
+#define HD44780SIMPCF8574_TAS           40
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type HD44780SIMPCF8574
+* Description:
+*   Describes one simulated PCF8574 and how its port is wired to a simulated
+* controller. The user must fill in:
+* - The simulated controller
+* - The expander's 7-bit I2C address
+* - The port bit numbers (P0 = 0 to P7 = 7) wired to RS, R/W and E
+* - The port bit number wired to DB4; DB5 to DB7 follow on the next 3 bits
+* The remaining members are private to the module.
+*******************************************************************************/
+typedef struct HD44780SIMPCF8574TYPE {
+    HD44780SIM                    * hd44780Sim;
+    unsigned char                   address;
+    unsigned char                   RS_BIT;
+    unsigned char                   RW_BIT;
+    unsigned char                   E_BIT;
+    unsigned char                   DATA_SHIFT;
+    unsigned char                   port;
+    unsigned char                   expanderFlags;
+    HD44780SIMTIME                  rsChangeTime;
+    HD44780SIMTIME                  eRiseTime;
+    HD44780SIMTIME                  eFallTime;
+    struct HD44780SIMPCF8574TYPE  * nextExpander;
+} HD44780SIMPCF8574;
+
+/*******************************************************************************
+* New data type HD44780SIMPCF8574STATS
+* Description:
+*   Counters collected by the I2C bus model. Members are:
+*   - starts        - number of START conditions, one per transaction
+*   - bytes         - number of bytes sent, including address bytes
+*   - bits          - number of bit times on the wire: nine per byte, for the
+*                     eight data bits and the acknowledge, plus one each for
+*                     the START and STOP conditions
+*   - portWrites    - number of data bytes put on an expander's port
+*   - nacks         - number of transactions no expander acknowledged
+*   - violations    - number of write E edges that broke the HD44780U's
+*                     tcycE, PWEH or tAS, or where RS, R/W or the data
+*                     changed while E was high or as it fell
+*******************************************************************************/
+typedef struct HD44780SIMPCF8574STATSTYPE {
+    unsigned long                   starts;
+    unsigned long                   bytes;
+    unsigned long                   bits;
+    unsigned long                   portWrites;
+    unsigned long                   nacks;
+    unsigned long                   violations;
+} HD44780SIMPCF8574STATS;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            hd44780simPcf8574Init(void);
+unsigned char   hd44780simPcf8574Connect(HD44780SIMPCF8574 * const expander);
+void            hd44780simPcf8574SetClock(unsigned int        clockKHz);
+
+unsigned char   hd44780simPcf8574Write(unsigned char          address,
+                                       const unsigned char  * data,
+                                       unsigned int           length);
+
+void            hd44780simPcf8574GetStats(HD44780SIMPCF8574STATS * const
+                                                                    stats);
+void            hd44780simPcf8574ClearStats(void);
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*
+*                   PCF8574 I2C BACKPACK SIMULATOR MODULE END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,1704 @@
+/*******************************************************************************
+*
+* HD44780 PIC32 PIN LEVEL SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module watches the simulated PIC32MX GPIO registers and turns what the
+* LCD interface module does to them into bus cycles on simulated HD44780
+* controllers. It also models the Parallel Master Port, Timer 2 and the DMA
+* controller, so that LCD interface modules using them can be tested too.
+*
+* Filename : hd44780simpic32.c
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. Once started, the register bank is mapped read-only. A store to it raises
+*    SIGSEGV; the handler counts the store, makes the bank writable and sets
+*    the trap flag so that the store executes as a single step. The following
+*    SIGTRAP compares the bank with a shadow copy to find what was written,
+*    applies the CLR/SET/INV and PORT-writes-LAT behaviour of the device,
+*    decodes E edges, updates the PORT registers and protects the bank again.
+* 2. The simulated clock is moved forward by one E cycle on each falling edge
+*    of E, as lcdif_host.c does, so busy times match the function level model.
+* 3. Undriven data pins read high because of the HD44780's internal pull-ups.
+*    Other undriven pins read low.
+* 4. The PMP bank is mapped with no access at all, so loads fault as well. The
+*    x86 page fault error code tells stores from loads. A PMP cycle is made in
+*    full when PMDIN is accessed, so PMMODE never reads busy, and a load gets
+*    the byte from the previous read cycle, as on the device.
+* 5. Timer 2 and the DMA channels only run while hd44780simPic32Run() lets
+*    simulated time pass. A timer period match or a DMA channel event starts
+*    one cell transfer on each enabled channel whose start IRQ it is. Cells
+*    written to the PMP bank act as stores to it; the GPIO bank can't be a DMA
+*    destination. TMR2, the interrupt controller, channel priorities and
+*    pattern matching are not modelled.
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                    HD44780 PIC32 PIN LEVEL SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stddef.h>
+#include <string.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "hd44780simpic32.h"
+
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to note the level of the E pin at the last store
+*******************************************************************************/
+#define SIMPIC32_ESTATE             (0x01 << 0)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the controller is driving the data pins
+*******************************************************************************/
+#define SIMPIC32_DRIVING            (0x01 << 1)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that only DB7 to DB4 of the controller are connected
+*******************************************************************************/
+#define SIMPIC32_4BITBUS            (0x01 << 2)
+
+/*******************************************************************************
+* Summary:
+*   x86 EFLAGS trap flag, used to single step the trapped store
+*******************************************************************************/
+#define SIMPIC32_TRAPFLAG           0x100
+
+/*******************************************************************************
+* Summary:
+*   Number of 32-bit words in the bank, in one register and in one GPIO port
+*******************************************************************************/
+#define SIMPIC32_BANKWORDS      (SIMPIC32_SFRBANKSIZE / sizeof(unsigned int))
+#define SIMPIC32_REGWORDS       (sizeof(SIMPIC32REG) / sizeof(unsigned int))
+#define SIMPIC32_PORTWORDS      (sizeof(SIMPIC32PORT) / sizeof(unsigned int))
+
+/*******************************************************************************
+* Summary:
+*   Offsets of the companion registers within a SIMPIC32REG, in words
+*******************************************************************************/
+#define SIMPIC32_CLR                1
+#define SIMPIC32_SET                2
+#define SIMPIC32_INV                3
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that a register pointer is not in the GPIO bank
+*******************************************************************************/
+#define SIMPIC32_NOPORT             0xFF
+
+/*******************************************************************************
+* Summary:
+*   Write access bit of the x86 page fault error code
+*******************************************************************************/
+#define SIMPIC32_WRITEFAULT         0x02
+
+/*******************************************************************************
+* Summary:
+*   Number of 32-bit words in the PMP bank, and the word of PMDIN
+*******************************************************************************/
+#define SIMPIC32_PMPWORDS       (SIMPIC32_PMPBANKSIZE / sizeof(unsigned int))
+#define SIMPIC32_PMDINWORD      (offsetof(SIMPIC32PMP, pmdin) /               \
+                                                        sizeof(unsigned int))
+
+/*******************************************************************************
+* Summary:
+*   PMCON and PMMODE bits used by the model. HD44780 cycles need master mode 1
+*   with PMWR/PMENB and PMRD/PMWR enabled and both strobes active high
+*******************************************************************************/
+#define SIMPIC32_PMPEN              (0x01 << 15)
+#define SIMPIC32_PMPSTROBES         ((0x01 << 9) | (0x01 << 8) | (0x01 << 1) | \
+                                     (0x01 << 0))
+#define SIMPIC32_PMPMODEMASK        (0x03 << 8)
+#define SIMPIC32_PMPMASTER1         (0x03 << 8)
+
+/*******************************************************************************
+* Summary:
+*   Number of 32-bit words used in the bank, and the word of a register in it
+*******************************************************************************/
+#define SIMPIC32_USEDWORDS      (sizeof(simPic32Sfr.sfr) / sizeof(unsigned int))
+#define SIMPIC32_WORDOF(reg)    ((unsigned int) (&(reg) - &simPic32Sfr.word[0]))
+
+/*******************************************************************************
+* Summary:
+*   T2CON bits: timer on and the input clock prescale field
+*******************************************************************************/
+#define SIMPIC32_TIMERON            (0x01 << 15)
+#define SIMPIC32_TCKPSSHIFT         4
+
+/*******************************************************************************
+* Summary:
+*   DMACON, DCHxCON and DCHxECON bits: controller on, channel enabled, channel
+*   left enabled after a block and channel started by its start IRQ
+*******************************************************************************/
+#define SIMPIC32_DMAON              (0x01 << 15)
+#define SIMPIC32_CHEN               (0x01 << 7)
+#define SIMPIC32_CHAEN              (0x01 << 4)
+#define SIMPIC32_SIRQEN             (0x01 << 4)
+
+/*******************************************************************************
+* Summary:
+*   DCHxINT flags: address error, cell done, block done, destination done and
+*   source done. Each flag's enable bit is 16 bits above it
+*******************************************************************************/
+#define SIMPIC32_CHERIF             (0x01 << 0)
+#define SIMPIC32_CHCCIF             (0x01 << 2)
+#define SIMPIC32_CHBCIF             (0x01 << 3)
+#define SIMPIC32_CHDDIF             (0x01 << 5)
+#define SIMPIC32_CHSDIF             (0x01 << 7)
+
+/*******************************************************************************
+* Summary:
+*   Number of pointers KVA_TO_PA() remembers. Each is given the stand-in
+*   address (slot + 1) << 24
+*******************************************************************************/
+#define SIMPIC32_DMAREGIONS         16
+
+/*******************************************************************************
+* Summary:
+*   Shortest RS set-up time (tAS), E pulse width (PWEH) and hold time (tH) of
+*   the HD44780U at VCC = 2.7 to 4.5V, in nanoseconds
+*******************************************************************************/
+#define SIMPIC32_MINSETUPTIME       60
+#define SIMPIC32_MINPULSEWIDTH      450
+#define SIMPIC32_MINHOLDTIME        20
+
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Timer 2 input clock divide ratio, as a shift, for each TCKPS value
+*******************************************************************************/
+static const unsigned char timerPrescaleShifts[8] = { 0, 1, 2, 3, 4, 5, 6, 8 };
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   The simulated SFR bank declared in p32xxxx.h
+*******************************************************************************/
+SIMPIC32SFR simPic32Sfr __attribute__((aligned(SIMPIC32_SFRBANKSIZE)));
+
+/*******************************************************************************
+* Summary:
+*   The simulated PMP bank declared in p32xxxx.h
+*******************************************************************************/
+SIMPIC32PMPBANK simPic32Pmp __attribute__((aligned(SIMPIC32_PMPBANKSIZE)));
+
+/*******************************************************************************
+* Summary:
+*   Copy of the bank as it was after the last store was processed
+*******************************************************************************/
+static unsigned int sfrShadow[SIMPIC32_BANKWORDS];
+
+/*******************************************************************************
+* Summary:
+*   Number of stores made to each word of the bank
+*******************************************************************************/
+static unsigned long sfrWrites[SIMPIC32_BANKWORDS];
+static unsigned long pmpWrites[SIMPIC32_PMPWORDS];
+
+/*******************************************************************************
+* Summary:
+*   Levels driven onto each port by connected controllers, which pins they are
+*   currently driving and which pins have pull-ups
+*******************************************************************************/
+static unsigned int externalLevels[SIMPIC32_NUMBEROFPORTS];
+static unsigned int externalDriven[SIMPIC32_NUMBEROFPORTS];
+static unsigned int pullUps[SIMPIC32_NUMBEROFPORTS];
+
+/*******************************************************************************
+* Summary:
+*   Local pointer to a linked list of connected controllers
+*******************************************************************************/
+static HD44780SIMPIC32PINS * startOfPins;
+
+/*******************************************************************************
+* Summary:
+*   Local pointer to a linked list of controllers connected to the PMP, and
+*   the peripheral bus clock period that times its cycles
+*******************************************************************************/
+static HD44780SIMPIC32PMPLCD * startOfPmpLcds;
+static HD44780SIMTIME pbPeriod = HD44780SIMPIC32_DEFAULTPBPERIOD;
+
+/*******************************************************************************
+* Summary:
+*   Simulated time of the next Timer 2 period match
+*******************************************************************************/
+static HD44780SIMTIME timerNextMatch;
+
+/*******************************************************************************
+* Summary:
+*   Bytes moved so far in the current block of each DMA channel
+*******************************************************************************/
+static unsigned int dmaBlockCount[SIMPIC32_NUMBEROFDMACHANNELS];
+
+/*******************************************************************************
+* Summary:
+*   Pointers handed out as DMA addresses by simPic32KvaToPa(), and the slot to
+*   be used for the next new one
+*******************************************************************************/
+static const volatile unsigned char * dmaRegions[SIMPIC32_DMAREGIONS];
+static unsigned char nextDmaRegion;
+
+/*******************************************************************************
+* Summary:
+*   Counters for the whole model
+*******************************************************************************/
+static HD44780SIMPIC32STATS pic32Stats;
+
+/*******************************************************************************
+* Summary:
+*   Signal handlers in place before hd44780simPic32Start() was called
+*******************************************************************************/
+static struct sigaction oldSegvAction;
+static struct sigaction oldTrapAction;
+
+/*******************************************************************************
+* Summary:
+*   Used to note that the bank is protected and the handlers are installed,
+*   and that a trapped store is being single stepped
+*******************************************************************************/
+static unsigned char trapsActive;
+static volatile sig_atomic_t stepPending;
+
+/*******************************************************************************
+* Summary:
+*   Word of the PMP bank being accessed by the trapped instruction, plus one,
+*   or 0 if the access is to the SFR bank, and whether it is a store
+*******************************************************************************/
+static unsigned int pmpAccessWord;
+static unsigned char pmpAccessIsStore;
+
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+
+static void             sfrWriteFault(int signalNumber, siginfo_t * info,
+                                      void * context);
+static void             sfrWriteStep(int signalNumber, siginfo_t * info,
+                                     void * context);
+static void             processStore(void);
+static void             processPmpAccess(unsigned int wordIndex,
+                                         unsigned char isStore);
+static void             makePmpCycle(unsigned char rw);
+static void             noteStartedPeripherals(void);
+static void             raiseIrq(unsigned char irq);
+static void             makeDmaCell(unsigned char channel);
+static volatile unsigned char * getDmaPointer(unsigned int address);
+static HD44780SIMTIME   getTimerTick(void);
+static unsigned char    decodePins(HD44780SIMPIC32PINS * const pins);
+static void             updatePorts(void);
+static unsigned int     getPinLevels(unsigned char portIndex);
+static unsigned char    getPortIndex(volatile unsigned int const * reg);
+static unsigned char    isSingleBit(unsigned int bits);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* hd44780simPic32Init()
+*
+* Summary:
+*   Resets the simulated GPIO, timer, DMA and PMP registers and disconnects
+*   all controllers
+*
+* See also:
+*   hd44780simPic32Connect(), hd44780simPic32ConnectPmp()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+* 1. As after a device reset, all pins are inputs, all LAT bits are clear and
+*    the PMP, Timer 2 and the DMA controller are off
+* 2. Stops the model if it was running
+* 3. The peripheral bus clock period is left as it is
+*******************************************************************************/
+void hd44780simPic32Init(void)
+{
+    unsigned char counter;
+
+    hd44780simPic32Stop();
+
+    memset((void *) &simPic32Sfr, 0, sizeof(simPic32Sfr));
+    for (counter = 0; counter < SIMPIC32_NUMBEROFPORTS; counter++)
+    {
+        simPic32Sfr.sfr.gpio[counter].tris.reg = 0xFFFFFFFF;
+        externalLevels[counter] = 0;
+        externalDriven[counter] = 0;
+        pullUps[counter] = 0;
+    }
+    startOfPins = (HD44780SIMPIC32PINS *) 0;
+
+    memset((void *) &simPic32Pmp, 0, sizeof(simPic32Pmp));
+    startOfPmpLcds = (HD44780SIMPIC32PMPLCD *) 0;
+
+    for (counter = 0; counter < SIMPIC32_DMAREGIONS; counter++)
+    {
+        dmaRegions[counter] = (const volatile unsigned char *) 0;
+    }
+    nextDmaRegion = 0;
+
+    updatePorts();
+    hd44780simPic32ClearStats();
+}
+
+/*******************************************************************************
+* hd44780simPic32Connect()
+*
+* Summary:
+*   Wires a simulated controller to the simulated GPIO pins
+*
+* See also:
+*   hd44780simPic32Init()
+*
+* Arguments:
+*   pins            - wiring description of the controller
+*
+* Returns:
+*   - 1             - controller connected
+*   - 0             - wiring description not valid or model already running
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+* 1. Several controllers may share the RW, RS and data pins, each with its own
+*    E pin, just as several lcdif objects may share one PBIFOBJ
+* 2. Must be called before hd44780simPic32Start()
+*******************************************************************************/
+unsigned char hd44780simPic32Connect(HD44780SIMPIC32PINS * const pins)
+{
+    unsigned int  bitTest;
+    unsigned char bitCount;
+    unsigned char dataPort;
+
+    if (trapsActive || pins == (HD44780SIMPIC32PINS *) 0 ||
+        pins->hd44780Sim == (HD44780SIM *) 0)
+    {
+        return 0;
+    }
+                                        /* All pins must be in the bank       */
+    dataPort = getPortIndex(pins->DATA_LAT);
+    if (getPortIndex(pins->RW_LAT) == SIMPIC32_NOPORT ||
+        getPortIndex(pins->RS_LAT) == SIMPIC32_NOPORT ||
+        getPortIndex(pins->E_LAT) == SIMPIC32_NOPORT ||
+        dataPort == SIMPIC32_NOPORT)
+    {
+        return 0;
+    }
+    if (!isSingleBit(pins->RW_BIT) || !isSingleBit(pins->RS_BIT) ||
+        !isSingleBit(pins->E_BIT))
+    {
+        return 0;
+    }
+                                        /* Data pins must be 4 or 8           */
+                                        /* consecutive bits                   */
+    if (pins->DATA_MASK == 0)
+    {
+        return 0;
+    }
+    for (pins->dataShift = 0, bitTest = pins->DATA_MASK; !(bitTest & 0x01);
+         bitTest >>= 1)
+    {
+        pins->dataShift++;
+    }
+    for (bitCount = 0; bitTest & 0x01; bitTest >>= 1)
+    {
+        bitCount++;
+    }
+    if (bitTest != 0 || (bitCount != 4 && bitCount != 8))
+    {
+        return 0;
+    }
+
+    pins->pinFlags = 0;
+    if (bitCount == 4)
+    {
+        pins->pinFlags |= SIMPIC32_4BITBUS;
+    }
+    if (getPinLevels(getPortIndex(pins->E_LAT)) & pins->E_BIT)
+    {
+        pins->pinFlags |= SIMPIC32_ESTATE;
+    }
+    pullUps[dataPort] |= pins->DATA_MASK;
+                                        /* Insert at start of the list        */
+    pins->nextPins = startOfPins;
+    startOfPins = pins;
+
+    updatePorts();
+    return 1;
+}
+
+/*******************************************************************************
+* hd44780simPic32ConnectPmp()
+*
+* Summary:
+*   Wires a simulated controller to the simulated PMP
+*
+* See also:
+*   hd44780simPic32Connect(), hd44780simPic32SetPbPeriod()
+*
+* Arguments:
+*   lcd             - wiring description of the controller
+*
+* Returns:
+*   - 1             - controller connected
+*   - 0             - wiring description not valid or model already running
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+* 1. Several controllers may share the PMP, each selected by its own address
+*    lines
+* 2. Must be called before hd44780simPic32Start()
+*******************************************************************************/
+unsigned char hd44780simPic32ConnectPmp(HD44780SIMPIC32PMPLCD * const lcd)
+{
+    if (trapsActive || lcd == (HD44780SIMPIC32PMPLCD *) 0 ||
+        lcd->hd44780Sim == (HD44780SIM *) 0)
+    {
+        return 0;
+    }
+    if (!isSingleBit(lcd->RS_ADDRESS) ||
+        (lcd->RS_ADDRESS & lcd->SELECT_ADDRESS) != 0)
+    {
+        return 0;
+    }
+                                        /* Insert at start of the list        */
+    lcd->nextLcd = startOfPmpLcds;
+    startOfPmpLcds = lcd;
+
+    return 1;
+}
+
+/*******************************************************************************
+* hd44780simPic32SetPbPeriod()
+*
+* Summary:
+*   Sets the peripheral bus clock period that times PMP cycles
+*
+* See also:
+*   hd44780simPic32ConnectPmp()
+*
+* Arguments:
+*   period          - clock period in nanoseconds
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPic32SetPbPeriod(HD44780SIMTIME period)
+{
+    pbPeriod = period;
+}
+
+/*******************************************************************************
+* hd44780simPic32Start()
+*
+* Summary:
+*   Starts trapping stores to the simulated GPIO registers, and loads and
+*   stores to the simulated PMP registers
+*
+* See also:
+*   hd44780simPic32Stop()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   - 1             - model running
+*   - 0             - could not install the signal handlers or protect the
+*                     register bank
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+unsigned char hd44780simPic32Start(void)
+{
+    struct sigaction action;
+
+    if (trapsActive)
+    {
+        return 1;
+    }
+                                        /* The banks must fill whole pages    */
+    if (SIMPIC32_SFRBANKSIZE % sysconf(_SC_PAGESIZE) ||
+        SIMPIC32_PMPBANKSIZE % sysconf(_SC_PAGESIZE))
+    {
+        return 0;
+    }
+
+    memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_SIGINFO;
+
+    action.sa_sigaction = sfrWriteFault;
+    if (sigaction(SIGSEGV, &action, &oldSegvAction))
+    {
+        return 0;
+    }
+    action.sa_sigaction = sfrWriteStep;
+    if (sigaction(SIGTRAP, &action, &oldTrapAction))
+    {
+        sigaction(SIGSEGV, &oldSegvAction, (struct sigaction *) 0);
+        return 0;
+    }
+
+    memcpy(sfrShadow, (void *) &simPic32Sfr, sizeof(sfrShadow));
+    stepPending = 0;
+    pmpAccessWord = 0;
+    if (mprotect((void *) &simPic32Sfr, SIMPIC32_SFRBANKSIZE, PROT_READ) ||
+        mprotect((void *) &simPic32Pmp, SIMPIC32_PMPBANKSIZE, PROT_NONE))
+    {
+        mprotect((void *) &simPic32Sfr, SIMPIC32_SFRBANKSIZE,
+                 PROT_READ | PROT_WRITE);
+        sigaction(SIGSEGV, &oldSegvAction, (struct sigaction *) 0);
+        sigaction(SIGTRAP, &oldTrapAction, (struct sigaction *) 0);
+        return 0;
+    }
+
+    trapsActive = 1;
+    return 1;
+}
+
+/*******************************************************************************
+* hd44780simPic32Stop()
+*
+* Summary:
+*   Stops trapping accesses to the simulated registers
+*
+* See also:
+*   hd44780simPic32Start()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs, hd44780simPic32Init()
+*
+* Notes :
+* 1. Stores made while the model is stopped are not decoded
+*******************************************************************************/
+void hd44780simPic32Stop(void)
+{
+    if (trapsActive)
+    {
+        mprotect((void *) &simPic32Sfr, SIMPIC32_SFRBANKSIZE,
+                 PROT_READ | PROT_WRITE);
+        mprotect((void *) &simPic32Pmp, SIMPIC32_PMPBANKSIZE,
+                 PROT_READ | PROT_WRITE);
+        sigaction(SIGSEGV, &oldSegvAction, (struct sigaction *) 0);
+        sigaction(SIGTRAP, &oldTrapAction, (struct sigaction *) 0);
+        trapsActive = 0;
+    }
+}
+
+/*******************************************************************************
+* hd44780simPic32Run()
+*
+* Summary:
+*   Lets simulated time pass with Timer 2 and the DMA controller running
+*
+* See also:
+*   simPic32KvaToPa()
+*
+* Arguments:
+*   duration        - time to let pass in nanoseconds
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+* 1. Stands in for the time the target's CPU spends on other work while DMA
+*    transfers are paced by the timer. hd44780simAdvance() and
+*    hd44780simDelay() move the clock without running the timer
+* 2. A PMP cycle made by a DMA transfer can move the clock past the next
+*    timer match, in which case the match is handled late
+*******************************************************************************/
+void hd44780simPic32Run(HD44780SIMTIME duration)
+{
+    HD44780SIMTIME endTime;
+
+    endTime = hd44780simGetTime() + duration;
+                                        /* The model's own accesses must not  */
+                                        /* be trapped                         */
+    if (trapsActive)
+    {
+        mprotect((void *) &simPic32Sfr, SIMPIC32_SFRBANKSIZE,
+                 PROT_READ | PROT_WRITE);
+        mprotect((void *) &simPic32Pmp, SIMPIC32_PMPBANKSIZE,
+                 PROT_READ | PROT_WRITE);
+    }
+
+    while ((T2CON & SIMPIC32_TIMERON) && timerNextMatch <= endTime)
+    {
+        if (timerNextMatch > hd44780simGetTime())
+        {
+            hd44780simAdvance(timerNextMatch - hd44780simGetTime());
+        }
+        timerNextMatch += (HD44780SIMTIME) (PR2 + 1) * getTimerTick();
+        raiseIrq(_TIMER_2_IRQ);
+    }
+    if (endTime > hd44780simGetTime())
+    {
+        hd44780simAdvance(endTime - hd44780simGetTime());
+    }
+
+    if (trapsActive)
+    {
+        memcpy(sfrShadow, (void *) &simPic32Sfr, sizeof(sfrShadow));
+        mprotect((void *) &simPic32Sfr, SIMPIC32_SFRBANKSIZE, PROT_READ);
+        mprotect((void *) &simPic32Pmp, SIMPIC32_PMPBANKSIZE, PROT_NONE);
+    }
+}
+
+/*******************************************************************************
+* simPic32KvaToPa()
+*
+* Summary:
+*   Gives a pointer the 32-bit address a simulated DMA channel uses to reach
+*   it. Called through KVA_TO_PA() in the sys/kmem.h stand-in
+*
+* See also:
+*   hd44780simPic32Run()
+*
+* Arguments:
+*   address         - pointer to a buffer or register
+*
+* Returns:
+*   Stand-in physical address
+*
+* Callers:
+*   LCD interface modules, host test programs
+*
+* Notes :
+* 1. The same pointer always gets the same address while it is remembered
+*******************************************************************************/
+unsigned int simPic32KvaToPa(const volatile void * address)
+{
+    unsigned char slot;
+
+    for (slot = 0; slot < SIMPIC32_DMAREGIONS; slot++)
+    {
+        if (dmaRegions[slot] == (const volatile unsigned char *) address)
+        {
+            return (unsigned int) (slot + 1) << 24;
+        }
+    }
+
+    slot = nextDmaRegion;
+    dmaRegions[slot] = (const volatile unsigned char *) address;
+    nextDmaRegion = (unsigned char) ((slot + 1) % SIMPIC32_DMAREGIONS);
+
+    return (unsigned int) (slot + 1) << 24;
+}
+
+/*******************************************************************************
+* hd44780simPic32GetWrites()
+*
+* Summary:
+*   Returns the number of stores made to one register
+*
+* See also:
+*   hd44780simPic32GetStats()
+*
+* Arguments:
+*   reg             - the register, e.g. &LATD, &LATDSET or &PMDIN
+*
+* Returns:
+*   Number of stores since the counters were last cleared
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+unsigned long hd44780simPic32GetWrites(volatile unsigned int const * reg)
+{
+    unsigned long wordIndex;
+
+    wordIndex = (unsigned long) (reg - &simPic32Pmp.word[0]);
+    if (reg >= &simPic32Pmp.word[0] && wordIndex < SIMPIC32_PMPWORDS)
+    {
+        return pmpWrites[wordIndex];
+    }
+
+    wordIndex = (unsigned long) (reg - &simPic32Sfr.word[0]);
+    if (reg < &simPic32Sfr.word[0] || wordIndex >= SIMPIC32_BANKWORDS)
+    {
+        return 0;
+    }
+
+    return sfrWrites[wordIndex];
+}
+
+/*******************************************************************************
+* hd44780simPic32GetStats()
+*
+* Summary:
+*   Returns the counters for the whole model
+*
+* See also:
+*   hd44780simPic32ClearStats()
+*
+* Arguments:
+*   stats           - where to copy the counters
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPic32GetStats(HD44780SIMPIC32STATS * const stats)
+{
+    *stats = pic32Stats;
+}
+
+/*******************************************************************************
+* hd44780simPic32ClearStats()
+*
+* Summary:
+*   Clears the store counters of every register and of the whole model
+*
+* See also:
+*   hd44780simPic32GetStats()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Host test programs, hd44780simPic32Init()
+*
+* Notes :
+*   None
+*******************************************************************************/
+void hd44780simPic32ClearStats(void)
+{
+    memset(sfrWrites, 0, sizeof(sfrWrites));
+    memset(pmpWrites, 0, sizeof(pmpWrites));
+    memset(&pic32Stats, 0, sizeof(pic32Stats));
+}
+
+/*******************************************************************************
+* sfrWriteFault() --PRIVATE FUNCTION--
+*
+* Summary:
+*   SIGSEGV handler. Counts a store to the SFR bank, or a load or store to the
+*   PMP bank, and lets it execute as a single step
+*
+* See also:
+*   sfrWriteStep()
+*
+* Arguments:
+*   signalNumber    - SIGSEGV
+*   info            - holds the faulting address
+*   context         - register state of the interrupted code
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Operating system
+*
+* Notes :
+* 1. Faults outside the banks are real faults. The original handler is put
+*    back so that the faulting instruction fails again and is reported normally
+*******************************************************************************/
+static void sfrWriteFault(int signalNumber, siginfo_t * info, void * context)
+{
+    ucontext_t          * userContext = (ucontext_t *) context;
+    unsigned char       * address = (unsigned char *) info->si_addr;
+    unsigned char       * bank = (unsigned char *) &simPic32Sfr;
+    unsigned char       * pmpBank = (unsigned char *) &simPic32Pmp;
+    unsigned int          wordIndex;
+
+    (void) signalNumber;
+
+    if (address >= pmpBank && address < pmpBank + SIMPIC32_PMPBANKSIZE)
+    {
+        wordIndex = (address - pmpBank) / sizeof(unsigned int);
+        pmpAccessIsStore = (userContext->uc_mcontext.gregs[REG_ERR] &
+                            SIMPIC32_WRITEFAULT) ? 1 : 0;
+        if (pmpAccessIsStore)
+        {
+            pmpWrites[wordIndex]++;
+            pic32Stats.registerWrites++;
+        }
+        else
+        {
+            pic32Stats.registerReads++;
+        }
+        pmpAccessWord = wordIndex + 1;
+                                        /* Let the access through and trap    */
+                                        /* straight after it                  */
+        mprotect(pmpBank, SIMPIC32_PMPBANKSIZE, PROT_READ | PROT_WRITE);
+        stepPending = 1;
+        userContext->uc_mcontext.gregs[REG_EFL] |= SIMPIC32_TRAPFLAG;
+        return;
+    }
+
+    if (address < bank || address >= bank + SIMPIC32_SFRBANKSIZE)
+    {
+        sigaction(SIGSEGV, &oldSegvAction, (struct sigaction *) 0);
+        return;
+    }
+
+    sfrWrites[(address - bank) / sizeof(unsigned int)]++;
+    pic32Stats.registerWrites++;
+                                        /* Let the store through and trap     */
+                                        /* straight after it                  */
+    mprotect(bank, SIMPIC32_SFRBANKSIZE, PROT_READ | PROT_WRITE);
+    pmpAccessWord = 0;
+    stepPending = 1;
+    userContext->uc_mcontext.gregs[REG_EFL] |= SIMPIC32_TRAPFLAG;
+}
+
+/*******************************************************************************
+* sfrWriteStep() --PRIVATE FUNCTION--
+*
+* Summary:
+*   SIGTRAP handler. Processes the access that has just completed and protects
+*   its bank again
+*
+* See also:
+*   sfrWriteFault()
+*
+* Arguments:
+*   signalNumber    - SIGTRAP
+*   info            - not used
+*   context         - register state of the interrupted code
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Operating system
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void sfrWriteStep(int signalNumber, siginfo_t * info, void * context)
+{
+    ucontext_t          * userContext = (ucontext_t *) context;
+
+    (void) signalNumber;
+    (void) info;
+
+    if (!stepPending)
+    {
+        return;
+    }
+
+    userContext->uc_mcontext.gregs[REG_EFL] &= ~SIMPIC32_TRAPFLAG;
+    stepPending = 0;
+
+    if (pmpAccessWord)
+    {
+        processPmpAccess(pmpAccessWord - 1, pmpAccessIsStore);
+        pmpAccessWord = 0;
+        mprotect((void *) &simPic32Pmp, SIMPIC32_PMPBANKSIZE, PROT_NONE);
+        return;
+    }
+
+    processStore();
+
+    mprotect((void *) &simPic32Sfr, SIMPIC32_SFRBANKSIZE, PROT_READ);
+}
+
+/*******************************************************************************
+* processStore() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Applies the effect of a store to the bank and decodes the pins
+*
+* See also:
+*   None
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   sfrWriteStep()
+*
+* Notes :
+* 1. Writing to PORTx writes LATx. Writing to a CLR, SET or INV register
+*    modifies its base register and leaves the companion reading 0
+* 2. Timer 2 and DMA channels switched on by the store are noted
+*******************************************************************************/
+static void processStore(void)
+{
+    HD44780SIMPIC32PINS * pins;
+    unsigned int          wordIndex;
+    unsigned int          baseIndex;
+    unsigned int          value;
+    unsigned int          gpioWords;
+    unsigned char         cycleDone;
+
+    gpioWords = SIMPIC32_NUMBEROFPORTS * SIMPIC32_PORTWORDS;
+
+    for (wordIndex = 0; wordIndex < SIMPIC32_USEDWORDS; wordIndex++)
+    {
+        value = simPic32Sfr.word[wordIndex];
+        if (value == sfrShadow[wordIndex])
+        {
+            continue;
+        }
+                                        /* Find the register to modify        */
+        baseIndex = wordIndex - (wordIndex % SIMPIC32_REGWORDS);
+        if (wordIndex < gpioWords &&
+            &simPic32Sfr.word[baseIndex] ==
+            &simPic32Sfr.sfr.gpio[wordIndex / SIMPIC32_PORTWORDS].port.reg)
+        {
+            simPic32Sfr.word[baseIndex] = sfrShadow[baseIndex];
+            baseIndex += SIMPIC32_REGWORDS;
+        }
+
+        switch (wordIndex % SIMPIC32_REGWORDS)
+        {
+            case SIMPIC32_CLR:
+                simPic32Sfr.word[baseIndex] &= ~value;
+                simPic32Sfr.word[wordIndex] = 0;
+                break;
+
+            case SIMPIC32_SET:
+                simPic32Sfr.word[baseIndex] |= value;
+                simPic32Sfr.word[wordIndex] = 0;
+                break;
+
+            case SIMPIC32_INV:
+                simPic32Sfr.word[baseIndex] ^= value;
+                simPic32Sfr.word[wordIndex] = 0;
+                break;
+
+            default:
+                simPic32Sfr.word[baseIndex] = value;
+                break;
+        }
+    }
+
+    noteStartedPeripherals();
+
+    cycleDone = 0;
+    for (pins = startOfPins; pins != (HD44780SIMPIC32PINS *) 0;
+         pins = pins->nextPins)
+    {
+        cycleDone |= decodePins(pins);
+    }
+                                        /* Strobing several E pins together   */
+                                        /* is still one bus cycle             */
+    if (cycleDone)
+    {
+        hd44780simAdvance(hd44780simGetCycleTime());
+    }
+
+    updatePorts();
+    memcpy(sfrShadow, (void *) &simPic32Sfr, sizeof(sfrShadow));
+}
+
+/*******************************************************************************
+* decodePins() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Turns an edge on a controller's E pin into a bus cycle
+*
+* See also:
+*   None
+*
+* Arguments:
+*   pins            - wiring of the controller
+*
+* Returns:
+*   1 if a bus cycle ended on this store, otherwise 0
+*
+* Callers:
+*   processStore()
+*
+* Notes :
+* 1. Read data is driven from the rising edge of E until its falling edge.
+*    Write data is latched on the falling edge
+* 2. Each completed cycle is added to the bus signature on its falling edge.
+*    The caller advances the clock, so controllers strobed together share
+*    one cycle time
+*******************************************************************************/
+static unsigned char decodePins(HD44780SIMPIC32PINS * const pins)
+{
+    unsigned char dataPort;
+    unsigned char rw;
+    unsigned char rs;
+    unsigned char dataLines;
+    unsigned int  busLevels;
+
+    dataPort = getPortIndex(pins->DATA_LAT);
+    rw = (getPinLevels(getPortIndex(pins->RW_LAT)) & pins->RW_BIT) ? 1 : 0;
+    rs = (getPinLevels(getPortIndex(pins->RS_LAT)) & pins->RS_BIT) ? 1 : 0;
+                                        /* Rising edge of E                   */
+    if ((getPinLevels(getPortIndex(pins->E_LAT)) & pins->E_BIT) &&
+        !(pins->pinFlags & SIMPIC32_ESTATE))
+    {
+        pins->pinFlags |= SIMPIC32_ESTATE;
+        if (rw)
+        {
+            dataLines = hd44780simRead(pins->hd44780Sim, rs);
+            if (pins->pinFlags & SIMPIC32_4BITBUS)
+            {
+                dataLines >>= 4;
+            }
+            busLevels = ((unsigned int) dataLines << pins->dataShift) &
+                                                                pins->DATA_MASK;
+                                        /* The PIC32 should not be driving    */
+            if (~simPic32Sfr.sfr.gpio[dataPort].tris.reg & pins->DATA_MASK)
+            {
+                pic32Stats.busContentions++;
+            }
+            externalLevels[dataPort] &= ~pins->DATA_MASK;
+            externalLevels[dataPort] |= busLevels;
+            externalDriven[dataPort] |= pins->DATA_MASK;
+            pins->pinFlags |= SIMPIC32_DRIVING;
+        }
+    }
+                                        /* Falling edge of E                  */
+    else if (!(getPinLevels(getPortIndex(pins->E_LAT)) & pins->E_BIT) &&
+             (pins->pinFlags & SIMPIC32_ESTATE))
+    {
+        pins->pinFlags &= ~SIMPIC32_ESTATE;
+        dataLines = 0;
+        if (pins->pinFlags & SIMPIC32_DRIVING)
+        {
+            externalDriven[dataPort] &= ~pins->DATA_MASK;
+            pins->pinFlags &= ~SIMPIC32_DRIVING;
+        }
+        else if (!rw)
+        {
+            dataLines = (unsigned char) ((getPinLevels(dataPort) &
+                                          pins->DATA_MASK) >> pins->dataShift);
+            if (pins->pinFlags & SIMPIC32_4BITBUS)
+            {
+                dataLines <<= 4;
+            }
+            hd44780simWrite(pins->hd44780Sim, rs, dataLines);
+        }
+        pic32Stats.busSignature = pic32Stats.busSignature * 31 +
+                                  ((unsigned long) rw << 9) +
+                                  ((unsigned long) rs << 8) + dataLines;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* processPmpAccess() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Applies the effect of a load or store to the PMP bank
+*
+* See also:
+*   makePmpCycle()
+*
+* Arguments:
+*   wordIndex       - word of the bank accessed
+*   isStore         - 1 for a store, 0 for a load
+*
+* Returns:
+*   void
+*
+* Callers:
+*   sfrWriteStep(), makeDmaCell()
+*
+* Notes :
+* 1. Storing to PMDIN starts a write cycle and loading from it a read cycle,
+*    but only while the PMP is on. Other registers are just updated
+*******************************************************************************/
+static void processPmpAccess(unsigned int wordIndex, unsigned char isStore)
+{
+    unsigned int baseIndex;
+    unsigned int value;
+
+    baseIndex = wordIndex - (wordIndex % SIMPIC32_REGWORDS);
+    if (isStore)
+    {
+        value = simPic32Pmp.word[wordIndex];
+        switch (wordIndex % SIMPIC32_REGWORDS)
+        {
+            case SIMPIC32_CLR:
+                simPic32Pmp.word[baseIndex] &= ~value;
+                simPic32Pmp.word[wordIndex] = 0;
+                break;
+
+            case SIMPIC32_SET:
+                simPic32Pmp.word[baseIndex] |= value;
+                simPic32Pmp.word[wordIndex] = 0;
+                break;
+
+            case SIMPIC32_INV:
+                simPic32Pmp.word[baseIndex] ^= value;
+                simPic32Pmp.word[wordIndex] = 0;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (wordIndex == SIMPIC32_PMDINWORD && (PMCON & SIMPIC32_PMPEN))
+    {
+        makePmpCycle(isStore ? 0 : 1);
+    }
+}
+
+/*******************************************************************************
+* makePmpCycle() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Makes one PMP bus cycle on every controller selected by PMADDR
+*
+* See also:
+*   processPmpAccess()
+*
+* Arguments:
+*   rw              - 1 for a read cycle, 0 for a write cycle
+*
+* Returns:
+*   void
+*
+* Callers:
+*   processPmpAccess()
+*
+* Notes :
+* 1. The byte read is left in PMDIN for the next load. If no controller is
+*    selected the data lines float high
+* 2. The cycle lasts WAITB + WAITM + WAITE + 3 peripheral bus clocks, but the
+*    clock is moved on by at least one E cycle, as for GPIO cycles
+*******************************************************************************/
+static void makePmpCycle(unsigned char rw)
+{
+    HD44780SIMPIC32PMPLCD * lcd;
+    HD44780SIMTIME          setupTime;
+    HD44780SIMTIME          pulseWidth;
+    HD44780SIMTIME          holdTime;
+    unsigned char           rs = 0;
+    unsigned char           dataLines = 0xFF;
+
+    setupTime = (((PMMODE >> 6) & 0x03) + 1) * pbPeriod;
+    pulseWidth = (((PMMODE >> 2) & 0x0F) + 1) * pbPeriod;
+    holdTime = ((PMMODE & 0x03) + 1) * pbPeriod;
+                                        /* Check the strobes suit an HD44780  */
+    if ((PMMODE & SIMPIC32_PMPMODEMASK) != SIMPIC32_PMPMASTER1 ||
+        (PMCON & SIMPIC32_PMPSTROBES) != SIMPIC32_PMPSTROBES ||
+        setupTime < SIMPIC32_MINSETUPTIME ||
+        pulseWidth < SIMPIC32_MINPULSEWIDTH ||
+        holdTime < SIMPIC32_MINHOLDTIME)
+    {
+        pic32Stats.pmpViolations++;
+    }
+
+    for (lcd = startOfPmpLcds; lcd != (HD44780SIMPIC32PMPLCD *) 0;
+         lcd = lcd->nextLcd)
+    {
+        if ((PMADDR & lcd->SELECT_ADDRESS) != lcd->SELECT_ADDRESS)
+        {
+            continue;
+        }
+        rs = (PMADDR & lcd->RS_ADDRESS) ? 1 : 0;
+        if (rw)
+        {
+            dataLines = hd44780simRead(lcd->hd44780Sim, rs);
+        }
+        else
+        {
+            hd44780simWrite(lcd->hd44780Sim, rs,
+                            (unsigned char) (PMDIN & 0xFF));
+        }
+    }
+
+    if (rw)
+    {
+        PMDIN = dataLines;
+        dataLines = 0;
+    }
+    else
+    {
+        dataLines = (unsigned char) (PMDIN & 0xFF);
+    }
+    pic32Stats.busSignature = pic32Stats.busSignature * 31 +
+                              ((unsigned long) rw << 9) +
+                              ((unsigned long) rs << 8) + dataLines;
+
+    if (setupTime + pulseWidth + holdTime > hd44780simGetCycleTime())
+    {
+        hd44780simAdvance(setupTime + pulseWidth + holdTime);
+    }
+    else
+    {
+        hd44780simAdvance(hd44780simGetCycleTime());
+    }
+}
+
+/*******************************************************************************
+* noteStartedPeripherals() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Sets up the model of Timer 2 or a DMA channel that the store just
+*   processed switched on
+*
+* See also:
+*   processStore()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   processStore()
+*
+* Notes :
+* 1. A channel starts its next block from the beginning of its source and
+*    destination when it is enabled
+*******************************************************************************/
+static void noteStartedPeripherals(void)
+{
+    SIMPIC32DMACHANNEL  * dch;
+    unsigned char         channel;
+
+    if ((T2CON & SIMPIC32_TIMERON) &&
+        !(sfrShadow[SIMPIC32_WORDOF(T2CON)] & SIMPIC32_TIMERON))
+    {
+        timerNextMatch = hd44780simGetTime() +
+                         (HD44780SIMTIME) (PR2 + 1 - TMR2) * getTimerTick();
+    }
+
+    for (channel = 0; channel < SIMPIC32_NUMBEROFDMACHANNELS; channel++)
+    {
+        dch = &simPic32Sfr.sfr.dch[channel];
+        if ((dch->dchcon.reg & SIMPIC32_CHEN) &&
+            !(sfrShadow[SIMPIC32_WORDOF(dch->dchcon.reg)] & SIMPIC32_CHEN))
+        {
+            dch->dchsptr.reg = 0;
+            dch->dchdptr.reg = 0;
+            dmaBlockCount[channel] = 0;
+        }
+    }
+}
+
+/*******************************************************************************
+* raiseIrq() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Starts a cell transfer on every enabled DMA channel started by an
+*   interrupt request
+*
+* See also:
+*   makeDmaCell()
+*
+* Arguments:
+*   irq             - interrupt request number, e.g. _TIMER_2_IRQ
+*
+* Returns:
+*   void
+*
+* Callers:
+*   hd44780simPic32Run(), makeDmaCell()
+*
+* Notes :
+* 1. Channels are served in number order, whatever their priority
+*******************************************************************************/
+static void raiseIrq(unsigned char irq)
+{
+    SIMPIC32DMACHANNEL  * dch;
+    unsigned char         channel;
+
+    if (!(DMACON & SIMPIC32_DMAON))
+    {
+        return;
+    }
+
+    for (channel = 0; channel < SIMPIC32_NUMBEROFDMACHANNELS; channel++)
+    {
+        dch = &simPic32Sfr.sfr.dch[channel];
+        if ((dch->dchcon.reg & SIMPIC32_CHEN) &&
+            (dch->dchecon.reg & SIMPIC32_SIRQEN) &&
+            ((dch->dchecon.reg >> 8) & 0xFF) == irq)
+        {
+            makeDmaCell(channel);
+        }
+    }
+}
+
+/*******************************************************************************
+* makeDmaCell() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Moves one cell of a DMA channel's block and raises the channel's events
+*
+* See also:
+*   raiseIrq()
+*
+* Arguments:
+*   channel         - DMA channel number
+*
+* Returns:
+*   void
+*
+* Callers:
+*   raiseIrq()
+*
+* Notes :
+* 1. A block is as long as the larger of the source and destination sizes.
+*    The smaller one is wrapped round as often as needed
+* 2. A cell written to the PMP bank has the effect of one store to the word
+*    its first byte lands in. DMA stores are not counted as register writes
+* 3. An event whose enable bit is set in DCHxINT raises the channel's IRQ,
+*    which may start a cell on another channel straight away
+*******************************************************************************/
+static void makeDmaCell(unsigned char channel)
+{
+    SIMPIC32DMACHANNEL      * dch = &simPic32Sfr.sfr.dch[channel];
+    volatile unsigned char  * source;
+    volatile unsigned char  * destination;
+    volatile unsigned char  * firstByte;
+    unsigned char           * pmpBank = (unsigned char *) &simPic32Pmp;
+    unsigned int              blockSize;
+    unsigned int              counter;
+    unsigned int              flags = 0;
+
+    source = getDmaPointer(dch->dchssa.reg);
+    destination = getDmaPointer(dch->dchdsa.reg);
+    if (source == (volatile unsigned char *) 0 ||
+        destination == (volatile unsigned char *) 0)
+    {
+        dch->dchcon.reg &= ~SIMPIC32_CHEN;
+        flags = SIMPIC32_CHERIF;
+        goto raise_events;
+    }
+
+    blockSize = dch->dchssiz.reg;
+    if (dch->dchdsiz.reg > blockSize)
+    {
+        blockSize = dch->dchdsiz.reg;
+    }
+
+    firstByte = &destination[dch->dchdptr.reg];
+    for (counter = 0; counter < dch->dchcsiz.reg &&
+                      dmaBlockCount[channel] < blockSize; counter++)
+    {
+        destination[dch->dchdptr.reg] = source[dch->dchsptr.reg];
+        dmaBlockCount[channel]++;
+        if (++dch->dchsptr.reg >= dch->dchssiz.reg)
+        {
+            dch->dchsptr.reg = 0;
+            flags |= SIMPIC32_CHSDIF;
+        }
+        if (++dch->dchdptr.reg >= dch->dchdsiz.reg)
+        {
+            dch->dchdptr.reg = 0;
+            flags |= SIMPIC32_CHDDIF;
+        }
+    }
+    pic32Stats.dmaTransfers++;
+                                        /* A cell stored to the PMP           */
+    if ((unsigned char *) firstByte >= pmpBank &&
+        (unsigned char *) firstByte < pmpBank + SIMPIC32_PMPBANKSIZE)
+    {
+        processPmpAccess((unsigned int) ((unsigned char *) firstByte -
+                                         pmpBank) / sizeof(unsigned int), 1);
+    }
+
+    flags |= SIMPIC32_CHCCIF;
+    if (dmaBlockCount[channel] >= blockSize)
+    {
+        flags |= SIMPIC32_CHBCIF;
+        dmaBlockCount[channel] = 0;
+        if (!(dch->dchcon.reg & SIMPIC32_CHAEN))
+        {
+            dch->dchcon.reg &= ~SIMPIC32_CHEN;
+        }
+    }
+
+raise_events:
+    dch->dchint.reg |= flags;
+    if (flags & (dch->dchint.reg >> 16))
+    {
+        raiseIrq((unsigned char) (_DMA0_IRQ + channel));
+    }
+}
+
+/*******************************************************************************
+* getDmaPointer() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Turns a stand-in physical address back into a pointer
+*
+* See also:
+*   simPic32KvaToPa()
+*
+* Arguments:
+*   address         - address from a DCHxSSA or DCHxDSA register
+*
+* Returns:
+*   Pointer, or NULL if the address was never handed out
+*
+* Callers:
+*   makeDmaCell()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static volatile unsigned char * getDmaPointer(unsigned int address)
+{
+    unsigned int slot = address >> 24;
+
+    if (slot == 0 || slot > SIMPIC32_DMAREGIONS ||
+        dmaRegions[slot - 1] == (const volatile unsigned char *) 0)
+    {
+        return (volatile unsigned char *) 0;
+    }
+
+    return (volatile unsigned char *) dmaRegions[slot - 1] +
+                                                    (address & 0x00FFFFFF);
+}
+
+/*******************************************************************************
+* getTimerTick() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Returns the time one count of Timer 2 takes
+*
+* See also:
+*   None
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   Peripheral bus clock period times the T2CON prescale ratio
+*
+* Callers:
+*   hd44780simPic32Run(), noteStartedPeripherals()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static HD44780SIMTIME getTimerTick(void)
+{
+    return pbPeriod << timerPrescaleShifts[(T2CON >> SIMPIC32_TCKPSSHIFT) &
+                                           0x07];
+}
+
+/*******************************************************************************
+* updatePorts() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Loads every PORT register with the current level of its pins
+*
+* See also:
+*   getPinLevels()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   processStore(), hd44780simPic32Init(), hd44780simPic32Connect()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void updatePorts(void)
+{
+    unsigned char counter;
+
+    for (counter = 0; counter < SIMPIC32_NUMBEROFPORTS; counter++)
+    {
+        simPic32Sfr.sfr.gpio[counter].port.reg = getPinLevels(counter);
+    }
+}
+
+/*******************************************************************************
+* getPinLevels() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Works out the level of every pin of a port
+*
+* See also:
+*   updatePorts()
+*
+* Arguments:
+*   portIndex       - 0 for PORTA, 1 for PORTB, ...
+*
+* Returns:
+*   Pin levels, one bit per pin
+*
+* Callers:
+*   decodePins(), updatePorts(), hd44780simPic32Connect()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned int getPinLevels(unsigned char portIndex)
+{
+    unsigned int tris;
+    unsigned int levels;
+
+    tris = simPic32Sfr.sfr.gpio[portIndex].tris.reg;
+                                        /* Outputs follow LAT                 */
+    levels = simPic32Sfr.sfr.gpio[portIndex].lat.reg & ~tris;
+                                        /* Inputs follow whatever drives them */
+                                        /* or their pull-up                   */
+    levels |= externalLevels[portIndex] & externalDriven[portIndex] & tris;
+    levels |= pullUps[portIndex] & ~externalDriven[portIndex] & tris;
+
+    return levels;
+}
+
+/*******************************************************************************
+* getPortIndex() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Finds which GPIO port a register belongs to
+*
+* See also:
+*   None
+*
+* Arguments:
+*   reg             - any register of the port
+*
+* Returns:
+*   - 0 to SIMPIC32_NUMBEROFPORTS - 1   - port number
+*   - SIMPIC32_NOPORT                   - not a GPIO register
+*
+* Callers:
+*   hd44780simPic32Connect(), decodePins()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned char getPortIndex(volatile unsigned int const * reg)
+{
+    unsigned long wordIndex;
+
+    if (reg < &simPic32Sfr.word[0])
+    {
+        return SIMPIC32_NOPORT;
+    }
+    wordIndex = (unsigned long) (reg - &simPic32Sfr.word[0]);
+    if (wordIndex >= SIMPIC32_NUMBEROFPORTS * SIMPIC32_PORTWORDS)
+    {
+        return SIMPIC32_NOPORT;
+    }
+
+    return (unsigned char) (wordIndex / SIMPIC32_PORTWORDS);
+}
+
+/*******************************************************************************
+* isSingleBit() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Checks that exactly one bit is set
+*
+* See also:
+*   None
+*
+* Arguments:
+*   bits            - value to check
+*
+* Returns:
+*   - 1             - exactly one bit is set
+*   - 0             - otherwise
+*
+* Callers:
+*   hd44780simPic32Connect(), hd44780simPic32ConnectPmp()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned char isSingleBit(unsigned int bits)
+{
+    return (bits != 0 && !(bits & (bits - 1))) ? 1 : 0;
+}
+
+
+/*******************************************************************************
+*
+*                  HD44780 PIC32 PIN LEVEL SIMULATOR MODULE END
+*
+*******************************************************************************/
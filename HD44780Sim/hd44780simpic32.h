@@ -0,0 +1,196 @@
+/*******************************************************************************
+*
+* HD44780 PIC32 PIN LEVEL SIMULATOR MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module connects simulated HD44780 controllers to the simulated PIC32MX
+* GPIO registers declared in pic32/p32xxxx.h, so that the unmodified PIC32 LCD
+* interface module (lcdif_c32.c) can be run on a host PC. Every store to the
+* register bank is trapped, the RW, RS, E and data pin levels are worked out
+* from the LAT and TRIS registers, and each E edge is turned into a bus cycle
+* on the simulated controller wired to that E pin. Data driven by a controller
+* during a read cycle appears on the PORT register, just as on the device.
+* The number of stores made to each register is counted, giving the true
+* read-modify-write cost of the GPIO path.
+* Controllers can instead be wired to the simulated Parallel Master Port, used
+* in master mode 1 with an address line as RS. Stores to PMDIN and loads from
+* it are turned into write and read cycles, and the PMP wait states are
+* checked against the HD44780U bus timing. Timer 2 and the DMA controller are
+* modelled as well, so a DMA channel paced by the timer can feed the PMP while
+* hd44780simPic32Run() lets simulated time pass.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : hd44780simpic32.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* This module is only intended for use on an x86 or x86-64 Linux host PC, as
+* it single steps the trapped store using the processor's trap flag
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                    HD44780 PIC32 PIN LEVEL SIMULATOR MODULE
+*
+*******************************************************************************/
+#ifndef __HD44780SIMPIC32_MODULE_PRESENT__
+#define __HD44780SIMPIC32_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <p32xxxx.h>
+#include "hd44780sim.h"
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Default peripheral bus clock period in nanoseconds, used to time PMP
+*   cycles
+* See also:
+*   <link hd44780simPic32SetPbPeriod>
+*******************************************************************************/
+#define HD44780SIMPIC32_DEFAULTPBPERIOD 50
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type HD44780SIMPIC32PINS
+* Description:
+*   Describes how one simulated controller is wired to the simulated PIC32MX.
+* The user must fill in:
+* - The simulated controller
+* - The LAT register and bit to which the R/W pin is connected
+* - The LAT register and bit to which the RS pin is connected
+* - The LAT register and bit to which the E pin is connected
+* - The LAT register to which the data pins are connected
+* - A mask of 4 or 8 consecutive bits defining the data pins used; with 4 bits
+*   they are connected to DB7 to DB4
+* The remaining members are private to the module.
+*******************************************************************************/
+typedef struct HD44780SIMPIC32PINSTYPE {
+    HD44780SIM                    * hd44780Sim;
+    volatile unsigned int         * RW_LAT;
+    unsigned int                    RW_BIT;
+    volatile unsigned int         * RS_LAT;
+    unsigned int                    RS_BIT;
+    volatile unsigned int         * E_LAT;
+    unsigned int                    E_BIT;
+    volatile unsigned int         * DATA_LAT;
+    unsigned int                    DATA_MASK;
+    unsigned char                   dataShift;
+    unsigned char                   pinFlags;
+    struct HD44780SIMPIC32PINSTYPE * nextPins;
+} HD44780SIMPIC32PINS;
+
+/*******************************************************************************
+* New data type HD44780SIMPIC32PMPLCD
+* Description:
+*   Describes how one simulated controller is wired to the simulated PMP, with
+* PMENB as E, PMRD/PMWR as R/W and PMD0 to PMD7 as DB0 to DB7. The user must
+* fill in:
+* - The simulated controller
+* - The PMADDR bit whose address line is wired to RS
+* - The PMADDR bits that must be set for PMENB to reach this controller's E
+*   pin, or 0 if it is wired straight to PMENB
+* The remaining member is private to the module.
+*******************************************************************************/
+typedef struct HD44780SIMPIC32PMPLCDTYPE {
+    HD44780SIM                    * hd44780Sim;
+    unsigned int                    RS_ADDRESS;
+    unsigned int                    SELECT_ADDRESS;
+    struct HD44780SIMPIC32PMPLCDTYPE * nextLcd;
+} HD44780SIMPIC32PMPLCD;
+
+/*******************************************************************************
+* New data type HD44780SIMPIC32STATS
+* Description:
+*   Counters collected by the pin level model. Members are:
+*   - registerWrites    - stores made to any register in the banks
+*   - registerReads     - loads made from any register in the PMP bank. Loads
+*                         from the GPIO bank are not trapped
+*   - busContentions    - E cycles where both the PIC32 and a controller were
+*                         driving the data pins
+*   - busSignature      - running hash of the RS and R/W levels and written
+*                         data of every E cycle, in order. Two runs that make
+*                         the same bus cycles give the same signature however
+*                         the pins were driven
+*   - pmpViolations     - PMP cycles made outside master mode 1 with active
+*                         high strobes, or with wait states too short for the
+*                         HD44780U
+*   - dmaTransfers      - cells moved by the DMA channels
+*******************************************************************************/
+typedef struct HD44780SIMPIC32STATSTYPE {
+    unsigned long                   registerWrites;
+    unsigned long                   registerReads;
+    unsigned long                   busContentions;
+    unsigned long                   busSignature;
+    unsigned long                   pmpViolations;
+    unsigned long                   dmaTransfers;
+} HD44780SIMPIC32STATS;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            hd44780simPic32Init(void);
+unsigned char   hd44780simPic32Connect(HD44780SIMPIC32PINS * const pins);
+unsigned char   hd44780simPic32ConnectPmp(HD44780SIMPIC32PMPLCD * const lcd);
+void            hd44780simPic32SetPbPeriod(HD44780SIMTIME period);
+
+unsigned char   hd44780simPic32Start(void);
+void            hd44780simPic32Stop(void);
+void            hd44780simPic32Run(HD44780SIMTIME duration);
+
+unsigned long   hd44780simPic32GetWrites(volatile unsigned int const *
+                                                                    reg);
+void            hd44780simPic32GetStats(HD44780SIMPIC32STATS * const stats);
+void            hd44780simPic32ClearStats(void);
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(__x86_64__) && !defined(__i386__)
+#error The PIC32 pin level simulator requires an x86 or x86-64 host
+#endif
+
+
+/*******************************************************************************
+*
+*                  HD44780 PIC32 PIN LEVEL SIMULATOR MODULE END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,591 @@
+/*******************************************************************************
+*
+* PIC32MX SPECIAL FUNCTION REGISTER STAND-IN FOR HOST PC SIMULATION
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This file stands in for the C32 compiler's <p32xxxx.h> when the PIC32 LCD
+* interface module (lcdif_c32.c) is compiled on a host PC. Instead of fixed
+* SFR addresses, the GPIO registers are members of one page-aligned register
+* bank that the pin-level simulator (hd44780simpic32.c) write-protects, so
+* every store the driver makes can be seen and decoded into HD44780 bus
+* cycles.
+* Each register has the same CLR, SET and INV companions at the same offsets
+* as on a PIC32MX, and writes to them behave as they do on the device.
+* The Parallel Master Port registers live in a second bank of their own, which
+* the simulator protects against loads as well as stores, as reading PMDIN
+* starts a PMP read cycle. Timer 2 and the DMA controller follow the GPIO ports
+* in the first bank; they only run while hd44780simPic32Run() lets simulated
+* time pass.
+*
+* Filename : p32xxxx.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* Add HD44780Sim/pic32 to the include path ahead of any C32 installation and
+* define __PIC32MX__ when compiling for the host
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                          PIC32MX SFR STAND-IN HEADER
+*
+*******************************************************************************/
+#ifndef __SIMPIC32_SFR_PRESENT__
+#define __SIMPIC32_SFR_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Size of the simulated SFR bank. This must be a multiple of the host page
+*   size so that the bank can be write-protected on its own
+*******************************************************************************/
+#define SIMPIC32_SFRBANKSIZE        4096
+
+/*******************************************************************************
+* Summary:
+*   Number of GPIO ports (PORTA to PORTG) in the simulated SFR bank
+*******************************************************************************/
+#define SIMPIC32_NUMBEROFPORTS      7
+
+/*******************************************************************************
+* Summary:
+*   Number of DMA channels in the simulated SFR bank
+*******************************************************************************/
+#define SIMPIC32_NUMBEROFDMACHANNELS 4
+
+/*******************************************************************************
+* Summary:
+*   Interrupt request numbers of Timer 2 and the DMA channels, as on the
+*   PIC32MX3xx/4xx. A DMA channel may be started by any of them
+*******************************************************************************/
+#define _TIMER_2_IRQ                8
+#define _DMA0_IRQ                   36
+#define _DMA1_IRQ                   37
+#define _DMA2_IRQ                   38
+#define _DMA3_IRQ                   39
+
+/*******************************************************************************
+* Summary:
+*   Size of the simulated PMP register bank. As with the SFR bank, this must
+*   be a multiple of the host page size
+*******************************************************************************/
+#define SIMPIC32_PMPBANKSIZE        4096
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type SIMPIC32REG
+* Description:
+*   One PIC32MX SFR with its CLR, SET and INV companion registers
+*******************************************************************************/
+typedef struct SIMPIC32REGTYPE {
+    volatile unsigned int           reg;
+    volatile unsigned int           clr;
+    volatile unsigned int           set;
+    volatile unsigned int           inv;
+} SIMPIC32REG;
+
+/*******************************************************************************
+* New data type SIMPIC32PORT
+* Description:
+*   The registers of one PIC32MX GPIO port, in device order
+*******************************************************************************/
+typedef struct SIMPIC32PORTTYPE {
+    SIMPIC32REG                     tris;
+    SIMPIC32REG                     port;
+    SIMPIC32REG                     lat;
+    SIMPIC32REG                     odc;
+} SIMPIC32PORT;
+
+/*******************************************************************************
+* New data type SIMPIC32TIMER
+* Description:
+*   The registers of one PIC32MX timer, in device order
+*******************************************************************************/
+typedef struct SIMPIC32TIMERTYPE {
+    SIMPIC32REG                     txcon;
+    SIMPIC32REG                     tmrx;
+    SIMPIC32REG                     prx;
+} SIMPIC32TIMER;
+
+/*******************************************************************************
+* New data type SIMPIC32DMACHANNEL
+* Description:
+*   The registers of one PIC32MX DMA channel, in device order
+*******************************************************************************/
+typedef struct SIMPIC32DMACHANNELTYPE {
+    SIMPIC32REG                     dchcon;
+    SIMPIC32REG                     dchecon;
+    SIMPIC32REG                     dchint;
+    SIMPIC32REG                     dchssa;
+    SIMPIC32REG                     dchdsa;
+    SIMPIC32REG                     dchssiz;
+    SIMPIC32REG                     dchdsiz;
+    SIMPIC32REG                     dchsptr;
+    SIMPIC32REG                     dchdptr;
+    SIMPIC32REG                     dchcsiz;
+    SIMPIC32REG                     dchcptr;
+    SIMPIC32REG                     dchdat;
+} SIMPIC32DMACHANNEL;
+
+/*******************************************************************************
+* New data type SIMPIC32SFR
+* Description:
+*   The complete simulated SFR bank, padded to a whole page
+*******************************************************************************/
+typedef union SIMPIC32SFRTYPE {
+    struct {
+        SIMPIC32PORT                gpio[SIMPIC32_NUMBEROFPORTS];
+        SIMPIC32TIMER               timer2;
+        SIMPIC32REG                 dmacon;
+        SIMPIC32DMACHANNEL          dch[SIMPIC32_NUMBEROFDMACHANNELS];
+    } sfr;
+    volatile unsigned int           word[SIMPIC32_SFRBANKSIZE /
+                                         sizeof(unsigned int)];
+} SIMPIC32SFR;
+
+/*******************************************************************************
+* New data type SIMPIC32PMP
+* Description:
+*   The registers of the PIC32MX Parallel Master Port, in device order
+*******************************************************************************/
+typedef struct SIMPIC32PMPTYPE {
+    SIMPIC32REG                     pmcon;
+    SIMPIC32REG                     pmmode;
+    SIMPIC32REG                     pmaddr;
+    SIMPIC32REG                     pmdout;
+    SIMPIC32REG                     pmdin;
+    SIMPIC32REG                     pmaen;
+    SIMPIC32REG                     pmstat;
+} SIMPIC32PMP;
+
+/*******************************************************************************
+* New data type SIMPIC32PMPBANK
+* Description:
+*   The simulated PMP register bank, padded to a whole page
+*******************************************************************************/
+typedef union SIMPIC32PMPBANKTYPE {
+    SIMPIC32PMP                     pmp;
+    volatile unsigned int           word[SIMPIC32_PMPBANKSIZE /
+                                         sizeof(unsigned int)];
+} SIMPIC32PMPBANK;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+extern SIMPIC32SFR simPic32Sfr;
+extern SIMPIC32PMPBANK simPic32Pmp;
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+                                        /* PORTA                              */
+#define TRISA           (simPic32Sfr.sfr.gpio[0].tris.reg)
+#define TRISACLR        (simPic32Sfr.sfr.gpio[0].tris.clr)
+#define TRISASET        (simPic32Sfr.sfr.gpio[0].tris.set)
+#define TRISAINV        (simPic32Sfr.sfr.gpio[0].tris.inv)
+#define PORTA           (simPic32Sfr.sfr.gpio[0].port.reg)
+#define PORTACLR        (simPic32Sfr.sfr.gpio[0].port.clr)
+#define PORTASET        (simPic32Sfr.sfr.gpio[0].port.set)
+#define PORTAINV        (simPic32Sfr.sfr.gpio[0].port.inv)
+#define LATA            (simPic32Sfr.sfr.gpio[0].lat.reg)
+#define LATACLR         (simPic32Sfr.sfr.gpio[0].lat.clr)
+#define LATASET         (simPic32Sfr.sfr.gpio[0].lat.set)
+#define LATAINV         (simPic32Sfr.sfr.gpio[0].lat.inv)
+#define ODCA            (simPic32Sfr.sfr.gpio[0].odc.reg)
+#define ODCACLR         (simPic32Sfr.sfr.gpio[0].odc.clr)
+#define ODCASET         (simPic32Sfr.sfr.gpio[0].odc.set)
+#define ODCAINV         (simPic32Sfr.sfr.gpio[0].odc.inv)
+
+                                        /* PORTB                              */
+#define TRISB           (simPic32Sfr.sfr.gpio[1].tris.reg)
+#define TRISBCLR        (simPic32Sfr.sfr.gpio[1].tris.clr)
+#define TRISBSET        (simPic32Sfr.sfr.gpio[1].tris.set)
+#define TRISBINV        (simPic32Sfr.sfr.gpio[1].tris.inv)
+#define PORTB           (simPic32Sfr.sfr.gpio[1].port.reg)
+#define PORTBCLR        (simPic32Sfr.sfr.gpio[1].port.clr)
+#define PORTBSET        (simPic32Sfr.sfr.gpio[1].port.set)
+#define PORTBINV        (simPic32Sfr.sfr.gpio[1].port.inv)
+#define LATB            (simPic32Sfr.sfr.gpio[1].lat.reg)
+#define LATBCLR         (simPic32Sfr.sfr.gpio[1].lat.clr)
+#define LATBSET         (simPic32Sfr.sfr.gpio[1].lat.set)
+#define LATBINV         (simPic32Sfr.sfr.gpio[1].lat.inv)
+#define ODCB            (simPic32Sfr.sfr.gpio[1].odc.reg)
+#define ODCBCLR         (simPic32Sfr.sfr.gpio[1].odc.clr)
+#define ODCBSET         (simPic32Sfr.sfr.gpio[1].odc.set)
+#define ODCBINV         (simPic32Sfr.sfr.gpio[1].odc.inv)
+
+                                        /* PORTC                              */
+#define TRISC           (simPic32Sfr.sfr.gpio[2].tris.reg)
+#define TRISCCLR        (simPic32Sfr.sfr.gpio[2].tris.clr)
+#define TRISCSET        (simPic32Sfr.sfr.gpio[2].tris.set)
+#define TRISCINV        (simPic32Sfr.sfr.gpio[2].tris.inv)
+#define PORTC           (simPic32Sfr.sfr.gpio[2].port.reg)
+#define PORTCCLR        (simPic32Sfr.sfr.gpio[2].port.clr)
+#define PORTCSET        (simPic32Sfr.sfr.gpio[2].port.set)
+#define PORTCINV        (simPic32Sfr.sfr.gpio[2].port.inv)
+#define LATC            (simPic32Sfr.sfr.gpio[2].lat.reg)
+#define LATCCLR         (simPic32Sfr.sfr.gpio[2].lat.clr)
+#define LATCSET         (simPic32Sfr.sfr.gpio[2].lat.set)
+#define LATCINV         (simPic32Sfr.sfr.gpio[2].lat.inv)
+#define ODCC            (simPic32Sfr.sfr.gpio[2].odc.reg)
+#define ODCCCLR         (simPic32Sfr.sfr.gpio[2].odc.clr)
+#define ODCCSET         (simPic32Sfr.sfr.gpio[2].odc.set)
+#define ODCCINV         (simPic32Sfr.sfr.gpio[2].odc.inv)
+
+                                        /* PORTD                              */
+#define TRISD           (simPic32Sfr.sfr.gpio[3].tris.reg)
+#define TRISDCLR        (simPic32Sfr.sfr.gpio[3].tris.clr)
+#define TRISDSET        (simPic32Sfr.sfr.gpio[3].tris.set)
+#define TRISDINV        (simPic32Sfr.sfr.gpio[3].tris.inv)
+#define PORTD           (simPic32Sfr.sfr.gpio[3].port.reg)
+#define PORTDCLR        (simPic32Sfr.sfr.gpio[3].port.clr)
+#define PORTDSET        (simPic32Sfr.sfr.gpio[3].port.set)
+#define PORTDINV        (simPic32Sfr.sfr.gpio[3].port.inv)
+#define LATD            (simPic32Sfr.sfr.gpio[3].lat.reg)
+#define LATDCLR         (simPic32Sfr.sfr.gpio[3].lat.clr)
+#define LATDSET         (simPic32Sfr.sfr.gpio[3].lat.set)
+#define LATDINV         (simPic32Sfr.sfr.gpio[3].lat.inv)
+#define ODCD            (simPic32Sfr.sfr.gpio[3].odc.reg)
+#define ODCDCLR         (simPic32Sfr.sfr.gpio[3].odc.clr)
+#define ODCDSET         (simPic32Sfr.sfr.gpio[3].odc.set)
+#define ODCDINV         (simPic32Sfr.sfr.gpio[3].odc.inv)
+
+                                        /* PORTE                              */
+#define TRISE           (simPic32Sfr.sfr.gpio[4].tris.reg)
+#define TRISECLR        (simPic32Sfr.sfr.gpio[4].tris.clr)
+#define TRISESET        (simPic32Sfr.sfr.gpio[4].tris.set)
+#define TRISEINV        (simPic32Sfr.sfr.gpio[4].tris.inv)
+#define PORTE           (simPic32Sfr.sfr.gpio[4].port.reg)
+#define PORTECLR        (simPic32Sfr.sfr.gpio[4].port.clr)
+#define PORTESET        (simPic32Sfr.sfr.gpio[4].port.set)
+#define PORTEINV        (simPic32Sfr.sfr.gpio[4].port.inv)
+#define LATE            (simPic32Sfr.sfr.gpio[4].lat.reg)
+#define LATECLR         (simPic32Sfr.sfr.gpio[4].lat.clr)
+#define LATESET         (simPic32Sfr.sfr.gpio[4].lat.set)
+#define LATEINV         (simPic32Sfr.sfr.gpio[4].lat.inv)
+#define ODCE            (simPic32Sfr.sfr.gpio[4].odc.reg)
+#define ODCECLR         (simPic32Sfr.sfr.gpio[4].odc.clr)
+#define ODCESET         (simPic32Sfr.sfr.gpio[4].odc.set)
+#define ODCEINV         (simPic32Sfr.sfr.gpio[4].odc.inv)
+
+                                        /* PORTF                              */
+#define TRISF           (simPic32Sfr.sfr.gpio[5].tris.reg)
+#define TRISFCLR        (simPic32Sfr.sfr.gpio[5].tris.clr)
+#define TRISFSET        (simPic32Sfr.sfr.gpio[5].tris.set)
+#define TRISFINV        (simPic32Sfr.sfr.gpio[5].tris.inv)
+#define PORTF           (simPic32Sfr.sfr.gpio[5].port.reg)
+#define PORTFCLR        (simPic32Sfr.sfr.gpio[5].port.clr)
+#define PORTFSET        (simPic32Sfr.sfr.gpio[5].port.set)
+#define PORTFINV        (simPic32Sfr.sfr.gpio[5].port.inv)
+#define LATF            (simPic32Sfr.sfr.gpio[5].lat.reg)
+#define LATFCLR         (simPic32Sfr.sfr.gpio[5].lat.clr)
+#define LATFSET         (simPic32Sfr.sfr.gpio[5].lat.set)
+#define LATFINV         (simPic32Sfr.sfr.gpio[5].lat.inv)
+#define ODCF            (simPic32Sfr.sfr.gpio[5].odc.reg)
+#define ODCFCLR         (simPic32Sfr.sfr.gpio[5].odc.clr)
+#define ODCFSET         (simPic32Sfr.sfr.gpio[5].odc.set)
+#define ODCFINV         (simPic32Sfr.sfr.gpio[5].odc.inv)
+
+                                        /* PORTG                              */
+#define TRISG           (simPic32Sfr.sfr.gpio[6].tris.reg)
+#define TRISGCLR        (simPic32Sfr.sfr.gpio[6].tris.clr)
+#define TRISGSET        (simPic32Sfr.sfr.gpio[6].tris.set)
+#define TRISGINV        (simPic32Sfr.sfr.gpio[6].tris.inv)
+#define PORTG           (simPic32Sfr.sfr.gpio[6].port.reg)
+#define PORTGCLR        (simPic32Sfr.sfr.gpio[6].port.clr)
+#define PORTGSET        (simPic32Sfr.sfr.gpio[6].port.set)
+#define PORTGINV        (simPic32Sfr.sfr.gpio[6].port.inv)
+#define LATG            (simPic32Sfr.sfr.gpio[6].lat.reg)
+#define LATGCLR         (simPic32Sfr.sfr.gpio[6].lat.clr)
+#define LATGSET         (simPic32Sfr.sfr.gpio[6].lat.set)
+#define LATGINV         (simPic32Sfr.sfr.gpio[6].lat.inv)
+#define ODCG            (simPic32Sfr.sfr.gpio[6].odc.reg)
+#define ODCGCLR         (simPic32Sfr.sfr.gpio[6].odc.clr)
+#define ODCGSET         (simPic32Sfr.sfr.gpio[6].odc.set)
+#define ODCGINV         (simPic32Sfr.sfr.gpio[6].odc.inv)
+
+                                        /* Timer 2                            */
+#define T2CON           (simPic32Sfr.sfr.timer2.txcon.reg)
+#define T2CONCLR        (simPic32Sfr.sfr.timer2.txcon.clr)
+#define T2CONSET        (simPic32Sfr.sfr.timer2.txcon.set)
+#define T2CONINV        (simPic32Sfr.sfr.timer2.txcon.inv)
+#define TMR2            (simPic32Sfr.sfr.timer2.tmrx.reg)
+#define TMR2CLR         (simPic32Sfr.sfr.timer2.tmrx.clr)
+#define TMR2SET         (simPic32Sfr.sfr.timer2.tmrx.set)
+#define TMR2INV         (simPic32Sfr.sfr.timer2.tmrx.inv)
+#define PR2             (simPic32Sfr.sfr.timer2.prx.reg)
+#define PR2CLR          (simPic32Sfr.sfr.timer2.prx.clr)
+#define PR2SET          (simPic32Sfr.sfr.timer2.prx.set)
+#define PR2INV          (simPic32Sfr.sfr.timer2.prx.inv)
+
+                                        /* DMA controller                     */
+#define DMACON          (simPic32Sfr.sfr.dmacon.reg)
+#define DMACONCLR       (simPic32Sfr.sfr.dmacon.clr)
+#define DMACONSET       (simPic32Sfr.sfr.dmacon.set)
+#define DMACONINV       (simPic32Sfr.sfr.dmacon.inv)
+
+                                        /* DMA channel 0                      */
+#define DCH0CON         (simPic32Sfr.sfr.dch[0].dchcon.reg)
+#define DCH0CONCLR      (simPic32Sfr.sfr.dch[0].dchcon.clr)
+#define DCH0CONSET      (simPic32Sfr.sfr.dch[0].dchcon.set)
+#define DCH0CONINV      (simPic32Sfr.sfr.dch[0].dchcon.inv)
+#define DCH0ECON        (simPic32Sfr.sfr.dch[0].dchecon.reg)
+#define DCH0ECONCLR     (simPic32Sfr.sfr.dch[0].dchecon.clr)
+#define DCH0ECONSET     (simPic32Sfr.sfr.dch[0].dchecon.set)
+#define DCH0ECONINV     (simPic32Sfr.sfr.dch[0].dchecon.inv)
+#define DCH0INT         (simPic32Sfr.sfr.dch[0].dchint.reg)
+#define DCH0INTCLR      (simPic32Sfr.sfr.dch[0].dchint.clr)
+#define DCH0INTSET      (simPic32Sfr.sfr.dch[0].dchint.set)
+#define DCH0INTINV      (simPic32Sfr.sfr.dch[0].dchint.inv)
+#define DCH0SSA         (simPic32Sfr.sfr.dch[0].dchssa.reg)
+#define DCH0SSACLR      (simPic32Sfr.sfr.dch[0].dchssa.clr)
+#define DCH0SSASET      (simPic32Sfr.sfr.dch[0].dchssa.set)
+#define DCH0SSAINV      (simPic32Sfr.sfr.dch[0].dchssa.inv)
+#define DCH0DSA         (simPic32Sfr.sfr.dch[0].dchdsa.reg)
+#define DCH0DSACLR      (simPic32Sfr.sfr.dch[0].dchdsa.clr)
+#define DCH0DSASET      (simPic32Sfr.sfr.dch[0].dchdsa.set)
+#define DCH0DSAINV      (simPic32Sfr.sfr.dch[0].dchdsa.inv)
+#define DCH0SSIZ        (simPic32Sfr.sfr.dch[0].dchssiz.reg)
+#define DCH0SSIZCLR     (simPic32Sfr.sfr.dch[0].dchssiz.clr)
+#define DCH0SSIZSET     (simPic32Sfr.sfr.dch[0].dchssiz.set)
+#define DCH0SSIZINV     (simPic32Sfr.sfr.dch[0].dchssiz.inv)
+#define DCH0DSIZ        (simPic32Sfr.sfr.dch[0].dchdsiz.reg)
+#define DCH0DSIZCLR     (simPic32Sfr.sfr.dch[0].dchdsiz.clr)
+#define DCH0DSIZSET     (simPic32Sfr.sfr.dch[0].dchdsiz.set)
+#define DCH0DSIZINV     (simPic32Sfr.sfr.dch[0].dchdsiz.inv)
+#define DCH0SPTR        (simPic32Sfr.sfr.dch[0].dchsptr.reg)
+#define DCH0SPTRCLR     (simPic32Sfr.sfr.dch[0].dchsptr.clr)
+#define DCH0SPTRSET     (simPic32Sfr.sfr.dch[0].dchsptr.set)
+#define DCH0SPTRINV     (simPic32Sfr.sfr.dch[0].dchsptr.inv)
+#define DCH0DPTR        (simPic32Sfr.sfr.dch[0].dchdptr.reg)
+#define DCH0DPTRCLR     (simPic32Sfr.sfr.dch[0].dchdptr.clr)
+#define DCH0DPTRSET     (simPic32Sfr.sfr.dch[0].dchdptr.set)
+#define DCH0DPTRINV     (simPic32Sfr.sfr.dch[0].dchdptr.inv)
+#define DCH0CSIZ        (simPic32Sfr.sfr.dch[0].dchcsiz.reg)
+#define DCH0CSIZCLR     (simPic32Sfr.sfr.dch[0].dchcsiz.clr)
+#define DCH0CSIZSET     (simPic32Sfr.sfr.dch[0].dchcsiz.set)
+#define DCH0CSIZINV     (simPic32Sfr.sfr.dch[0].dchcsiz.inv)
+#define DCH0CPTR        (simPic32Sfr.sfr.dch[0].dchcptr.reg)
+#define DCH0CPTRCLR     (simPic32Sfr.sfr.dch[0].dchcptr.clr)
+#define DCH0CPTRSET     (simPic32Sfr.sfr.dch[0].dchcptr.set)
+#define DCH0CPTRINV     (simPic32Sfr.sfr.dch[0].dchcptr.inv)
+#define DCH0DAT         (simPic32Sfr.sfr.dch[0].dchdat.reg)
+#define DCH0DATCLR      (simPic32Sfr.sfr.dch[0].dchdat.clr)
+#define DCH0DATSET      (simPic32Sfr.sfr.dch[0].dchdat.set)
+#define DCH0DATINV      (simPic32Sfr.sfr.dch[0].dchdat.inv)
+
+                                        /* DMA channel 1                      */
+#define DCH1CON         (simPic32Sfr.sfr.dch[1].dchcon.reg)
+#define DCH1CONCLR      (simPic32Sfr.sfr.dch[1].dchcon.clr)
+#define DCH1CONSET      (simPic32Sfr.sfr.dch[1].dchcon.set)
+#define DCH1CONINV      (simPic32Sfr.sfr.dch[1].dchcon.inv)
+#define DCH1ECON        (simPic32Sfr.sfr.dch[1].dchecon.reg)
+#define DCH1ECONCLR     (simPic32Sfr.sfr.dch[1].dchecon.clr)
+#define DCH1ECONSET     (simPic32Sfr.sfr.dch[1].dchecon.set)
+#define DCH1ECONINV     (simPic32Sfr.sfr.dch[1].dchecon.inv)
+#define DCH1INT         (simPic32Sfr.sfr.dch[1].dchint.reg)
+#define DCH1INTCLR      (simPic32Sfr.sfr.dch[1].dchint.clr)
+#define DCH1INTSET      (simPic32Sfr.sfr.dch[1].dchint.set)
+#define DCH1INTINV      (simPic32Sfr.sfr.dch[1].dchint.inv)
+#define DCH1SSA         (simPic32Sfr.sfr.dch[1].dchssa.reg)
+#define DCH1SSACLR      (simPic32Sfr.sfr.dch[1].dchssa.clr)
+#define DCH1SSASET      (simPic32Sfr.sfr.dch[1].dchssa.set)
+#define DCH1SSAINV      (simPic32Sfr.sfr.dch[1].dchssa.inv)
+#define DCH1DSA         (simPic32Sfr.sfr.dch[1].dchdsa.reg)
+#define DCH1DSACLR      (simPic32Sfr.sfr.dch[1].dchdsa.clr)
+#define DCH1DSASET      (simPic32Sfr.sfr.dch[1].dchdsa.set)
+#define DCH1DSAINV      (simPic32Sfr.sfr.dch[1].dchdsa.inv)
+#define DCH1SSIZ        (simPic32Sfr.sfr.dch[1].dchssiz.reg)
+#define DCH1SSIZCLR     (simPic32Sfr.sfr.dch[1].dchssiz.clr)
+#define DCH1SSIZSET     (simPic32Sfr.sfr.dch[1].dchssiz.set)
+#define DCH1SSIZINV     (simPic32Sfr.sfr.dch[1].dchssiz.inv)
+#define DCH1DSIZ        (simPic32Sfr.sfr.dch[1].dchdsiz.reg)
+#define DCH1DSIZCLR     (simPic32Sfr.sfr.dch[1].dchdsiz.clr)
+#define DCH1DSIZSET     (simPic32Sfr.sfr.dch[1].dchdsiz.set)
+#define DCH1DSIZINV     (simPic32Sfr.sfr.dch[1].dchdsiz.inv)
+#define DCH1SPTR        (simPic32Sfr.sfr.dch[1].dchsptr.reg)
+#define DCH1SPTRCLR     (simPic32Sfr.sfr.dch[1].dchsptr.clr)
+#define DCH1SPTRSET     (simPic32Sfr.sfr.dch[1].dchsptr.set)
+#define DCH1SPTRINV     (simPic32Sfr.sfr.dch[1].dchsptr.inv)
+#define DCH1DPTR        (simPic32Sfr.sfr.dch[1].dchdptr.reg)
+#define DCH1DPTRCLR     (simPic32Sfr.sfr.dch[1].dchdptr.clr)
+#define DCH1DPTRSET     (simPic32Sfr.sfr.dch[1].dchdptr.set)
+#define DCH1DPTRINV     (simPic32Sfr.sfr.dch[1].dchdptr.inv)
+#define DCH1CSIZ        (simPic32Sfr.sfr.dch[1].dchcsiz.reg)
+#define DCH1CSIZCLR     (simPic32Sfr.sfr.dch[1].dchcsiz.clr)
+#define DCH1CSIZSET     (simPic32Sfr.sfr.dch[1].dchcsiz.set)
+#define DCH1CSIZINV     (simPic32Sfr.sfr.dch[1].dchcsiz.inv)
+#define DCH1CPTR        (simPic32Sfr.sfr.dch[1].dchcptr.reg)
+#define DCH1CPTRCLR     (simPic32Sfr.sfr.dch[1].dchcptr.clr)
+#define DCH1CPTRSET     (simPic32Sfr.sfr.dch[1].dchcptr.set)
+#define DCH1CPTRINV     (simPic32Sfr.sfr.dch[1].dchcptr.inv)
+#define DCH1DAT         (simPic32Sfr.sfr.dch[1].dchdat.reg)
+#define DCH1DATCLR      (simPic32Sfr.sfr.dch[1].dchdat.clr)
+#define DCH1DATSET      (simPic32Sfr.sfr.dch[1].dchdat.set)
+#define DCH1DATINV      (simPic32Sfr.sfr.dch[1].dchdat.inv)
+
+                                        /* DMA channel 2                      */
+#define DCH2CON         (simPic32Sfr.sfr.dch[2].dchcon.reg)
+#define DCH2CONCLR      (simPic32Sfr.sfr.dch[2].dchcon.clr)
+#define DCH2CONSET      (simPic32Sfr.sfr.dch[2].dchcon.set)
+#define DCH2CONINV      (simPic32Sfr.sfr.dch[2].dchcon.inv)
+#define DCH2ECON        (simPic32Sfr.sfr.dch[2].dchecon.reg)
+#define DCH2ECONCLR     (simPic32Sfr.sfr.dch[2].dchecon.clr)
+#define DCH2ECONSET     (simPic32Sfr.sfr.dch[2].dchecon.set)
+#define DCH2ECONINV     (simPic32Sfr.sfr.dch[2].dchecon.inv)
+#define DCH2INT         (simPic32Sfr.sfr.dch[2].dchint.reg)
+#define DCH2INTCLR      (simPic32Sfr.sfr.dch[2].dchint.clr)
+#define DCH2INTSET      (simPic32Sfr.sfr.dch[2].dchint.set)
+#define DCH2INTINV      (simPic32Sfr.sfr.dch[2].dchint.inv)
+#define DCH2SSA         (simPic32Sfr.sfr.dch[2].dchssa.reg)
+#define DCH2SSACLR      (simPic32Sfr.sfr.dch[2].dchssa.clr)
+#define DCH2SSASET      (simPic32Sfr.sfr.dch[2].dchssa.set)
+#define DCH2SSAINV      (simPic32Sfr.sfr.dch[2].dchssa.inv)
+#define DCH2DSA         (simPic32Sfr.sfr.dch[2].dchdsa.reg)
+#define DCH2DSACLR      (simPic32Sfr.sfr.dch[2].dchdsa.clr)
+#define DCH2DSASET      (simPic32Sfr.sfr.dch[2].dchdsa.set)
+#define DCH2DSAINV      (simPic32Sfr.sfr.dch[2].dchdsa.inv)
+#define DCH2SSIZ        (simPic32Sfr.sfr.dch[2].dchssiz.reg)
+#define DCH2SSIZCLR     (simPic32Sfr.sfr.dch[2].dchssiz.clr)
+#define DCH2SSIZSET     (simPic32Sfr.sfr.dch[2].dchssiz.set)
+#define DCH2SSIZINV     (simPic32Sfr.sfr.dch[2].dchssiz.inv)
+#define DCH2DSIZ        (simPic32Sfr.sfr.dch[2].dchdsiz.reg)
+#define DCH2DSIZCLR     (simPic32Sfr.sfr.dch[2].dchdsiz.clr)
+#define DCH2DSIZSET     (simPic32Sfr.sfr.dch[2].dchdsiz.set)
+#define DCH2DSIZINV     (simPic32Sfr.sfr.dch[2].dchdsiz.inv)
+#define DCH2SPTR        (simPic32Sfr.sfr.dch[2].dchsptr.reg)
+#define DCH2SPTRCLR     (simPic32Sfr.sfr.dch[2].dchsptr.clr)
+#define DCH2SPTRSET     (simPic32Sfr.sfr.dch[2].dchsptr.set)
+#define DCH2SPTRINV     (simPic32Sfr.sfr.dch[2].dchsptr.inv)
+#define DCH2DPTR        (simPic32Sfr.sfr.dch[2].dchdptr.reg)
+#define DCH2DPTRCLR     (simPic32Sfr.sfr.dch[2].dchdptr.clr)
+#define DCH2DPTRSET     (simPic32Sfr.sfr.dch[2].dchdptr.set)
+#define DCH2DPTRINV     (simPic32Sfr.sfr.dch[2].dchdptr.inv)
+#define DCH2CSIZ        (simPic32Sfr.sfr.dch[2].dchcsiz.reg)
+#define DCH2CSIZCLR     (simPic32Sfr.sfr.dch[2].dchcsiz.clr)
+#define DCH2CSIZSET     (simPic32Sfr.sfr.dch[2].dchcsiz.set)
+#define DCH2CSIZINV     (simPic32Sfr.sfr.dch[2].dchcsiz.inv)
+#define DCH2CPTR        (simPic32Sfr.sfr.dch[2].dchcptr.reg)
+#define DCH2CPTRCLR     (simPic32Sfr.sfr.dch[2].dchcptr.clr)
+#define DCH2CPTRSET     (simPic32Sfr.sfr.dch[2].dchcptr.set)
+#define DCH2CPTRINV     (simPic32Sfr.sfr.dch[2].dchcptr.inv)
+#define DCH2DAT         (simPic32Sfr.sfr.dch[2].dchdat.reg)
+#define DCH2DATCLR      (simPic32Sfr.sfr.dch[2].dchdat.clr)
+#define DCH2DATSET      (simPic32Sfr.sfr.dch[2].dchdat.set)
+#define DCH2DATINV      (simPic32Sfr.sfr.dch[2].dchdat.inv)
+
+                                        /* DMA channel 3                      */
+#define DCH3CON         (simPic32Sfr.sfr.dch[3].dchcon.reg)
+#define DCH3CONCLR      (simPic32Sfr.sfr.dch[3].dchcon.clr)
+#define DCH3CONSET      (simPic32Sfr.sfr.dch[3].dchcon.set)
+#define DCH3CONINV      (simPic32Sfr.sfr.dch[3].dchcon.inv)
+#define DCH3ECON        (simPic32Sfr.sfr.dch[3].dchecon.reg)
+#define DCH3ECONCLR     (simPic32Sfr.sfr.dch[3].dchecon.clr)
+#define DCH3ECONSET     (simPic32Sfr.sfr.dch[3].dchecon.set)
+#define DCH3ECONINV     (simPic32Sfr.sfr.dch[3].dchecon.inv)
+#define DCH3INT         (simPic32Sfr.sfr.dch[3].dchint.reg)
+#define DCH3INTCLR      (simPic32Sfr.sfr.dch[3].dchint.clr)
+#define DCH3INTSET      (simPic32Sfr.sfr.dch[3].dchint.set)
+#define DCH3INTINV      (simPic32Sfr.sfr.dch[3].dchint.inv)
+#define DCH3SSA         (simPic32Sfr.sfr.dch[3].dchssa.reg)
+#define DCH3SSACLR      (simPic32Sfr.sfr.dch[3].dchssa.clr)
+#define DCH3SSASET      (simPic32Sfr.sfr.dch[3].dchssa.set)
+#define DCH3SSAINV      (simPic32Sfr.sfr.dch[3].dchssa.inv)
+#define DCH3DSA         (simPic32Sfr.sfr.dch[3].dchdsa.reg)
+#define DCH3DSACLR      (simPic32Sfr.sfr.dch[3].dchdsa.clr)
+#define DCH3DSASET      (simPic32Sfr.sfr.dch[3].dchdsa.set)
+#define DCH3DSAINV      (simPic32Sfr.sfr.dch[3].dchdsa.inv)
+#define DCH3SSIZ        (simPic32Sfr.sfr.dch[3].dchssiz.reg)
+#define DCH3SSIZCLR     (simPic32Sfr.sfr.dch[3].dchssiz.clr)
+#define DCH3SSIZSET     (simPic32Sfr.sfr.dch[3].dchssiz.set)
+#define DCH3SSIZINV     (simPic32Sfr.sfr.dch[3].dchssiz.inv)
+#define DCH3DSIZ        (simPic32Sfr.sfr.dch[3].dchdsiz.reg)
+#define DCH3DSIZCLR     (simPic32Sfr.sfr.dch[3].dchdsiz.clr)
+#define DCH3DSIZSET     (simPic32Sfr.sfr.dch[3].dchdsiz.set)
+#define DCH3DSIZINV     (simPic32Sfr.sfr.dch[3].dchdsiz.inv)
+#define DCH3SPTR        (simPic32Sfr.sfr.dch[3].dchsptr.reg)
+#define DCH3SPTRCLR     (simPic32Sfr.sfr.dch[3].dchsptr.clr)
+#define DCH3SPTRSET     (simPic32Sfr.sfr.dch[3].dchsptr.set)
+#define DCH3SPTRINV     (simPic32Sfr.sfr.dch[3].dchsptr.inv)
+#define DCH3DPTR        (simPic32Sfr.sfr.dch[3].dchdptr.reg)
+#define DCH3DPTRCLR     (simPic32Sfr.sfr.dch[3].dchdptr.clr)
+#define DCH3DPTRSET     (simPic32Sfr.sfr.dch[3].dchdptr.set)
+#define DCH3DPTRINV     (simPic32Sfr.sfr.dch[3].dchdptr.inv)
+#define DCH3CSIZ        (simPic32Sfr.sfr.dch[3].dchcsiz.reg)
+#define DCH3CSIZCLR     (simPic32Sfr.sfr.dch[3].dchcsiz.clr)
+#define DCH3CSIZSET     (simPic32Sfr.sfr.dch[3].dchcsiz.set)
+#define DCH3CSIZINV     (simPic32Sfr.sfr.dch[3].dchcsiz.inv)
+#define DCH3CPTR        (simPic32Sfr.sfr.dch[3].dchcptr.reg)
+#define DCH3CPTRCLR     (simPic32Sfr.sfr.dch[3].dchcptr.clr)
+#define DCH3CPTRSET     (simPic32Sfr.sfr.dch[3].dchcptr.set)
+#define DCH3CPTRINV     (simPic32Sfr.sfr.dch[3].dchcptr.inv)
+#define DCH3DAT         (simPic32Sfr.sfr.dch[3].dchdat.reg)
+#define DCH3DATCLR      (simPic32Sfr.sfr.dch[3].dchdat.clr)
+#define DCH3DATSET      (simPic32Sfr.sfr.dch[3].dchdat.set)
+#define DCH3DATINV      (simPic32Sfr.sfr.dch[3].dchdat.inv)
+
+                                        /* Parallel Master Port               */
+#define PMCON           (simPic32Pmp.pmp.pmcon.reg)
+#define PMCONCLR        (simPic32Pmp.pmp.pmcon.clr)
+#define PMCONSET        (simPic32Pmp.pmp.pmcon.set)
+#define PMCONINV        (simPic32Pmp.pmp.pmcon.inv)
+#define PMMODE          (simPic32Pmp.pmp.pmmode.reg)
+#define PMMODECLR       (simPic32Pmp.pmp.pmmode.clr)
+#define PMMODESET       (simPic32Pmp.pmp.pmmode.set)
+#define PMMODEINV       (simPic32Pmp.pmp.pmmode.inv)
+#define PMADDR          (simPic32Pmp.pmp.pmaddr.reg)
+#define PMADDRCLR       (simPic32Pmp.pmp.pmaddr.clr)
+#define PMADDRSET       (simPic32Pmp.pmp.pmaddr.set)
+#define PMADDRINV       (simPic32Pmp.pmp.pmaddr.inv)
+#define PMDOUT          (simPic32Pmp.pmp.pmdout.reg)
+#define PMDOUTCLR       (simPic32Pmp.pmp.pmdout.clr)
+#define PMDOUTSET       (simPic32Pmp.pmp.pmdout.set)
+#define PMDOUTINV       (simPic32Pmp.pmp.pmdout.inv)
+#define PMDIN           (simPic32Pmp.pmp.pmdin.reg)
+#define PMDINCLR        (simPic32Pmp.pmp.pmdin.clr)
+#define PMDINSET        (simPic32Pmp.pmp.pmdin.set)
+#define PMDININV        (simPic32Pmp.pmp.pmdin.inv)
+#define PMAEN           (simPic32Pmp.pmp.pmaen.reg)
+#define PMAENCLR        (simPic32Pmp.pmp.pmaen.clr)
+#define PMAENSET        (simPic32Pmp.pmp.pmaen.set)
+#define PMAENINV        (simPic32Pmp.pmp.pmaen.inv)
+#define PMSTAT          (simPic32Pmp.pmp.pmstat.reg)
+#define PMSTATCLR       (simPic32Pmp.pmp.pmstat.clr)
+#define PMSTATSET       (simPic32Pmp.pmp.pmstat.set)
+#define PMSTATINV       (simPic32Pmp.pmp.pmstat.inv)
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+#ifndef __PIC32MX__
+#error Define __PIC32MX__ when building the PIC32 modules for the host PC
+#endif
+
+
+/*******************************************************************************
+*
+*                        PIC32MX SFR STAND-IN HEADER END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,67 @@
+/*******************************************************************************
+*
+* PIC32MX KERNEL MEMORY ADDRESS STAND-IN FOR HOST PC SIMULATION
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This file stands in for the C32 compiler's <sys/kmem.h> when the PIC32
+* modules are compiled on a host PC. A DMA channel on the PIC32MX is given
+* physical addresses, which are 32 bits wide, while host pointers are usually
+* 64 bits wide. KVA_TO_PA() therefore hands out a 32-bit stand-in address for
+* each pointer, which the simulated DMA controller (hd44780simpic32.c) turns
+* back into the pointer.
+*
+* Filename : kmem.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. The low 24 bits of a stand-in address are an offset from the pointer
+*    given, so a channel may step through up to 16MB from it
+* 2. Only the last 16 different pointers given are remembered
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                        PIC32MX KMEM STAND-IN HEADER
+*
+*******************************************************************************/
+#ifndef __SIMPIC32_KMEM_PRESENT__
+#define __SIMPIC32_KMEM_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Converts a pointer into the address a DMA channel uses to reach it
+*******************************************************************************/
+#define KVA_TO_PA(v)    simPic32KvaToPa((const volatile void *) (v))
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+unsigned int    simPic32KvaToPa(const volatile void * address);
+
+
+/*******************************************************************************
+*
+*                      PIC32MX KMEM STAND-IN HEADER END
+*
+*******************************************************************************/
+#endif
@@ -317,6 +317,9 @@ int main(void)
     lcdIfFuncPointers.pWriteInstr = lcdifWriteInstruction;
     lcdIfFuncPointers.pReadAddr = lcdifReadAddress;
     lcdIfFuncPointers.p4BitFunctionSet = lcdif4BitFunctionSet;
+    lcdIfFuncPointers.pWriteDataBlock = lcdifWriteDataBlock;
+    lcdIfFuncPointers.pWriteInstrBlock = lcdifWriteInstructionBlock;
+    lcdIfFuncPointers.pReadDataBlock = lcdifReadDataBlock;
 
     TMR0H = 0x00;
     TMR0L = 0x00;
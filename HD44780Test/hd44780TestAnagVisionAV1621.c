@@ -274,6 +274,9 @@ int main(void)
     lcdIfFuncPointers.pWriteInstr = lcdifWriteInstruction;
     lcdIfFuncPointers.pReadAddr = lcdifReadAddress;
     lcdIfFuncPointers.p4BitFunctionSet = lcdif4BitFunctionSet;
+    lcdIfFuncPointers.pWriteDataBlock = lcdifWriteDataBlock;
+    lcdIfFuncPointers.pWriteInstrBlock = lcdifWriteInstructionBlock;
+    lcdIfFuncPointers.pReadDataBlock = lcdifReadDataBlock;
 
                                         /* Create an HD44780 display object   */
     hd44780One = hd44780Create(hLcdIfOne, &lcdIfFuncPointers, &hd44780ObjOne);
@@ -0,0 +1,675 @@
+/*******************************************************************************
+*
+* HD44780 MODULE HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Tests the HD44780 module's functionality on a host PC against the simulated
+* HD44780 controller and measures the bus cost of each API call. For every
+* tested configuration (chipset clone and bus width) the program reports the
+* simulated bus time and the number of E cycles each call needed, and checks
+* that the DDRAM contents are what was written and that the driver never
+* wrote to the controller while it was busy. Timed configurations run the
+* driver in timed mode on write-only wiring, where the controller is never
+* read. The HD44780 slot table is then filled to capacity.
+*
+* Filename : hd44780TestHost.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM -DHD44780_MAXOBJECTS=40
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHost.c hd44780TestHostCommon.c ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHost
+*   ./hd44780TestHost
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                        HD44780 MODULE HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFCONFIGS     6
+#define QUEUESIZE           8
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTCONFIG
+* Description:
+*   One display configuration to be tested
+*******************************************************************************/
+typedef struct TESTCONFIGTYPE {
+    const char                    * name;
+    HD44780CLONE                    clone;
+    unsigned char                   busWidth;
+    unsigned char                   timed;
+} TESTCONFIG;
+
+/*******************************************************************************
+* New data type TESTMEASUREMENT
+* Description:
+*   Simulated time and bus cycles used by one API call
+*******************************************************************************/
+typedef struct TESTMEASUREMENTTYPE {
+    HD44780SIMTIME                  startTime;
+    unsigned long                   startCycles;
+} TESTMEASUREMENT;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTCONFIG testConfigs[NUMBEROFCONFIGS] = {
+    { "HD44780U 8-bit", HD44780U, BUS8BITSWIDE, 0 },
+    { "HD44780U 4-bit", HD44780U, BUS4BITSWIDE, 0 },
+    { "KS0066U  8-bit", KS0066U,  BUS8BITSWIDE, 0 },
+    { "KS0066U  4-bit", KS0066U,  BUS4BITSWIDE, 0 },
+    { "HD44780U 8-bit timed, write-only", HD44780U, BUS8BITSWIDE, 1 },
+    { "KS0066U  4-bit timed, write-only", KS0066U,  BUS4BITSWIDE, 1 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char lineOne[] = "HD44780 host sim";
+static const unsigned char lineTwo[] = "MASTERs";
+static const HD44780_ROM unsigned char romLine[] = "String from ROM!";
+static const unsigned char character1[] = { 0x10, 0x1F, 0x10, 0x1F,
+                                             0x10, 0x1F, 0x10, 0x1F,
+                                             0 };
+static HD44780SIM           hd44780Sim;
+static unsigned char        shadowBuffer[HD44780_SHADOWSIZE];
+static unsigned char        frame[HD44780_SHADOWSIZE];
+static HD44780CMD           commandQueue[QUEUESIZE];
+static unsigned char        commandsDone;
+static HD44780SEQ           lastCommandDone;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testConfig(const TESTCONFIG * config);
+static void testCommitResume(HHD44780 const hHd44780);
+static void testSlotTable(void);
+static void startMeasurement(TESTMEASUREMENT * measurement);
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name);
+static void commandDone(HHD44780 const hHd44780, HD44780SEQ sequence);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+
+    for (counter = 0; counter < NUMBEROFCONFIGS; counter++)
+    {
+        testConfig(&testConfigs[counter]);
+    }
+    testSlotTable();
+
+    return testResult();
+}
+
+/*******************************************************************************
+* testConfig()
+*
+* Description:
+*   Runs the complete test sequence for one display configuration
+*
+* See also:
+*
+* Arguments:
+*   config              - configuration to test
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testConfig(const TESTCONFIG * config)
+{
+    HD44780OBJ              hd44780Obj;
+    HD44780NUM              hd44780Num;
+    HHD44780                hHd44780;
+    LCDIFFP                 lcdIfFuncPointers;
+    LCDIFOBJ                lcdIfObj;
+    LCDIFNUM                lcdIfNum;
+    HLCDIF                  hLcdIf;
+    TESTMEASUREMENT         measurement;
+    unsigned int            returnValue;
+    unsigned char           readData = 0;
+    unsigned char           readAddress = 0;
+    const unsigned char   * pString;
+    const HD44780_ROM unsigned char * pRomString;
+    unsigned long           dataWrites;
+    unsigned long           busCycles;
+    HD44780SEQ              sequence;
+    unsigned char           counter;
+
+    printf("\n%s\n", config->name);
+    printf("    %-24s %10s %8s\n", "call", "time (ns)", "cycles");
+
+    hd44780simResetTime();
+    hd44780simInit(&hd44780Sim, config->clone);
+                                        /* Create and open an LCD interface   */
+                                        /* to the simulated display           */
+    lcdIfObj.hd44780Sim = &hd44780Sim;
+    lcdIfObj.busWidth = config->busWidth;
+    lcdIfNum = lcdifCreate(&lcdIfObj);
+    hLcdIf = lcdifOpen(lcdIfNum);
+    check(hLcdIf != (HLCDIF) 0, "lcdifOpen");
+                                        /* Fill an LCD function pointers      */
+                                        /* struct; with RW tied low nothing   */
+                                        /* can be read                        */
+    testFuncPointers(&lcdIfFuncPointers, config->timed);
+    writeOnlyReads = 0;
+                                        /* Create and open an HD44780 object  */
+    hd44780Num = hd44780Create(hLcdIf, &lcdIfFuncPointers, &hd44780Obj);
+    hHd44780 = hd44780Open(hd44780Num);
+    check(hHd44780 != (HHD44780) 0, "hd44780Open");
+    if (config->timed)
+    {
+        check(hd44780SetTimedMode(hHd44780, config->clone, getMicroseconds),
+              "hd44780SetTimedMode");
+    }
+                                        /* Initialise by instruction, waiting */
+                                        /* as long as the driver asks         */
+    startMeasurement(&measurement);
+    do
+    {
+        returnValue = hd44780InstructionInit(hHd44780, config->clone,
+                                             FS_5X8DOTS & FS_2LINE,
+                                             DOFC_BLINKINGOFF &
+                                             DOFC_CURSOROFF & DOFC_DISPLAYOFF,
+                                             EMS_CURSORMOVE & EMS_INCREMENT);
+        if (returnValue > 1)
+        {
+            hd44780simDelay(returnValue);
+        }
+    }
+    while (returnValue != 0);
+    endMeasurement(&measurement, "hd44780InstructionInit");
+    check(hd44780simIs4BitMode(&hd44780Sim) ==
+          (config->busWidth == BUS4BITSWIDE), "bus width after init");
+    check(hd44780Sim.functionSet & 0x08, "two line mode after init");
+    check(hd44780Sim.entryMode == 0x06, "entry mode after init");
+
+    startMeasurement(&measurement);
+    while (!hd44780DisplayControl(hHd44780, DOFC_BLINKINGOFF &
+                                  DOFC_CURSOROFF & DOFC_DISPLAYON));
+    endMeasurement(&measurement, "hd44780DisplayControl");
+    check(hd44780Sim.displayControl == 0x0C, "display control");
+
+    startMeasurement(&measurement);
+    while (!hd44780ClearDisplay(hHd44780));
+    endMeasurement(&measurement, "hd44780ClearDisplay");
+
+    startMeasurement(&measurement);
+    while (!hd44780WriteChar(hHd44780, '1'));
+    endMeasurement(&measurement, "hd44780WriteChar");
+    check(hd44780Sim.ddram[0x00] == '1', "DDRAM after hd44780WriteChar");
+
+    startMeasurement(&measurement);
+    while (!hd44780SetCursorAddr(hHd44780, 0x00));
+    endMeasurement(&measurement, "hd44780SetCursorAddr");
+
+    startMeasurement(&measurement);
+    pString = lineOne;
+    do
+    {
+        pString = hd44780WriteRAMString(hHd44780, pString);
+    } while (pString != (const unsigned char *) 0);
+    endMeasurement(&measurement, "hd44780WriteRAMString(16)");
+    check(memcmp(&hd44780Sim.ddram[0x00], lineOne, 16) == 0,
+          "DDRAM line one");
+
+    while (!hd44780SetCursorAddr(hHd44780, 0x40));
+    pString = lineTwo;
+    do
+    {
+        pString = hd44780WriteRAMString(hHd44780, pString);
+    } while (pString != (const unsigned char *) 0);
+    check(memcmp(&hd44780Sim.ddram[0x40], lineTwo, 7) == 0,
+          "DDRAM line two");
+
+    check(hd44780Sim.addressCounter == 0x47, "address after line two");
+    if (!config->timed)
+    {
+        startMeasurement(&measurement);
+        while (!hd44780ReadAddr(hHd44780, &readAddress));
+        endMeasurement(&measurement, "hd44780ReadAddr");
+        check(readAddress == 0x47, "address counter after line two");
+
+        while (!hd44780SetCursorAddr(hHd44780, 0x40));
+        startMeasurement(&measurement);
+        while (!hd44780ReadChar(hHd44780, &readData));
+        endMeasurement(&measurement, "hd44780ReadChar");
+        check(readData == 'M', "hd44780ReadChar");
+    }
+
+    while (!hd44780SetCursorAddr(hHd44780, 0x00));
+    startMeasurement(&measurement);
+    pRomString = romLine;
+    do
+    {
+        pRomString = hd44780WriteROMString(hHd44780, pRomString);
+    } while (pRomString != (const HD44780_ROM unsigned char *) 0);
+    endMeasurement(&measurement, "hd44780WriteROMString(16)");
+    check(memcmp(&hd44780Sim.ddram[0x00], romLine, 16) == 0,
+          "DDRAM after hd44780WriteROMString");
+    check(hd44780WriteROMString(hHd44780, romLine + 16) ==
+          (const HD44780_ROM unsigned char *) 0, "empty ROM string");
+
+    while (!hd44780SetCGRAMAddr(hHd44780, 0x08));
+    startMeasurement(&measurement);
+    pString = character1;
+    do
+    {
+        pString = hd44780WriteCGRAM(hHd44780, pString, FS_5X8DOTS);
+    } while (pString != (const unsigned char *) 0);
+    endMeasurement(&measurement, "hd44780WriteCGRAM(8)");
+    check(memcmp(&hd44780Sim.cgram[0x08], character1, 8) == 0,
+          "CGRAM character 1");
+
+    startMeasurement(&measurement);
+    while (!hd44780ReturnHome(hHd44780));
+    endMeasurement(&measurement, "hd44780ReturnHome");
+    check(hd44780Sim.addressCounter == 0x00, "address after return home");
+                                        /* Shadow framebuffer: first frame is */
+                                        /* sent in full                       */
+    check(hd44780AttachShadow(hHd44780, shadowBuffer), "hd44780AttachShadow");
+    for (counter = 0; counter < HD44780_SHADOWSIZE; counter++)
+    {
+        frame[counter] = 'A' + (counter % 26);
+    }
+    startMeasurement(&measurement);
+    while (!hd44780CommitFrame(hHd44780, frame));
+    endMeasurement(&measurement, "hd44780CommitFrame(all)");
+    check(memcmp(&hd44780Sim.ddram[0x00], &frame[0], 40) == 0 &&
+          memcmp(&hd44780Sim.ddram[0x40], &frame[40], 40) == 0,
+          "DDRAM after full frame");
+                                        /* Then only the changed cells; 5 and */
+                                        /* 7 are one run, 39 runs onto 40     */
+    frame[5] = '*';
+    frame[7] = '*';
+    frame[39] = '*';
+    frame[40] = '*';
+    frame[70] = '*';
+    dataWrites = hd44780Sim.stats.dataWrites;
+    startMeasurement(&measurement);
+    while (!hd44780CommitFrame(hHd44780, frame));
+    endMeasurement(&measurement, "hd44780CommitFrame(5)");
+    check(hd44780Sim.stats.dataWrites - dataWrites == 6,
+          "changed cells only");
+    check(memcmp(&hd44780Sim.ddram[0x00], &frame[0], 40) == 0 &&
+          memcmp(&hd44780Sim.ddram[0x40], &frame[40], 40) == 0,
+          "DDRAM after partial frame");
+    dataWrites = hd44780Sim.stats.dataWrites;
+    startMeasurement(&measurement);
+    while (!hd44780CommitFrame(hHd44780, frame));
+    endMeasurement(&measurement, "hd44780CommitFrame(0)");
+    check(hd44780Sim.stats.dataWrites == dataWrites, "unchanged frame");
+    testCommitResume(hHd44780);
+                                        /* Command queue: queueing never      */
+                                        /* touches the bus                    */
+    check(!hd44780IsDone(hHd44780, 1), "hd44780IsDone without a queue");
+    check(hd44780AttachQueue(hHd44780, commandQueue, QUEUESIZE, commandDone),
+          "hd44780AttachQueue");
+    check(!hd44780IsDone(hHd44780, 1), "hd44780IsDone before any command");
+    commandsDone = 0;
+    busCycles = hd44780Sim.stats.writeCycles + hd44780Sim.stats.readCycles;
+    hd44780Enqueue(hHd44780, CMD_CLEARDISPLAY, 0, (const unsigned char *) 0);
+    hd44780Enqueue(hHd44780, CMD_SETCURSORADDR, 0x00,
+                   (const unsigned char *) 0);
+    hd44780Enqueue(hHd44780, CMD_WRITERAMSTRING, 0, lineOne);
+    hd44780Enqueue(hHd44780, CMD_SETCURSORADDR, 0x40,
+                   (const unsigned char *) 0);
+    sequence = hd44780Enqueue(hHd44780, CMD_WRITERAMSTRING, 0, lineTwo);
+    check(sequence != 0, "hd44780Enqueue");
+    check(hd44780Sim.stats.writeCycles + hd44780Sim.stats.readCycles ==
+          busCycles, "hd44780Enqueue doesn't touch the bus");
+    check(!hd44780IsDone(hHd44780, sequence), "hd44780IsDone while queued");
+    check(!hd44780IsDone(hHd44780, 0) &&
+          !hd44780IsDone(hHd44780, sequence + 1),
+          "hd44780IsDone for a sequence number not issued");
+    startMeasurement(&measurement);
+    while (!hd44780Service(hHd44780));
+    endMeasurement(&measurement, "hd44780Service(5)");
+    check(commandsDone == 5 && lastCommandDone == sequence &&
+          hd44780IsDone(hHd44780, sequence), "queued commands completed");
+    check(memcmp(&hd44780Sim.ddram[0x00], lineOne, 16) == 0 &&
+          memcmp(&hd44780Sim.ddram[0x40], lineTwo, 7) == 0 &&
+          hd44780Sim.ddram[0x10] == ' ', "DDRAM after queued commands");
+                                        /* A full queue refuses more          */
+    for (counter = 0; counter < QUEUESIZE; counter++)
+    {
+        hd44780Enqueue(hHd44780, CMD_WRITECHAR, '0' + counter,
+                       (const unsigned char *) 0);
+    }
+    check(hd44780Enqueue(hHd44780, CMD_WRITECHAR, '!',
+                         (const unsigned char *) 0) == 0, "full queue");
+    while (!hd44780Service(hHd44780));
+    check(memcmp(&hd44780Sim.ddram[0x47], "01234567", QUEUESIZE) == 0,
+          "DDRAM after wrapping queue");
+
+    check(hd44780Sim.stats.violations == 0, "no writes while busy");
+    if (config->timed)
+    {
+        check(writeOnlyReads == 0 && hd44780Sim.stats.readCycles == 0,
+              "no reads on write-only wiring");
+    }
+    printf("    %lu instructions, %lu data writes, %lu busy polls\n",
+           hd44780Sim.stats.instructions, hd44780Sim.stats.dataWrites,
+           hd44780Sim.stats.busyReads);
+
+    hd44780Close(hHd44780);
+    check(hd44780WriteROMString(hHd44780, romLine + 16) == romLine + 16,
+          "empty ROM string on a closed display");
+    hd44780Destroy(hd44780Num);
+    lcdifClose(hLcdIf);
+    lcdifDestroy(lcdIfNum);
+}
+
+/*******************************************************************************
+* testCommitResume()
+*
+* Description:
+*   Stops hd44780CommitFrame() right after it sets the DDRAM address, moves the
+*   address counter with another call and checks that carrying on still puts
+*   the frame in the right cells
+*
+* See also:
+*
+* Arguments:
+*   hHd44780            - display with a shadow buffer attached
+*
+* Returns:
+*   void
+*
+* Callers: testConfig()
+*
+* Notes :
+* 1. Once the Set DDRAM Address instruction is written the display is busy,
+*    so the first call returns before writing any data
+*
+*******************************************************************************/
+static void testCommitResume(HHD44780 const hHd44780)
+{
+    unsigned long           dataWrites;
+                                        /* Stopped by hd44780ClearDisplay()   */
+    while (!hd44780ClearDisplay(hHd44780));
+    memset(frame, ' ', HD44780_SHADOWSIZE);
+    memcpy(&frame[5], "HELLO", 5);
+    while (hd44780simIsBusy(&hd44780Sim))
+    {
+        hd44780simAdvance(hd44780simGetCycleTime());
+    }
+    dataWrites = hd44780Sim.stats.dataWrites;
+    check(!hd44780CommitFrame(hHd44780, frame) &&
+          hd44780Sim.stats.dataWrites == dataWrites,
+          "frame stopped after Set DDRAM Address");
+    while (!hd44780ClearDisplay(hHd44780));
+    while (!hd44780CommitFrame(hHd44780, frame));
+    check(memcmp(&hd44780Sim.ddram[0x00], &frame[0], 40) == 0 &&
+          memcmp(&hd44780Sim.ddram[0x40], &frame[40], 40) == 0,
+          "DDRAM after frame resumed past hd44780ClearDisplay");
+                                        /* Stopped by hd44780WriteChar(), at  */
+                                        /* the cell the frame resumes from    */
+    frame[0] = '>';
+    while (hd44780simIsBusy(&hd44780Sim))
+    {
+        hd44780simAdvance(hd44780simGetCycleTime());
+    }
+    dataWrites = hd44780Sim.stats.dataWrites;
+    check(!hd44780CommitFrame(hHd44780, frame) &&
+          hd44780Sim.stats.dataWrites == dataWrites,
+          "frame stopped after Set DDRAM Address");
+    while (!hd44780WriteChar(hHd44780, '#'));
+    while (!hd44780CommitFrame(hHd44780, frame));
+    check(memcmp(&hd44780Sim.ddram[0x00], &frame[0], 40) == 0 &&
+          memcmp(&hd44780Sim.ddram[0x40], &frame[40], 40) == 0,
+          "DDRAM after frame resumed past hd44780WriteChar");
+}
+
+/*******************************************************************************
+* testSlotTable()
+*
+* Description:
+*   Fills the HD44780 slot table, then checks that a destroyed object's number
+*   is the next one reused
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testSlotTable(void)
+{
+    static HD44780OBJ       hd44780Objs[HD44780_MAXOBJECTS + 1];
+    HHD44780                hHd44780;
+    LCDIFFP                 lcdIfFuncPointers;
+    LCDIFOBJ                lcdIfObj;
+    LCDIFNUM                lcdIfNum;
+    HLCDIF                  hLcdIf;
+    HD44780NUM              hd44780Num;
+    unsigned int            counter;
+    unsigned int            failures = 0;
+
+    printf("\nSlot table, %u objects\n", HD44780_MAXOBJECTS);
+
+    hd44780simInit(&hd44780Sim, HD44780U);
+    lcdIfObj.hd44780Sim = &hd44780Sim;
+    lcdIfObj.busWidth = BUS8BITSWIDE;
+    lcdIfNum = lcdifCreate(&lcdIfObj);
+    hLcdIf = lcdifOpen(lcdIfNum);
+    testFuncPointers(&lcdIfFuncPointers, 0);
+                                        /* Numbers are issued lowest first    */
+    for (counter = 0; counter < HD44780_MAXOBJECTS; counter++)
+    {
+        if (hd44780Create(hLcdIf, &lcdIfFuncPointers,
+                          &hd44780Objs[counter]) != counter + 1)
+        {
+            failures++;
+        }
+    }
+    check(failures == 0, "hd44780Create up to capacity");
+    check(hd44780Create(hLcdIf, &lcdIfFuncPointers,
+                        &hd44780Objs[HD44780_MAXOBJECTS]) == 0,
+          "hd44780Create beyond capacity");
+                                        /* Each number opens its own object   */
+    for (counter = 0; counter < HD44780_MAXOBJECTS; counter++)
+    {
+        hHd44780 = hd44780Open(counter + 1);
+        if (hHd44780 != &hd44780Objs[counter] ||
+            hd44780Close(hHd44780) != counter + 1)
+        {
+            failures++;
+        }
+    }
+    check(failures == 0, "hd44780Open by number");
+    check(hd44780Open(0) == (HHD44780) 0 &&
+          hd44780Open(HD44780_MAXOBJECTS + 1) == (HHD44780) 0,
+          "hd44780Open of invalid numbers");
+                                        /* A freed number is reused           */
+    hd44780Num = HD44780_MAXOBJECTS / 2;
+    check(hd44780Destroy(hd44780Num) == HD44780_DESTROY_OK, "hd44780Destroy");
+    check(hd44780Open(hd44780Num) == (HHD44780) 0, "open destroyed object");
+    check(hd44780Create(hLcdIf, &lcdIfFuncPointers,
+                        &hd44780Objs[HD44780_MAXOBJECTS]) == hd44780Num,
+          "hd44780Create reuses freed number");
+
+    for (counter = 1; counter <= HD44780_MAXOBJECTS; counter++)
+    {
+        hd44780Destroy(counter);
+    }
+    lcdifClose(hLcdIf);
+    lcdifDestroy(lcdIfNum);
+}
+
+/*******************************************************************************
+* startMeasurement()
+*
+* Description:
+*   Waits until the simulated controller is idle, then notes the simulated
+*   time and bus cycle count before an API call
+*
+* See also:
+*   endMeasurement()
+*
+* Arguments:
+*   measurement         - where to store the starting point
+*
+* Returns:
+*   void
+*
+* Callers: testConfig()
+*
+* Notes :
+* 1. Waiting for the previous instruction to complete first means the result
+*    is the cost of the measured call alone
+*
+*******************************************************************************/
+static void startMeasurement(TESTMEASUREMENT * measurement)
+{
+    while (hd44780simIsBusy(&hd44780Sim))
+    {
+        hd44780simAdvance(hd44780simGetCycleTime());
+    }
+    measurement->startTime = hd44780simGetTime();
+    measurement->startCycles = hd44780Sim.stats.writeCycles +
+                               hd44780Sim.stats.readCycles;
+}
+
+/*******************************************************************************
+* endMeasurement()
+*
+* Description:
+*   Prints the simulated time and bus cycles used since startMeasurement()
+*
+* See also:
+*   startMeasurement()
+*
+* Arguments:
+*   measurement         - starting point
+*   name                - name of the measured call
+*
+* Returns:
+*   void
+*
+* Callers: testConfig()
+*
+* Notes :
+*
+*******************************************************************************/
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name)
+{
+    printf("    %-24s %10llu %8lu\n", name,
+           hd44780simGetTime() - measurement->startTime,
+           hd44780Sim.stats.writeCycles + hd44780Sim.stats.readCycles -
+           measurement->startCycles);
+}
+
+/*******************************************************************************
+* commandDone()
+*
+* Description:
+*   Notes each command completed by hd44780Service()
+*
+* See also:
+*
+* Arguments:
+*   hHd44780            - handle to the HD44780 that completed the command
+*   sequence            - sequence number of the command
+*
+* Returns:
+*   void
+*
+* Callers: HD44780 module
+*
+* Notes :
+*
+*******************************************************************************/
+static void commandDone(HHD44780 const hHd44780, HD44780SEQ sequence)
+{
+    (void) hHd44780;
+    commandsDone++;
+    lastCommandDone = sequence;
+}
+
+
+/*******************************************************************************
+*
+*                      HD44780 MODULE HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,767 @@
+/*******************************************************************************
+*
+* HD44780 MODULE 40X4 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module and the unmodified PIC32 LCD interface module
+* (lcdif_c32.c) on a host PC against the pin level simulator, with the two
+* controllers of a 40x4 module sharing RW, RS and a 4-bit data bus, each with
+* its own E pin. Whole frames are sent to the top and bottom halves one after
+* the other and then through a virtual display with
+* hd44780CommitVirtualFrame(), in timed mode and polling the busy flag. The
+* program checks that every row shows the frame, that neither controller is
+* written while busy and that the virtual display takes about half the time
+* in timed mode, and reports how long each approach took. Rows are also
+* written and the cursor moved through the virtual display, and the bus is
+* taken part way through a timed frame.
+*
+* Filename : hd44780TestHost40x4.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on an x86 or x86-64 Linux PC:
+*   gcc -D__PIC32MX__
+*       -I../HD44780Sim/pic32 -I../HD44780Sim -I../HD44780_module
+*       -I../lcdif_module
+*       hd44780TestHost40x4.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_c32.c ../HD44780Sim/hd44780simpic32.c
+*       ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHost40x4
+*   ./hd44780TestHost40x4
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                    HD44780 MODULE 40X4 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include <p32xxxx.h>
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+#include "hd44780simpic32.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFMODES       2
+                                        /* Shared pins; data is on RD0-RD3    */
+#define RS_PIN              (1 << 4)
+#define RW_PIN              (1 << 5)
+#define DATA_PINS           0x0F
+                                        /* Top controller's E pin; the bottom */
+                                        /* one follows it                     */
+#define FIRST_E_PIN         (1 << 6)
+                                        /* Most calls allowed for one frame   */
+#define MAXCALLS            100000
+                                        /* In timed mode the virtual display  */
+                                        /* may take this fraction longer than */
+                                        /* half the time of the halves one    */
+                                        /* after the other                    */
+#define MARGINDIVISOR       10
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMODE
+* Description:
+*   How the controllers are written
+*******************************************************************************/
+typedef struct TESTMODETYPE {
+    const char                    * name;
+    unsigned char                   timed;
+} TESTMODE;
+
+/*******************************************************************************
+* New data type TESTCONTROLLER
+* Description:
+*   One simulated controller of the 40x4 module and the objects driving it
+*******************************************************************************/
+typedef struct TESTCONTROLLERTYPE {
+    HD44780SIM                      hd44780Sim;
+    HD44780SIMPIC32PINS             simPins;
+    PBIFLCDENOBJ                    pbIfLcdEn;
+    LCDIFOBJ                        lcdIfObj;
+    LCDIFNUM                        lcdIfNum;
+    HLCDIF                          hLcdIf;
+    HD44780OBJ                      hd44780Obj;
+    HD44780NUM                      hd44780Num;
+    HHD44780                        hHd44780;
+    unsigned char                   shadowBuffer[HD44780_SHADOWSIZE];
+} TESTCONTROLLER;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTMODE testModes[NUMBEROFMODES] = {
+    { "timed",      1 },
+    { "busy flag",  0 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static TESTCONTROLLER       controllers[HD44780_VIRTUALCONTROLLERS];
+static HD44780INIT          initTable[HD44780_VIRTUALCONTROLLERS];
+static HD44780VIRTUAL       virtualDisplay;
+static unsigned char        frame[HD44780_VIRTUALFRAMESIZE];
+static PBIFOBJ              pbIf;
+static LCDIFFP              lcdIfFuncPointers;
+                                        /* Bus acquisitions granted before    */
+                                        /* the bus is taken                   */
+static unsigned long        busGrants;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void openController(TESTCONTROLLER * controller, unsigned char index);
+static void initialiseControllers(void);
+static void testMode(const TESTMODE * mode, unsigned char pass);
+static HD44780SIMTIME commitHalves(void);
+static HD44780SIMTIME commitVirtual(unsigned long * calls);
+static void testRows(void);
+static void testBusTaken(void);
+static unsigned char takenGetPb(HLCDIF const hLcdIf);
+static void makeFrame(unsigned char pass);
+static void invalidateShadows(void);
+static void checkFrame(const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(__PIC32MX__)
+#error This test program must be built with __PIC32MX__ defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+    hd44780simPic32Init();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+                                        /* Fill the shared parallel bus       */
+                                        /* interface struct                   */
+    pbIf.RW_LAT     = &LATD;
+    pbIf.RW_BIT     = RW_PIN;
+    pbIf.RS_LAT     = &LATD;
+    pbIf.RS_BIT     = RS_PIN;
+    pbIf.DATA_LAT   = &LATD;
+    pbIf.DATA_PORT  = &PORTD;
+    pbIf.DATA_TRIS  = &TRISD;
+    pbIf.DATA_MASK  = DATA_PINS;
+    pbIf.RW_LATSET  = &LATDSET;
+    pbIf.RW_LATCLR  = &LATDCLR;
+    pbIf.RS_LATSET  = &LATDSET;
+    pbIf.RS_LATCLR  = &LATDCLR;
+    pbIf.DATA_LATINV = &LATDINV;
+    pbIf.DATA_TRISSET = &TRISDSET;
+    pbIf.DATA_TRISCLR = &TRISDCLR;
+
+    for (counter = 0; counter < HD44780_VIRTUALCONTROLLERS; counter++)
+    {
+        openController(&controllers[counter], counter);
+    }
+    check(hd44780simPic32Start(), "hd44780simPic32Start");
+                                        /* Make RW, RS and E lines outputs    */
+    LATDCLR = RW_PIN | RS_PIN | (FIRST_E_PIN * 3);
+    TRISDCLR = RW_PIN | RS_PIN | (FIRST_E_PIN * 3);
+
+    initialiseControllers();
+
+    check(!hd44780AttachVirtual(&virtualDisplay, controllers[0].hHd44780,
+                                controllers[0].hHd44780),
+          "one controller twice refused");
+    check(hd44780AttachVirtual(&virtualDisplay, controllers[0].hHd44780,
+                               controllers[1].hHd44780),
+          "hd44780AttachVirtual");
+    check(!hd44780CommitVirtualFrame(&virtualDisplay, frame),
+          "no shadow buffers to commit with");
+
+    for (counter = 0; counter < NUMBEROFMODES; counter++)
+    {
+        testMode(&testModes[counter], counter);
+    }
+    testRows();
+    testBusTaken();
+
+    for (counter = 0; counter < HD44780_VIRTUALCONTROLLERS; counter++)
+    {
+        check(controllers[counter].hd44780Sim.stats.violations == 0,
+              "no writes while busy");
+        hd44780Close(controllers[counter].hHd44780);
+        hd44780Destroy(controllers[counter].hd44780Num);
+        lcdifClose(controllers[counter].hLcdIf);
+        lcdifDestroy(controllers[counter].lcdIfNum);
+    }
+    hd44780simPic32Stop();
+
+    return testResult();
+}
+
+/*******************************************************************************
+* openController()
+*
+* Description:
+*   Wires one controller to the simulated PIC32 on its own E pin, creates and
+*   opens the objects driving it and adds it to the initialisation table
+*
+* See also:
+*
+* Arguments:
+*   controller          - controller to open
+*   index               - 0 for the top controller, 1 for the bottom one
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openController(TESTCONTROLLER * controller, unsigned char index)
+{
+    HD44780INIT       * init;
+
+    hd44780simInit(&controller->hd44780Sim, HD44780U);
+
+    controller->simPins.hd44780Sim = &controller->hd44780Sim;
+    controller->simPins.RW_LAT = &LATD;
+    controller->simPins.RW_BIT = RW_PIN;
+    controller->simPins.RS_LAT = &LATD;
+    controller->simPins.RS_BIT = RS_PIN;
+    controller->simPins.E_LAT = &LATD;
+    controller->simPins.E_BIT = FIRST_E_PIN << index;
+    controller->simPins.DATA_LAT = &LATD;
+    controller->simPins.DATA_MASK = DATA_PINS;
+    check(hd44780simPic32Connect(&controller->simPins),
+          "hd44780simPic32Connect");
+
+    controller->pbIfLcdEn.E_LAT = &LATD;
+    controller->pbIfLcdEn.E_BIT = FIRST_E_PIN << index;
+    controller->pbIfLcdEn.E_LATSET = &LATDSET;
+    controller->pbIfLcdEn.E_LATCLR = &LATDCLR;
+    controller->lcdIfObj.pbIfObject = &pbIf;
+    controller->lcdIfObj.pbIfLcdEnObject = &controller->pbIfLcdEn;
+    controller->lcdIfNum = lcdifCreate(&controller->lcdIfObj);
+    controller->hLcdIf = lcdifOpen(controller->lcdIfNum);
+    check(controller->hLcdIf != (HLCDIF) 0, "lcdifOpen");
+
+    controller->hd44780Num = hd44780Create(controller->hLcdIf,
+                                           &lcdIfFuncPointers,
+                                           &controller->hd44780Obj);
+    controller->hHd44780 = hd44780Open(controller->hd44780Num);
+    check(controller->hHd44780 != (HHD44780) 0, "hd44780Open");
+
+    init = &initTable[index];
+    init->hHd44780 = controller->hHd44780;
+    init->hd44780Clone = HD44780U;
+    init->functionSet = TESTFUNCTIONSET;
+    init->displayOnOffControl = TESTDISPLAYCONTROL;
+    init->entryModeSet = TESTENTRYMODE;
+    init->initDone = 0;
+    init->waitTime = 0;
+}
+
+/*******************************************************************************
+* initialiseControllers()
+*
+* Description:
+*   Initialises both controllers, polling busy flags
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void initialiseControllers(void)
+{
+    unsigned int        returnValue;
+    unsigned long       calls;
+
+    calls = 0;
+    do
+    {
+        returnValue = hd44780InstructionInitAll(initTable,
+                                                HD44780_VIRTUALCONTROLLERS);
+        calls++;
+        if (returnValue > 1)
+        {
+            hd44780simDelay(returnValue);
+        }
+    }
+    while (returnValue != 0 && calls < MAXCALLS);
+
+    check(returnValue == 0, "initialisation completes");
+}
+
+/*******************************************************************************
+* testMode()
+*
+* Description:
+*   Sends a full frame to the halves one after the other and another through
+*   the virtual display, and compares the time taken
+*
+* See also:
+*
+* Arguments:
+*   mode                - how the controllers are written
+*   pass                - number of the pass, so each frame differs
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testMode(const TESTMODE * mode, unsigned char pass)
+{
+    unsigned char       counter;
+    unsigned long       calls;
+    HD44780SIMTIME      serialTime;
+    HD44780SIMTIME      virtualTime;
+
+    printf("\n%s\n", mode->name);
+    for (counter = 0; counter < HD44780_VIRTUALCONTROLLERS; counter++)
+    {
+        check(hd44780SetTimedMode(controllers[counter].hHd44780, HD44780U,
+                                  mode->timed ? getMicroseconds :
+                                  (unsigned int (*)(void)) 0),
+              "hd44780SetTimedMode");
+                                        /* Let the Clear Display that timed   */
+                                        /* mode assumes finish                */
+        while (!hd44780SetCursorAddr(controllers[counter].hHd44780, 0))
+        {
+        }
+    }
+                                        /* Halves one after the other         */
+    makeFrame(pass * 2);
+    invalidateShadows();
+    serialTime = commitHalves();
+    checkFrame("frame sent a half at a time");
+                                        /* Both through the virtual display   */
+    makeFrame(pass * 2 + 1);
+    invalidateShadows();
+    virtualTime = commitVirtual(&calls);
+    checkFrame("frame sent through the virtual display");
+
+    printf("    halves one after the other: %6llu us\n", serialTime / 1000);
+    printf("    virtual display:            %6llu us in %lu call(s), "
+           "%.1f%% of the time\n", virtualTime / 1000, calls,
+           100.0 * virtualTime / serialTime);
+    if (mode->timed)
+    {
+        check(calls == 1, "timed frame sent in one call");
+        check(virtualTime * 2 <= serialTime + serialTime / MARGINDIVISOR,
+              "about half the time");
+    }
+    else
+    {
+        check(virtualTime < serialTime, "quicker than the halves in turn");
+    }
+                                        /* Nothing changed, nothing sent      */
+    calls = controllers[0].hd44780Sim.stats.dataWrites +
+            controllers[1].hd44780Sim.stats.dataWrites;
+    commitVirtual((unsigned long *) 0);
+    check(controllers[0].hd44780Sim.stats.dataWrites +
+          controllers[1].hd44780Sim.stats.dataWrites == calls,
+          "unchanged frame not sent again");
+}
+
+/*******************************************************************************
+* commitHalves()
+*
+* Description:
+*   Commits the top half of the frame to the top controller and then the
+*   bottom half to the bottom controller
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Time taken, in ns, until both controllers are ready again
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static HD44780SIMTIME commitHalves(void)
+{
+    unsigned char       counter;
+    unsigned long       calls;
+    HD44780SIMTIME      startTime;
+
+    startTime = hd44780simGetTime();
+    for (counter = 0; counter < HD44780_VIRTUALCONTROLLERS; counter++)
+    {
+        for (calls = 0; calls < MAXCALLS &&
+             !hd44780CommitFrame(controllers[counter].hHd44780,
+                                 &frame[counter * HD44780_SHADOWSIZE]);
+             calls++)
+        {
+        }
+    }
+                                        /* Wait for the last write too        */
+    while (!hd44780SetCursorAddr(controllers[1].hHd44780, 0))
+    {
+    }
+
+    return hd44780simGetTime() - startTime;
+}
+
+/*******************************************************************************
+* commitVirtual()
+*
+* Description:
+*   Commits the whole frame through the virtual display
+*
+* See also:
+*
+* Arguments:
+*   calls               - where to store the number of calls made, or NULL
+*
+* Returns:
+*   Time taken, in ns, until both controllers are ready again
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static HD44780SIMTIME commitVirtual(unsigned long * calls)
+{
+    unsigned long       counter;
+    HD44780SIMTIME      startTime;
+
+    startTime = hd44780simGetTime();
+    for (counter = 1; counter < MAXCALLS &&
+         !hd44780CommitVirtualFrame(&virtualDisplay, frame); counter++)
+    {
+    }
+    check(counter < MAXCALLS, "hd44780CommitVirtualFrame completes");
+    if (calls != (unsigned long *) 0)
+    {
+        *calls = counter;
+    }
+                                        /* Wait for the last writes too       */
+    while (!hd44780SetCursorAddr(controllers[0].hHd44780, 0))
+    {
+    }
+    while (!hd44780SetCursorAddr(controllers[1].hHd44780, 0))
+    {
+    }
+
+    return hd44780simGetTime() - startTime;
+}
+
+/*******************************************************************************
+* testRows()
+*
+* Description:
+*   Writes rows and moves the cursor through the virtual display
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testRows(void)
+{
+    static const unsigned char text[] = "ROW";
+    unsigned char       row;
+    unsigned char       written;
+    unsigned long       calls;
+    unsigned long       dataWrites;
+
+    printf("\nrows\n");
+    for (row = 0; row < 4; row++)
+    {
+        written = 0;
+        for (calls = 0; written != sizeof(text) - 1 && calls < MAXCALLS;
+             calls++)
+        {
+            written = hd44780WriteVirtualAt(&virtualDisplay, row, row * 10,
+                                            text, sizeof(text) - 1, written);
+        }
+    }
+    check(memcmp(&controllers[0].hd44780Sim.ddram[0x00], text, 3) == 0 &&
+          memcmp(&controllers[0].hd44780Sim.ddram[0x40 + 10], text, 3) == 0 &&
+          memcmp(&controllers[1].hd44780Sim.ddram[0x00 + 20], text, 3) == 0 &&
+          memcmp(&controllers[1].hd44780Sim.ddram[0x40 + 30], text, 3) == 0,
+          "each row on its controller");
+
+    dataWrites = controllers[0].hd44780Sim.stats.dataWrites +
+                 controllers[1].hd44780Sim.stats.dataWrites;
+    check(hd44780WriteVirtualAt(&virtualDisplay, 4, 0, text, 3, 0) == 3,
+          "row off the display dropped");
+    check(controllers[0].hd44780Sim.stats.dataWrites +
+          controllers[1].hd44780Sim.stats.dataWrites == dataWrites,
+          "nothing sent");
+
+    check(!hd44780SetVirtualCursorPos(&virtualDisplay, 4, 0),
+          "cursor off the display refused");
+    while (!hd44780SetVirtualCursorPos(&virtualDisplay, 3, 39))
+    {
+    }
+    while (!hd44780WriteChar(controllers[1].hHd44780, '*'))
+    {
+    }
+    check(controllers[1].hd44780Sim.ddram[0x67] == '*',
+          "hd44780SetVirtualCursorPos");
+}
+
+/*******************************************************************************
+* testBusTaken()
+*
+* Description:
+*   Takes the bus away part way through a timed virtual display frame, checks
+*   that hd44780CommitVirtualFrame() returns rather than waiting for it and
+*   that the frame is finished once the bus is free again
+*
+* See also:
+*   takenGetPb()
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testBusTaken(void)
+{
+    unsigned char       counter;
+
+    printf("\nbus taken\n");
+    for (counter = 0; counter < HD44780_VIRTUALCONTROLLERS; counter++)
+    {
+        check(hd44780SetTimedMode(controllers[counter].hHd44780, HD44780U,
+                                  getMicroseconds), "hd44780SetTimedMode");
+        while (!hd44780SetCursorAddr(controllers[counter].hHd44780, 0))
+        {
+        }
+    }
+    makeFrame(NUMBEROFMODES * 2);
+    invalidateShadows();
+
+    busGrants = 20;
+    lcdIfFuncPointers.pGetBus = takenGetPb;
+    check(!hd44780CommitVirtualFrame(&virtualDisplay, frame),
+          "frame not sent while the bus is taken");
+    check(busGrants == 0, "bus taken part way through the frame");
+    lcdIfFuncPointers.pGetBus = lcdifGetPb;
+
+    commitVirtual((unsigned long *) 0);
+    checkFrame("frame finished once the bus is free");
+}
+
+/*******************************************************************************
+* makeFrame()
+*
+* Description:
+*   Fills the frame with text that differs from pass to pass
+*
+* See also:
+*
+* Arguments:
+*   pass                - number of the frame
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void makeFrame(unsigned char pass)
+{
+    unsigned char       index;
+
+    for (index = 0; index < HD44780_VIRTUALFRAMESIZE; index++)
+    {
+        frame[index] = (unsigned char) ('!' + (index * 3 + pass * 11) % 90);
+    }
+}
+
+/*******************************************************************************
+* invalidateShadows()
+*
+* Description:
+*   Attaches both shadow buffers again, so the next frame is sent in full
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void invalidateShadows(void)
+{
+    unsigned char       counter;
+
+    for (counter = 0; counter < HD44780_VIRTUALCONTROLLERS; counter++)
+    {
+        check(hd44780AttachShadow(controllers[counter].hHd44780,
+                                  controllers[counter].shadowBuffer),
+              "hd44780AttachShadow");
+    }
+}
+
+/*******************************************************************************
+* checkFrame()
+*
+* Description:
+*   Checks that each row of the 40x4 module shows its part of the frame
+*
+* See also:
+*
+* Arguments:
+*   description         - what is being checked
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void checkFrame(const char * description)
+{
+    unsigned char       row;
+    HD44780SIM        * sim;
+    unsigned char       match = 1;
+
+    for (row = 0; row < 4; row++)
+    {
+        sim = &controllers[row / 2].hd44780Sim;
+        if (memcmp(&sim->ddram[(row % 2) * 0x40], &frame[row * 40], 40) != 0)
+        {
+            match = 0;
+        }
+    }
+    check(match, description);
+}
+
+/*******************************************************************************
+* takenGetPb()
+*
+* Description:
+*   Stands in for lcdifGetPb(), granting the bus busGrants times and then
+*   refusing it as if another task had taken it
+*
+* See also:
+*   testBusTaken()
+*
+* Arguments:
+*   hLcdIf              - handle to the LCD interface
+*
+* Returns:
+*   - 1                 - bus granted
+*   - 0                 - bus taken
+*
+* Callers: HD44780 module
+*
+* Notes :
+*
+*******************************************************************************/
+static unsigned char takenGetPb(HLCDIF const hLcdIf)
+{
+    if (busGrants == 0)
+    {
+        return 0;
+    }
+    busGrants--;
+
+    return lcdifGetPb(hLcdIf);
+}
+
+
+/*******************************************************************************
+*
+*                    HD44780 MODULE 40X4 HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,573 @@
+/*******************************************************************************
+*
+* HD44780 MODULE BROADCAST HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module and the unmodified PIC32 LCD interface module
+* (lcdif_c32.c) on a host PC against the pin level simulator, with three
+* displays of different chipsets sharing RW, RS and a 4-bit data bus, each
+* with its own E pin. The displays are initialised through their own LCD
+* interfaces and a line of text is then written to each in turn, and again to
+* all of them at once through a broadcast interface strobing all three E pins.
+* The program checks that every display shows the text, that no display is
+* written while busy, that reads are refused on the broadcast interface and
+* that broadcasting takes about a third of the time. It reports how long each
+* approach took.
+*
+* Filename : hd44780TestHostBroadcast.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on an x86 or x86-64 Linux PC:
+*   gcc -D__PIC32MX__
+*       -I../HD44780Sim/pic32 -I../HD44780Sim -I../HD44780_module
+*       -I../lcdif_module
+*       hd44780TestHostBroadcast.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_c32.c ../HD44780Sim/hd44780simpic32.c
+*       ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostBroadcast
+*   ./hd44780TestHostBroadcast
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                 HD44780 MODULE BROADCAST HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include <p32xxxx.h>
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+#include "hd44780simpic32.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFDISPLAYS    3
+                                        /* Shared pins; data is on RD0-RD3    */
+#define RS_PIN              (1 << 4)
+#define RW_PIN              (1 << 5)
+#define DATA_PINS           0x0F
+                                        /* First display's E pin, the others  */
+                                        /* follow it                          */
+#define FIRST_E_PIN         (1 << 6)
+                                        /* Broadcasting may take this         */
+                                        /* fraction longer than writing one   */
+                                        /* display                            */
+#define MARGINDIVISOR       10
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTDISPLAY
+* Description:
+*   One simulated display and the objects driving it on its own
+*******************************************************************************/
+typedef struct TESTDISPLAYTYPE {
+    const char                    * name;
+    HD44780CLONE                    clone;
+    HD44780SIM                      hd44780Sim;
+    HD44780SIMPIC32PINS             simPins;
+    PBIFLCDENOBJ                    pbIfLcdEn;
+    LCDIFOBJ                        lcdIfObj;
+    LCDIFNUM                        lcdIfNum;
+    HLCDIF                          hLcdIf;
+    HD44780OBJ                      hd44780Obj;
+    HD44780NUM                      hd44780Num;
+    HHD44780                        hHd44780;
+} TESTDISPLAY;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const HD44780CLONE displayClones[NUMBEROFDISPLAYS] = {
+    HD44780U, KS0066U, NT7603
+};
+
+static const char * const displayNames[NUMBEROFDISPLAYS] = {
+    "HD44780U", "KS0066U", "NT7603"
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char message[] = "Same on all LCDs";
+static TESTDISPLAY          displays[NUMBEROFDISPLAYS];
+static HD44780INIT          initTable[NUMBEROFDISPLAYS];
+static PBIFOBJ              pbIf;
+static PBIFLCDENOBJ         broadcastLcdEn;
+static LCDIFOBJ             broadcastLcdIfObj;
+static LCDIFNUM             broadcastLcdIfNum;
+static HLCDIF               hBroadcastLcdIf;
+static HD44780OBJ           broadcastHd44780Obj;
+static HD44780NUM           broadcastHd44780Num;
+static HHD44780             hBroadcastHd44780;
+static LCDIFFP              lcdIfFuncPointers;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void openDisplay(TESTDISPLAY * display, unsigned char index);
+static void openBroadcast(void);
+static void initialiseDisplays(void);
+static HD44780SIMTIME testOneAfterAnother(void);
+static void testBroadcast(HD44780SIMTIME sequentialTime);
+static void checkDisplays(const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(__PIC32MX__)
+#error This test program must be built with __PIC32MX__ defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+    HD44780SIMTIME      sequentialTime;
+
+    testInit();
+    hd44780simPic32Init();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+                                        /* Fill the shared parallel bus       */
+                                        /* interface struct                   */
+    pbIf.RW_LAT     = &LATD;
+    pbIf.RW_BIT     = RW_PIN;
+    pbIf.RS_LAT     = &LATD;
+    pbIf.RS_BIT     = RS_PIN;
+    pbIf.DATA_LAT   = &LATD;
+    pbIf.DATA_PORT  = &PORTD;
+    pbIf.DATA_TRIS  = &TRISD;
+    pbIf.DATA_MASK  = DATA_PINS;
+    pbIf.RW_LATSET  = &LATDSET;
+    pbIf.RW_LATCLR  = &LATDCLR;
+    pbIf.RS_LATSET  = &LATDSET;
+    pbIf.RS_LATCLR  = &LATDCLR;
+    pbIf.DATA_LATINV = &LATDINV;
+    pbIf.DATA_TRISSET = &TRISDSET;
+    pbIf.DATA_TRISCLR = &TRISDCLR;
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        openDisplay(&displays[counter], counter);
+    }
+    check(hd44780simPic32Start(), "hd44780simPic32Start");
+                                        /* Make RW, RS and E lines outputs    */
+    LATDCLR = RW_PIN | RS_PIN | broadcastLcdEn.E_BIT;
+    TRISDCLR = RW_PIN | RS_PIN | broadcastLcdEn.E_BIT;
+
+    openBroadcast();
+    initialiseDisplays();
+
+    sequentialTime = testOneAfterAnother();
+    testBroadcast(sequentialTime);
+
+    hd44780Close(hBroadcastHd44780);
+    hd44780Destroy(broadcastHd44780Num);
+    lcdifClose(hBroadcastLcdIf);
+    lcdifDestroy(broadcastLcdIfNum);
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        hd44780Close(displays[counter].hHd44780);
+        hd44780Destroy(displays[counter].hd44780Num);
+        lcdifClose(displays[counter].hLcdIf);
+        lcdifDestroy(displays[counter].lcdIfNum);
+    }
+    hd44780simPic32Stop();
+
+    return testResult();
+}
+
+/*******************************************************************************
+* openDisplay()
+*
+* Description:
+*   Wires one display to the simulated PIC32 on its own E pin, creates and
+*   opens the objects driving it and adds it to the initialisation table
+*
+* See also:
+*
+* Arguments:
+*   display             - display to open
+*   index               - its position in the group
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openDisplay(TESTDISPLAY * display, unsigned char index)
+{
+    HD44780INIT       * init;
+
+    display->name = displayNames[index];
+    display->clone = displayClones[index];
+    hd44780simInit(&display->hd44780Sim, display->clone);
+
+    display->simPins.hd44780Sim = &display->hd44780Sim;
+    display->simPins.RW_LAT = &LATD;
+    display->simPins.RW_BIT = RW_PIN;
+    display->simPins.RS_LAT = &LATD;
+    display->simPins.RS_BIT = RS_PIN;
+    display->simPins.E_LAT = &LATD;
+    display->simPins.E_BIT = FIRST_E_PIN << index;
+    display->simPins.DATA_LAT = &LATD;
+    display->simPins.DATA_MASK = DATA_PINS;
+    check(hd44780simPic32Connect(&display->simPins), "hd44780simPic32Connect");
+                                        /* The broadcast interface strobes    */
+                                        /* every display's E pin              */
+    broadcastLcdEn.E_BIT |= FIRST_E_PIN << index;
+
+    display->pbIfLcdEn.E_LAT = &LATD;
+    display->pbIfLcdEn.E_BIT = FIRST_E_PIN << index;
+    display->pbIfLcdEn.E_LATSET = &LATDSET;
+    display->pbIfLcdEn.E_LATCLR = &LATDCLR;
+    display->lcdIfObj.pbIfObject = &pbIf;
+    display->lcdIfObj.pbIfLcdEnObject = &display->pbIfLcdEn;
+    display->lcdIfNum = lcdifCreate(&display->lcdIfObj);
+    display->hLcdIf = lcdifOpen(display->lcdIfNum);
+    check(display->hLcdIf != (HLCDIF) 0, "lcdifOpen");
+
+    display->hd44780Num = hd44780Create(display->hLcdIf, &lcdIfFuncPointers,
+                                        &display->hd44780Obj);
+    display->hHd44780 = hd44780Open(display->hd44780Num);
+    check(display->hHd44780 != (HHD44780) 0, "hd44780Open");
+
+    init = &initTable[index];
+    init->hHd44780 = display->hHd44780;
+    init->hd44780Clone = display->clone;
+    init->functionSet = TESTFUNCTIONSET;
+    init->displayOnOffControl = TESTDISPLAYCONTROL;
+    init->entryModeSet = TESTENTRYMODE;
+    init->initDone = 0;
+    init->waitTime = 0;
+}
+
+/*******************************************************************************
+* openBroadcast()
+*
+* Description:
+*   Creates and opens the broadcast LCD interface and the HD44780 object on it
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openBroadcast(void)
+{
+    broadcastLcdEn.E_LAT = &LATD;
+    broadcastLcdEn.E_LATSET = &LATDSET;
+    broadcastLcdEn.E_LATCLR = &LATDCLR;
+    broadcastLcdIfObj.pbIfObject = &pbIf;
+    broadcastLcdIfObj.pbIfLcdEnObject = &broadcastLcdEn;
+                                        /* A normal interface has only one E  */
+                                        /* pin                                */
+    check(lcdifCreate(&broadcastLcdIfObj) == 0,
+          "lcdifCreate refuses several E pins");
+    broadcastLcdIfNum = lcdifCreateBroadcast(&broadcastLcdIfObj);
+    hBroadcastLcdIf = lcdifOpen(broadcastLcdIfNum);
+    check(hBroadcastLcdIf != (HLCDIF) 0, "lcdifCreateBroadcast");
+
+    broadcastHd44780Num = hd44780Create(hBroadcastLcdIf, &lcdIfFuncPointers,
+                                        &broadcastHd44780Obj);
+    hBroadcastHd44780 = hd44780Open(broadcastHd44780Num);
+    check(hBroadcastHd44780 != (HHD44780) 0, "hd44780Open broadcast");
+    check(!hd44780SetBroadcastMode(hBroadcastHd44780, displayClones,
+                                   NUMBEROFDISPLAYS,
+                                   (unsigned int (*)(void)) 0),
+          "hd44780SetBroadcastMode needs a time source");
+}
+
+/*******************************************************************************
+* initialiseDisplays()
+*
+* Description:
+*   Initialises every display through its own interface, polling busy flags
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void initialiseDisplays(void)
+{
+    unsigned int        returnValue;
+    unsigned long       calls;
+
+    calls = 0;
+    do
+    {
+        returnValue = hd44780InstructionInitAll(initTable, NUMBEROFDISPLAYS);
+        calls++;
+        if (returnValue > 1)
+        {
+            hd44780simDelay(returnValue);
+        }
+    }
+    while (returnValue != 0 && calls < 100000);
+
+    check(returnValue == 0, "initialisation completes");
+}
+
+/*******************************************************************************
+* testOneAfterAnother()
+*
+* Description:
+*   Writes the line of text to each display in turn through its own interface
+*   in timed mode
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Time taken to write all the displays, in ns
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static HD44780SIMTIME testOneAfterAnother(void)
+{
+    TESTDISPLAY       * display;
+    unsigned char       counter;
+    HD44780SIMTIME      startTime;
+    HD44780SIMTIME      elapsed;
+
+    printf("\nWriting one display after another\n");
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        check(hd44780SetTimedMode(display->hHd44780, display->clone,
+                                  getMicroseconds), "hd44780SetTimedMode");
+        while (!hd44780ClearDisplay(display->hHd44780))
+        {
+        }
+    }
+                                        /* Let the Clear Display finish       */
+    while (!hd44780SetCursorAddr(displays[0].hHd44780, 0))
+    {
+    }
+
+    startTime = hd44780simGetTime();
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        while (!hd44780SetCursorAddr(display->hHd44780, 0))
+        {
+        }
+        while (hd44780WriteRAMString(display->hHd44780, message) !=
+                                                    (unsigned char *) 0)
+        {
+        }
+    }
+                                        /* Wait for the last write too        */
+    while (!hd44780SetCursorAddr(displays[NUMBEROFDISPLAYS - 1].hHd44780, 0))
+    {
+    }
+    elapsed = hd44780simGetTime() - startTime;
+
+    printf("    all displays: %llu us\n", elapsed / 1000);
+    checkDisplays("text on every display");
+
+    return elapsed;
+}
+
+/*******************************************************************************
+* testBroadcast()
+*
+* Description:
+*   Writes the line of text to all the displays at once through the broadcast
+*   interface and compares the time taken with writing them one after another
+*
+* See also:
+*
+* Arguments:
+*   sequentialTime      - time all displays took one after another, in ns
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testBroadcast(HD44780SIMTIME sequentialTime)
+{
+    unsigned char       counter;
+    unsigned char       address = 0;
+    HD44780SIMTIME      startTime;
+    HD44780SIMTIME      elapsed;
+    HD44780SIMPIC32STATS simStats;
+
+    printf("\nWriting all displays at once\n");
+                                        /* The displays' own objects have     */
+                                        /* been used, so restart the timing   */
+    check(hd44780SetBroadcastMode(hBroadcastHd44780, displayClones,
+                                  NUMBEROFDISPLAYS, getMicroseconds),
+          "hd44780SetBroadcastMode");
+    while (!hd44780ClearDisplay(hBroadcastHd44780))
+    {
+    }
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        check(displays[counter].hd44780Sim.ddram[0] == ' ',
+              "every display cleared");
+    }
+    while (!hd44780SetCursorAddr(hBroadcastHd44780, 0))
+    {
+    }
+
+    hd44780simPic32ClearStats();
+    startTime = hd44780simGetTime();
+    while (hd44780WriteRAMString(hBroadcastHd44780, message) !=
+                                                (unsigned char *) 0)
+    {
+    }
+                                        /* Wait for the last write too        */
+    while (!hd44780SetCursorAddr(hBroadcastHd44780, 0))
+    {
+    }
+    elapsed = hd44780simGetTime() - startTime;
+
+    printf("    all displays: %llu us, %.1f%% of the time taken one after "
+           "another\n", elapsed / 1000, 100.0 * elapsed / sequentialTime);
+    checkDisplays("text on every display");
+    check(elapsed * NUMBEROFDISPLAYS <=
+          sequentialTime + sequentialTime / MARGINDIVISOR,
+          "about as long as writing one display");
+
+    hd44780simPic32GetStats(&simStats);
+    check(simStats.busContentions == 0, "no bus contention");
+                                        /* Reads can't be told apart          */
+    check(!hd44780ReadAddr(hBroadcastHd44780, &address),
+          "hd44780ReadAddr refused on broadcast");
+    hd44780simPic32GetStats(&simStats);
+    check(simStats.busContentions == 0, "no bus cycle for a refused read");
+                                        /* Each display can still be read     */
+                                        /* through its own interface          */
+    check(hd44780SetTimedMode(displays[0].hHd44780, displays[0].clone,
+                              (unsigned int (*)(void)) 0),
+          "hd44780SetTimedMode off");
+    while (!hd44780ReadAddr(displays[0].hHd44780, &address))
+    {
+    }
+    check(address == 0, "address read through own interface");
+}
+
+/*******************************************************************************
+* checkDisplays()
+*
+* Description:
+*   Checks that every display shows the line of text and was never written
+*   while busy
+*
+* See also:
+*
+* Arguments:
+*   description         - what is being checked
+*
+* Returns:
+*   void
+*
+* Callers: testOneAfterAnother(), testBroadcast()
+*
+* Notes :
+*
+*******************************************************************************/
+static void checkDisplays(const char * description)
+{
+    unsigned char       counter;
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        if (memcmp(displays[counter].hd44780Sim.ddram, message,
+                   sizeof(message) - 1) != 0)
+        {
+            printf("    %s: ", displays[counter].name);
+        }
+        check(memcmp(displays[counter].hd44780Sim.ddram, message,
+                     sizeof(message) - 1) == 0, description);
+        check(displays[counter].hd44780Sim.stats.violations == 0,
+              "no writes while busy");
+    }
+}
+
+
+/*******************************************************************************
+*
+*                 HD44780 MODULE BROADCAST HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,463 @@
+/*******************************************************************************
+*
+* HD44780 MODULE CGRAM UPLOAD HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module on a host PC against a simulated display and uploads
+* user defined characters with hd44780WriteCGRAMBlock(), polling the busy flag
+* and in timed mode. Eight 5x8 characters with blank rows and four 5x10
+* characters are uploaded and the program checks that CGRAM holds them, that
+* the CGRAM address was set only as often as needed, that timed mode finishes
+* in one call, that bad arguments are refused and that the display was never
+* written while busy. The same characters are then uploaded one at a time
+* with hd44780SetCGRAMAddr() and hd44780WriteCGRAM() and the time and number
+* of calls each approach took is reported.
+*
+* Filename : hd44780TestHostCGRAM.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostCGRAM.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostCGRAM
+*   ./hd44780TestHostCGRAM
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                  HD44780 MODULE CGRAM UPLOAD HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFMODES       2
+#define CHARACTERS5X8       8
+#define CHARACTERS5X10      4
+                                        /* CGRAM bytes per 5x10 character     */
+#define CHARACTERSIZE5X10   16
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMODE
+* Description:
+*   How the characters are uploaded
+*******************************************************************************/
+typedef struct TESTMODETYPE {
+    const char                    * name;
+    unsigned char                   timed;
+} TESTMODE;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTMODE testModes[NUMBEROFMODES] = {
+    { "busy flag",  0 },
+    { "timed",      1 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+                                        /* 5x8 characters with blank rows     */
+static unsigned char        font5x8[CHARACTERS5X8 * CGRAMFONT_5X8];
+static unsigned char        font5x10[CHARACTERS5X10 * CGRAMFONT_5X10];
+                                        /* 5x8 characters without blank rows, */
+                                        /* each zero terminated for           */
+                                        /* hd44780WriteCGRAM()                */
+static unsigned char        solid5x8[CHARACTERS5X8 * CGRAMFONT_5X8];
+static unsigned char        strings5x8[CHARACTERS5X8][CGRAMFONT_5X8 + 1];
+static LCDIFFP              lcdIfFuncPointers;
+static TESTDISPLAY          display;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void makeFonts(void);
+static void testMode(const TESTMODE * mode);
+static void testArguments(void);
+static void testCompare(const TESTMODE * mode);
+static unsigned int uploadBlock(unsigned char firstCharacter,
+                                const unsigned char * characters,
+                                unsigned char numberOfCharacters,
+                                unsigned char font);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+    makeFonts();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+
+    for (counter = 0; counter < NUMBEROFMODES; counter++)
+    {
+        testMode(&testModes[counter]);
+    }
+
+    return testResult();
+}
+
+/*******************************************************************************
+* makeFonts()
+*
+* Description:
+*   Fills the font tables. The top and bottom rows of the characters in
+*   font5x8 and font5x10 are blank, as in most real fonts; the characters in
+*   solid5x8 have no blank rows
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void makeFonts(void)
+{
+    unsigned char       character;
+    unsigned char       row;
+    unsigned char       dots;
+
+    for (character = 0; character < CHARACTERS5X8; character++)
+    {
+        for (row = 0; row < CGRAMFONT_5X8; row++)
+        {
+            dots = (unsigned char) ((character * 7 + row * 11) ^ (row << 2))
+                   & 0x1F;
+            font5x8[character * CGRAMFONT_5X8 + row] =
+                          (row == 0 || row == CGRAMFONT_5X8 - 1) ? 0x00 : dots;
+            solid5x8[character * CGRAMFONT_5X8 + row] = dots | 0x01;
+            strings5x8[character][row] = dots | 0x01;
+        }
+        strings5x8[character][CGRAMFONT_5X8] = 0;
+    }
+    for (character = 0; character < CHARACTERS5X10; character++)
+    {
+        for (row = 0; row < CGRAMFONT_5X10; row++)
+        {
+            font5x10[character * CGRAMFONT_5X10 + row] =
+                    (row == 0 || row == CGRAMFONT_5X10 - 1) ? 0x00 :
+                    (unsigned char) ((character * 5 + row * 3) & 0x1F);
+        }
+    }
+}
+
+/*******************************************************************************
+* testMode()
+*
+* Description:
+*   Uploads 5x8 and 5x10 characters in one mode, checking each upload
+*
+* See also:
+*
+* Arguments:
+*   mode                - how characters are uploaded
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testMode(const TESTMODE * mode)
+{
+    unsigned char       character;
+    unsigned char       wrong;
+    unsigned long       instructions;
+    unsigned int        calls;
+
+    printf("\n%s\n", mode->name);
+    testOpenDisplay(&display, HD44780U, BUS4BITSWIDE, &lcdIfFuncPointers,
+                    mode->timed);
+    testInitDisplay(&display);
+
+    testArguments();
+                                        /* Eight 5x8 characters with blank    */
+                                        /* rows in one upload                 */
+    instructions = display.hd44780Sim.stats.instructions;
+    calls = uploadBlock(0, font5x8, CHARACTERS5X8, CGRAMFONT_5X8);
+    printf("    %u 5x8 characters uploaded in %u call(s)\n", CHARACTERS5X8,
+           calls);
+    check(memcmp(display.hd44780Sim.cgram, font5x8, sizeof(font5x8)) == 0,
+          "5x8 characters in CGRAM");
+    check(display.hd44780Sim.stats.instructions - instructions == 1,
+          "CGRAM address set once");
+    if (mode->timed)
+    {
+        check(calls == 1, "timed upload in one call");
+    }
+                                        /* Part of the table, further on      */
+    memset(display.hd44780Sim.cgram, 0, sizeof(display.hd44780Sim.cgram));
+    uploadBlock(5, font5x8, 3, CGRAMFONT_5X8);
+    check(memcmp(&display.hd44780Sim.cgram[5 * CGRAMFONT_5X8], font5x8,
+                 3 * CGRAMFONT_5X8) == 0 && display.hd44780Sim.cgram[0] == 0,
+          "5x8 characters 5 to 7 in CGRAM");
+                                        /* Four 5x10 characters; each starts  */
+                                        /* 16 bytes on                        */
+    instructions = display.hd44780Sim.stats.instructions;
+    calls = uploadBlock(0, font5x10, CHARACTERS5X10, CGRAMFONT_5X10);
+    printf("    %u 5x10 characters uploaded in %u call(s)\n", CHARACTERS5X10,
+           calls);
+    wrong = 0;
+    for (character = 0; character < CHARACTERS5X10; character++)
+    {
+        wrong |= memcmp(&display.hd44780Sim.cgram[character *
+                                                  CHARACTERSIZE5X10],
+                        &font5x10[character * CGRAMFONT_5X10],
+                        CGRAMFONT_5X10) != 0;
+    }
+    check(!wrong, "5x10 characters in CGRAM");
+    check(display.hd44780Sim.stats.instructions - instructions ==
+          CHARACTERS5X10, "CGRAM address set once per 5x10 character");
+    if (mode->timed)
+    {
+        check(calls == 1, "timed 5x10 upload in one call");
+    }
+
+    testCompare(mode);
+
+    check(display.hd44780Sim.stats.violations == 0, "no writes while busy");
+
+    testCloseDisplay(&display);
+}
+
+/*******************************************************************************
+* testArguments()
+*
+* Description:
+*   Checks that uploads that don't fit CGRAM, or use an unknown font, are
+*   refused without touching the display
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testArguments(void)
+{
+    unsigned long       writeCycles;
+
+    writeCycles = display.hd44780Sim.stats.writeCycles;
+    check(hd44780WriteCGRAMBlock(display.hHd44780, 0, font5x8, 1, 7, 0) == 0,
+          "unknown font refused");
+    check(hd44780WriteCGRAMBlock(display.hHd44780, 7, font5x8, 2, CGRAMFONT_5X8,
+                                 0) == 0, "9th 5x8 character refused");
+    check(hd44780WriteCGRAMBlock(display.hHd44780, 8, font5x8, 0, CGRAMFONT_5X8,
+                                 0) == 0, "5x8 character 8 refused");
+    check(hd44780WriteCGRAMBlock(display.hHd44780, 2, font5x10, 3,
+                                 CGRAMFONT_5X10, 0) == 0,
+          "5th 5x10 character refused");
+    check(hd44780WriteCGRAMBlock(display.hHd44780, 0, font5x8, 1, CGRAMFONT_5X8,
+                                 CGRAMFONT_5X8) == CGRAMFONT_5X8,
+          "finished upload left alone");
+    check(display.hd44780Sim.stats.writeCycles == writeCycles,
+          "nothing written for bad arguments");
+}
+
+/*******************************************************************************
+* testCompare()
+*
+* Description:
+*   Uploads eight 5x8 characters one at a time with hd44780SetCGRAMAddr() and
+*   hd44780WriteCGRAM(), then all together with hd44780WriteCGRAMBlock(), and
+*   reports the time and calls each took
+*
+* See also:
+*
+* Arguments:
+*   mode                - how characters are uploaded
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testCompare(const TESTMODE * mode)
+{
+    unsigned char       character;
+    const unsigned char * position;
+    unsigned int        calls[2];
+    unsigned long       instructions[2];
+    HD44780SIMTIME      startTime;
+    HD44780SIMTIME      elapsed[2];
+                                        /* One character at a time            */
+    memset(display.hd44780Sim.cgram, 0, sizeof(display.hd44780Sim.cgram));
+    calls[0] = 0;
+    instructions[0] = display.hd44780Sim.stats.instructions;
+    startTime = hd44780simGetTime();
+    for (character = 0; character < CHARACTERS5X8; character++)
+    {
+        do
+        {
+            calls[0]++;
+        }
+        while (!hd44780SetCGRAMAddr(display.hHd44780,
+                                    character * CGRAMFONT_5X8));
+        position = strings5x8[character];
+        do
+        {
+            calls[0]++;
+            position = hd44780WriteCGRAM(display.hHd44780, position,
+                                         CGRAMFONT_5X8);
+        }
+        while (position != (const unsigned char *) 0);
+    }
+    elapsed[0] = hd44780simGetTime() - startTime;
+    instructions[0] = display.hd44780Sim.stats.instructions - instructions[0];
+    check(memcmp(display.hd44780Sim.cgram, solid5x8, sizeof(solid5x8)) == 0,
+          "characters in CGRAM, one at a time");
+                                        /* All in one upload                  */
+    memset(display.hd44780Sim.cgram, 0, sizeof(display.hd44780Sim.cgram));
+    instructions[1] = display.hd44780Sim.stats.instructions;
+    startTime = hd44780simGetTime();
+    calls[1] = uploadBlock(0, solid5x8, CHARACTERS5X8, CGRAMFONT_5X8);
+    elapsed[1] = hd44780simGetTime() - startTime;
+    instructions[1] = display.hd44780Sim.stats.instructions - instructions[1];
+    check(memcmp(display.hd44780Sim.cgram, solid5x8, sizeof(solid5x8)) == 0,
+          "characters in CGRAM, one upload");
+
+    printf("    one at a time: %lu instruction(s), %u call(s), %llu us\n",
+           instructions[0], calls[0], elapsed[0] / 1000);
+    printf("    one upload:    %lu instruction(s), %u call(s), %llu us\n",
+           instructions[1], calls[1], elapsed[1] / 1000);
+    check(instructions[1] == 1 && instructions[0] == CHARACTERS5X8,
+          "fewer Set CGRAM Address instructions");
+    check(elapsed[1] < elapsed[0], "one upload is faster");
+    if (mode->timed)
+    {
+        check(calls[1] == 1 && calls[1] < calls[0], "fewer calls");
+    }
+}
+
+/*******************************************************************************
+* uploadBlock()
+*
+* Description:
+*   Calls hd44780WriteCGRAMBlock() until the upload is complete
+*
+* See also:
+*
+* Arguments:
+*   firstCharacter      - first character code to define
+*   characters          - font data
+*   numberOfCharacters  - number of characters to upload
+*   font                - CGRAMFONT_5X8 or CGRAMFONT_5X10
+*
+* Returns:
+*   Number of calls made
+*
+* Callers: testMode(), testCompare()
+*
+* Notes :
+*
+*******************************************************************************/
+static unsigned int uploadBlock(unsigned char firstCharacter,
+                                const unsigned char * characters,
+                                unsigned char numberOfCharacters,
+                                unsigned char font)
+{
+    unsigned char       written = 0;
+    unsigned int        calls = 0;
+
+    while (written != numberOfCharacters * font && calls < 10000)
+    {
+        written = hd44780WriteCGRAMBlock(display.hHd44780, firstCharacter,
+                                         characters, numberOfCharacters, font,
+                                         written);
+        calls++;
+    }
+    check(written == numberOfCharacters * font, "upload complete");
+
+    return calls;
+}
+
+
+/*******************************************************************************
+*
+*              HD44780 MODULE CGRAM UPLOAD HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,401 @@
+/*******************************************************************************
+*
+* HD44780 MODULE HOST TEST HARNESS
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Harness shared by the host test programs. Each program keeps only its own
+* behaviour checks and links this file for recording and reporting checks,
+* initialising the modules, filling the LCD function pointers struct, the
+* microsecond count used in timed mode and, with LCDIF_HOST_SIM, opening,
+* initialising and closing simulated displays.
+*
+* Filename : hd44780TestHostCommon.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Add this file and its directory to the gcc command of a test program; the
+* command is given at the top of each program.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                        HD44780 MODULE HOST TEST HARNESS
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static unsigned int         testFailures;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+unsigned long               writeOnlyReads;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static unsigned char writeOnlyRead(HLCDIF const hLcdIf,
+                                   unsigned char * const data);
+
+
+/*******************************************************************************
+* testInit()
+*
+* Description:
+*   Clears the check and read counts, sets the simulated clock back to zero
+*   and initialises the LCD interface and HD44780 modules
+*
+* See also:
+*   testResult()
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: Host test programs
+*
+* Notes :
+* 1. Simulators with their own state, such as the PIC32 one, are initialised
+*    by the test program as well
+*
+*******************************************************************************/
+void testInit(void)
+{
+    testFailures = 0;
+    writeOnlyReads = 0;
+                                        /* Init modules                       */
+    hd44780simResetTime();
+    lcdifInit();
+    hd44780Init();
+}
+
+/*******************************************************************************
+* testResult()
+*
+* Description:
+*   Prints the overall result of the test program
+*
+* See also:
+*   testInit(), check()
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks, for main() to return
+*
+* Callers: Host test programs
+*
+* Notes :
+*
+*******************************************************************************/
+int testResult(void)
+{
+    printf("\n%s: %u check(s) failed\n",
+           testFailures ? "FAIL" : "PASS", testFailures);
+
+    return (int) testFailures;
+}
+
+/*******************************************************************************
+* check()
+*
+* Description:
+*   Records and reports the result of one test check
+*
+* See also:
+*   testResult()
+*
+* Arguments:
+*   condition           - non-zero if the check passed
+*   description         - what was checked
+*
+* Returns:
+*   void
+*
+* Callers: Host test programs, testOpenDisplay()
+*
+* Notes :
+*
+*******************************************************************************/
+void check(int condition, const char * description)
+{
+    if (!condition)
+    {
+        printf("    FAILED: %s\n", description);
+        testFailures++;
+    }
+}
+
+/*******************************************************************************
+* testFuncPointers()
+*
+* Description:
+*   Fills an LCD function pointers struct with the LCD interface module's
+*   functions
+*
+* See also:
+*
+* Arguments:
+*   lcdIfFuncPointers   - struct to fill
+*   writeOnly           - non-zero if RW is tied low, so nothing can be read
+*
+* Returns:
+*   void
+*
+* Callers: Host test programs
+*
+* Notes :
+* 1. On write-only wiring the read functions are replaced by one that counts
+*    every attempt in writeOnlyReads, and there is no block read
+*
+*******************************************************************************/
+void testFuncPointers(LCDIFFP * const lcdIfFuncPointers,
+                      unsigned char writeOnly)
+{
+    lcdIfFuncPointers->pGetBus = lcdifGetPb;
+    lcdIfFuncPointers->pReturnBus = lcdifReturnPb;
+    lcdIfFuncPointers->pWriteData = lcdifWriteData;
+    lcdIfFuncPointers->pReadData = lcdifReadData;
+    lcdIfFuncPointers->pWriteInstr = lcdifWriteInstruction;
+    lcdIfFuncPointers->pReadAddr = lcdifReadAddress;
+    lcdIfFuncPointers->p4BitFunctionSet = lcdif4BitFunctionSet;
+    lcdIfFuncPointers->pWriteDataBlock = lcdifWriteDataBlock;
+    lcdIfFuncPointers->pWriteInstrBlock = lcdifWriteInstructionBlock;
+    lcdIfFuncPointers->pReadDataBlock = lcdifReadDataBlock;
+                                        /* With RW tied low nothing can be    */
+                                        /* read                               */
+    if (writeOnly)
+    {
+        lcdIfFuncPointers->pReadData = writeOnlyRead;
+        lcdIfFuncPointers->pReadAddr = writeOnlyRead;
+        lcdIfFuncPointers->pReadDataBlock = 0;
+    }
+}
+
+/*******************************************************************************
+* getMicroseconds()
+*
+* Description:
+*   Free running microsecond count handed to the driver in timed mode
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Simulated time in microseconds
+*
+* Callers: HD44780 module
+*
+* Notes :
+* 1. Each call lets one bus cycle time pass, standing in for the time the
+*    code reading the timer would take on the target
+*
+*******************************************************************************/
+unsigned int getMicroseconds(void)
+{
+    hd44780simAdvance(hd44780simGetCycleTime());
+
+    return (unsigned int) (hd44780simGetTime() / 1000ULL);
+}
+
+#if defined(LCDIF_HOST_SIM)
+/*******************************************************************************
+* testOpenDisplay()
+*
+* Description:
+*   Powers on a simulated display and creates and opens the LCD interface and
+*   HD44780 objects driving it
+*
+* See also:
+*   testInitDisplay(), testCloseDisplay()
+*
+* Arguments:
+*   display             - display to open
+*   clone               - chipset of the display
+*   busWidth            - BUS4BITSWIDE or BUS8BITSWIDE
+*   lcdIfFuncPointers   - LCD function pointers for the HD44780 object
+*   timed               - non-zero to put the display in timed mode
+*
+* Returns:
+*   void
+*
+* Callers: Host test programs
+*
+* Notes :
+* 1. The display is not initialised; see testInitDisplay()
+*
+*******************************************************************************/
+void testOpenDisplay(TESTDISPLAY * const display, HD44780CLONE clone,
+                     unsigned char busWidth,
+                     LCDIFFP * const lcdIfFuncPointers, unsigned char timed)
+{
+    display->clone = clone;
+    hd44780simInit(&display->hd44780Sim, clone);
+    display->lcdIfObj.hd44780Sim = &display->hd44780Sim;
+    display->lcdIfObj.busWidth = busWidth;
+    display->lcdIfNum = lcdifCreate(&display->lcdIfObj);
+    display->hLcdIf = lcdifOpen(display->lcdIfNum);
+    check(display->hLcdIf != (HLCDIF) 0, "lcdifOpen");
+
+    display->hd44780Num = hd44780Create(display->hLcdIf, lcdIfFuncPointers,
+                                        &display->hd44780Obj);
+    display->hHd44780 = hd44780Open(display->hd44780Num);
+    check(display->hHd44780 != (HHD44780) 0, "hd44780Open");
+    if (timed)
+    {
+        check(hd44780SetTimedMode(display->hHd44780, clone, getMicroseconds),
+              "hd44780SetTimedMode");
+    }
+}
+
+/*******************************************************************************
+* testInitDisplay()
+*
+* Description:
+*   Initialises an open display by instruction with the TEST settings,
+*   waiting as long as the driver asks
+*
+* See also:
+*   testOpenDisplay()
+*
+* Arguments:
+*   display             - display to initialise
+*
+* Returns:
+*   void
+*
+* Callers: Host test programs
+*
+* Notes :
+*
+*******************************************************************************/
+void testInitDisplay(TESTDISPLAY * const display)
+{
+    unsigned int        returnValue;
+
+    do
+    {
+        returnValue = hd44780InstructionInit(display->hHd44780,
+                                             display->clone,
+                                             TESTFUNCTIONSET,
+                                             TESTDISPLAYCONTROL,
+                                             TESTENTRYMODE);
+        if (returnValue > 1)
+        {
+            hd44780simDelay(returnValue);
+        }
+    }
+    while (returnValue != 0);
+}
+
+/*******************************************************************************
+* testCloseDisplay()
+*
+* Description:
+*   Closes and destroys a display's objects
+*
+* See also:
+*   testOpenDisplay()
+*
+* Arguments:
+*   display             - display to close
+*
+* Returns:
+*   void
+*
+* Callers: Host test programs
+*
+* Notes :
+*
+*******************************************************************************/
+void testCloseDisplay(TESTDISPLAY * const display)
+{
+    hd44780Close(display->hHd44780);
+    hd44780Destroy(display->hd44780Num);
+    lcdifClose(display->hLcdIf);
+    lcdifDestroy(display->lcdIfNum);
+}
+#endif
+
+/*******************************************************************************
+* writeOnlyRead()
+*
+* Description:
+*   Stands in for the read functions of the LCD interface when RW is tied low,
+*   counting any attempt to read
+*
+* See also:
+*   testFuncPointers()
+*
+* Arguments:
+*   hLcdIf              - handle to the LCD interface
+*   data                - where to store the data read
+*
+* Returns:
+*   1
+*
+* Callers: HD44780 module
+*
+* Notes :
+*
+*******************************************************************************/
+static unsigned char writeOnlyRead(HLCDIF const hLcdIf,
+                                   unsigned char * const data)
+{
+    (void) hLcdIf;
+    writeOnlyReads++;
+    *data = 0x00;
+
+    return 1;
+}
+
+
+/*******************************************************************************
+*
+*                      HD44780 MODULE HOST TEST HARNESS END
+*
+*******************************************************************************/
@@ -0,0 +1,128 @@
+/*******************************************************************************
+*
+* HD44780 MODULE HOST TEST HARNESS
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Harness shared by the host test programs: recording and reporting checks,
+* initialising the modules, filling the LCD function pointers struct and the
+* microsecond count handed to the driver in timed mode. Programs built with
+* LCDIF_HOST_SIM can also open, initialise and close a simulated display
+* through lcdif_host.c with one call each.
+* All contents within this file are 'public' and to be used by the test
+* programs
+*
+* Filename : hd44780TestHostCommon.h
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* This module is only intended for use on a host PC (gcc or similar) and is
+* not part of any target build. Build hd44780TestHostCommon.c with the same
+* defines and include paths as the test program it is linked with
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                        HD44780 MODULE HOST TEST HARNESS
+*
+*******************************************************************************/
+#ifndef __HD44780TESTHOSTCOMMON_PRESENT__
+#define __HD44780TESTHOSTCOMMON_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "HD44780.h"
+#include "hd44780sim.h"
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Settings testInitDisplay() initialises a display with
+*******************************************************************************/
+#define TESTFUNCTIONSET     (FS_5X8DOTS & FS_2LINE)
+#define TESTDISPLAYCONTROL  (DOFC_BLINKINGOFF & DOFC_CURSOROFF & DOFC_DISPLAYON)
+#define TESTENTRYMODE       (EMS_CURSORMOVE & EMS_INCREMENT)
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+#if defined(LCDIF_HOST_SIM)
+/*******************************************************************************
+* New data type TESTDISPLAY
+* Description:
+*   One simulated display and the objects driving it
+*******************************************************************************/
+typedef struct TESTDISPLAYTYPE {
+    HD44780CLONE                    clone;
+    HD44780SIM                      hd44780Sim;
+    LCDIFOBJ                        lcdIfObj;
+    LCDIFNUM                        lcdIfNum;
+    HLCDIF                          hLcdIf;
+    HD44780OBJ                      hd44780Obj;
+    HD44780NUM                      hd44780Num;
+    HHD44780                        hHd44780;
+} TESTDISPLAY;
+#endif
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+                                        /* Reads attempted through function   */
+                                        /* pointers filled as write-only      */
+extern unsigned long writeOnlyReads;
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            testInit(void);
+int             testResult(void);
+void            check(int                               condition,
+                      const char                      * description);
+void            testFuncPointers(LCDIFFP        * const lcdIfFuncPointers,
+                                 unsigned char          writeOnly);
+unsigned int    getMicroseconds(void);
+
+#if defined(LCDIF_HOST_SIM)
+void            testOpenDisplay(TESTDISPLAY     * const display,
+                                HD44780CLONE            clone,
+                                unsigned char           busWidth,
+                                LCDIFFP         * const lcdIfFuncPointers,
+                                unsigned char           timed);
+void            testInitDisplay(TESTDISPLAY     * const display);
+void            testCloseDisplay(TESTDISPLAY    * const display);
+#endif
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*
+*                      HD44780 MODULE HOST TEST HARNESS END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,439 @@
+/*******************************************************************************
+*
+* HD44780 MODULE GEOMETRY HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module on a host PC against a simulated display and writes
+* to it by row and column, polling the busy flag and in timed mode. Every row
+* of each stock geometry is filled with hd44780WriteAt() and the simulated
+* DDRAM is checked against the row address tables, along with the number of
+* Set DDRAM Address instructions used. This is compared with moving the
+* cursor before every character. Clipping at the end of a row and off the
+* display, hd44780SetCursorPos() and invalid geometries are also checked. The
+* display must never be written while busy.
+*
+* Filename : hd44780TestHostGeometry.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostGeometry.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostGeometry
+*   ./hd44780TestHostGeometry
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                   HD44780 MODULE GEOMETRY HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFMODES       2
+#define NUMBEROFGEOMETRIES  12
+                                        /* Most calls allowed for one write   */
+#define MAXCALLS            10000
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMODE
+* Description:
+*   How the display is written
+*******************************************************************************/
+typedef struct TESTMODETYPE {
+    const char                    * name;
+    unsigned char                   timed;
+} TESTMODE;
+
+/*******************************************************************************
+* New data type TESTGEOMETRY
+* Description:
+*   One stock geometry and the DDRAM address of the first character of each of
+*   its rows, worked out from the data sheets rather than the module's tables.
+*   The rows of a split 16x1 display are its two halves
+*******************************************************************************/
+typedef struct TESTGEOMETRYTYPE {
+    const char                    * name;
+    const HD44780GEOMETRY         * geometry;
+    unsigned char                   segmentAddresses[4];
+} TESTGEOMETRY;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTMODE testModes[NUMBEROFMODES] = {
+    { "busy flag",  0 },
+    { "timed",      1 }
+};
+
+static const TESTGEOMETRY testGeometries[NUMBEROFGEOMETRIES] = {
+    { "8x1",        &hd44780Geometry8x1,        { 0x00 } },
+    { "8x2",        &hd44780Geometry8x2,        { 0x00, 0x40 } },
+    { "16x1",       &hd44780Geometry16x1,       { 0x00, 0x40 } },
+    { "16x1 linear",&hd44780Geometry16x1Linear, { 0x00 } },
+    { "16x2",       &hd44780Geometry16x2,       { 0x00, 0x40 } },
+    { "16x4",       &hd44780Geometry16x4,       { 0x00, 0x40, 0x10, 0x50 } },
+    { "20x1",       &hd44780Geometry20x1,       { 0x00 } },
+    { "20x2",       &hd44780Geometry20x2,       { 0x00, 0x40 } },
+    { "20x4",       &hd44780Geometry20x4,       { 0x00, 0x40, 0x14, 0x54 } },
+    { "24x2",       &hd44780Geometry24x2,       { 0x00, 0x40 } },
+    { "40x1",       &hd44780Geometry40x1,       { 0x00 } },
+    { "40x2",       &hd44780Geometry40x2,       { 0x00, 0x40 } }
+};
+
+                                        /* Columns don't split into segments  */
+static const unsigned char testBadRowAddresses[] = { 0x00, 0x40 };
+static const HD44780GEOMETRY testBadGeometry = { 1, 16, 6,
+                                                 testBadRowAddresses };
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static unsigned char        text[HD44780SIM_DDRAMSIZE];
+static LCDIFFP              lcdIfFuncPointers;
+static TESTDISPLAY          display;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testMode(const TESTMODE * mode);
+static void testGeometry(const TESTMODE * mode, const TESTGEOMETRY * test);
+static void testClipping(void);
+static unsigned int writeAt(unsigned char row, unsigned char column,
+                            const unsigned char * characters,
+                            unsigned char length);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+    for (counter = 0; counter < sizeof(text); counter++)
+    {
+        text[counter] = (unsigned char) ('A' + counter % 26);
+    }
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+
+    for (counter = 0; counter < NUMBEROFMODES; counter++)
+    {
+        testMode(&testModes[counter]);
+    }
+
+    return testResult();
+}
+
+/*******************************************************************************
+* testMode()
+*
+* Description:
+*   Runs every geometry test in one mode
+*
+* See also:
+*
+* Arguments:
+*   mode                - how the display is written
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testMode(const TESTMODE * mode)
+{
+    unsigned char       counter;
+
+    printf("\n%s\n", mode->name);
+    testOpenDisplay(&display, HD44780U, BUS4BITSWIDE, &lcdIfFuncPointers,
+                    mode->timed);
+    testInitDisplay(&display);
+                                        /* Nothing to go on without a         */
+                                        /* geometry                           */
+    check(hd44780SetCursorPos(display.hHd44780, 0, 0) == 0,
+          "hd44780SetCursorPos without a geometry");
+    check(hd44780WriteAt(display.hHd44780, 0, 0, text, 4, 0) == 0,
+          "hd44780WriteAt without a geometry");
+    check(hd44780AttachGeometry(display.hHd44780, &testBadGeometry) == 0,
+          "geometry with part segments refused");
+    check(hd44780AttachGeometry(display.hHd44780, (HD44780GEOMETRY *) 0),
+          "geometry detached");
+
+    for (counter = 0; counter < NUMBEROFGEOMETRIES; counter++)
+    {
+        testGeometry(mode, &testGeometries[counter]);
+    }
+    testClipping();
+
+    check(display.hd44780Sim.stats.violations == 0, "no writes while busy");
+
+    testCloseDisplay(&display);
+}
+
+/*******************************************************************************
+* testGeometry()
+*
+* Description:
+*   Fills every row of one geometry with hd44780WriteAt(), checking where the
+*   characters land and the instructions used, and then fills it again moving
+*   the cursor before every character to compare
+*
+* See also:
+*
+* Arguments:
+*   mode                - how the display is written
+*   test                - geometry under test
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testGeometry(const TESTMODE * mode, const TESTGEOMETRY * test)
+{
+    const HD44780GEOMETRY * geometry = test->geometry;
+    unsigned char       segments;
+    unsigned char       segment;
+    unsigned char       row;
+    unsigned char       column;
+    unsigned char       match;
+    unsigned int        calls;
+    unsigned long       instructions[2];
+    unsigned long       startInstructions;
+
+    check(hd44780AttachGeometry(display.hHd44780, geometry), test->name);
+    segments = geometry->columns / geometry->segmentColumns;
+    memset(display.hd44780Sim.ddram, ' ', sizeof(display.hd44780Sim.ddram));
+                                        /* A row at a time                    */
+    match = 1;
+    calls = 0;
+    startInstructions = display.hd44780Sim.stats.instructions;
+    for (row = 0; row < geometry->rows; row++)
+    {
+        calls += writeAt(row, 0, &text[row * geometry->columns],
+                         geometry->columns);
+        for (segment = 0; segment < segments; segment++)
+        {
+            if (memcmp(&display.hd44780Sim.ddram[test->segmentAddresses[row *
+                                                       segments + segment]],
+                       &text[row * geometry->columns +
+                             segment * geometry->segmentColumns],
+                       geometry->segmentColumns) != 0)
+            {
+                match = 0;
+            }
+        }
+    }
+    instructions[0] = display.hd44780Sim.stats.instructions - startInstructions;
+    check(match, "rows written at the data sheet addresses");
+    check(instructions[0] == (unsigned long) geometry->rows * segments,
+          "one Set DDRAM Address per row segment");
+    if (mode->timed)
+    {
+        check(calls == geometry->rows, "timed row written in one call");
+    }
+                                        /* Moving the cursor every character  */
+    startInstructions = display.hd44780Sim.stats.instructions;
+    for (row = 0; row < geometry->rows; row++)
+    {
+        for (column = 0; column < geometry->columns; column++)
+        {
+            while (!hd44780SetCursorPos(display.hHd44780, row, column))
+            {
+            }
+            while (!hd44780WriteChar(display.hHd44780,
+                                     text[row * geometry->columns + column]))
+            {
+            }
+        }
+    }
+    instructions[1] = display.hd44780Sim.stats.instructions - startInstructions;
+
+    printf("    %-12s %2lu instruction(s) by row, %3lu by character\n",
+           test->name, instructions[0], instructions[1]);
+}
+
+/*******************************************************************************
+* testClipping()
+*
+* Description:
+*   Writes off the end of a row and off the display, and moves the cursor
+*   with hd44780SetCursorPos()
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testClipping(void)
+{
+    unsigned long       dataWrites;
+    unsigned char       written;
+
+    check(hd44780AttachGeometry(display.hHd44780, &hd44780Geometry16x2),
+          "hd44780AttachGeometry");
+    memset(display.hd44780Sim.ddram, ' ', sizeof(display.hd44780Sim.ddram));
+    dataWrites = display.hd44780Sim.stats.dataWrites;
+    writeAt(0, 14, (const unsigned char *) "ABCDEF", 6);
+    check(display.hd44780Sim.ddram[0x0E] == 'A' &&
+          display.hd44780Sim.ddram[0x0F] == 'B' &&
+          display.hd44780Sim.ddram[0x10] == ' ',
+          "clipped at the end of the row");
+    check(display.hd44780Sim.stats.dataWrites - dataWrites == 2,
+          "clipped characters not sent");
+                                        /* Wholly off the display             */
+    dataWrites = display.hd44780Sim.stats.dataWrites;
+    written = hd44780WriteAt(display.hHd44780, 2, 0, text, 6, 0);
+    check(written == 6, "row off the display dropped");
+    written = hd44780WriteAt(display.hHd44780, 1, 16, text, 6, 0);
+    check(written == 6, "column off the display dropped");
+    check(display.hd44780Sim.stats.dataWrites == dataWrites, "nothing sent");
+                                        /* Split 16x1 carries on across the   */
+                                        /* halves                             */
+    check(hd44780AttachGeometry(display.hHd44780, &hd44780Geometry16x1),
+          "hd44780AttachGeometry");
+    writeAt(0, 6, (const unsigned char *) "WXYZ", 4);
+    check(display.hd44780Sim.ddram[0x06] == 'W' &&
+          display.hd44780Sim.ddram[0x07] == 'X' &&
+          display.hd44780Sim.ddram[0x40] == 'Y' &&
+          display.hd44780Sim.ddram[0x41] == 'Z',
+          "split 16x1 written across the halves");
+                                        /* Cursor by position                 */
+    check(hd44780AttachGeometry(display.hHd44780, &hd44780Geometry20x4),
+          "hd44780AttachGeometry");
+    check(hd44780SetCursorPos(display.hHd44780, 4, 0) == 0,
+          "row off the display");
+    check(hd44780SetCursorPos(display.hHd44780, 0, 20) == 0,
+          "column off the display");
+    while (!hd44780SetCursorPos(display.hHd44780, 3, 5))
+    {
+    }
+    while (!hd44780WriteChar(display.hHd44780, '*'))
+    {
+    }
+    check(display.hd44780Sim.ddram[0x54 + 5] == '*', "hd44780SetCursorPos");
+}
+
+/*******************************************************************************
+* writeAt()
+*
+* Description:
+*   Calls hd44780WriteAt() until the write is complete
+*
+* See also:
+*
+* Arguments:
+*   row                 - row to write to
+*   column              - column of the first character
+*   characters          - characters to write
+*   length              - number of characters to write
+*
+* Returns:
+*   Number of calls made
+*
+* Callers: testGeometry(), testClipping()
+*
+* Notes :
+*
+*******************************************************************************/
+static unsigned int writeAt(unsigned char row, unsigned char column,
+                            const unsigned char * characters,
+                            unsigned char length)
+{
+    unsigned char       written = 0;
+    unsigned int        calls = 0;
+
+    while (written != length && calls < MAXCALLS)
+    {
+        written = hd44780WriteAt(display.hHd44780, row, column, characters,
+                                 length, written);
+        calls++;
+    }
+    check(written == length, "hd44780WriteAt complete");
+
+    return calls;
+}
+
+
+/*******************************************************************************
+*
+*                HD44780 MODULE GEOMETRY HOST TEST PROGRAM END
+*
+*******************************************************************************/
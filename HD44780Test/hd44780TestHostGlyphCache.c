@@ -0,0 +1,764 @@
+/*******************************************************************************
+*
+* HD44780 MODULE GLYPH CACHE HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module on a host PC against a simulated display and sends
+* it frames using a table of 32 custom glyphs through a glyph cache attached
+* with hd44780AttachGlyphCache(), polling the busy flag, in timed mode and
+* from hd44780Tick(). After every frame the program checks that each cell
+* shows the right character or glyph, that no glyph was loaded that did not
+* need to be and that the display was never written while busy. Pinned
+* glyphs and frames using more glyphs than CGRAM holds are checked too, as
+* are the characters chosen for new glyphs and reloading after
+* hd44780WriteCGRAMBlock().
+* Finally an animation is sent with the cache kept, and again with every glyph
+* loaded for every frame, and the time each took is reported.
+*
+* Filename : hd44780TestHostGlyphCache.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostGlyphCache.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostGlyphCache
+*   ./hd44780TestHostGlyphCache
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                  HD44780 MODULE GLYPH CACHE HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFGLYPHS      32
+#define NUMBEROFMODES       3
+                                        /* Animation: a window of glyphs      */
+                                        /* sliding one place per frame        */
+#define ANIMATIONFRAMES     40
+#define ANIMATIONWINDOW     6
+#define ANIMATIONGLYPHS     16
+                                        /* Period of hd44780Tick() in us      */
+#define TICKPERIOD          50
+#define QUEUESIZE           4
+                                        /* First frame cell of the second     */
+                                        /* line                               */
+#define LINE2CELL           40
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMODE
+* Description:
+*   How the frames are sent to the display
+*******************************************************************************/
+typedef struct TESTMODETYPE {
+    const char                    * name;
+    unsigned char                   timed;
+    unsigned char                   ticked;
+} TESTMODE;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTMODE testModes[NUMBEROFMODES] = {
+    { "busy flag",  0, 0 },
+    { "timed",      1, 0 },
+    { "hd44780Tick, busy flag", 0, 1 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static unsigned char        glyphs[NUMBEROFGLYPHS][CGRAMFONT_5X8];
+static LCDIFFP              lcdIfFuncPointers;
+static TESTDISPLAY          display;
+static unsigned char        shadowBuffer[HD44780_SHADOWSIZE];
+static HD44780GLYPHCACHE    glyphCache;
+static HD44780CMD           queue[QUEUESIZE];
+static HD44780CELL          frame[HD44780_SHADOWSIZE];
+static const TESTMODE     * currentMode;
+static unsigned long        maxWritesPerTick;
+static unsigned int         lastUploads;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void makeGlyphs(void);
+static void openDisplay(const TESTMODE * mode);
+static void closeDisplay(void);
+static void testMode(const TESTMODE * mode);
+static void testPinning(void);
+static void testEviction(void);
+static void testAnimation(void);
+static void makeFrame(const unsigned char * frameGlyphs, unsigned char count);
+static void commitFrame(void);
+static void checkFrame(unsigned int expectedUploads, unsigned char missing,
+                       const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+    makeGlyphs();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+
+    for (counter = 0; counter < NUMBEROFMODES; counter++)
+    {
+        testMode(&testModes[counter]);
+    }
+
+    return testResult();
+}
+
+/*******************************************************************************
+* makeGlyphs()
+*
+* Description:
+*   Fills the glyph table with 32 different glyphs. The top row of every glyph
+*   is blank, as in most real fonts
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void makeGlyphs(void)
+{
+    unsigned char       glyph;
+    unsigned char       row;
+
+    for (glyph = 0; glyph < NUMBEROFGLYPHS; glyph++)
+    {
+        glyphs[glyph][0] = 0x00;
+        for (row = 1; row < CGRAMFONT_5X8 - 1; row++)
+        {
+            glyphs[glyph][row] = (unsigned char) ((glyph * 7 + row * 11) ^
+                                                  (row << 2)) & 0x1F;
+        }
+        glyphs[glyph][CGRAMFONT_5X8 - 1] = glyph & 0x1F;
+    }
+}
+
+/*******************************************************************************
+* openDisplay()
+*
+* Description:
+*   Powers on and initialises the simulated display and attaches a shadow
+*   buffer, a glyph cache and, when ticked, a command queue
+*
+* See also:
+*
+* Arguments:
+*   mode                - how frames will be sent
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openDisplay(const TESTMODE * mode)
+{
+    testOpenDisplay(&display, HD44780U, BUS4BITSWIDE, &lcdIfFuncPointers,
+                    mode->timed);
+    testInitDisplay(&display);
+
+    check(hd44780AttachShadow(display.hHd44780, shadowBuffer),
+          "hd44780AttachShadow");
+    check(!hd44780AttachGlyphCache(display.hHd44780, &glyphCache,
+                                   (const unsigned char (*)[CGRAMFONT_5X8]) 0,
+                                   NUMBEROFGLYPHS),
+          "hd44780AttachGlyphCache needs a glyph table");
+    check(hd44780AttachGlyphCache(display.hHd44780, &glyphCache,
+                                  (const unsigned char (*)[CGRAMFONT_5X8])
+                                  glyphs, NUMBEROFGLYPHS),
+          "hd44780AttachGlyphCache");
+    lastUploads = 0;
+    if (mode->ticked)
+    {
+        check(hd44780AttachQueue(display.hHd44780, queue, QUEUESIZE,
+                                 (void (*)(HHD44780 const, HD44780SEQ)) 0),
+              "hd44780AttachQueue");
+    }
+}
+
+/*******************************************************************************
+* closeDisplay()
+*
+* Description:
+*   Closes and destroys the display's objects
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void closeDisplay(void)
+{
+    check(hd44780AttachGlyphCache(display.hHd44780, (HD44780GLYPHCACHE *) 0,
+                                  (const unsigned char (*)[CGRAMFONT_5X8]) 0,
+                                  0), "detach glyph cache");
+    testCloseDisplay(&display);
+}
+
+/*******************************************************************************
+* testMode()
+*
+* Description:
+*   Sends a series of frames in one mode, checking each
+*
+* See also:
+*
+* Arguments:
+*   mode                - how frames are sent
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testMode(const TESTMODE * mode)
+{
+    static const unsigned char frameA[] = { 0, 1, 2, 3, 4, 0, 1, 2, 3, 4 };
+    static const unsigned char frameB[] = { 3, 4, 5, 6, 7, 8, 9, 10 };
+    static const unsigned char frameC[] = { 11, 12, 13, 14, 15, 16, 17, 18 };
+    static const unsigned char frameD[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+    static const unsigned char frameE[] = { 0, 8, 40 };
+    unsigned long       writes;
+
+    printf("\n%s\n", mode->name);
+    currentMode = mode;
+    maxWritesPerTick = 0;
+    openDisplay(mode);
+
+    makeFrame(frameA, sizeof(frameA));
+    commitFrame();
+    checkFrame(5, 0, "5 glyphs loaded");
+
+    writes = display.hd44780Sim.stats.instructions +
+             display.hd44780Sim.stats.dataWrites;
+    commitFrame();
+    checkFrame(0, 0, "same frame again");
+    check(display.hd44780Sim.stats.instructions +
+          display.hd44780Sim.stats.dataWrites == writes,
+          "nothing written for the same frame");
+
+    makeFrame(frameB, sizeof(frameB));
+    commitFrame();
+    checkFrame(6, 0, "2 glyphs kept, 6 loaded");
+
+    makeFrame(frameC, sizeof(frameC));
+    commitFrame();
+    checkFrame(8, 0, "8 new glyphs loaded");
+                                        /* Nine glyphs; one can't be shown    */
+    makeFrame(frameD, sizeof(frameD));
+    commitFrame();
+    checkFrame(8, 1, "9 glyphs, 8 loaded");
+                                        /* Glyph 8 was the one left out; 40   */
+                                        /* isn't in the table                 */
+    makeFrame(frameE, sizeof(frameE));
+    commitFrame();
+    checkFrame(1, 1, "unknown glyph");
+
+    testPinning();
+    testEviction();
+
+    if (mode->ticked)
+    {
+        printf("    at most %lu write(s) per tick\n", maxWritesPerTick);
+        check(maxWritesPerTick == 1, "one write per tick");
+    }
+    else
+    {
+        testAnimation();
+    }
+    check(display.hd44780Sim.stats.violations == 0, "no writes while busy");
+
+    closeDisplay();
+}
+
+/*******************************************************************************
+* testPinning()
+*
+* Description:
+*   Checks that a pinned glyph stays in CGRAM, is never put where it would
+*   change the display, and is released again
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testPinning(void)
+{
+    static const unsigned char frameF[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    static const unsigned char frameG[] = { 21, 22 };
+    static const unsigned char frameH[] = { 23, 24, 25, 26, 27, 28, 29, 30 };
+    static const unsigned char frameI[] = { 20 };
+    unsigned int        uploads;
+                                        /* Every character is on the display  */
+    makeFrame(frameF, sizeof(frameF));
+    commitFrame();
+    checkFrame(1, 0, "8 glyphs, 1 loaded");
+    check(!hd44780PinGlyph(display.hHd44780, 20, 1),
+          "no character free to pin");
+    check(!hd44780PinGlyph(display.hHd44780, NUMBEROFGLYPHS, 1),
+          "can't pin a glyph not in the table");
+
+    makeFrame(frameG, sizeof(frameG));
+    commitFrame();
+    checkFrame(2, 0, "2 glyphs loaded");
+                                        /* Loaded by the next frame           */
+    uploads = glyphCache.uploads;
+    check(hd44780PinGlyph(display.hHd44780, 20, 1), "hd44780PinGlyph");
+    check(glyphCache.uploads == uploads, "pinning doesn't touch the bus");
+    commitFrame();
+    checkFrame(1, 0, "pinned glyph loaded");
+                                        /* Only 7 characters are left         */
+    makeFrame(frameH, sizeof(frameH));
+    commitFrame();
+    checkFrame(7, 1, "8 glyphs beside a pinned one");
+
+    makeFrame(frameI, sizeof(frameI));
+    commitFrame();
+    checkFrame(0, 0, "pinned glyph still loaded");
+
+    check(hd44780PinGlyph(display.hHd44780, 20, 0), "release glyph");
+    makeFrame(frameF, sizeof(frameF));
+    commitFrame();
+    checkFrame(8, 0, "released glyph replaced");
+}
+
+/*******************************************************************************
+* testEviction()
+*
+* Description:
+*   Checks that a glyph is loaded into a character the display isn't showing
+*   while there is one, even if one it shows was used longer ago, and that
+*   characters written by hd44780WriteCGRAMBlock() are loaded again
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testEviction(void)
+{
+    static const unsigned char frameJ[] = { 0, 1, 2, 3 };
+    static const unsigned char frameK[] = { 8 };
+    static const unsigned char blank[CGRAMFONT_5X8] = { 0 };
+    unsigned char       glyph;
+    unsigned char       index;
+    unsigned char       shownCodes = 0;
+    unsigned char       written;
+
+    check(hd44780AttachGlyphCache(display.hHd44780, &glyphCache,
+                                  (const unsigned char (*)[CGRAMFONT_5X8])
+                                  glyphs, NUMBEROFGLYPHS),
+          "hd44780AttachGlyphCache");
+    lastUploads = 0;
+                                        /* Glyphs 4 to 7 go in the characters */
+                                        /* used first, the frame's in the     */
+                                        /* others                             */
+    for (glyph = 4; glyph < 8; glyph++)
+    {
+        check(hd44780PinGlyph(display.hHd44780, glyph, 1), "hd44780PinGlyph");
+    }
+    makeFrame(frameJ, sizeof(frameJ));
+    commitFrame();
+    checkFrame(8, 0, "4 glyphs and 4 pinned ones loaded");
+    for (index = 0; index < sizeof(frameJ); index++)
+    {
+        shownCodes |= 1 << display.hd44780Sim.ddram[8 + index];
+    }
+                                        /* Pinning again makes them more      */
+                                        /* recently used than those shown     */
+    for (glyph = 4; glyph < 8; glyph++)
+    {
+        check(hd44780PinGlyph(display.hHd44780, glyph, 1), "hd44780PinGlyph");
+        check(hd44780PinGlyph(display.hHd44780, glyph, 0), "release glyph");
+    }
+
+    makeFrame(frameK, sizeof(frameK));
+    commitFrame();
+    checkFrame(1, 0, "1 glyph loaded");
+    check(!(shownCodes & (1 << display.hd44780Sim.ddram[8])),
+          "glyph loaded into a character not on the display");
+                                        /* Overwrite glyph 0's character      */
+    frame[8] = HD44780_GLYPH(frameJ[0]);
+    for (index = 0; index < HD44780_GLYPHSLOTS; index++)
+    {
+        if (glyphCache.slotGlyph[index] == frameJ[0])
+        {
+            break;
+        }
+    }
+    check(index < HD44780_GLYPHSLOTS, "glyph 0 in CGRAM");
+    written = 0;
+    while (index < HD44780_GLYPHSLOTS && written != CGRAMFONT_5X8)
+    {
+        written = hd44780WriteCGRAMBlock(display.hHd44780, index, blank, 1,
+                                         CGRAMFONT_5X8, written);
+    }
+    makeFrame(frameJ, sizeof(frameJ));
+    commitFrame();
+    checkFrame(1, 0, "glyph loaded again after hd44780WriteCGRAMBlock()");
+}
+
+/*******************************************************************************
+* testAnimation()
+*
+* Description:
+*   Sends an animation with the glyph cache kept between frames, and again
+*   with it attached afresh before each frame so that every glyph is loaded
+*   every time, and reports how long each took
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testAnimation(void)
+{
+    unsigned char       frameNumber;
+    unsigned char       glyph;
+    unsigned char       counter;
+    unsigned char       reload;
+    unsigned int        uploads;
+    HD44780SIMTIME      startTime;
+    HD44780SIMTIME      elapsed[2];
+
+    for (reload = 0; reload < 2; reload++)
+    {
+        check(hd44780AttachGlyphCache(display.hHd44780, &glyphCache,
+                                      (const unsigned char (*)[CGRAMFONT_5X8])
+                                      glyphs, NUMBEROFGLYPHS),
+              "hd44780AttachGlyphCache");
+        lastUploads = 0;
+        uploads = 0;
+        startTime = hd44780simGetTime();
+        for (frameNumber = 0; frameNumber < ANIMATIONFRAMES; frameNumber++)
+        {
+            if (reload)
+            {
+                uploads += glyphCache.uploads;
+                hd44780AttachGlyphCache(display.hHd44780, &glyphCache,
+                                        (const unsigned char (*)
+                                        [CGRAMFONT_5X8]) glyphs,
+                                        NUMBEROFGLYPHS);
+                lastUploads = 0;
+            }
+                                        /* Each glyph has its own place, so   */
+                                        /* only two places change per frame   */
+            makeFrame((const unsigned char *) 0, 0);
+            for (counter = 0; counter < ANIMATIONWINDOW; counter++)
+            {
+                glyph = (frameNumber + counter) % ANIMATIONGLYPHS;
+                frame[8 + glyph] = HD44780_GLYPH(glyph);
+                frame[LINE2CELL + 2 * glyph] = HD44780_GLYPH(glyph);
+            }
+            commitFrame();
+            checkFrame(reload ? ANIMATIONWINDOW : (frameNumber ? 1 :
+                       ANIMATIONWINDOW), 0, "animation frame");
+        }
+        uploads += glyphCache.uploads;
+        elapsed[reload] = hd44780simGetTime() - startTime;
+        printf("    %d frames, %s: %u glyphs loaded in %llu us\n",
+               ANIMATIONFRAMES, reload ? "all glyphs loaded every frame" :
+               "glyph cache kept", uploads, elapsed[reload] / 1000);
+        check(uploads == (reload ? ANIMATIONFRAMES * ANIMATIONWINDOW :
+                          ANIMATIONFRAMES + ANIMATIONWINDOW - 1),
+              "glyphs loaded by the animation");
+    }
+    printf("    glyph cache took %.1f%% of the time\n",
+           100.0 * elapsed[0] / elapsed[1]);
+    check(elapsed[0] * 2 < elapsed[1], "glyph cache at least twice as fast");
+}
+
+/*******************************************************************************
+* makeFrame()
+*
+* Description:
+*   Builds a frame with a line of text and the given glyphs, each glyph shown
+*   in two places
+*
+* See also:
+*
+* Arguments:
+*   frameGlyphs         - glyphs to show
+*   count               - number of glyphs
+*
+* Returns:
+*   void
+*
+* Callers: testMode(), testPinning(), testEviction(), testAnimation()
+*
+* Notes :
+*
+*******************************************************************************/
+static void makeFrame(const unsigned char * frameGlyphs, unsigned char count)
+{
+    static const char text[] = "Glyphs:";
+    unsigned char       index;
+
+    for (index = 0; index < HD44780_SHADOWSIZE; index++)
+    {
+        frame[index] = ' ';
+    }
+    for (index = 0; text[index] != 0; index++)
+    {
+        frame[index] = (unsigned char) text[index];
+    }
+    for (index = 0; index < count; index++)
+    {
+        frame[8 + index] = HD44780_GLYPH(frameGlyphs[index]);
+        frame[LINE2CELL + 2 * index] =
+                                        HD44780_GLYPH(frameGlyphs[index]);
+    }
+}
+
+/*******************************************************************************
+* commitFrame()
+*
+* Description:
+*   Sends the frame in the current mode
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode(), testPinning(), testEviction(), testAnimation()
+*
+* Notes :
+*
+*******************************************************************************/
+static void commitFrame(void)
+{
+    HD44780SEQ          sequence;
+    unsigned long       writes;
+    unsigned long       ticks;
+
+    if (!currentMode->ticked)
+    {
+        while (!hd44780CommitGlyphFrame(display.hHd44780, frame))
+        {
+        }
+        return;
+    }
+
+    sequence = hd44780Enqueue(display.hHd44780, CMD_COMMITGLYPHFRAME, 0,
+                              (const unsigned char *) frame);
+    check(sequence != 0, "hd44780Enqueue");
+    for (ticks = 0;
+         !hd44780IsDone(display.hHd44780, sequence) && ticks < 100000;
+         ticks++)
+    {
+        writes = display.hd44780Sim.stats.instructions +
+                 display.hd44780Sim.stats.dataWrites;
+        hd44780Tick();
+        writes = display.hd44780Sim.stats.instructions +
+                 display.hd44780Sim.stats.dataWrites - writes;
+        if (writes > maxWritesPerTick)
+        {
+            maxWritesPerTick = writes;
+        }
+        hd44780simDelay(TICKPERIOD);
+    }
+}
+
+/*******************************************************************************
+* checkFrame()
+*
+* Description:
+*   Checks that the display shows the frame and that the expected number of
+*   glyphs were loaded since the last check
+*
+* See also:
+*
+* Arguments:
+*   expectedUploads     - glyphs that should have been loaded
+*   missing             - glyphs of the frame that can't be shown
+*   description         - what is being checked
+*
+* Returns:
+*   void
+*
+* Callers: testMode(), testPinning(), testEviction(), testAnimation()
+*
+* Notes :
+*
+*******************************************************************************/
+static void checkFrame(unsigned int expectedUploads, unsigned char missing,
+                       const char * description)
+{
+    unsigned char       index;
+    unsigned char       address;
+    unsigned char       code;
+    unsigned char       glyph;
+    unsigned char       wrong = 0;
+    unsigned int        missingGlyphs = 0;
+    unsigned char       missingMap[256 / 8];
+
+    memset(missingMap, 0, sizeof(missingMap));
+
+    for (index = 0; index < HD44780_SHADOWSIZE; index++)
+    {
+        address = index < LINE2CELL ? index :
+                                    0x40 + index - LINE2CELL;
+        code = display.hd44780Sim.ddram[address];
+        if (frame[index] <= 0xFF)
+        {
+            wrong |= (code != frame[index]);
+            continue;
+        }
+        glyph = (unsigned char) frame[index];
+        if (code == HD44780_GLYPHMISSING)
+        {
+            if (!(missingMap[glyph / 8] & (1 << (glyph % 8))))
+            {
+                missingMap[glyph / 8] |= 1 << (glyph % 8);
+                missingGlyphs++;
+            }
+            continue;
+        }
+        wrong |= (code >= HD44780_GLYPHSLOTS || glyph >= NUMBEROFGLYPHS ||
+                  memcmp(&display.hd44780Sim.cgram[code * CGRAMFONT_5X8],
+                         glyphs[glyph], CGRAMFONT_5X8) != 0);
+    }
+
+    if (wrong || missingGlyphs != missing ||
+        glyphCache.uploads - lastUploads != expectedUploads)
+    {
+        printf("    %s: %u glyph(s) loaded, %u missing%s\n", description,
+               glyphCache.uploads - lastUploads, missingGlyphs,
+               wrong ? ", display wrong" : "");
+    }
+    check(!wrong, description);
+    check(missingGlyphs == missing, "glyphs that can't be shown");
+    check(glyphCache.uploads - lastUploads == expectedUploads,
+          "glyphs loaded");
+    lastUploads = glyphCache.uploads;
+}
+
+
+/*******************************************************************************
+*
+*                 HD44780 MODULE GLYPH CACHE HOST TEST PROGRAM END
+*
+*******************************************************************************/
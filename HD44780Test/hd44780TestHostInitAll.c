@@ -0,0 +1,402 @@
+/*******************************************************************************
+*
+* HD44780 MODULE CONCURRENT INITIALISATION HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Initialises several simulated displays, each a different chipset, on a host
+* PC: first one after the other with hd44780InstructionInit(), as the demo
+* programs do, and then all together with hd44780InstructionInitAll(). The
+* program checks that the displays are left in the same state both ways,
+* that no display is written while busy or before it has powered up and that
+* initialising them together takes little longer than the slowest display
+* on its own. It reports how long each approach took.
+*
+* Filename : hd44780TestHostInitAll.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostInitAll.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostInitAll
+*   ./hd44780TestHostInitAll
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*           HD44780 MODULE CONCURRENT INITIALISATION HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFDISPLAYS    4
+                                        /* Initialising together may take     */
+                                        /* this fraction longer than the      */
+                                        /* slowest display alone, for the     */
+                                        /* others' bus cycles                 */
+#define MARGINDIVISOR       20
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTCONFIG
+* Description:
+*   Configuration of one simulated display
+*******************************************************************************/
+typedef struct TESTCONFIGTYPE {
+    const char                    * name;
+    HD44780CLONE                    clone;
+    unsigned char                   busWidth;
+    unsigned char                   timed;
+} TESTCONFIG;
+
+/*******************************************************************************
+* New data type INITDISPLAY
+* Description:
+*   One simulated display and the controller state it was left in by
+*   initialising it on its own
+*******************************************************************************/
+typedef struct INITDISPLAYTYPE {
+    const TESTCONFIG              * config;
+    TESTDISPLAY                     lcd;
+    HD44780SIM                      referenceSim;
+    HD44780SIMTIME                  initTime;
+} INITDISPLAY;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTCONFIG displayConfigs[NUMBEROFDISPLAYS] = {
+    { "HD44780U 4-bit busy flag", HD44780U, BUS4BITSWIDE, 0 },
+    { "ST7066U  8-bit timed",     ST7066U,  BUS8BITSWIDE, 1 },
+    { "KS0066U  8-bit busy flag", KS0066U,  BUS8BITSWIDE, 0 },
+    { "NT7603   4-bit timed",     NT7603,   BUS4BITSWIDE, 1 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static INITDISPLAY          displays[NUMBEROFDISPLAYS];
+static HD44780INIT          initTable[NUMBEROFDISPLAYS];
+static LCDIFFP              lcdIfFuncPointers;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void openDisplay(INITDISPLAY * display, const TESTCONFIG * config);
+static void powerOnDisplays(void);
+static HD44780SIMTIME testOneAfterAnother(void);
+static void testTogether(HD44780SIMTIME slowestTime,
+                         HD44780SIMTIME sequentialTime);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+    HD44780SIMTIME      sequentialTime;
+    HD44780SIMTIME      slowestTime;
+
+    testInit();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        openDisplay(&displays[counter], &displayConfigs[counter]);
+    }
+
+    sequentialTime = testOneAfterAnother();
+
+    slowestTime = 0;
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        if (displays[counter].initTime > slowestTime)
+        {
+            slowestTime = displays[counter].initTime;
+        }
+    }
+                                        /* Twice, to show the table is left   */
+                                        /* ready to be used again             */
+    testTogether(slowestTime, sequentialTime);
+    testTogether(slowestTime, sequentialTime);
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        testCloseDisplay(&displays[counter].lcd);
+    }
+
+    return testResult();
+}
+
+/*******************************************************************************
+* openDisplay()
+*
+* Description:
+*   Creates and opens one display and adds it to the table handed to
+*   hd44780InstructionInitAll()
+*
+* See also:
+*
+* Arguments:
+*   display             - display to open
+*   config              - its configuration
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openDisplay(INITDISPLAY * display, const TESTCONFIG * config)
+{
+    HD44780INIT       * init;
+
+    display->config = config;
+    testOpenDisplay(&display->lcd, config->clone, config->busWidth,
+                    &lcdIfFuncPointers, config->timed);
+
+    init = &initTable[display - displays];
+    init->hHd44780 = display->lcd.hHd44780;
+    init->hd44780Clone = config->clone;
+    init->functionSet = TESTFUNCTIONSET;
+    init->displayOnOffControl = TESTDISPLAYCONTROL;
+    init->entryModeSet = TESTENTRYMODE;
+    init->initDone = 0;
+    init->waitTime = 0;
+}
+
+/*******************************************************************************
+* powerOnDisplays()
+*
+* Description:
+*   Powers all the simulated controllers on at the current simulated time
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testOneAfterAnother(), testTogether()
+*
+* Notes :
+*
+*******************************************************************************/
+static void powerOnDisplays(void)
+{
+    unsigned char       counter;
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        hd44780simInit(&displays[counter].lcd.hd44780Sim,
+                       displays[counter].config->clone);
+    }
+}
+
+/*******************************************************************************
+* testOneAfterAnother()
+*
+* Description:
+*   Initialises each display in turn with hd44780InstructionInit(), noting
+*   how long each took and the state it was left in
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Time taken to initialise all the displays, in ns
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static HD44780SIMTIME testOneAfterAnother(void)
+{
+    INITDISPLAY       * display;
+    unsigned char       counter;
+    HD44780SIMTIME      startTime;
+    HD44780SIMTIME      displayStartTime;
+
+    printf("\nInitialising one after another\n");
+    powerOnDisplays();
+    startTime = hd44780simGetTime();
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        displayStartTime = hd44780simGetTime();
+        testInitDisplay(&display->lcd);
+
+        display->initTime = hd44780simGetTime() - displayStartTime;
+        display->referenceSim = display->lcd.hd44780Sim;
+        printf("    %s: %llu us\n", display->config->name,
+               display->initTime / 1000);
+        check(display->lcd.hd44780Sim.stats.violations == 0,
+              "no writes while busy");
+    }
+
+    printf("    all displays: %llu us\n",
+           (hd44780simGetTime() - startTime) / 1000);
+
+    return hd44780simGetTime() - startTime;
+}
+
+/*******************************************************************************
+* testTogether()
+*
+* Description:
+*   Initialises all the displays together with hd44780InstructionInitAll()
+*   and checks the result against initialising them one after another
+*
+* See also:
+*
+* Arguments:
+*   slowestTime         - longest time one display took on its own, in ns
+*   sequentialTime      - time all displays took one after another, in ns
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testTogether(HD44780SIMTIME slowestTime,
+                         HD44780SIMTIME sequentialTime)
+{
+    INITDISPLAY       * display;
+    unsigned char       counter;
+    unsigned int        returnValue;
+    unsigned long       calls;
+    unsigned long       waits;
+    HD44780SIMTIME      startTime;
+    HD44780SIMTIME      elapsed;
+
+    printf("\nInitialising together\n");
+    powerOnDisplays();
+    startTime = hd44780simGetTime();
+    calls = 0;
+    waits = 0;
+
+    do
+    {
+        returnValue = hd44780InstructionInitAll(initTable, NUMBEROFDISPLAYS);
+        calls++;
+        if (returnValue > 1)
+        {
+            hd44780simDelay(returnValue);
+            waits++;
+        }
+    }
+    while (returnValue != 0 && calls < 100000);
+
+    elapsed = hd44780simGetTime() - startTime;
+    printf("    all displays: %llu us in %lu calls, %lu of them followed by "
+           "a wait\n", elapsed / 1000, calls, waits);
+    printf("    %.1f%% of the time taken one after another, %.1f%% of the "
+           "slowest display's time\n", 100.0 * elapsed / sequentialTime,
+           100.0 * elapsed / slowestTime);
+
+    check(returnValue == 0, "initialisation completes");
+    check(elapsed <= slowestTime + slowestTime / MARGINDIVISOR,
+          "about as long as the slowest display");
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        check(display->lcd.hd44780Sim.stats.violations == 0,
+              "no writes while busy");
+        check(display->lcd.hd44780Sim.functionSet ==
+              display->referenceSim.functionSet &&
+              display->lcd.hd44780Sim.displayControl ==
+              display->referenceSim.displayControl &&
+              display->lcd.hd44780Sim.entryMode ==
+              display->referenceSim.entryMode &&
+              display->lcd.hd44780Sim.addressCounter ==
+              display->referenceSim.addressCounter &&
+              hd44780simIs4BitMode(&display->lcd.hd44780Sim) ==
+              hd44780simIs4BitMode(&display->referenceSim),
+              "same state as initialising on its own");
+        check(display->lcd.hd44780Sim.stats.instructions ==
+              display->referenceSim.stats.instructions,
+              "same instructions as initialising on its own");
+        check(!initTable[counter].initDone && !initTable[counter].waitTime,
+              "table left ready to be used again");
+    }
+}
+
+
+/*******************************************************************************
+*
+*       HD44780 MODULE CONCURRENT INITIALISATION HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,568 @@
+/*******************************************************************************
+*
+* HD44780 MODULE READBACK HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module on a host PC against a simulated display and reads
+* its RAM back, polling the busy flag and in timed mode. A frame is sent and
+* the whole screen is read back one character at a time with
+* hd44780ReadChar() and then with hd44780ReadScreen(), reporting the calls,
+* bus cycles and time each took. Part of a line is read with
+* hd44780ReadRAMBlock() and 5x8 and 5x10 characters are read back with
+* hd44780ReadCGRAM(). Finally the screen is read into a freshly attached
+* shadow buffer, as after a warm reset, and the program checks that the next
+* frame only sends what changed. The display must never be read or written
+* while busy.
+*
+* Filename : hd44780TestHostReadback.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostReadback.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostReadback
+*   ./hd44780TestHostReadback
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                   HD44780 MODULE READBACK HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFMODES       2
+#define CHARACTERS5X8       8
+#define CHARACTERS5X10      4
+                                        /* CGRAM bytes per 5x10 character     */
+#define CHARACTERSIZE5X10   16
+                                        /* First frame cell of the second     */
+                                        /* line                               */
+#define LINE2CELL           40
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMODE
+* Description:
+*   How the display is read
+*******************************************************************************/
+typedef struct TESTMODETYPE {
+    const char                    * name;
+    unsigned char                   timed;
+} TESTMODE;
+
+/*******************************************************************************
+* New data type TESTMEASUREMENT
+* Description:
+*   Calls, bus cycles and simulated time used by one way of reading the screen
+*******************************************************************************/
+typedef struct TESTMEASUREMENTTYPE {
+    unsigned long                   calls;
+    unsigned long                   busCycles;
+    HD44780SIMTIME                  startTime;
+    HD44780SIMTIME                  elapsed;
+} TESTMEASUREMENT;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTMODE testModes[NUMBEROFMODES] = {
+    { "busy flag",  0 },
+    { "timed",      1 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static unsigned char        frame[HD44780_SHADOWSIZE];
+static unsigned char        screen[HD44780_SHADOWSIZE];
+static unsigned char        shadowBuffer[HD44780_SHADOWSIZE];
+static unsigned char        font5x8[CHARACTERS5X8 * CGRAMFONT_5X8];
+static unsigned char        font5x10[CHARACTERS5X10 * CGRAMFONT_5X10];
+static unsigned char        readFont[CHARACTERS5X8 * CGRAMFONT_5X8];
+static LCDIFFP              lcdIfFuncPointers;
+static TESTDISPLAY          display;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void makeData(void);
+static void testMode(const TESTMODE * mode);
+static void testScreen(const TESTMODE * mode);
+static void testCGRAM(void);
+static void testShadow(void);
+static void commitFrame(void);
+static void startMeasurement(TESTMEASUREMENT * measurement);
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+    makeData();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+
+    for (counter = 0; counter < NUMBEROFMODES; counter++)
+    {
+        testMode(&testModes[counter]);
+    }
+
+    return testResult();
+}
+
+/*******************************************************************************
+* makeData()
+*
+* Description:
+*   Fills the frame with text on both lines and the font tables with
+*   characters that have blank top and bottom rows
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void makeData(void)
+{
+    unsigned char       index;
+
+    for (index = 0; index < HD44780_SHADOWSIZE; index++)
+    {
+        frame[index] = (unsigned char) ('!' + (index * 7) % 90);
+    }
+    for (index = 0; index < CHARACTERS5X8 * CGRAMFONT_5X8; index++)
+    {
+        font5x8[index] = (index % CGRAMFONT_5X8 == 0 ||
+                          index % CGRAMFONT_5X8 == CGRAMFONT_5X8 - 1) ? 0x00 :
+                         (unsigned char) ((index * 13) & 0x1F);
+    }
+    for (index = 0; index < CHARACTERS5X10 * CGRAMFONT_5X10; index++)
+    {
+        font5x10[index] = (index % CGRAMFONT_5X10 == 0 ||
+                           index % CGRAMFONT_5X10 == CGRAMFONT_5X10 - 1) ?
+                          0x00 : (unsigned char) ((index * 5 + 3) & 0x1F);
+    }
+}
+
+
+/*******************************************************************************
+* testMode()
+*
+* Description:
+*   Runs every readback test in one mode
+*
+* See also:
+*
+* Arguments:
+*   mode                - how the display is read
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testMode(const TESTMODE * mode)
+{
+    printf("\n%s\n", mode->name);
+    testOpenDisplay(&display, HD44780U, BUS4BITSWIDE, &lcdIfFuncPointers,
+                    mode->timed);
+    testInitDisplay(&display);
+
+    check(hd44780ReadScreen(display.hHd44780, (unsigned char *) 0, 0) == 0,
+          "no shadow buffer to read into");
+    check(hd44780AttachShadow(display.hHd44780, shadowBuffer),
+          "hd44780AttachShadow");
+    commitFrame();
+    check(memcmp(display.hd44780Sim.ddram, frame, LINE2CELL) == 0 &&
+          memcmp(&display.hd44780Sim.ddram[0x40], &frame[LINE2CELL],
+                 LINE2CELL) == 0,
+          "frame on the display");
+
+    testScreen(mode);
+    testCGRAM();
+    testShadow();
+
+    check(display.hd44780Sim.stats.violations == 0,
+          "no reads or writes while busy");
+
+    testCloseDisplay(&display);
+}
+
+/*******************************************************************************
+* testScreen()
+*
+* Description:
+*   Reads the screen back a character at a time and in one go, and reads part
+*   of the second line with hd44780ReadRAMBlock()
+*
+* See also:
+*
+* Arguments:
+*   mode                - how the display is read
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testScreen(const TESTMODE * mode)
+{
+    TESTMEASUREMENT     measurement;
+    unsigned long       busCycles[2];
+    unsigned long       instructions;
+    unsigned char       index;
+    unsigned char       read;
+                                        /* One character at a time            */
+    memset(screen, 0, sizeof(screen));
+    startMeasurement(&measurement);
+    for (index = 0; index < HD44780_SHADOWSIZE; index++)
+    {
+        if (index % LINE2CELL == 0)
+        {
+            do
+            {
+                measurement.calls++;
+            }
+            while (!hd44780SetCursorAddr(display.hHd44780,
+                                         index ? 0x40 : 0x00));
+        }
+        do
+        {
+            measurement.calls++;
+        }
+        while (!hd44780ReadChar(display.hHd44780, &screen[index]));
+    }
+    endMeasurement(&measurement, "hd44780ReadChar");
+    busCycles[0] = measurement.busCycles;
+    check(memcmp(screen, frame, sizeof(frame)) == 0,
+          "screen read a character at a time");
+                                        /* The whole screen                   */
+    memset(screen, 0, sizeof(screen));
+    instructions = display.hd44780Sim.stats.instructions;
+    startMeasurement(&measurement);
+    read = 0;
+    while (read != HD44780_SHADOWSIZE && measurement.calls < 10000)
+    {
+        read = hd44780ReadScreen(display.hHd44780, screen, read);
+        measurement.calls++;
+    }
+    endMeasurement(&measurement, "hd44780ReadScreen");
+    busCycles[1] = measurement.busCycles;
+    check(memcmp(screen, frame, sizeof(frame)) == 0, "hd44780ReadScreen");
+    check(display.hd44780Sim.stats.instructions - instructions == 2,
+          "DDRAM address set once per line");
+    check(busCycles[1] <= busCycles[0], "no extra bus cycles");
+    if (mode->timed)
+    {
+        check(measurement.calls == 1, "timed screen read in one call");
+    }
+                                        /* Part of line two from the current  */
+                                        /* address                            */
+    while (!hd44780SetCursorAddr(display.hHd44780, 0x40 + 5))
+    {
+    }
+    memset(screen, 0, sizeof(screen));
+    read = 0;
+    for (index = 0; read != 10 && index < 200; index++)
+    {
+        read = hd44780ReadRAMBlock(display.hHd44780, screen, 10, read);
+    }
+    check(memcmp(screen, &frame[LINE2CELL + 5], 10) == 0,
+          "hd44780ReadRAMBlock");
+}
+
+/*******************************************************************************
+* testCGRAM()
+*
+* Description:
+*   Uploads 5x8 and 5x10 characters and reads them back with
+*   hd44780ReadCGRAM()
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testCGRAM(void)
+{
+    unsigned char       done;
+    unsigned int        calls;
+    unsigned long       instructions;
+
+    check(hd44780ReadCGRAM(display.hHd44780, 0, readFont, 1, 7, 0) == 0,
+          "unknown font refused");
+    check(hd44780ReadCGRAM(display.hHd44780, 6, readFont, 3, CGRAMFONT_5X8,
+                           0) == 0, "9th 5x8 character refused");
+
+    for (done = 0, calls = 0; done != sizeof(font5x8) && calls < 10000;
+         calls++)
+    {
+        done = hd44780WriteCGRAMBlock(display.hHd44780, 0, font5x8,
+                                      CHARACTERS5X8, CGRAMFONT_5X8, done);
+    }
+    memset(readFont, 0xFF, sizeof(readFont));
+    instructions = display.hd44780Sim.stats.instructions;
+    for (done = 0, calls = 0; done != sizeof(font5x8) && calls < 10000;
+         calls++)
+    {
+        done = hd44780ReadCGRAM(display.hHd44780, 0, readFont, CHARACTERS5X8,
+                                CGRAMFONT_5X8, done);
+    }
+    check(memcmp(readFont, font5x8, sizeof(font5x8)) == 0,
+          "5x8 characters read back");
+    check(display.hd44780Sim.stats.instructions - instructions == 1,
+          "CGRAM address set once");
+                                        /* 5x10 characters start every 16     */
+                                        /* bytes                              */
+    for (done = 0, calls = 0; done != sizeof(font5x10) && calls < 10000;
+         calls++)
+    {
+        done = hd44780WriteCGRAMBlock(display.hHd44780, 0, font5x10,
+                                      CHARACTERS5X10, CGRAMFONT_5X10, done);
+    }
+    memset(readFont, 0xFF, sizeof(readFont));
+    instructions = display.hd44780Sim.stats.instructions;
+    for (done = 0, calls = 0; done != sizeof(font5x10) && calls < 10000;
+         calls++)
+    {
+        done = hd44780ReadCGRAM(display.hHd44780, 0, readFont, CHARACTERS5X10,
+                                CGRAMFONT_5X10, done);
+    }
+    check(memcmp(readFont, font5x10, sizeof(font5x10)) == 0,
+          "5x10 characters read back");
+    check(display.hd44780Sim.stats.instructions - instructions ==
+          CHARACTERS5X10, "CGRAM address set once per 5x10 character");
+}
+
+/*******************************************************************************
+* testShadow()
+*
+* Description:
+*   Attaches a new shadow buffer, as after a warm reset, fills it from the
+*   display and checks that the next frame only sends the changes
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testShadow(void)
+{
+    unsigned char       read;
+    unsigned int        calls;
+    unsigned long       dataWrites;
+
+    memset(shadowBuffer, 0, sizeof(shadowBuffer));
+    check(hd44780AttachShadow(display.hHd44780, shadowBuffer),
+          "hd44780AttachShadow");
+    for (read = 0, calls = 0; read != HD44780_SHADOWSIZE && calls < 10000;
+         calls++)
+    {
+        read = hd44780ReadScreen(display.hHd44780, (unsigned char *) 0, read);
+    }
+    check(memcmp(shadowBuffer, frame, sizeof(frame)) == 0,
+          "shadow buffer read from the display");
+
+    frame[3]++;
+    frame[LINE2CELL + 7]++;
+    dataWrites = display.hd44780Sim.stats.dataWrites;
+    commitFrame();
+    printf("    after reading the shadow back, %lu byte(s) sent for 2 "
+           "changes\n", display.hd44780Sim.stats.dataWrites - dataWrites);
+    check(display.hd44780Sim.stats.dataWrites - dataWrites == 2,
+          "only changes sent");
+    check(display.hd44780Sim.ddram[3] == frame[3] &&
+          display.hd44780Sim.ddram[0x40 + 7] == frame[LINE2CELL + 7],
+          "changes on the display");
+}
+
+/*******************************************************************************
+* commitFrame()
+*
+* Description:
+*   Sends the frame to the display
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: testMode(), testShadow()
+*
+* Notes :
+*
+*******************************************************************************/
+static void commitFrame(void)
+{
+    unsigned int        calls;
+
+    for (calls = 0;
+         !hd44780CommitFrame(display.hHd44780, frame) && calls < 10000;
+         calls++)
+    {
+    }
+}
+
+/*******************************************************************************
+* startMeasurement()
+*
+* Description:
+*   Notes the simulated time and bus cycles before a way of reading the screen
+*
+* See also:
+*
+* Arguments:
+*   measurement         - measurement to start
+*
+* Returns:
+*   void
+*
+* Callers: testScreen()
+*
+* Notes :
+*
+*******************************************************************************/
+static void startMeasurement(TESTMEASUREMENT * measurement)
+{
+    measurement->calls = 0;
+    measurement->busCycles = display.hd44780Sim.stats.writeCycles +
+                             display.hd44780Sim.stats.readCycles;
+    measurement->startTime = hd44780simGetTime();
+}
+
+/*******************************************************************************
+* endMeasurement()
+*
+* Description:
+*   Works out and prints what a way of reading the screen used
+*
+* See also:
+*
+* Arguments:
+*   measurement         - measurement started by startMeasurement()
+*   name                - what was measured
+*
+* Returns:
+*   void
+*
+* Callers: testScreen()
+*
+* Notes :
+*
+*******************************************************************************/
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name)
+{
+    measurement->busCycles = display.hd44780Sim.stats.writeCycles +
+                             display.hd44780Sim.stats.readCycles -
+                             measurement->busCycles;
+    measurement->elapsed = hd44780simGetTime() - measurement->startTime;
+    printf("    %-18s %5lu call(s) %5lu bus cycles %6llu us\n", name,
+           measurement->calls, measurement->busCycles,
+           measurement->elapsed / 1000);
+}
+
+
+/*******************************************************************************
+*
+*                HD44780 MODULE READBACK HOST TEST PROGRAM END
+*
+*******************************************************************************/
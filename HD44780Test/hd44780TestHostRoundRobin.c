@@ -0,0 +1,468 @@
+/*******************************************************************************
+*
+* HD44780 MODULE ROUND ROBIN HOST BENCHMARK PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Measures on a host PC how fast 1, 2, 4 and 8 simulated displays sharing one
+* bus can be written, first by servicing each display's queue in turn with
+* hd44780Service() and then by taking them round a write at a time with
+* hd44780ServiceAll(). Every bus cycle of every display moves the one
+* simulated clock on, so the displays share the bus just as several LCD
+* interfaces with their own E pins share one PBIFOBJ on the target. Both the
+* busy flag and timed mode are measured, all in 4-bit mode. The program
+* checks that the text arrives, that no display is written while busy and
+* that round robin throughput grows with the number of displays.
+*
+* Filename : hd44780TestHostRoundRobin.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostRoundRobin.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostRoundRobin
+*   ./hd44780TestHostRoundRobin
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*               HD44780 MODULE ROUND ROBIN HOST BENCHMARK PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define MAXDISPLAYS         8
+#define NUMBEROFCOUNTS      4
+#define QUEUESIZE           4
+#define TEXTLENGTH          32
+                                        /* Round robin over N displays must   */
+                                        /* reach at least this percentage of  */
+                                        /* N times one display's throughput   */
+#define MINSCALING          75
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type QUEUEDDISPLAY
+* Description:
+*   One simulated display and its command queue
+*******************************************************************************/
+typedef struct QUEUEDDISPLAYTYPE {
+    TESTDISPLAY                     lcd;
+    HD44780CMD                      queue[QUEUESIZE];
+} QUEUEDDISPLAY;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const unsigned char displayCounts[NUMBEROFCOUNTS] = { 1, 2, 4, 8 };
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char text[TEXTLENGTH + 1] =
+                                            "Round robin keeps the bus busy!!";
+static QUEUEDDISPLAY        displays[MAXDISPLAYS];
+static HD44780INIT          initTable[MAXDISPLAYS];
+static LCDIFFP              lcdIfFuncPointers;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void benchmark(unsigned char timed);
+static void openDisplays(unsigned char numberOfDisplays,
+                         unsigned char timed);
+static void closeDisplays(unsigned char numberOfDisplays);
+static void queueText(unsigned char numberOfDisplays);
+static double runInTurn(unsigned char numberOfDisplays);
+static double runRoundRobin(unsigned char numberOfDisplays);
+static void checkDisplays(unsigned char numberOfDisplays,
+                          const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+#if HD44780_MAXOBJECTS < MAXDISPLAYS || LCDIF_MAXOBJECTS < MAXDISPLAYS
+#error This test program needs room for MAXDISPLAYS objects
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    testInit();
+                                        /* Fill the LCD function pointers     */
+                                        /* struct                             */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+
+    benchmark(0);
+    benchmark(1);
+
+    return testResult();
+}
+
+/*******************************************************************************
+* benchmark()
+*
+* Description:
+*   Measures both ways of writing the displays for each number of displays
+*   and prints the aggregate throughputs
+*
+* See also:
+*
+* Arguments:
+*   timed               - non-zero to use timed mode, 0 to poll the busy flag
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void benchmark(unsigned char timed)
+{
+    unsigned char       count;
+    unsigned char       numberOfDisplays;
+    double              inTurn;
+    double              roundRobin;
+    double              single = 0.0;
+
+    printf("\n%s, 4-bit bus, %u characters per display\n",
+           timed ? "Timed mode" : "Busy flag", TEXTLENGTH);
+    printf("    displays  in turn (chars/s)  round robin (chars/s)  "
+           "speed up\n");
+
+    for (count = 0; count < NUMBEROFCOUNTS; count++)
+    {
+        numberOfDisplays = displayCounts[count];
+        openDisplays(numberOfDisplays, timed);
+
+        queueText(numberOfDisplays);
+        inTurn = runInTurn(numberOfDisplays);
+        checkDisplays(numberOfDisplays, "in turn");
+
+        queueText(numberOfDisplays);
+        roundRobin = runRoundRobin(numberOfDisplays);
+        checkDisplays(numberOfDisplays, "round robin");
+
+        printf("    %8u  %17.0f  %21.0f  %7.2fx\n", numberOfDisplays,
+               inTurn, roundRobin, roundRobin / inTurn);
+
+        if (numberOfDisplays == 1)
+        {
+            single = roundRobin;
+        }
+        check(roundRobin * 100 >= single * numberOfDisplays * MINSCALING,
+              "round robin throughput scales with the number of displays");
+
+        closeDisplays(numberOfDisplays);
+    }
+}
+
+/*******************************************************************************
+* openDisplays()
+*
+* Description:
+*   Creates, opens and initialises the displays and gives each a queue
+*
+* See also:
+*
+* Arguments:
+*   numberOfDisplays    - number of displays to open
+*   timed               - non-zero to use timed mode
+*
+* Returns:
+*   void
+*
+* Callers: benchmark()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openDisplays(unsigned char numberOfDisplays, unsigned char timed)
+{
+    QUEUEDDISPLAY     * display;
+    unsigned char       counter;
+    unsigned int        returnValue;
+
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+        testOpenDisplay(&display->lcd, HD44780U, BUS4BITSWIDE,
+                        &lcdIfFuncPointers, timed);
+
+        initTable[counter].hHd44780 = display->lcd.hHd44780;
+        initTable[counter].hd44780Clone = HD44780U;
+        initTable[counter].functionSet = TESTFUNCTIONSET;
+        initTable[counter].displayOnOffControl = TESTDISPLAYCONTROL;
+        initTable[counter].entryModeSet = TESTENTRYMODE;
+        initTable[counter].initDone = 0;
+        initTable[counter].waitTime = 0;
+    }
+
+    do
+    {
+        returnValue = hd44780InstructionInitAll(initTable, numberOfDisplays);
+        if (returnValue > 1)
+        {
+            hd44780simDelay(returnValue);
+        }
+    }
+    while (returnValue != 0);
+
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+        check(hd44780AttachQueue(display->lcd.hHd44780, display->queue,
+                                 QUEUESIZE,
+                                 (void (*)(HHD44780 const, HD44780SEQ)) 0),
+              "hd44780AttachQueue");
+    }
+}
+
+/*******************************************************************************
+* closeDisplays()
+*
+* Description:
+*   Closes and destroys the displays so that the next run starts afresh
+*
+* See also:
+*
+* Arguments:
+*   numberOfDisplays    - number of displays open
+*
+* Returns:
+*   void
+*
+* Callers: benchmark()
+*
+* Notes :
+*
+*******************************************************************************/
+static void closeDisplays(unsigned char numberOfDisplays)
+{
+    QUEUEDDISPLAY     * display;
+    unsigned char       counter;
+
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+        check(display->lcd.hd44780Sim.stats.violations == 0,
+              "no writes while busy");
+        testCloseDisplay(&display->lcd);
+    }
+}
+
+/*******************************************************************************
+* queueText()
+*
+* Description:
+*   Blanks each display's DDRAM and queues the text to be written to it
+*
+* See also:
+*
+* Arguments:
+*   numberOfDisplays    - number of displays open
+*
+* Returns:
+*   void
+*
+* Callers: benchmark()
+*
+* Notes :
+* 1. The DDRAM is blanked in the simulator directly, so that only the text is
+*    timed
+*
+*******************************************************************************/
+static void queueText(unsigned char numberOfDisplays)
+{
+    QUEUEDDISPLAY     * display;
+    unsigned char       counter;
+
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+        memset(display->lcd.hd44780Sim.ddram, ' ',
+               sizeof(display->lcd.hd44780Sim.ddram));
+        check(hd44780Enqueue(display->lcd.hHd44780, CMD_SETCURSORADDR, 0x00,
+                             (const unsigned char *) 0) != 0 &&
+              hd44780Enqueue(display->lcd.hHd44780, CMD_WRITERAMSTRING, 0,
+                             text) != 0,
+              "hd44780Enqueue");
+    }
+}
+
+/*******************************************************************************
+* runInTurn()
+*
+* Description:
+*   Empties each display's queue with hd44780Service() before starting on the
+*   next
+*
+* See also:
+*
+* Arguments:
+*   numberOfDisplays    - number of displays open
+*
+* Returns:
+*   Aggregate throughput in characters per second
+*
+* Callers: benchmark()
+*
+* Notes :
+*
+*******************************************************************************/
+static double runInTurn(unsigned char numberOfDisplays)
+{
+    unsigned char       counter;
+    HD44780SIMTIME      startTime;
+
+    startTime = hd44780simGetTime();
+
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        while (!hd44780Service(displays[counter].lcd.hHd44780))
+        {
+            ;
+        }
+    }
+
+    return numberOfDisplays * TEXTLENGTH * 1e9 /
+           (hd44780simGetTime() - startTime);
+}
+
+/*******************************************************************************
+* runRoundRobin()
+*
+* Description:
+*   Empties all the displays' queues together with hd44780ServiceAll()
+*
+* See also:
+*
+* Arguments:
+*   numberOfDisplays    - number of displays open
+*
+* Returns:
+*   Aggregate throughput in characters per second
+*
+* Callers: benchmark()
+*
+* Notes :
+*
+*******************************************************************************/
+static double runRoundRobin(unsigned char numberOfDisplays)
+{
+    HD44780SIMTIME      startTime;
+
+    startTime = hd44780simGetTime();
+
+    while (!hd44780ServiceAll())
+    {
+        ;
+    }
+
+    return numberOfDisplays * TEXTLENGTH * 1e9 /
+           (hd44780simGetTime() - startTime);
+}
+
+/*******************************************************************************
+* checkDisplays()
+*
+* Description:
+*   Checks that the text arrived on every display and no queue has anything
+*   left in it
+*
+* See also:
+*
+* Arguments:
+*   numberOfDisplays    - number of displays open
+*   description         - the run being checked
+*
+* Returns:
+*   void
+*
+* Callers: benchmark()
+*
+* Notes :
+*
+*******************************************************************************/
+static void checkDisplays(unsigned char numberOfDisplays,
+                          const char * description)
+{
+    QUEUEDDISPLAY     * display;
+    unsigned char       counter;
+    char                failure[64];
+
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+        sprintf(failure, "%s, display %u", description, counter);
+        check(memcmp(display->lcd.hd44780Sim.ddram, text, TEXTLENGTH) == 0 &&
+              display->lcd.hd44780Obj.queueAdded ==
+              display->lcd.hd44780Obj.queueRemoved, failure);
+    }
+}
+
+
+/*******************************************************************************
+*
+*           HD44780 MODULE ROUND ROBIN HOST BENCHMARK PROGRAM END
+*
+*******************************************************************************/
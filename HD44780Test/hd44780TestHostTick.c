@@ -0,0 +1,624 @@
+/*******************************************************************************
+*
+* HD44780 MODULE BACKGROUND REFRESH HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the HD44780 module's background engine, hd44780Tick(), on a host PC
+* from a simulated periodic timer interrupt, driving two simulated displays:
+* one in timed mode on write-only wiring and one polling the busy flag. The
+* application only queues commands and is never made to wait for a display.
+* The program checks that each tick writes at most once to each display,
+* that no display is written while busy and that everything queued arrives,
+* including a stream of characters fed through a small queue while the timer
+* is running. It reports the worst case and average time spent in the
+* interrupt, in bus time, and the throughput each display achieved.
+*
+* Filename : hd44780TestHostTick.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc:
+*   gcc -DLCDIF_HOST_SIM
+*       -I../HD44780_module -I../lcdif_module -I../HD44780Sim
+*       hd44780TestHostTick.c hd44780TestHostCommon.c
+*       ../HD44780_module/HD44780.c
+*       ../lcdif_module/lcdif_host.c ../HD44780Sim/hd44780sim.c
+*       -o hd44780TestHostTick
+*   ./hd44780TestHostTick
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*               HD44780 MODULE BACKGROUND REFRESH HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "HD44780.h"
+#include "hd44780TestHostCommon.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFDISPLAYS    2
+#define QUEUESIZE           8
+#define STREAMQUEUESIZE     3
+                                        /* Timer interrupt period in ns; the  */
+                                        /* 37us to 39us an instruction takes, */
+                                        /* plus room for the tick's own time  */
+#define TICKPERIOD          50000ULL
+#define MAXTICKS            2000
+                                        /* Most bus cycles one tick may spend */
+                                        /* on one display: reading the busy   */
+                                        /* flag and writing one byte, both as */
+                                        /* two nibbles, and reading the time  */
+#define MAXCYCLESPERDISPLAY 6
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTCONFIG
+* Description:
+*   Configuration of one simulated display
+*******************************************************************************/
+typedef struct TESTCONFIGTYPE {
+    const char                    * name;
+    HD44780CLONE                    clone;
+    unsigned char                   busWidth;
+    unsigned char                   timed;
+} TESTCONFIG;
+
+/*******************************************************************************
+* New data type TICKDISPLAY
+* Description:
+*   One simulated display with the queue and shadow buffer it is refreshed
+*   from
+*******************************************************************************/
+typedef struct TICKDISPLAYTYPE {
+    const TESTCONFIG              * config;
+    TESTDISPLAY                     lcd;
+    HD44780CMD                      queue[QUEUESIZE];
+    unsigned char                   shadowBuffer[HD44780_SHADOWSIZE];
+    HD44780SEQ                      lastSequence;
+} TICKDISPLAY;
+
+/*******************************************************************************
+* New data type TICKSTATS
+* Description:
+*   What a run of timer ticks cost and achieved
+*******************************************************************************/
+typedef struct TICKSTATSTYPE {
+    unsigned long                   ticks;
+    HD44780SIMTIME                  startTime;
+    HD44780SIMTIME                  tickTime;
+    HD44780SIMTIME                  maxTickTime;
+    unsigned long                   maxWrites;
+} TICKSTATS;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTCONFIG displayConfigs[NUMBEROFDISPLAYS] = {
+    { "HD44780U 4-bit timed, write-only", HD44780U, BUS4BITSWIDE, 1 },
+    { "KS0066U  8-bit busy flag",         KS0066U,  BUS8BITSWIDE, 0 }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char lineOne[] = "Background ticks";
+static const unsigned char lineTwo[] = "never wait";
+static const unsigned char stream[] = "Fed through a queue of three";
+static const unsigned char character1[] = { 0x04, 0x0E, 0x1F, 0x0E,
+                                             0x04, 0x00, 0x00, 0x00,
+                                             0 };
+static TICKDISPLAY          displays[NUMBEROFDISPLAYS];
+static LCDIFFP              lcdIfFuncPointers;
+static LCDIFFP              writeOnlyFuncPointers;
+static unsigned char        frame[HD44780_SHADOWSIZE];
+static HD44780SIMTIME       nextTick;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void openDisplay(TICKDISPLAY * display, const TESTCONFIG * config);
+static void testQueuedCommands(void);
+static void testStream(void);
+static unsigned long runTicks(TICKSTATS * stats);
+static void timerInterrupt(TICKSTATS * stats);
+static unsigned long getWrites(TICKDISPLAY * display);
+static void printTickStats(TICKSTATS * stats, unsigned long bytes);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(LCDIF_HOST_SIM)
+#error This test program must be built with LCDIF_HOST_SIM defined
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testInit();
+                                        /* Fill the LCD function pointers     */
+                                        /* structs; with RW tied low nothing  */
+                                        /* can be read                        */
+    testFuncPointers(&lcdIfFuncPointers, 0);
+    testFuncPointers(&writeOnlyFuncPointers, 1);
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        openDisplay(&displays[counter], &displayConfigs[counter]);
+    }
+                                        /* Start the timer                    */
+    nextTick = hd44780simGetTime() + TICKPERIOD;
+
+    testQueuedCommands();
+    testStream();
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        check(displays[counter].lcd.hd44780Sim.stats.violations == 0,
+              "no writes while busy");
+        testCloseDisplay(&displays[counter].lcd);
+    }
+    check(writeOnlyReads == 0 &&
+          displays[0].lcd.hd44780Sim.stats.readCycles == 0,
+          "no reads on write-only wiring");
+
+    return testResult();
+}
+
+/*******************************************************************************
+* openDisplay()
+*
+* Description:
+*   Creates and opens one display, initialises it by instruction in the
+*   foreground and gives it a command queue and a shadow buffer
+*
+* See also:
+*
+* Arguments:
+*   display             - display to open
+*   config              - its configuration
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void openDisplay(TICKDISPLAY * display, const TESTCONFIG * config)
+{
+    printf("\nOpening %s\n", config->name);
+    display->config = config;
+    testOpenDisplay(&display->lcd, config->clone, config->busWidth,
+                    config->timed ? &writeOnlyFuncPointers :
+                                    &lcdIfFuncPointers,
+                    config->timed);
+    testInitDisplay(&display->lcd);
+
+    check(hd44780AttachQueue(display->lcd.hHd44780, display->queue, QUEUESIZE,
+                             (void (*)(HHD44780 const, HD44780SEQ)) 0),
+          "hd44780AttachQueue");
+    check(hd44780AttachShadow(display->lcd.hHd44780, display->shadowBuffer),
+          "hd44780AttachShadow");
+}
+
+/*******************************************************************************
+* testQueuedCommands()
+*
+* Description:
+*   Queues the same text, a CGRAM character and a frame on both displays and
+*   lets the timer carry them out
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testQueuedCommands(void)
+{
+    TICKDISPLAY       * display;
+    TICKSTATS           stats;
+    unsigned long       bytes;
+    unsigned long       busCycles;
+    unsigned char       counter;
+
+    printf("\nQueued text, CGRAM character and frame on both displays\n");
+                                        /* Queueing never touches the bus     */
+    busCycles = 0;
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        busCycles += displays[counter].lcd.hd44780Sim.stats.writeCycles +
+                     displays[counter].lcd.hd44780Sim.stats.readCycles;
+    }
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        hd44780Enqueue(display->lcd.hHd44780, CMD_CLEARDISPLAY, 0,
+                       (const unsigned char *) 0);
+        hd44780Enqueue(display->lcd.hHd44780, CMD_WRITERAMSTRING, 0, lineOne);
+        hd44780Enqueue(display->lcd.hHd44780, CMD_SETCURSORADDR, 0x40,
+                       (const unsigned char *) 0);
+        hd44780Enqueue(display->lcd.hHd44780, CMD_WRITERAMSTRING, 0, lineTwo);
+        hd44780Enqueue(display->lcd.hHd44780, CMD_SETCGRAMADDR, 0x08,
+                       (const unsigned char *) 0);
+        display->lastSequence = hd44780Enqueue(display->lcd.hHd44780,
+                                               CMD_WRITECGRAM, FS_5X8DOTS,
+                                               character1);
+        check(display->lastSequence != 0, "hd44780Enqueue");
+    }
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        busCycles -= displays[counter].lcd.hd44780Sim.stats.writeCycles +
+                     displays[counter].lcd.hd44780Sim.stats.readCycles;
+    }
+    check(busCycles == 0, "hd44780Enqueue doesn't touch the bus");
+
+    bytes = runTicks(&stats);
+    printTickStats(&stats, bytes);
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        check(hd44780IsDone(display->lcd.hHd44780, display->lastSequence),
+              "queued commands completed");
+        check(memcmp(&display->lcd.hd44780Sim.ddram[0x00], lineOne, 16) == 0 &&
+              memcmp(&display->lcd.hd44780Sim.ddram[0x40], lineTwo, 10) == 0 &&
+              display->lcd.hd44780Sim.ddram[0x4A] == ' ',
+              "DDRAM after queued text");
+        check(memcmp(&display->lcd.hd44780Sim.cgram[0x08], character1, 8) == 0,
+              "CGRAM after queued character");
+    }
+                                        /* A frame is sent a cell per tick    */
+    printf("\nQueued frame on both displays\n");
+    for (counter = 0; counter < HD44780_SHADOWSIZE; counter++)
+    {
+        frame[counter] = 'a' + (counter % 26);
+    }
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        display->lastSequence = hd44780Enqueue(display->lcd.hHd44780,
+                                               CMD_COMMITFRAME, 0, frame);
+    }
+    bytes = runTicks(&stats);
+    printTickStats(&stats, bytes);
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        display = &displays[counter];
+        check(hd44780IsDone(display->lcd.hHd44780, display->lastSequence),
+              "frame completed");
+        check(memcmp(&display->lcd.hd44780Sim.ddram[0x00], &frame[0],
+                     40) == 0 &&
+              memcmp(&display->lcd.hd44780Sim.ddram[0x40], &frame[40],
+                     40) == 0,
+              "DDRAM after queued frame");
+    }
+}
+
+/*******************************************************************************
+* testStream()
+*
+* Description:
+*   Feeds a string to the first display one character at a time through a
+*   small queue, queueing each as soon as there is room between ticks
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+* 1. The queue wraps many times while the timer is emptying it, so its two
+*    counts are exercised from both sides
+*
+*******************************************************************************/
+static void testStream(void)
+{
+    static HD44780CMD   streamQueue[STREAMQUEUESIZE];
+    TICKDISPLAY       * display;
+    TICKSTATS           stats;
+    unsigned long       bytes;
+    HD44780SEQ          sequence;
+    unsigned char       index;
+    unsigned char       refused;
+
+    printf("\nCharacters fed through a queue of %u\n", STREAMQUEUESIZE);
+
+    display = &displays[0];
+    check(hd44780AttachQueue(display->lcd.hHd44780, streamQueue,
+                             STREAMQUEUESIZE,
+                             (void (*)(HHD44780 const, HD44780SEQ)) 0),
+          "hd44780AttachQueue");
+    display->lastSequence = hd44780Enqueue(display->lcd.hHd44780,
+                                           CMD_SETCURSORADDR, 0x00,
+                                           (const unsigned char *) 0);
+
+    stats.ticks = 0;
+    stats.startTime = hd44780simGetTime();
+    stats.tickTime = 0;
+    stats.maxTickTime = 0;
+    stats.maxWrites = 0;
+    bytes = getWrites(display);
+    index = 0;
+    refused = 0;
+    while (stats.ticks < MAXTICKS &&
+           (stream[index] != 0 ||
+            !hd44780IsDone(display->lcd.hHd44780, display->lastSequence)))
+    {
+        while (stream[index] != 0)
+        {
+            sequence = hd44780Enqueue(display->lcd.hHd44780, CMD_WRITECHAR,
+                                      stream[index],
+                                      (const unsigned char *) 0);
+            if (sequence == 0)
+            {
+                refused++;
+                break;
+            }
+            display->lastSequence = sequence;
+            index++;
+        }
+        timerInterrupt(&stats);
+    }
+    printTickStats(&stats, getWrites(display) - bytes);
+
+    check(refused != 0, "full queue refused characters");
+    check(memcmp(display->lcd.hd44780Sim.ddram, stream,
+                 sizeof(stream) - 1) == 0, "DDRAM after stream");
+}
+
+/*******************************************************************************
+* runTicks()
+*
+* Description:
+*   Lets the timer run until every display's last queued command is done
+*
+* See also:
+*
+* Arguments:
+*   stats               - where to collect the cost of the ticks
+*
+* Returns:
+*   Number of instructions and data bytes written to all displays
+*
+* Callers: testQueuedCommands()
+*
+* Notes :
+*
+*******************************************************************************/
+static unsigned long runTicks(TICKSTATS * stats)
+{
+    unsigned long       bytes = 0;
+    unsigned char       counter;
+    unsigned char       done;
+
+    stats->ticks = 0;
+    stats->startTime = hd44780simGetTime();
+    stats->tickTime = 0;
+    stats->maxTickTime = 0;
+    stats->maxWrites = 0;
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        bytes -= getWrites(&displays[counter]);
+    }
+
+    do
+    {
+        timerInterrupt(stats);
+        done = 1;
+        for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+        {
+            if (!hd44780IsDone(displays[counter].lcd.hHd44780,
+                               displays[counter].lastSequence))
+            {
+                done = 0;
+            }
+        }
+    }
+    while (!done && stats->ticks < MAXTICKS);
+    check(done, "queues emptied");
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        bytes += getWrites(&displays[counter]);
+    }
+
+    return bytes;
+}
+
+/*******************************************************************************
+* timerInterrupt()
+*
+* Description:
+*   Simulates the application running until the next timer interrupt, then
+*   the interrupt itself calling hd44780Tick()
+*
+* See also:
+*
+* Arguments:
+*   stats               - where to collect the cost of the tick
+*
+* Returns:
+*   void
+*
+* Callers: runTicks(), testStream()
+*
+* Notes :
+* 1. If a tick overran the timer period the next one follows straight away
+*
+*******************************************************************************/
+static void timerInterrupt(TICKSTATS * stats)
+{
+    unsigned long       writes[NUMBEROFDISPLAYS];
+    HD44780SIMTIME      tickTime;
+    unsigned char       counter;
+
+    if (hd44780simGetTime() < nextTick)
+    {
+        hd44780simAdvance(nextTick - hd44780simGetTime());
+    }
+    nextTick += TICKPERIOD;
+
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        writes[counter] = getWrites(&displays[counter]);
+    }
+
+    tickTime = hd44780simGetTime();
+    hd44780Tick();
+    tickTime = hd44780simGetTime() - tickTime;
+
+    stats->ticks++;
+    stats->tickTime += tickTime;
+    if (tickTime > stats->maxTickTime)
+    {
+        stats->maxTickTime = tickTime;
+    }
+    for (counter = 0; counter < NUMBEROFDISPLAYS; counter++)
+    {
+        writes[counter] = getWrites(&displays[counter]) - writes[counter];
+        if (writes[counter] > stats->maxWrites)
+        {
+            stats->maxWrites = writes[counter];
+        }
+    }
+}
+
+/*******************************************************************************
+* getWrites()
+*
+* Description:
+*   Returns the number of instructions and data bytes written to a display
+*
+* See also:
+*
+* Arguments:
+*   display             - display to check
+*
+* Returns:
+*   Instructions plus data bytes written so far
+*
+* Callers: runTicks(), timerInterrupt(), testStream()
+*
+* Notes :
+*
+*******************************************************************************/
+static unsigned long getWrites(TICKDISPLAY * display)
+{
+    return display->lcd.hd44780Sim.stats.instructions +
+           display->lcd.hd44780Sim.stats.dataWrites;
+}
+
+/*******************************************************************************
+* printTickStats()
+*
+* Description:
+*   Prints the cost of a run of ticks and checks it against its limits
+*
+* See also:
+*
+* Arguments:
+*   stats               - cost of the ticks
+*   bytes               - number of instructions and data bytes written
+*
+* Returns:
+*   void
+*
+* Callers: testQueuedCommands(), testStream()
+*
+* Notes :
+*
+*******************************************************************************/
+static void printTickStats(TICKSTATS * stats, unsigned long bytes)
+{
+    HD44780SIMTIME      elapsed;
+
+    elapsed = hd44780simGetTime() - stats->startTime;
+
+    printf("    %lu ticks of %lluus, %lu bytes written in %llu us\n",
+           stats->ticks, TICKPERIOD / 1000, bytes, elapsed / 1000);
+    printf("    interrupt time: worst %llu ns, average %llu ns, "
+           "%.2f%% of the CPU\n", stats->maxTickTime,
+           stats->tickTime / stats->ticks,
+           100.0 * stats->tickTime / elapsed);
+    printf("    throughput %.0f bytes/s, at most %lu write(s) per display "
+           "per tick\n", bytes * 1e9 / elapsed, stats->maxWrites);
+
+    check(stats->maxWrites <= 1, "one write per display per tick");
+    check(stats->maxTickTime <= NUMBEROFDISPLAYS * MAXCYCLESPERDISPLAY *
+                                hd44780simGetCycleTime(),
+          "worst case interrupt time");
+    check(stats->maxTickTime < TICKPERIOD, "ticks never overrun");
+}
+
+
+/*******************************************************************************
+*
+*           HD44780 MODULE BACKGROUND REFRESH HOST TEST PROGRAM END
+*
+*******************************************************************************/
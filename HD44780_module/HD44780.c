@@ -48,20 +48,133 @@
 *   <link hd44780ReturnHome>, <link hd44780EntryModeSet>,
 *   <link hd44780DisplayControl>, <link hd44780ShiftControl>,
 *   <link hd44780FunctionSet>, <link hd44780SetCGRAMAddr>,
-*   <link hd44780SetCursorAddr>, <link hd44780ReadAddr>, <link hd44780WriteChar>,
-*   <link hd44780ReadChar>, <link hd44780WriteRAMString>,
-*   <link hd44780WriteCGRAM>, <link hd44780InstructionInit>
+*   <link hd44780SetCursorAddr>, <link hd44780SetCursorPos>,
+*   <link hd44780ReadAddr>, <link hd44780WriteChar>, <link hd44780ReadChar>,
+*   <link hd44780WriteRAMString>, <link hd44780WriteROMString>,
+*   <link hd44780WriteAt>, <link hd44780WriteCGRAM>,
+*   <link hd44780WriteCGRAMBlock>, <link hd44780ReadRAMBlock>,
+*   <link hd44780ReadCGRAM>, <link hd44780ReadScreen>,
+*   <link hd44780InstructionInit>,
+*   <link hd44780SetTimedMode>, <link hd44780SetBroadcastMode>,
+*   <link hd44780AttachQueue>, <link hd44780Enqueue>, <link hd44780Tick>,
+*   <link hd44780AttachGlyphCache>, <link hd44780PinGlyph>,
+*   <link hd44780CommitGlyphFrame>, <link hd44780AttachGeometry>,
+*   <link hd44780AttachVirtual>, <link hd44780CommitVirtualFrame>
 *******************************************************************************/
 #define HD44780_OPEN                (0x01 << 7)
 
 /*******************************************************************************
 * Summary:
-*   Used to mask the lower bits of the hd44780Flags element for use in the
-* instruction initialisation routine's state-machine
+*   Used to mask the lower bits of the hd44780Flags element, which hold the
+* step of its initialisation script that hd44780InstructionInit() carries out
+* next
 * See also:
 *   <link hd44780InstructionInit>
 *******************************************************************************/
-#define HD44780_INSTRINITSTATE      (0x07)
+#define HD44780_INSTRINITSTATE      (0x0F)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the shadow buffer holds what is on the display. It is
+* cleared by any write the module cannot track, so that the next frame is sent
+* in full
+* See also:
+*   <link hd44780AttachShadow>, <link hd44780CommitFrame>
+*******************************************************************************/
+#define HD44780_SHADOWVALID         (0x01 << 6)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that hd44780CommitFrame() stopped part way through a frame
+* after setting the DDRAM address itself, so the address counter position
+* noted in shadowCursor can be trusted when it is called again. Every other
+* instruction, data write or read clears it, as they move the address counter
+* See also:
+*   <link hd44780CommitFrame>
+*******************************************************************************/
+#define HD44780_SHADOWRESUME        (0x01 << 5)
+
+/*******************************************************************************
+* Summary:
+*   Used in timed mode to indicate that the last instruction or data written may
+* still be executing, i.e. that lastWriteTime and executionTime are valid
+* See also:
+*   <link hd44780SetTimedMode>
+*******************************************************************************/
+#define HD44780_TIMEDWAIT           (0x01 << 4)
+
+/*******************************************************************************
+* Summary:
+*   Number of cells in each line of a shadow buffer
+* See also:
+*   <link hd44780CommitFrame>
+*******************************************************************************/
+#define HD44780_SHADOWLINELENGTH    40
+
+/*******************************************************************************
+* Summary:
+*   Largest run of unchanged cells hd44780CommitFrame() writes again rather than
+* jumping over with a Set DDRAM Address instruction. One data write costs the
+* same bus time as one instruction, so bridging a single cell saves a jump for
+* free
+* See also:
+*   <link hd44780CommitFrame>
+*******************************************************************************/
+#define HD44780_SHADOWBRIDGE        1
+
+/*******************************************************************************
+* Summary:
+*   Used by hd44780CommitFrame() to note that the address counter position is
+* not known
+* See also:
+*   <link hd44780CommitFrame>
+*******************************************************************************/
+#define HD44780_SHADOWNOCURSOR      0xFF
+
+/*******************************************************************************
+* Summary:
+*   Marks a CGRAM character of a glyph cache that holds no glyph yet
+* See also:
+*   <link hd44780AttachGlyphCache>
+*******************************************************************************/
+#define HD44780_NOGLYPH             0xFF
+
+/*******************************************************************************
+* Summary:
+*   Set in the progress returned by hd44780WriteAt(), hd44780WriteCGRAMBlock(),
+* hd44780ReadCGRAM() and hd44780ReadScreen() when the RAM address is already
+* set for the next byte. No transfer is more than 80 bytes, so the bit is free
+* See also:
+*   <link hd44780WriteAt>, <link hd44780WriteCGRAMBlock>,
+*   <link hd44780ReadCGRAM>, <link hd44780ReadScreen>
+*******************************************************************************/
+#define HD44780_RAMADDRESSED        0x80
+
+/*******************************************************************************
+* Summary:
+*   Most columns a geometry may have, so that a row fits in DDRAM and progress
+* through it leaves HD44780_RAMADDRESSED free
+* See also:
+*   <link hd44780AttachGeometry>
+*******************************************************************************/
+#define HD44780_MAXCOLUMNS          80
+
+/*******************************************************************************
+* Summary:
+*   Number of rows of a virtual display driven by each of its controllers
+* See also:
+*   <link hd44780AttachVirtual>
+*******************************************************************************/
+#define HD44780_VIRTUALROWS         2
+
+/*******************************************************************************
+* Summary:
+*   Number of the most recent sequence numbers hd44780IsDone() takes as
+* issued; any further back are taken as not yet issued
+* See also:
+*   <link hd44780IsDone>
+*******************************************************************************/
+#define HD44780_SEQUENCEWINDOW      0x8000
 
 /*******************************************************************************
 * Summary:
@@ -141,6 +254,68 @@
 *******************************************************************************/
 #define HD44780_SETDDRAMADDRESS         0xFF
 
+/*******************************************************************************
+* Summary:
+*   Operations of an initialisation script step, held in the lower bits of its
+* operation member:
+* - INITOP_WAIT           - wait for the power supply to settle; first step only
+* - INITOP_NIBBLE         - single 4-bit Function Set write of value
+* - INITOP_FUNCTIONSET    - Function Set with the caller's settings, forced to
+*                           4-bit on a 4-bit bus
+* - INITOP_DISPLAYCONTROL - Display On/Off Control with the caller's settings
+*                           ANDed with value
+* - INITOP_CLEARDISPLAY   - Clear Display
+* - INITOP_ENTRYMODESET   - Entry Mode Set with the caller's settings
+* - INITOP_END            - initialisation complete
+* See also:
+*   <link hd44780InstructionInit>
+*******************************************************************************/
+#define INITOP_WAIT                 0
+#define INITOP_NIBBLE               1
+#define INITOP_FUNCTIONSET          2
+#define INITOP_DISPLAYCONTROL       3
+#define INITOP_CLEARDISPLAY         4
+#define INITOP_ENTRYMODESET         5
+#define INITOP_END                  6
+#define INITSTEP_OPERATION          0x07
+
+/*******************************************************************************
+* Summary:
+*   Flags of an initialisation script step, held in the upper bits of its
+* operation member. A step marked for one bus width is skipped on the other;
+* a step marked INITSTEP_WAITBUSY waits for the busy flag to clear first
+* See also:
+*   <link hd44780InstructionInit>
+*******************************************************************************/
+#define INITSTEP_WAITBUSY           (0x01 << 5)
+#define INITSTEP_BUS4               (0x01 << 6)
+#define INITSTEP_BUS8               (0x01 << 7)
+
+
+/*******************************************************************************
+* Summary:
+*   Number of bits in each word of the activeHD44780Objects bitmap. On PIC32
+* (and the host simulator) a free slot is found with the CLZ instruction on
+* 32-bit words; on PIC18 with a lookup table on 8-bit words
+* See also:
+*   <link hd44780Create>
+*******************************************************************************/
+#if defined(__PIC32MX__) || defined(LCDIF_HOST_SIM)
+#define HD44780_SLOTWORDBITS        32
+#else
+#define HD44780_SLOTWORDBITS        8
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Number of words in the activeHD44780Objects bitmap
+* See also:
+*   <link hd44780Create>
+*******************************************************************************/
+#define HD44780_SLOTWORDS           ((HD44780_MAXOBJECTS +                    \
+                                      HD44780_SLOTWORDBITS - 1) /             \
+                                     HD44780_SLOTWORDBITS)
+
 
 /*******************************************************************************
 *                                LOCAL CONSTANTS
@@ -154,37 +329,211 @@
 *******************************************************************************/
 
 /*******************************************************************************
-* New data type HD44780INSTRINITSTATE
+* New data type HD44780INITSTEP
 * Description:
-*   Holds a list of states to be stepped through when executing the instruction
-* initialisation routine
+*   One step of a chipset's instruction initialisation script. Members are:
+*   - operation     - INITOP_ operation ORed with INITSTEP_ flags
+*   - value         - nibble for INITOP_NIBBLE, mask for INITOP_DISPLAYCONTROL
+*   - delay         - microseconds to wait after the step; 1 to be called again
+*                     straight away, or 0 to carry on with the next step in
+*                     the same call
 *******************************************************************************/
-typedef enum HD44780INSTRINITSTATETYPE
-{
-                                        /* Step 0: Initialisation started     */
-    STARTINIT,
-                                        /* Step 1: Function set               */
-    FUNCTIONSET1,
-                                        /* Step 2: Function set (optional)    */
-    FUNCTIONSET2,
-                                        /* Step 3: Function set (optional)    */
-    FUNCTIONSET3,
-                                        /* Step 4: Function set (optional)    */
-    FUNCTIONSET4,                       
-                                        /* Step 5: Display on/off control     */
-    DISPLAYONOFFCONTROL,
-                                        /* Step 6: Display clear              */
-    DISPLAYCLEAR,
-                                        /* Step 7: Entry mode set             */
-    ENTRYMODESET
-} HD44780INSTRINITSTATE;
+typedef struct HD44780INITSTEPTYPE {
+    unsigned char           operation;
+    unsigned char           value;
+    unsigned int            delay;
+} HD44780INITSTEP;
+
+/*******************************************************************************
+* New data type HD44780SLOTWORD
+* Description:
+*   One word of the activeHD44780Objects bitmap
+*******************************************************************************/
+#if HD44780_SLOTWORDBITS == 32
+typedef unsigned int HD44780SLOTWORD;
+#else
+typedef unsigned char HD44780SLOTWORD;
+#endif
 
 
 /*******************************************************************************
 *                                  LOCAL TABLES
 *******************************************************************************/
 
-//<Add all locally created tables of data here>
+/*******************************************************************************
+* Summary:
+*   Instruction execution times in microseconds for each HD44780CLONE, as used
+* in timed mode. The first entry of each pair is for all instructions and data
+* reads and writes except 'Clear Display' and 'Return Home', which use the
+* second entry. These are the same times that hd44780InstructionInit() waits
+* for each chipset
+* See also:
+*   <link hd44780SetTimedMode>, <link hd44780SetBroadcastMode>
+*******************************************************************************/
+static const unsigned int hd44780ExecutionTimes[][2] = {
+                                        /* Hitachi HD44780U                   */
+    {   37, 1520 },
+                                        /* Sitronix ST7066U                   */
+    {   37, 1520 },
+                                        /* Samsung S6A0069                    */
+    {   39, 1530 },
+                                        /* Samsung KS0066U                    */
+    {   39, 1530 },
+                                        /* Novatek NT7603                     */
+    {   40, 1640 }
+};
+
+/*******************************************************************************
+* Summary:
+*   Instruction initialisation scripts of all the chipsets, each ending with
+* INITOP_END and no longer than 16 steps. These follow the "Initializing by
+* Instruction" flowcharts in each datasheet. The busy flag can't be read
+* before the last Function Set, and the Samsung and Novatek chipsets are
+* waited for throughout
+* See also:
+*   <link hd44780InstructionInit>
+*******************************************************************************/
+static const HD44780_ROM HD44780INITSTEP hd44780InitSteps[] = {
+                                        /* Hitachi HD44780U                   */
+    { INITOP_WAIT,                                      0,    15000 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x03, 4100 },
+    { INITOP_FUNCTIONSET | INITSTEP_BUS8,               0,    4100 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x03, 100 },
+    { INITOP_FUNCTIONSET | INITSTEP_BUS8,               0,    100 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x03, 0 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x02, 1 },
+    { INITOP_FUNCTIONSET | INITSTEP_BUS8,               0,    1 },
+    { INITOP_FUNCTIONSET,                               0,    1 },
+    { INITOP_DISPLAYCONTROL | INITSTEP_WAITBUSY,        DOFC_DISPLAYOFF &
+                                                        DOFC_CURSOROFF &
+                                                        DOFC_BLINKINGOFF, 1 },
+    { INITOP_CLEARDISPLAY | INITSTEP_WAITBUSY,          0,    1 },
+    { INITOP_ENTRYMODESET | INITSTEP_WAITBUSY,          0,    0 },
+    { INITOP_END,                                       0,    0 },
+                                        /* Sitronix ST7066U                   */
+    { INITOP_WAIT,                                      0,    40000 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x03, 37 },
+    { INITOP_FUNCTIONSET | INITSTEP_BUS8,               0,    37 },
+    { INITOP_FUNCTIONSET,                               0,    37 },
+    { INITOP_FUNCTIONSET | INITSTEP_BUS4,               0,    1 },
+    { INITOP_DISPLAYCONTROL | INITSTEP_WAITBUSY,        0xFF, 1 },
+    { INITOP_CLEARDISPLAY | INITSTEP_WAITBUSY,          0,    1 },
+    { INITOP_ENTRYMODESET | INITSTEP_WAITBUSY,          0,    0 },
+    { INITOP_END,                                       0,    0 },
+                                        /* Samsung S6A0069                    */
+    { INITOP_WAIT,                                      0,    40000 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x02, 0 },
+    { INITOP_FUNCTIONSET,                               0,    39 },
+    { INITOP_DISPLAYCONTROL,                            0xFF, 39 },
+    { INITOP_CLEARDISPLAY,                              0,    1530 },
+    { INITOP_ENTRYMODESET,                              0,    0 },
+    { INITOP_END,                                       0,    0 },
+                                        /* Samsung KS0066U                    */
+    { INITOP_WAIT,                                      0,    30000 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x02, 0 },
+    { INITOP_FUNCTIONSET,                               0,    39 },
+    { INITOP_DISPLAYCONTROL,                            0xFF, 39 },
+    { INITOP_CLEARDISPLAY,                              0,    1530 },
+    { INITOP_ENTRYMODESET,                              0,    0 },
+    { INITOP_END,                                       0,    0 },
+                                        /* Novatek NT7603                     */
+    { INITOP_WAIT,                                      0,    30000 },
+    { INITOP_NIBBLE | INITSTEP_BUS4,                    0x02, 0 },
+    { INITOP_FUNCTIONSET,                               0,    40 },
+    { INITOP_DISPLAYCONTROL,                            0xFF, 40 },
+    { INITOP_CLEARDISPLAY,                              0,    1640 },
+    { INITOP_ENTRYMODESET,                              0,    0 },
+    { INITOP_END,                                       0,    0 }
+};
+
+/*******************************************************************************
+* Summary:
+*   Step of hd44780InitSteps at which each HD44780CLONE's script starts
+* See also:
+*   <link hd44780InstructionInit>
+*******************************************************************************/
+static const HD44780_ROM unsigned char hd44780InitScripts[] = {
+                                        /* Hitachi HD44780U                   */
+    0,
+                                        /* Sitronix ST7066U                   */
+    13,
+                                        /* Samsung S6A0069                    */
+    22,
+                                        /* Samsung KS0066U                    */
+    29,
+                                        /* Novatek NT7603                     */
+    36
+};
+
+/*******************************************************************************
+* Summary:
+*   DDRAM address of each row, or of each half of the row of a split 16x1
+* display, as used by the hd44780Geometry descriptors
+* See also:
+*   <link hd44780AttachGeometry>
+*******************************************************************************/
+static const unsigned char hd44780RowAddresses1Line[] = {
+    0x00
+};
+static const unsigned char hd44780RowAddresses2Line[] = {
+    0x00, 0x40
+};
+static const unsigned char hd44780RowAddresses16x4[] = {
+    0x00, 0x40, 0x10, 0x50
+};
+static const unsigned char hd44780RowAddresses20x4[] = {
+    0x00, 0x40, 0x14, 0x54
+};
+
+#if HD44780_SLOTWORDBITS == 8
+/*******************************************************************************
+* Summary:
+*   Position of the lowest clear bit in each 4-bit value, or 4 if all bits are
+* set. Used to find a free slot in the activeHD44780Objects bitmap on PIC18
+* See also:
+*   <link hd44780Create>
+*******************************************************************************/
+static const unsigned char hd44780FirstZero[16] = {
+    0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0, 4
+};
+#endif
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Layouts of the common display sizes, as rows, columns, columns per segment
+* and the DDRAM address of each segment
+* See also:
+*   <link hd44780AttachGeometry>
+*******************************************************************************/
+const HD44780GEOMETRY hd44780Geometry8x1 =
+    { 1,  8,  8,  hd44780RowAddresses1Line };
+const HD44780GEOMETRY hd44780Geometry8x2 =
+    { 2,  8,  8,  hd44780RowAddresses2Line };
+const HD44780GEOMETRY hd44780Geometry16x1 =
+    { 1,  16, 8,  hd44780RowAddresses2Line };
+const HD44780GEOMETRY hd44780Geometry16x1Linear =
+    { 1,  16, 16, hd44780RowAddresses1Line };
+const HD44780GEOMETRY hd44780Geometry16x2 =
+    { 2,  16, 16, hd44780RowAddresses2Line };
+const HD44780GEOMETRY hd44780Geometry16x4 =
+    { 4,  16, 16, hd44780RowAddresses16x4 };
+const HD44780GEOMETRY hd44780Geometry20x1 =
+    { 1,  20, 20, hd44780RowAddresses1Line };
+const HD44780GEOMETRY hd44780Geometry20x2 =
+    { 2,  20, 20, hd44780RowAddresses2Line };
+const HD44780GEOMETRY hd44780Geometry20x4 =
+    { 4,  20, 20, hd44780RowAddresses20x4 };
+const HD44780GEOMETRY hd44780Geometry24x2 =
+    { 2,  24, 24, hd44780RowAddresses2Line };
+const HD44780GEOMETRY hd44780Geometry40x1 =
+    { 1,  40, 40, hd44780RowAddresses1Line };
+const HD44780GEOMETRY hd44780Geometry40x2 =
+    { 2,  40, 40, hd44780RowAddresses2Line };
 
 
 /*******************************************************************************
@@ -193,23 +542,57 @@ typedef enum HD44780INSTRINITSTATETYPE
 
 /*******************************************************************************
 * Summary:
-*   Local pointer to a linked list of HD44780 LCD objects
+*   Local table of HD44780 LCD objects, indexed by HD44780 number minus one
+*******************************************************************************/
+static HD44780OBJ * hd44780Slots[HD44780_MAXOBJECTS];
+
+/*******************************************************************************
+* Summary:
+*   Used to note which HD44780 objects are active. Each bit in this bitmap
+* relates to one slot of hd44780Slots.
 *******************************************************************************/
-static HD44780OBJ * startOfHD44780Objs;
+static HD44780SLOTWORD activeHD44780Objects[HD44780_SLOTWORDS];
 
 /*******************************************************************************
 * Summary:
-*   Used to note how many HD44780 objects are active. Each bit in this
-* variable relates to one active display object.
+*   Set while serviceHD44780Round() services the displays, so that the
+* functions it calls stop after one write to the bus
 *******************************************************************************/
-static unsigned int activeHD44780Objects;
+static unsigned char hd44780Ticking;
 
 
 /*******************************************************************************
 *#X#                          LOCAL FUNCTION PROTOTYPES
 *******************************************************************************/
 
+static unsigned int  findFreeHD44780Slot(void);
+static unsigned char serviceHD44780Round(void);
 static unsigned char isHD44780Busy(HHD44780 const hHd44780);
+static void writeHD44780Instr(HHD44780 const hHd44780, unsigned char instr);
+static void writeHD44780Data(HHD44780 const hHd44780, unsigned char data);
+static void writeHD44780DataBlock(HHD44780 const hHd44780,
+                                  const unsigned char * data,
+                                  unsigned char length);
+static unsigned char measureHD44780String(const unsigned char * string);
+static unsigned char locateHD44780Cell(const HD44780GEOMETRY * geometry,
+                                       unsigned char row,
+                                       unsigned char column);
+static unsigned char readHD44780Data(HHD44780 const hHd44780,
+                                     unsigned char * data);
+static unsigned char readHD44780DataBlock(HHD44780 const hHd44780,
+                                          unsigned char * data,
+                                          unsigned char length);
+static unsigned char mapHD44780Glyph(HD44780GLYPHCACHE * const glyphCache,
+                                     unsigned char glyph,
+                                     unsigned char keepSlots);
+static unsigned char uploadHD44780Glyphs(HHD44780 const hHd44780);
+static unsigned char readHD44780RAM(HHD44780 const hHd44780,
+                                    unsigned char * data,
+                                    unsigned char total,
+                                    unsigned char read,
+                                    unsigned char firstInstr,
+                                    unsigned char runLength,
+                                    unsigned char runStride);
 
 
 /*******************************************************************************
@@ -245,12 +628,19 @@ static unsigned char isHD44780Busy(HHD44780 const hHd44780);
 *******************************************************************************/
 void hd44780Init(void)
 {
-                                        /* Initialise the local pointer to    */
-                                        /* the list of HD44780 LCD objects    */
-    startOfHD44780Objs = (HD44780OBJ *) 0;
+    unsigned int slot;
+                                        /* Empty the HD44780 slot table       */
+    for (slot = 0; slot < HD44780_MAXOBJECTS; slot++)
+    {
+        hd44780Slots[slot] = (HD44780OBJ *) 0;
+    }
                                         /* Currently no active HD44780 LCD    */
                                         /* objects                            */
-    activeHD44780Objects = 0;
+    for (slot = 0; slot < HD44780_SLOTWORDS; slot++)
+    {
+        activeHD44780Objects[slot] = 0;
+    }
+    hd44780Ticking = 0;
 }
 
 /*******************************************************************************
@@ -276,12 +666,19 @@ void hd44780Init(void)
 *******************************************************************************/
 void hd44780Deinit(void)
 {
-                                        /* Initialise the local pointer to    */
-                                        /* the list of HD44780 LCD objects    */
-    startOfHD44780Objs = (HD44780OBJ *) 0;
+    unsigned int slot;
+                                        /* Empty the HD44780 slot table       */
+    for (slot = 0; slot < HD44780_MAXOBJECTS; slot++)
+    {
+        hd44780Slots[slot] = (HD44780OBJ *) 0;
+    }
                                         /* Currently no active HD44780 LCD    */
                                         /* objects                            */
-    activeHD44780Objects = 0;
+    for (slot = 0; slot < HD44780_SLOTWORDS; slot++)
+    {
+        activeHD44780Objects[slot] = 0;
+    }
+    hd44780Ticking = 0;
 }
 
 /*******************************************************************************
@@ -294,11 +691,14 @@ void hd44780Deinit(void)
 *   hd44780Destroy()
 *
 * Arguments: 
-*   hd44780Obj              - HD44780 object to insert in a list of HD44780 
-*                             objects 
+*   hLcdIf                  - handle to the LCD interface the HD44780 is
+*                             connected to
+*   lcdIfFunctionPointers   - functions implementing the LCD interface
+*   hd44780Obj              - HD44780 object to enter in the slot table
 *
 * Returns: 
-*   - 1 to MAX_HD44780IFS  	- number the LCD interface has been assigned if it 
+*   - 1 to HD44780_MAXOBJECTS 
+*                           - number the LCD interface has been assigned if it 
 *                             was possible to allocate it
 *   - 0		                - if the HD44780 LCD allocation failed
 *
@@ -306,18 +706,15 @@ void hd44780Deinit(void)
 *   Main application code
 *
 * Notes : 
-*   1. hd44780Create() must have been called prior to calling this function
+*   1. hd44780Init() must have been called prior to calling this function
+*   2. The number assigned is the object's slot in the slot table plus one,
+*      and is always the lowest one free
 *******************************************************************************/
 HD44780NUM hd44780Create(HLCDIF const           hLcdIf,
                          LCDIFFP * const        lcdIfFunctionPointers,
                          HD44780OBJ * const     hd44780Obj)
 {
-    HD44780OBJ * localHd44780Obj;       /* Stores local copy of pointer to    */
-                                        /* linked list so we can insert next  */
-                                        /* object in at the top               */
-    unsigned int  hd44780Number = 0x0001;      
-                                        /* Used to calculate the interface    */
-                                        /* number to return to caller         */
+    unsigned int slot;                  /* Slot allocated to this object      */
 
                                         /* Check we got an object to point to */
     if(hd44780Obj != (HD44780OBJ *) 0)
@@ -341,66 +738,46 @@ HD44780NUM hd44780Create(HLCDIF const           hLcdIf,
                                         /* If we got here we have             */
                                         /* valid data we can work with        */
 
-                                        /* If there are no active objects in  */
-                                        /* the list put this object at the    */
-                                        /* top                                */
-        if (activeHD44780Objects == 0 && startOfHD44780Objs == (HD44780OBJ *) 0)
+                                        /* Find a free slot, if we haven't    */
+                                        /* allocated all the HD44780 objects  */
+                                        /* we can support                     */
+        slot = findFreeHD44780Slot();
+        if (slot >= HD44780_MAXOBJECTS)
         {
-            startOfHD44780Objs = hd44780Obj;
-            startOfHD44780Objs->nextHD44780Obj = (HD44780OBJ *) 0;
-                                        /* Clear the object's flags           */
-            startOfHD44780Objs->hd44780Flags = 0;
-                                        /* Store the function pointers        */
-            startOfHD44780Objs->lcdIfFunctionPointers = lcdIfFunctionPointers;
-                                        /* Store the handle to the LCD        */
-                                        /* interface                          */
-            startOfHD44780Objs->hLcdIf = hLcdIf;
-                                        /* Assign the interface number        */
-            activeHD44780Objects |= hd44780Number;
-            startOfHD44780Objs->hd44780Num = hd44780Number;
-                                        /* Return the interface number        */
-            return startOfHD44780Objs->hd44780Num;
-        }
-                                        /* Otherwise, if we haven't allocated */
-                                        /* all the HD44780 objects we         */
-                                        /* can support, insert another        */
-        else if (activeHD44780Objects != 0xFFFF)
-        {
-                                        /* Insert this object at start of the */
-                                        /* list                               */
-            localHd44780Obj = startOfHD44780Objs;
-            startOfHD44780Objs = hd44780Obj;
-            startOfHD44780Objs->nextHD44780Obj = localHd44780Obj;
+            goto cannot_create_HD44780;
+        }
+        activeHD44780Objects[slot / HD44780_SLOTWORDBITS] |=
+                     (HD44780SLOTWORD) 1 << (slot % HD44780_SLOTWORDBITS);
+        hd44780Slots[slot] = hd44780Obj;
                                         /* Clear the object's flags           */
-            startOfHD44780Objs->hd44780Flags = 0;
+        hd44780Obj->hd44780Flags = 0;
+                                        /* No shadow buffer until one is      */
+                                        /* attached                           */
+        hd44780Obj->shadowBuffer = (unsigned char *) 0;
+                                        /* No glyph cache until one is        */
+                                        /* attached                           */
+        hd44780Obj->glyphCache = (HD44780GLYPHCACHE *) 0;
+                                        /* Rows and columns can't be used     */
+                                        /* until a geometry is attached       */
+        hd44780Obj->geometry = (HD44780GEOMETRY *) 0;
+                                        /* Poll the busy flag until timed     */
+                                        /* mode is selected                   */
+        hd44780Obj->pGetMicroseconds = (unsigned int (*)(void)) 0;
+                                        /* No command queue until one is      */
+                                        /* attached                           */
+        hd44780Obj->queue = (HD44780CMD *) 0;
+        hd44780Obj->queueAdded = 0;
+        hd44780Obj->queueRemoved = 0;
+        hd44780Obj->lastSequence = 0;
                                         /* Store the function pointers        */
-            startOfHD44780Objs->lcdIfFunctionPointers = lcdIfFunctionPointers;
+        hd44780Obj->lcdIfFunctionPointers = lcdIfFunctionPointers;
                                         /* Store the handle to the LCD        */
                                         /* interface                          */
-            startOfHD44780Objs->hLcdIf = hLcdIf;
-                                        /* Find a free LCD interface number   */
-                                        /* for this interface                 */
-                                        /* HD44780 Number '1' is assigned, so */
-                                        /* start looking from '2' for a free  */
-                                        /* number                             */
-            hd44780Number = 0x0002;
-            
-            do
-            {
-                if (!(activeHD44780Objects & hd44780Number))
-                {
-                                        /* Assign the interface number        */
-                    activeHD44780Objects |= hd44780Number;
-                    startOfHD44780Objs->hd44780Num = hd44780Number;
-                    return startOfHD44780Objs->hd44780Num;
-                }
-                                        /* That wasn't free; try next bit     */
-                hd44780Number <<= 1;
-                                        /* Mask just in case unsigned int is  */
-                                        /* bigger than 16-bits                */
-                hd44780Number &= 0xFFFF;
-            } while(hd44780Number != 0x0000);
-        }
+        hd44780Obj->hLcdIf = hLcdIf;
+                                        /* Assign the HD44780 number          */
+        hd44780Obj->hd44780Num = slot + 1;
+                                        /* Return the HD44780 number          */
+        return hd44780Obj->hd44780Num;
     }
 cannot_create_HD44780:
                                         /* Couldn't create interface          */
@@ -412,7 +789,7 @@ cannot_create_HD44780:
 *
 * Summary: 
 *   Destroys a previously created HD44780 object by removing it from the
-*   linked list. The HD44780 object must have already been closed, otherwise
+*   slot table. The HD44780 object must have already been closed, otherwise
 *   this call will fail.
 *
 * See also:
@@ -437,64 +814,22 @@ cannot_create_HD44780:
 *******************************************************************************/
 unsigned char hd44780Destroy(HD44780NUM hd44780Number)
 {
-    HD44780OBJ * localHd44780Obj;       /* Stores local copy of pointer to    */
-                                        /* linked list so we can insert next  */
-                                        /* object in at the top               */
-    HD44780OBJ * previousHd44780Obj;    /* Temporary object pointer so we can */
-                                        /* remove an object from the list     */
+    unsigned int slot;                  /* Slot holding the object            */
 
-                                        /* Check that there are created       */
-                                        /* objects                            */
-    if(startOfHD44780Objs != (HD44780OBJ *) 0)
-    {
-                                        /* Check if the first object in the   */
-                                        /* list is the one we are looking for */
-        if (startOfHD44780Objs->hd44780Num == hd44780Number)
-        {
-                                        /* Simply copy where this object is   */
-                                        /* pointing to into the               */
-                                        /* startOfHD44780Objs                 */
-            startOfHD44780Objs = startOfHD44780Objs->nextHD44780Obj;
-                                        /* Clear this object's bit in the     */
-                                        /* active HD44780 objects variable    */
-            activeHD44780Objects &= ~hd44780Number;
+                                        /* Check the number could have been   */
+                                        /* issued and that it is in use       */
+    if (hd44780Number != 0 && hd44780Number <= HD44780_MAXOBJECTS)
+    {
+        slot = hd44780Number - 1;
+        if (hd44780Slots[slot] != (HD44780OBJ *) 0)
+        {
+                                        /* Empty the slot and clear its bit   */
+                                        /* in the active HD44780 objects map  */
+            hd44780Slots[slot] = (HD44780OBJ *) 0;
+            activeHD44780Objects[slot / HD44780_SLOTWORDBITS] &=
+                     ~((HD44780SLOTWORD) 1 << (slot % HD44780_SLOTWORDBITS));
                                         /* Destroyed the desired object       */
             return HD44780_DESTROY_OK;
-        }
-                                        /* Otherwise loop through all the     */
-                                        /* objects until we find the right    */
-                                        /* one, if it is to be found at all   */
-        else if (startOfHD44780Objs->nextHD44780Obj != (HD44780OBJ *) 0)
-        {
-                                        /* Keep a copy of the pointer to this */
-                                        /* object                             */
-            previousHd44780Obj = startOfHD44780Objs;
-                                        /* Get next object in the list        */
-            localHd44780Obj = startOfHD44780Objs->nextHD44780Obj;
-                                        /* Loop through each item and check   */
-                                        /* until we find the one we are       */
-                                        /* searching for                      */
-            do
-            {
-                if (localHd44780Obj->hd44780Num == hd44780Number)
-                {
-                                        /* Remove this buffer from the list   */
-                    previousHd44780Obj->nextHD44780Obj =
-                                                localHd44780Obj->nextHD44780Obj;
-                                        /* Clear this object's bit in the     */
-                                        /* active HD44780 objects variable    */
-                    activeHD44780Objects &= ~hd44780Number;
-                                        /* Destroyed the desired object       */
-                    return HD44780_DESTROY_OK;
-                }
-                else
-                {
-                                        /* That wasn't the one we were        */
-                                        /* looking for. Move to the next one  */
-                    previousHd44780Obj = localHd44780Obj;
-                    localHd44780Obj = localHd44780Obj->nextHD44780Obj;
-                }
-            } while (localHd44780Obj != (HD44780OBJ *) 0);
         }
     }
                                         /* Couldn't destroy object            */
@@ -502,68 +837,49 @@ unsigned char hd44780Destroy(HD44780NUM hd44780Number)
 }
 
 /*******************************************************************************
-* lcdifOpen()
+* hd44780Open()
 *
 * Summary: 
-*   Opens an LCD interface for use by caller and initialises an HLCDIF
+*   Opens an HD44780 object for use by caller and returns an HHD44780
 *   handle to it
 *
 * See also:
-*   lcdifClose()
+*   hd44780Close()
 *
 * Arguments: 
-*   lcdIfNumber     - number of an existing LCD interface object to use
+*   hd44780Num      - number of an existing HD44780 object to use
 *
 * Returns: 
-*   - NULL	        - if LCD interface couldn't be opened
-*   - handle        - if LCD interface was opened properly
+*   - NULL	        - if HD44780 object couldn't be opened
+*   - handle        - if HD44780 object was opened properly
 *
 * Callers: 
 *   User application
 *
 * Notes : 
-* 1. Caller must have created (lcdifCreate) at least one LCD interface object 
+* 1. Caller must have created (hd44780Create) at least one HD44780 object 
 *    before calling this function
 *******************************************************************************/
 HHD44780 hd44780Open(HD44780NUM hd44780Num)
 {
-	HD44780OBJ * localHD44780Obj;       /* Stores local copy of pointer to    */
-                                        /* linked list so we can insert next  */
-                                        /* object in at the top               */
+	HD44780OBJ * localHD44780Obj;       /* Object in the requested slot       */
 	
-                                        /* Check that there are created       */
-                                        /* objects                            */
-    if(startOfHD44780Objs != (HD44780OBJ *) 0)
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (hd44780Num != 0 && hd44780Num <= HD44780_MAXOBJECTS)
     {
-                                        /* Check that a LCDIFNUM object       */
-                                        /* exists with lcdIfNumber            */
-
-        localHD44780Obj = startOfHD44780Objs;
+        localHD44780Obj = hd44780Slots[hd44780Num - 1];
         
-        do
+                                        /* Check an object is in the slot and */
+        	                            /* that it is not already open        */
+        if (localHD44780Obj != (HD44780OBJ *) 0 &&
+            !(localHD44780Obj->hd44780Flags & HD44780_OPEN))
         {
-    	    if (localHD44780Obj->hd44780Num == hd44780Num)
-    	    {
-        	                            /* Check LCD is not already open      */
-                if (!(localHD44780Obj->hd44780Flags & HD44780_OPEN))
-                {
                                         /* Note that it is now in use         */
-                    localHD44780Obj->hd44780Flags |= HD44780_OPEN;
+            localHD44780Obj->hd44780Flags |= HD44780_OPEN;
         	                            /* Return handle to it                */
-        	        return localHD44780Obj;
-        	    }
-        	                            /* If buffer is already open, return  */
-        	                            /* NULL handle pointer                */
-        	    else
-        	    {
-            	    return (HD44780OBJ *) 0;
-            	}    
-        	}    
-        	else
-        	{
-            	localHD44780Obj = localHD44780Obj->nextHD44780Obj;
-            }   	
-    	} while (localHD44780Obj != (HD44780OBJ *) 0);
+            return localHD44780Obj;
+        }
     }
     	                                /* Return handle to NULL otherwise    */
     return (HD44780OBJ *) 0;
@@ -595,29 +911,20 @@ HHD44780 hd44780Open(HD44780NUM hd44780Num)
 *******************************************************************************/
 HD44780NUM hd44780Close(HHD44780 const hHd44780)
 {
-                                        /* Check that there are created       */
-                                        /* objects                            */
-    if(startOfHD44780Objs != (HD44780OBJ *) 0)
-    {
     	                                /* Check LCD interface is actually    */
     	                                /* open                               */
-        if (hHd44780->hd44780Flags & HD44780_OPEN)
-        {
+    if (hHd44780->hd44780Flags & HD44780_OPEN)
+    {
         	                            /* Note that this LCD interface       */
         	                            /* object is closed                   */
-            hHd44780->hd44780Flags &= ~HD44780_OPEN;
+        hHd44780->hd44780Flags &= ~HD44780_OPEN;
                                         /* Return LCD interface object's      */
                                         /* interface number                   */
-            return hHd44780->hd44780Num;
-        }
+        return hHd44780->hd44780Num;
+    }
                                         /* Otherwise return 0 to say that     */
                                         /* buffer object wasn't open          */
-        else
-        {
-            return (HD44780NUM) 0;
-        }
-    }
-    return 0;
+    return (HD44780NUM) 0;
 }
 
 /*******************************************************************************
@@ -647,6 +954,7 @@ HD44780NUM hd44780Close(HHD44780 const hHd44780)
 unsigned char hd44780ClearDisplay(HHD44780 const hHd44780)
 {
     unsigned char returnValue = 0;
+    unsigned char counter;
                                         /* Check LCD interface is actually    */
     	                                /* open                               */
     if (hHd44780->hd44780Flags & HD44780_OPEN)
@@ -657,8 +965,16 @@ unsigned char hd44780ClearDisplay(HHD44780 const hHd44780)
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                                                          HD44780_CLEARDISPLAY);
+                writeHD44780Instr(hHd44780, HD44780_CLEARDISPLAY);
+                                        /* The display now holds only spaces  */
+                if (hHd44780->shadowBuffer != (unsigned char *) 0)
+                {
+                    for (counter = 0; counter < HD44780_SHADOWSIZE; counter++)
+                    {
+                        hHd44780->shadowBuffer[counter] = ' ';
+                    }
+                    hHd44780->hd44780Flags |= HD44780_SHADOWVALID;
+                }
                 returnValue = 1;
             }
                                         /* Return the bus                     */
@@ -706,8 +1022,7 @@ unsigned char hd44780ReturnHome(HHD44780 const hHd44780)
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                                                            HD44780_RETURNHOME);
+                writeHD44780Instr(hHd44780, HD44780_RETURNHOME);
                                         /* Return the bus                     */
                 hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
                 returnValue = 1;
@@ -759,8 +1074,7 @@ unsigned char hd44780EntryModeSet(HHD44780 const     hHd44780,
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                                              HD44780_ENTRYMODESET & entryMode);
+                writeHD44780Instr(hHd44780, HD44780_ENTRYMODESET & entryMode);
                                         
                 returnValue = 1;
             }
@@ -811,8 +1125,9 @@ unsigned char hd44780DisplayControl(HHD44780 const   hHd44780,
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                             HD44780_DISPLAYONOFFCONTROL & displayOnOffControl);
+                writeHD44780Instr(hHd44780,
+                                  HD44780_DISPLAYONOFFCONTROL &
+                                  displayOnOffControl);
                                         
                 returnValue = 1;
             }
@@ -863,8 +1178,8 @@ unsigned char hd44780ShiftControl(HHD44780 const hHd44780,
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                             HD44780_CURSORORDISPLAYSHIFT & shiftControl);
+                writeHD44780Instr(hHd44780,
+                                  HD44780_CURSORORDISPLAYSHIFT & shiftControl);
                                         
                 returnValue = 1;
             }
@@ -915,8 +1230,7 @@ unsigned char hd44780FunctionSet(HHD44780 const hHd44780,
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                             HD44780_FUNCTIONSET & functionSet);
+                writeHD44780Instr(hHd44780, HD44780_FUNCTIONSET & functionSet);
                                         
                 returnValue = 1;
             }
@@ -979,8 +1293,7 @@ unsigned char hd44780SetCGRAMAddr(HHD44780 const hHd44780,
                                         /* Set 6th bit of address, otherwise  */
                                         /* the commands 6th bit gets cleared  */
                 address = address | 0x40;
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                             HD44780_SETCGRAMADDRESS & address);
+                writeHD44780Instr(hHd44780, HD44780_SETCGRAMADDRESS & address);
                                         
                 returnValue = 1;
             }
@@ -1000,7 +1313,7 @@ unsigned char hd44780SetCGRAMAddr(HHD44780 const hHd44780,
 *   the LCD; also known as setting the Display Data RAM (DDRAM) address
 *
 * See also:
-*   
+*   hd44780SetCursorPos()
 *
 * Arguments: 
 *   hHd44780            - handle to the open HD44780
@@ -1038,8 +1351,7 @@ unsigned char hd44780SetCursorAddr(HHD44780 const hHd44780,
                                         /* Set MSb of address, otherwise the  */
                                         /* commands MSb gets cleared          */
                 address = address | 0x80;
-                hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf,
-                             HD44780_SETDDRAMADDRESS & address);
+                writeHD44780Instr(hHd44780, HD44780_SETDDRAMADDRESS & address);
                                         
                 returnValue = 1;
             }
@@ -1051,6 +1363,54 @@ unsigned char hd44780SetCursorAddr(HHD44780 const hHd44780,
     return returnValue;    
 }
 
+/*******************************************************************************
+* hd44780SetCursorPos()
+*
+* Summary: 
+*   Moves the cursor to a row and column of the display, looking the DDRAM
+*   address up in the attached geometry
+*
+* See also:
+*   hd44780SetCursorAddr(), hd44780AttachGeometry(), hd44780WriteAt()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   row                 - row to move to, starting from 0 at the top
+*   column              - column to move to, starting from 0 on the left
+*
+* Returns: 
+*   - 1  	        - command was completed successfully
+*   - 0             - command couldn't complete (most likely bus busy), no
+*                     geometry is attached or the position is off the display
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one HD44780 object before
+*    calling this function
+* 2. On a split 16x1 display the address counter doesn't carry on from the
+*    first half into the second, so writing across column 8 needs another
+*    call; hd44780WriteAt() does this itself
+*
+*******************************************************************************/
+unsigned char hd44780SetCursorPos(HHD44780 const hHd44780,
+                                  unsigned char row,
+                                  unsigned char column)
+{
+    const HD44780GEOMETRY * geometry = hHd44780->geometry;
+                                        /* Check we know where the position   */
+                                        /* is                                 */
+    if (geometry == (HD44780GEOMETRY *) 0 ||
+        row >= geometry->rows || column >= geometry->columns)
+    {
+        return 0;
+    }
+
+    return hd44780SetCursorAddr(hHd44780,
+                                locateHD44780Cell(geometry, row, column));
+}
+
 /*******************************************************************************
 * hd44780ReadAddr()
 *
@@ -1144,9 +1504,9 @@ unsigned char hd44780WriteChar(HHD44780 const hHd44780, unsigned char data)
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteData(hHd44780->hLcdIf,
-                                                            data);
-                                        
+                writeHD44780Data(hHd44780, data);
+                                        /* Shadow buffer can't follow this    */
+                hHd44780->hd44780Flags &= ~HD44780_SHADOWVALID;
                 returnValue = 1;
             }
                                         /* Return the bus                     */
@@ -1165,7 +1525,7 @@ unsigned char hd44780WriteChar(HHD44780 const hHd44780, unsigned char data)
 *   "Set Address" command was to a DDRAM (cursor) address
 *
 * See also:
-*   hd44780WriteString()
+*   hd44780WriteString(), hd44780ReadRAMBlock()
 *
 * Arguments: 
 *   hHd44780            - handle to the open HD44780
@@ -1196,9 +1556,7 @@ unsigned char hd44780ReadChar(HHD44780 const hHd44780, unsigned char * data)
                                         /* Check busy bit                     */
             if(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pReadData(hHd44780->hLcdIf,
-                                                                          data);
-                returnValue = 1;
+                returnValue = readHD44780Data(hHd44780, data);
             }
                                         /* Return the bus                     */
             hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
@@ -1216,7 +1574,7 @@ unsigned char hd44780ReadChar(HHD44780 const hHd44780, unsigned char * data)
 *   on a Harvard architecture PIC controller (everything but PIC32)
 *
 * See also:
-*   None
+*   hd44780WriteROMString()
 *
 * Arguments: 
 *   hHd44780            - handle to the open HD44780
@@ -1233,11 +1591,16 @@ unsigned char hd44780ReadChar(HHD44780 const hHd44780, unsigned char * data)
 * Notes : 
 * 1. Caller must have 'created' at least one HD44780 object before
 *    calling this function
+* 2. In timed mode, if the LCD interface provides pWriteDataBlock, up to 255
+*    characters are written in one call, waiting between each of them
+* 3. When carried out by hd44780Tick() or hd44780ServiceAll(), one character
+*    is written per call
 *
 *******************************************************************************/
 const unsigned char * hd44780WriteRAMString(HHD44780 const   hHd44780,
                                  const unsigned char * string)
 {
+    unsigned char length;
                                         /* Check LCD interface is actually    */
     	                                /* open                               */
     if (hHd44780->hd44780Flags & HD44780_OPEN)
@@ -1245,11 +1608,34 @@ const unsigned char * hd44780WriteRAMString(HHD44780 const   hHd44780,
                                         /* First get the bus                  */
         if (hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
         {
+                                        /* In timed mode the whole string can */
+                                        /* go in one block transfer           */
+            if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+                hHd44780->lcdIfFunctionPointers->pWriteDataBlock != 0 &&
+                !hd44780Ticking)
+            {
+                if (!isHD44780Busy(hHd44780))
+                {
+                    length = measureHD44780String(string);
+                    writeHD44780DataBlock(hHd44780, string, length);
+                    string += length;
+                                        /* Shadow buffer can't follow this    */
+                    hHd44780->hd44780Flags &= ~HD44780_SHADOWVALID;
+                }
+                                        /* Return the bus                     */
+                hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+                if (*string == 0)
+                {
+                    return (unsigned char *) 0;
+                }
+                return string;
+            }
                                         /* Check busy bit                     */
             while(!isHD44780Busy(hHd44780))
             {
-                hHd44780->lcdIfFunctionPointers->pWriteData(hHd44780->hLcdIf,
-                                                                       *string);
+                writeHD44780Data(hHd44780, *string);
+                                        /* Shadow buffer can't follow this    */
+                hHd44780->hd44780Flags &= ~HD44780_SHADOWVALID;
                                         /* Increment string pointer           */
                 string++;
                                         /* If no more data, return NULL       */
@@ -1260,7 +1646,11 @@ const unsigned char * hd44780WriteRAMString(HHD44780 const   hHd44780,
 
                     return (unsigned char *) 0;
                 }    
-                                        
+                                        /* One character per tick             */
+                if (hd44780Ticking)
+                {
+                    break;
+                }
             }
                                         /* Return the bus                     */
             hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
@@ -1273,23 +1663,22 @@ const unsigned char * hd44780WriteRAMString(HHD44780 const   hHd44780,
 }    
 
 /*******************************************************************************
-* hd44780WriteCGRAM()
+* hd44780WriteROMString()
 *
 * Summary: 
-*   Write a string of data to the display. The string itself must lie in SRAM
-*   on a Harvard architecture PIC controller (everything but PIC32)
+*   Write a string held in program memory to the display, reading each
+*   character straight from program memory onto the bus
 *
 * See also:
-*   None
+*   hd44780WriteRAMString()
 *
 * Arguments: 
 *   hHd44780            - handle to the open HD44780
-*   character           - pointer to where the character data is stored
-*   font                - the font size (5x8 or 5x10 dots)
+*   string              - string in program memory (HD44780_ROM)
 *
 * Returns: 
 *   - !NULL         - command not complete (most likely bus busy); returned 
-*                     value indicates where in charcter we stopped
+*                     value indicates where in string we stopped
 *   - NULL          - command complete
 *
 * Callers: 
@@ -1298,14 +1687,21 @@ const unsigned char * hd44780WriteRAMString(HHD44780 const   hHd44780,
 * Notes : 
 * 1. Caller must have 'created' at least one HD44780 object before
 *    calling this function
-* 2. Caller must have set a CGRAM address before using this function
+* 2. On PIC18 (C18) the string is a rom pointer and is read with TBLRD, so
+*    strings need not be copied into RAM first. On C30 HD44780_ROM is empty
+*    and the string is an ordinary const pointer; see HD44780_ROM for what
+*    that needs. On other targets this is the same as
+*    hd44780WriteRAMString() without block transfers
+* 3. In timed mode the whole string is written in one call under a single
+*    bus acquisition, waiting out each character. Block transfers need the
+*    string in RAM, so each character is written on its own
 *
 *******************************************************************************/
-const unsigned char * hd44780WriteCGRAM(HHD44780 const hHd44780,
-                         const unsigned char * character,
-                                 unsigned char font)
+const HD44780_ROM unsigned char * hd44780WriteROMString(
+                                  HHD44780 const   hHd44780,
+                                  const HD44780_ROM unsigned char * string)
 {
-    unsigned char counter;
+    unsigned char streaming;
                                         /* Check LCD interface is actually    */
     	                                /* open                               */
     if (hHd44780->hd44780Flags & HD44780_OPEN)
@@ -1313,753 +1709,3179 @@ const unsigned char * hd44780WriteCGRAM(HHD44780 const hHd44780,
                                         /* First get the bus                  */
         if (hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
         {
-                                        /* Check busy bit                     */
-            while(!isHD44780Busy(hHd44780))
+                                        /* Timed mode keeps the bus and waits */
+                                        /* out each character                 */
+            streaming = hHd44780->pGetMicroseconds !=
+                                            (unsigned int (*)(void)) 0;
+            while (*string != 0)
             {
-                hHd44780->lcdIfFunctionPointers->pWriteData(hHd44780->hLcdIf,
-                                                                    *character);
-                                        /* Increment character pointer        */
-                character++;
-                                        /* If no more data, return NULL       */
-                if (*character == 0)
+                                        /* Check busy bit                     */
+                if (isHD44780Busy(hHd44780))
                 {
-                                        /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
-
-                    return (unsigned char *) 0;
-                }    
-                                        
+                    if (streaming)
+                    {
+                        continue;
+                    }
+                    break;
+                }
+                writeHD44780Data(hHd44780, *string);
+                                        /* Shadow buffer can't follow this    */
+                hHd44780->hd44780Flags &= ~HD44780_SHADOWVALID;
+                                        /* Increment string pointer           */
+                string++;
             }
                                         /* Return the bus                     */
             hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
-            return character;
-        }    
+                                        /* If no more data, return NULL       */
+            if (*string == 0)
+            {
+                return (const HD44780_ROM unsigned char *) 0;
+            }
+        }
     }
                                         /* Return string if we couldn't do    */
                                         /* anything                           */
-    return character;
-}    
+    return string;
+}
 
 /*******************************************************************************
-* hd44780InstructionInit(()
+* hd44780WriteAt()
 *
 * Summary: 
-*   Closes an LCD interface and releases the handle to it
+*   Writes characters to a row of the display starting at the given column,
+*   dropping any that fall off the end of the row
 *
 * See also:
+*   hd44780AttachGeometry(), hd44780SetCursorPos(), hd44780WriteRAMString()
 *
 * Arguments: 
 *   hHd44780            - handle to the open HD44780
-*   hd44780Clone        - chipset if not exactly an Hitachi HD44780U
-*   displayOnOffControl - desired settings for the Display On/Off Control 
-*                         command which will be called as part of this procedure
-*   entryModeSet        - desired settings for the Entry Mode Set command which
-*                         will be called as part of this procedure
+*   row                 - row to write to, starting from 0 at the top
+*   column              - column of the first character, starting from 0 on
+*                         the left
+*   characters          - characters to write; may include 0 for CGRAM
+*                         character 0
+*   length              - number of characters to write
+*   written             - 0 to start writing, or the value returned by the
+*                         previous call to carry on
 *
 * Returns: 
-*   - >1  	        - number of microseconds (us) to wait until calling this
-*                     function again
-*   - 1             - call this function repeatedly until 0 is returned
-*   - 0             - this function has completed the initialisation procedure
-*                     and the LCD is ready to be used
+*   Progress of the write, to be passed back as written; the write is complete
+*   when this is length. The value is unchanged if no geometry is attached or
+*   the bus or display was busy
 *
 * Callers: 
 *   User application
 *
 * Notes : 
-* 1. Caller must have 'created' at least one LCD interface object before
+* 1. Caller must have 'created' at least one HD44780 object before
 *    calling this function
-* 2. For a true HD44780U chip set, this function will leave the display in the 
-*    "display off" state as required by the Instruction Initialisation routine
-*    in the datasheet
+* 2. The DDRAM address is looked up in the attached geometry and set once;
+*    the address counter's auto-increment does the rest. Only a split 16x1
+*    display needs a second Set DDRAM Address, at column 8
+* 3. Characters that would fall off the row, or a row or column off the
+*    display, are dropped and count as written
+* 4. In timed mode, if the LCD interface provides pWriteDataBlock, the row is
+*    written in one call under a single bus acquisition, waiting out each
+*    instruction
+* 5. In busy flag mode the function returns as soon as the display is busy;
+*    call it again with the value returned. Don't write to the display in
+*    between or the DDRAM address is lost
+* 6. When called from within hd44780Tick() or hd44780ServiceAll(), one
+*    instruction or character is written per call
+* 7. The display must be incrementing, without display shift. The cursor is
+*    left after the last character written
 *
 *******************************************************************************/
-unsigned int hd44780InstructionInit(HHD44780 const  hHd44780,
-                                    HD44780CLONE    hd44780Clone,
-                                    unsigned char   functionSet,
-                                    unsigned char   displayOnOffControl,
-                                    unsigned char   entryModeSet)
+unsigned char hd44780WriteAt(HHD44780 const hHd44780,
+                             unsigned char row,
+                             unsigned char column,
+                             const unsigned char * characters,
+                             unsigned char length,
+                             unsigned char written)
 {
-    unsigned int returnValue;
+    const HD44780GEOMETRY * geometry = hHd44780->geometry;
+    unsigned char visible;              /* Characters that land on the row    */
+    unsigned char segmentLeft;          /* Columns left in this segment       */
+    unsigned char addressSet;
+    unsigned char blockTransfer;
                                         /* Check LCD interface is actually    */
-    	                                /* open                               */
-    if (hHd44780->hd44780Flags & HD44780_OPEN)
+    	                                /* open and has a geometry            */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        geometry == (HD44780GEOMETRY *) 0)
     {
-                                        /* Check what state we are currently  */
-                                        /* in                                 */
-        switch(hHd44780->hd44780Flags & HD44780_INSTRINITSTATE)
-        {
-/******************************************************************************/
-/*                        START OF INITIALISATION                             */
-/******************************************************************************/
-                                        /* On starting initialisation, we     */
-                                        /* always wait a set time before      */
-                                        /* doing anything                     */
-            case STARTINIT:
-                if (hd44780Clone == HD44780U)
-                {
-                                        /* Wait >15ms                         */
-                    returnValue = 15000;
-                }
-                else if (hd44780Clone == KS0066U || hd44780Clone == NT7603)
-                {
-                                        /* Wait >30ms                         */
-                    returnValue = 30000;   
-                }
-                else
-                {
-                                        /* Otherwise wait >40ms               */
-                    returnValue = 40000;   
-                }
-                                        /* Set up next state                  */
-                hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                hHd44780->hd44780Flags |= FUNCTIONSET1;
-                break;
-                
-/******************************************************************************/
-/*                        FIRST FUNCTION SET CALL                             */
-/******************************************************************************/
-                                        /* This implements the first Function */
-                                        /* set command. This is a single      */
-                                        /* 4-bit access in 4-bit bus mode.    */
-                                        /* Some chipsets allow an immediate   */
-                                        /* second 8-bit access                */
-            case FUNCTIONSET1:
-                                        /* First get the bus                  */
-                if (hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
-                {
-                                        /* Is it a 4- or 8-bit bus?           */
-                    if (lcdifGetPbBusWidth(hHd44780->hLcdIf) == BUS4BITSWIDE)
-                    {
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-/*                                   4-BIT BUS                                */
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-                                        /* For a 4-bit bus...                 */
-                        if (hd44780Clone == ST7066U)
-                        {   
-                                        /* Send first 4 bit FuncSet command   */
-                            hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
-                                                               hHd44780->hLcdIf,
-                                                               0x03);
-                                        /* Wait further 37us                  */
-                            returnValue = 37;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET2;
-                        }
-                        else if ((hd44780Clone == KS0066U) || 
-                                 (hd44780Clone == S6A0069) ||
-                                 (hd44780Clone == NT7603))
-                        {
-                                        /* Send two function set commands     */
-                                        /* first 4-bit, second 8-bit          */
-                            hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
-                                                               hHd44780->hLcdIf,
-                                                               0x02);
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                              hHd44780->hLcdIf, 
-                                              HD44780_FUNCTIONSET & FS_4BITBUS &
-                                              functionSet);
-                            if (hd44780Clone == NT7603)
-                            {
-                                        /* Wait further 40us                  */
-                                returnValue = 40;
-                            }
-                            else
-                            {
-                                        /* Wait further 39us                  */
-                                returnValue = 39;
-                            }
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= DISPLAYONOFFCONTROL;
-                        }
-                        else if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send single 4-bit function set     */
-                                        /* command                            */
-                            hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
-                                                               hHd44780->hLcdIf,
-                                                               0x03);
-                                        /* Wait further 4.1ms                 */
-                            returnValue = 4100;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET2;
-                        }   
-                    }
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-/*                                   8-BIT BUS                                */
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-                    else                /* Bus is 8-bits                      */
-                    {
-                        if (hd44780Clone == ST7066U)
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        /* Wait further 37us */
-                            returnValue = 37;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET2;
-                        }
-                        else if ((hd44780Clone == KS0066U) ||
-                                 (hd44780Clone == S6A0069) ||
-                                 (hd44780Clone == NT7603))
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        
-                            if (hd44780Clone == NT7603)
-                            {
-                                        /* Wait further 40us                  */
-                                returnValue = 40;
-                            }
-                            else
-                            {
-                                        /* Wait further 39us                  */
-                                returnValue = 39;
-                            }
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= DISPLAYONOFFCONTROL;
-                        }    
-                        else if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        /* Wait further 4.1ms */
-                            returnValue = 4100;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET2;
-                        }    
-                    }
-                                        /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);    
-                }
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
-                {
-                    returnValue = 1;
-                }
-                break;
-/******************************************************************************/
-/*                        SECOND FUNCTION SET CALL                            */
-/******************************************************************************/
-                                        /* This implements the second         */
-                                        /* Function set command.              */            
-            case FUNCTIONSET2:
+        goto hd44780WriteAtDone;
+    }
+                                        /* Clip to the row                    */
+    visible = 0;
+    if (row < geometry->rows && column < geometry->columns)
+    {
+        visible = geometry->columns - column;
+        if (visible > length)
+        {
+            visible = length;
+        }
+    }
+    if ((written & ~HD44780_RAMADDRESSED) >= visible)
+    {
+        written = length;
+        goto hd44780WriteAtDone;
+    }
                                         /* First get the bus                  */
-                if (lcdifGetPb(hHd44780->hLcdIf))
-                {
-                                        /* Is it a 4- or 8-bit bus?           */
-                    if (lcdifGetPbBusWidth(hHd44780->hLcdIf) == BUS4BITSWIDE)
-                    {
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-/*                                   4-BIT BUS                                */
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/                        
-                        if (hd44780Clone == ST7066U)
-                        {
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                              hHd44780->hLcdIf, 
-                                              HD44780_FUNCTIONSET & FS_4BITBUS &
-                                              functionSet);
-                                        /* Wait further 37us                  */
-                            returnValue = 37;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET3;
-                        }
-                        else if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send 4 bit FuncSet command         */
-                            hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
-                                                               hHd44780->hLcdIf,
-                                                               0x03);
-                                        /* Wait further 100us                 */
-                            returnValue = 100;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET3;
-                        }     
-                    }
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-/*                                   8-BIT BUS                                */
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-                    else                /* Bus is 8-bits wide                 */
-                    {
-                        if (hd44780Clone == ST7066U)
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        /* Wait further 37us */
-                            returnValue = 37;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= DISPLAYONOFFCONTROL;
-                        }
-                        else if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        /* Wait further 100us */
-                            returnValue = 100;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET3;
-                        }    
+    if (!hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+    {
+        goto hd44780WriteAtDone;
+    }
+                                        /* A part way write left the address  */
+                                        /* counter where it carries on from   */
+    addressSet = written & HD44780_RAMADDRESSED;
+    written &= ~HD44780_RAMADDRESSED;
+    blockTransfer = hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+                    hHd44780->lcdIfFunctionPointers->pWriteDataBlock != 0 &&
+                    !hd44780Ticking;
 
-                    }
-                                        /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);  
-                }
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
-                {
-                    returnValue = 1;
-                }
-                break;
+    while (written < visible)
+    {
+                                        /* Check busy bit; timed mode waits   */
+                                        /* out the timer to keep the bus      */
+        if (isHD44780Busy(hHd44780))
+        {
+            if (blockTransfer)
+            {
+                continue;
+            }
+            break;
+        }
 
-/******************************************************************************/
-/*                        THIRD FUNCTION SET CALL                             */
-/******************************************************************************/
-                                        /* This implements the third          */
-                                        /* Function set command.              */            
-            case FUNCTIONSET3:
-                                        /* First get the bus                  */
-                if (lcdifGetPb(hHd44780->hLcdIf))
-                {
-                                        /* Is it a 4- or 8-bit bus?           */
-                    if (lcdifGetPbBusWidth(hHd44780->hLcdIf) == BUS4BITSWIDE)
-                    {
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-/*                                   4-BIT BUS                                */
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-                        if (hd44780Clone == ST7066U)
-                        {
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                              hHd44780->hLcdIf, 
-                                              HD44780_FUNCTIONSET & FS_4BITBUS &
-                                              functionSet);
-                                        /* Return 1 so that we are called     */
-                                        /* again                              */
-                            returnValue = 1;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= DISPLAYONOFFCONTROL;
-                        }
-                        else if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send 4 bit FuncSet command         */
-                            hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
-                                                               hHd44780->hLcdIf,
-                                                               0x03);
-                                        /* Send further 4 bit FuncSet command */
-                                        /* This time setting 4-bit bus        */
-                            hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
-                                                               hHd44780->hLcdIf,
-                                                               0x02);
-                                        /* Return 1 so we get called again    */
-                            returnValue = 1;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET4;
-                        }    
-                    }
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-/*                                   8-BIT BUS                                */
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-                                        /* If bus is 8-bits wide              */
-                    else
-                    {
-                        if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        /* Return 1 so we get called again    */
-                            returnValue = 1;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= FUNCTIONSET4;
-                        } 
-                    }    
+        segmentLeft = geometry->segmentColumns -
+                      (column + written) % geometry->segmentColumns;
+        if (!addressSet)
+        {
+            writeHD44780Instr(hHd44780, HD44780_SETDDRAMADDRESS &
+                              (0x80 | locateHD44780Cell(geometry, row,
+                                                        column + written)));
+            addressSet = 1;
+        }
+        else
+        {
+            if (segmentLeft > visible - written)
+            {
+                segmentLeft = visible - written;
+            }
+            if (blockTransfer)
+            {
+                                        /* Rest of this segment in one block  */
+                writeHD44780DataBlock(hHd44780, characters + written,
+                                      segmentLeft);
+                written += segmentLeft;
+                segmentLeft = 0;
+            }
+            else
+            {
+                writeHD44780Data(hHd44780, characters[written]);
+                written++;
+                segmentLeft--;
+            }
+                                        /* Shadow buffer can't follow this    */
+            hHd44780->hd44780Flags &= ~HD44780_SHADOWVALID;
+                                        /* Next segment needs its own address */
+            if (segmentLeft == 0)
+            {
+                addressSet = 0;
+            }
+        }
+                                        /* One write per tick                 */
+        if (hd44780Ticking)
+        {
+            break;
+        }
+    }
                                         /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);
-                }            
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
-                {
-                    returnValue = 1;
-                }
-                break;
+    hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+    if (written >= visible)
+    {
+        written = length;
+    }
+    else if (addressSet)
+    {
+        written |= HD44780_RAMADDRESSED;
+    }
+
+hd44780WriteAtDone:
+    return written;
+}
 
-/******************************************************************************/
-/*                        FOURTH FUNCTION SET CALL                            */
-/******************************************************************************/
-                                        /* This implements the fourth         */
-                                        /* Function set command.              */            
-            case FUNCTIONSET4:
+/*******************************************************************************
+* hd44780WriteCGRAM()
+*
+* Summary: 
+*   Write a string of data to the display. The string itself must lie in SRAM
+*   on a Harvard architecture PIC controller (everything but PIC32)
+*
+* See also:
+*   hd44780WriteCGRAMBlock()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   character           - pointer to where the character data is stored
+*   font                - the font size (5x8 or 5x10 dots)
+*
+* Returns: 
+*   - !NULL         - command not complete (most likely bus busy); returned 
+*                     value indicates where in charcter we stopped
+*   - NULL          - command complete
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one HD44780 object before
+*    calling this function
+* 2. Caller must have set a CGRAM address before using this function
+* 3. In timed mode, if the LCD interface provides pWriteDataBlock, the whole
+*    character is written in one call, waiting between each byte
+* 4. When carried out by hd44780Tick() or hd44780ServiceAll(), one byte is
+*    written per call
+* 5. Writing stops at the first 0 in character, so a character with a blank
+*    row can't be written this way; use hd44780WriteCGRAMBlock() instead
+*
+*******************************************************************************/
+const unsigned char * hd44780WriteCGRAM(HHD44780 const hHd44780,
+                         const unsigned char * character,
+                                 unsigned char font)
+{
+    unsigned char counter;
+    unsigned char length;
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if (hHd44780->hd44780Flags & HD44780_OPEN)
+    {
                                         /* First get the bus                  */
-                if (lcdifGetPb(hHd44780->hLcdIf))
-                {
-                                        /* Is it a 4- or 8-bit bus?           */
-                    if (lcdifGetPbBusWidth(hHd44780->hLcdIf) == BUS4BITSWIDE)
-                    {
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-/*                                   4-BIT BUS                                */
-/*4444444444444444444444444444444444444444444444444444444444444444444444444444*/
-                        if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send full FuncSet command          */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                           hHd44780->hLcdIf,
-                                                           HD44780_FUNCTIONSET &
-                                                           FS_4BITBUS &
-                                                           functionSet);
-                                        /* Return 1 so we get called again    */
-                            returnValue = 1;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= DISPLAYONOFFCONTROL;
-                        }    
-                    }
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-/*                                   8-BIT BUS                                */
-/*8888888888888888888888888888888888888888888888888888888888888888888888888888*/
-                    /* If bus is 8-bits wide              */
-                    else
-                    {
-                        if (hd44780Clone == HD44780U)
-                        {
-                                        /* Send a function set command        */
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                             hHd44780->hLcdIf, 
-                                             HD44780_FUNCTIONSET & functionSet);
-                                        /* Return 1 so we get called again    */
-                            returnValue = 1;
-                                        /* Set up next state                  */
-                            hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                            hHd44780->hd44780Flags |= DISPLAYONOFFCONTROL;
-                        } 
-                    }
-                                        /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);
-                }            
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
+        if (hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+        {
+                                        /* In timed mode the whole character  */
+                                        /* can go in one block transfer       */
+            if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+                hHd44780->lcdIfFunctionPointers->pWriteDataBlock != 0 &&
+                !hd44780Ticking)
+            {
+                if (!isHD44780Busy(hHd44780))
                 {
-                    returnValue = 1;
+                    length = measureHD44780String(character);
+                    writeHD44780DataBlock(hHd44780, character, length);
+                    character += length;
                 }
-                break;
-                
-/******************************************************************************/
-/*                        DISPLAY ON/OFF CALL                                 */
-/******************************************************************************/
-                                        /* This implements the display on/off */
-                                        /* command                            */
-            case DISPLAYONOFFCONTROL:
-                if (lcdifGetPb(hHd44780->hLcdIf))
-                {
-                    unsigned char address;
-                                        /* No longer need to check the bus    */
-                                        /* width as the HAL layer deals with  */
-                                        /* this issue for us                  */
-
-                                        /* Reading busy bit only works for    */
-                                        /* ST7066U and HD44780U at this point */
-                                        /* Other controllers still need to    */
-                                        /* wait a set time                    */
-                    if (hd44780Clone == ST7066U || hd44780Clone == HD44780U)
-                    {
-                                        /* Read address to get the busy-bit   */
-                        hHd44780->lcdIfFunctionPointers->pReadAddr(
-                                                    hHd44780->hLcdIf, &address);
-                        if (!(address & 0x80))
-                        {
-                            if (hd44780Clone == ST7066U)
-                            {
-                                hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                   hHd44780->hLcdIf,
-                                                   HD44780_DISPLAYONOFFCONTROL &
-                                                   displayOnOffControl);
-                                        /* Set up next state                  */
-                                hHd44780->hd44780Flags &= 
-                                                        ~HD44780_INSTRINITSTATE;
-                                hHd44780->hd44780Flags |= DISPLAYCLEAR;
-                            }
-                            else if (hd44780Clone == HD44780U)
-                            {
-                                hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                   hHd44780->hLcdIf,
-                                                   HD44780_DISPLAYONOFFCONTROL &
-                                                   DOFC_DISPLAYOFF & 
-                                                   DOFC_CURSOROFF &
-                                                   DOFC_BLINKINGOFF);
-                                        /* Set up next state                  */
-                                hHd44780->hd44780Flags &= 
-                                                        ~HD44780_INSTRINITSTATE;
-                                hHd44780->hd44780Flags |= DISPLAYCLEAR;
-                            }
-                                        /* Return 1 so we get called again    */
-                            returnValue = 1;    
-                        }
-                                        /* If busy bit was set, note that we  */
-                                        /* should be called again             */
-                        else
-                        {
-                            returnValue = 1;   
-                        }    
-                    }
-                    else if ((hd44780Clone == KS0066U) || 
-                             (hd44780Clone == S6A0069) ||
-                             (hd44780Clone == NT7603))
-                    {
-                        hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                   hHd44780->hLcdIf,
-                                                   HD44780_DISPLAYONOFFCONTROL &
-                                                   displayOnOffControl);
-                                        /* Set up next state                  */
-                        hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                        hHd44780->hd44780Flags |= DISPLAYCLEAR;
-
-                        if (hd44780Clone == NT7603)
-                        {
-                                        /* Wait further 40us                  */
-                            returnValue = 40;
-                        }
-                        else
-                        {
-                                        /* Wait further 39us                  */
-                            returnValue = 39;
-                        }
                                         /* Return the bus                     */
-                        hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);
-                    }
-                }
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
+                hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+                if (*character == 0)
                 {
-                    returnValue = 1;
+                    return (unsigned char *) 0;
                 }
-                break;
-
-/******************************************************************************/
-/*                        DISPLAY CLEAR                                       */
-/******************************************************************************/
-                                        /* This implements the display on/off */
-                                        /* command                            */
-            case DISPLAYCLEAR:
-                if (lcdifGetPb(hHd44780->hLcdIf))
+                return character;
+            }
+                                        /* Check busy bit                     */
+            while(!isHD44780Busy(hHd44780))
+            {
+                writeHD44780Data(hHd44780, *character);
+                                        /* Increment character pointer        */
+                character++;
+                                        /* If no more data, return NULL       */
+                if (*character == 0)
                 {
-                    unsigned char address;
-                                        /* No longer need to check the bus    */
-                                        /* width as the HAL layer deals with  */
-                                        /* this issue for us                  */
-
-                                        /* Reading busy bit only works for    */
-                                        /* ST7066U and HD44780U at this point */
-                                        /* Other controllers still need to    */
-                                        /* wait a set time                    */
-                    if (hd44780Clone == ST7066U || hd44780Clone == HD44780U)
-                    {
-                                        /* Read address to get the busy-bit   */
-                        hHd44780->lcdIfFunctionPointers->pReadAddr(
-                                                    hHd44780->hLcdIf, &address);
-                        if (!(address & 0x80))
-                        {
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                          hHd44780->hLcdIf,
-                                                          HD44780_CLEARDISPLAY);
-                                        /* Set up next state                  */
-                                hHd44780->hd44780Flags &= 
-                                                        ~HD44780_INSTRINITSTATE;
-                                hHd44780->hd44780Flags |= ENTRYMODESET;
-                                        /* Return 1 so we get called again    */
-                            returnValue = 1;    
-                        }
-                                        /* If busy bit was set, note that we  */
-                                        /* should be called again             */
-                        else
-                        {
-                            returnValue = 1;   
-                        }
-                    }
-                    else if (hd44780Clone == KS0066U || 
-                             hd44780Clone == S6A0069 ||
-                             hd44780Clone == NT7603)
-                    {
-                        hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                          hHd44780->hLcdIf,
-                                                          HD44780_CLEARDISPLAY);
-                                        /* Set up next state                  */
-                        hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                        hHd44780->hd44780Flags |= ENTRYMODESET;                       
-                                        
-                        if (hd44780Clone == NT7603)
-                        {
-                                        /* Call again in 1.64ms or more       */
-                            returnValue = 1640;
-                        }
-                        else
-                        {
-                                        /* Call again in 1.53ms or more       */
-                            returnValue = 1530;
-                        }
-                    }    
-
                                         /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);
-                }
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
+                    hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+
+                    return (unsigned char *) 0;
+                }    
+                                        /* One byte per tick                  */
+                if (hd44780Ticking)
                 {
-                    returnValue = 1;
+                    break;
                 }
-                break;
-                
-/******************************************************************************/
-/*                        ENTRY MODE SET                                      */
-/******************************************************************************/
-                                        /* This implements the display on/off */
-                                        /* command                            */
-            case ENTRYMODESET:
-                if (lcdifGetPb(hHd44780->hLcdIf))
-                {
-                    unsigned char address;
-                                        /* No longer need to check the bus    */
-                                        /* width as the HAL layer deals with  */
-                                        /* this issue for us                  */
-
-                                        /* Reading busy bit only works for    */
-                                        /* ST7066U and HD44780U at this point */
-                                        /* Other controllers still need to    */
-                                        /* wait a set time                    */
-                    if (hd44780Clone == ST7066U || hd44780Clone == HD44780U)
-                    {
-                                        /* Read address to get the busy-bit   */
-                        hHd44780->lcdIfFunctionPointers->pReadAddr(
-                                                    hHd44780->hLcdIf, &address);
-                        if (!(address & 0x80))
-                        {
-                            hHd44780->lcdIfFunctionPointers->pWriteInstr( 
-                                                          hHd44780->hLcdIf,
-                                                          HD44780_ENTRYMODESET &
-                                                          entryModeSet);
-                                        /* Set up start state in case this    */
-                                        /* function is called again           */
-                                hHd44780->hd44780Flags &= 
-                                                        ~HD44780_INSTRINITSTATE;
-                                hHd44780->hd44780Flags |= STARTINIT;
-                                        /* Return 0 as initialisation is      */
-                                        /* complete                           */
-                            returnValue = 0;    
-                        }
-                                        /* If busy bit was set, note that we  */
-                                        /* should be called again             */
-                        else
-                        {
-                            returnValue = 1;   
-                        }
-                    }
-                    else if (hd44780Clone == KS0066U || 
-                             hd44780Clone == S6A0069 ||
-                             hd44780Clone == NT7603)
-                    {
-                        hHd44780->lcdIfFunctionPointers->pWriteInstr(
-                                                          hHd44780->hLcdIf,
-                                                          HD44780_ENTRYMODESET &
-                                                          entryModeSet);
-                                        /* Set up start state in case this    */
-                                        /* function is called again           */
-                        hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
-                        hHd44780->hd44780Flags |= STARTINIT;                       
-                                        /* Return 0 as initialisation is      */
-                                        /* complete                           */
-                            returnValue = 0;   
-                    }    
-   
+            }
                                         /* Return the bus                     */
-                    hHd44780->lcdIfFunctionPointers->pReturnBus(
-                                                              hHd44780->hLcdIf);
-                }
-                                        /* If we couldn't get the bus, return */
-                                        /* 1 so we get called again           */
-                else
-                {
-                    returnValue = 1;
-                }
-                break;
+            hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+            return character;
         }    
-    } 
-    
-    return returnValue;   
+    }
+                                        /* Return string if we couldn't do    */
+                                        /* anything                           */
+    return character;
 }    
 
 /*******************************************************************************
-* isHD44780Busy() --PRIVATE FUNCTION--
+* hd44780WriteCGRAMBlock()
 *
 * Summary: 
-*   Checks the busy bit of the LCD chip set. This function is private to the 
-* HD44780 Module.
+*   Uploads a run of user defined characters to CGRAM. The data is counted
+*   rather than zero terminated, so character rows may be blank
 *
 * See also:
-*   None
+*   hd44780WriteCGRAM(), hd44780SetCGRAMAddr()
 *
 * Arguments: 
-*   hHd44780        - handle to valid HD44780 object
+*   hHd44780            - handle to the open HD44780
+*   firstCharacter      - first character code to define; 0 to 7 for 5x8
+*                         dots, 0 to 3 for 5x10 dots
+*   characters          - font data, font bytes per character, one byte per
+*                         row with the dots in the lower five bits
+*   numberOfCharacters  - number of characters to upload
+*   font                - the font size (CGRAMFONT_5X8 or CGRAMFONT_5X10)
+*   written             - 0 to start an upload, or the value returned by the
+*                         previous call to carry on
 *
 * Returns: 
-*   0               - device not busy
-*   1               - device is busy
+*   Progress of the upload, to be passed back as written; the upload is
+*   complete when this is numberOfCharacters * font. The value is unchanged
+*   if the arguments are invalid or the bus or display was busy
 *
 * Callers: 
-*   hd44780ClearDisplay(), hd44780ReturnHome(), hd44780EntryModeSet(), 
-*   hd44780DisplayControl(), hd44780ShiftControl(), hd44780FunctionSet(), 
-*   hd44780SetCGRAMAddr(), hd44780SetCursorAddr(), hd44780ReadAddr(), 
-*   hd44780WriteChar(), hd44780ReadChar(), hd44780WriteRAMString(), 
-*   hd44780WriteCGRAM()
+*   User application
 *
 * Notes : 
-* 1. You must own the pbIf bus before calling this function, i.e. 
-*    hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf) *must* have
-*    returned true. If you don't, this call will fail and return 1
+* 1. Caller must have 'created' at least one HD44780 object before
+*    calling this function
+* 2. The function sets the CGRAM address itself; once per upload for 5x8
+*    dots and once per character for 5x10 dots, as these start every 16 bytes
+* 3. In timed mode, if the LCD interface provides pWriteDataBlock, the whole
+*    upload is written in one call under a single bus acquisition, waiting
+*    out each instruction
+* 4. In busy flag mode the function returns as soon as the display is busy,
+*    so it can't hang on a missing display; call it again with the value
+*    returned. Don't write to the display in between or the CGRAM address
+*    is lost
+* 5. When called from within hd44780Tick() or hd44780ServiceAll(), one
+*    instruction or byte is written per call
+* 6. The address counter is left in CGRAM; set a DDRAM address before
+*    writing characters again
+* 7. The characters written are freed in an attached glyph cache, including
+*    any pinned there
+*
 *******************************************************************************/
-unsigned char isHD44780Busy(HHD44780 const hHd44780)
+unsigned char hd44780WriteCGRAMBlock(HHD44780 const hHd44780,
+                                     unsigned char firstCharacter,
+                                     const unsigned char * characters,
+                                     unsigned char numberOfCharacters,
+                                     unsigned char font,
+                                     unsigned char written)
 {
-    unsigned char address;              /* Storage for return value of        */
-                                        /* pReadAddr                          */
-    hHd44780->lcdIfFunctionPointers->pReadAddr(hHd44780->hLcdIf, &address);
-    if (!(address & 0x80))
+    unsigned char charactersInCGRAM;
+    unsigned char characterSize;        /* CGRAM bytes per character          */
+    unsigned char total;
+    unsigned char length;
+    unsigned char addressSet;
+    unsigned char blockTransfer;
+    HD44780GLYPHCACHE * glyphCache;
+    unsigned char slotMask;             /* Glyph cache characters written     */
+    unsigned char slot;
+                                        /* Check the font and that the        */
+                                        /* characters fit in CGRAM            */
+    if (font == CGRAMFONT_5X8)
     {
-        return 0;
-    }    
-    
-    return 1;        
+        charactersInCGRAM = 8;
+        characterSize = 8;
+    }
+    else if (font == CGRAMFONT_5X10)
+    {
+        charactersInCGRAM = 4;
+        characterSize = 16;
+    }
+    else
+    {
+        goto hd44780WriteCGRAMBlockDone;
+    }
+    if (firstCharacter >= charactersInCGRAM ||
+        numberOfCharacters > charactersInCGRAM - firstCharacter)
+    {
+        goto hd44780WriteCGRAMBlockDone;
+    }
+    total = numberOfCharacters * font;
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        (written & ~HD44780_RAMADDRESSED) >= total)
+    {
+        goto hd44780WriteCGRAMBlockDone;
+    }
+                                        /* First get the bus                  */
+    if (!hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+    {
+        goto hd44780WriteCGRAMBlockDone;
+    }
+                                        /* The glyph cache's glyphs are gone  */
+                                        /* from the characters written        */
+    glyphCache = hHd44780->glyphCache;
+    if (glyphCache != (HD44780GLYPHCACHE *) 0)
+    {
+        slotMask = (unsigned char) (((0x01 << (numberOfCharacters *
+                                    characterSize / CGRAMFONT_5X8)) - 1) <<
+                                    (firstCharacter * characterSize /
+                                     CGRAMFONT_5X8));
+        for (slot = 0; slot < HD44780_GLYPHSLOTS; slot++)
+        {
+            if (slotMask & (0x01 << slot))
+            {
+                glyphCache->slotGlyph[slot] = HD44780_NOGLYPH;
+            }
+        }
+        glyphCache->pinnedSlots &= ~slotMask;
+        if (glyphCache->uploadSlots & slotMask)
+        {
+            glyphCache->uploadSlots &= ~slotMask;
+            glyphCache->uploadRow = 0;
+        }
+                                        /* A frame mapped to them is mapped   */
+                                        /* again                              */
+        glyphCache->frameMapped = 0;
+    }
+                                        /* A part way upload left the address */
+                                        /* counter where it carries on from   */
+    addressSet = written & HD44780_RAMADDRESSED;
+    written &= ~HD44780_RAMADDRESSED;
+    blockTransfer = hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+                    hHd44780->lcdIfFunctionPointers->pWriteDataBlock != 0 &&
+                    !hd44780Ticking;
+
+    while (written < total)
+    {
+                                        /* Check busy bit; timed mode waits   */
+                                        /* out the timer to keep the bus      */
+        if (isHD44780Busy(hHd44780))
+        {
+            if (blockTransfer)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (!addressSet)
+        {
+            writeHD44780Instr(hHd44780, HD44780_SETCGRAMADDRESS &
+                   (0x40 | ((firstCharacter + written / font) * characterSize +
+                            written % font)));
+            addressSet = 1;
+        }
+        else
+        {
+            if (blockTransfer)
+            {
+                                        /* 5x8 characters follow on from each */
+                                        /* other; 5x10 ones go one at a time  */
+                length = total - written;
+                if (font == CGRAMFONT_5X10)
+                {
+                    length = font - written % font;
+                }
+                writeHD44780DataBlock(hHd44780, characters + written, length);
+            }
+            else
+            {
+                writeHD44780Data(hHd44780, characters[written]);
+                length = 1;
+            }
+            written += length;
+            if (written % font == 0 && font == CGRAMFONT_5X10)
+            {
+                addressSet = 0;
+            }
+        }
+                                        /* One write per tick                 */
+        if (hd44780Ticking)
+        {
+            break;
+        }
+    }
+                                        /* Return the bus                     */
+    hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+    if (addressSet && written < total)
+    {
+        written |= HD44780_RAMADDRESSED;
+    }
+
+hd44780WriteCGRAMBlockDone:
+    return written;
+}
+
+/*******************************************************************************
+* hd44780ReadRAMBlock()
+*
+* Summary: 
+*   Reads a run of bytes from DDRAM or CGRAM, starting at the current address,
+*   as the block counterpart of hd44780ReadChar()
+*
+* See also:
+*   hd44780ReadChar(), hd44780ReadCGRAM(), hd44780ReadScreen()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   data                - place to store the bytes read
+*   length              - number of bytes to read
+*   read                - 0 to start reading, or the value returned by the
+*                         previous call to carry on
+*
+* Returns: 
+*   Number of bytes read so far; the read is complete when this is length.
+*   The value is unchanged if the bus or display was busy
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one HD44780 object before
+*    calling this function
+* 2. Caller must have set a DDRAM or CGRAM address before using this function
+* 3. In timed mode, if the LCD interface provides pReadDataBlock, all length
+*    bytes are read in one call under a single bus acquisition, with the bus
+*    set up for reading once
+* 4. In busy flag mode the function returns as soon as the display is busy;
+*    call it again with the value returned
+*
+*******************************************************************************/
+unsigned char hd44780ReadRAMBlock(HHD44780 const hHd44780,
+                                  unsigned char * data,
+                                  unsigned char length,
+                                  unsigned char read)
+{
+    return readHD44780RAM(hHd44780, data, length, read, 0, length, 0);
+}
+
+/*******************************************************************************
+* hd44780ReadCGRAM()
+*
+* Summary: 
+*   Reads a run of user defined characters back from CGRAM
+*
+* See also:
+*   hd44780WriteCGRAMBlock(), hd44780ReadRAMBlock()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   firstCharacter      - first character code to read; 0 to 7 for 5x8
+*                         dots, 0 to 3 for 5x10 dots
+*   characters          - place to store the font data, font bytes per
+*                         character
+*   numberOfCharacters  - number of characters to read
+*   font                - the font size (CGRAMFONT_5X8 or CGRAMFONT_5X10)
+*   read                - 0 to start reading, or the value returned by the
+*                         previous call to carry on
+*
+* Returns: 
+*   Progress of the read, to be passed back as read; the read is complete
+*   when this is numberOfCharacters * font. The value is unchanged if the
+*   arguments are invalid or the bus or display was busy
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one HD44780 object before
+*    calling this function
+* 2. The function sets the CGRAM address itself, as hd44780WriteCGRAMBlock()
+*    does
+* 3. In timed mode, if the LCD interface provides pReadDataBlock, the whole
+*    read is made in one call under a single bus acquisition
+* 4. In busy flag mode the function returns as soon as the display is busy;
+*    call it again with the value returned and don't use the display in
+*    between
+* 5. The address counter is left in CGRAM; set a DDRAM address before
+*    writing characters again
+*
+*******************************************************************************/
+unsigned char hd44780ReadCGRAM(HHD44780 const hHd44780,
+                               unsigned char firstCharacter,
+                               unsigned char * characters,
+                               unsigned char numberOfCharacters,
+                               unsigned char font,
+                               unsigned char read)
+{
+    unsigned char charactersInCGRAM;
+    unsigned char characterSize;        /* CGRAM bytes per character          */
+    unsigned char runLength;            /* Bytes read per address set         */
+                                        /* Check the font and that the        */
+                                        /* characters are in CGRAM            */
+    if (font == CGRAMFONT_5X8)
+    {
+        charactersInCGRAM = 8;
+        characterSize = 8;
+    }
+    else if (font == CGRAMFONT_5X10)
+    {
+        charactersInCGRAM = 4;
+        characterSize = 16;
+    }
+    else
+    {
+        return read;
+    }
+    if (firstCharacter >= charactersInCGRAM ||
+        numberOfCharacters == 0 ||
+        numberOfCharacters > charactersInCGRAM - firstCharacter)
+    {
+        return read;
+    }
+
+                                        /* 5x8 characters are back to back so */
+                                        /* they are read as one run           */
+    runLength = font;
+    if (font == characterSize)
+    {
+        runLength = numberOfCharacters * font;
+    }
+
+    return readHD44780RAM(hHd44780, characters, numberOfCharacters * font,
+                          read, HD44780_SETCGRAMADDRESS &
+                          (0x40 | (firstCharacter * characterSize)),
+                          runLength, characterSize);
+}
+
+/*******************************************************************************
+* hd44780ReadScreen()
+*
+* Summary: 
+*   Reads the whole of DDRAM back from the display, in the layout of a frame
+*   passed to hd44780CommitFrame()
+*
+* See also:
+*   hd44780ReadRAMBlock(), hd44780AttachShadow(), hd44780CommitFrame()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   screen              - HD44780_SHADOWSIZE bytes to store DDRAM in; cells
+*                         0 to 39 are the first line and cells 40 to 79 the
+*                         second. NULL reads into the attached shadow buffer
+*   read                - 0 to start reading, or the value returned by the
+*                         previous call to carry on
+*
+* Returns: 
+*   Progress of the read, to be passed back as read; the read is complete
+*   when this is HD44780_SHADOWSIZE. The value is unchanged if the bus or
+*   display was busy
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one HD44780 object before
+*    calling this function
+* 2. One Set DDRAM Address instruction is needed per line
+* 3. Reading into the shadow buffer makes it valid once the read is
+*    complete, so the next hd44780CommitFrame() only sends what differs from
+*    what is on the display; for example after a warm reset of the host
+* 4. In timed mode, if the LCD interface provides pReadDataBlock, the whole
+*    screen is read in one call under a single bus acquisition
+* 5. In busy flag mode the function returns as soon as the display is busy;
+*    call it again with the value returned and don't use the display in
+*    between
+*
+*******************************************************************************/
+unsigned char hd44780ReadScreen(HHD44780 const hHd44780,
+                                unsigned char * screen,
+                                unsigned char read)
+{
+    unsigned char returnValue;
+
+    if (screen == (unsigned char *) 0)
+    {
+        screen = hHd44780->shadowBuffer;
+        if (screen == (unsigned char *) 0)
+        {
+            return read;
+        }
+    }
+                                        /* A shadow buffer can't be trusted   */
+                                        /* until it is all read               */
+    if (screen == hHd44780->shadowBuffer)
+    {
+        hHd44780->hd44780Flags &= ~HD44780_SHADOWVALID;
+    }
+
+    returnValue = readHD44780RAM(hHd44780, screen, HD44780_SHADOWSIZE, read,
+                                 HD44780_SETDDRAMADDRESS & 0x80,
+                                 HD44780_SHADOWSIZE / 2, 0x40);
+
+    if (screen == hHd44780->shadowBuffer &&
+        returnValue == HD44780_SHADOWSIZE)
+    {
+        hHd44780->hd44780Flags |= HD44780_SHADOWVALID;
+    }
+
+    return returnValue;
+}
+
+/*******************************************************************************
+* hd44780InstructionInit(()
+*
+* Summary: 
+*   Initialises the display by instruction, carrying out the chipset's
+*   initialisation script a step at a time
+*
+* See also:
+*   hd44780InstructionInitAll()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   hd44780Clone        - chipset if not exactly an Hitachi HD44780U
+*   functionSet         - desired settings for the Function Set command which
+*                         will be called as part of this procedure
+*   displayOnOffControl - desired settings for the Display On/Off Control 
+*                         command which will be called as part of this procedure
+*   entryModeSet        - desired settings for the Entry Mode Set command which
+*                         will be called as part of this procedure
+*
+* Returns: 
+*   - >1  	        - number of microseconds (us) to wait until calling this
+*                     function again
+*   - 1             - call this function repeatedly until 0 is returned
+*   - 0             - this function has completed the initialisation procedure
+*                     and the LCD is ready to be used
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. For a true HD44780U chip set, this function will leave the display in the 
+*    "display off" state as required by the Instruction Initialisation routine
+*    in the datasheet
+* 3. If timed mode has been selected with hd44780SetTimedMode(), the busy flag
+*    is not read during initialisation either
+* 4. The scripts are held in hd44780InitSteps, so supporting another chipset
+*    only needs its script adding there and in hd44780InitScripts
+*
+*******************************************************************************/
+unsigned int hd44780InstructionInit(HHD44780 const  hHd44780,
+                                    HD44780CLONE    hd44780Clone,
+                                    unsigned char   functionSet,
+                                    unsigned char   displayOnOffControl,
+                                    unsigned char   entryModeSet)
+{
+    const HD44780_ROM HD44780INITSTEP * step;
+                                        /* Next step of the script            */
+    unsigned char stepNumber;
+                                        /* Steps for the other bus width are  */
+                                        /* skipped                            */
+    unsigned char otherBus;
+    unsigned char instruction;
+    unsigned int returnValue = 0;
+                                        /* Check LCD interface is actually    */
+    	                                /* open and the chipset is known      */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        (unsigned int) hd44780Clone >= sizeof(hd44780InitScripts))
+    {
+        return 0;
+    }
+
+    stepNumber = hHd44780->hd44780Flags & HD44780_INSTRINITSTATE;
+    step = &hd44780InitSteps[hd44780InitScripts[hd44780Clone] + stepNumber];
+                                        /* Waiting for power up doesn't need  */
+                                        /* the bus                            */
+    if ((step->operation & INITSTEP_OPERATION) == INITOP_WAIT)
+    {
+        hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
+        hHd44780->hd44780Flags |= stepNumber + 1;
+        return step->delay;
+    }
+                                        /* First get the bus; if we can't,    */
+                                        /* return 1 so we get called again    */
+    if (!hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+    {
+        return 1;
+    }
+
+    if (lcdifGetPbBusWidth(hHd44780->hLcdIf) == BUS4BITSWIDE)
+    {
+        otherBus = INITSTEP_BUS8;
+    }
+    else
+    {
+        otherBus = INITSTEP_BUS4;
+    }
+                                        /* Carry out steps until one asks us  */
+                                        /* to wait or the script ends         */
+    while (returnValue == 0)
+    {
+        if (step->operation & otherBus)
+        {
+            step++;
+            stepNumber++;
+            continue;
+        }
+                                        /* Check busy bit                     */
+        if ((step->operation & INITSTEP_WAITBUSY) && isHD44780Busy(hHd44780))
+        {
+            returnValue = 1;
+            break;
+        }
+
+        switch (step->operation & INITSTEP_OPERATION)
+        {
+            case INITOP_NIBBLE:
+                hHd44780->lcdIfFunctionPointers->p4BitFunctionSet(
+                                                               hHd44780->hLcdIf,
+                                                               step->value);
+                break;
+
+            case INITOP_FUNCTIONSET:
+                instruction = HD44780_FUNCTIONSET & functionSet;
+                if (otherBus == INITSTEP_BUS8)
+                {
+                    instruction &= FS_4BITBUS;
+                }
+                writeHD44780Instr(hHd44780, instruction);
+                break;
+
+            case INITOP_DISPLAYCONTROL:
+                writeHD44780Instr(hHd44780, HD44780_DISPLAYONOFFCONTROL &
+                                            displayOnOffControl & step->value);
+                break;
+
+            case INITOP_CLEARDISPLAY:
+                writeHD44780Instr(hHd44780, HD44780_CLEARDISPLAY);
+                break;
+
+            case INITOP_ENTRYMODESET:
+                writeHD44780Instr(hHd44780, HD44780_ENTRYMODESET &
+                                            entryModeSet);
+                break;
+                                        /* Initialisation complete; start     */
+                                        /* again if called again              */
+            default:
+                stepNumber = 0;
+                goto init_complete;
+        }
+
+        returnValue = step->delay;
+        step++;
+        stepNumber++;
+    }
+init_complete:
+                                        /* Note where to carry on from        */
+    hHd44780->hd44780Flags &= ~HD44780_INSTRINITSTATE;
+    hHd44780->hd44780Flags |= stepNumber;
+                                        /* Return the bus                     */
+    hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+
+    return returnValue;
+}
+
+/*******************************************************************************
+* hd44780InstructionInitAll()
+*
+* Summary:
+*   Initialises several displays by instruction at the same time, interleaving
+*   their initialisation scripts so that one display's steps are carried out
+*   while the others wait
+*
+* See also:
+*   hd44780InstructionInit()
+*
+* Arguments:
+*   displays            - array of displays to initialise
+*   numberOfDisplays    - number of entries in the array
+*
+* Returns:
+*   - >1  	        - number of microseconds (us) until the next display's
+*                     step is due; wait this long before calling this
+*                     function again
+*   - 1             - call this function repeatedly until 0 is returned
+*   - 0             - all the displays have been initialised and are ready to
+*                     be used
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Each display is taken through hd44780InstructionInit() as though it were
+*    the only one, so the whole set takes about as long as the slowest
+*    display rather than the sum of them all. The displays may share one
+*    peripheral bus
+* 2. Each call assumes the caller waited as long as it was told to by the
+*    previous call. Time spent on the bus, or waiting for longer than asked,
+*    is not counted, so steps are only ever late, never early
+* 3. The private members of each entry are left at 0 when 0 is returned, so
+*    the same array may be used again
+*
+*******************************************************************************/
+unsigned int hd44780InstructionInitAll(HD44780INIT * const displays,
+                                       unsigned char       numberOfDisplays)
+{
+    HD44780INIT * display;
+    unsigned char counter;
+                                        /* Earliest time any display needs    */
+                                        /* calling again                      */
+    unsigned int nextWait = 0;
+    unsigned char waiting = 0;
+                                        /* Carry out the next step of each    */
+                                        /* display that is due                */
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+
+        if (display->initDone)
+        {
+            continue;
+        }
+
+        if (display->waitTime == 0)
+        {
+            display->waitTime = hd44780InstructionInit(display->hHd44780,
+                                                   display->hd44780Clone,
+                                                   display->functionSet,
+                                                   display->displayOnOffControl,
+                                                   display->entryModeSet);
+            if (display->waitTime == 0)
+            {
+                display->initDone = 1;
+                continue;
+            }
+                                        /* 1 means call again, not wait 1us   */
+            if (display->waitTime == 1)
+            {
+                display->waitTime = 0;
+            }
+        }
+
+        if (!waiting || display->waitTime < nextWait)
+        {
+            nextWait = display->waitTime;
+        }
+        waiting = 1;
+    }
+                                        /* All done; leave the array ready to */
+                                        /* be used again                      */
+    if (!waiting)
+    {
+        for (counter = 0; counter < numberOfDisplays; counter++)
+        {
+            displays[counter].initDone = 0;
+        }
+        return 0;
+    }
+                                        /* At least one display wants calling */
+                                        /* again straight away                */
+    if (nextWait == 0)
+    {
+        return 1;
+    }
+                                        /* A 1us wait can't be returned as it */
+                                        /* means call again; wait 2us instead */
+    if (nextWait == 1)
+    {
+        nextWait = 2;
+    }
+                                        /* The caller will now wait, so take  */
+                                        /* the wait off every display         */
+    for (counter = 0; counter < numberOfDisplays; counter++)
+    {
+        display = &displays[counter];
+
+        if (display->waitTime > nextWait)
+        {
+            display->waitTime -= nextWait;
+        }
+        else
+        {
+            display->waitTime = 0;
+        }
+    }
+
+    return nextWait;
+}
+
+/*******************************************************************************
+* hd44780SetTimedMode()
+*
+* Summary: 
+*   Selects whether the module polls the busy flag of this display or simply
+*   waits for each instruction's execution time to pass
+*
+* See also:
+*   hd44780InstructionInit(), hd44780SetBroadcastMode()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   hd44780Clone        - chipset, which selects the execution times used
+*   pGetMicroseconds    - pointer to a function returning a free running
+*                         microsecond count, or NULL to poll the busy flag
+*
+* Returns: 
+*   - 1  	        - mode selected
+*   - 0             - HD44780 object is not open or clone is unknown
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. In timed mode the busy flag is never read, halving the bus transactions
+*    needed for each character, and the display may be wired with RW tied low.
+*    hd44780ReadAddr() and hd44780ReadChar() still need RW to be connected
+* 2. The count may wrap at any power of two, e.g. a free running 16-bit timer
+*    clocked at 1MHz, as only differences between two readings are used
+* 3. The execution times are for the controllers' nominal oscillator frequency
+*    (270kHz for the HD44780U). A time source running slightly slow, e.g.
+*    0.9us per count, gives margin for displays clocked below nominal
+* 4. Select timed mode before calling hd44780InstructionInit(). If selected
+*    later, the first write waits as long as a Clear Display to be safe
+*
+*******************************************************************************/
+unsigned char hd44780SetTimedMode(HHD44780 const   hHd44780,
+                                  HD44780CLONE     hd44780Clone,
+                                  unsigned int     (*pGetMicroseconds)(void))
+{
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if ((hHd44780->hd44780Flags & HD44780_OPEN) &&
+        (unsigned int) hd44780Clone < sizeof(hd44780ExecutionTimes) /
+                                      sizeof(hd44780ExecutionTimes[0]))
+    {
+        hHd44780->hd44780Clone = hd44780Clone;
+        hHd44780->pGetMicroseconds = pGetMicroseconds;
+        hHd44780->hd44780Flags &= ~HD44780_TIMEDWAIT;
+                                        /* We don't know what the display is  */
+                                        /* doing, so assume the worst         */
+        if (pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            hHd44780->lastWriteTime = pGetMicroseconds();
+            hHd44780->executionTime = hd44780ExecutionTimes[hd44780Clone][1];
+            hHd44780->hd44780Flags |= HD44780_TIMEDWAIT;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780SetBroadcastMode()
+*
+* Summary: 
+*   Sets up an HD44780 object opened on a broadcast LCD interface, so that each
+*   write reaches every display in the group at once
+*
+* See also:
+*   hd44780SetTimedMode(), lcdifCreateBroadcast()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   hd44780Clones       - chipset of each display in the group
+*   numberOfClones      - number of entries in hd44780Clones
+*   pGetMicroseconds    - pointer to a function returning a free running
+*                         microsecond count
+*
+* Returns: 
+*   - 1  	        - mode selected
+*   - 0             - HD44780 object is not open, no time source or clones
+*                     were given, or a clone is unknown
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. The busy flag can't be read through a broadcast interface, so timed mode
+*    is always used, with the execution times of the slowest chipset given
+* 2. Initialise each display through its own interface first, e.g. with
+*    hd44780InstructionInitAll(). Only writes work on the broadcast object;
+*    hd44780ReadAddr() and hd44780ReadChar() fail
+* 3. A write on a display's own object leaves the others in the group behind,
+*    so call this again after using one to restart the timing safely
+*
+*******************************************************************************/
+unsigned char hd44780SetBroadcastMode(HHD44780 const   hHd44780,
+                                      const HD44780CLONE * hd44780Clones,
+                                      unsigned char    numberOfClones,
+                                      unsigned int     (*pGetMicroseconds)(void))
+{
+    HD44780CLONE  slowestClone;
+    unsigned char index;
+
+    if (pGetMicroseconds == (unsigned int (*)(void)) 0 || numberOfClones == 0)
+    {
+        return 0;
+    }
+                                        /* Find the chipset with the longest  */
+                                        /* execution times                    */
+    slowestClone = hd44780Clones[0];
+    for (index = 0; index < numberOfClones; index++)
+    {
+        if ((unsigned int) hd44780Clones[index] >=
+                                        sizeof(hd44780ExecutionTimes) /
+                                        sizeof(hd44780ExecutionTimes[0]))
+        {
+            return 0;
+        }
+        if (hd44780ExecutionTimes[hd44780Clones[index]][0] >
+                                    hd44780ExecutionTimes[slowestClone][0] ||
+            hd44780ExecutionTimes[hd44780Clones[index]][1] >
+                                    hd44780ExecutionTimes[slowestClone][1])
+        {
+            slowestClone = hd44780Clones[index];
+        }
+    }
+
+    return hd44780SetTimedMode(hHd44780, slowestClone, pGetMicroseconds);
+}
+
+/*******************************************************************************
+* hd44780AttachGeometry()
+*
+* Summary: 
+*   Tells an HD44780 object how the rows and columns of its display map onto
+*   DDRAM, so that it can be written by position
+*
+* See also:
+*   hd44780SetCursorPos(), hd44780WriteAt()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   geometry            - one of the hd44780Geometry descriptors, a
+*                         descriptor of the caller's own, or NULL to detach
+*                         the current geometry
+*
+* Returns: 
+*   - 1  	        - geometry attached or detached
+*   - 0             - HD44780 object is not open or the geometry is invalid
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. The descriptor and its row address table are not copied, so they must
+*    remain valid while attached
+* 2. A geometry may have up to HD44780_MAXCOLUMNS columns and the columns
+*    must split into whole segments
+*
+*******************************************************************************/
+unsigned char hd44780AttachGeometry(HHD44780 const         hHd44780,
+                                    const HD44780GEOMETRY * geometry)
+{
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN))
+    {
+        return 0;
+    }
+                                        /* Check the geometry makes sense     */
+    if (geometry != (HD44780GEOMETRY *) 0 &&
+        (geometry->rows == 0 || geometry->columns == 0 ||
+         geometry->columns > HD44780_MAXCOLUMNS ||
+         geometry->segmentColumns == 0 ||
+         geometry->columns % geometry->segmentColumns != 0 ||
+         geometry->rowAddresses == (const unsigned char *) 0))
+    {
+        return 0;
+    }
+
+    hHd44780->geometry = geometry;
+    return 1;
+}
+
+/*******************************************************************************
+* hd44780AttachShadow()
+*
+* Summary: 
+*   Gives an HD44780 object a shadow buffer so that frames can be sent with
+*   hd44780CommitFrame()
+*
+* See also:
+*   hd44780CommitFrame()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   shadowBuffer        - HD44780_SHADOWSIZE bytes of RAM owned by the caller,
+*                         or NULL to detach the current shadow buffer
+*
+* Returns: 
+*   - 1  	        - shadow buffer attached or detached
+*   - 0             - HD44780 object is not open
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. The contents of the display are not known when the buffer is attached, so
+*    the first frame committed is always sent in full
+* 2. The buffer must not be modified by the caller while it is attached
+*
+*******************************************************************************/
+unsigned char hd44780AttachShadow(HHD44780 const   hHd44780,
+                                  unsigned char *  shadowBuffer)
+{
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if (hHd44780->hd44780Flags & HD44780_OPEN)
+    {
+        hHd44780->shadowBuffer = shadowBuffer;
+        hHd44780->hd44780Flags &= ~(HD44780_SHADOWVALID |
+                                    HD44780_SHADOWRESUME);
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780CommitFrame()
+*
+* Summary: 
+*   Brings the display up to date with a complete frame, sending only the
+*   characters that differ from what is already on the display
+*
+* See also:
+*   hd44780AttachShadow()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   frame               - HD44780_SHADOWSIZE characters; cells 0 to 39 are the
+*                         first line and cells 40 to 79 the second
+*
+* Returns: 
+*   - 1  	        - display now shows frame
+*   - 0             - command not complete (most likely bus busy); call again
+*                     with the same frame to carry on
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. A shadow buffer must have been attached with hd44780AttachShadow()
+* 2. Each run of changed characters costs one Set DDRAM Address instruction.
+*    Runs separated by no more than HD44780_SHADOWBRIDGE unchanged characters
+*    are sent as one run. The address counter's jump from 0x27 to 0x40 lets a
+*    run continue from the end of the first line onto the second
+* 3. The display must be in 2-line mode, incrementing, without display shift.
+*    The cursor is left after the last character written
+* 4. hd44780ClearDisplay() keeps the shadow buffer valid. hd44780WriteChar()
+*    and hd44780WriteRAMString() invalidate it, so the next frame is sent in
+*    full
+* 5. If 0 is returned, call again with the same frame to carry on from where
+*    the address counter was left. The module remembers that position itself,
+*    so the address counter is never read and write-only wiring is supported.
+*    Any other function that writes to or reads from the display in between
+*    makes the next call set the DDRAM address again
+* 6. When carried out by hd44780Tick() or hd44780ServiceAll(), one
+*    instruction or character is written per call
+*
+*******************************************************************************/
+unsigned char hd44780CommitFrame(HHD44780 const         hHd44780,
+                                 const unsigned char *  frame)
+{
+    unsigned char returnValue = 0;
+    unsigned char index;
+    unsigned char lookAhead;
+    unsigned char cursor = HD44780_SHADOWNOCURSOR;
+                                        /* Cell the address counter points to */
+    unsigned char * shadow;
+                                        /* Check LCD interface is actually    */
+    	                                /* open and has a shadow buffer       */
+    if ((hHd44780->hd44780Flags & HD44780_OPEN) &&
+        hHd44780->shadowBuffer != (unsigned char *) 0)
+    {
+        shadow = hHd44780->shadowBuffer;
+                                        /* First get the bus                  */
+        if (hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+        {
+                                        /* If the shadow can't be trusted,    */
+                                        /* make every cell differ from frame  */
+            if (!(hHd44780->hd44780Flags & HD44780_SHADOWVALID))
+            {
+                for (index = 0; index < HD44780_SHADOWSIZE; index++)
+                {
+                    shadow[index] = ~frame[index];
+                }
+                hHd44780->hd44780Flags |= HD44780_SHADOWVALID;
+            }
+
+                                        /* Carrying on from an earlier call;  */
+                                        /* the AC is where we left it         */
+            if (hHd44780->hd44780Flags & HD44780_SHADOWRESUME)
+            {
+                cursor = hHd44780->shadowCursor;
+            }
+
+            for (index = 0; index < HD44780_SHADOWSIZE; index++)
+            {
+                if (frame[index] == shadow[index])
+                {
+                                        /* Unchanged; only rewrite it if the  */
+                                        /* cursor is here and another change  */
+                                        /* follows closely                    */
+                    if (cursor != index)
+                    {
+                        continue;
+                    }
+                    for (lookAhead = index + 1;
+                         lookAhead <= index + HD44780_SHADOWBRIDGE &&
+                         lookAhead < HD44780_SHADOWSIZE &&
+                         frame[lookAhead] == shadow[lookAhead];
+                         lookAhead++);
+                    if (lookAhead > index + HD44780_SHADOWBRIDGE ||
+                        lookAhead >= HD44780_SHADOWSIZE)
+                    {
+                        continue;
+                    }
+                }
+                                        /* Jump to the start of a new run     */
+                if (cursor != index)
+                {
+                                        /* Check busy bit                     */
+                    if (isHD44780Busy(hHd44780))
+                    {
+                        goto frame_not_complete;
+                    }
+                    if (index < HD44780_SHADOWLINELENGTH)
+                    {
+                        writeHD44780Instr(hHd44780, HD44780_SETDDRAMADDRESS &
+                                                    (0x80 | index));
+                    }
+                    else
+                    {
+                        writeHD44780Instr(hHd44780, HD44780_SETDDRAMADDRESS &
+                                                    (0xC0 | (index -
+                                                    HD44780_SHADOWLINELENGTH)));
+                    }
+                    cursor = index;
+                                        /* One write per tick                 */
+                    if (hd44780Ticking)
+                    {
+                        goto frame_not_complete;
+                    }
+                }
+                                        /* Check busy bit                     */
+                if (isHD44780Busy(hHd44780))
+                {
+                    goto frame_not_complete;
+                }
+                writeHD44780Data(hHd44780, frame[index]);
+                shadow[index] = frame[index];
+                cursor++;
+                if (hd44780Ticking)
+                {
+                    goto frame_not_complete;
+                }
+            }
+            hHd44780->hd44780Flags &= ~HD44780_SHADOWRESUME;
+            returnValue = 1;
+frame_not_complete:
+                                        /* Note the AC for the next call; any */
+                                        /* other write in between clears the  */
+                                        /* flag again                         */
+            if (returnValue == 0 && cursor != HD44780_SHADOWNOCURSOR)
+            {
+                hHd44780->hd44780Flags |= HD44780_SHADOWRESUME;
+            }
+            hHd44780->shadowCursor = cursor;
+                                        /* Return the bus                     */
+            hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+        }
+    }
+
+    return returnValue;
+}
+
+/*******************************************************************************
+* hd44780AttachGlyphCache()
+*
+* Summary: 
+*   Gives an HD44780 object a glyph cache so that frames using more custom
+*   characters than the CGRAM holds can be sent with hd44780CommitGlyphFrame()
+*
+* See also:
+*   hd44780CommitGlyphFrame(), hd44780PinGlyph()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   glyphCache          - glyph cache owned by the caller, or NULL to detach
+*                         the current glyph cache
+*   glyphs              - table of glyphs, each 8 rows of 5 dots with the
+*                         leftmost dot in bit 4
+*   numberOfGlyphs      - number of glyphs in the table (at most 255)
+*
+* Returns: 
+*   - 1  	        - glyph cache attached or detached
+*   - 0             - HD44780 object is not open or glyphs is NULL
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. The CGRAM contents are not known when the cache is attached, so every
+*    glyph is loaded the first time a frame uses it
+* 2. The cache and glyph table must not be modified by the caller while the
+*    cache is attached. On a Harvard architecture PIC the table must lie in
+*    SRAM
+* 3. hd44780SetCGRAMAddr() and hd44780WriteCGRAM() change CGRAM behind the
+*    cache's back; attach the cache again after using them.
+*    hd44780WriteCGRAMBlock() frees the characters it writes in the cache,
+*    so a glyph they held is loaded again when a frame next uses it
+*
+*******************************************************************************/
+unsigned char hd44780AttachGlyphCache(HHD44780 const        hHd44780,
+                                      HD44780GLYPHCACHE *   glyphCache,
+                                      const unsigned char   (* glyphs)
+                                                            [CGRAMFONT_5X8],
+                                      unsigned char         numberOfGlyphs)
+{
+    unsigned char slot;
+    unsigned char index;
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if ((hHd44780->hd44780Flags & HD44780_OPEN) &&
+        (glyphCache == (HD44780GLYPHCACHE *) 0 ||
+         glyphs != (const unsigned char (*)[CGRAMFONT_5X8]) 0))
+    {
+        if (glyphCache != (HD44780GLYPHCACHE *) 0)
+        {
+            glyphCache->glyphs = glyphs;
+            glyphCache->numberOfGlyphs = numberOfGlyphs;
+                                        /* Every character is free; list them */
+                                        /* so that character 0 is used first  */
+            for (slot = 0; slot < HD44780_GLYPHSLOTS; slot++)
+            {
+                glyphCache->slotGlyph[slot] = HD44780_NOGLYPH;
+                glyphCache->lruSlots[slot] = HD44780_GLYPHSLOTS - 1 - slot;
+            }
+            glyphCache->pinnedSlots = 0;
+            glyphCache->uploadSlots = 0;
+            glyphCache->uploadRow = 0;
+            glyphCache->frameMapped = 0;
+            for (index = 0; index < HD44780_SHADOWSIZE; index++)
+            {
+                glyphCache->frame[index] = ' ';
+            }
+            glyphCache->uploads = 0;
+        }
+        hHd44780->glyphCache = glyphCache;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780PinGlyph()
+*
+* Summary: 
+*   Keeps a glyph in CGRAM whether or not frames use it, or releases it again
+*
+* See also:
+*   hd44780AttachGlyphCache(), hd44780CommitGlyphFrame()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   glyph               - number of the glyph in the glyph table
+*   pin                 - 1 to pin the glyph, 0 to release it
+*
+* Returns: 
+*   - 1  	        - glyph pinned or released
+*   - 0             - HD44780 object is not open, has no glyph cache, glyph
+*                     is not in the table, or no CGRAM character is free
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. The bus is not touched. A glyph that is not already in CGRAM is loaded by
+*    the next call of hd44780CommitGlyphFrame()
+* 2. A glyph is only pinned into a CGRAM character that is not pinned and not
+*    used by the last frame committed, so what is on the display never
+*    changes. Pin glyphs before they are needed, e.g. at start-up
+* 3. Each pinned glyph leaves one character fewer for the glyphs of frames
+*
+*******************************************************************************/
+unsigned char hd44780PinGlyph(HHD44780 const    hHd44780,
+                              unsigned char     glyph,
+                              unsigned char     pin)
+{
+    HD44780GLYPHCACHE * glyphCache;
+    unsigned char keepSlots;            /* Characters that mustn't be reused  */
+    unsigned char slot;
+    unsigned char index;
+                                        /* Check LCD interface is actually    */
+    	                                /* open and has a glyph cache         */
+    if ((hHd44780->hd44780Flags & HD44780_OPEN) &&
+        hHd44780->glyphCache != (HD44780GLYPHCACHE *) 0 &&
+        glyph < hHd44780->glyphCache->numberOfGlyphs)
+    {
+        glyphCache = hHd44780->glyphCache;
+        if (!pin)
+        {
+            for (slot = 0; slot < HD44780_GLYPHSLOTS; slot++)
+            {
+                if (glyphCache->slotGlyph[slot] == glyph)
+                {
+                    glyphCache->pinnedSlots &= ~(0x01 << slot);
+                }
+            }
+            return 1;
+        }
+                                        /* Keep the characters on the display */
+        keepSlots = glyphCache->pinnedSlots;
+        for (index = 0; index < HD44780_SHADOWSIZE; index++)
+        {
+            if (glyphCache->frame[index] < HD44780_GLYPHSLOTS)
+            {
+                keepSlots |= 0x01 << glyphCache->frame[index];
+            }
+        }
+        slot = mapHD44780Glyph(glyphCache, glyph, keepSlots);
+        if (slot < HD44780_GLYPHSLOTS)
+        {
+            glyphCache->pinnedSlots |= 0x01 << slot;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780CommitGlyphFrame()
+*
+* Summary: 
+*   Brings the display up to date with a complete frame that may use any of
+*   the glyphs of the glyph table, loading into CGRAM only those glyphs that
+*   are not already there
+*
+* See also:
+*   hd44780AttachGlyphCache(), hd44780PinGlyph(), hd44780CommitFrame()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   frame               - HD44780_SHADOWSIZE cells laid out as for
+*                         hd44780CommitFrame(); each a character code, or a
+*                         glyph given by HD44780_GLYPH()
+*
+* Returns: 
+*   - 1  	        - display now shows frame
+*   - 0             - command not complete (most likely bus busy); call again
+*                     with the same frame to carry on
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. A shadow buffer and a glyph cache must have been attached with
+*    hd44780AttachShadow() and hd44780AttachGlyphCache()
+* 2. Glyphs the frame uses that are already in CGRAM stay where they are.
+*    Each of the others is loaded into a character that is neither pinned
+*    nor used by the frame, taking a free one first and otherwise the least
+*    recently used, passing over those the last frame committed shows while
+*    any other is left. A frame using no more glyphs than there are unpinned
+*    characters is therefore shown with one load per glyph not yet in CGRAM,
+*    and with none when it is. Glyphs beyond that are shown as
+*    HD44780_GLYPHMISSING
+* 3. Each load costs a Set CGRAM Address instruction, skipped when the
+*    previous load ended at the right address, and 8 data writes. The frame
+*    itself is then sent by hd44780CommitFrame(), so only changed cells are
+*    written. A cell whose glyph was replaced changes on the display as soon
+*    as the new glyph is loaded. A glyph is never loaded into a character the
+*    new frame uses, but if the last frame's characters have to be reused,
+*    its cells show the new glyph until they are rewritten; many ticks when
+*    carried out by hd44780Tick()
+* 4. The same conditions as for hd44780CommitFrame() apply, and also the
+*    display must be in 5x8 dot mode. Character codes 0x00 to 0x0F in the
+*    frame show whatever glyph the cache last loaded into that character
+* 5. When carried out by hd44780Tick() or hd44780ServiceAll(), one
+*    instruction or byte is written per call
+*
+*******************************************************************************/
+unsigned char hd44780CommitGlyphFrame(HHD44780 const         hHd44780,
+                                      const HD44780CELL *    frame)
+{
+    HD44780GLYPHCACHE * glyphCache;
+    unsigned char keepSlots;            /* Characters the frame uses          */
+    unsigned char shownSlots;           /* Characters on the display          */
+    unsigned char slot;
+    unsigned char index;
+    unsigned char done;
+                                        /* Check LCD interface is actually    */
+    	                                /* open and has a glyph cache         */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        hHd44780->glyphCache == (HD44780GLYPHCACHE *) 0)
+    {
+        return 0;
+    }
+    glyphCache = hHd44780->glyphCache;
+                                        /* Map the frame to character codes   */
+                                        /* once, on the first call            */
+    if (!glyphCache->frameMapped)
+    {
+                                        /* Keep the glyphs already loaded     */
+                                        /* first, so that none of them is     */
+                                        /* replaced by another of the frame,  */
+                                        /* and note those on the display      */
+        keepSlots = 0;
+        shownSlots = 0;
+        for (index = 0; index < HD44780_SHADOWSIZE; index++)
+        {
+            if (glyphCache->frame[index] < HD44780_GLYPHSLOTS)
+            {
+                shownSlots |= 0x01 << glyphCache->frame[index];
+            }
+            if (frame[index] > 0xFF &&
+                (unsigned char) frame[index] < glyphCache->numberOfGlyphs)
+            {
+                for (slot = 0; slot < HD44780_GLYPHSLOTS; slot++)
+                {
+                    if (glyphCache->slotGlyph[slot] ==
+                                            (unsigned char) frame[index])
+                    {
+                        keepSlots |= 0x01 << slot;
+                    }
+                }
+            }
+        }
+        for (index = 0; index < HD44780_SHADOWSIZE; index++)
+        {
+            if (frame[index] <= 0xFF)
+            {
+                glyphCache->frame[index] = (unsigned char) frame[index];
+                continue;
+            }
+            slot = HD44780_GLYPHSLOTS;
+            if ((unsigned char) frame[index] < glyphCache->numberOfGlyphs)
+            {
+                                        /* Only reuse a character on the      */
+                                        /* display if no other is left        */
+                slot = mapHD44780Glyph(glyphCache,
+                                       (unsigned char) frame[index],
+                                       keepSlots | shownSlots);
+                if (slot == HD44780_GLYPHSLOTS)
+                {
+                    slot = mapHD44780Glyph(glyphCache,
+                                           (unsigned char) frame[index],
+                                           keepSlots);
+                }
+            }
+            if (slot < HD44780_GLYPHSLOTS)
+            {
+                keepSlots |= 0x01 << slot;
+                glyphCache->frame[index] = slot;
+            }
+            else
+            {
+                glyphCache->frame[index] = HD44780_GLYPHMISSING;
+            }
+        }
+        glyphCache->frameMapped = 1;
+    }
+                                        /* Load the glyphs not yet in CGRAM   */
+    if (glyphCache->uploadSlots != 0)
+    {
+        done = 0;
+                                        /* First get the bus                  */
+        if (hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+        {
+            done = uploadHD44780Glyphs(hHd44780);
+                                        /* Return the bus                     */
+            hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+        }
+                                        /* One write per tick                 */
+        if (!done || hd44780Ticking)
+        {
+            return 0;
+        }
+    }
+
+    if (hd44780CommitFrame(hHd44780, glyphCache->frame))
+    {
+        glyphCache->frameMapped = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780AttachVirtual()
+*
+* Summary: 
+*   Puts two open HD44780 objects behind one virtual display, such as the top
+*   and bottom halves of a 40x4 module
+*
+* See also:
+*   hd44780SetVirtualCursorPos(), hd44780WriteVirtualAt(),
+*   hd44780CommitVirtualFrame()
+*
+* Arguments: 
+*   virtualDisplay      - virtual display object owned by the caller
+*   hTopHd44780         - handle to the open HD44780 driving rows 0 and 1
+*   hBottomHd44780      - handle to the open HD44780 driving rows 2 and 3
+*
+* Returns: 
+*   - 1  	        - virtual display set up
+*   - 0             - an HD44780 object is not open, or both are the same
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Both HD44780 objects are given the hd44780Geometry40x2 geometry
+* 2. The two controllers normally share the bus through two LCD interfaces
+*    with their own E pins on one parallel bus interface. While one controller
+*    is executing an instruction the bus is free to write to the other
+*
+*******************************************************************************/
+unsigned char hd44780AttachVirtual(HD44780VIRTUAL * const virtualDisplay,
+                                   HHD44780 const         hTopHd44780,
+                                   HHD44780 const         hBottomHd44780)
+{
+                                        /* Check both LCD interfaces are      */
+    	                                /* actually open                      */
+    if (!(hTopHd44780->hd44780Flags & HD44780_OPEN) ||
+        !(hBottomHd44780->hd44780Flags & HD44780_OPEN) ||
+        hTopHd44780 == hBottomHd44780)
+    {
+        return 0;
+    }
+
+    hd44780AttachGeometry(hTopHd44780, &hd44780Geometry40x2);
+    hd44780AttachGeometry(hBottomHd44780, &hd44780Geometry40x2);
+    virtualDisplay->hHd44780[0] = hTopHd44780;
+    virtualDisplay->hHd44780[1] = hBottomHd44780;
+
+    return 1;
+}
+
+/*******************************************************************************
+* hd44780SetVirtualCursorPos()
+*
+* Summary: 
+*   Moves the cursor of the controller driving a row of a virtual display to
+*   a row and column
+*
+* See also:
+*   hd44780AttachVirtual(), hd44780SetCursorPos()
+*
+* Arguments: 
+*   virtualDisplay      - virtual display set up with hd44780AttachVirtual()
+*   row                 - row to move to, 0 to 3
+*   column              - column to move to, 0 to 39
+*
+* Returns: 
+*   - 1  	        - command was completed successfully
+*   - 0             - command couldn't complete (most likely bus busy) or the
+*                     position is off the display
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Each controller keeps its own cursor; turn the cursor on with
+*    hd44780DisplayControl() on the controller it should be shown by
+*
+*******************************************************************************/
+unsigned char hd44780SetVirtualCursorPos(HD44780VIRTUAL * const virtualDisplay,
+                                         unsigned char          row,
+                                         unsigned char          column)
+{
+    if (row >= HD44780_VIRTUALCONTROLLERS * HD44780_VIRTUALROWS)
+    {
+        return 0;
+    }
+
+    return hd44780SetCursorPos(
+                virtualDisplay->hHd44780[row / HD44780_VIRTUALROWS],
+                row % HD44780_VIRTUALROWS, column);
+}
+
+/*******************************************************************************
+* hd44780WriteVirtualAt()
+*
+* Summary: 
+*   Writes characters to a row of a virtual display starting at the given
+*   column, dropping any that fall off the end of the row
+*
+* See also:
+*   hd44780AttachVirtual(), hd44780WriteAt()
+*
+* Arguments: 
+*   virtualDisplay      - virtual display set up with hd44780AttachVirtual()
+*   row                 - row to write to, 0 to 3
+*   column              - column of the first character, 0 to 39
+*   characters          - characters to write
+*   length              - number of characters to write
+*   written             - 0 to start writing, or the value returned by the
+*                         previous call to carry on
+*
+* Returns: 
+*   Progress of the write, to be passed back as written; the write is complete
+*   when this is length
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. The write goes to the controller driving the row through
+*    hd44780WriteAt(), whose notes apply
+*
+*******************************************************************************/
+unsigned char hd44780WriteVirtualAt(HD44780VIRTUAL * const virtualDisplay,
+                                    unsigned char          row,
+                                    unsigned char          column,
+                                    const unsigned char *  characters,
+                                    unsigned char          length,
+                                    unsigned char          written)
+{
+                                        /* Rows off the display are dropped   */
+    if (row >= HD44780_VIRTUALCONTROLLERS * HD44780_VIRTUALROWS)
+    {
+        return length;
+    }
+
+    return hd44780WriteAt(virtualDisplay->hHd44780[row / HD44780_VIRTUALROWS],
+                          row % HD44780_VIRTUALROWS, column, characters,
+                          length, written);
+}
+
+/*******************************************************************************
+* hd44780CommitVirtualFrame()
+*
+* Summary: 
+*   Brings a virtual display up to date with a complete frame, alternating
+*   writes between its controllers so that each one's execution time is
+*   spent writing to the other
+*
+* See also:
+*   hd44780AttachVirtual(), hd44780CommitFrame()
+*
+* Arguments: 
+*   virtualDisplay      - virtual display set up with hd44780AttachVirtual()
+*   frame               - HD44780_VIRTUALFRAMESIZE characters; 40 for each
+*                         row, top row first
+*
+* Returns: 
+*   - 1  	        - display now shows frame
+*   - 0             - command not complete (most likely bus busy); call again
+*                     with the same frame to carry on
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Each controller must have a shadow buffer attached with
+*    hd44780AttachShadow(). Only changed characters are sent, as for
+*    hd44780CommitFrame(), whose notes apply to each controller
+* 2. Each controller's half of frame is written one instruction or character
+*    at a time in turn, the same way hd44780ServiceAll() shares the bus out.
+*    A full refresh takes about half as long as committing the halves one
+*    after the other
+* 3. If both controllers are in timed mode the call waits out the execution
+*    times and returns once the whole frame is sent. In busy flag mode, or if
+*    a controller can't get the bus, each controller is written at most once
+*    per call
+* 4. A hd44780Tick() interrupting the call leaves it writing one instruction
+*    or character at a time
+*
+*******************************************************************************/
+unsigned char hd44780CommitVirtualFrame(HD44780VIRTUAL * const virtualDisplay,
+                                        const unsigned char *  frame)
+{
+    unsigned char controller;
+    unsigned char pending = 0;          /* Bitmap of halves not yet sent      */
+    unsigned char timed = 1;            /* Cleared to make a single round     */
+    unsigned char wasTicking = hd44780Ticking;
+    HHD44780 hHd44780;
+                                        /* Check every controller is open and */
+                                        /* has a shadow buffer                */
+    for (controller = 0; controller < HD44780_VIRTUALCONTROLLERS; controller++)
+    {
+        hHd44780 = virtualDisplay->hHd44780[controller];
+        if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+            hHd44780->shadowBuffer == (unsigned char *) 0)
+        {
+            return 0;
+        }
+        if (hHd44780->pGetMicroseconds == (unsigned int (*)(void)) 0)
+        {
+            timed = 0;
+        }
+        pending |= 0x01 << controller;
+    }
+                                        /* One write per controller in turn   */
+    hd44780Ticking = 1;
+    do
+    {
+        for (controller = 0; controller < HD44780_VIRTUALCONTROLLERS;
+             controller++)
+        {
+            hHd44780 = virtualDisplay->hHd44780[controller];
+            if (!(pending & (0x01 << controller)))
+            {
+                continue;
+            }
+                                        /* If the bus has been taken, finish  */
+                                        /* this round and return rather than  */
+                                        /* wait for it                        */
+            if (!hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+            {
+                timed = 0;
+                continue;
+            }
+            hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+            if (hd44780CommitFrame(hHd44780,
+                                   frame + controller * HD44780_SHADOWSIZE))
+            {
+                pending &= ~(0x01 << controller);
+            }
+        }
+    }
+    while (pending != 0 && timed);
+    hd44780Ticking = wasTicking;
+
+    return pending == 0;
+}
+
+/*******************************************************************************
+* hd44780AttachQueue()
+*
+* Summary: 
+*   Gives an HD44780 object a command queue so that commands can be queued with
+*   hd44780Enqueue() and carried out later by hd44780Service()
+*
+* See also:
+*   hd44780Enqueue(), hd44780Service(), hd44780IsDone()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   queue               - array of queueSize entries owned by the caller, or
+*                         NULL to detach the current queue
+*   queueSize           - number of entries in queue (1 to 255)
+*   pCommandDone        - function to call as each queued command completes,
+*                         or NULL if completion is checked with hd44780IsDone()
+*
+* Returns: 
+*   - 1  	        - queue attached or detached
+*   - 0             - HD44780 object is not open or queueSize is 0
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Any commands still in a previously attached queue are discarded
+* 2. The queue must not be modified by the caller while it is attached
+* 3. If hd44780Tick() is running from an interrupt, attach or detach the
+*    queue before the interrupt is enabled or with it disabled
+*
+*******************************************************************************/
+unsigned char hd44780AttachQueue(HHD44780 const     hHd44780,
+                                 HD44780CMD *       queue,
+                                 unsigned char      queueSize,
+                                 void (*pCommandDone)(HHD44780 const,
+                                                      HD44780SEQ))
+{
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if ((hHd44780->hd44780Flags & HD44780_OPEN) &&
+        (queue == (HD44780CMD *) 0 || queueSize != 0))
+    {
+        hHd44780->queue = queue;
+        hHd44780->queueSize = queueSize;
+        hHd44780->queueHead = 0;
+        hHd44780->queueTail = 0;
+        hHd44780->queueAdded = 0;
+        hHd44780->queueRemoved = 0;
+        hHd44780->pCommandDone = pCommandDone;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780Enqueue()
+*
+* Summary: 
+*   Adds a command to the end of a display's command queue without touching
+*   the bus
+*
+* See also:
+*   hd44780AttachQueue(), hd44780Service(), hd44780IsDone()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   command             - command to queue
+*   value               - argument of the command, e.g. the entry mode for
+*                         CMD_ENTRYMODESET or the font for CMD_WRITECGRAM
+*   data                - string, CGRAM data or frame for CMD_WRITERAMSTRING,
+*                         CMD_WRITECGRAM and CMD_COMMITFRAME, otherwise NULL.
+*                         For CMD_COMMITGLYPHFRAME, the HD44780CELL frame cast
+*                         to const unsigned char *
+*
+* Returns: 
+*   - >0  	        - sequence number issued to the command
+*   - 0             - command couldn't be queued (no queue attached, queue
+*                     full, or data missing)
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. data is not copied; it must stay unchanged until the command completes
+* 2. May be called while hd44780Service() or hd44780Tick() is servicing the
+*    same display from an interrupt, as each side only changes its own count
+*    of the commands. It must not itself be called from more than one
+*    context at once, other than from the pCommandDone function
+*
+*******************************************************************************/
+HD44780SEQ hd44780Enqueue(HHD44780 const          hHd44780,
+                          HD44780COMMAND          command,
+                          unsigned char           value,
+                          const unsigned char *   data)
+{
+    unsigned char tail;                 /* Entry to store the command in      */
+
+                                        /* Check LCD interface is actually    */
+    	                                /* open and has room in its queue     */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        hHd44780->queue == (HD44780CMD *) 0 ||
+        (unsigned char) (hHd44780->queueAdded - hHd44780->queueRemoved) ==
+                                                        hHd44780->queueSize)
+    {
+        goto cannot_enqueue;
+    }
+                                        /* These commands need something to   */
+                                        /* write                              */
+    if ((command == CMD_WRITERAMSTRING || command == CMD_WRITECGRAM ||
+         command == CMD_COMMITFRAME || command == CMD_COMMITGLYPHFRAME) &&
+        data == (const unsigned char *) 0)
+    {
+        goto cannot_enqueue;
+    }
+    tail = hHd44780->queueTail;
+                                        /* Issue the next sequence number,    */
+                                        /* skipping 0                         */
+    hHd44780->lastSequence = (hHd44780->lastSequence + 1) & 0xFFFF;
+    if (hHd44780->lastSequence == 0)
+    {
+        hHd44780->lastSequence = 1;
+    }
+
+    hHd44780->queue[tail].data = data;
+    hHd44780->queue[tail].sequence = hHd44780->lastSequence;
+    hHd44780->queue[tail].command = (unsigned char) command;
+    hHd44780->queue[tail].value = value;
+    tail++;
+    if (tail == hHd44780->queueSize)
+    {
+        tail = 0;
+    }
+    hHd44780->queueTail = tail;
+                                        /* Only now can hd44780Service() see  */
+                                        /* the command                        */
+    hHd44780->queueAdded++;
+
+    return hHd44780->lastSequence;
+
+cannot_enqueue:
+                                        /* Couldn't queue the command         */
+    return 0;
+}
+
+/*******************************************************************************
+* hd44780Service()
+*
+* Summary: 
+*   Carries out as many queued commands as the display can accept right now,
+*   oldest first, without waiting for the display
+*
+* See also:
+*   hd44780AttachQueue(), hd44780Enqueue(), hd44780IsDone()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*
+* Returns: 
+*   - 1  	        - queue is empty
+*   - 0             - commands are still queued (most likely bus busy); call
+*                     again later
+*
+* Callers: 
+*   User application, typically from its main loop, hd44780Tick()
+*
+* Notes : 
+* 1. The pCommandDone function given to hd44780AttachQueue() is called once
+*    for each command completed, after it has left the queue, and may queue
+*    further commands
+* 2. Don't call the other API functions on a display while it has commands
+*    queued, as they would be carried out ahead of the queue
+* 3. Don't call this function for a display that hd44780Tick() services
+*
+*******************************************************************************/
+unsigned char hd44780Service(HHD44780 const hHd44780)
+{
+    HD44780CMD * command;               /* Oldest queued command              */
+    HD44780SEQ sequence;                /* Its sequence number                */
+    unsigned char done;                 /* Set when the command completed     */
+
+                                        /* Check LCD interface is actually    */
+    	                                /* open and has a queue               */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        hHd44780->queue == (HD44780CMD *) 0)
+    {
+        return 1;
+    }
+
+    while (hHd44780->queueAdded != hHd44780->queueRemoved)
+    {
+        command = &hHd44780->queue[hHd44780->queueHead];
+        done = 1;
+
+        switch (command->command)
+        {
+            case CMD_CLEARDISPLAY:
+                done = hd44780ClearDisplay(hHd44780);
+                break;
+
+            case CMD_RETURNHOME:
+                done = hd44780ReturnHome(hHd44780);
+                break;
+
+            case CMD_ENTRYMODESET:
+                done = hd44780EntryModeSet(hHd44780, command->value);
+                break;
+
+            case CMD_DISPLAYCONTROL:
+                done = hd44780DisplayControl(hHd44780, command->value);
+                break;
+
+            case CMD_SHIFTCONTROL:
+                done = hd44780ShiftControl(hHd44780, command->value);
+                break;
+
+            case CMD_FUNCTIONSET:
+                done = hd44780FunctionSet(hHd44780, command->value);
+                break;
+
+            case CMD_SETCGRAMADDR:
+                done = hd44780SetCGRAMAddr(hHd44780, command->value);
+                break;
+
+            case CMD_SETCURSORADDR:
+                done = hd44780SetCursorAddr(hHd44780, command->value);
+                break;
+
+            case CMD_WRITECHAR:
+                done = hd44780WriteChar(hHd44780, command->value);
+                break;
+                                        /* Strings carry on from where they   */
+                                        /* stopped; an empty one is done      */
+            case CMD_WRITERAMSTRING:
+                if (*command->data != 0)
+                {
+                    command->data = hd44780WriteRAMString(hHd44780,
+                                                          command->data);
+                    done = (command->data == (const unsigned char *) 0);
+                }
+                break;
+
+            case CMD_WRITECGRAM:
+                if (*command->data != 0)
+                {
+                    command->data = hd44780WriteCGRAM(hHd44780, command->data,
+                                                      command->value);
+                    done = (command->data == (const unsigned char *) 0);
+                }
+                break;
+
+            case CMD_COMMITFRAME:
+                done = hd44780CommitFrame(hHd44780, command->data);
+                break;
+
+            case CMD_COMMITGLYPHFRAME:
+                done = hd44780CommitGlyphFrame(hHd44780,
+                                        (const HD44780CELL *) command->data);
+                break;
+                                        /* Unknown commands are dropped       */
+            default:
+                break;
+        }
+                                        /* Display busy; try again later      */
+        if (!done)
+        {
+            return 0;
+        }
+                                        /* Remove the command from the queue  */
+        sequence = command->sequence;
+        hHd44780->queueHead++;
+        if (hHd44780->queueHead == hHd44780->queueSize)
+        {
+            hHd44780->queueHead = 0;
+        }
+        hHd44780->queueRemoved++;
+
+        if (hHd44780->pCommandDone !=
+                          (void (*)(HHD44780 const, HD44780SEQ)) 0)
+        {
+            hHd44780->pCommandDone(hHd44780, sequence);
+        }
+                                        /* From hd44780Tick() or              */
+                                        /* hd44780ServiceAll() one write is   */
+                                        /* all we may do; the next command    */
+                                        /* waits for the next round           */
+        if (hd44780Ticking)
+        {
+            break;
+        }
+    }
+
+    return (hHd44780->queueAdded == hHd44780->queueRemoved);
+}
+
+/*******************************************************************************
+* hd44780Tick()
+*
+* Summary: 
+*   Carries out the queued commands of every open display a little at a time,
+*   with at most one write to each display. Intended to be called from a
+*   periodic timer interrupt so that the application never waits for a display
+*
+* See also:
+*   hd44780AttachQueue(), hd44780Enqueue(), hd44780IsDone()
+*
+* Arguments: 
+*   None
+*
+* Returns: 
+*   void
+*
+* Callers: 
+*   User application, typically a timer interrupt service routine
+*
+* Notes : 
+* 1. Displays without a queue, or with nothing queued, are skipped without
+*    touching the bus, so the application may still use the other API
+*    functions on them, but only with this function's interrupt disabled
+* 2. A display that is busy, or whose bus is in use, is left for the next
+*    tick. Strings, CGRAM data and frames are written one byte per tick
+* 3. In timed mode the display is never read. Otherwise the busy flag is read
+*    once before each write. With a tick period of the instruction execution
+*    time (37us to 39us) plus the time a tick takes and a count of the time
+*    source, e.g. 50us, a display is written on every tick. Clear Display and
+*    Return Home then take about 30 ticks
+* 4. pCommandDone functions are called from this function, and so from the
+*    interrupt
+*
+*******************************************************************************/
+void hd44780Tick(void)
+{
+    serviceHD44780Round();
+}
+
+/*******************************************************************************
+* hd44780ServiceAll()
+*
+* Summary: 
+*   Carries out the queued commands of every open display, taking them in
+*   turn a write at a time, so that each display is written while the others
+*   are still executing their last instruction
+*
+* See also:
+*   hd44780Tick(), hd44780Service()
+*
+* Arguments: 
+*   None
+*
+* Returns: 
+*   - 1  	        - every display's queue is empty
+*   - 0             - commands are still queued; call this function again
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Each call makes one round of the open displays, making at most one write
+*    to each display that has a command queued and is not busy. A busy display
+*    is passed over rather than waited for
+* 2. Calling this function until it returns 1 writes N displays sharing a bus
+*    about N times as fast as hd44780Service() on each in turn, as long as a
+*    round takes less than an instruction's execution time. In timed mode a
+*    display that is still busy costs no bus cycles at all
+* 3. Must not be used at the same time as hd44780Tick()
+*
+*******************************************************************************/
+unsigned char hd44780ServiceAll(void)
+{
+    return serviceHD44780Round();
+}
+
+/*******************************************************************************
+* hd44780IsDone()
+*
+* Summary: 
+*   Checks whether a queued command has completed
+*
+* See also:
+*   hd44780Enqueue(), hd44780Service()
+*
+* Arguments: 
+*   hHd44780            - handle to the open HD44780
+*   sequence            - sequence number returned by hd44780Enqueue()
+*
+* Returns: 
+*   - 1  	        - command has completed
+*   - 0             - command is still queued, sequence was not issued by
+*                     hd44780Enqueue() for this display, or the display is
+*                     not open or has no queue
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Takes longer the more commands are queued; only hd44780Enqueue() and
+*    the removal of completed commands take a fixed time
+* 2. Sequence numbers wrap after 0xFFFF, so a sequence number can only be
+*    checked until another 0x7FFF commands have been queued on the display.
+*    After that it is taken as not yet issued, and 0 is returned
+* 3. Commands dropped by attaching the queue again are reported as completed
+*
+*******************************************************************************/
+unsigned char hd44780IsDone(HHD44780 const  hHd44780,
+                            HD44780SEQ      sequence)
+{
+    unsigned char index;                /* Entry being checked                */
+    unsigned char counter;
+    unsigned char queued;               /* Number of commands queued          */
+    HD44780SEQ age;                     /* Commands queued since this one     */
+                                        /* Check LCD interface is actually    */
+    	                                /* open, has a queue and has issued   */
+                                        /* the sequence number                */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN) ||
+        hHd44780->queue == (HD44780CMD *) 0 ||
+        sequence == 0 || (sequence & 0xFFFF) != sequence ||
+        hHd44780->lastSequence == 0)
+    {
+        return 0;
+    }
+                                        /* 0 is skipped when the numbers wrap */
+    age = hHd44780->lastSequence - sequence;
+    if (sequence > hHd44780->lastSequence)
+    {
+        age += 0xFFFF;
+    }
+    if (age >= HD44780_SEQUENCEWINDOW)
+    {
+        return 0;
+    }
+
+                                        /* Count before reading the head; if  */
+                                        /* a command completes in between one */
+                                        /* stale entry is checked too, rather */
+                                        /* than the newest being missed       */
+    queued = hHd44780->queueAdded - hHd44780->queueRemoved;
+    index = hHd44780->queueHead;
+    for (counter = 0; counter < queued; counter++)
+    {
+        if (hHd44780->queue[index].sequence == sequence)
+        {
+            return 0;
+        }
+        index++;
+        if (index == hHd44780->queueSize)
+        {
+            index = 0;
+        }
+    }
+
+    return 1;
+}
+
+/*******************************************************************************
+* serviceHD44780Round() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Services each open display that has commands queued, with at most one
+* write to each. This function is private to the HD44780 Module.
+*
+* See also:
+*   hd44780Service()
+*
+* Arguments: 
+*   None
+*
+* Returns: 
+*   - 1             - no display has any commands left queued
+*   - 0             - at least one display still has commands queued
+*
+* Callers: 
+*   hd44780Tick(), hd44780ServiceAll()
+*
+* Notes : 
+*   None
+*******************************************************************************/
+static unsigned char serviceHD44780Round(void)
+{
+    unsigned int word;                  /* Bitmap word being checked          */
+    unsigned int slot;                  /* Slot of the display to service     */
+    HD44780SLOTWORD activeSlots;        /* Set bits mark slots in use         */
+    HHD44780 hHd44780;
+    unsigned char allDone = 1;          /* Cleared if any queue isn't empty   */
+    unsigned char wasTicking = hd44780Ticking;
+                                        /* A tick may interrupt a foreground  */
+                                        /* call that is already writing one   */
+                                        /* at a time, so put back what was    */
+                                        /* set rather than clearing it        */
+    hd44780Ticking = 1;
+
+    for (word = 0; word < HD44780_SLOTWORDS; word++)
+    {
+        activeSlots = activeHD44780Objects[word];
+        for (slot = word * HD44780_SLOTWORDBITS; activeSlots != 0;
+             slot++, activeSlots >>= 1)
+        {
+            if (!(activeSlots & 0x01))
+            {
+                continue;
+            }
+            hHd44780 = hd44780Slots[slot];
+                                        /* Only open displays with commands   */
+                                        /* queued                             */
+            if ((hHd44780->hd44780Flags & HD44780_OPEN) &&
+                hHd44780->queue != (HD44780CMD *) 0 &&
+                hHd44780->queueAdded != hHd44780->queueRemoved)
+            {
+                if (!hd44780Service(hHd44780))
+                {
+                    allDone = 0;
+                }
+            }
+        }
+    }
+
+    hd44780Ticking = wasTicking;
+
+    return allDone;
+}
+
+/*******************************************************************************
+* findFreeHD44780Slot() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Finds the lowest free slot in the HD44780 slot table. This function is
+* private to the HD44780 Module.
+*
+* See also:
+*   None
+*
+* Arguments: 
+*   None
+*
+* Returns: 
+*   - 0 to HD44780_MAXOBJECTS - 1
+*                   - lowest free slot
+*   - HD44780_MAXOBJECTS
+*                   - all slots are in use
+*
+* Callers: 
+*   hd44780Create()
+*
+* Notes : 
+* 1. Each word of the bitmap covers 32 slots on PIC32 and 8 on PIC18, so with
+*    up to that many objects a free slot is found without any loop
+*******************************************************************************/
+static unsigned int findFreeHD44780Slot(void)
+{
+    unsigned int word;                  /* Bitmap word being checked          */
+    unsigned int slot;                  /* Free slot found                    */
+    HD44780SLOTWORD freeSlots;          /* Set bits mark free slots           */
+
+    for (word = 0; word < HD44780_SLOTWORDS; word++)
+    {
+        freeSlots = ~activeHD44780Objects[word];
+        if (freeSlots != 0)
+        {
+#if HD44780_SLOTWORDBITS == 32
+                                        /* Isolate the lowest free slot's bit */
+                                        /* and count the zeros above it       */
+            slot = 31 - __builtin_clz(freeSlots & (0 - freeSlots));
+#else
+                                        /* Look up the lowest clear bit a     */
+                                        /* nibble at a time                   */
+            if ((freeSlots & 0x0F) != 0)
+            {
+                slot = hd44780FirstZero[activeHD44780Objects[word] & 0x0F];
+            }
+            else
+            {
+                slot = 4 + hd44780FirstZero[activeHD44780Objects[word] >> 4];
+            }
+#endif
+            slot += word * HD44780_SLOTWORDBITS;
+                                        /* The last word may have bits beyond */
+                                        /* the end of the table               */
+            if (slot < HD44780_MAXOBJECTS)
+            {
+                return slot;
+            }
+            break;
+        }
+    }
+
+    return HD44780_MAXOBJECTS;
+}
+
+/*******************************************************************************
+* isHD44780Busy() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Checks the busy bit of the LCD chip set. This function is private to the 
+* HD44780 Module.
+*
+* See also:
+*   None
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object
+*
+* Returns: 
+*   0               - device not busy
+*   1               - device is busy
+*
+* Callers: 
+*   hd44780ClearDisplay(), hd44780ReturnHome(), hd44780EntryModeSet(), 
+*   hd44780DisplayControl(), hd44780ShiftControl(), hd44780FunctionSet(), 
+*   hd44780SetCGRAMAddr(), hd44780SetCursorAddr(), hd44780ReadAddr(), 
+*   hd44780WriteChar(), hd44780ReadChar(), hd44780WriteRAMString(), 
+*   hd44780WriteCGRAM(), hd44780WriteCGRAMBlock(), hd44780InstructionInit(),
+*   hd44780CommitFrame(), uploadHD44780Glyphs()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function, i.e. 
+*    hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf) *must* have
+*    returned true. If you don't, this call will fail and return 1
+* 2. In timed mode the bus is not touched; the device is busy until more than
+*    the execution time of the last write has passed. Waiting for one tick
+*    more than the execution time covers the time source's resolution
+*******************************************************************************/
+unsigned char isHD44780Busy(HHD44780 const hHd44780)
+{
+    unsigned char address;              /* Storage for return value of        */
+                                        /* pReadAddr                          */
+                                        /* Timed mode; check the time passed  */
+    if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0)
+    {
+        if (hHd44780->hd44780Flags & HD44780_TIMEDWAIT)
+        {
+            if ((unsigned int) (hHd44780->pGetMicroseconds() -
+                                hHd44780->lastWriteTime) <=
+                hHd44780->executionTime)
+            {
+                return 1;
+            }
+                                        /* Done; no need to read the time     */
+                                        /* again until the next write         */
+            hHd44780->hd44780Flags &= ~HD44780_TIMEDWAIT;
+        }
+        return 0;
+    }
+
+    hHd44780->lcdIfFunctionPointers->pReadAddr(hHd44780->hLcdIf, &address);
+    if (!(address & 0x80))
+    {
+        return 0;
+    }    
+    
+    return 1;        
+}
+
+/*******************************************************************************
+* writeHD44780Instr() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Writes an instruction to the LCD chip set and, in timed mode, notes when
+* it was written and how long it takes to execute. This function is private
+* to the HD44780 Module.
+*
+* See also:
+*   writeHD44780Data(), isHD44780Busy()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object
+*   instr           - instruction to write
+*
+* Returns: 
+*   void
+*
+* Callers: 
+*   hd44780ClearDisplay(), hd44780ReturnHome(), hd44780EntryModeSet(), 
+*   hd44780DisplayControl(), hd44780ShiftControl(), hd44780FunctionSet(), 
+*   hd44780SetCGRAMAddr(), hd44780SetCursorAddr(), hd44780InstructionInit(),
+*   hd44780CommitFrame(), hd44780WriteCGRAMBlock(), uploadHD44780Glyphs()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function
+*******************************************************************************/
+static void writeHD44780Instr(HHD44780 const hHd44780, unsigned char instr)
+{
+    hHd44780->lcdIfFunctionPointers->pWriteInstr(hHd44780->hLcdIf, instr);
+                                        /* The address counter has moved, so  */
+                                        /* a part way frame can't resume      */
+    hHd44780->hd44780Flags &= ~HD44780_SHADOWRESUME;
+
+    if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0)
+    {
+        hHd44780->lastWriteTime = hHd44780->pGetMicroseconds();
+                                        /* Clear Display and Return Home are  */
+                                        /* the only instructions below 0x04   */
+        if ((instr & 0xFC) == 0)
+        {
+            hHd44780->executionTime =
+                           hd44780ExecutionTimes[hHd44780->hd44780Clone][1];
+        }
+        else
+        {
+            hHd44780->executionTime =
+                           hd44780ExecutionTimes[hHd44780->hd44780Clone][0];
+        }
+        hHd44780->hd44780Flags |= HD44780_TIMEDWAIT;
+    }
+}
+
+/*******************************************************************************
+* writeHD44780Data() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Writes data to the LCD chip set's DDRAM or CGRAM and, in timed mode, notes
+* when it was written and how long it takes to execute. This function is
+* private to the HD44780 Module.
+*
+* See also:
+*   writeHD44780Instr(), isHD44780Busy()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object
+*   data            - data to write
+*
+* Returns: 
+*   void
+*
+* Callers: 
+*   hd44780WriteChar(), hd44780WriteRAMString(), hd44780WriteCGRAM(),
+*   hd44780WriteCGRAMBlock(), hd44780CommitFrame(), uploadHD44780Glyphs()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function
+*******************************************************************************/
+static void writeHD44780Data(HHD44780 const hHd44780, unsigned char data)
+{
+    hHd44780->lcdIfFunctionPointers->pWriteData(hHd44780->hLcdIf, data);
+                                        /* The address counter has moved, so  */
+                                        /* a part way frame can't resume      */
+    hHd44780->hd44780Flags &= ~HD44780_SHADOWRESUME;
+
+    if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0)
+    {
+        hHd44780->lastWriteTime = hHd44780->pGetMicroseconds();
+        hHd44780->executionTime =
+                           hd44780ExecutionTimes[hHd44780->hd44780Clone][0];
+        hHd44780->hd44780Flags |= HD44780_TIMEDWAIT;
+    }
+}
+
+/*******************************************************************************
+* writeHD44780DataBlock() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Writes a run of data to the LCD chip set's DDRAM or CGRAM in one LCD
+* interface block transfer. This function is private to the HD44780 Module.
+*
+* See also:
+*   writeHD44780Data(), measureHD44780String()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object in timed mode
+*   data            - data to write
+*   length          - number of bytes to write
+*
+* Returns: 
+*   void
+*
+* Callers: 
+*   hd44780WriteRAMString(), hd44780WriteCGRAM(), hd44780WriteCGRAMBlock(),
+*   uploadHD44780Glyphs()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function and the device
+*    must not be busy
+*******************************************************************************/
+static void writeHD44780DataBlock(HHD44780 const hHd44780,
+                                  const unsigned char * data,
+                                  unsigned char length)
+{
+    hHd44780->lcdIfFunctionPointers->pWriteDataBlock(hHd44780->hLcdIf, data,
+                           length, hHd44780->pGetMicroseconds,
+                           hd44780ExecutionTimes[hHd44780->hd44780Clone][0]);
+                                        /* The address counter has moved, so  */
+                                        /* a part way frame can't resume      */
+    hHd44780->hd44780Flags &= ~HD44780_SHADOWRESUME;
+                                        /* The last byte is timed like a      */
+                                        /* single write                       */
+    hHd44780->lastWriteTime = hHd44780->pGetMicroseconds();
+    hHd44780->executionTime = hd44780ExecutionTimes[hHd44780->hd44780Clone][0];
+    hHd44780->hd44780Flags |= HD44780_TIMEDWAIT;
+}
+
+/*******************************************************************************
+* measureHD44780String() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Counts the bytes of a zero terminated string that fit in one block
+* transfer. This function is private to the HD44780 Module.
+*
+* See also:
+*   writeHD44780DataBlock()
+*
+* Arguments: 
+*   string          - zero terminated string
+*
+* Returns: 
+*   Number of bytes before the terminating 0, but at most 255
+*
+* Callers: 
+*   hd44780WriteRAMString(), hd44780WriteCGRAM()
+*
+* Notes : 
+*   None
+*******************************************************************************/
+static unsigned char measureHD44780String(const unsigned char * string)
+{
+    unsigned char length = 0;
+    
+    while (string[length] != 0 && length < 0xFF)
+    {
+        length++;
+    }
+
+    return length;
+}
+
+/*******************************************************************************
+* locateHD44780Cell() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Looks up the DDRAM address of a row and column of a display. This
+* function is private to the HD44780 Module.
+*
+* See also:
+*   hd44780AttachGeometry()
+*
+* Arguments: 
+*   geometry        - layout of the display
+*   row             - row, which must be on the display
+*   column          - column, which must be on the display
+*
+* Returns: 
+*   DDRAM address of the character
+*
+* Callers: 
+*   hd44780SetCursorPos(), hd44780WriteAt()
+*
+* Notes : 
+*   None
+*******************************************************************************/
+static unsigned char locateHD44780Cell(const HD44780GEOMETRY * geometry,
+                                       unsigned char row,
+                                       unsigned char column)
+{
+    unsigned char segments = geometry->columns / geometry->segmentColumns;
+
+    return geometry->rowAddresses[row * segments +
+                                  column / geometry->segmentColumns] +
+           column % geometry->segmentColumns;
+}
+
+/*******************************************************************************
+* readHD44780Data() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Reads data from the LCD chip set's DDRAM or CGRAM and, in timed mode,
+* notes when it was read, as the controller is busy moving its address
+* counter on afterwards. This function is private to the HD44780 Module.
+*
+* See also:
+*   writeHD44780Data(), readHD44780DataBlock()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object
+*   data            - place to store the data read
+*
+* Returns: 
+*   - 1             - data read
+*   - 0             - the LCD interface couldn't read
+*
+* Callers: 
+*   hd44780ReadChar(), readHD44780RAM()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function
+*******************************************************************************/
+static unsigned char readHD44780Data(HHD44780 const hHd44780,
+                                     unsigned char * data)
+{
+    if (!hHd44780->lcdIfFunctionPointers->pReadData(hHd44780->hLcdIf, data))
+    {
+        return 0;
+    }
+                                        /* The address counter has moved, so  */
+                                        /* a part way frame can't resume      */
+    hHd44780->hd44780Flags &= ~HD44780_SHADOWRESUME;
+
+    if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0)
+    {
+        hHd44780->lastWriteTime = hHd44780->pGetMicroseconds();
+        hHd44780->executionTime =
+                           hd44780ExecutionTimes[hHd44780->hd44780Clone][0];
+        hHd44780->hd44780Flags |= HD44780_TIMEDWAIT;
+    }
+
+    return 1;
+}
+
+/*******************************************************************************
+* readHD44780DataBlock() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Reads a run of data from the LCD chip set's DDRAM or CGRAM in one LCD
+* interface block transfer. This function is private to the HD44780 Module.
+*
+* See also:
+*   readHD44780Data(), writeHD44780DataBlock()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object in timed mode
+*   data            - place to store the data read
+*   length          - number of bytes to read
+*
+* Returns: 
+*   - 1             - data read
+*   - 0             - the LCD interface couldn't read
+*
+* Callers: 
+*   readHD44780RAM()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function and the device
+*    must not be busy
+*******************************************************************************/
+static unsigned char readHD44780DataBlock(HHD44780 const hHd44780,
+                                          unsigned char * data,
+                                          unsigned char length)
+{
+    if (!hHd44780->lcdIfFunctionPointers->pReadDataBlock(hHd44780->hLcdIf,
+                           data, length, hHd44780->pGetMicroseconds,
+                           hd44780ExecutionTimes[hHd44780->hd44780Clone][0]))
+    {
+        return 0;
+    }
+                                        /* The address counter has moved, so  */
+                                        /* a part way frame can't resume      */
+    hHd44780->hd44780Flags &= ~HD44780_SHADOWRESUME;
+                                        /* The last byte is timed like a      */
+                                        /* single read                        */
+    hHd44780->lastWriteTime = hHd44780->pGetMicroseconds();
+    hHd44780->executionTime = hd44780ExecutionTimes[hHd44780->hd44780Clone][0];
+    hHd44780->hd44780Flags |= HD44780_TIMEDWAIT;
+
+    return 1;
+}
+
+/*******************************************************************************
+* mapHD44780Glyph() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Finds the CGRAM character holding a glyph, choosing one to load it into if
+* it isn't in CGRAM, and makes it the most recently used. This function is
+* private to the HD44780 Module.
+*
+* See also:
+*   uploadHD44780Glyphs()
+*
+* Arguments: 
+*   glyphCache      - glyph cache to use
+*   glyph           - number of the glyph in the glyph table
+*   keepSlots       - bitmap of characters that must not be reused
+*
+* Returns: 
+*   - 0 to HD44780_GLYPHSLOTS - 1
+*                   - character holding, or to be loaded with, the glyph
+*   - HD44780_GLYPHSLOTS
+*                   - glyph isn't in CGRAM and every character is kept or
+*                     pinned
+*
+* Callers: 
+*   hd44780PinGlyph(), hd44780CommitGlyphFrame()
+*
+* Notes : 
+* 1. The bus is not touched; a character chosen is marked in uploadSlots to be
+*    loaded by uploadHD44780Glyphs()
+*******************************************************************************/
+static unsigned char mapHD44780Glyph(HD44780GLYPHCACHE * const glyphCache,
+                                     unsigned char glyph,
+                                     unsigned char keepSlots)
+{
+    unsigned char position;             /* Position of slot in lruSlots       */
+    unsigned char slot;
+
+    for (position = 0; position < HD44780_GLYPHSLOTS; position++)
+    {
+        if (glyphCache->slotGlyph[glyphCache->lruSlots[position]] == glyph)
+        {
+            break;
+        }
+    }
+                                        /* Not in CGRAM; take the least       */
+                                        /* recently used character we may     */
+    if (position == HD44780_GLYPHSLOTS)
+    {
+        keepSlots |= glyphCache->pinnedSlots;
+        do
+        {
+            if (position == 0)
+            {
+                return HD44780_GLYPHSLOTS;
+            }
+            position--;
+        }
+        while (keepSlots & (0x01 << glyphCache->lruSlots[position]));
+
+        slot = glyphCache->lruSlots[position];
+                                        /* A load under way may have been of  */
+                                        /* the old glyph, or may now not be   */
+                                        /* the lowest; restart it             */
+        if (glyphCache->uploadSlots != 0)
+        {
+            glyphCache->uploadRow = 0;
+        }
+        glyphCache->slotGlyph[slot] = glyph;
+        glyphCache->uploadSlots |= 0x01 << slot;
+    }
+                                        /* Move it to the front of lruSlots   */
+    slot = glyphCache->lruSlots[position];
+    for (; position > 0; position--)
+    {
+        glyphCache->lruSlots[position] = glyphCache->lruSlots[position - 1];
+    }
+    glyphCache->lruSlots[0] = slot;
+
+    return slot;
+}
+
+/*******************************************************************************
+* uploadHD44780Glyphs() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Loads each CGRAM character marked in uploadSlots with its glyph, lowest
+* character first. This function is private to the HD44780 Module.
+*
+* See also:
+*   mapHD44780Glyph()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object with a glyph cache
+*
+* Returns: 
+*   - 1             - every character is loaded
+*   - 0             - device busy, or one write made from hd44780Tick() or
+*                     hd44780ServiceAll(); call again to carry on
+*
+* Callers: 
+*   hd44780CommitGlyphFrame()
+*
+* Notes : 
+* 1. You must own the pbIf bus before calling this function
+* 2. The CGRAM address counter moves on by itself from the end of one
+*    character to the start of the next, so loading neighbouring characters
+*    needs only one Set CGRAM Address instruction
+* 3. The address counter is left in CGRAM, so hd44780CommitFrame() is told
+*    to set the DDRAM address again
+* 4. In timed mode, if the LCD interface provides pWriteDataBlock, the rows
+*    of a glyph are written in one block transfer
+*******************************************************************************/
+static unsigned char uploadHD44780Glyphs(HHD44780 const hHd44780)
+{
+    HD44780GLYPHCACHE * glyphCache;
+    unsigned char slot;
+
+    glyphCache = hHd44780->glyphCache;
+    while (glyphCache->uploadSlots != 0)
+    {
+        for (slot = 0; !(glyphCache->uploadSlots & (0x01 << slot)); slot++);
+                                        /* Check busy bit                     */
+        if (isHD44780Busy(hHd44780))
+        {
+            return 0;
+        }
+        if (glyphCache->uploadRow == 0)
+        {
+            writeHD44780Instr(hHd44780, HD44780_SETCGRAMADDRESS &
+                                        (0x40 | (slot * CGRAMFONT_5X8)));
+        }
+        else if (hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+                 hHd44780->lcdIfFunctionPointers->pWriteDataBlock != 0 &&
+                 !hd44780Ticking)
+        {
+                                        /* Rest of the glyph in one block     */
+            writeHD44780DataBlock(hHd44780, &glyphCache->glyphs[
+                  glyphCache->slotGlyph[slot]][glyphCache->uploadRow - 1],
+                  CGRAMFONT_5X8 + 1 - glyphCache->uploadRow);
+            glyphCache->uploadRow = CGRAMFONT_5X8;
+        }
+        else
+        {
+            writeHD44780Data(hHd44780, glyphCache->glyphs[
+                  glyphCache->slotGlyph[slot]][glyphCache->uploadRow - 1]);
+        }
+        glyphCache->uploadRow++;
+                                        /* Character done; carry straight on  */
+                                        /* if the next one is to be loaded    */
+        if (glyphCache->uploadRow > CGRAMFONT_5X8)
+        {
+            glyphCache->uploadSlots &= ~(0x01 << slot);
+            glyphCache->uploads++;
+            glyphCache->uploadRow = 0;
+            if (glyphCache->uploadSlots & (0x01 << (slot + 1)))
+            {
+                glyphCache->uploadRow = 1;
+            }
+        }
+                                        /* One write per tick                 */
+        if (hd44780Ticking)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*******************************************************************************
+* readHD44780RAM() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Reads DDRAM or CGRAM made up of runs of neighbouring addresses, setting
+* the address at the start of each run. This function is private to the
+* HD44780 Module.
+*
+* See also:
+*   readHD44780Data(), readHD44780DataBlock()
+*
+* Arguments: 
+*   hHd44780        - handle to valid HD44780 object
+*   data            - place to store the bytes read
+*   total           - number of bytes to read
+*   read            - progress returned by the last call, or 0 to start
+*   firstInstr      - Set CGRAM or DDRAM Address instruction for the first
+*                     byte, or 0 to read from the current address
+*   runLength       - number of bytes in each run
+*   runStride       - address difference between the start of each run
+*
+* Returns: 
+*   Progress of the read; total when complete
+*
+* Callers: 
+*   hd44780ReadRAMBlock(), hd44780ReadCGRAM(), hd44780ReadScreen()
+*
+* Notes : 
+* 1. When firstInstr is not 0, HD44780_RAMADDRESSED is set in the progress
+*    returned if the address is already set for the next byte
+* 2. In timed mode the function waits out the timer rather than return, so
+*    that the whole read is made under one bus acquisition
+*******************************************************************************/
+static unsigned char readHD44780RAM(HHD44780 const hHd44780,
+                                    unsigned char * data,
+                                    unsigned char total,
+                                    unsigned char read,
+                                    unsigned char firstInstr,
+                                    unsigned char runLength,
+                                    unsigned char runStride)
+{
+    unsigned char addressSet = 1;
+    unsigned char blockTransfer;
+    unsigned char length;
+                                        /* Check LCD interface is actually    */
+    	                                /* open                               */
+    if (!(hHd44780->hd44780Flags & HD44780_OPEN))
+    {
+        return read;
+    }
+    if (firstInstr != 0)
+    {
+        addressSet = read & HD44780_RAMADDRESSED;
+        read &= ~HD44780_RAMADDRESSED;
+    }
+    if (read >= total ||
+        !hHd44780->lcdIfFunctionPointers->pGetBus(hHd44780->hLcdIf))
+    {
+        goto readHD44780RAMDone;
+    }
+    blockTransfer = hHd44780->pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+                    hHd44780->lcdIfFunctionPointers->pReadDataBlock != 0 &&
+                    !hd44780Ticking;
+
+    while (read < total)
+    {
+                                        /* Check busy bit; timed mode waits   */
+                                        /* out the timer to keep the bus      */
+        if (isHD44780Busy(hHd44780))
+        {
+            if (blockTransfer)
+            {
+                continue;
+            }
+            break;
+        }
+
+        if (!addressSet)
+        {
+            writeHD44780Instr(hHd44780, firstInstr +
+                              (read / runLength) * runStride +
+                              read % runLength);
+            addressSet = 1;
+        }
+        else
+        {
+            length = 1;
+            if (blockTransfer)
+            {
+                                        /* Rest of this run in one block      */
+                length = runLength - read % runLength;
+                if (length > total - read)
+                {
+                    length = total - read;
+                }
+                if (!readHD44780DataBlock(hHd44780, data + read, length))
+                {
+                    break;
+                }
+            }
+            else if (!readHD44780Data(hHd44780, data + read))
+            {
+                break;
+            }
+            read += length;
+            if (firstInstr != 0 && read % runLength == 0)
+            {
+                addressSet = 0;
+            }
+        }
+                                        /* One access per tick                */
+        if (hd44780Ticking)
+        {
+            break;
+        }
+    }
+                                        /* Return the bus                     */
+    hHd44780->lcdIfFunctionPointers->pReturnBus(hHd44780->hLcdIf);
+
+readHD44780RAMDone:
+    if (addressSet && firstInstr != 0 && read < total)
+    {
+        read |= HD44780_RAMADDRESSED;
+    }
+
+    return read;
 }
 
     
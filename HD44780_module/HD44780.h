@@ -30,10 +30,18 @@
 /*******************************************************************************
 *                                 INCLUDE FILES
 *******************************************************************************/
-#if defined(__18CXX)
+#if defined(LCDIF_PMP)
+    #include "lcdif_pmp.h"
+#elif defined(LCDIF_SPI595)
+    #include "lcdif_spi595.h"
+#elif defined(LCDIF_PCF8574)
+    #include "lcdif_pcf8574.h"
+#elif defined(__18CXX)
     #include "lcdif_c32.h"
 #elif defined (__PIC32MX__)
     #include "lcdif_c32.h"
+#elif defined (LCDIF_HOST_SIM)
+    #include "lcdif_host.h"
 #else
     #error This processor family or toolchain is not currently supported
 #endif
@@ -48,13 +56,55 @@
 /*******************************************************************************
 *                             DEFAULT CONFIGURATION
 *******************************************************************************/
-//<List any default configuration information here>
+
+/*******************************************************************************
+* Summary:
+*   Maximum number of HD44780 objects that can be created at the same time.
+*   Define it on the compiler command line to use a different capacity
+* See also:
+*   <link hd44780Create>
+*******************************************************************************/
+#ifndef HD44780_MAXOBJECTS
+#define HD44780_MAXOBJECTS  16
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Character hd44780CommitGlyphFrame() shows in place of a glyph that is not in
+*   the glyph table or for which no CGRAM character is free. Define it on the
+*   compiler command line to use a different character
+* See also:
+*   <link hd44780CommitGlyphFrame>
+*******************************************************************************/
+#ifndef HD44780_GLYPHMISSING
+#define HD44780_GLYPHMISSING ' '
+#endif
 
 
 /*******************************************************************************
 *                                    DEFINES
 *******************************************************************************/
 
+/*******************************************************************************
+* Summary:
+*   Qualifies data held in program memory. C18 copies const data to RAM at
+*   start-up unless it is qualified rom, and rom data is read with TBLRD.
+*   PIC32 maps program memory into the data space, so there it is plain
+*   const. On C30 it is plain const too, so const data is only read from
+*   program memory if it is built with the default constants in code memory
+*   model (-mconst-in-code), which puts it in the auto_psv section, and the
+*   start-up code has enabled the PSV window on that section's page. Strings
+*   placed elsewhere with space(psv), or in another PSV page, are not
+*   supported, and an interrupt using this module must be declared auto_psv
+* See also:
+*   <link hd44780WriteROMString>, <link hd44780InstructionInit>
+*******************************************************************************/
+#if defined(__18CXX)
+#define HD44780_ROM         rom
+#else
+#define HD44780_ROM
+#endif
+
 /*******************************************************************************
 * Summary:
 *   Entry Mode Set HD44780 Setting "CURSORMOVE" - cursor moves after each
@@ -242,7 +292,8 @@
 * Summary:
 *   This defines that the CGRAM font has 8 lines of data when creating new fonts
 * See also:
-*   <link hd44780WriteCGRAM>,  <link hd44780ReadCGRAM>
+*   <link hd44780WriteCGRAM>, <link hd44780WriteCGRAMBlock>,
+*   <link hd44780ReadCGRAM>
 *******************************************************************************/
 #define CGRAMFONT_5X8       8
 
@@ -251,10 +302,60 @@
 *   This defines that the CGRAM font has 10 lines of data when creating new
 *   fonts
 * See also:
-*   <link hd44780WriteCGRAM>, <link hd44780ReadCGRAM>
+*   <link hd44780WriteCGRAM>, <link hd44780WriteCGRAMBlock>,
+*   <link hd44780ReadCGRAM>
 *******************************************************************************/
 #define CGRAMFONT_5X10      10
 
+/*******************************************************************************
+* Summary:
+*   Number of characters in a shadow buffer and in a frame passed to
+*   hd44780CommitFrame(). This is the whole DDRAM of a 2-line display: cells 0
+*   to 39 are DDRAM addresses 0x00 to 0x27, cells 40 to 79 are addresses 0x40
+*   to 0x67
+* See also:
+*   <link hd44780AttachShadow>, <link hd44780CommitFrame>,
+*   <link hd44780ReadScreen>
+*******************************************************************************/
+#define HD44780_SHADOWSIZE  80
+
+/*******************************************************************************
+* Summary:
+*   Number of CGRAM characters shared out by a glyph cache. Glyphs are always
+*   5x8 dots
+* See also:
+*   <link hd44780AttachGlyphCache>
+*******************************************************************************/
+#define HD44780_GLYPHSLOTS  8
+
+/*******************************************************************************
+* Summary:
+*   Gives the frame cell for hd44780CommitGlyphFrame() that shows glyph number
+*   glyph of the glyph table. Cells below 0x100 show that character code
+* See also:
+*   <link hd44780CommitGlyphFrame>
+*******************************************************************************/
+#define HD44780_GLYPH(glyph) ((HD44780CELL) (0x100 | (glyph)))
+
+/*******************************************************************************
+* Summary:
+*   Number of HD44780 controllers behind a virtual display, such as the two of
+*   a 40x4 module
+* See also:
+*   <link hd44780AttachVirtual>
+*******************************************************************************/
+#define HD44780_VIRTUALCONTROLLERS  2
+
+/*******************************************************************************
+* Summary:
+*   Number of characters in a frame passed to hd44780CommitVirtualFrame(); 40
+*   for each of the 4 rows, top row first
+* See also:
+*   <link hd44780CommitVirtualFrame>
+*******************************************************************************/
+#define HD44780_VIRTUALFRAMESIZE    (HD44780_VIRTUALCONTROLLERS *             \
+                                     HD44780_SHADOWSIZE)
+
 /*******************************************************************************
 * Summary:
 *   Signals that hd44780Destroy() failed to deallocate requested buffer object
@@ -304,6 +405,19 @@ typedef unsigned int HD44780NUM;
 *                         4-bit write needed during the instruction
 *                         initialisation process (only required in 4-bit data
 *                         bus mode)
+*   - *pWriteDataBlock  - Pointer to function that writes a block of data to
+*                         the data bus, setting up the bus once for the whole
+*                         block, or NULL if not implemented
+*   - *pWriteInstrBlock - Pointer to function that writes a block of LCD
+*                         controller instructions to the data bus, or NULL if
+*                         not implemented
+*   - *pReadDataBlock   - Pointer to function that reads a block of data from
+*                         the data bus, setting up the bus once for the whole
+*                         block, or NULL if not implemented
+* The block functions are only used by this module in timed mode (see
+* hd44780SetTimedMode()), as the busy flag can't be read part way through a
+* block. They are passed the time source and the number of microseconds to
+* leave between each byte.
 *******************************************************************************/
 typedef struct LCDIFFPTYPE {
     unsigned char   (*pGetBus)          (HLCDIF const           hLcdIf);
@@ -318,8 +432,176 @@ typedef struct LCDIFFPTYPE {
                                          unsigned char * const  addr);
     unsigned char   (*p4BitFunctionSet) (HLCDIF const hLcdIf, 
                                          unsigned char          instruction);
+    unsigned char   (*pWriteDataBlock)  (HLCDIF const           hLcdIf,
+                                         const unsigned char *  data,
+                                         unsigned char          length,
+                                         unsigned int (*pGetMicroseconds)
+                                                                (void),
+                                         unsigned int           interval);
+    unsigned char   (*pWriteInstrBlock) (HLCDIF const           hLcdIf,
+                                         const unsigned char *  instr,
+                                         unsigned char          length,
+                                         unsigned int (*pGetMicroseconds)
+                                                                (void),
+                                         unsigned int           interval);
+    unsigned char   (*pReadDataBlock)   (HLCDIF const           hLcdIf,
+                                         unsigned char *        data,
+                                         unsigned char          length,
+                                         unsigned int (*pGetMicroseconds)
+                                                                (void),
+                                         unsigned int           interval);
 } LCDIFFP ;
 
+/*******************************************************************************
+* New data type HD44780CLONE
+* Description:
+*   Holds a list of HD44780 clone chip sets so that we can perform the 
+*   instruction initialisation depending on the chip set being used
+*******************************************************************************/
+typedef enum HD44780CLONETYPE
+{
+                                        /* Hitachi HD44780U                   */
+    HD44780U,
+                                        /* Sitronix ST7066U                   */
+    ST7066U,
+                                        /* Samsung S6A0069                    */
+    S6A0069,
+                                        /* Samsung KS0066U                    */
+    KS0066U,
+                                        /* Novatek NT7603                     */
+    NT7603
+} HD44780CLONE;    
+
+/*******************************************************************************
+* New data type HD44780SEQ
+* Description:
+*   Sequence number issued by hd44780Enqueue() to identify a queued command.
+*   Sequence numbers run from 1 to 0xFFFF and then wrap; 0 is never issued.
+*   hd44780IsDone() accepts the last 0x8000 issued on a display
+*******************************************************************************/
+typedef unsigned int HD44780SEQ;
+
+/*******************************************************************************
+* New data type HD44780COMMAND
+* Description:
+*   Lists the commands that can be queued with hd44780Enqueue(). Each one is
+*   carried out by hd44780Service() with the API function of the same name
+*******************************************************************************/
+typedef enum HD44780COMMANDTYPE
+{
+                                        /* hd44780ClearDisplay()              */
+    CMD_CLEARDISPLAY,
+                                        /* hd44780ReturnHome()                */
+    CMD_RETURNHOME,
+                                        /* hd44780EntryModeSet(value)         */
+    CMD_ENTRYMODESET,
+                                        /* hd44780DisplayControl(value)       */
+    CMD_DISPLAYCONTROL,
+                                        /* hd44780ShiftControl(value)         */
+    CMD_SHIFTCONTROL,
+                                        /* hd44780FunctionSet(value)          */
+    CMD_FUNCTIONSET,
+                                        /* hd44780SetCGRAMAddr(value)         */
+    CMD_SETCGRAMADDR,
+                                        /* hd44780SetCursorAddr(value)        */
+    CMD_SETCURSORADDR,
+                                        /* hd44780WriteChar(value)            */
+    CMD_WRITECHAR,
+                                        /* hd44780WriteRAMString(data)        */
+    CMD_WRITERAMSTRING,
+                                        /* hd44780WriteCGRAM(data, value)     */
+    CMD_WRITECGRAM,
+                                        /* hd44780CommitFrame(data)           */
+    CMD_COMMITFRAME,
+                                        /* hd44780CommitGlyphFrame(data)      */
+    CMD_COMMITGLYPHFRAME
+} HD44780COMMAND;
+
+/*******************************************************************************
+* New data type HD44780CMD
+* Description:
+*   One entry in a display's command queue. An array of these is supplied by
+*   the user with hd44780AttachQueue(); the members are private to the module.
+*   Members are:
+*   - * data                    - String, CGRAM data or frame to be written;
+*                                 moves on as a string is written
+*   - sequence                  - Sequence number issued for this command
+*   - command                   - Command to carry out (HD44780COMMAND)
+*   - value                     - Argument of the command
+*******************************************************************************/
+typedef struct HD44780CMDTYPE {
+  const unsigned char     * data;
+  HD44780SEQ                sequence;
+  unsigned char             command;
+  unsigned char             value;
+} HD44780CMD;
+
+/*******************************************************************************
+* New data type HD44780CELL
+* Description:
+*   One cell of a frame passed to hd44780CommitGlyphFrame(): a character code
+*   below 0x100, or a glyph given by HD44780_GLYPH()
+*******************************************************************************/
+typedef unsigned short HD44780CELL;
+
+/*******************************************************************************
+* New data type HD44780GLYPHCACHE
+* Description:
+*   Shares the CGRAM characters of a display out among a larger table of
+*   glyphs, loading each glyph only when a frame needs it. One is supplied by
+*   the user with hd44780AttachGlyphCache(); the members are private to the
+*   module, except that uploads may be read. Members are:
+*   - (* glyphs)[]              - Glyph table; 8 rows of 5 dots per glyph
+*   - numberOfGlyphs            - Number of glyphs in the table
+*   - slotGlyph                 - Glyph held by each CGRAM character, or 0xFF
+*   - lruSlots                  - CGRAM characters, most recently used first
+*   - pinnedSlots               - Bitmap of CGRAM characters that are pinned
+*   - uploadSlots               - Bitmap of CGRAM characters still to be
+*                                 loaded with their glyph
+*   - uploadRow                 - Progress through loading the lowest of
+*                                 uploadSlots; 0 until its address is set
+*   - frameMapped               - Set once frame holds the frame being
+*                                 committed
+*   - frame                     - Frame being committed, in character codes
+*   - uploads                   - Number of glyphs loaded since the cache was
+*                                 attached
+*******************************************************************************/
+typedef struct HD44780GLYPHCACHETYPE {
+  const unsigned char    (* glyphs)[CGRAMFONT_5X8];
+  unsigned char             numberOfGlyphs;
+  unsigned char             slotGlyph[HD44780_GLYPHSLOTS];
+  unsigned char             lruSlots[HD44780_GLYPHSLOTS];
+  unsigned char             pinnedSlots;
+  unsigned char             uploadSlots;
+  unsigned char             uploadRow;
+  unsigned char             frameMapped;
+  unsigned char             frame[HD44780_SHADOWSIZE];
+  unsigned int              uploads;
+} HD44780GLYPHCACHE;
+
+/*******************************************************************************
+* New data type HD44780GEOMETRY
+* Description:
+*   Describes how the rows and columns of a display map onto DDRAM addresses.
+*   Attached to an HD44780 object with hd44780AttachGeometry(); the stock
+*   displays are described by the hd44780Geometry descriptors below. Members
+*   are:
+*   - rows                      - Number of rows on the display
+*   - columns                   - Number of characters on each row
+*   - segmentColumns            - Number of columns after which a row
+*                                 continues at another DDRAM address; the
+*                                 same as columns unless a row is split, as
+*                                 on most 16x1 displays
+*   - * rowAddresses            - DDRAM address of the first column of each
+*                                 segment, row by row
+*******************************************************************************/
+typedef struct HD44780GEOMETRYTYPE {
+  unsigned char             rows;
+  unsigned char             columns;
+  unsigned char             segmentColumns;
+  const unsigned char     * rowAddresses;
+} HD44780GEOMETRY;
+
 /*******************************************************************************
 * New data type HD44780OBJ                                                    
 * Description:
@@ -333,15 +615,65 @@ typedef struct LCDIFFPTYPE {
 *   - hd44780Flags              - Flags used by the module to keep track of the
 *                                 status of this HD44780 controller (private to
 *                                 this module)
-*   - *nextHD44780Obj           - Pointer to the next HD44780 object in the
-*                                 linked list
+*   - * shadowBuffer            - Optional copy of the DDRAM contents used by
+*                                 hd44780CommitFrame() (private to this module;
+*                                 see hd44780AttachShadow())
+*   - shadowCursor              - Shadow buffer cell the address counter was
+*                                 left at by hd44780CommitFrame() (private to
+*                                 this module)
+*   - * glyphCache              - Optional glyph cache used by
+*                                 hd44780CommitGlyphFrame() (private to this
+*                                 module; see hd44780AttachGlyphCache())
+*   - * geometry                - Optional layout of the display used by
+*                                 hd44780SetCursorPos() and hd44780WriteAt()
+*                                 (private to this module; see
+*                                 hd44780AttachGeometry())
+*   - hd44780Clone              - Chipset whose execution times are used in
+*                                 timed mode (private to this module; see
+*                                 hd44780SetTimedMode())
+*   - *pGetMicroseconds         - Time source used in timed mode, or NULL if
+*                                 the busy flag is polled (private to this
+*                                 module)
+*   - lastWriteTime             - Time of the last write in timed mode (private
+*                                 to this module)
+*   - executionTime             - Execution time of the last write in timed
+*                                 mode (private to this module)
+*   - * queue                   - Optional command queue (private to this
+*                                 module; see hd44780AttachQueue())
+*   - queueSize                 - Number of entries in the queue
+*   - queueHead                 - Entry of the oldest queued command
+*   - queueTail                 - Entry the next command will be queued in
+*   - queueAdded                - Number of commands queued, modulo 256;
+*                                 only changed by hd44780Enqueue()
+*   - queueRemoved              - Number of commands completed, modulo 256;
+*                                 only changed by hd44780Service(), so that
+*                                 it may run from an interrupt
+*   - lastSequence              - Sequence number issued to the newest command
+*   - *pCommandDone             - Function called by hd44780Service() as each
+*                                 queued command completes, or NULL
 *******************************************************************************/
 typedef struct HD44780OBJTYPE {
   HLCDIF                    hLcdIf;
   LCDIFFP                 * lcdIfFunctionPointers;
   HD44780NUM                hd44780Num;
   unsigned char             hd44780Flags;
-  struct HD44780OBJTYPE   * nextHD44780Obj;
+  unsigned char           * shadowBuffer;
+  unsigned char             shadowCursor;
+  HD44780GLYPHCACHE       * glyphCache;
+  const HD44780GEOMETRY   * geometry;
+  HD44780CLONE              hd44780Clone;
+  unsigned int           (* pGetMicroseconds)(void);
+  unsigned int              lastWriteTime;
+  unsigned int              executionTime;
+  HD44780CMD              * queue;
+  unsigned char             queueSize;
+  unsigned char             queueHead;
+  unsigned char             queueTail;
+  volatile unsigned char    queueAdded;
+  volatile unsigned char    queueRemoved;
+  HD44780SEQ                lastSequence;
+  void                   (* pCommandDone)(struct HD44780OBJTYPE * const,
+                                          HD44780SEQ);
 } HD44780OBJ;
 
 
@@ -353,35 +685,76 @@ typedef struct HD44780OBJTYPE {
 typedef HD44780OBJ * HHD44780;
 
 /*******************************************************************************
-* New data type HD44780CLONE
+* New data type HD44780VIRTUAL
 * Description:
-*   Holds a list of HD44780 clone chip sets so that we can perform the 
-*   instruction initialisation depending on the chip set being used
+*   One display driven by several HD44780 controllers, such as a 40x4 module,
+*   which is two 40x2 controllers sharing data, RS and RW with an E pin each.
+*   One is supplied by the user with hd44780AttachVirtual(); the members are
+*   private to the module. Members are:
+*   - hHd44780                  - Controllers, top first, each driving two
+*                                 rows of 40 characters
 *******************************************************************************/
-typedef enum HD44780CLONETYPE
-{
-                                        /* Hitachi HD44780U                   */
-    HD44780U,
-                                        /* Sitronix ST7066U                   */
-    ST7066U,
-                                        /* Samsung S6A0069                    */
-    S6A0069,
-                                        /* Samsung KS0066U                    */
-    KS0066U,
-                                        /* Novatek NT7603                     */
-    NT7603
-} HD44780CLONE;    
+typedef struct HD44780VIRTUALTYPE {
+  HHD44780                  hHd44780[HD44780_VIRTUALCONTROLLERS];
+} HD44780VIRTUAL;
+
+/*******************************************************************************
+* New data type HD44780INIT
+* Description:
+*   One display to be initialised by hd44780InstructionInitAll(). An array of
+*   these is filled in by the user. Members are:
+*   - hHd44780                  - Handle to the open HD44780
+*   - hd44780Clone              - Chipset if not exactly an Hitachi HD44780U
+*   - functionSet               - Settings for the Function Set command, as
+*                                 for hd44780InstructionInit()
+*   - displayOnOffControl       - Settings for the Display On/Off Control
+*                                 command, as for hd44780InstructionInit()
+*   - entryModeSet              - Settings for the Entry Mode Set command, as
+*                                 for hd44780InstructionInit()
+*   - initDone                  - Set once this display is initialised
+*                                 (private to this module; must be 0 before
+*                                 the first call)
+*   - waitTime                  - Microseconds until this display's next step
+*                                 is due (private to this module; must be 0
+*                                 before the first call)
+*******************************************************************************/
+typedef struct HD44780INITTYPE {
+  HHD44780                  hHd44780;
+  HD44780CLONE              hd44780Clone;
+  unsigned char             functionSet;
+  unsigned char             displayOnOffControl;
+  unsigned char             entryModeSet;
+  unsigned char             initDone;
+  unsigned int              waitTime;
+} HD44780INIT;
+
 
 
 /*******************************************************************************
 *                                GLOBAL VARIABLES
 *******************************************************************************/
-//<Add all variable which are global here>
+
 /*******************************************************************************
-* Global variable <My Global Variable>                                                     
+* Global variables hd44780Geometry...
 * Summary:
-*   <Global variable description>
-*******************************************************************************/
+*   Layouts of the common display sizes, to be passed to
+*   hd44780AttachGeometry(). hd44780Geometry16x1 is the usual 16x1 display,
+*   driven as two halves of 8 characters at 0x00 and 0x40;
+*   hd44780Geometry16x1Linear is for the few with all 16 characters at 0x00.
+*   The 4 row displays carry on row 0 into row 2 and row 1 into row 3
+*******************************************************************************/
+extern const HD44780GEOMETRY hd44780Geometry8x1;
+extern const HD44780GEOMETRY hd44780Geometry8x2;
+extern const HD44780GEOMETRY hd44780Geometry16x1;
+extern const HD44780GEOMETRY hd44780Geometry16x1Linear;
+extern const HD44780GEOMETRY hd44780Geometry16x2;
+extern const HD44780GEOMETRY hd44780Geometry16x4;
+extern const HD44780GEOMETRY hd44780Geometry20x1;
+extern const HD44780GEOMETRY hd44780Geometry20x2;
+extern const HD44780GEOMETRY hd44780Geometry20x4;
+extern const HD44780GEOMETRY hd44780Geometry24x2;
+extern const HD44780GEOMETRY hd44780Geometry40x1;
+extern const HD44780GEOMETRY hd44780Geometry40x2;
 
 
 /*******************************************************************************
@@ -420,6 +793,9 @@ unsigned char       hd44780SetCGRAMAddr(HHD44780 const  hHd44780,
                                         unsigned char   address);
 unsigned char       hd44780SetCursorAddr(HHD44780 const hHd44780,
                                         unsigned char   address);
+unsigned char       hd44780SetCursorPos(HHD44780 const  hHd44780,
+                                        unsigned char   row,
+                                        unsigned char   column);
 unsigned char       hd44780ReadAddr(HHD44780 const      hHd44780,
                                          unsigned char *    address);
 unsigned char       hd44780WriteChar(HHD44780 const        hHd44780,
@@ -428,25 +804,106 @@ unsigned char       hd44780ReadChar(HHD44780 const        hHd44780,
                                           unsigned char *   data);
 const unsigned char *     hd44780WriteRAMString(HHD44780 const        hHd44780,
                                           const unsigned char * string);
+const HD44780_ROM unsigned char * hd44780WriteROMString(
+                                          HHD44780 const    hHd44780,
+                                          const HD44780_ROM unsigned char *
+                                                            string);
 const unsigned char *     hd44780WriteCGRAM(HHD44780 const        hHd44780,
                                           const unsigned char *   character,
                                           unsigned char     font);
+unsigned char       hd44780WriteAt(HHD44780 const       hHd44780,
+                                          unsigned char     row,
+                                          unsigned char     column,
+                                          const unsigned char *   characters,
+                                          unsigned char     length,
+                                          unsigned char     written);
+unsigned char       hd44780WriteCGRAMBlock(HHD44780 const   hHd44780,
+                                          unsigned char     firstCharacter,
+                                          const unsigned char *   characters,
+                                          unsigned char     numberOfCharacters,
+                                          unsigned char     font,
+                                          unsigned char     written);
+unsigned char       hd44780ReadRAMBlock(HHD44780 const      hHd44780,
+                                          unsigned char *   data,
+                                          unsigned char     length,
+                                          unsigned char     read);
 unsigned char       hd44780ReadCGRAM(HHD44780 const        hHd44780,
-                                          const unsigned char *   character,
-                                          unsigned char     font);
+                                          unsigned char     firstCharacter,
+                                          unsigned char *   characters,
+                                          unsigned char     numberOfCharacters,
+                                          unsigned char     font,
+                                          unsigned char     read);
+unsigned char       hd44780ReadScreen(HHD44780 const       hHd44780,
+                                          unsigned char *   screen,
+                                          unsigned char     read);
 unsigned int        hd44780InstructionInit(HHD44780 const   hHd44780,
                                            HD44780CLONE     hd44780Clone,
                                            unsigned char    functionSet,
                                            unsigned char    displayOnOffControl,
                                            unsigned char    entryModeSet);
+unsigned int        hd44780InstructionInitAll(HD44780INIT * const displays,
+                                              unsigned char numberOfDisplays);
+unsigned char       hd44780SetTimedMode(HHD44780 const      hHd44780,
+                                        HD44780CLONE        hd44780Clone,
+                                        unsigned int (*pGetMicroseconds)(void));
+unsigned char       hd44780SetBroadcastMode(HHD44780 const  hHd44780,
+                                        const HD44780CLONE * hd44780Clones,
+                                        unsigned char       numberOfClones,
+                                        unsigned int (*pGetMicroseconds)(void));
+unsigned char       hd44780AttachQueue(HHD44780 const       hHd44780,
+                                       HD44780CMD *         queue,
+                                       unsigned char        queueSize,
+                                       void (*pCommandDone)(HHD44780 const,
+                                                            HD44780SEQ));
+HD44780SEQ          hd44780Enqueue(HHD44780 const           hHd44780,
+                                   HD44780COMMAND           command,
+                                   unsigned char            value,
+                                   const unsigned char *    data);
+unsigned char       hd44780Service(HHD44780 const           hHd44780);
+void                hd44780Tick(void);
+unsigned char       hd44780ServiceAll(void);
+unsigned char       hd44780IsDone(HHD44780 const            hHd44780,
+                                  HD44780SEQ                sequence);
+unsigned char       hd44780AttachGeometry(HHD44780 const    hHd44780,
+                                    const HD44780GEOMETRY * geometry);
+unsigned char       hd44780AttachShadow(HHD44780 const      hHd44780,
+                                        unsigned char *     shadowBuffer);
+unsigned char       hd44780CommitFrame(HHD44780 const       hHd44780,
+                                       const unsigned char * frame);
+unsigned char       hd44780AttachGlyphCache(HHD44780 const  hHd44780,
+                                    HD44780GLYPHCACHE *     glyphCache,
+                                    const unsigned char  (* glyphs)
+                                                            [CGRAMFONT_5X8],
+                                    unsigned char           numberOfGlyphs);
+unsigned char       hd44780PinGlyph(HHD44780 const          hHd44780,
+                                    unsigned char           glyph,
+                                    unsigned char           pin);
+unsigned char       hd44780CommitGlyphFrame(HHD44780 const  hHd44780,
+                                    const HD44780CELL *     frame);
+unsigned char       hd44780AttachVirtual(HD44780VIRTUAL * const virtualDisplay,
+                                    HHD44780 const          hTopHd44780,
+                                    HHD44780 const          hBottomHd44780);
+unsigned char       hd44780SetVirtualCursorPos(
+                                    HD44780VIRTUAL * const  virtualDisplay,
+                                    unsigned char           row,
+                                    unsigned char           column);
+unsigned char       hd44780WriteVirtualAt(
+                                    HD44780VIRTUAL * const  virtualDisplay,
+                                    unsigned char           row,
+                                    unsigned char           column,
+                                    const unsigned char *   characters,
+                                    unsigned char           length,
+                                    unsigned char           written);
+unsigned char       hd44780CommitVirtualFrame(
+                                    HD44780VIRTUAL * const  virtualDisplay,
+                                    const unsigned char *   frame);
 
 /*******************************************************************************
 *                              CONFIGURATION ERRORS
 *******************************************************************************/
-//<Add all pre-processor error messages here>
-//#ifndef <Important Define>
-//#error Important header file is missing!
-//#endif
+#if HD44780_MAXOBJECTS < 1 || HD44780_MAXOBJECTS > 0xFFFF
+#error HD44780_MAXOBJECTS must be between 1 and 65535
+#endif
 
 
 /*******************************************************************************
@@ -0,0 +1,487 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE BUS MUTEX HOST STRESS TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the unmodified PIC32 LCD interface module (lcdif_c32.c) on a host PC
+* with several LCD interfaces sharing one parallel bus, as in the "dual LCD,
+* single PBIF" use case, each driven by a thread of its own. Every thread
+* takes the bus with lcdifGetPb(), writes to its display and returns the bus
+* as fast as it can, sometimes giving up the processor while holding it. The
+* program checks that no two threads ever held the bus at once, that a write
+* made without the bus is refused, that an interface can't return a bus it
+* doesn't own and that the owner and contention counters add up. It reports
+* what an uncontended lcdifGetPb() and lcdifReturnPb() pair costs.
+*
+* Filename : lcdifTestHostMutex.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on a Linux PC:
+*   gcc -O2 -pthread -D__PIC32MX__ -DPBIF_MUTEXSTATS=1
+*       -I../HD44780Sim/pic32 -I../lcdif_module
+*       lcdifTestHostMutex.c ../lcdif_module/lcdif_c32.c
+*       -o lcdifTestHostMutex
+*   ./lcdifTestHostMutex
+* The program returns 0 if all tests passed.
+* The GPIO registers are plain variables here, as no bus cycles are decoded,
+* so the pin level simulator is not needed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*               LCD INTERFACE MODULE BUS MUTEX HOST STRESS TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <p32xxxx.h>
+#include "lcdif_c32.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFTHREADS     4
+#define ITERATIONS          200000
+                                        /* Every this many iterations a       */
+                                        /* thread yields while holding the    */
+                                        /* bus, so the others find it taken   */
+#define YIELDINTERVAL       64
+#define TIMINGPAIRS         10000000
+                                        /* Pins as on the PICDEM 2 Plus GREEN */
+                                        /* board                              */
+#define RS_PIN              (1 << 4)
+#define RW_PIN              (1 << 5)
+#define E_PIN               (1 << 6)
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTTHREAD
+* Description:
+*   One LCD interface on the shared bus and the thread driving it
+*******************************************************************************/
+typedef struct TESTTHREADTYPE {
+    PBIFLCDENOBJ                    pbIfLcdEn;
+    volatile unsigned int           eLat;
+    LCDIFOBJ                        lcdIfObj;
+    LCDIFNUM                        lcdIfNum;
+    HLCDIF                          hLcdIf;
+    pthread_t                       thread;
+    unsigned long                   taken;
+    unsigned long                   refused;
+    unsigned long                   violations;
+} TESTTHREAD;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static PBIFOBJ              pbIf;
+static TESTTHREAD           threads[NUMBEROFTHREADS];
+                                        /* Stand-ins for the shared GPIO      */
+                                        /* registers                          */
+static volatile unsigned int controlLat;
+static volatile unsigned int dataLat;
+static volatile unsigned int dataPort;
+static volatile unsigned int dataTris;
+                                        /* Written only while holding the     */
+                                        /* bus, without atomic operations     */
+static volatile HLCDIF      busHolder;
+static volatile unsigned long busUses;
+static pthread_barrier_t    startBarrier;
+static unsigned int         testFailures;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testOwnership(void);
+static void testStress(void);
+static void * stressThread(void * argument);
+static void testTiming(void);
+static void check(int condition, const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+#if !PBIF_MUTEXSTATS
+#error This test program must be built with PBIF_MUTEXSTATS=1
+#endif
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned int        counter;
+    TESTTHREAD        * thread;
+
+    testFailures = 0;
+
+    pbIf.RW_LAT     = &controlLat;
+    pbIf.RW_BIT     = RW_PIN;
+    pbIf.RS_LAT     = &controlLat;
+    pbIf.RS_BIT     = RS_PIN;
+    pbIf.DATA_LAT   = &dataLat;
+    pbIf.DATA_PORT  = &dataPort;
+    pbIf.DATA_TRIS  = &dataTris;
+    pbIf.DATA_MASK  = 0xFF;
+    pbIf.RW_LATSET  = &controlLat;
+    pbIf.RW_LATCLR  = &controlLat;
+    pbIf.RS_LATSET  = &controlLat;
+    pbIf.RS_LATCLR  = &controlLat;
+    pbIf.DATA_LATINV = &dataLat;
+    pbIf.DATA_TRISSET = &dataTris;
+    pbIf.DATA_TRISCLR = &dataTris;
+
+    lcdifInit();
+                                        /* One LCD interface per thread, each */
+                                        /* with an E pin of its own           */
+    for (counter = 0; counter < NUMBEROFTHREADS; counter++)
+    {
+        thread = &threads[counter];
+        thread->pbIfLcdEn.E_LAT = &thread->eLat;
+        thread->pbIfLcdEn.E_BIT = E_PIN;
+        thread->pbIfLcdEn.E_LATSET = &thread->eLat;
+        thread->pbIfLcdEn.E_LATCLR = &thread->eLat;
+        thread->lcdIfObj.pbIfObject = &pbIf;
+        thread->lcdIfObj.pbIfLcdEnObject = &thread->pbIfLcdEn;
+        thread->lcdIfNum = lcdifCreate(&thread->lcdIfObj);
+        thread->hLcdIf = lcdifOpen(thread->lcdIfNum);
+        check(thread->hLcdIf != (HLCDIF) 0, "lcdifOpen");
+    }
+
+    testOwnership();
+    testStress();
+    testTiming();
+
+    for (counter = 0; counter < NUMBEROFTHREADS; counter++)
+    {
+        lcdifClose(threads[counter].hLcdIf);
+        lcdifDestroy(threads[counter].lcdIfNum);
+    }
+    lcdifDeinit();
+
+    printf("\n%s: %u check(s) failed\n",
+           testFailures ? "FAIL" : "PASS", testFailures);
+
+    return (int) testFailures;
+}
+
+/*******************************************************************************
+* testOwnership()
+*
+* Description:
+*   Checks from a single thread that only the owner of the bus may use it or
+*   return it
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testOwnership(void)
+{
+    HLCDIF              hLcdIf0 = threads[0].hLcdIf;
+    HLCDIF              hLcdIf1 = threads[1].hLcdIf;
+    unsigned int        latBefore;
+
+    printf("\nOwnership\n");
+
+    check(lcdifGetPb(hLcdIf0) == 1, "free bus is taken");
+    check(pbIf.mutexOwner == (void *) hLcdIf0, "owner noted");
+    check(lcdifGetPb(hLcdIf0) == 0, "mutex is not recursive");
+    check(lcdifGetPb(hLcdIf1) == 0, "held bus is refused");
+                                        /* Writing without the bus must not   */
+                                        /* touch the pins                     */
+    latBefore = dataLat;
+    check(lcdifWriteData(hLcdIf1, (unsigned char) ~latBefore) == 0 &&
+          dataLat == latBefore && threads[1].eLat == 0,
+          "write without the bus is refused");
+                                        /* Only the owner can return it       */
+    lcdifReturnPb(hLcdIf1);
+    check(pbIf.mutexOwner == (void *) hLcdIf0 && lcdifGetPb(hLcdIf1) == 0,
+          "non-owner can't return the bus");
+    check(lcdifWriteData(hLcdIf0, 0x5A) == 1 && (dataLat & 0xFF) == 0x5A,
+          "owner writes");
+    lcdifReturnPb(hLcdIf0);
+    check(pbIf.mutexOwner == (void *) 0 && pbIf.mutex == 0, "bus returned");
+    check(lcdifGetPb(hLcdIf1) == 1, "returned bus is taken");
+    lcdifReturnPb(hLcdIf1);
+
+    check(pbIf.mutexTaken == 2, "taken count");
+    check(pbIf.mutexContended == 3, "contended count");
+    printf("    bus taken %u times, found in use %u times\n",
+           pbIf.mutexTaken, pbIf.mutexContended);
+}
+
+/*******************************************************************************
+* testStress()
+*
+* Description:
+*   Has every thread take, use and return the shared bus as fast as it can
+*   and checks that they excluded each other
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testStress(void)
+{
+    unsigned int        counter;
+    unsigned long       taken = 0;
+    unsigned long       refused = 0;
+    unsigned long       violations = 0;
+    unsigned int        takenBefore;
+    unsigned int        contendedBefore;
+
+    printf("\nStress, %u threads of %u iterations\n", NUMBEROFTHREADS,
+           ITERATIONS);
+
+    takenBefore = pbIf.mutexTaken;
+    contendedBefore = pbIf.mutexContended;
+    busHolder = (HLCDIF) 0;
+    busUses = 0;
+    pthread_barrier_init(&startBarrier, NULL, NUMBEROFTHREADS);
+
+    for (counter = 0; counter < NUMBEROFTHREADS; counter++)
+    {
+        check(pthread_create(&threads[counter].thread, NULL, stressThread,
+                             &threads[counter]) == 0, "pthread_create");
+    }
+    for (counter = 0; counter < NUMBEROFTHREADS; counter++)
+    {
+        pthread_join(threads[counter].thread, NULL);
+        taken += threads[counter].taken;
+        refused += threads[counter].refused;
+        violations += threads[counter].violations;
+        printf("    thread %u: bus taken %lu times, refused %lu times\n",
+               counter, threads[counter].taken, threads[counter].refused);
+    }
+    pthread_barrier_destroy(&startBarrier);
+
+    check(violations == 0, "no two threads held the bus at once");
+    check(busUses == taken, "no update made under the bus was lost");
+    check(refused > 0, "threads contended for the bus");
+    check(pbIf.mutexTaken - takenBefore == taken, "taken count");
+    check(pbIf.mutexContended - contendedBefore == refused,
+          "contended count");
+    check(pbIf.mutex == 0 && pbIf.mutexOwner == (void *) 0, "bus left free");
+}
+
+/*******************************************************************************
+* stressThread()
+*
+* Description:
+*   Body of each stress test thread
+*
+* See also:
+*
+* Arguments:
+*   argument            - the thread's TESTTHREAD
+*
+* Returns:
+*   NULL
+*
+* Callers: pthread_create()
+*
+* Notes :
+* 1. All the threads are released together by startBarrier
+* 2. While holding the bus the thread notes itself as the holder and adds one
+*    to a shared count without atomic operations. Another thread inside at
+*    the same time shows up as a changed holder or a lost count
+*
+*******************************************************************************/
+static void * stressThread(void * argument)
+{
+    TESTTHREAD        * thread = (TESTTHREAD *) argument;
+    HLCDIF              hLcdIf = thread->hLcdIf;
+    unsigned long       iteration;
+
+    thread->taken = 0;
+    thread->refused = 0;
+    thread->violations = 0;
+    pthread_barrier_wait(&startBarrier);
+
+    for (iteration = 0; iteration < ITERATIONS; iteration++)
+    {
+                                        /* Let the holder finish, as a task   */
+                                        /* refused the bus would              */
+        if (!lcdifGetPb(hLcdIf))
+        {
+            thread->refused++;
+            sched_yield();
+            continue;
+        }
+
+        if (busHolder != (HLCDIF) 0 || pbIf.mutexOwner != (void *) hLcdIf)
+        {
+            thread->violations++;
+        }
+        busHolder = hLcdIf;
+        busUses = busUses + 1;
+
+        lcdifWriteData(hLcdIf, (unsigned char) iteration);
+        if (iteration % YIELDINTERVAL == 0)
+        {
+            sched_yield();
+        }
+
+        if (busHolder != hLcdIf)
+        {
+            thread->violations++;
+        }
+        busHolder = (HLCDIF) 0;
+        thread->taken++;
+        lcdifReturnPb(hLcdIf);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+* testTiming()
+*
+* Description:
+*   Measures an uncontended lcdifGetPb() and lcdifReturnPb() pair
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testTiming(void)
+{
+    HLCDIF              hLcdIf = threads[0].hLcdIf;
+    struct timespec     start;
+    struct timespec     end;
+    unsigned long       counter;
+    unsigned long       failures = 0;
+    double              elapsed;
+
+    printf("\nTiming\n");
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (counter = 0; counter < TIMINGPAIRS; counter++)
+    {
+        if (!lcdifGetPb(hLcdIf))
+        {
+            failures++;
+        }
+        lcdifReturnPb(hLcdIf);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    elapsed = (end.tv_sec - start.tv_sec) * 1e9 +
+              (end.tv_nsec - start.tv_nsec);
+    printf("    %.1f ns per lcdifGetPb() and lcdifReturnPb() pair\n",
+           elapsed / TIMINGPAIRS);
+    check(failures == 0, "uncontended bus is always taken");
+}
+
+/*******************************************************************************
+* check()
+*
+* Description:
+*   Records and reports the result of one test check
+*
+* See also:
+*
+* Arguments:
+*   condition           - non-zero if the check passed
+*   description         - what was checked
+*
+* Returns:
+*   void
+*
+* Callers: main(), testOwnership(), testStress(), testTiming()
+*
+* Notes :
+*
+*******************************************************************************/
+static void check(int condition, const char * description)
+{
+    if (!condition)
+    {
+        printf("    FAILED: %s\n", description);
+        testFailures++;
+    }
+}
+
+
+/*******************************************************************************
+*
+*           LCD INTERFACE MODULE BUS MUTEX HOST STRESS TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,632 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE PCF8574 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the unmodified PCF8574 I2C backpack LCD interface module
+* (lcdif_pcf8574.c) on a host PC against a model of an I2C bus carrying two
+* backpacks, checks that the port changes it sends form correct HD44780 write
+* cycles and reports how many START conditions and bits on the wire each LCD
+* interface call costs per character.
+*
+* The first display is told the I2C clock, so a block write goes out as one
+* transaction. The second isn't, so its block writes are paced with the time
+* source, one transaction per character. The first display is then run with
+* the bus at 1MHz, where each character is no longer slow enough on its own
+* and padding bytes have to be added. The bit counts are checked against
+* fixed limits so that any change to the packing that costs bus time fails.
+*
+* Filename : lcdifTestHostPcf8574.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on a PC:
+*   gcc -I../HD44780Sim -I../lcdif_module
+*       lcdifTestHostPcf8574.c ../lcdif_module/lcdif_pcf8574.c
+*       ../HD44780Sim/hd44780simpcf8574.c ../HD44780Sim/hd44780sim.c
+*       -o lcdifTestHostPcf8574
+*   ./lcdifTestHostPcf8574
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                  LCD INTERFACE MODULE PCF8574 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "lcdif_pcf8574.h"
+#include "hd44780simpcf8574.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define PACKED_ADDRESS      0x27
+#define TIMED_ADDRESS       0x3F
+#define MISSING_ADDRESS     0x20
+#define I2C_CLOCK_KHZ       100
+#define FAST_CLOCK_KHZ      1000
+                                        /* One transaction per port change:   */
+                                        /* START, address, one byte and STOP  */
+#define BITS_PER_CHANGE     (1 + 9 + 9 + 1)
+                                        /* Limit for a packed block: the four */
+                                        /* port changes of one character plus */
+                                        /* its share of the START, address,   */
+                                        /* STOP and RS set-up bytes           */
+#define MAX_BLOCK_BITS      (4 * 9 + 2)
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMEASUREMENT
+* Description:
+*   START conditions, bits on the wire, port writes, E cycles and simulated
+*   time used by one or more LCD interface calls
+*******************************************************************************/
+typedef struct TESTMEASUREMENTTYPE {
+    unsigned long                   startStarts;
+    unsigned long                   startBits;
+    unsigned long                   startPortWrites;
+    unsigned long                   startCycles;
+    HD44780SIMTIME                  startTime;
+} TESTMEASUREMENT;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char message[] = "PCF8574 on a host!";
+                                        /* Cursor on, then off again; entry   */
+                                        /* mode increment                     */
+static const unsigned char instructions[] = { 0x0E, 0x0C, 0x06 };
+static HD44780SIM           packedSim;
+static HD44780SIM           timedSim;
+static HD44780SIM         * currentSim;
+static unsigned int         testFailures;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testDisplay(HLCDIF hLcdIf, HD44780SIM * sim, unsigned char packed);
+static void testFastClock(HLCDIF hLcdIf);
+static void initByInstruction(HLCDIF hLcdIf);
+static void fillWiring(LCDIFOBJ * lcdIfObj, unsigned char address);
+static unsigned int getMicroseconds(void);
+static void startMeasurement(TESTMEASUREMENT * measurement);
+static double endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                             unsigned int calls);
+static void check(int condition, const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    HD44780SIMPCF8574       packedExpander;
+    HD44780SIMPCF8574       timedExpander;
+    HD44780SIMPCF8574STATS  busStats;
+    LCDIFOBJ                packedObj;
+    LCDIFOBJ                timedObj;
+    LCDIFOBJ                missingObj;
+    LCDIFOBJ                badObj;
+    LCDIFNUM                packedNum;
+    LCDIFNUM                timedNum;
+    LCDIFNUM                missingNum;
+    HLCDIF                  hPacked;
+    HLCDIF                  hTimed;
+    HLCDIF                  hMissing;
+
+    testFailures = 0;
+                                        /* Power on both displays and wire    */
+                                        /* them to the simulated I2C bus      */
+    hd44780simResetTime();
+    hd44780simInit(&packedSim, 0);
+    hd44780simInit(&timedSim, 0);
+    hd44780simPcf8574Init();
+    hd44780simPcf8574SetClock(I2C_CLOCK_KHZ);
+    packedExpander.hd44780Sim = &packedSim;
+    packedExpander.address = PACKED_ADDRESS;
+    packedExpander.RS_BIT = LCDIF_BACKPACK_RS;
+    packedExpander.RW_BIT = LCDIF_BACKPACK_RW;
+    packedExpander.E_BIT = LCDIF_BACKPACK_E;
+    packedExpander.DATA_SHIFT = LCDIF_BACKPACK_DATA;
+    timedExpander = packedExpander;
+    timedExpander.hd44780Sim = &timedSim;
+    timedExpander.address = TIMED_ADDRESS;
+    check(hd44780simPcf8574Connect(&packedExpander),
+          "hd44780simPcf8574Connect");
+    check(hd44780simPcf8574Connect(&timedExpander),
+          "hd44780simPcf8574Connect");
+
+    lcdifInit();
+                                        /* Objects that can't work are        */
+                                        /* refused                            */
+    fillWiring(&badObj, PACKED_ADDRESS);
+    badObj.RW_BIT = LCDIF_BACKPACK_E;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with R/W as E");
+    fillWiring(&badObj, PACKED_ADDRESS);
+    badObj.RS_BIT = LCDIF_BACKPACK_DATA + 1;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with RS as DB5");
+    fillWiring(&badObj, PACKED_ADDRESS);
+    badObj.OTHER_BITS |= 1u << LCDIF_BACKPACK_RW;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with R/W held high");
+    fillWiring(&badObj, 0x80);
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with 8-bit address");
+
+    fillWiring(&packedObj, PACKED_ADDRESS);
+    fillWiring(&timedObj, TIMED_ADDRESS);
+    timedObj.i2cClockKHz = 0;
+    fillWiring(&missingObj, MISSING_ADDRESS);
+    packedNum = lcdifCreate(&packedObj);
+    timedNum = lcdifCreate(&timedObj);
+    missingNum = lcdifCreate(&missingObj);
+    hPacked = lcdifOpen(packedNum);
+    hTimed = lcdifOpen(timedNum);
+    hMissing = lcdifOpen(missingNum);
+    check(hPacked != (HLCDIF) 0 && hTimed != (HLCDIF) 0 &&
+          hMissing != (HLCDIF) 0, "lcdifOpen");
+                                        /* The I2C bus goes to one at a time  */
+    check(lcdifWriteData(hPacked, 'X') == 0, "lcdifWriteData without bus");
+    check(lcdifGetPb(hPacked), "lcdifGetPb");
+    check(lcdifGetPb(hTimed) == 0, "I2C bus kept by its owner");
+    lcdifReturnPb(hPacked);
+                                        /* A backpack that isn't there fails  */
+    check(lcdifGetPb(hMissing), "lcdifGetPb");
+    check(lcdifWriteInstruction(hMissing, 0x01) == 0 &&
+          lcdifWriteDataBlock(hMissing, message, 4, getMicroseconds, 37) == 0,
+          "writes to missing backpack fail");
+    lcdifReturnPb(hMissing);
+    hd44780simPcf8574GetStats(&busStats);
+    check(busStats.nacks == 2 && busStats.portWrites == 0,
+          "missing backpack not acknowledged");
+
+    testDisplay(hPacked, &packedSim, 1);
+    testDisplay(hTimed, &timedSim, 0);
+    testFastClock(hPacked);
+
+    lcdifClose(hPacked);
+    lcdifClose(hTimed);
+    lcdifClose(hMissing);
+    lcdifDestroy(packedNum);
+    lcdifDestroy(timedNum);
+    lcdifDestroy(missingNum);
+    lcdifDeinit();
+
+    printf("\n%s: %u check(s) failed\n",
+           testFailures ? "FAIL" : "PASS", testFailures);
+
+    return (int) testFailures;
+}
+
+/*******************************************************************************
+* testDisplay()
+*
+* Description:
+*   Runs the complete test sequence on one display with the bus at 100kHz
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the display's open LCD interface
+*   sim                 - the display's simulated controller
+*   packed              - 1 if the LCD interface knows the I2C clock
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testDisplay(HLCDIF hLcdIf, HD44780SIM * sim, unsigned char packed)
+{
+    HD44780SIMPCF8574STATS  busStats;
+    TESTMEASUREMENT         measurement;
+    HD44780SIM            * otherSim;
+    unsigned long           otherCycles;
+    unsigned long           portChanges;
+    unsigned char           readData = 0;
+    unsigned int            interval;
+    unsigned char           counter;
+    double                  bits;
+
+    currentSim = sim;
+    otherSim = (sim == &packedSim) ? &timedSim : &packedSim;
+    otherCycles = otherSim->stats.writeCycles;
+    hd44780simPcf8574ClearStats();
+
+    printf("\n%s at %ukHz\n", packed ? "Block writes in one transaction" :
+                                       "Block writes paced by the time source",
+           I2C_CLOCK_KHZ);
+    printf("    %-26s %8s %8s %8s %8s\n", "call", "STARTs", "bits",
+           "E cycles", "us");
+
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+    check(lcdifGetPbBusWidth(hLcdIf) == BUS4BITSWIDE, "4-bit bus");
+    check(lcdifReadData(hLcdIf, &readData) == 0 &&
+          lcdifReadAddress(hLcdIf, &readData) == 0, "reads refused");
+
+    initByInstruction(hLcdIf);
+    check(hd44780simIs4BitMode(sim) && sim->functionSet == 0x28,
+          "function set");
+                                        /* Write a line of text               */
+    startMeasurement(&measurement);
+    for (counter = 0; message[counter] != 0; counter++)
+    {
+        lcdifWriteData(hLcdIf, message[counter]);
+    }
+    endMeasurement(&measurement, "lcdifWriteData", counter);
+    check(memcmp(sim->ddram, message, counter) == 0, "DDRAM contents");
+                                        /* The text again on line two, now as */
+                                        /* one block paced by the execution   */
+                                        /* time of a data write               */
+    interval = (unsigned int) ((hd44780simGetExecTime(0, 1, 0) + 999) / 1000);
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x40);
+    startMeasurement(&measurement);
+    lcdifWriteDataBlock(hLcdIf, message, counter, getMicroseconds, interval);
+    bits = endMeasurement(&measurement, "lcdifWriteDataBlock", counter);
+    check(memcmp(&sim->ddram[0x40], message, counter) == 0,
+          "DDRAM contents after block");
+    hd44780simPcf8574GetStats(&busStats);
+    portChanges = busStats.portWrites - measurement.startPortWrites;
+    if (packed)
+    {
+        check(busStats.starts - measurement.startStarts == 1,
+              "one START per block");
+        check(bits <= MAX_BLOCK_BITS, "bits per character in a block");
+    }
+    else
+    {
+        check(busStats.starts - measurement.startStarts == counter,
+              "one START per character");
+    }
+
+    startMeasurement(&measurement);
+    lcdifWriteInstructionBlock(hLcdIf, instructions, sizeof(instructions),
+                               getMicroseconds, interval);
+    endMeasurement(&measurement, "lcdifWriteInstructionBlock",
+                   sizeof(instructions));
+    check(sim->displayControl == 0x0C && sim->entryMode == 0x06,
+          "instruction block");
+    hd44780simDelay(40);
+
+    lcdifReturnPb(hLcdIf);
+
+    hd44780simPcf8574GetStats(&busStats);
+    check(sim->stats.violations == 0, "no writes while busy");
+    check(busStats.violations == 0, "E timing met");
+    check(otherSim->stats.writeCycles == otherCycles,
+          "other display not strobed");
+    printf("    one transaction per port change would need %.1f bits per "
+           "character\n", (double) portChanges * BITS_PER_CHANGE / counter);
+}
+
+/*******************************************************************************
+* testFastClock()
+*
+* Description:
+*   Writes a block with the bus at 1MHz, where padding bytes are needed to
+*   give the controller its execution time
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the first display's open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testFastClock(HLCDIF hLcdIf)
+{
+    HD44780SIMPCF8574STATS  busStats;
+    TESTMEASUREMENT         measurement;
+    unsigned int            interval;
+    unsigned int            length;
+
+    currentSim = &packedSim;
+    length = sizeof(message) - 1;
+    interval = (unsigned int) ((hd44780simGetExecTime(0, 1, 0) + 999) / 1000);
+
+    printf("\nBlock writes in one transaction at %ukHz\n", FAST_CLOCK_KHZ);
+    printf("    %-26s %8s %8s %8s %8s\n", "call", "STARTs", "bits",
+           "E cycles", "us");
+
+    hd44780simPcf8574SetClock(FAST_CLOCK_KHZ);
+    hLcdIf->i2cClockKHz = FAST_CLOCK_KHZ;
+    hd44780simPcf8574ClearStats();
+    hd44780simClearStats(&packedSim);
+
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x14);
+    hd44780simDelay(40);
+    startMeasurement(&measurement);
+    lcdifWriteDataBlock(hLcdIf, message, (unsigned char) length,
+                        getMicroseconds, interval);
+    endMeasurement(&measurement, "lcdifWriteDataBlock", length);
+    hd44780simDelay(40);
+    lcdifReturnPb(hLcdIf);
+
+    hd44780simPcf8574GetStats(&busStats);
+    check(memcmp(&packedSim.ddram[0x14], message, length) == 0,
+          "DDRAM contents after fast block");
+    check(busStats.starts - measurement.startStarts == 1,
+          "one START per block");
+    check(busStats.portWrites - measurement.startPortWrites > 4 * length,
+          "padding added");
+    check(packedSim.stats.violations == 0, "no writes while busy");
+    check(busStats.violations == 0, "E timing met");
+
+    hd44780simPcf8574SetClock(I2C_CLOCK_KHZ);
+    hLcdIf->i2cClockKHz = I2C_CLOCK_KHZ;
+}
+
+/*******************************************************************************
+* initByInstruction()
+*
+* Description:
+*   Puts the display into 4-bit mode with the "Initialising by Instruction"
+*   sequence, then switches it on, clears it and sets increment mode
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: testDisplay()
+*
+* Notes :
+* 1. At 100kHz each write takes longer than all but the slowest instructions
+*    take to execute, so only those are waited for
+*
+*******************************************************************************/
+static void initByInstruction(HLCDIF hLcdIf)
+{
+    TESTMEASUREMENT     measurement;
+
+    hd44780simDelay(15000);
+    startMeasurement(&measurement);
+    lcdif4BitFunctionSet(hLcdIf, 0x03);
+    endMeasurement(&measurement, "lcdif4BitFunctionSet", 1);
+    hd44780simDelay(4100);
+    lcdif4BitFunctionSet(hLcdIf, 0x03);
+    hd44780simDelay(100);
+    lcdif4BitFunctionSet(hLcdIf, 0x03);
+    lcdif4BitFunctionSet(hLcdIf, 0x02);
+    startMeasurement(&measurement);
+    lcdifWriteInstruction(hLcdIf, 0x28);
+    endMeasurement(&measurement, "lcdifWriteInstruction", 1);
+    lcdifWriteInstruction(hLcdIf, 0x0C);
+    lcdifWriteInstruction(hLcdIf, 0x01);
+    hd44780simDelay(1640);
+    lcdifWriteInstruction(hLcdIf, 0x06);
+}
+
+/*******************************************************************************
+* fillWiring()
+*
+* Description:
+*   Fills in an LCD interface object for a backpack with the usual wiring and
+*   its backlight on
+*
+* See also:
+*
+* Arguments:
+*   lcdIfObj            - object to fill in
+*   address             - 7-bit I2C address of the backpack
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void fillWiring(LCDIFOBJ * lcdIfObj, unsigned char address)
+{
+    lcdIfObj->pI2cWrite = hd44780simPcf8574Write;
+    lcdIfObj->i2cAddress = address;
+    lcdIfObj->RS_BIT = LCDIF_BACKPACK_RS;
+    lcdIfObj->RW_BIT = LCDIF_BACKPACK_RW;
+    lcdIfObj->E_BIT = LCDIF_BACKPACK_E;
+    lcdIfObj->DATA_SHIFT = LCDIF_BACKPACK_DATA;
+    lcdIfObj->OTHER_BITS = LCDIF_BACKPACK_LIGHT;
+    lcdIfObj->i2cClockKHz = I2C_CLOCK_KHZ;
+}
+
+/*******************************************************************************
+* getMicroseconds()
+*
+* Description:
+*   Free running microsecond count used to pace block transfers
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Simulated time in microseconds
+*
+* Callers: LCD interface module
+*
+* Notes :
+* 1. Each call lets one bus cycle time pass, standing in for the time the
+*    code polling it would take on the target
+*
+*******************************************************************************/
+static unsigned int getMicroseconds(void)
+{
+    hd44780simAdvance(hd44780simGetCycleTime());
+
+    return (unsigned int) (hd44780simGetTime() / 1000ULL);
+}
+
+/*******************************************************************************
+* startMeasurement()
+*
+* Description:
+*   Notes the bus counters, E cycles and time before an LCD interface call
+*
+* See also:
+*   endMeasurement()
+*
+* Arguments:
+*   measurement         - where to store the starting point
+*
+* Returns:
+*   void
+*
+* Callers: testDisplay(), testFastClock(), initByInstruction()
+*
+* Notes :
+*
+*******************************************************************************/
+static void startMeasurement(TESTMEASUREMENT * measurement)
+{
+    HD44780SIMPCF8574STATS  busStats;
+
+    hd44780simPcf8574GetStats(&busStats);
+    measurement->startStarts = busStats.starts;
+    measurement->startBits = busStats.bits;
+    measurement->startPortWrites = busStats.portWrites;
+    measurement->startCycles = currentSim->stats.writeCycles;
+    measurement->startTime = hd44780simGetTime();
+}
+
+/*******************************************************************************
+* endMeasurement()
+*
+* Description:
+*   Prints the START conditions, bits on the wire, E cycles and time used per
+*   call since startMeasurement()
+*
+* See also:
+*   startMeasurement()
+*
+* Arguments:
+*   measurement         - starting point
+*   name                - name of the measured call
+*   calls               - number of calls, or characters in a block
+*
+* Returns:
+*   Bits on the wire per call
+*
+* Callers: testDisplay(), testFastClock(), initByInstruction()
+*
+* Notes :
+*
+*******************************************************************************/
+static double endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                             unsigned int calls)
+{
+    HD44780SIMPCF8574STATS  busStats;
+    double                  bits;
+
+    hd44780simPcf8574GetStats(&busStats);
+    bits = (double) (busStats.bits - measurement->startBits) / calls;
+
+    printf("    %-26s %8.2f %8.1f %8.1f %8.1f\n", name,
+           (double) (busStats.starts - measurement->startStarts) / calls,
+           bits,
+           (double) (currentSim->stats.writeCycles -
+                     measurement->startCycles) / calls,
+           (double) (hd44780simGetTime() - measurement->startTime) /
+                                                            (1000.0 * calls));
+
+    return bits;
+}
+
+/*******************************************************************************
+* check()
+*
+* Description:
+*   Records and reports the result of one test check
+*
+* See also:
+*
+* Arguments:
+*   condition           - non-zero if the check passed
+*   description         - what was checked
+*
+* Returns:
+*   void
+*
+* Callers: main(), testDisplay(), testFastClock()
+*
+* Notes :
+*
+*******************************************************************************/
+static void check(int condition, const char * description)
+{
+    if (!condition)
+    {
+        printf("    FAILED: %s\n", description);
+        testFailures++;
+    }
+}
+
+
+/*******************************************************************************
+*
+*                LCD INTERFACE MODULE PCF8574 HOST TEST PROGRAM END
+*
+*******************************************************************************/
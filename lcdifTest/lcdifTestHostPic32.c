@@ -0,0 +1,695 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE PIC32 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the unmodified PIC32 LCD interface module (lcdif_c32.c) on a host PC
+* against the pin level simulator, checks that what it does to the GPIO
+* registers forms correct HD44780 bus cycles and reports how many register
+* stores each LCD interface call costs, in both 4-bit and 8-bit bus modes.
+* Block transfers are measured per byte, for comparison with single reads and
+* writes.
+* The LCD interface slot table is then filled to capacity.
+*
+* Built with LCDIF_ATOMICPINS=1 the module drives the pins through the SET, CLR
+* and INV registers instead, and the test also checks that no store was made to
+* a LAT or TRIS register directly. Both builds must print the same bus
+* signature for each wiring, showing that they make the same bus cycles.
+*
+* Filename : lcdifTestHostPic32.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on an x86 or x86-64 Linux PC:
+*   gcc -D__PIC32MX__ -DLCDIF_MAXOBJECTS=40
+*       -I../HD44780Sim/pic32 -I../HD44780Sim -I../lcdif_module
+*       lcdifTestHostPic32.c ../lcdif_module/lcdif_c32.c
+*       ../HD44780Sim/hd44780simpic32.c ../HD44780Sim/hd44780sim.c
+*       -o lcdifTestHostPic32
+*   ./lcdifTestHostPic32
+* and again with -DLCDIF_ATOMICPINS=1 added to the gcc command line.
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                    LCD INTERFACE MODULE PIC32 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include <p32xxxx.h>
+#include "lcdif_c32.h"
+#include "hd44780simpic32.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+#define NUMBEROFCONFIGS     3
+                                        /* Pins as on the PICDEM 2 Plus GREEN */
+                                        /* board                              */
+#define RS_PIN              (1 << 4)
+#define RW_PIN              (1 << 5)
+#define E_PIN               (1 << 6)
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTCONFIG
+* Description:
+*   One wiring to be tested. In 4-bit mode the data pins are RD0 to RD3 or
+*   RE4 to RE7, in 8-bit mode they are RE0 to RE7
+*******************************************************************************/
+typedef struct TESTCONFIGTYPE {
+    const char                    * name;
+    volatile unsigned int         * dataLat;
+    volatile unsigned int         * dataPort;
+    volatile unsigned int         * dataTris;
+    unsigned int                    dataMask;
+    volatile unsigned int         * dataLatInv;
+    volatile unsigned int         * dataTrisSet;
+    volatile unsigned int         * dataTrisClr;
+} TESTCONFIG;
+
+/*******************************************************************************
+* New data type TESTMEASUREMENT
+* Description:
+*   Register stores and E cycles used by one or more LCD interface calls
+*******************************************************************************/
+typedef struct TESTMEASUREMENTTYPE {
+    unsigned long                   startWrites;
+    unsigned long                   startLatD;
+    unsigned long                   startTrisD;
+    unsigned long                   startData;
+    unsigned long                   startCycles;
+} TESTMEASUREMENT;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+static const TESTCONFIG testConfigs[NUMBEROFCONFIGS] = {
+    { "4-bit bus on RD0-RD3", &LATD, &PORTD, &TRISD, 0x0F,
+      &LATDINV, &TRISDSET, &TRISDCLR },
+    { "8-bit bus on RE0-RE7", &LATE, &PORTE, &TRISE, 0xFF,
+      &LATEINV, &TRISESET, &TRISECLR },
+    { "4-bit bus on RE4-RE7", &LATE, &PORTE, &TRISE, 0xF0,
+      &LATEINV, &TRISESET, &TRISECLR }
+};
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char message[] = "PIC32 on a host!";
+                                        /* Cursor on, then off again; entry   */
+                                        /* mode increment                     */
+static const unsigned char instructions[] = { 0x0E, 0x0C, 0x06 };
+static HD44780SIM           hd44780Sim;
+static const TESTCONFIG   * currentConfig;
+static unsigned int         testFailures;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testConfig(const TESTCONFIG * config);
+static void testSlotTable(void);
+static void waitWhileBusy(HLCDIF hLcdIf);
+static unsigned int getMicroseconds(void);
+static void startMeasurement(TESTMEASUREMENT * measurement);
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                           unsigned int calls);
+static unsigned long getRegisterWrites(volatile unsigned int * reg);
+static void check(int condition, const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    unsigned char       counter;
+
+    testFailures = 0;
+
+    for (counter = 0; counter < NUMBEROFCONFIGS; counter++)
+    {
+        testConfig(&testConfigs[counter]);
+    }
+    testSlotTable();
+
+    printf("\n%s: %u check(s) failed\n",
+           testFailures ? "FAIL" : "PASS", testFailures);
+
+    return (int) testFailures;
+}
+
+/*******************************************************************************
+* testConfig()
+*
+* Description:
+*   Runs the complete test sequence for one wiring
+*
+* See also:
+*
+* Arguments:
+*   config              - wiring to test
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testConfig(const TESTCONFIG * config)
+{
+    HD44780SIMPIC32PINS     simPins;
+    HD44780SIMPIC32STATS    simStats;
+    PBIFOBJ                 pbIf;
+    PBIFLCDENOBJ            pbIfLcdEn;
+    LCDIFOBJ                lcdIfObj;
+    LCDIFNUM                lcdIfNum;
+    HLCDIF                  hLcdIf;
+    TESTMEASUREMENT         measurement;
+    unsigned char           fourBitBus;
+    unsigned char           readData = 0;
+    unsigned char           readAddress = 0;
+    unsigned char           readBlock[sizeof(message)];
+    unsigned char           counter;
+
+    currentConfig = config;
+    fourBitBus = (config->dataMask != 0xFF);
+
+    printf("\n%s\n", config->name);
+    printf("    %-26s %8s %6s %6s %6s %8s\n", "call", "stores", "LATD",
+           "TRISD", "data", "E cycles");
+                                        /* Power on the display and wire it   */
+                                        /* to the simulated PIC32             */
+    hd44780simResetTime();
+    hd44780simInit(&hd44780Sim, 0);
+    hd44780simPic32Init();
+    simPins.hd44780Sim = &hd44780Sim;
+    simPins.RW_LAT = &LATD;
+    simPins.RW_BIT = RW_PIN;
+    simPins.RS_LAT = &LATD;
+    simPins.RS_BIT = RS_PIN;
+    simPins.E_LAT = &LATD;
+    simPins.E_BIT = E_PIN;
+    simPins.DATA_LAT = config->dataLat;
+    simPins.DATA_MASK = config->dataMask;
+    check(hd44780simPic32Connect(&simPins), "hd44780simPic32Connect");
+    check(hd44780simPic32Start(), "hd44780simPic32Start");
+                                        /* Make RW, RS and E lines outputs    */
+    LATDCLR = RW_PIN | RS_PIN | E_PIN;
+    TRISDCLR = RW_PIN | RS_PIN | E_PIN;
+                                        /* Fill parallel bus interface struct */
+    pbIf.RW_LAT     = &LATD;
+    pbIf.RW_BIT     = RW_PIN;
+    pbIf.RS_LAT     = &LATD;
+    pbIf.RS_BIT     = RS_PIN;
+    pbIf.DATA_LAT   = config->dataLat;
+    pbIf.DATA_PORT  = config->dataPort;
+    pbIf.DATA_TRIS  = config->dataTris;
+    pbIf.DATA_MASK  = config->dataMask;
+    pbIf.RW_LATSET  = &LATDSET;
+    pbIf.RW_LATCLR  = &LATDCLR;
+    pbIf.RS_LATSET  = &LATDSET;
+    pbIf.RS_LATCLR  = &LATDCLR;
+    pbIf.DATA_LATINV = config->dataLatInv;
+    pbIf.DATA_TRISSET = config->dataTrisSet;
+    pbIf.DATA_TRISCLR = config->dataTrisClr;
+    pbIfLcdEn.E_LAT = &LATD;
+    pbIfLcdEn.E_BIT = E_PIN;
+    pbIfLcdEn.E_LATSET = &LATDSET;
+    pbIfLcdEn.E_LATCLR = &LATDCLR;
+                                        /* Fill lcd interface struct          */
+    lcdIfObj.pbIfObject = &pbIf;
+    lcdIfObj.pbIfLcdEnObject = &pbIfLcdEn;
+
+    lcdifInit();
+    lcdIfNum = lcdifCreate(&lcdIfObj);
+    hLcdIf = lcdifOpen(lcdIfNum);
+    check(hLcdIf != (HLCDIF) 0, "lcdifOpen");
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+                                        /* Initialising by Instruction        */
+    hd44780simDelay(15000);
+    if (fourBitBus)
+    {
+        startMeasurement(&measurement);
+        lcdif4BitFunctionSet(hLcdIf, 0x03);
+        endMeasurement(&measurement, "lcdif4BitFunctionSet", 1);
+        hd44780simDelay(4100);
+        lcdif4BitFunctionSet(hLcdIf, 0x03);
+        hd44780simDelay(100);
+        lcdif4BitFunctionSet(hLcdIf, 0x03);
+        lcdif4BitFunctionSet(hLcdIf, 0x02);
+        check(hd44780simIs4BitMode(&hd44780Sim), "4-bit mode selected");
+        startMeasurement(&measurement);
+        lcdifWriteInstruction(hLcdIf, 0x28);
+        endMeasurement(&measurement, "lcdifWriteInstruction", 1);
+    }
+    else
+    {
+        lcdifWriteInstruction(hLcdIf, 0x30);
+        hd44780simDelay(4100);
+        lcdifWriteInstruction(hLcdIf, 0x30);
+        hd44780simDelay(100);
+        lcdifWriteInstruction(hLcdIf, 0x30);
+        startMeasurement(&measurement);
+        lcdifWriteInstruction(hLcdIf, 0x38);
+        endMeasurement(&measurement, "lcdifWriteInstruction", 1);
+    }
+    check(hd44780Sim.functionSet == (fourBitBus ? 0x28 : 0x38),
+          "function set");
+
+    startMeasurement(&measurement);
+    waitWhileBusy(hLcdIf);
+    endMeasurement(&measurement, "lcdifReadAddress (poll)", 1);
+                                        /* Display on, clear, increment       */
+    lcdifWriteInstruction(hLcdIf, 0x0C);
+    waitWhileBusy(hLcdIf);
+    lcdifWriteInstruction(hLcdIf, 0x01);
+    waitWhileBusy(hLcdIf);
+    lcdifWriteInstruction(hLcdIf, 0x06);
+    waitWhileBusy(hLcdIf);
+                                        /* Write a line of text               */
+    startMeasurement(&measurement);
+    for (counter = 0; message[counter] != 0; counter++)
+    {
+        lcdifWriteData(hLcdIf, message[counter]);
+        hd44780simDelay(40);
+    }
+    endMeasurement(&measurement, "lcdifWriteData", counter);
+    check(memcmp(hd44780Sim.ddram, message, counter) == 0, "DDRAM contents");
+
+    startMeasurement(&measurement);
+    lcdifReadAddress(hLcdIf, &readAddress);
+    endMeasurement(&measurement, "lcdifReadAddress", 1);
+    check(readAddress == counter, "address counter");
+                                        /* Read back the fourth character     */
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x03);
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifReadData(hLcdIf, &readData);
+    endMeasurement(&measurement, "lcdifReadData", 1);
+    check(readData == message[3], "lcdifReadData");
+                                        /* The text again on line two, now as */
+                                        /* one block                          */
+    waitWhileBusy(hLcdIf);
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x40);
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifWriteDataBlock(hLcdIf, message, counter, getMicroseconds, 37);
+    endMeasurement(&measurement, "lcdifWriteDataBlock", counter);
+    check(memcmp(&hd44780Sim.ddram[0x40], message, counter) == 0,
+          "DDRAM contents after block");
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifWriteInstructionBlock(hLcdIf, instructions, sizeof(instructions),
+                               getMicroseconds, 37);
+    endMeasurement(&measurement, "lcdifWriteInstructionBlock",
+                   sizeof(instructions));
+    check(hd44780Sim.displayControl == 0x0C && hd44780Sim.entryMode == 0x06,
+          "instruction block");
+    waitWhileBusy(hLcdIf);
+                                        /* Read line two back as one block    */
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x40);
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifReadDataBlock(hLcdIf, readBlock, counter, getMicroseconds, 37);
+    endMeasurement(&measurement, "lcdifReadDataBlock", counter);
+    check(memcmp(readBlock, message, counter) == 0, "lcdifReadDataBlock");
+    waitWhileBusy(hLcdIf);
+
+    lcdifReturnPb(hLcdIf);
+
+    hd44780simPic32Stop();
+    hd44780simPic32GetStats(&simStats);
+    check(hd44780Sim.stats.violations == 0, "no writes while busy");
+    check(simStats.busContentions == 0, "no data bus contention");
+#if LCDIF_ATOMICPINS
+    check(hd44780simPic32GetWrites(&LATD) == 0 &&
+          hd44780simPic32GetWrites(&TRISD) == 0 &&
+          hd44780simPic32GetWrites(config->dataLat) == 0 &&
+          hd44780simPic32GetWrites(config->dataTris) == 0,
+          "pins only driven through SET, CLR and INV");
+#endif
+    printf("    %lu register stores in total\n", simStats.registerWrites);
+    printf("    bus signature %08lX\n", simStats.busSignature);
+
+    lcdifClose(hLcdIf);
+    lcdifDestroy(lcdIfNum);
+    lcdifDeinit();
+}
+
+/*******************************************************************************
+* testSlotTable()
+*
+* Description:
+*   Fills the LCD interface slot table, then checks that a destroyed object's
+*   number is the next one reused
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+* 1. No bus cycles are made, so the simulator is not needed
+*
+*******************************************************************************/
+static void testSlotTable(void)
+{
+    static LCDIFOBJ         lcdIfObjs[LCDIF_MAXOBJECTS + 1];
+    PBIFOBJ                 pbIf;
+    PBIFLCDENOBJ            pbIfLcdEn;
+    HLCDIF                  hLcdIf;
+    LCDIFNUM                lcdIfNum;
+    unsigned int            counter;
+    unsigned int            failures = 0;
+
+    printf("\nSlot table, %u objects\n", LCDIF_MAXOBJECTS);
+
+    pbIf.RW_LAT     = &LATD;
+    pbIf.RW_BIT     = RW_PIN;
+    pbIf.RS_LAT     = &LATD;
+    pbIf.RS_BIT     = RS_PIN;
+    pbIf.DATA_LAT   = &LATE;
+    pbIf.DATA_PORT  = &PORTE;
+    pbIf.DATA_TRIS  = &TRISE;
+    pbIf.DATA_MASK  = 0xFF;
+    pbIf.RW_LATSET  = &LATDSET;
+    pbIf.RW_LATCLR  = &LATDCLR;
+    pbIf.RS_LATSET  = &LATDSET;
+    pbIf.RS_LATCLR  = &LATDCLR;
+    pbIf.DATA_LATINV = &LATEINV;
+    pbIf.DATA_TRISSET = &TRISESET;
+    pbIf.DATA_TRISCLR = &TRISECLR;
+    pbIfLcdEn.E_LAT = &LATD;
+    pbIfLcdEn.E_BIT = E_PIN;
+    pbIfLcdEn.E_LATSET = &LATDSET;
+    pbIfLcdEn.E_LATCLR = &LATDCLR;
+
+    lcdifInit();
+                                        /* Numbers are issued lowest first    */
+    for (counter = 0; counter <= LCDIF_MAXOBJECTS; counter++)
+    {
+        lcdIfObjs[counter].pbIfObject = &pbIf;
+        lcdIfObjs[counter].pbIfLcdEnObject = &pbIfLcdEn;
+    }
+    for (counter = 0; counter < LCDIF_MAXOBJECTS; counter++)
+    {
+        if (lcdifCreate(&lcdIfObjs[counter]) != counter + 1)
+        {
+            failures++;
+        }
+    }
+    check(failures == 0, "lcdifCreate up to capacity");
+    check(lcdifCreate(&lcdIfObjs[LCDIF_MAXOBJECTS]) == 0,
+          "lcdifCreate beyond capacity");
+                                        /* Each number opens its own object   */
+    for (counter = 0; counter < LCDIF_MAXOBJECTS; counter++)
+    {
+        hLcdIf = lcdifOpen(counter + 1);
+        if (hLcdIf != &lcdIfObjs[counter] || lcdifClose(hLcdIf) != counter + 1)
+        {
+            failures++;
+        }
+    }
+    check(failures == 0, "lcdifOpen by number");
+    check(lcdifOpen(0) == (HLCDIF) 0 &&
+          lcdifOpen(LCDIF_MAXOBJECTS + 1) == (HLCDIF) 0,
+          "lcdifOpen of invalid numbers");
+                                        /* An open object can't be destroyed; */
+                                        /* a freed number is reused           */
+    lcdIfNum = LCDIF_MAXOBJECTS / 2;
+    hLcdIf = lcdifOpen(lcdIfNum);
+    check(lcdifDestroy(lcdIfNum) == 0, "lcdifDestroy of open object");
+    lcdifClose(hLcdIf);
+    check(lcdifDestroy(lcdIfNum) == 1, "lcdifDestroy");
+    check(lcdifOpen(lcdIfNum) == (HLCDIF) 0, "open destroyed object");
+    check(lcdifCreate(&lcdIfObjs[LCDIF_MAXOBJECTS]) == lcdIfNum,
+          "lcdifCreate reuses freed number");
+
+    lcdifDeinit();
+}
+
+/*******************************************************************************
+* waitWhileBusy()
+*
+* Description:
+*   Polls the busy flag until the display is ready
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: testConfig()
+*
+* Notes :
+*
+*******************************************************************************/
+static void waitWhileBusy(HLCDIF hLcdIf)
+{
+    unsigned char       readAddress;
+
+    do
+    {
+        lcdifReadAddress(hLcdIf, &readAddress);
+    } while (readAddress & HD44780SIM_BUSYFLAG);
+}
+
+/*******************************************************************************
+* getMicroseconds()
+*
+* Description:
+*   Free running microsecond count used to pace block transfers
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Simulated time in microseconds
+*
+* Callers: LCD interface module
+*
+* Notes :
+* 1. Each call lets one bus cycle time pass, standing in for the time the
+*    code polling it would take on the target
+*
+*******************************************************************************/
+static unsigned int getMicroseconds(void)
+{
+    hd44780simAdvance(hd44780simGetCycleTime());
+
+    return (unsigned int) (hd44780simGetTime() / 1000ULL);
+}
+
+/*******************************************************************************
+* startMeasurement()
+*
+* Description:
+*   Notes the register store and E cycle counts before an LCD interface call
+*
+* See also:
+*   endMeasurement()
+*
+* Arguments:
+*   measurement         - where to store the starting point
+*
+* Returns:
+*   void
+*
+* Callers: testConfig()
+*
+* Notes :
+*
+*******************************************************************************/
+static void startMeasurement(TESTMEASUREMENT * measurement)
+{
+    HD44780SIMPIC32STATS    simStats;
+
+    hd44780simPic32GetStats(&simStats);
+    measurement->startWrites = simStats.registerWrites;
+    measurement->startLatD = getRegisterWrites(&LATD);
+    measurement->startTrisD = getRegisterWrites(&TRISD);
+    measurement->startData = 0;
+    if (currentConfig->dataLat != &LATD)
+    {
+        measurement->startData = getRegisterWrites(currentConfig->dataLat) +
+                                 getRegisterWrites(currentConfig->dataTris);
+    }
+    measurement->startCycles = hd44780Sim.stats.writeCycles +
+                               hd44780Sim.stats.readCycles;
+}
+
+/*******************************************************************************
+* endMeasurement()
+*
+* Description:
+*   Prints the register stores and E cycles used per call since
+*   startMeasurement()
+*
+* See also:
+*   startMeasurement()
+*
+* Arguments:
+*   measurement         - starting point
+*   name                - name of the measured call
+*   calls               - number of calls made
+*
+* Returns:
+*   void
+*
+* Callers: testConfig()
+*
+* Notes :
+* 1. "data" is the stores to the data port's LAT and TRIS registers when they
+*    are not on PORTD
+* 2. Stores to a register's CLR, SET and INV registers are counted with it
+*
+*******************************************************************************/
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                           unsigned int calls)
+{
+    HD44780SIMPIC32STATS    simStats;
+    unsigned long           dataWrites = 0;
+
+    hd44780simPic32GetStats(&simStats);
+    if (currentConfig->dataLat != &LATD)
+    {
+        dataWrites = getRegisterWrites(currentConfig->dataLat) +
+                     getRegisterWrites(currentConfig->dataTris);
+    }
+
+    printf("    %-26s %8.1f %6.1f %6.1f %6.1f %8.1f\n", name,
+           (double) (simStats.registerWrites - measurement->startWrites) /
+                                                                        calls,
+           (double) (getRegisterWrites(&LATD) -
+                     measurement->startLatD) / calls,
+           (double) (getRegisterWrites(&TRISD) -
+                     measurement->startTrisD) / calls,
+           (double) (dataWrites - measurement->startData) / calls,
+           (double) (hd44780Sim.stats.writeCycles +
+                     hd44780Sim.stats.readCycles -
+                     measurement->startCycles) / calls);
+}
+
+/*******************************************************************************
+* getRegisterWrites()
+*
+* Description:
+*   Returns the stores made to a register and its CLR, SET and INV registers
+*
+* See also:
+*
+* Arguments:
+*   reg                 - LAT or TRIS register in the simulated bank
+*
+* Returns:
+*   Total number of stores
+*
+* Callers: startMeasurement(), endMeasurement()
+*
+* Notes :
+* 1. The CLR, SET and INV registers follow the register in SIMPIC32REG
+*
+*******************************************************************************/
+static unsigned long getRegisterWrites(volatile unsigned int * reg)
+{
+    return hd44780simPic32GetWrites(reg) +
+           hd44780simPic32GetWrites(reg + 1) +
+           hd44780simPic32GetWrites(reg + 2) +
+           hd44780simPic32GetWrites(reg + 3);
+}
+
+/*******************************************************************************
+* check()
+*
+* Description:
+*   Records and reports the result of one test check
+*
+* See also:
+*
+* Arguments:
+*   condition           - non-zero if the check passed
+*   description         - what was checked
+*
+* Returns:
+*   void
+*
+* Callers: testConfig(), testSlotTable()
+*
+* Notes :
+*
+*******************************************************************************/
+static void check(int condition, const char * description)
+{
+    if (!condition)
+    {
+        printf("    FAILED: %s\n", description);
+        testFailures++;
+    }
+}
+
+
+/*******************************************************************************
+*
+*                 LCD INTERFACE MODULE PIC32 HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -0,0 +1,753 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE PMP HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the unmodified Parallel Master Port LCD interface module (lcdif_pmp.c)
+* on a host PC against a model of the PIC32 PMP, checks that the PMP cycles it
+* starts form correct HD44780 bus cycles and reports how many register stores
+* and loads each LCD interface call costs.
+*
+* Two displays share the PMP, each with its E pin gated by its own address
+* line. The first is given wait states meeting the HD44780U's timing, the
+* second wait states that are too short. The test checks that each display
+* only sees its own cycles and that the model flags the second display's
+* cycles, and only those, as too fast.
+*
+* A full 20x4 frame is then sent to the first display by DMA, paced by Timer 2,
+* checking that it arrives in order, that the pacing leaves the controller
+* time to execute each write, and how little the CPU does meanwhile.
+*
+* Filename : lcdifTestHostPmp.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on an x86 or x86-64 Linux PC:
+*   gcc -D__PIC32MX__
+*       -I../HD44780Sim/pic32 -I../HD44780Sim -I../lcdif_module
+*       lcdifTestHostPmp.c ../lcdif_module/lcdif_pmp.c
+*       ../HD44780Sim/hd44780simpic32.c ../HD44780Sim/hd44780sim.c
+*       -o lcdifTestHostPmp
+*   ./lcdifTestHostPmp
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                     LCD INTERFACE MODULE PMP HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include <p32xxxx.h>
+#include "lcdif_pmp.h"
+#include "hd44780simpic32.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+                                        /* 20MHz peripheral bus clock         */
+#define PB_PERIOD           50
+#define RS_LINE             LCDIF_PMA0
+#define GOOD_SELECT         LCDIF_PMA14
+#define FAST_SELECT         LCDIF_PMA15
+                                        /* Strobe of 2 clocks, 100ns          */
+#define FAST_WAITS          LCDIF_PMPWAITSTATES(0, 1, 0)
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMEASUREMENT
+* Description:
+*   Register stores and loads and E cycles used by one or more LCD interface
+*   calls
+*******************************************************************************/
+typedef struct TESTMEASUREMENTTYPE {
+    unsigned long                   startWrites;
+    unsigned long                   startReads;
+    unsigned long                   startCycles;
+} TESTMEASUREMENT;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char message[] = "PMP on a host!";
+                                        /* Cursor on, then off again; entry   */
+                                        /* mode increment                     */
+static const unsigned char instructions[] = { 0x0E, 0x0C, 0x06 };
+                                        /* A 20x4 display's lines, in DDRAM   */
+static const unsigned char lineAddresses[4] = { 0x00, 0x40, 0x14, 0x54 };
+static const unsigned char frameText[4][21] = {
+    "First line by DMA   ",
+    "Second line by DMA  ",
+    "Third line by DMA   ",
+    "Fourth line by DMA  "
+};
+static HD44780SIM           goodSim;
+static HD44780SIM           fastSim;
+static HD44780SIM         * currentSim;
+static unsigned int         testFailures;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testGoodWaits(HLCDIF hLcdIf);
+static void testFastWaits(HLCDIF hLcdIf);
+static void testFrame(HLCDIF hLcdIf, HLCDIF hOtherLcdIf);
+static unsigned long waitForFrame(HLCDIF hLcdIf, unsigned int interval);
+static void initByInstruction(HLCDIF hLcdIf);
+static void waitWhileBusy(HLCDIF hLcdIf);
+static unsigned int getMicroseconds(void);
+static void startMeasurement(TESTMEASUREMENT * measurement);
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                           unsigned int calls);
+static void check(int condition, const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    HD44780SIMPIC32PMPLCD   goodLcd;
+    HD44780SIMPIC32PMPLCD   fastLcd;
+    LCDIFOBJ                goodObj;
+    LCDIFOBJ                fastObj;
+    LCDIFOBJ                badObj;
+    LCDIFNUM                goodNum;
+    LCDIFNUM                fastNum;
+    HLCDIF                  hGood;
+    HLCDIF                  hFast;
+
+    testFailures = 0;
+                                        /* Power on both displays and wire    */
+                                        /* them to the simulated PMP          */
+    hd44780simResetTime();
+    hd44780simInit(&goodSim, 0);
+    hd44780simInit(&fastSim, 0);
+    hd44780simPic32Init();
+    hd44780simPic32SetPbPeriod(PB_PERIOD);
+    goodLcd.hd44780Sim = &goodSim;
+    goodLcd.RS_ADDRESS = RS_LINE;
+    goodLcd.SELECT_ADDRESS = GOOD_SELECT;
+    fastLcd.hd44780Sim = &fastSim;
+    fastLcd.RS_ADDRESS = RS_LINE;
+    fastLcd.SELECT_ADDRESS = FAST_SELECT;
+    check(hd44780simPic32ConnectPmp(&goodLcd), "hd44780simPic32ConnectPmp");
+    check(hd44780simPic32ConnectPmp(&fastLcd), "hd44780simPic32ConnectPmp");
+    check(hd44780simPic32Start(), "hd44780simPic32Start");
+
+    lcdifInit();
+                                        /* Objects that can't work are        */
+                                        /* refused                            */
+    badObj.selectAddress = GOOD_SELECT;
+    badObj.rsAddress = RS_LINE | LCDIF_PMA1;
+    badObj.waitStates = LCDIF_PMPWAIT_HD44780U;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with two RS lines");
+    badObj.rsAddress = GOOD_SELECT;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with RS as select line");
+    badObj.rsAddress = RS_LINE;
+    badObj.waitStates = 0x100;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with invalid wait states");
+
+    goodObj.selectAddress = GOOD_SELECT;
+    goodObj.rsAddress = RS_LINE;
+    goodObj.waitStates = LCDIF_PMPWAIT_HD44780U;
+    fastObj.selectAddress = FAST_SELECT;
+    fastObj.rsAddress = RS_LINE;
+    fastObj.waitStates = FAST_WAITS;
+    goodNum = lcdifCreate(&goodObj);
+    fastNum = lcdifCreate(&fastObj);
+    hGood = lcdifOpen(goodNum);
+    hFast = lcdifOpen(fastNum);
+    check(hGood != (HLCDIF) 0 && hFast != (HLCDIF) 0, "lcdifOpen");
+
+    testGoodWaits(hGood);
+    testFrame(hGood, hFast);
+    testFastWaits(hFast);
+
+    hd44780simPic32Stop();
+
+    lcdifClose(hGood);
+    lcdifClose(hFast);
+    lcdifDestroy(goodNum);
+    lcdifDestroy(fastNum);
+    lcdifDeinit();
+
+    printf("\n%s: %u check(s) failed\n",
+           testFailures ? "FAIL" : "PASS", testFailures);
+
+    return (int) testFailures;
+}
+
+/*******************************************************************************
+* testGoodWaits()
+*
+* Description:
+*   Runs the complete test sequence on the display with HD44780U wait states
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the display's open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testGoodWaits(HLCDIF hLcdIf)
+{
+    HD44780SIMPIC32STATS    simStats;
+    TESTMEASUREMENT         measurement;
+    unsigned char           readData = 0;
+    unsigned char           readAddress = 0;
+    unsigned char           readBlock[sizeof(message)];
+    unsigned char           counter;
+
+    currentSim = &goodSim;
+
+    printf("\nHD44780U wait states on PMA14\n");
+    printf("    %-26s %8s %8s %8s\n", "call", "stores", "loads", "E cycles");
+
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+    check(lcdifGetPbBusWidth(hLcdIf) == BUS8BITSWIDE, "8-bit bus");
+    check(lcdif4BitFunctionSet(hLcdIf, 0x03) == 0,
+          "lcdif4BitFunctionSet refused");
+    hd44780simPic32ClearStats();
+
+    initByInstruction(hLcdIf);
+    check(goodSim.functionSet == 0x38, "function set");
+
+    startMeasurement(&measurement);
+    waitWhileBusy(hLcdIf);
+    endMeasurement(&measurement, "lcdifReadAddress (poll)", 1);
+                                        /* Display on, clear, increment       */
+    lcdifWriteInstruction(hLcdIf, 0x0C);
+    waitWhileBusy(hLcdIf);
+    lcdifWriteInstruction(hLcdIf, 0x01);
+    waitWhileBusy(hLcdIf);
+    lcdifWriteInstruction(hLcdIf, 0x06);
+    waitWhileBusy(hLcdIf);
+                                        /* Write a line of text               */
+    startMeasurement(&measurement);
+    for (counter = 0; message[counter] != 0; counter++)
+    {
+        lcdifWriteData(hLcdIf, message[counter]);
+        hd44780simDelay(40);
+    }
+    endMeasurement(&measurement, "lcdifWriteData", counter);
+    check(memcmp(goodSim.ddram, message, counter) == 0, "DDRAM contents");
+
+    startMeasurement(&measurement);
+    lcdifReadAddress(hLcdIf, &readAddress);
+    endMeasurement(&measurement, "lcdifReadAddress", 1);
+    check(readAddress == counter, "address counter");
+                                        /* Read back the fourth character and */
+                                        /* check only one cycle was made      */
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x03);
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifReadData(hLcdIf, &readData);
+    endMeasurement(&measurement, "lcdifReadData", 1);
+    check(readData == message[3], "lcdifReadData");
+    lcdifReadAddress(hLcdIf, &readAddress);
+    check((readAddress & ~HD44780SIM_BUSYFLAG) == 0x04,
+          "address counter after lcdifReadData");
+    waitWhileBusy(hLcdIf);
+                                        /* The text again on line two, now as */
+                                        /* one block                          */
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x40);
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifWriteDataBlock(hLcdIf, message, counter, getMicroseconds, 37);
+    endMeasurement(&measurement, "lcdifWriteDataBlock", counter);
+    check(memcmp(&goodSim.ddram[0x40], message, counter) == 0,
+          "DDRAM contents after block");
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifWriteInstructionBlock(hLcdIf, instructions, sizeof(instructions),
+                               getMicroseconds, 37);
+    endMeasurement(&measurement, "lcdifWriteInstructionBlock",
+                   sizeof(instructions));
+    check(goodSim.displayControl == 0x0C && goodSim.entryMode == 0x06,
+          "instruction block");
+    waitWhileBusy(hLcdIf);
+                                        /* Read line two back as one block    */
+                                        /* and check no extra cycle was made  */
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x40);
+    waitWhileBusy(hLcdIf);
+    startMeasurement(&measurement);
+    lcdifReadDataBlock(hLcdIf, readBlock, counter, getMicroseconds, 37);
+    endMeasurement(&measurement, "lcdifReadDataBlock", counter);
+    check(memcmp(readBlock, message, counter) == 0, "lcdifReadDataBlock");
+    lcdifReadAddress(hLcdIf, &readAddress);
+    check((readAddress & ~HD44780SIM_BUSYFLAG) == 0x40 + counter,
+          "address counter after lcdifReadDataBlock");
+    waitWhileBusy(hLcdIf);
+
+    lcdifReturnPb(hLcdIf);
+
+    hd44780simPic32GetStats(&simStats);
+    check(goodSim.stats.violations == 0, "no writes while busy");
+    check(simStats.pmpViolations == 0, "PMP timing met");
+    check(fastSim.stats.writeCycles == 0 && fastSim.stats.readCycles == 0,
+          "other display not strobed");
+    printf("    %lu register stores in total\n", simStats.registerWrites);
+    printf("    bus signature %08lX\n", simStats.busSignature);
+}
+
+/*******************************************************************************
+* testFrame()
+*
+* Description:
+*   Sends a full frame to the display with HD44780U wait states by DMA, once
+*   paced for the controller's execution time and once too fast
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the display's open LCD interface
+*   hOtherLcdIf         - handle to the other display's open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testFrame(HLCDIF hLcdIf, HLCDIF hOtherLcdIf)
+{
+    static LCDIFFRAME       frame;
+    HD44780SIMPIC32STATS    simStats;
+    HD44780SIMTIME          startTime;
+    unsigned long           startWrites;
+    unsigned long           startTransfers;
+    unsigned long           otherCycles;
+    unsigned long           polls;
+    unsigned int            interval;
+    unsigned char           readAddress = 0;
+    unsigned char           line;
+    unsigned char           failures = 0;
+
+    currentSim = &goodSim;
+    otherCycles = fastSim.stats.writeCycles + fastSim.stats.readCycles;
+
+    printf("\nDMA frame on PMA14\n");
+                                        /* Each line's set DDRAM address      */
+                                        /* instruction, then its text         */
+    lcdifClearFrame(&frame);
+    for (line = 0; line < 4; line++)
+    {
+        if (!lcdifAddFrameInstruction(hLcdIf, &frame,
+                                      0x80 | lineAddresses[line]) ||
+            !lcdifAddFrameData(hLcdIf, &frame, frameText[line], 20))
+        {
+            failures++;
+        }
+    }
+    check(failures == 0 && frame.length == LCDIF_FRAMESIZE, "frame filled");
+    check(!lcdifAddFrameInstruction(hLcdIf, &frame, 0x01) &&
+          !lcdifAddFrameData(hLcdIf, &frame, message, 1),
+          "frame overflow refused");
+                                        /* Pace by the execution time of a    */
+                                        /* data write, rounded up             */
+    interval = (unsigned int) ((hd44780simGetExecTime(0, 1, 0) + 999) / 1000);
+
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+    waitWhileBusy(hLcdIf);
+    hd44780simClearStats(&goodSim);
+    hd44780simPic32ClearStats();
+    startTime = hd44780simGetTime();
+
+    check(lcdifWriteFrame(hLcdIf, &frame, interval) == 1, "lcdifWriteFrame");
+    hd44780simPic32GetStats(&simStats);
+    startWrites = simStats.registerWrites;
+    startTransfers = simStats.dmaTransfers;
+                                        /* The PMP is reserved for the DMA    */
+    check(lcdifWriteData(hLcdIf, 'X') == 0 && lcdifGetPb(hLcdIf) == 0,
+          "LCD interface busy during frame");
+    check(lcdifGetPb(hOtherLcdIf) == 0, "PMP kept during frame");
+
+    polls = waitForFrame(hLcdIf, interval);
+
+    hd44780simPic32GetStats(&simStats);
+    printf("    %lu stores to start, %lu polls to finish, %lu stores then\n",
+           startWrites, polls, simStats.registerWrites - startWrites);
+    printf("    %lu DMA cells for %u bytes in %lu us\n",
+           simStats.dmaTransfers - startTransfers, frame.length,
+           (unsigned long) ((hd44780simGetTime() - startTime) / 1000ULL));
+
+    for (line = 0; line < 4; line++)
+    {
+        if (memcmp(&goodSim.ddram[lineAddresses[line]], frameText[line], 20))
+        {
+            failures++;
+        }
+    }
+    check(failures == 0, "DDRAM contents after frame");
+    check(goodSim.stats.writeCycles == LCDIF_FRAMESIZE, "one cycle per entry");
+    check(simStats.dmaTransfers == 2 * LCDIF_FRAMESIZE, "two cells per entry");
+    check(goodSim.stats.violations == 0, "no writes while busy");
+    check(simStats.pmpViolations == 0, "PMP timing met");
+    check(fastSim.stats.writeCycles + fastSim.stats.readCycles == otherCycles,
+          "other display not strobed");
+                                        /* The LCD interface works again. The */
+                                        /* last write was to 0x67, so the     */
+                                        /* address counter has wrapped to 0   */
+    waitWhileBusy(hLcdIf);
+    check(lcdifReadAddress(hLcdIf, &readAddress) == 1 && readAddress == 0x00,
+          "address counter after frame");
+                                        /* A quarter of the interval is too   */
+                                        /* short, which the model must catch  */
+    hd44780simClearStats(&goodSim);
+    lcdifWriteFrame(hLcdIf, &frame, interval / 4);
+    waitForFrame(hLcdIf, interval / 4);
+    check(goodSim.stats.violations != 0,
+          "writes while busy when paced too fast");
+    printf("    %lu writes while busy at a %u us interval\n",
+           goodSim.stats.violations, interval / 4);
+    hd44780simDelay(1000);
+
+    lcdifReturnPb(hLcdIf);
+}
+
+/*******************************************************************************
+* waitForFrame()
+*
+* Description:
+*   Lets simulated time pass until the frame being sent by DMA has been sent
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the open LCD interface
+*   interval            - microseconds between writes
+*
+* Returns:
+*   Number of times lcdifIsFrameDone() was called
+*
+* Callers: testFrame()
+*
+* Notes :
+* 1. The CPU is left to other work for one interval between each poll
+*
+*******************************************************************************/
+static unsigned long waitForFrame(HLCDIF hLcdIf, unsigned int interval)
+{
+    unsigned long       polls;
+
+    for (polls = 1; !lcdifIsFrameDone(hLcdIf); polls++)
+    {
+        hd44780simPic32Run((HD44780SIMTIME) interval * 1000ULL);
+    }
+
+    return polls;
+}
+
+/*******************************************************************************
+* testFastWaits()
+*
+* Description:
+*   Initialises the display given too short wait states and checks that the
+*   model flags its cycles
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the display's open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testFastWaits(HLCDIF hLcdIf)
+{
+    HD44780SIMPIC32STATS    simStats;
+    unsigned long           goodCycles;
+
+    currentSim = &fastSim;
+    goodCycles = goodSim.stats.writeCycles + goodSim.stats.readCycles;
+
+    printf("\nShort wait states on PMA15\n");
+
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+    hd44780simPic32ClearStats();
+
+    initByInstruction(hLcdIf);
+    waitWhileBusy(hLcdIf);
+    lcdifWriteData(hLcdIf, message[0]);
+
+    lcdifReturnPb(hLcdIf);
+
+    hd44780simPic32GetStats(&simStats);
+    check(fastSim.functionSet == 0x38, "function set");
+    check(simStats.pmpViolations ==
+                    fastSim.stats.writeCycles + fastSim.stats.readCycles,
+          "every cycle flagged as too fast");
+    check(goodSim.stats.writeCycles + goodSim.stats.readCycles == goodCycles,
+          "other display not strobed");
+    printf("    %lu of %lu PMP cycles too fast\n", simStats.pmpViolations,
+           fastSim.stats.writeCycles + fastSim.stats.readCycles);
+}
+
+/*******************************************************************************
+* initByInstruction()
+*
+* Description:
+*   Puts the display into 8-bit mode with the "Initialising by Instruction"
+*   sequence
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: testGoodWaits(), testFastWaits()
+*
+* Notes :
+*
+*******************************************************************************/
+static void initByInstruction(HLCDIF hLcdIf)
+{
+    TESTMEASUREMENT     measurement;
+
+    hd44780simDelay(15000);
+    lcdifWriteInstruction(hLcdIf, 0x30);
+    hd44780simDelay(4100);
+    lcdifWriteInstruction(hLcdIf, 0x30);
+    hd44780simDelay(100);
+    lcdifWriteInstruction(hLcdIf, 0x30);
+    startMeasurement(&measurement);
+    lcdifWriteInstruction(hLcdIf, 0x38);
+    if (currentSim == &goodSim)
+    {
+        endMeasurement(&measurement, "lcdifWriteInstruction", 1);
+    }
+}
+
+/*******************************************************************************
+* waitWhileBusy()
+*
+* Description:
+*   Polls the busy flag until the display is ready
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: testGoodWaits(), testFastWaits()
+*
+* Notes :
+*
+*******************************************************************************/
+static void waitWhileBusy(HLCDIF hLcdIf)
+{
+    unsigned char       readAddress;
+
+    do
+    {
+        lcdifReadAddress(hLcdIf, &readAddress);
+    } while (readAddress & HD44780SIM_BUSYFLAG);
+}
+
+/*******************************************************************************
+* getMicroseconds()
+*
+* Description:
+*   Free running microsecond count used to pace block transfers
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Simulated time in microseconds
+*
+* Callers: LCD interface module
+*
+* Notes :
+* 1. Each call lets one bus cycle time pass, standing in for the time the
+*    code polling it would take on the target
+*
+*******************************************************************************/
+static unsigned int getMicroseconds(void)
+{
+    hd44780simAdvance(hd44780simGetCycleTime());
+
+    return (unsigned int) (hd44780simGetTime() / 1000ULL);
+}
+
+/*******************************************************************************
+* startMeasurement()
+*
+* Description:
+*   Notes the register store and load and E cycle counts before an LCD
+*   interface call
+*
+* See also:
+*   endMeasurement()
+*
+* Arguments:
+*   measurement         - where to store the starting point
+*
+* Returns:
+*   void
+*
+* Callers: testGoodWaits(), initByInstruction()
+*
+* Notes :
+*
+*******************************************************************************/
+static void startMeasurement(TESTMEASUREMENT * measurement)
+{
+    HD44780SIMPIC32STATS    simStats;
+
+    hd44780simPic32GetStats(&simStats);
+    measurement->startWrites = simStats.registerWrites;
+    measurement->startReads = simStats.registerReads;
+    measurement->startCycles = currentSim->stats.writeCycles +
+                               currentSim->stats.readCycles;
+}
+
+/*******************************************************************************
+* endMeasurement()
+*
+* Description:
+*   Prints the register stores and loads and E cycles used per call since
+*   startMeasurement()
+*
+* See also:
+*   startMeasurement()
+*
+* Arguments:
+*   measurement         - starting point
+*   name                - name of the measured call
+*   calls               - number of calls made
+*
+* Returns:
+*   void
+*
+* Callers: testGoodWaits(), initByInstruction()
+*
+* Notes :
+* 1. Loads include the polls of the PMP busy flag
+*
+*******************************************************************************/
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                           unsigned int calls)
+{
+    HD44780SIMPIC32STATS    simStats;
+
+    hd44780simPic32GetStats(&simStats);
+
+    printf("    %-26s %8.1f %8.1f %8.1f\n", name,
+           (double) (simStats.registerWrites - measurement->startWrites) /
+                                                                        calls,
+           (double) (simStats.registerReads - measurement->startReads) /
+                                                                        calls,
+           (double) (currentSim->stats.writeCycles +
+                     currentSim->stats.readCycles -
+                     measurement->startCycles) / calls);
+}
+
+/*******************************************************************************
+* check()
+*
+* Description:
+*   Records and reports the result of one test check
+*
+* See also:
+*
+* Arguments:
+*   condition           - non-zero if the check passed
+*   description         - what was checked
+*
+* Returns:
+*   void
+*
+* Callers: main(), testGoodWaits(), testFastWaits()
+*
+* Notes :
+*
+*******************************************************************************/
+static void check(int condition, const char * description)
+{
+    if (!condition)
+    {
+        printf("    FAILED: %s\n", description);
+        testFailures++;
+    }
+}
+
+
+/*******************************************************************************
+*
+*                  LCD INTERFACE MODULE PMP HOST TEST PROGRAM END
+*
+*******************************************************************************/
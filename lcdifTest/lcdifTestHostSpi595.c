@@ -0,0 +1,564 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE SPI 74HC595 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* Runs the unmodified SPI shift register LCD interface module (lcdif_spi595.c)
+* on a host PC against a model of a 74HC595 wired to an HD44780 with a 4-bit
+* bus, checks that the output changes it sends form correct HD44780 write
+* cycles and reports how many SPI bursts and bytes each LCD interface call
+* puts on the wire.
+*
+* Two displays share the SPI bus, each behind its own 595. The first is told
+* its SPI clock, so block writes are paced by padding bytes and go out in as
+* few bursts as the burst buffer allows. The second isn't, so its block writes
+* are paced with the time source, one burst per byte.
+*
+* Filename : lcdifTestHostSpi595.c
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* V0.01 -   First cut
+*
+* Build and run from this directory with gcc on a PC:
+*   gcc -I../HD44780Sim -I../lcdif_module
+*       lcdifTestHostSpi595.c ../lcdif_module/lcdif_spi595.c
+*       ../HD44780Sim/hd44780sim595.c ../HD44780Sim/hd44780sim.c
+*       -o lcdifTestHostSpi595
+*   ./lcdifTestHostSpi595
+* The program returns 0 if all tests passed.
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                LCD INTERFACE MODULE SPI 74HC595 HOST TEST PROGRAM
+*
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "lcdif_spi595.h"
+#include "hd44780sim595.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+                                        /* QA to QD drive DB4 to DB7, QE RS,  */
+                                        /* QF E and QH the backlight          */
+#define DATA_OUTPUT         0
+#define RS_OUTPUT           4
+#define E_OUTPUT            5
+#define BACKLIGHT           0x80
+#define SPI_CLOCK_KHZ       8000
+                                        /* Time to start one SPI transaction  */
+#define BURST_OVERHEAD      2000
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type TESTMEASUREMENT
+* Description:
+*   SPI bursts and bytes, E cycles and simulated time used by one or more LCD
+*   interface calls
+*******************************************************************************/
+typedef struct TESTMEASUREMENTTYPE {
+    unsigned long                   startBursts;
+    unsigned long                   startBytes;
+    unsigned long                   startCycles;
+    HD44780SIMTIME                  startTime;
+} TESTMEASUREMENT;
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+static const unsigned char message[] = "595 on a host!";
+                                        /* Cursor on, then off again; entry   */
+                                        /* mode increment                     */
+static const unsigned char instructions[] = { 0x0E, 0x0C, 0x06 };
+static HD44780SIM           paddedSim;
+static HD44780SIM           timedSim;
+static HD44780SIM595        paddedSr;
+static HD44780SIM595        timedSr;
+static HD44780SIM595      * currentSr;
+static unsigned int         testFailures;
+
+
+/*******************************************************************************
+*                             LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static void testDisplay(HLCDIF hLcdIf, HD44780SIM595 * sr,
+                        unsigned char padded);
+static void initByInstruction(HLCDIF hLcdIf);
+static void paddedSpiWrite(const unsigned char * data, unsigned int length);
+static void timedSpiWrite(const unsigned char * data, unsigned int length);
+static unsigned int getMicroseconds(void);
+static void startMeasurement(TESTMEASUREMENT * measurement);
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                           unsigned int calls);
+static void check(int condition, const char * description);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* main()
+*
+* Description:
+*   Main application code
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Number of failed checks
+*
+* Callers: C start-up code
+*
+* Notes :
+*
+*******************************************************************************/
+int main(void)
+{
+    LCDIFOBJ                paddedObj;
+    LCDIFOBJ                timedObj;
+    LCDIFOBJ                badObj;
+    LCDIFNUM                paddedNum;
+    LCDIFNUM                timedNum;
+    HLCDIF                  hPadded;
+    HLCDIF                  hTimed;
+
+    testFailures = 0;
+                                        /* Power on both displays and their   */
+                                        /* shift registers                    */
+    hd44780simResetTime();
+    hd44780simInit(&paddedSim, 0);
+    hd44780simInit(&timedSim, 0);
+    paddedSr.hd44780Sim = &paddedSim;
+    paddedSr.RS_BIT = RS_OUTPUT;
+    paddedSr.E_BIT = E_OUTPUT;
+    paddedSr.DATA_SHIFT = DATA_OUTPUT;
+    paddedSr.spiClockKHz = SPI_CLOCK_KHZ;
+    paddedSr.burstOverhead = BURST_OVERHEAD;
+    timedSr = paddedSr;
+    timedSr.hd44780Sim = &timedSim;
+    hd44780sim595Init(&paddedSr);
+    hd44780sim595Init(&timedSr);
+
+    lcdifInit();
+                                        /* Objects that can't work are        */
+                                        /* refused                            */
+    badObj.pSpiWrite = paddedSpiWrite;
+    badObj.RS_BIT = RS_OUTPUT;
+    badObj.E_BIT = E_OUTPUT;
+    badObj.DATA_SHIFT = DATA_OUTPUT;
+    badObj.OTHER_BITS = BACKLIGHT;
+    badObj.spiClockKHz = LCDIF_SPIMAXCLOCKKHZ + 1;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with SPI clock too fast");
+    badObj.spiClockKHz = SPI_CLOCK_KHZ;
+    badObj.E_BIT = RS_OUTPUT;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with RS as E");
+    badObj.E_BIT = DATA_OUTPUT + 3;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with E as DB7");
+    badObj.E_BIT = E_OUTPUT;
+    badObj.OTHER_BITS = BACKLIGHT | (1u << RS_OUTPUT);
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate with RS held high");
+    badObj.OTHER_BITS = BACKLIGHT;
+    badObj.pSpiWrite = 0;
+    check(lcdifCreate(&badObj) == 0, "lcdifCreate without SPI function");
+
+    paddedObj = badObj;
+    paddedObj.pSpiWrite = paddedSpiWrite;
+    timedObj = paddedObj;
+    timedObj.pSpiWrite = timedSpiWrite;
+    timedObj.spiClockKHz = 0;
+    paddedNum = lcdifCreate(&paddedObj);
+    timedNum = lcdifCreate(&timedObj);
+    hPadded = lcdifOpen(paddedNum);
+    hTimed = lcdifOpen(timedNum);
+    check(hPadded != (HLCDIF) 0 && hTimed != (HLCDIF) 0, "lcdifOpen");
+                                        /* The SPI bus goes to one at a time  */
+    check(lcdifWriteData(hPadded, 'X') == 0, "lcdifWriteData without bus");
+    check(lcdifGetPb(hPadded), "lcdifGetPb");
+    check(lcdifGetPb(hTimed) == 0, "SPI bus kept by its owner");
+    lcdifReturnPb(hPadded);
+    check(paddedSr.stats.bursts == 0 && timedSr.stats.bursts == 0,
+          "nothing sent");
+
+    testDisplay(hPadded, &paddedSr, 1);
+    testDisplay(hTimed, &timedSr, 0);
+
+    lcdifClose(hPadded);
+    lcdifClose(hTimed);
+    lcdifDestroy(paddedNum);
+    lcdifDestroy(timedNum);
+    lcdifDeinit();
+
+    printf("\n%s: %u check(s) failed\n",
+           testFailures ? "FAIL" : "PASS", testFailures);
+
+    return (int) testFailures;
+}
+
+/*******************************************************************************
+* testDisplay()
+*
+* Description:
+*   Runs the complete test sequence on one display
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the display's open LCD interface
+*   sr                  - the display's simulated shift register
+*   padded              - 1 if the LCD interface knows its SPI clock
+*
+* Returns:
+*   void
+*
+* Callers: main()
+*
+* Notes :
+*
+*******************************************************************************/
+static void testDisplay(HLCDIF hLcdIf, HD44780SIM595 * sr,
+                        unsigned char padded)
+{
+    TESTMEASUREMENT     measurement;
+    HD44780SIM        * sim;
+    HD44780SIM595     * otherSr;
+    unsigned long       otherBytes;
+    unsigned long       startChanges;
+    unsigned long       perPinBursts;
+    unsigned char       readData = 0;
+    unsigned int        interval;
+    unsigned char       counter;
+
+    currentSr = sr;
+    sim = sr->hd44780Sim;
+    otherSr = (sr == &paddedSr) ? &timedSr : &paddedSr;
+    otherBytes = otherSr->stats.bytes;
+
+    printf("\n%s\n", padded ? "Block writes paced by padding bytes" :
+                              "Block writes paced by the time source");
+    printf("    %-26s %8s %8s %8s %8s\n", "call", "bursts", "bytes",
+           "E cycles", "us");
+
+    check(lcdifGetPb(hLcdIf), "lcdifGetPb");
+    check(lcdifGetPbBusWidth(hLcdIf) == BUS4BITSWIDE, "4-bit bus");
+    check(lcdifReadData(hLcdIf, &readData) == 0 &&
+          lcdifReadAddress(hLcdIf, &readData) == 0, "reads refused");
+
+    initByInstruction(hLcdIf);
+    check(hd44780simIs4BitMode(sim) && sim->functionSet == 0x28,
+          "function set");
+                                        /* Write a line of text               */
+    startMeasurement(&measurement);
+    for (counter = 0; message[counter] != 0; counter++)
+    {
+        lcdifWriteData(hLcdIf, message[counter]);
+        hd44780simDelay(40);
+    }
+    endMeasurement(&measurement, "lcdifWriteData", counter);
+    check(memcmp(sim->ddram, message, counter) == 0, "DDRAM contents");
+                                        /* The text again on line two, now as */
+                                        /* one block paced by the execution   */
+                                        /* time of a data write               */
+    interval = (unsigned int) ((hd44780simGetExecTime(0, 1, 0) + 999) / 1000);
+    lcdifWriteInstruction(hLcdIf, 0x80 | 0x40);
+    hd44780simDelay(40);
+    startChanges = sr->stats.changes;
+    startMeasurement(&measurement);
+    lcdifWriteDataBlock(hLcdIf, message, counter, getMicroseconds, interval);
+    endMeasurement(&measurement, "lcdifWriteDataBlock", counter);
+    check(memcmp(&sim->ddram[0x40], message, counter) == 0,
+          "DDRAM contents after block");
+    if (padded)
+    {
+        check(sr->stats.bursts - measurement.startBursts ==
+              (sr->stats.bytes - measurement.startBytes +
+               LCDIF_SPIBURSTSIZE - 1) / LCDIF_SPIBURSTSIZE,
+              "one burst per burst buffer");
+    }
+    else
+    {
+        check(sr->stats.bursts - measurement.startBursts == counter,
+              "one burst per byte");
+    }
+    perPinBursts = sr->stats.changes - startChanges;
+    hd44780simDelay(40);
+
+    startMeasurement(&measurement);
+    lcdifWriteInstructionBlock(hLcdIf, instructions, sizeof(instructions),
+                               getMicroseconds, interval);
+    endMeasurement(&measurement, "lcdifWriteInstructionBlock",
+                   sizeof(instructions));
+    check(sim->displayControl == 0x0C && sim->entryMode == 0x06,
+          "instruction block");
+    hd44780simDelay(40);
+
+    lcdifReturnPb(hLcdIf);
+
+    check(sim->stats.violations == 0, "no writes while busy");
+    check(sr->stats.violations == 0, "E timing met");
+    check(otherSr->stats.bytes == otherBytes, "other display not sent to");
+    printf("    block of %u characters: one burst per output change would "
+           "need %lu bursts\n", counter, perPinBursts);
+}
+
+/*******************************************************************************
+* initByInstruction()
+*
+* Description:
+*   Puts the display into 4-bit mode with the "Initialising by Instruction"
+*   sequence, then switches it on, clears it and sets increment mode
+*
+* See also:
+*
+* Arguments:
+*   hLcdIf              - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers: testDisplay()
+*
+* Notes :
+*
+*******************************************************************************/
+static void initByInstruction(HLCDIF hLcdIf)
+{
+    TESTMEASUREMENT     measurement;
+
+    hd44780simDelay(15000);
+    startMeasurement(&measurement);
+    lcdif4BitFunctionSet(hLcdIf, 0x03);
+    endMeasurement(&measurement, "lcdif4BitFunctionSet", 1);
+    hd44780simDelay(4100);
+    lcdif4BitFunctionSet(hLcdIf, 0x03);
+    hd44780simDelay(100);
+    lcdif4BitFunctionSet(hLcdIf, 0x03);
+    hd44780simDelay(100);
+    lcdif4BitFunctionSet(hLcdIf, 0x02);
+    hd44780simDelay(100);
+    startMeasurement(&measurement);
+    lcdifWriteInstruction(hLcdIf, 0x28);
+    endMeasurement(&measurement, "lcdifWriteInstruction", 1);
+    hd44780simDelay(40);
+    lcdifWriteInstruction(hLcdIf, 0x0C);
+    hd44780simDelay(40);
+    lcdifWriteInstruction(hLcdIf, 0x01);
+    hd44780simDelay(1640);
+    lcdifWriteInstruction(hLcdIf, 0x06);
+    hd44780simDelay(40);
+}
+
+/*******************************************************************************
+* paddedSpiWrite()
+*
+* Description:
+*   SPI write function of the first display's LCD interface
+*
+* See also:
+*   timedSpiWrite()
+*
+* Arguments:
+*   data                - bytes to send
+*   length              - number of bytes to send
+*
+* Returns:
+*   void
+*
+* Callers: LCD interface module
+*
+* Notes :
+*
+*******************************************************************************/
+static void paddedSpiWrite(const unsigned char * data, unsigned int length)
+{
+    hd44780sim595Write(&paddedSr, data, length);
+}
+
+/*******************************************************************************
+* timedSpiWrite()
+*
+* Description:
+*   SPI write function of the second display's LCD interface
+*
+* See also:
+*   paddedSpiWrite()
+*
+* Arguments:
+*   data                - bytes to send
+*   length              - number of bytes to send
+*
+* Returns:
+*   void
+*
+* Callers: LCD interface module
+*
+* Notes :
+*
+*******************************************************************************/
+static void timedSpiWrite(const unsigned char * data, unsigned int length)
+{
+    hd44780sim595Write(&timedSr, data, length);
+}
+
+/*******************************************************************************
+* getMicroseconds()
+*
+* Description:
+*   Free running microsecond count used to pace block transfers
+*
+* See also:
+*
+* Arguments:
+*   void
+*
+* Returns:
+*   Simulated time in microseconds
+*
+* Callers: LCD interface module
+*
+* Notes :
+* 1. Each call lets one bus cycle time pass, standing in for the time the
+*    code polling it would take on the target
+*
+*******************************************************************************/
+static unsigned int getMicroseconds(void)
+{
+    hd44780simAdvance(hd44780simGetCycleTime());
+
+    return (unsigned int) (hd44780simGetTime() / 1000ULL);
+}
+
+/*******************************************************************************
+* startMeasurement()
+*
+* Description:
+*   Notes the SPI bursts and bytes, E cycles and time before an LCD interface
+*   call
+*
+* See also:
+*   endMeasurement()
+*
+* Arguments:
+*   measurement         - where to store the starting point
+*
+* Returns:
+*   void
+*
+* Callers: testDisplay(), initByInstruction()
+*
+* Notes :
+*
+*******************************************************************************/
+static void startMeasurement(TESTMEASUREMENT * measurement)
+{
+    measurement->startBursts = currentSr->stats.bursts;
+    measurement->startBytes = currentSr->stats.bytes;
+    measurement->startCycles = currentSr->hd44780Sim->stats.writeCycles;
+    measurement->startTime = hd44780simGetTime();
+}
+
+/*******************************************************************************
+* endMeasurement()
+*
+* Description:
+*   Prints the SPI bursts and bytes, E cycles and time used per call since
+*   startMeasurement()
+*
+* See also:
+*   startMeasurement()
+*
+* Arguments:
+*   measurement         - starting point
+*   name                - name of the measured call
+*   calls               - number of calls made
+*
+* Returns:
+*   void
+*
+* Callers: testDisplay(), initByInstruction()
+*
+* Notes :
+* 1. The time includes any delays the test makes between the calls
+*
+*******************************************************************************/
+static void endMeasurement(TESTMEASUREMENT * measurement, const char * name,
+                           unsigned int calls)
+{
+    printf("    %-26s %8.1f %8.1f %8.1f %8.1f\n", name,
+           (double) (currentSr->stats.bursts - measurement->startBursts) /
+                                                                        calls,
+           (double) (currentSr->stats.bytes - measurement->startBytes) /
+                                                                        calls,
+           (double) (currentSr->hd44780Sim->stats.writeCycles -
+                     measurement->startCycles) / calls,
+           (double) (hd44780simGetTime() - measurement->startTime) /
+                                                            (1000.0 * calls));
+}
+
+/*******************************************************************************
+* check()
+*
+* Description:
+*   Records and reports the result of one test check
+*
+* See also:
+*
+* Arguments:
+*   condition           - non-zero if the check passed
+*   description         - what was checked
+*
+* Returns:
+*   void
+*
+* Callers: main(), testDisplay()
+*
+* Notes :
+*
+*******************************************************************************/
+static void check(int condition, const char * description)
+{
+    if (!condition)
+    {
+        printf("    FAILED: %s\n", description);
+        testFailures++;
+    }
+}
+
+
+/*******************************************************************************
+*
+*             LCD INTERFACE MODULE SPI 74HC595 HOST TEST PROGRAM END
+*
+*******************************************************************************/
@@ -67,6 +67,17 @@
 *******************************************************************************/
 #define LCDIF_SHIFTDATAMASK (0x07)
 
+/*******************************************************************************
+* Summary:
+*   Gives the value to write to the data pins for a nibble in 4-bit bus mode
+*******************************************************************************/
+#if LCDIF_NIBBLETABLE
+#define LCDIF_NIBBLETOPORT(hLcdIf, nibble)  ((hLcdIf)->nibbleToPort[(nibble)])
+#else
+#define LCDIF_NIBBLETOPORT(hLcdIf, nibble)                                     \
+                    ((nibble) << ((hLcdIf)->lcdIfFlags & LCDIF_SHIFTDATAMASK))
+#endif
+
 /*******************************************************************************
 * Summary:
 *   Used to indicate that the parallel bus is not busy when the LCD interface
@@ -135,6 +146,11 @@ extern unsigned char    pbifGetBusMutex(char * pbIfFlag);
                                         /* defined as extern                  */
                                         /* See pbif_c18.asm                   */
 extern void             pbifReturnBusMutex(char * pbIfFlag);
+static void             writeLcdIfBlock(HLCDIF const hLcdIf,
+                                        const unsigned char * data,
+                                        unsigned char length,
+                                        unsigned int (*pGetMicroseconds)(void),
+                                        unsigned int interval);
 
 
 /*******************************************************************************
@@ -365,6 +381,20 @@ LCDIFNUM lcdifCreate(LCDIFOBJ * const lcdIfObj)
                                         /* If we got here the object contains */
                                         /* valid data we can work with        */
 
+                                        /* Work out the data pin mask and, in */
+                                        /* 4-bit mode, the value to put on    */
+                                        /* the data pins for each nibble      */
+        lcdIfObj->dataClearMask = ~lcdIfObj->pbIfObject->DATA_MASK;
+#if LCDIF_NIBBLETABLE
+        if (busWidth == 4)
+        {
+            for (bitTest = 0; bitTest < 16; bitTest++)
+            {
+                lcdIfObj->nibbleToPort[bitTest] = bitTest << busDataShift;
+            }
+        }
+#endif
+
                                         /* If there are no active objects in  */
                                         /* the list put this object at the    */
                                         /* top                                */
@@ -776,7 +806,6 @@ void lcdifReturnPb(HLCDIF const hLcdIf)
 *******************************************************************************/
 unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
 {
-    unsigned char tempData;
                                         /* Check if we own the peripheral bus */
     if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
     {   
@@ -792,30 +821,22 @@ unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
             *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
                                         /* Set RS pin                         */
             *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
-                                        /* Get high nibble of data            */
-            tempData = data >> 4;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-            tempData <<= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempData;
+                                        /* Put high nibble on the data pins   */
+                                        /* in one write                       */
+            *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                        hLcdIf->dataClearMask) |
+                        LCDIF_NIBBLETOPORT(hLcdIf, data >> 4);
                                         /* Set data pins to outputs           */
-            *hLcdIf->pbIfObject->DATA_TRIS &= ~hLcdIf->pbIfObject->DATA_MASK;
+            *hLcdIf->pbIfObject->DATA_TRIS &= hLcdIf->dataClearMask;
                                         /* Set E pin                          */
             *hLcdIf->E_LAT |= hLcdIf->E_BIT;
                                         /* Clear E pin                        */
             *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Get low nibble of data             */
-            tempData = data & 0x0F;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-            tempData <<= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempData;
+                                        /* Put low nibble on the data pins    */
+                                        /* in one write                       */
+            *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                        hLcdIf->dataClearMask) |
+                        LCDIF_NIBBLETOPORT(hLcdIf, data & 0x0F);
                                         /* Set E pin                          */
             *hLcdIf->E_LAT |= hLcdIf->E_BIT;
                                         /* Clear E pin                        */
@@ -909,7 +930,7 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
                                         /* into low four bytes of tempData    */
             tempData = (*hLcdIf->pbIfObject->DATA_PORT & 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempData >>= (startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK);
+            tempData >>= (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK);
                                         /* Clear E pin                        */
             *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
                                         /* Shift data into high nibble of     */
@@ -921,7 +942,7 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
                                         /* into low four bytes of tempData    */
             tempData2 = (*hLcdIf->pbIfObject->DATA_PORT& 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempData2 >>= (startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK);
+            tempData2 >>= (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK);
                                         /* Formulate whole data byte          */
             tempData += tempData2;
                                         /* Give value read back to caller     */
@@ -993,7 +1014,6 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
 unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf, 
                                    unsigned char instruction)
 {
-    unsigned char tempInstruction;
                                         /* Check if we own the peripheral bus */
     if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
     {   
@@ -1009,32 +1029,22 @@ unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf,
             *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
                                         /* Clear RS pin                       */
             *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
-                                        /* Get high nibble of instruction     */
-            tempInstruction = instruction >> 4;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-            tempInstruction <<= startOfLcdIfObjs->lcdIfFlags & 
-                                                            LCDIF_SHIFTDATAMASK;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempInstruction;
+                                        /* Put high nibble on the data pins   */
+                                        /* in one write                       */
+            *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                        hLcdIf->dataClearMask) |
+                        LCDIF_NIBBLETOPORT(hLcdIf, instruction >> 4);
                                         /* Set data pins to outputs           */
-            *hLcdIf->pbIfObject->DATA_TRIS &= ~hLcdIf->pbIfObject->DATA_MASK;
+            *hLcdIf->pbIfObject->DATA_TRIS &= hLcdIf->dataClearMask;
                                         /* Set E pin                          */
             *hLcdIf->E_LAT |= hLcdIf->E_BIT;
                                         /* Clear E pin                        */
             *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Get low nibble of instruction      */
-            tempInstruction = instruction & 0x0F;
-                                        /* Get instruction in correct         */
-                                        /* position for 4-bit bus             */
-            tempInstruction <<= startOfLcdIfObjs->lcdIfFlags & 
-                                                            LCDIF_SHIFTDATAMASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempInstruction;
+                                        /* Put low nibble on the data pins    */
+                                        /* in one write                       */
+            *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                        hLcdIf->dataClearMask) |
+                        LCDIF_NIBBLETOPORT(hLcdIf, instruction & 0x0F);
                                         /* Set E pin                          */
             *hLcdIf->E_LAT |= hLcdIf->E_BIT;
                                         /* Clear E pin                        */
@@ -1130,7 +1140,7 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
                                         /* tempAddress                        */
             tempAddress = (*hLcdIf->pbIfObject->DATA_PORT & 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempAddress >>= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
+            tempAddress >>= hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK;
                                         /* Clear E pin                        */
             *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
                                         /* Check to see if nibbles need to be */
@@ -1147,7 +1157,7 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
                                         /* into low four bytes of tempAddress */
             tempAddress2 = (*hLcdIf->pbIfObject->DATA_PORT & 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempAddress2 >>= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
+            tempAddress2 >>= hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK;
                                         /* Clear E pin                        */
             *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
             if (!(hLcdIf->lcdIfFlags & LCDIF_FIXNIBBLESWAP))
@@ -1197,6 +1207,217 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
     return LCDIF_BUSY;    
 }
 
+/*******************************************************************************
+* lcdifWriteDataBlock()
+*
+* Summary: 
+*   Writes a block of data to the LCD interface. RW and RS are set up once
+*   and the data pins made outputs once for the whole block
+*
+* See also:
+*   lcdifWriteData(), lcdifWriteInstructionBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteDataBlock(HLCDIF const hLcdIf,
+                                  const unsigned char * data,
+                                  unsigned char length,
+                                  unsigned int (*pGetMicroseconds)(void),
+                                  unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {   
+                                        /* Clear RW pin                       */
+        *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+                                        /* Set RS pin                         */
+        *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
+        writeLcdIfBlock(hLcdIf, data, length, pGetMicroseconds, interval);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;       
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;    
+}
+
+/*******************************************************************************
+* lcdifWriteInstructionBlock()
+*
+* Summary: 
+*   Writes a block of instructions to the LCD interface. RW and RS are set up
+*   once and the data pins made outputs once for the whole block
+*
+* See also:
+*   lcdifWriteInstruction(), lcdifWriteDataBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instructions to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                         const unsigned char * instruction,
+                                         unsigned char length,
+                                         unsigned int (*pGetMicroseconds)(void),
+                                         unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {   
+                                        /* Clear RW pin                       */
+        *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+                                        /* Clear RS pin                       */
+        *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
+        writeLcdIfBlock(hLcdIf, instruction, length, pGetMicroseconds,
+                        interval);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;       
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;    
+}
+
+/*******************************************************************************
+* lcdifReadDataBlock()
+*
+* Summary: 
+*   Reads a block of data from the LCD interface. RW and RS are set up once
+*   and the data pins made inputs once for the whole block
+*
+* See also:
+*   lcdifReadData(), lcdifWriteDataBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   data            - place to store the data read
+*   length          - number of bytes to read
+*   pGetMicroseconds - time source used to pace the reads, or NULL to read
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifReadDataBlock(HLCDIF const hLcdIf,
+                                 unsigned char * data,
+                                 unsigned char length,
+                                 unsigned int (*pGetMicroseconds)(void),
+                                 unsigned int interval)
+{
+    unsigned char tempData;
+    unsigned int lastReadTime;
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {   
+                                        /* Set RW pin                         */
+        *hLcdIf->pbIfObject->RW_LAT |= hLcdIf->pbIfObject->RW_BIT;
+                                        /* Set RS pin                         */
+        *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
+                                        /* Set data pins to inputs            */
+        if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+        {
+            *hLcdIf->pbIfObject->DATA_TRIS |= hLcdIf->pbIfObject->DATA_MASK;
+        }
+        else
+        {
+            *hLcdIf->pbIfObject->DATA_TRIS = 0xFF;
+        }
+
+        while (length)
+        {
+            if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+            {
+                                        /* Read high nibble of data           */
+                *hLcdIf->E_LAT |= hLcdIf->E_BIT;
+                tempData = (*hLcdIf->pbIfObject->DATA_PORT &
+                                                hLcdIf->pbIfObject->DATA_MASK)
+                           >> (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK);
+                *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
+                                        /* Then the low nibble                */
+                *hLcdIf->E_LAT |= hLcdIf->E_BIT;
+                *data = (unsigned char) ((tempData << 4) +
+                        ((*hLcdIf->pbIfObject->DATA_PORT &
+                                                hLcdIf->pbIfObject->DATA_MASK)
+                         >> (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK)));
+                *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
+            }
+            else
+            {
+                                        /* Set E pin and read the data        */
+                *hLcdIf->E_LAT |= hLcdIf->E_BIT;
+                *data = *hLcdIf->pbIfObject->DATA_PORT;
+                                        /* Clear E pin                        */
+                *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
+            }
+            data++;
+            length--;
+                                        /* Give the LCD controller time to    */
+                                        /* move its address counter on        */
+            if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+            {
+                lastReadTime = pGetMicroseconds();
+                while ((unsigned int) (pGetMicroseconds() - lastReadTime) <=
+                                                                    interval)
+                {
+                    ;
+                }
+            }
+        }
+                                        /* Inform caller that read succeeded  */
+        return LCDIF_SUCCESS;       
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;    
+}
+
 /*******************************************************************************
 * lcdif4BitFunctionSet()
 *
@@ -1245,7 +1466,6 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
 unsigned char lcdif4BitFunctionSet(HLCDIF const hLcdIf, 
                                   unsigned char instruction)
 {
-    unsigned char tempInstruction;
                                         /* Check if we own the peripheral bus */
     if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
     {   
@@ -1257,18 +1477,13 @@ unsigned char lcdif4BitFunctionSet(HLCDIF const hLcdIf,
         *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
                                         /* Clear RS pin                       */
         *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
-                                        /* Make copy of low nibble of         */
-                                        /* instruction                        */
-        tempInstruction = instruction & 0x0F;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-        tempInstruction <<= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
-                                        /* Clear data pins                    */
-        *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Set desired data pins              */
-        *hLcdIf->pbIfObject->DATA_LAT |= tempInstruction;
+                                        /* Put low nibble of instruction on   */
+                                        /* the data pins in one write         */
+        *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                    hLcdIf->dataClearMask) |
+                    LCDIF_NIBBLETOPORT(hLcdIf, instruction & 0x0F);
                                         /* Set data pins to outputs           */
-        *hLcdIf->pbIfObject->DATA_TRIS &= ~hLcdIf->pbIfObject->DATA_MASK;
+        *hLcdIf->pbIfObject->DATA_TRIS &= hLcdIf->dataClearMask;
                                         /* Set E pin                          */
         *hLcdIf->E_LAT |= hLcdIf->E_BIT;
                                         /* Clear E pin                        */
@@ -1356,6 +1571,98 @@ void lcdifFixNibbleSwap(HLCDIF const hLcdIf)
 {
     hLcdIf->lcdIfFlags |= LCDIF_FIXNIBBLESWAP;
 }
+
+/*******************************************************************************
+* writeLcdIfBlock() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Makes the data pins outputs and strobes a block of bytes onto them, pacing
+*   them with the time source given. This function is private to the
+*   LCDIFC18 module.
+*
+* See also:
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   data            - bytes to write
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source, or NULL
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   None
+*
+* Callers: 
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Notes : 
+* 1. RW and RS must already be set up by the caller
+* 2. In 4-bit mode each nibble is put on the data pins with a single
+*    read-modify-write of the LAT register, using the object's nibble table
+*    if there is one
+* 3. The wait is for more than interval, covering the time source's resolution
+*******************************************************************************/
+static void writeLcdIfBlock(HLCDIF const hLcdIf, const unsigned char * data,
+                            unsigned char length,
+                            unsigned int (*pGetMicroseconds)(void),
+                            unsigned int interval)
+{
+    unsigned int lastWriteTime;
+                                        /* Set data pins to outputs           */
+    if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+    {
+        *hLcdIf->pbIfObject->DATA_TRIS &= hLcdIf->dataClearMask;
+    }
+    else
+    {
+        *hLcdIf->pbIfObject->DATA_TRIS = 0x00;
+    }
+
+    while (length)
+    {
+        if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+        {
+                                        /* Put high nibble on the data pins   */
+                                        /* in one write                       */
+            *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                        hLcdIf->dataClearMask) |
+                        LCDIF_NIBBLETOPORT(hLcdIf, *data >> 4);
+                                        /* Set E pin                          */
+            *hLcdIf->E_LAT |= hLcdIf->E_BIT;
+                                        /* Clear E pin                        */
+            *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
+                                        /* Same for the low nibble            */
+            *hLcdIf->pbIfObject->DATA_LAT = (*hLcdIf->pbIfObject->DATA_LAT &
+                        hLcdIf->dataClearMask) |
+                        LCDIF_NIBBLETOPORT(hLcdIf, *data & 0x0F);
+            *hLcdIf->E_LAT |= hLcdIf->E_BIT;
+            *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
+        }
+        else
+        {
+                                        /* Write data to pins                 */
+            *hLcdIf->pbIfObject->DATA_LAT = *data;
+                                        /* Set E pin                          */
+            *hLcdIf->E_LAT |= hLcdIf->E_BIT;
+                                        /* Clear E pin                        */
+            *hLcdIf->E_LAT &= ~hLcdIf->E_BIT;
+        }
+        data++;
+        length--;
+                                        /* Give the LCD controller time to    */
+                                        /* execute before the next byte       */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            lastWriteTime = pGetMicroseconds();
+            while ((unsigned int) (pGetMicroseconds() - lastWriteTime) <=
+                                                                    interval)
+            {
+                ;
+            }
+        }
+    }
+}
    
  
 /*******************************************************************************
@@ -75,6 +75,15 @@
 *                             DEFAULT CONFIGURATION
 *******************************************************************************/
 
+/*******************************************************************************
+* Summary:
+*   Set to 1 to give each LCD interface object a 16 entry table that turns a
+* nibble straight into the value for its data pins in 4-bit bus mode, so that
+* no shift is needed per nibble written. Set to 0 to save the RAM
+*******************************************************************************/
+#ifndef LCDIF_NIBBLETABLE
+#define LCDIF_NIBBLETABLE   1
+#endif
 
 /*******************************************************************************
 *                                    DEFINES
@@ -103,7 +112,9 @@ typedef unsigned int LCDIFNUM;
 /*******************************************************************************
 * New data type LCDIFOBJTYPE                                                     
 * Description:
-*   Holds the object information for each LCD interface object created
+*   Holds the object information for each LCD interface object created. The
+* user fills in the pin information; dataClearMask and nibbleToPort are worked
+* out from it by lcdifCreate()
 *******************************************************************************/
 typedef struct LCDIFOBJTYPE {
     volatile unsigned int         * E_LAT;
@@ -111,6 +122,10 @@ typedef struct LCDIFOBJTYPE {
     PBIFOBJ                       * pbIfObject;
     LCDIFNUM                        lcdIfNum;
     unsigned char                   lcdIfFlags;
+    unsigned int                    dataClearMask;
+#if LCDIF_NIBBLETABLE
+    unsigned int                    nibbleToPort[16];
+#endif
     struct LCDIFOBJTYPE           * nextLcdIfObj;
 } LCDIFOBJ;
 
@@ -157,6 +172,22 @@ unsigned char   lcdifWriteInstruction(HLCDIF      const hLcdIf,
 unsigned char   lcdifReadAddress(HLCDIF           const hLcdIf,
                                  unsigned char  * const address);
 
+unsigned char   lcdifWriteDataBlock(HLCDIF        const hLcdIf,
+                                    const unsigned char * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                    const unsigned char * instruction,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifReadDataBlock(HLCDIF         const hLcdIf,
+                                    unsigned char     * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+
 unsigned char   lcdif4BitFunctionSet(HLCDIF       const hLcdIf,
                                       unsigned char     instruction);
 
@@ -75,6 +75,13 @@
 *******************************************************************************/
 #define LCDIF_FIXNIBBLESWAP (0x01 << 4)
 
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD interface strobes several E pins at once and
+* so may only be written
+*******************************************************************************/
+#define LCDIF_BROADCAST     (0x01 << 3)
+
 /*******************************************************************************
 * Summary:
 *   Used to mask the bitShiftData information in flags (lowest three bits)
@@ -83,14 +90,88 @@
 
 /*******************************************************************************
 * Summary:
-*   Used to indicate that the parallel bus is not busy when the LCD interface
-* object is initialised in lcdifCreate()
-* #### ToDo: If this module becomes a generic module for all controllers,
-*            PBIF_NOT_BUSY should be 0x00 for PIC24, dsPIC and PIC32 as they
-*            will use an atomic bit test & set to indicate the bus is in use and
-*            not a subtraction as is used for the PIC18
+*   Gives the value to write to the data pins for a nibble in 4-bit bus mode
+*******************************************************************************/
+#if LCDIF_NIBBLETABLE
+#define LCDIF_NIBBLETOPORT(hLcdIf, nibble)  ((hLcdIf)->nibbleToPort[(nibble)])
+#else
+#define LCDIF_NIBBLETOPORT(hLcdIf, nibble)                                     \
+                    ((nibble) << ((hLcdIf)->lcdIfFlags & LCDIF_SHIFTDATAMASK))
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Drive the control pins, turn the data pins around and put a nibble or byte
+* on the data pins. With LCDIF_ATOMICPINS each of these is one store to the
+* SET, CLR or INV register of the port, so pins on the same port changed by
+* interrupt handlers are never overwritten. Otherwise they read, modify and
+* write the LAT and TRIS registers
+*******************************************************************************/
+#if LCDIF_ATOMICPINS
+#define LCDIF_RWHIGH(hLcdIf)                                                   \
+        (*(hLcdIf)->pbIfObject->RW_LATSET = (hLcdIf)->pbIfObject->RW_BIT)
+#define LCDIF_RWLOW(hLcdIf)                                                    \
+        (*(hLcdIf)->pbIfObject->RW_LATCLR = (hLcdIf)->pbIfObject->RW_BIT)
+#define LCDIF_RSHIGH(hLcdIf)                                                   \
+        (*(hLcdIf)->pbIfObject->RS_LATSET = (hLcdIf)->pbIfObject->RS_BIT)
+#define LCDIF_RSLOW(hLcdIf)                                                    \
+        (*(hLcdIf)->pbIfObject->RS_LATCLR = (hLcdIf)->pbIfObject->RS_BIT)
+#define LCDIF_EHIGH(hLcdIf)                                                    \
+        (*(hLcdIf)->pbIfLcdEnObject->E_LATSET =                                \
+                                            (hLcdIf)->pbIfLcdEnObject->E_BIT)
+#define LCDIF_ELOW(hLcdIf)                                                     \
+        (*(hLcdIf)->pbIfLcdEnObject->E_LATCLR =                                \
+                                            (hLcdIf)->pbIfLcdEnObject->E_BIT)
+#define LCDIF_DATAOUT(hLcdIf)                                                  \
+        (*(hLcdIf)->pbIfObject->DATA_TRISCLR = (hLcdIf)->pbIfObject->DATA_MASK)
+#define LCDIF_DATAIN(hLcdIf)                                                   \
+        (*(hLcdIf)->pbIfObject->DATA_TRISSET = (hLcdIf)->pbIfObject->DATA_MASK)
+#define LCDIF_PUTNIBBLE(hLcdIf, nibble)                                        \
+        (*(hLcdIf)->pbIfObject->DATA_LATINV =                                  \
+                    (*(hLcdIf)->pbIfObject->DATA_LAT ^                         \
+                     LCDIF_NIBBLETOPORT(hLcdIf, nibble)) &                     \
+                    (hLcdIf)->pbIfObject->DATA_MASK)
+#define LCDIF_PUTBYTE(hLcdIf, byte)                                            \
+        (*(hLcdIf)->pbIfObject->DATA_LATINV =                                  \
+                    (*(hLcdIf)->pbIfObject->DATA_LAT ^ (byte)) &               \
+                    (hLcdIf)->pbIfObject->DATA_MASK)
+#else
+#define LCDIF_RWHIGH(hLcdIf)                                                   \
+        (*(hLcdIf)->pbIfObject->RW_LAT |= (hLcdIf)->pbIfObject->RW_BIT)
+#define LCDIF_RWLOW(hLcdIf)                                                    \
+        (*(hLcdIf)->pbIfObject->RW_LAT &= ~(hLcdIf)->pbIfObject->RW_BIT)
+#define LCDIF_RSHIGH(hLcdIf)                                                   \
+        (*(hLcdIf)->pbIfObject->RS_LAT |= (hLcdIf)->pbIfObject->RS_BIT)
+#define LCDIF_RSLOW(hLcdIf)                                                    \
+        (*(hLcdIf)->pbIfObject->RS_LAT &= ~(hLcdIf)->pbIfObject->RS_BIT)
+#define LCDIF_EHIGH(hLcdIf)                                                    \
+        (*(hLcdIf)->pbIfLcdEnObject->E_LAT |=                                  \
+                                            (hLcdIf)->pbIfLcdEnObject->E_BIT)
+#define LCDIF_ELOW(hLcdIf)                                                     \
+        (*(hLcdIf)->pbIfLcdEnObject->E_LAT &=                                  \
+                                            ~(hLcdIf)->pbIfLcdEnObject->E_BIT)
+#define LCDIF_DATAOUT(hLcdIf)                                                  \
+        (*(hLcdIf)->pbIfObject->DATA_TRIS &= (hLcdIf)->dataClearMask)
+#define LCDIF_DATAIN(hLcdIf)                                                   \
+        (*(hLcdIf)->pbIfObject->DATA_TRIS |= (hLcdIf)->pbIfObject->DATA_MASK)
+#define LCDIF_PUTNIBBLE(hLcdIf, nibble)                                        \
+        (*(hLcdIf)->pbIfObject->DATA_LAT =                                     \
+                    (*(hLcdIf)->pbIfObject->DATA_LAT &                         \
+                     (hLcdIf)->dataClearMask) |                                \
+                    LCDIF_NIBBLETOPORT(hLcdIf, nibble))
+#define LCDIF_PUTBYTE(hLcdIf, byte)                                            \
+        (*(hLcdIf)->pbIfObject->DATA_LAT =                                     \
+                    (*(hLcdIf)->pbIfObject->DATA_LAT &                         \
+                     (hLcdIf)->dataClearMask) | (byte))
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Values of the parallel bus mutex. It is taken by an atomic exchange of
+* PBIF_BUSY for PBIF_NOT_BUSY and is initialised in lcdifCreate()
 *******************************************************************************/
 #define PBIF_NOT_BUSY       0x00
+#define PBIF_BUSY           0x01
 
 /*******************************************************************************
 * Summary:
@@ -98,6 +179,12 @@
 *******************************************************************************/
 #define LCDIF_BUSY          0
 
+/*******************************************************************************
+* Summary:
+* Number of 32-bit words in the activeLcdIfObjects bitmap
+*******************************************************************************/
+#define LCDIF_SLOTWORDS     ((LCDIF_MAXOBJECTS + 31) / 32)
+
 /*******************************************************************************
 * Summary:
 * Used to indicate that the LCD interface call was successful
@@ -125,28 +212,33 @@
 
 /*******************************************************************************
 * Summary:
-* Local pointer to a linked list of LCD intrface objects
+* Local table of LCD interface objects, indexed by interface number minus one
 *******************************************************************************/
-static LCDIFOBJ * startOfLcdIfObjs;
+static LCDIFOBJ * lcdIfSlots[LCDIF_MAXOBJECTS];
 
 /*******************************************************************************
 * Summary:
-* Used to note how many LCD interface objects are active. Each bit in this
-* variable relates to one active object.
+* Used to note which LCD interface objects are active. Each bit in this bitmap
+* relates to one slot of lcdIfSlots.
 *******************************************************************************/
-static unsigned int activeLcdIfObjects;
+static unsigned int activeLcdIfObjects[LCDIF_SLOTWORDS];
 
 /*******************************************************************************
 *#X#                          LOCAL FUNCTION PROTOTYPES
 *******************************************************************************/
-                                        /* These functions are implemented in */
-                                        /* assembly code and hence are        */
-                                        /* defined as extern                  */
-/* $$$$ These functions are temporarily ignored for test purposes.            */
-#if 0
-extern unsigned char    pbifGetBusMutex(unsigned int * pbIfFlag);
-extern void             pbifReturnBusMutex(unsigned int * pbIfFlag);
+static unsigned char    pbifGetBusMutex(volatile unsigned int * mutex);
+static void             pbifReturnBusMutex(volatile unsigned int * mutex);
+#if PBIF_MUTEXSTATS
+static void             pbifAtomicIncrement(volatile unsigned int * counter);
 #endif
+static LCDIFNUM         createLcdIf(LCDIFOBJ * const lcdIfObj,
+                                    unsigned char broadcast);
+static unsigned int     findFreeLcdIfSlot(void);
+static void             writeLcdIfBlock(HLCDIF const hLcdIf,
+                                        const unsigned char * data,
+                                        unsigned char length,
+                                        unsigned int (*pGetMicroseconds)(void),
+                                        unsigned int interval);
 
 
 /*******************************************************************************
@@ -177,11 +269,17 @@ extern void             pbifReturnBusMutex(unsigned int * pbIfFlag);
 *******************************************************************************/
 void lcdifInit(void)
 {
-                                        /* Initialise the local pointer to    */
-                                        /* the list of LCDIF objects          */
-    startOfLcdIfObjs = (LCDIFOBJ *) 0;
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
                                         /* Currently no active LCDIF objects  */
-    activeLcdIfObjects = 0;
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
 }
 
 /*******************************************************************************
@@ -207,11 +305,17 @@ void lcdifInit(void)
 *******************************************************************************/
 void lcdifDeinit(void)
 {
-                                        /* Initialise the local pointer to    */
-                                        /* the list of LCDIF objects          */
-    startOfLcdIfObjs = (LCDIFOBJ *) 0;
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
                                         /* Currently no active LCDIF objects  */
-    activeLcdIfObjects = 0;
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
 
 }
 
@@ -222,13 +326,14 @@ void lcdifDeinit(void)
 *   Creates an LCD interface for use by this module
 *
 * See also:
-*   lcdifDestroy()
+*   lcdifDestroy(), lcdifCreateBroadcast()
 *
 * Arguments: 
-*   lcdIfObj    - lcdif object to insert in a list of lcdif objects 
+*   lcdIfObj    - lcdif object to enter in the slot table
 *
 * Returns: 
-*   - 1 to MAX_LCFIFS  	- number the LCD interface has been assigned if it was 
+*   - 1 to LCDIF_MAXOBJECTS
+*                       - number the LCD interface has been assigned if it was 
 *                         possible to allocate it
 *   - 0		            - if the LCD interface allocation failed
 *
@@ -236,223 +341,52 @@ void lcdifDeinit(void)
 *   Main application code
 *
 * Notes : 
-*   1. lcdifCreate() must have been called prior to calling this function
+*   1. lcdifInit() must have been called prior to calling this function
+*   2. The number assigned is the object's slot in the slot table plus one,
+*      and is always the lowest one free
+*   3. E_BIT must have exactly one bit set
 *******************************************************************************/
 LCDIFNUM lcdifCreate(LCDIFOBJ * const lcdIfObj)
 {
-    LCDIFOBJ * localLcdIfObj;           /* Stores local copy of pointer to    */
-                                        /* linked list so we can insert next  */
-                                        /* object in at the top               */
-    unsigned int  interfaceNumber = 0x0001;      
-                                        /* Used to calculate the interface    */
-                                        /* number to return to caller         */
-    unsigned short bitTest;
-    unsigned short bitCount;
-                                        /* Used to note bus width             */
-    unsigned short busWidth;
-                                        /* Used to note how many bits to      */
-                                        /* shift bus data                     */
-    unsigned short busDataShift;
-                                        /* Check we got an object to point to */
-    if(lcdIfObj != (LCDIFOBJ *) 0)
-    {
-                                        /* Check that there is some useful    */
-                                        /* information in the object that was */
-                                        /* passed                             */
-                                        /* First, do we have a E_LAT?       */
-        if (lcdIfObj->pbIfLcdEnObject->E_LAT == (REGISTER_DATA_TYPE *) 0)
-        {
-            goto cannot_create_if;
-        }
-                                        /* Do we have only one E_BIT?        */
-        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
-        {
-            if (lcdIfObj->pbIfLcdEnObject->E_BIT & bitTest)
-            {
-                bitCount++;
-            }    
-        }
-        if (bitCount != 1)
-        {
-            goto cannot_create_if;
-        }    
-                                        /* Do we have a PBIFOBJ object?       */
-        if (lcdIfObj->pbIfObject == (PBIFOBJ *) 0)
-        {
-            goto cannot_create_if;
-        }    
-                                        /* Do we have anything in the         */
-                                        /* PBIFOBJ object?                    */
-                                        /* Do we have only one RW_BIT?        */
-        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
-        {
-            if (lcdIfObj->pbIfObject->RW_BIT & bitTest)
-            {
-                bitCount++;
-            }    
-        }
-        if (bitCount != 1)
-        {
-            goto cannot_create_if;
-        }    
-                                        /* Do we have only one RS_BIT?        */
-        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
-        {
-            if (lcdIfObj->pbIfObject->RW_BIT & bitTest)
-            {
-                bitCount++;
-            }    
-        }
-        if (bitCount != 1)
-        {
-            goto cannot_create_if;
-        }    
-                                        /* Do we have only four or eight      */
-                                        /* DATA_MASK bits                     */
-        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
-        {
-            if (lcdIfObj->pbIfObject->DATA_MASK & bitTest)
-            {
-                bitCount++;
-            }    
-        }
-        if (bitCount == 4)
-        {
-            busWidth = bitCount;
-                                        /* Calculate number of bits to shift  */
-                                        /* data for 4-bit bus                 */
-            for (bitTest = 0x01, busDataShift = 0; bitTest != 0x00; 
-                                                        bitTest <<= 1)
-            {
-                if (!(lcdIfObj->pbIfObject->DATA_MASK & bitTest))
-                {
-                    busDataShift++;
-                }
-                else
-                {
-                    break;
-                }    
-            }    
-        }    
-        else if (bitCount == 8)
-        {
-            busWidth = bitCount;
-        }    
-        else
-        {
-            goto cannot_create_if;
-        }    
-                                        /* Do we have a RW_LAT?              */
-        if (lcdIfObj->pbIfObject->RW_LAT == (REGISTER_DATA_TYPE *) 0)
-        {
-            goto cannot_create_if;
-        }
-                                        /* Do we have a RS_LAT?              */
-        if (lcdIfObj->pbIfObject->RS_LAT == (REGISTER_DATA_TYPE *) 0)
-        {
-            goto cannot_create_if;
-        }
-                                        /* Do we have a DATA_PORT?            */
-        if (lcdIfObj->pbIfObject->DATA_PORT == (REGISTER_DATA_TYPE *) 0)
-        {
-            goto cannot_create_if;
-        }
-                                        /* Do we have a DATA_LAT?             */
-        if (lcdIfObj->pbIfObject->DATA_LAT == (REGISTER_DATA_TYPE *) 0)
-        {
-            goto cannot_create_if;
-        }
-                                        /* Do we have a DATA_TRIS?            */
-        if (lcdIfObj->pbIfObject->DATA_TRIS == (REGISTER_DATA_TYPE *) 0)
-        {
-            goto cannot_create_if;
-        }
-                                        /* If we got here the object contains */
-                                        /* valid data we can work with        */
+    return createLcdIf(lcdIfObj, 0);
+}
 
-                                        /* If there are no active objects in  */
-                                        /* the list put this object at the    */
-                                        /* top                                */
-        if (activeLcdIfObjects == 0 && startOfLcdIfObjs == (LCDIFOBJ *) 0)
-        {
-            startOfLcdIfObjs = lcdIfObj;
-            startOfLcdIfObjs->nextLcdIfObj = (LCDIFOBJ *) 0;
-                                        /* Assign the interface number        */
-            activeLcdIfObjects |= interfaceNumber;
-            startOfLcdIfObjs->lcdIfNum = interfaceNumber;
-                                        /* Clear the object's flags           */
-            startOfLcdIfObjs->lcdIfFlags = 0;
-                                        /* Note parallel bus width - if it is */
-                                        /* not 4 it must be 8                 */
-                                        /* Also note amount to shift data to  */
-                                        /* use on the bus                     */
-            if (busWidth == 4)
-            {
-                startOfLcdIfObjs->lcdIfFlags |= LCDIF_PBWIDTH4BITS;
-                startOfLcdIfObjs->lcdIfFlags |= (busDataShift & 
-                                                        LCDIF_SHIFTDATAMASK);
-            }
-                                        /* Note that the parallel bus is not  */
-                                        /* in use                             */
-            startOfLcdIfObjs->pbIfObject->mutex = PBIF_NOT_BUSY;
-            
-            return startOfLcdIfObjs->lcdIfNum;
-        }
-                                        /* Otherwise, if we haven't allocated */
-                                        /* all the LCD interface objects we   */
-                                        /* can support, insert another        */
-                                        /* #### Need to mask this to 16-bits  */
-        else if (activeLcdIfObjects != 0xFFFF)
-        {
-                                        /* Insert this object at start of the */
-                                        /* list                               */
-            localLcdIfObj = startOfLcdIfObjs;
-            startOfLcdIfObjs = lcdIfObj;
-            startOfLcdIfObjs->nextLcdIfObj = localLcdIfObj;
-                                        /* Clear the object's flags           */
-            startOfLcdIfObjs->lcdIfFlags = 0;
-                                        /* Note parallel bus width - if it is */
-                                        /* not 4 it must be 8                 */
-                                        /* Also note amount to shift data to  */
-                                        /* use on the bus                     */
-            if (busWidth == 4)
-            {
-                startOfLcdIfObjs->lcdIfFlags |= LCDIF_PBWIDTH4BITS;
-                startOfLcdIfObjs->lcdIfFlags |= (busDataShift & 
-                                                        LCDIF_SHIFTDATAMASK);
-            }
-                                        /* Note that the parallel bus is not  */
-                                        /* in use                             */
-            startOfLcdIfObjs->pbIfObject->mutex = PBIF_NOT_BUSY;
-            
-                                        /* Find a free LCD interface number   */
-                                        /* for this interface                 */
-                                        /* Interface '1' is already assigned  */
-                                        /* if we're here. Start looking from  */
-                                        /* interface '2'                      */
-            interfaceNumber = 0x0002;
-            
-            do
-            {
-                if (!(activeLcdIfObjects & interfaceNumber))
-                {
-                                        /* Assign the interface number        */
-                    activeLcdIfObjects |= interfaceNumber;
-                    startOfLcdIfObjs->lcdIfNum = interfaceNumber;
-                    return startOfLcdIfObjs->lcdIfNum;
-                } 
-                                        /* That wasn't free; try next bit     */
-                                        /* position                           */
-                interfaceNumber <<= 1;
-                                        /* Just in case unsigned int is not   */
-                                        /* 16-bits, mask it off               */
-                interfaceNumber &= 0xFFFF;   
-            } while(interfaceNumber != 0);
-        }
-    }
-cannot_create_if:
-                                        /* Couldn't create interface          */
-    return 0;
+/*******************************************************************************
+* lcdifCreateBroadcast()
+*
+* Summary: 
+*   Creates a write-only LCD interface that strobes the E pins of several
+*   displays together, so that one write reaches all of them
+*
+* See also:
+*   lcdifCreate(), lcdifDestroy()
+*
+* Arguments: 
+*   lcdIfObj    - lcdif object to enter in the slot table. E_BIT may have one
+*                 or more bits set, all of them on E_LAT
+*
+* Returns: 
+*   - 1 to LCDIF_MAXOBJECTS
+*                       - number the LCD interface has been assigned if it was 
+*                         possible to allocate it
+*   - 0		            - if the LCD interface allocation failed
+*
+* Callers: 
+*   Main application code
+*
+* Notes : 
+*   1. lcdifInit() must have been called prior to calling this function
+*   2. The displays must share RW, RS and the data pins with each other. Each
+*      also needs its own interface from lcdifCreate() for initialisation and
+*      anything else that has to read
+*   3. lcdifReadData() and lcdifReadAddress() always return LCDIF_BUSY on a
+*      broadcast interface, as every display would drive the data pins at once
+*   4. The broadcast interface shares the PBIFOBJ, and so the bus mutex, with
+*      the displays' own interfaces
+*******************************************************************************/
+LCDIFNUM lcdifCreateBroadcast(LCDIFOBJ * const lcdIfObj)
+{
+    return createLcdIf(lcdIfObj, 1);
 }
 
 /*******************************************************************************
@@ -479,77 +413,24 @@ cannot_create_if:
 *******************************************************************************/
 unsigned char lcdifDestroy(LCDIFNUM lcdIfNumber)
 {
-    LCDIFOBJ * localLcdIfObj;           /* Stores local copy of pointer to    */
-                                        /* linked list so we can insert next  */
-                                        /* object in at the top               */
-    LCDIFOBJ * tempLcdIfObj;            /* Temporary object pointer so we can */
-                                        /* remove an object from the list     */
-    unsigned int  interfaceNumber;      /* Used to calculate the interface    */
-                                        /* number to return to caller         */
+    unsigned int slot;                  /* Slot holding the object            */
                                         
-                                        /* Check that there are created       */
-                                        /* objects                            */
-    if(startOfLcdIfObjs != (LCDIFOBJ *) 0)
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
     {
-                                        /* Search through the list to find    */
-                                        /* this interface                     */
-        localLcdIfObj = startOfLcdIfObjs;
-
-                                        /* If this is the first object in the */
-                                        /* list and the object is not open,   */
-                                        /* simply remove it                   */
-        if (startOfLcdIfObjs->lcdIfNum == lcdIfNumber && 
-            !(localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
+        slot = lcdIfNumber - 1;
+                                        /* If the slot holds an object that   */
+                                        /* is not open, simply remove it      */
+        if (lcdIfSlots[slot] != (LCDIFOBJ *) 0 &&
+            !(lcdIfSlots[slot]->lcdIfFlags & LCDIF_OPEN))
         {
-            startOfLcdIfObjs = startOfLcdIfObjs->nextLcdIfObj;
+            lcdIfSlots[slot] = (LCDIFOBJ *) 0;
                                         /* Also note that we have one less    */
                                         /* active LCD interface               */
-            activeLcdIfObjects &= ~lcdIfNumber;
+            activeLcdIfObjects[slot / 32] &= ~(1u << (slot % 32));
             return 1;
         }
-                                        /* Otherwise if this object is still  */
-                                        /* open, return that is can't be      */
-                                        /* destroyed                          */
-        else if (startOfLcdIfObjs->lcdIfNum == lcdIfNumber &&
-                 (localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
-        {
-            return 0;
-        }    
-                                        /* Otherwise parse through list of    */
-                                        /* objects until we find the object   */
-                                        /* or find no object with that number */
-        do
-        {
-                                        /* Save pointer to currect object in  */
-                                        /* case next object will be removed   */
-            tempLcdIfObj = localLcdIfObj;
-                                        /* Ensure that this object actually   */
-                                        /* points to another object and not   */
-                                        /* to NULL                            */
-            if(localLcdIfObj->nextLcdIfObj != (LCDIFOBJ *) 0)
-            {
-                                        /* Point to that next object in       */
-                                        /* list...                            */                          
-                localLcdIfObj = localLcdIfObj->nextLcdIfObj;
-                                        /* ...and see if it is the            */
-                                        /* interface we are searching for and */
-                                        /* that the interface is not open     */
-                if (localLcdIfObj->lcdIfNum == lcdIfNumber &&
-                   !(localLcdIfObj->lcdIfFlags && LCDIF_OPEN))
-                {
-                                        /* If so, remove this item from list  */
-                                        /* by pointing previous object to     */
-                                        /* where this object points           */
-                    tempLcdIfObj->nextLcdIfObj = localLcdIfObj->nextLcdIfObj;
-                                        /* Also note that we have one less    */
-                                        /* active LCD interface               */
-                    activeLcdIfObjects &= ~lcdIfNumber;
-                    return 1;
-                }
-            }    
-            
-        } while(localLcdIfObj->nextLcdIfObj != (LCDIFOBJ *) 0);
-
     }
                                         /* Couldn't destroy interface         */
     return 0;
@@ -581,43 +462,24 @@ unsigned char lcdifDestroy(LCDIFNUM lcdIfNumber)
 *******************************************************************************/
 HLCDIF lcdifOpen(LCDIFNUM lcdIfNumber)
 {
-	LCDIFOBJ * localLcdIfObj;           /* Stores local copy of pointer to    */
-                                        /* linked list so we can insert next  */
-                                        /* object in at the top               */
+	LCDIFOBJ * localLcdIfObj;           /* Object in the requested slot       */
 	
-                                        /* Check that there are created       */
-                                        /* objects                            */
-    if(startOfLcdIfObjs != (LCDIFOBJ *) 0)
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
     {
-                                        /* Check that a LCDIFNUM object       */
-                                        /* exists with lcdIfNumber            */
+        localLcdIfObj = lcdIfSlots[lcdIfNumber - 1];
 
-        localLcdIfObj = startOfLcdIfObjs;
-        
-        do
+        	                            /* Check there is an object in the    */
+        	                            /* slot that is not already open      */
+        if (localLcdIfObj != (LCDIFOBJ *) 0 &&
+            !(localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
         {
-    	    if (localLcdIfObj->lcdIfNum == lcdIfNumber)
-    	    {
-        	                            /* Check buffer is not already open   */
-                if (!(localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
-                {
                                         /* Note that it is now in use         */
-                    localLcdIfObj->lcdIfFlags |= LCDIF_OPEN;
+            localLcdIfObj->lcdIfFlags |= LCDIF_OPEN;
         	                            /* Return handle to it                */
-        	        return localLcdIfObj;
-        	    }
-        	                            /* If buffer is already open, return  */
-        	                            /* NULL handle pointer                */
-        	    else
-        	    {
-            	    return (LCDIFOBJ *) 0;
-            	}    
-        	}    
-        	else
-        	{
-            	localLcdIfObj = localLcdIfObj->nextLcdIfObj;
-            }   	
-    	} while (localLcdIfObj != (LCDIFOBJ *) 0);
+            return localLcdIfObj;
+        }
     }
     	                                /* Return handle to NULL otherwise    */
     return (LCDIFOBJ *) 0;
@@ -649,28 +511,20 @@ HLCDIF lcdifOpen(LCDIFNUM lcdIfNumber)
 *******************************************************************************/
 LCDIFNUM lcdifClose(HLCDIF const hLcdIf)
 {
-                                        /* Check that there are created       */
-                                        /* objects                            */
-    if(startOfLcdIfObjs != (LCDIFOBJ *) 0)
-    {
     	                                /* Check LCD interface is actually    */
     	                                /* open                               */
-        if (hLcdIf->lcdIfFlags & LCDIF_OPEN)
-        {
+    if (hLcdIf->lcdIfFlags & LCDIF_OPEN)
+    {
         	                            /* Note that this LCD interface       */
         	                            /* object is closed                   */
-            hLcdIf->lcdIfFlags &= ~LCDIF_OPEN;
+        hLcdIf->lcdIfFlags &= ~LCDIF_OPEN;
                                         /* Return LCD interface object's      */
                                         /* interface number                   */
-            return hLcdIf->lcdIfNum;
-        }
+        return hLcdIf->lcdIfNum;
+    }
                                         /* Otherwise return 0 to say that     */
                                         /* buffer object wasn't open          */
-        else
-        {
-            return (LCDIFNUM) 0;
-        }
-    }
+    return (LCDIFNUM) 0;
 }
 
 /*******************************************************************************
@@ -695,30 +549,34 @@ LCDIFNUM lcdifClose(HLCDIF const hLcdIf)
 * Notes : 
 * 1. Caller must have 'created' at least one LCD interface object before
 *    calling this function
-*  $$$$ This function always always succeeds for now
+* 2. LCD interfaces sharing one PBIFOBJ exclude each other, including when
+*    they are used from different interrupt priority levels. The mutex is not
+*    recursive: a second call before lcdifReturnPb() returns 0
+* 3. Taking and returning the mutex costs a handful of instructions, so it
+*    may be done for every byte written
 *******************************************************************************/
 unsigned char lcdifGetPb(HLCDIF const hLcdIf)
 {
-       return 1;
-#if 0
                                         /* Attempt to get the peripheral bus  */
                                         /* for this hLcdIf object             */
     if (pbifGetBusMutex(&hLcdIf->pbIfObject->mutex))
     {
+#if PBIF_MUTEXSTATS
+        hLcdIf->pbIfObject->mutexOwner = hLcdIf;
+        hLcdIf->pbIfObject->mutexTaken++;
+#endif
                                         /* If we were successful, note the    */
                                         /* fact in the LCD interface's flags  */
                                         /* variable                           */
         hLcdIf->lcdIfFlags |= LCDIF_OWNPB;
         return 1;
     }
-    else
-    {
                                         /* If we failed in our attempt,       */
                                         /* return 0                           */
-        return 0;
-    }
+#if PBIF_MUTEXSTATS
+    pbifAtomicIncrement(&hLcdIf->pbIfObject->mutexContended);
 #endif
-
+    return 0;
 }    
 
 /*******************************************************************************
@@ -742,17 +600,23 @@ unsigned char lcdifGetPb(HLCDIF const hLcdIf)
 * Notes : 
 * 1. Caller must have 'created' at least one LCD interface object before
 *    calling this function
-*  $$$$ This function always always succeeds for now
+* 2. Does nothing if this LCD interface doesn't own the peripheral bus, so
+*    that it can't release a bus another interface has taken
 *******************************************************************************/
 void lcdifReturnPb(HLCDIF const hLcdIf)
 {
-#if 0
-                                        /* Return the peripheral bus          */
-    pbifReturnBusMutex(&hLcdIf->pbIfObject->mutex);
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
                                         /* Note this in the LCD interface's   */
-                                        /* flags variable                     */
-    hLcdIf->lcdIfFlags &= ~LCDIF_OWNPB;
+                                        /* flags variable while we still own  */
+                                        /* the bus                            */
+        hLcdIf->lcdIfFlags &= ~LCDIF_OWNPB;
+#if PBIF_MUTEXSTATS
+        hLcdIf->pbIfObject->mutexOwner = (void *) 0;
 #endif
+                                        /* Return the peripheral bus          */
+        pbifReturnBusMutex(&hLcdIf->pbIfObject->mutex);
+    }
 }    
 
 /*******************************************************************************
@@ -787,9 +651,8 @@ void lcdifReturnPb(HLCDIF const hLcdIf)
 *******************************************************************************/
 unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
 {
-    unsigned char tempData;
                                         /* Check if we own the peripheral bus */
-    if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
     {   
                                         /* If it is a 4-bit bus, use a 4-bit  */
                                         /* access                             */
@@ -800,37 +663,25 @@ unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
                                         /* datasheets                         */
                                         
                                         /* Clear RW pin                       */
-            *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWLOW(hLcdIf);
                                         /* Set RS pin                         */
-            *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
-                                        /* Get high nibble of data            */
-            tempData = data >> 4;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-            tempData <<= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempData;
+            LCDIF_RSHIGH(hLcdIf);
+                                        /* Put high nibble on the data pins   */
+                                        /* in one write                       */
+            LCDIF_PUTNIBBLE(hLcdIf, data >> 4);
                                         /* Set data pins to outputs           */
-            *hLcdIf->pbIfObject->DATA_TRIS &= ~hLcdIf->pbIfObject->DATA_MASK;
+            LCDIF_DATAOUT(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Get low nibble of data             */
-            tempData = data & 0x0F;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-            tempData <<= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempData;
+            LCDIF_ELOW(hLcdIf);
+                                        /* Put low nibble on the data pins    */
+                                        /* in one write                       */
+            LCDIF_PUTNIBBLE(hLcdIf, data & 0x0F);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Write data process finished        */
         }
         else
@@ -840,17 +691,17 @@ unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
                                         /* datasheets                         */
                                         
                                         /* Clear RW pin                       */
-            *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWLOW(hLcdIf);
                                         /* Set RS pin                         */
-            *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
+            LCDIF_RSHIGH(hLcdIf);
                                         /* Write data to pins                 */
-            *hLcdIf->pbIfObject->DATA_LAT = data;
+            LCDIF_PUTBYTE(hLcdIf, data);
                                         /* Set data pins to outputs           */
-            *hLcdIf->pbIfObject->DATA_TRIS = 0x00;
+            LCDIF_DATAOUT(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Write data process finished        */
         }    
                                         /* Inform caller that write succeeded */
@@ -898,7 +749,8 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
     unsigned char tempData = 0;
     unsigned char tempData2 = 0;
                                         /* Check if we own the peripheral bus */
-    if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
+                                        /* and are not broadcasting           */
+    if ((hLcdIf->lcdIfFlags & (LCDIF_OWNPB | LCDIF_BROADCAST)) == LCDIF_OWNPB)
     {   
                                         /* If it is a 4-bit bus, use a 4-bit  */
                                         /* access                             */
@@ -909,36 +761,36 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
                                         /* datasheets                         */
                                         
                                         /* Set RW pin                         */
-            *hLcdIf->pbIfObject->RW_LAT |= hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWHIGH(hLcdIf);
                                         /* Set RS pin                         */
-            *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
+            LCDIF_RSHIGH(hLcdIf);
                                         /* Set data pins to inputs            */
-            *hLcdIf->pbIfObject->DATA_TRIS |= hLcdIf->pbIfObject->DATA_MASK;
+            LCDIF_DATAIN(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Read high nibble of data and shift */
                                         /* into low four bytes of tempData    */
             tempData = (*hLcdIf->pbIfObject->DATA_PORT & 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempData >>= (startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK);
+            tempData >>= (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Shift data into high nibble of     */
                                         /* tempData                           */
             tempData <<= 4;
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Read low nibble of data and add    */
                                         /* into low four bytes of tempData    */
             tempData2 = (*hLcdIf->pbIfObject->DATA_PORT& 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempData2 >>= (startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK);
+            tempData2 >>= (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK);
                                         /* Formulate whole data byte          */
             tempData += tempData2;
                                         /* Give value read back to caller     */
             *data = tempData;    
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Read data process finished         */
         }
         else
@@ -948,18 +800,18 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
                                         /* datasheets                         */
                                         
                                         /* Set RW pin                         */
-            *hLcdIf->pbIfObject->RW_LAT |= hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWHIGH(hLcdIf);
                                         /* Set RS pin                         */
-            *hLcdIf->pbIfObject->RS_LAT |= hLcdIf->pbIfObject->RS_BIT;
+            LCDIF_RSHIGH(hLcdIf);
                                         /* Set data pins to inputs            */
-            *hLcdIf->pbIfObject->DATA_TRIS = 0xFF;
+            LCDIF_DATAIN(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Read high nibble of data and shift */
                                         /* into low four bytes of tempData    */
             tempData = *hLcdIf->pbIfObject->DATA_PORT;
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Give value read back to caller     */
             * data = tempData;          
                                         /* Read data process finished         */   
@@ -1004,9 +856,8 @@ unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
 unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf, 
                                    unsigned char instruction)
 {
-    unsigned char tempInstruction;
                                         /* Check if we own the peripheral bus */
-    if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
     {   
                                         /* If it is a 4-bit bus, use a 4-bit  */
                                         /* access                             */
@@ -1017,39 +868,25 @@ unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf,
                                         /* datasheets                         */
                                         
                                         /* Clear RW pin                       */
-            *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWLOW(hLcdIf);
                                         /* Clear RS pin                       */
-            *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
-                                        /* Get high nibble of instruction     */
-            tempInstruction = instruction >> 4;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-            tempInstruction <<= startOfLcdIfObjs->lcdIfFlags & 
-                                                            LCDIF_SHIFTDATAMASK;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempInstruction;
+            LCDIF_RSLOW(hLcdIf);
+                                        /* Put high nibble on the data pins   */
+                                        /* in one write                       */
+            LCDIF_PUTNIBBLE(hLcdIf, instruction >> 4);
                                         /* Set data pins to outputs           */
-            *hLcdIf->pbIfObject->DATA_TRIS &= ~hLcdIf->pbIfObject->DATA_MASK;
+            LCDIF_DATAOUT(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
-                                        /* Clear data pins                    */
-            *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Get low nibble of instruction      */
-            tempInstruction = instruction & 0x0F;
-                                        /* Get instruction in correct         */
-                                        /* position for 4-bit bus             */
-            tempInstruction <<= startOfLcdIfObjs->lcdIfFlags & 
-                                                            LCDIF_SHIFTDATAMASK;
-                                        /* Set desired data pins              */
-            *hLcdIf->pbIfObject->DATA_LAT |= tempInstruction;
+            LCDIF_ELOW(hLcdIf);
+                                        /* Put low nibble on the data pins    */
+                                        /* in one write                       */
+            LCDIF_PUTNIBBLE(hLcdIf, instruction & 0x0F);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Write instruction process finished */
         }
         else
@@ -1059,17 +896,17 @@ unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf,
                                         /* datasheets                         */
                                         
                                         /* Clear RW pin                       */
-            *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWLOW(hLcdIf);
                                         /* Clear RS pin                       */
-            *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
+            LCDIF_RSLOW(hLcdIf);
                                         /* Write data to pins                 */
-            *hLcdIf->pbIfObject->DATA_LAT = instruction;
+            LCDIF_PUTBYTE(hLcdIf, instruction);
                                         /* Set data pins to outputs           */
-            *hLcdIf->pbIfObject->DATA_TRIS = 0;
+            LCDIF_DATAOUT(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Write instruction process finished */
         }    
                                         /* Inform caller that write succeeded */
@@ -1118,7 +955,8 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
     unsigned char tempAddress = 0;
     unsigned char tempAddress2 = 0;
                                         /* Check if we own the peripheral bus */
-    if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
+                                        /* and are not broadcasting           */
+    if ((hLcdIf->lcdIfFlags & (LCDIF_OWNPB | LCDIF_BROADCAST)) == LCDIF_OWNPB)
     {   
                                         /* If it is a 4-bit bus, use a 4-bit  */
                                         /* access                             */
@@ -1129,21 +967,21 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
                                         /* datasheets                         */
                                         
                                         /* Set RW pin                         */
-            *hLcdIf->pbIfObject->RW_LAT |= hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWHIGH(hLcdIf);
                                         /* Clear RS pin                       */
-            *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
+            LCDIF_RSLOW(hLcdIf);
                                         /* Set data pins to inputs            */
-            *hLcdIf->pbIfObject->DATA_TRIS |= hLcdIf->pbIfObject->DATA_MASK;
+            LCDIF_DATAIN(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Read high nibble of address and    */
                                         /* shift into low four bytes of       */
                                         /* tempAddress                        */
             tempAddress = (*hLcdIf->pbIfObject->DATA_PORT & 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempAddress >>= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
+            tempAddress >>= hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK;
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Check to see if nibbles need to be */
                                         /* swapped                            */
             if (!(hLcdIf->lcdIfFlags & LCDIF_FIXNIBBLESWAP))
@@ -1153,14 +991,14 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
                 tempAddress <<= 4;
             }
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Read low nibble of data and add    */
                                         /* into low four bytes of tempAddress */
             tempAddress2 = (*hLcdIf->pbIfObject->DATA_PORT & 
                                                 hLcdIf->pbIfObject->DATA_MASK);
-            tempAddress2 >>= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
+            tempAddress2 >>= hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK;
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
             if (!(hLcdIf->lcdIfFlags & LCDIF_FIXNIBBLESWAP))
             {
                                         /* Formulate whole address            */
@@ -1186,17 +1024,17 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
                                         /* datasheets                         */
                                         
                                         /* Set RW pin                         */
-            *hLcdIf->pbIfObject->RW_LAT |= hLcdIf->pbIfObject->RW_BIT;
+            LCDIF_RWHIGH(hLcdIf);
                                         /* Clear RS pin                       */
-            *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
+            LCDIF_RSLOW(hLcdIf);
                                         /* Set data pins to inputs            */
-            *hLcdIf->pbIfObject->DATA_TRIS = 0xFF;
+            LCDIF_DATAIN(hLcdIf);
                                         /* Set E pin                          */
-            *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_EHIGH(hLcdIf);
                                         /* Read data                          */
             tempAddress = *hLcdIf->pbIfObject->DATA_PORT;
                                         /* Clear E pin                        */
-            *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+            LCDIF_ELOW(hLcdIf);
                                         /* Return address to caller           */
             *address = tempAddress;
                                         /* Read data process finished         */
@@ -1209,30 +1047,22 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
 }
 
 /*******************************************************************************
-* lcdif4BitFunctionSet()
+* lcdifWriteDataBlock()
 *
 * Summary: 
-*   Writes a 4-bit instruction to the LCD interface. This is required as part
-*   of the software initialisation sequence. In the event that the hardware 
-*   power-on reset doesn't reset the chipset, a "software initialisation" is 
-*   required. All researched chipsets (Hitachi, Sitronix and Samsung), when 
-*   using a 4-bit data bus, require that the first bus access after power on be
-*   a function set instruction but only passing the high nibble. Depending on
-*   the data sheet you read, the DL (data length) bit may need to be 1 or 0
-*   *even though* the bus is only 4-bits wide.
-*   Subsequent accesses to the bus are then performed in two seperate nibble
-*   accesses as normal in 4-bit bus mode.
+*   Writes a block of data to the LCD interface. RW and RS are set up once
+*   and the data pins made outputs once for the whole block
 *
 * See also:
-*   None
+*   lcdifWriteData(), lcdifWriteInstructionBlock()
 *
 * Arguments: 
 *   hLcdIf          - handle to the open LCD interface
-*   instruction     - nibble instruction to write to the LCD interface
-*                     !NOTE! The value here expected is either 0x02 or 0x03.
-*                     Check the datasheet for the chipset used on your display
-*                     to find out what value to use here. Look for the heading
-*                     "Initialising by instruction - 4-bit interface mode".
+*   data            - data to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
 *
 * Returns: 
 *   - LCDIF_BUSY    - if the LCD parallel bus is in use
@@ -1244,10 +1074,224 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
 * Notes : 
 * 1. Caller must have 'created' at least one LCD interface object before
 *    calling this function
-* 2. In this function, no assumptions are made about the state of the pins. The 
-*    functions use the pins as desired and then leave them in that state. For 
-*    this write function that also means that the PORT pins being used for data 
-*    output are left as outputs. The only rule is to leave the ENABLE pin low 
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteDataBlock(HLCDIF const hLcdIf,
+                                  const unsigned char * data,
+                                  unsigned char length,
+                                  unsigned int (*pGetMicroseconds)(void),
+                                  unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {   
+                                        /* Clear RW pin                       */
+        LCDIF_RWLOW(hLcdIf);
+                                        /* Set RS pin                         */
+        LCDIF_RSHIGH(hLcdIf);
+        writeLcdIfBlock(hLcdIf, data, length, pGetMicroseconds, interval);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;       
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;    
+}
+
+/*******************************************************************************
+* lcdifWriteInstructionBlock()
+*
+* Summary: 
+*   Writes a block of instructions to the LCD interface. RW and RS are set up
+*   once and the data pins made outputs once for the whole block
+*
+* See also:
+*   lcdifWriteInstruction(), lcdifWriteDataBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instructions to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                         const unsigned char * instruction,
+                                         unsigned char length,
+                                         unsigned int (*pGetMicroseconds)(void),
+                                         unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {   
+                                        /* Clear RW pin                       */
+        LCDIF_RWLOW(hLcdIf);
+                                        /* Clear RS pin                       */
+        LCDIF_RSLOW(hLcdIf);
+        writeLcdIfBlock(hLcdIf, instruction, length, pGetMicroseconds,
+                        interval);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;       
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;    
+}
+
+/*******************************************************************************
+* lcdifReadDataBlock()
+*
+* Summary: 
+*   Reads a block of data from the LCD interface. RW and RS are set up once
+*   and the data pins made inputs once for the whole block
+*
+* See also:
+*   lcdifReadData(), lcdifWriteDataBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   data            - place to store the data read
+*   length          - number of bytes to read
+*   pGetMicroseconds - time source used to pace the reads, or NULL to read
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use or the interface
+*                     broadcasts to several displays
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifReadDataBlock(HLCDIF const hLcdIf,
+                                 unsigned char * data,
+                                 unsigned char length,
+                                 unsigned int (*pGetMicroseconds)(void),
+                                 unsigned int interval)
+{
+    unsigned char tempData;
+    unsigned int lastReadTime;
+                                        /* Check if we own the peripheral bus */
+                                        /* and are not broadcasting           */
+    if ((hLcdIf->lcdIfFlags & (LCDIF_OWNPB | LCDIF_BROADCAST)) == LCDIF_OWNPB)
+    {   
+                                        /* Set RW pin                         */
+        LCDIF_RWHIGH(hLcdIf);
+                                        /* Set RS pin                         */
+        LCDIF_RSHIGH(hLcdIf);
+                                        /* Set data pins to inputs            */
+        LCDIF_DATAIN(hLcdIf);
+
+        while (length)
+        {
+            if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+            {
+                                        /* Read high nibble of data           */
+                LCDIF_EHIGH(hLcdIf);
+                tempData = (*hLcdIf->pbIfObject->DATA_PORT &
+                                                hLcdIf->pbIfObject->DATA_MASK)
+                           >> (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK);
+                LCDIF_ELOW(hLcdIf);
+                                        /* Then the low nibble                */
+                LCDIF_EHIGH(hLcdIf);
+                *data = (unsigned char) ((tempData << 4) +
+                        ((*hLcdIf->pbIfObject->DATA_PORT &
+                                                hLcdIf->pbIfObject->DATA_MASK)
+                         >> (hLcdIf->lcdIfFlags & LCDIF_SHIFTDATAMASK)));
+                LCDIF_ELOW(hLcdIf);
+            }
+            else
+            {
+                                        /* Set E pin and read the data        */
+                LCDIF_EHIGH(hLcdIf);
+                *data = *hLcdIf->pbIfObject->DATA_PORT;
+                                        /* Clear E pin                        */
+                LCDIF_ELOW(hLcdIf);
+            }
+            data++;
+            length--;
+                                        /* Give the LCD controller time to    */
+                                        /* move its address counter on        */
+            if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+            {
+                lastReadTime = pGetMicroseconds();
+                while ((unsigned int) (pGetMicroseconds() - lastReadTime) <=
+                                                                    interval)
+                {
+                    ;
+                }
+            }
+        }
+                                        /* Inform caller that read succeeded  */
+        return LCDIF_SUCCESS;       
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;    
+}
+
+/*******************************************************************************
+* lcdif4BitFunctionSet()
+*
+* Summary: 
+*   Writes a 4-bit instruction to the LCD interface. This is required as part
+*   of the software initialisation sequence. In the event that the hardware 
+*   power-on reset doesn't reset the chipset, a "software initialisation" is 
+*   required. All researched chipsets (Hitachi, Sitronix and Samsung), when 
+*   using a 4-bit data bus, require that the first bus access after power on be
+*   a function set instruction but only passing the high nibble. Depending on
+*   the data sheet you read, the DL (data length) bit may need to be 1 or 0
+*   *even though* the bus is only 4-bits wide.
+*   Subsequent accesses to the bus are then performed in two seperate nibble
+*   accesses as normal in 4-bit bus mode.
+*
+* See also:
+*   None
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - nibble instruction to write to the LCD interface
+*                     !NOTE! The value here expected is either 0x02 or 0x03.
+*                     Check the datasheet for the chipset used on your display
+*                     to find out what value to use here. Look for the heading
+*                     "Initialising by instruction - 4-bit interface mode".
+*
+* Returns: 
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers: 
+*   User application
+*
+* Notes : 
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. In this function, no assumptions are made about the state of the pins. The 
+*    functions use the pins as desired and then leave them in that state. For 
+*    this write function that also means that the PORT pins being used for data 
+*    output are left as outputs. The only rule is to leave the ENABLE pin low 
 *    when finished.
 * 3. This function is only required when using 4-bit bus mode. *Do not* use this
 *    function in 8-bit bus mode.
@@ -1256,34 +1300,26 @@ unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
 unsigned char lcdif4BitFunctionSet(HLCDIF const hLcdIf, 
                                   unsigned char instruction)
 {
-    unsigned char tempInstruction;
                                         /* Check if we own the peripheral bus */
-    if (hLcdIf->lcdIfFlags && LCDIF_OWNPB)
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
     {   
                                         /* The following is a single nibble   */
                                         /* write as required for initialising */
                                         /* the display in 4-bit bus mode      */
                                         
                                         /* Clear RW pin                       */
-        *hLcdIf->pbIfObject->RW_LAT &= ~hLcdIf->pbIfObject->RW_BIT;
+        LCDIF_RWLOW(hLcdIf);
                                         /* Clear RS pin                       */
-        *hLcdIf->pbIfObject->RS_LAT &= ~hLcdIf->pbIfObject->RS_BIT;
-                                        /* Make copy of low nibble of         */
-                                        /* instruction                        */
-        tempInstruction = instruction & 0x0F;
-                                        /* Get data in correct position for   */
-                                        /* 4-bit bus                          */
-        tempInstruction <<= startOfLcdIfObjs->lcdIfFlags & LCDIF_SHIFTDATAMASK;
-                                        /* Clear data pins                    */
-        *hLcdIf->pbIfObject->DATA_LAT &= ~hLcdIf->pbIfObject->DATA_MASK;
-                                        /* Set desired data pins              */
-        *hLcdIf->pbIfObject->DATA_LAT |= tempInstruction;
+        LCDIF_RSLOW(hLcdIf);
+                                        /* Put low nibble of instruction on   */
+                                        /* the data pins in one write         */
+        LCDIF_PUTNIBBLE(hLcdIf, instruction & 0x0F);
                                         /* Set data pins to outputs           */
-        *hLcdIf->pbIfObject->DATA_TRIS &= ~hLcdIf->pbIfObject->DATA_MASK;
+        LCDIF_DATAOUT(hLcdIf);
                                         /* Set E pin                          */
-        *hLcdIf->pbIfLcdEnObject->E_LAT |= hLcdIf->pbIfLcdEnObject->E_BIT;
+        LCDIF_EHIGH(hLcdIf);
                                         /* Clear E pin                        */
-        *hLcdIf->pbIfLcdEnObject->E_LAT &= ~hLcdIf->pbIfLcdEnObject->E_BIT;
+        LCDIF_ELOW(hLcdIf);
                                         /* Write instruction process finished */
 
                                         /* Inform caller that write succeeded */
@@ -1367,6 +1403,502 @@ void lcdifFixNibbleSwap(HLCDIF const hLcdIf)
 {
     hLcdIf->lcdIfFlags |= LCDIF_FIXNIBBLESWAP;
 }
+
+/*******************************************************************************
+* pbifGetBusMutex() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Takes the parallel bus mutex if it is free, without waiting. This function
+* is private to the LCDIFC32 module.
+*
+* See also:
+*   pbifReturnBusMutex()
+*
+* Arguments: 
+*   mutex           - the mutex in the parallel bus interface object
+*
+* Returns: 
+*   - 1             - if we got the mutex
+*   - 0             - if the mutex is held by someone else
+*
+* Callers: 
+*   lcdifGetPb()
+*
+* Notes : 
+* 1. On the PIC32 this is an LL/SC loop. An interrupt between the LL and the
+*    SC clears the link bit, so the SC fails and the mutex is read again; the
+*    loop only repeats if an interrupt hit that two instruction window
+* 2. The M4K core doesn't reorder loads and stores, so no SYNC is needed; the
+*    memory clobber stops the compiler moving bus accesses out of the lock
+* 3. On a host PC the same try-lock is made with the compiler's C11 style
+*    atomic exchange, with acquire ordering
+*******************************************************************************/
+static unsigned char pbifGetBusMutex(volatile unsigned int * mutex)
+{
+    unsigned int previous;              /* Mutex value before we took it      */
+#if defined(__mips__)
+    unsigned int busy;                  /* Value stored, then SC's result     */
+
+    __asm__ __volatile__(
+        "   .set    push            \n"
+        "   .set    noreorder       \n"
+        "1: ll      %0, %2          \n"
+        "   bnez    %0, 2f          \n"
+        "   li      %1, %3          \n"
+        "   sc      %1, %2          \n"
+        "   beqz    %1, 1b          \n"
+        "   nop                     \n"
+        "2:                         \n"
+        "   .set    pop             \n"
+        : "=&r" (previous), "=&r" (busy), "+m" (*mutex)
+        : "i" (PBIF_BUSY)
+        : "memory");
+#else
+    previous = __atomic_exchange_n(mutex, PBIF_BUSY, __ATOMIC_ACQUIRE);
+#endif
+
+    return previous == PBIF_NOT_BUSY;
+}
+
+/*******************************************************************************
+* pbifReturnBusMutex() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Returns the parallel bus mutex taken with pbifGetBusMutex(). This function
+* is private to the LCDIFC32 module.
+*
+* See also:
+*   pbifGetBusMutex()
+*
+* Arguments: 
+*   mutex           - the mutex in the parallel bus interface object
+*
+* Returns: 
+*   void
+*
+* Callers: 
+*   lcdifReturnPb()
+*
+* Notes : 
+* 1. A plain store is atomic; all the bus accesses made while holding the
+*    mutex are kept before it
+*******************************************************************************/
+static void pbifReturnBusMutex(volatile unsigned int * mutex)
+{
+#if defined(__mips__)
+    __asm__ __volatile__("" : : : "memory");
+    *mutex = PBIF_NOT_BUSY;
+#else
+    __atomic_store_n(mutex, PBIF_NOT_BUSY, __ATOMIC_RELEASE);
+#endif
+}
+
+#if PBIF_MUTEXSTATS
+/*******************************************************************************
+* pbifAtomicIncrement() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Adds one to a counter that several tasks or interrupt levels may add to at
+* once. This function is private to the LCDIFC32 module.
+*
+* See also:
+*   pbifGetBusMutex()
+*
+* Arguments: 
+*   counter         - the counter
+*
+* Returns: 
+*   void
+*
+* Callers: 
+*   lcdifGetPb()
+*
+* Notes : 
+*   None
+*******************************************************************************/
+static void pbifAtomicIncrement(volatile unsigned int * counter)
+{
+#if defined(__mips__)
+    unsigned int value;                 /* New value, then SC's result        */
+
+    __asm__ __volatile__(
+        "   .set    push            \n"
+        "   .set    noreorder       \n"
+        "1: ll      %0, %1          \n"
+        "   addiu   %0, %0, 1       \n"
+        "   sc      %0, %1          \n"
+        "   beqz    %0, 1b          \n"
+        "   nop                     \n"
+        "   .set    pop             \n"
+        : "=&r" (value), "+m" (*counter)
+        :
+        : "memory");
+#else
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+#endif
+}
+#endif
+
+/*******************************************************************************
+* createLcdIf() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Checks an LCD interface object and enters it in the slot table
+*
+* See also:
+*   findFreeLcdIfSlot()
+*
+* Arguments: 
+*   lcdIfObj    - lcdif object to enter in the slot table
+*   broadcast   - 1 to allow several E_BIT bits and make the interface
+*                 write-only, otherwise 0
+*
+* Returns: 
+*   - 1 to LCDIF_MAXOBJECTS
+*                       - number the LCD interface has been assigned
+*   - 0		            - if the LCD interface allocation failed
+*
+* Callers: 
+*   lcdifCreate(), lcdifCreateBroadcast()
+*
+* Notes : 
+*   None
+*******************************************************************************/
+static LCDIFNUM createLcdIf(LCDIFOBJ * const lcdIfObj,
+                            unsigned char broadcast)
+{
+    unsigned int slot;                  /* Slot allocated to this object      */
+    unsigned short bitTest;
+    unsigned short bitCount;
+                                        /* Used to note bus width             */
+    unsigned short busWidth = 0;
+                                        /* Used to note how many bits to      */
+                                        /* shift bus data                     */
+    unsigned short busDataShift = 0;
+                                        /* Check we got an object to point to */
+    if(lcdIfObj != (LCDIFOBJ *) 0)
+    {
+                                        /* Check that there is some useful    */
+                                        /* information in the object that was */
+                                        /* passed                             */
+                                        /* First, do we have a E_LAT?       */
+        if (lcdIfObj->pbIfLcdEnObject->E_LAT == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Do we have only one E_BIT, or at   */
+                                        /* least one for a broadcast?         */
+        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
+        {
+            if (lcdIfObj->pbIfLcdEnObject->E_BIT & bitTest)
+            {
+                bitCount++;
+            }    
+        }
+        if (bitCount == 0 || (bitCount != 1 && !broadcast))
+        {
+            goto cannot_create_if;
+        }    
+                                        /* Do we have a PBIFOBJ object?       */
+        if (lcdIfObj->pbIfObject == (PBIFOBJ *) 0)
+        {
+            goto cannot_create_if;
+        }    
+                                        /* Do we have anything in the         */
+                                        /* PBIFOBJ object?                    */
+                                        /* Do we have only one RW_BIT?        */
+        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
+        {
+            if (lcdIfObj->pbIfObject->RW_BIT & bitTest)
+            {
+                bitCount++;
+            }    
+        }
+        if (bitCount != 1)
+        {
+            goto cannot_create_if;
+        }    
+                                        /* Do we have only one RS_BIT?        */
+        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
+        {
+            if (lcdIfObj->pbIfObject->RW_BIT & bitTest)
+            {
+                bitCount++;
+            }    
+        }
+        if (bitCount != 1)
+        {
+            goto cannot_create_if;
+        }    
+                                        /* Do we have only four or eight      */
+                                        /* DATA_MASK bits                     */
+        for (bitTest = 0x01, bitCount = 0; bitTest != 0x00; bitTest <<= 1)
+        {
+            if (lcdIfObj->pbIfObject->DATA_MASK & bitTest)
+            {
+                bitCount++;
+            }    
+        }
+        if (bitCount == 4)
+        {
+            busWidth = bitCount;
+                                        /* Calculate number of bits to shift  */
+                                        /* data for 4-bit bus                 */
+            for (bitTest = 0x01, busDataShift = 0; bitTest != 0x00; 
+                                                        bitTest <<= 1)
+            {
+                if (!(lcdIfObj->pbIfObject->DATA_MASK & bitTest))
+                {
+                    busDataShift++;
+                }
+                else
+                {
+                    break;
+                }    
+            }    
+        }    
+        else if (bitCount == 8)
+        {
+            busWidth = bitCount;
+        }    
+        else
+        {
+            goto cannot_create_if;
+        }    
+                                        /* Do we have a RW_LAT?              */
+        if (lcdIfObj->pbIfObject->RW_LAT == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Do we have a RS_LAT?              */
+        if (lcdIfObj->pbIfObject->RS_LAT == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Do we have a DATA_PORT?            */
+        if (lcdIfObj->pbIfObject->DATA_PORT == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Do we have a DATA_LAT?             */
+        if (lcdIfObj->pbIfObject->DATA_LAT == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Do we have a DATA_TRIS?            */
+        if (lcdIfObj->pbIfObject->DATA_TRIS == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+#if LCDIF_ATOMICPINS
+                                        /* Do we have the SET, CLR and INV    */
+                                        /* registers for every pin?           */
+        if (lcdIfObj->pbIfLcdEnObject->E_LATSET == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfLcdEnObject->E_LATCLR == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->RW_LATSET == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->RW_LATCLR == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->RS_LATSET == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->RS_LATCLR == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->DATA_LATINV == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->DATA_TRISSET == (REGISTER_DATA_TYPE *) 0 ||
+            lcdIfObj->pbIfObject->DATA_TRISCLR == (REGISTER_DATA_TYPE *) 0)
+        {
+            goto cannot_create_if;
+        }
+#endif
+                                        /* If we got here the object contains */
+                                        /* valid data we can work with        */
+
+                                        /* Work out the data pin mask and, in */
+                                        /* 4-bit mode, the value to put on    */
+                                        /* the data pins for each nibble      */
+        lcdIfObj->dataClearMask = ~lcdIfObj->pbIfObject->DATA_MASK;
+#if LCDIF_NIBBLETABLE
+        if (busWidth == 4)
+        {
+            for (bitTest = 0; bitTest < 16; bitTest++)
+            {
+                lcdIfObj->nibbleToPort[bitTest] = bitTest << busDataShift;
+            }
+        }
+#endif
+
+                                        /* Find a free slot, if we haven't    */
+                                        /* allocated all the LCD interface    */
+                                        /* objects we can support             */
+        slot = findFreeLcdIfSlot();
+        if (slot >= LCDIF_MAXOBJECTS)
+        {
+            goto cannot_create_if;
+        }
+        activeLcdIfObjects[slot / 32] |= 1u << (slot % 32);
+        lcdIfSlots[slot] = lcdIfObj;
+                                        /* Assign the interface number        */
+        lcdIfObj->lcdIfNum = slot + 1;
+                                        /* Clear the object's flags           */
+        lcdIfObj->lcdIfFlags = 0;
+                                        /* Note parallel bus width - if it is */
+                                        /* not 4 it must be 8                 */
+                                        /* Also note amount to shift data to  */
+                                        /* use on the bus                     */
+        if (busWidth == 4)
+        {
+            lcdIfObj->lcdIfFlags |= LCDIF_PBWIDTH4BITS;
+            lcdIfObj->lcdIfFlags |= (busDataShift & LCDIF_SHIFTDATAMASK);
+        }
+        if (broadcast)
+        {
+            lcdIfObj->lcdIfFlags |= LCDIF_BROADCAST;
+        }
+                                        /* Note that the parallel bus is not  */
+                                        /* in use                             */
+        lcdIfObj->pbIfObject->mutex = PBIF_NOT_BUSY;
+#if PBIF_MUTEXSTATS
+        lcdIfObj->pbIfObject->mutexOwner = (void *) 0;
+        lcdIfObj->pbIfObject->mutexTaken = 0;
+        lcdIfObj->pbIfObject->mutexContended = 0;
+#endif
+            
+        return lcdIfObj->lcdIfNum;
+    }
+cannot_create_if:
+                                        /* Couldn't create interface          */
+    return 0;
+}
+
+/*******************************************************************************
+* findFreeLcdIfSlot() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Finds the lowest free slot in the LCD interface slot table. This function
+* is private to the LCDIFC32 module.
+*
+* See also:
+*   None
+*
+* Arguments: 
+*   None
+*
+* Returns: 
+*   - 0 to LCDIF_MAXOBJECTS - 1
+*                   - lowest free slot
+*   - LCDIF_MAXOBJECTS
+*                   - all slots are in use
+*
+* Callers: 
+*   createLcdIf()
+*
+* Notes : 
+* 1. Uses the CLZ instruction, so up to 32 objects a free slot is found
+*    without any loop
+*******************************************************************************/
+static unsigned int findFreeLcdIfSlot(void)
+{
+    unsigned int word;                  /* Bitmap word being checked          */
+    unsigned int slot;                  /* Free slot found                    */
+    unsigned int freeSlots;             /* Set bits mark free slots           */
+
+    for (word = 0; word < LCDIF_SLOTWORDS; word++)
+    {
+        freeSlots = ~activeLcdIfObjects[word];
+        if (freeSlots != 0)
+        {
+                                        /* Isolate the lowest free slot's bit */
+                                        /* and count the zeros above it       */
+            slot = 31 - __builtin_clz(freeSlots & (0 - freeSlots));
+            slot += word * 32;
+                                        /* The last word may have bits beyond */
+                                        /* the end of the table               */
+            if (slot < LCDIF_MAXOBJECTS)
+            {
+                return slot;
+            }
+            break;
+        }
+    }
+
+    return LCDIF_MAXOBJECTS;
+}
+
+/*******************************************************************************
+* writeLcdIfBlock() --PRIVATE FUNCTION--
+*
+* Summary: 
+*   Makes the data pins outputs and strobes a block of bytes onto them, pacing
+*   them with the time source given. This function is private to the
+*   LCDIFC32 module.
+*
+* See also:
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Arguments: 
+*   hLcdIf          - handle to the open LCD interface
+*   data            - bytes to write
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source, or NULL
+*   interval        - microseconds to leave between each byte
+*
+* Returns: 
+*   None
+*
+* Callers: 
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Notes : 
+* 1. RW and RS must already be set up by the caller
+* 2. In 4-bit mode each nibble is put on the data pins with a single store,
+*    using the object's nibble table if there is one
+* 3. The wait is for more than interval, covering the time source's resolution
+*******************************************************************************/
+static void writeLcdIfBlock(HLCDIF const hLcdIf, const unsigned char * data,
+                            unsigned char length,
+                            unsigned int (*pGetMicroseconds)(void),
+                            unsigned int interval)
+{
+    unsigned int lastWriteTime;
+                                        /* Set data pins to outputs           */
+    LCDIF_DATAOUT(hLcdIf);
+
+    while (length)
+    {
+        if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+        {
+                                        /* Put high nibble on the data pins   */
+                                        /* in one write                       */
+            LCDIF_PUTNIBBLE(hLcdIf, *data >> 4);
+                                        /* Set E pin                          */
+            LCDIF_EHIGH(hLcdIf);
+                                        /* Clear E pin                        */
+            LCDIF_ELOW(hLcdIf);
+                                        /* Same for the low nibble            */
+            LCDIF_PUTNIBBLE(hLcdIf, *data & 0x0F);
+            LCDIF_EHIGH(hLcdIf);
+            LCDIF_ELOW(hLcdIf);
+        }
+        else
+        {
+                                        /* Write data to pins                 */
+            LCDIF_PUTBYTE(hLcdIf, *data);
+                                        /* Set E pin                          */
+            LCDIF_EHIGH(hLcdIf);
+                                        /* Clear E pin                        */
+            LCDIF_ELOW(hLcdIf);
+        }
+        data++;
+        length--;
+                                        /* Give the LCD controller time to    */
+                                        /* execute before the next byte       */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            lastWriteTime = pGetMicroseconds();
+            while ((unsigned int) (pGetMicroseconds() - lastWriteTime) <=
+                                                                    interval)
+            {
+                ;
+            }
+        }
+    }
+}
    
  
 /*******************************************************************************
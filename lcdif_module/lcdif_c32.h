@@ -61,6 +61,36 @@
 *                             DEFAULT CONFIGURATION
 *******************************************************************************/
 
+/*******************************************************************************
+* Summary:
+*   Maximum number of LCD interface objects that can be created at the same
+* time. Define it on the compiler command line to use a different capacity
+*******************************************************************************/
+#ifndef LCDIF_MAXOBJECTS
+#define LCDIF_MAXOBJECTS    16
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Set to 1 to give each LCD interface object a 16 entry table that turns a
+* nibble straight into the value for its data pins in 4-bit bus mode, so that
+* no shift is needed per nibble written. Set to 0 to save the RAM
+*******************************************************************************/
+#ifndef LCDIF_NIBBLETABLE
+#define LCDIF_NIBBLETABLE   1
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Set to 1 to drive every pin through the SET, CLR and INV registers given in
+* the PBIFOBJ and PBIFLCDENOBJ objects instead of by read-modify-write of LAT
+* and TRIS. Each pin change is then a single store that cannot corrupt other
+* pins on the same port written from an interrupt
+*******************************************************************************/
+#ifndef LCDIF_ATOMICPINS
+#define LCDIF_ATOMICPINS    0
+#endif
+
 
 /*******************************************************************************
 *                                    DEFINES
@@ -89,14 +119,19 @@ typedef unsigned int LCDIFNUM;
 /*******************************************************************************
 * New data type LCDIFOBJTYPE                                                     
 * Description:
-*   Holds the object information for each LCD interface object created
+*   Holds the object information for each LCD interface object created. The
+* user fills in the pin information; dataClearMask and nibbleToPort are worked
+* out from it by lcdifCreate()
 *******************************************************************************/
 typedef struct LCDIFOBJTYPE {
     PBIFLCDENOBJ                  * pbIfLcdEnObject;
     PBIFOBJ                       * pbIfObject;
     LCDIFNUM                        lcdIfNum;
     unsigned char                   lcdIfFlags;
-    struct LCDIFOBJTYPE           * nextLcdIfObj;
+    unsigned int                    dataClearMask;
+#if LCDIF_NIBBLETABLE
+    unsigned int                    nibbleToPort[16];
+#endif
 } LCDIFOBJ;
 
 /*******************************************************************************
@@ -124,6 +159,7 @@ void            lcdifInit(void);
 void            lcdifDeinit(void);
 
 LCDIFNUM        lcdifCreate(LCDIFOBJ            * const lcdIfObj);
+LCDIFNUM        lcdifCreateBroadcast(LCDIFOBJ   * const lcdIfObj);
 unsigned char   lcdifDestroy(LCDIFNUM                   lcdIfNumber);
 
 HLCDIF          lcdifOpen(LCDIFNUM                      lcdIfNumber);
@@ -142,6 +178,22 @@ unsigned char   lcdifWriteInstruction(HLCDIF      const hLcdIf,
 unsigned char   lcdifReadAddress(HLCDIF           const hLcdIf,
                                  unsigned char  * const address);
 
+unsigned char   lcdifWriteDataBlock(HLCDIF        const hLcdIf,
+                                    const unsigned char * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                    const unsigned char * instruction,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifReadDataBlock(HLCDIF         const hLcdIf,
+                                    unsigned char     * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+
 unsigned char   lcdif4BitFunctionSet(HLCDIF       const hLcdIf,
                                       unsigned char     instruction);
 
@@ -152,7 +204,9 @@ void            lcdifFixNibbleSwap(HLCDIF         const hLcdIf);
 /*******************************************************************************
 *                              CONFIGURATION ERRORS
 *******************************************************************************/
-
+#if LCDIF_MAXOBJECTS < 1
+#error LCDIF_MAXOBJECTS must be at least 1
+#endif
 
 /*******************************************************************************
 *
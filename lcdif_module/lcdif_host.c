@@ -0,0 +1,1075 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR HOST PC SIMULATION
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module is used to provide the interface for an HD44780 LCD display on a
+* host PC. Every access is passed on, one E strobe at a time, to the simulated
+* controller connected to the interface object, and the simulated clock is
+* moved forward by one E cycle per strobe. This allows the HD44780 module to be
+* run unmodified on a PC and the bus time used by each of its API calls to be
+* measured.
+*
+* Filename : lcdif_host.c
+*
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                               LCDIFHOST MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "lcdif_host.h"
+
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the LCD interface object is open and in use
+*******************************************************************************/
+#define LCDIF_OPEN          (0x01 << 7)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate the parallel bus width is 4 bits
+*******************************************************************************/
+#define LCDIF_PBWIDTH4BITS  (0x01 << 6)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD interface currently owns the peripheral bus
+*******************************************************************************/
+#define LCDIF_OWNPB         (0x01 << 5)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD module swaps the high/low nibble in 4-bit bus
+* mode when reading, and the driver should correct this
+*******************************************************************************/
+#define LCDIF_FIXNIBBLESWAP (0x01 << 4)
+
+/*******************************************************************************
+* Summary:
+* Number of 32-bit words in the activeLcdIfObjects bitmap
+*******************************************************************************/
+#define LCDIF_SLOTWORDS     ((LCDIF_MAXOBJECTS + 31) / 32)
+
+/*******************************************************************************
+* Summary:
+* Used to indicate that the LCD interface is in use from another task
+*******************************************************************************/
+#define LCDIF_BUSY          0
+
+/*******************************************************************************
+* Summary:
+* Used to indicate that the LCD interface call was successful
+*******************************************************************************/
+#define LCDIF_SUCCESS       1
+
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+* Local table of LCD interface objects, indexed by interface number minus one
+*******************************************************************************/
+static LCDIFOBJ * lcdIfSlots[LCDIF_MAXOBJECTS];
+
+/*******************************************************************************
+* Summary:
+* Used to note which LCD interface objects are active. Each bit in this bitmap
+* relates to one slot of lcdIfSlots.
+*******************************************************************************/
+static unsigned int activeLcdIfObjects[LCDIF_SLOTWORDS];
+
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+
+static unsigned int     findFreeLcdIfSlot(void);
+static void             writeStrobe(HLCDIF const hLcdIf, unsigned char rs,
+                                    unsigned char dataLines);
+static unsigned char    readStrobe(HLCDIF const hLcdIf, unsigned char rs);
+static unsigned char    readByte(HLCDIF const hLcdIf, unsigned char rs);
+static void             writeBlock(HLCDIF const hLcdIf, unsigned char rs,
+                                   const unsigned char * data,
+                                   unsigned char length,
+                                   unsigned int (*pGetMicroseconds)(void),
+                                   unsigned int interval);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* lcdifInit()
+*
+* Summary:
+*   Initialises the LCDIFHOST module for first use
+*
+* See also:
+*   lcdifDeinit()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   None
+*******************************************************************************/
+void lcdifInit(void)
+{
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
+                                        /* Currently no active LCDIF objects  */
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
+}
+
+/*******************************************************************************
+* lcdifDeinit()
+*
+* Summary:
+*   Deinitialises the LCDIFHOST module after use
+*
+* See also:
+*   lcdifInit()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   None
+*******************************************************************************/
+void lcdifDeinit(void)
+{
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
+                                        /* Currently no active LCDIF objects  */
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
+}
+
+/*******************************************************************************
+* lcdifCreate()
+*
+* Summary:
+*   Creates an LCD interface for use by this module
+*
+* See also:
+*   lcdifDestroy()
+*
+* Arguments:
+*   lcdIfObj    - lcdif object to enter in the slot table
+*
+* Returns:
+*   - 1 to LCDIF_MAXOBJECTS
+*                       - number the LCD interface has been assigned if it was
+*                         possible to allocate it
+*   - 0                 - if the LCD interface allocation failed
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   1. lcdifInit() must have been called prior to calling this function
+*   2. The number assigned is the object's slot in the slot table plus one,
+*      and is always the lowest one free
+*******************************************************************************/
+LCDIFNUM lcdifCreate(LCDIFOBJ * const lcdIfObj)
+{
+    unsigned int slot;                  /* Slot allocated to this object      */
+
+                                        /* Check we got an object that is     */
+                                        /* connected to a simulated display   */
+                                        /* with a valid bus width             */
+    if (lcdIfObj == (LCDIFOBJ *) 0 ||
+        lcdIfObj->hd44780Sim == (HD44780SIM *) 0 ||
+        (lcdIfObj->busWidth != BUS4BITSWIDE &&
+         lcdIfObj->busWidth != BUS8BITSWIDE))
+    {
+        return 0;
+    }
+                                        /* Find a free slot                   */
+    slot = findFreeLcdIfSlot();
+    if (slot >= LCDIF_MAXOBJECTS)
+    {
+                                        /* Couldn't create interface          */
+        return 0;
+    }
+    activeLcdIfObjects[slot / 32] |= 1u << (slot % 32);
+    lcdIfSlots[slot] = lcdIfObj;
+                                        /* Clear the object's flags and note  */
+                                        /* the bus width                      */
+    lcdIfObj->lcdIfFlags = 0;
+    if (lcdIfObj->busWidth == BUS4BITSWIDE)
+    {
+        lcdIfObj->lcdIfFlags |= LCDIF_PBWIDTH4BITS;
+    }
+                                        /* Assign the interface number        */
+    lcdIfObj->lcdIfNum = slot + 1;
+    return lcdIfObj->lcdIfNum;
+}
+
+/*******************************************************************************
+* lcdifDestroy()
+*
+* Summary:
+*   Destroys a previously created LCD interface object
+*
+* See also:
+*   lcdifCreate()
+*
+* Arguments:
+*   lcdIfNumber - number of the LCD interface object to destroy
+*
+* Returns:
+*   - 1   - LCD interface was successfully destroyed
+*   - 0   - couldn't detroy requested LCD interface - probably still open
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   1. lcdifCreate() must have been called prior to calling this function
+*******************************************************************************/
+unsigned char lcdifDestroy(LCDIFNUM lcdIfNumber)
+{
+    unsigned int slot;                  /* Slot holding the object            */
+
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
+    {
+        slot = lcdIfNumber - 1;
+                                        /* An open object can't be destroyed  */
+        if (lcdIfSlots[slot] != (LCDIFOBJ *) 0 &&
+            !(lcdIfSlots[slot]->lcdIfFlags & LCDIF_OPEN))
+        {
+                                        /* Empty the slot and note that we    */
+                                        /* have one less active LCD interface */
+            lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+            activeLcdIfObjects[slot / 32] &= ~(1u << (slot % 32));
+            return 1;
+        }
+    }
+                                        /* Couldn't destroy interface         */
+    return 0;
+}
+
+/*******************************************************************************
+* lcdifOpen()
+*
+* Summary:
+*   Opens an LCD interface for use by caller and initialises an HLCDIF
+*   handle to it
+*
+* See also:
+*   lcdifClose()
+*
+* Arguments:
+*   lcdIfNumber     - number of an existing LCD interface object to use
+*
+* Returns:
+*   - NULL          - if LCD interface couldn't be opened
+*   - handle        - if LCD interface was opened properly
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have created (lcdifCreate) at least one LCD interface object
+*    before calling this function
+*******************************************************************************/
+HLCDIF lcdifOpen(LCDIFNUM lcdIfNumber)
+{
+    LCDIFOBJ * localLcdIfObj;
+
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
+    {
+        localLcdIfObj = lcdIfSlots[lcdIfNumber - 1];
+                                        /* Check it exists and is not already */
+                                        /* open                               */
+        if (localLcdIfObj != (LCDIFOBJ *) 0 &&
+            !(localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
+        {
+                                        /* Note that it is now in use         */
+            localLcdIfObj->lcdIfFlags |= LCDIF_OPEN;
+            return localLcdIfObj;
+        }
+    }
+                                        /* Return handle to NULL otherwise    */
+    return (LCDIFOBJ *) 0;
+}
+
+/*******************************************************************************
+* lcdifClose()
+*
+* Summary:
+*   Closes an LCD interface and releases the handle to it
+*
+* See also:
+*   lcdifOpen()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - >0            - number of LCD interface object if it was was open
+*   - 0             - if the LCD interface was not open
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+LCDIFNUM lcdifClose(HLCDIF const hLcdIf)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OPEN)
+    {
+        hLcdIf->lcdIfFlags &= ~LCDIF_OPEN;
+        return hLcdIf->lcdIfNum;
+    }
+
+    return (LCDIFNUM) 0;
+}
+
+/*******************************************************************************
+* lcdifGetPb()
+*
+* Summary:
+*   Attempts to aquire the peripheral bus for use by the LCD interface module
+*
+* See also:
+*   lcdifReturnPb()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - 1             - this LCD interface (hLcdIf) owns the peripheral bus
+*   - 0             - the peripheral bus is currently in use by another task
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Each simulated interface has a bus of its own, so this always succeeds
+*******************************************************************************/
+unsigned char lcdifGetPb(HLCDIF const hLcdIf)
+{
+    hLcdIf->lcdIfFlags |= LCDIF_OWNPB;
+    return 1;
+}
+
+/*******************************************************************************
+* lcdifReturnPb()
+*
+* Summary:
+*   Returns the peripheral bus for use by other modules
+*
+* See also:
+*   lcdifGetPb()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers:
+*   User application
+*
+* Notes :
+*   None
+*******************************************************************************/
+void lcdifReturnPb(HLCDIF const hLcdIf)
+{
+    hLcdIf->lcdIfFlags &= ~LCDIF_OWNPB;
+}
+
+/*******************************************************************************
+* lcdifWriteData()
+*
+* Summary:
+*   Writes data to the LCD interface
+*
+* See also:
+*   lcdifReadData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+        {
+                                        /* High nibble then low nibble, both  */
+                                        /* on DB7 to DB4                      */
+            writeStrobe(hLcdIf, 1, data & 0xF0);
+            writeStrobe(hLcdIf, 1, (unsigned char) (data << 4));
+        }
+        else
+        {
+            writeStrobe(hLcdIf, 1, data);
+        }
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadData()
+*
+* Summary:
+*   Reads data from the LCD interface. The data read will be the contents of a
+*   CGRAM address if the previous instruction set a CGRAM address. If the
+*   previous instruction set a DDRAM address, the DDRAM address will be read
+*
+* See also:
+*   lcdifWriteData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   * data          - variable in which to store read data
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        *data = readByte(hLcdIf, 1);
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteInstruction()
+*
+* Summary:
+*   Writes an instruction to the LCD interface
+*
+* See also:
+*   lcdifReadAddress()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instruction to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf,
+                                    unsigned char instruction)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+        {
+            writeStrobe(hLcdIf, 0, instruction & 0xF0);
+            writeStrobe(hLcdIf, 0, (unsigned char) (instruction << 4));
+        }
+        else
+        {
+            writeStrobe(hLcdIf, 0, instruction);
+        }
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadAddress()
+*
+* Summary:
+*   Reads address counter value and busy flag
+*
+* See also:
+*   lcdifWriteData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   * address       - variable in which to store read address value
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
+                               unsigned char * const address)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        *address = readByte(hLcdIf, 0);
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteDataBlock()
+*
+* Summary:
+*   Writes a block of data to the LCD interface
+*
+* See also:
+*   lcdifWriteData(), lcdifWriteInstructionBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteDataBlock(HLCDIF const hLcdIf,
+                                  const unsigned char * data,
+                                  unsigned char length,
+                                  unsigned int (*pGetMicroseconds)(void),
+                                  unsigned int interval)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writeBlock(hLcdIf, 1, data, length, pGetMicroseconds, interval);
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteInstructionBlock()
+*
+* Summary:
+*   Writes a block of instructions to the LCD interface
+*
+* See also:
+*   lcdifWriteInstruction(), lcdifWriteDataBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instructions to write to the LCD interface
+*   length          - number of instructions to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each instruction
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                         const unsigned char * instruction,
+                                         unsigned char length,
+                                         unsigned int (*pGetMicroseconds)(void),
+                                         unsigned int interval)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writeBlock(hLcdIf, 0, instruction, length, pGetMicroseconds, interval);
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadDataBlock()
+*
+* Summary:
+*   Reads a block of data from the LCD interface
+*
+* See also:
+*   lcdifReadData(), lcdifWriteDataBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - place to store the data read
+*   length          - number of bytes to read
+*   pGetMicroseconds - time source used to pace the reads, or NULL to read
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. You must have called lcdifGetPb() successfully before calling this function
+* 2. The wait is for more than interval, covering the time source's resolution
+*******************************************************************************/
+unsigned char lcdifReadDataBlock(HLCDIF const hLcdIf,
+                                 unsigned char * data,
+                                 unsigned char length,
+                                 unsigned int (*pGetMicroseconds)(void),
+                                 unsigned int interval)
+{
+    unsigned int lastReadTime;
+
+    if (!(hLcdIf->lcdIfFlags & LCDIF_OWNPB))
+    {
+        return LCDIF_BUSY;
+    }
+
+    while (length)
+    {
+        *data = readByte(hLcdIf, 1);
+        data++;
+        length--;
+                                        /* Wait before the next byte          */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            lastReadTime = pGetMicroseconds();
+            while ((unsigned int) (pGetMicroseconds() - lastReadTime) <=
+                   interval)
+            {
+                ;
+            }
+        }
+    }
+
+    return LCDIF_SUCCESS;
+}
+
+/*******************************************************************************
+* lcdif4BitFunctionSet()
+*
+* Summary:
+*   Writes a single nibble instruction to the LCD interface as required by the
+*   "Initialising by Instruction" sequence in 4-bit bus mode
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - nibble instruction to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the LCD parallel bus is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. This function is only required when using 4-bit bus mode. *Do not* use this
+*    function in 8-bit bus mode.
+* 2. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdif4BitFunctionSet(HLCDIF const hLcdIf,
+                                   unsigned char instruction)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writeStrobe(hLcdIf, 0, (unsigned char) (instruction << 4));
+        return LCDIF_SUCCESS;
+    }
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifGetPbBusWidth()
+*
+* Summary:
+*   Returns the width of the parallel data bus
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - BUS4BITSWIDE      - if the parallel bus is 4 bits wide
+*   - BUS8BITSWIDE      - if the parallel bus is 8 bits wide
+*
+* Callers:
+*   User application
+*
+* Notes :
+*   None
+*******************************************************************************/
+unsigned char lcdifGetPbBusWidth(HLCDIF const hLcdIf)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+    {
+        return BUS4BITSWIDE;
+    }
+    else
+    {
+        return BUS8BITSWIDE;
+    }
+}
+
+/*******************************************************************************
+* lcdifFixNibbleSwap()
+*
+* Summary:
+*   Makes "ReadAddress" swap the nibbles it receives, for LCD modules that
+*   return the address counter low nibble first
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   None
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. The simulated controller never swaps its nibbles, so this is only useful
+*    to check the behaviour of the HD44780 module with such a display
+*******************************************************************************/
+void lcdifFixNibbleSwap(HLCDIF const hLcdIf)
+{
+    hLcdIf->lcdIfFlags |= LCDIF_FIXNIBBLESWAP;
+}
+
+/*******************************************************************************
+* findFreeLcdIfSlot() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Finds the lowest free slot in the LCD interface slot table, in the same
+*   way as the PIC32 LCD interface module
+*
+* See also:
+*   None
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   - 0 to LCDIF_MAXOBJECTS - 1
+*                   - lowest free slot
+*   - LCDIF_MAXOBJECTS
+*                   - all slots are in use
+*
+* Callers:
+*   lcdifCreate()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned int findFreeLcdIfSlot(void)
+{
+    unsigned int word;                  /* Bitmap word being checked          */
+    unsigned int slot;                  /* Free slot found                    */
+    unsigned int freeSlots;             /* Set bits mark free slots           */
+
+    for (word = 0; word < LCDIF_SLOTWORDS; word++)
+    {
+        freeSlots = ~activeLcdIfObjects[word];
+        if (freeSlots != 0)
+        {
+                                        /* Isolate the lowest free slot's bit */
+                                        /* and count the zeros above it       */
+            slot = 31 - __builtin_clz(freeSlots & (0 - freeSlots));
+            slot += word * 32;
+            if (slot < LCDIF_MAXOBJECTS)
+            {
+                return slot;
+            }
+            break;
+        }
+    }
+
+    return LCDIF_MAXOBJECTS;
+}
+
+/*******************************************************************************
+* writeStrobe() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Performs one write E cycle on the simulated bus
+*
+* See also:
+*   readStrobe()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line
+*   dataLines       - state of DB7 to DB0
+*
+* Returns:
+*   void
+*
+* Callers:
+*   lcdifWriteData(), lcdifWriteInstruction(), lcdif4BitFunctionSet(),
+*   writeBlock()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void writeStrobe(HLCDIF const hLcdIf, unsigned char rs,
+                        unsigned char dataLines)
+{
+    hd44780simWrite(hLcdIf->hd44780Sim, rs, dataLines);
+    hd44780simAdvance(hd44780simGetCycleTime());
+}
+
+/*******************************************************************************
+* readStrobe() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Performs one read E cycle on the simulated bus
+*
+* See also:
+*   writeStrobe()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line
+*
+* Returns:
+*   State of DB7 to DB0 while E was high
+*
+* Callers:
+*   readByte()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned char readStrobe(HLCDIF const hLcdIf, unsigned char rs)
+{
+    unsigned char dataLines;
+
+    dataLines = hd44780simRead(hLcdIf->hd44780Sim, rs);
+    hd44780simAdvance(hd44780simGetCycleTime());
+
+    return dataLines;
+}
+
+/*******************************************************************************
+* readByte() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Reads a complete byte using one or two E cycles depending on bus width
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line
+*
+* Returns:
+*   Byte read
+*
+* Callers:
+*   lcdifReadData(), lcdifReadAddress()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static unsigned char readByte(HLCDIF const hLcdIf, unsigned char rs)
+{
+    unsigned char highNibble;
+    unsigned char lowNibble;
+
+    if (!(hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS))
+    {
+        return readStrobe(hLcdIf, rs);
+    }
+
+    highNibble = readStrobe(hLcdIf, rs) >> 4;
+    lowNibble = readStrobe(hLcdIf, rs) >> 4;
+                                        /* Address reads on some modules      */
+                                        /* arrive low nibble first            */
+    if (!rs && (hLcdIf->lcdIfFlags & LCDIF_FIXNIBBLESWAP))
+    {
+        return (unsigned char) ((lowNibble << 4) | highNibble);
+    }
+
+    return (unsigned char) ((highNibble << 4) | lowNibble);
+}
+
+/*******************************************************************************
+* writeBlock() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Writes a block of bytes with the same RS line state, pacing them with the
+*   time source given
+*
+* See also:
+*   writeStrobe()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line
+*   data            - bytes to write
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source, or NULL
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   void
+*
+* Callers:
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Notes :
+* 1. The wait is for more than interval, covering the time source's resolution
+*******************************************************************************/
+static void writeBlock(HLCDIF const hLcdIf, unsigned char rs,
+                       const unsigned char * data, unsigned char length,
+                       unsigned int (*pGetMicroseconds)(void),
+                       unsigned int interval)
+{
+    unsigned int lastWriteTime;
+
+    while (length)
+    {
+        if (hLcdIf->lcdIfFlags & LCDIF_PBWIDTH4BITS)
+        {
+            writeStrobe(hLcdIf, rs, *data & 0xF0);
+            writeStrobe(hLcdIf, rs, (unsigned char) (*data << 4));
+        }
+        else
+        {
+            writeStrobe(hLcdIf, rs, *data);
+        }
+        data++;
+        length--;
+                                        /* Wait before the next byte          */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            lastWriteTime = pGetMicroseconds();
+            while ((unsigned int) (pGetMicroseconds() - lastWriteTime) <=
+                   interval)
+            {
+                ;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+*
+*                              LCDIFHOST MODULE END
+*
+*******************************************************************************/
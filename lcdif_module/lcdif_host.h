@@ -0,0 +1,180 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR HOST PC SIMULATION
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This file provides the necessary information required to create an LCD
+* interface for use with the HD44780 module on a host PC. Instead of driving
+* GPIO pins, each LCD interface object is connected to a simulated HD44780
+* controller (see hd44780sim.h), so the HD44780 module can be tested and its
+* bus timing measured without hardware.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : lcdif_host.h
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* See the lcdif_<compiler>.c file for the version changes and notes for this
+* module
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                               LCDIFHOST MODULE
+*
+*******************************************************************************/
+
+#ifndef __LCDIF_MODULE_PRESENT__
+#define __LCDIF_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "hd44780sim.h"
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Maximum number of LCD interface objects that can be created at the same
+* time. Define it on the compiler command line to use a different capacity
+*******************************************************************************/
+#ifndef LCDIF_MAXOBJECTS
+#define LCDIF_MAXOBJECTS    16
+#endif
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   This is used by the lcdifGetBusWidth function to tell upper layer the width
+* of the data bus. This is required for the "Initialising by Instruction"
+* process
+*******************************************************************************/
+#define     BUS4BITSWIDE    0
+#define     BUS8BITSWIDE    1
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type LCDIFNUM
+* Description:
+*   Used to hold the LCD interface number issued by the LCD IF Module
+*******************************************************************************/
+typedef unsigned int LCDIFNUM;
+
+/*******************************************************************************
+* New data type LCDIFOBJTYPE
+* Description:
+*   Holds the object information for each LCD interface object created. The
+* user must fill in:
+* - The simulated controller this interface is connected to
+* - The width of the simulated data bus, BUS4BITSWIDE or BUS8BITSWIDE
+*******************************************************************************/
+typedef struct LCDIFOBJTYPE {
+    HD44780SIM                    * hd44780Sim;
+    unsigned char                   busWidth;
+    LCDIFNUM                        lcdIfNum;
+    unsigned char                   lcdIfFlags;
+} LCDIFOBJ;
+
+/*******************************************************************************
+* New data type HLCDIF
+* Description:
+*   Holds a pointer to an LCDIF object
+*******************************************************************************/
+typedef LCDIFOBJ * HLCDIF;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            lcdifInit(void);
+void            lcdifDeinit(void);
+
+LCDIFNUM        lcdifCreate(LCDIFOBJ            * const lcdIfObj);
+unsigned char   lcdifDestroy(LCDIFNUM                   lcdIfNumber);
+
+HLCDIF          lcdifOpen(LCDIFNUM                      lcdIfNumber);
+LCDIFNUM        lcdifClose(HLCDIF                 const hLcdIf);
+
+unsigned char   lcdifGetPb(HLCDIF                 const hLcdIf);
+void            lcdifReturnPb(HLCDIF              const hLcdIf);
+
+unsigned char   lcdifWriteData(HLCDIF             const hLcdIf,
+                               unsigned char            data);
+unsigned char   lcdifReadData(HLCDIF              const hLcdIf,
+                              unsigned char     * const data);
+
+unsigned char   lcdifWriteInstruction(HLCDIF      const hLcdIf,
+                                      unsigned char     instruction);
+unsigned char   lcdifReadAddress(HLCDIF           const hLcdIf,
+                                 unsigned char  * const address);
+
+unsigned char   lcdifWriteDataBlock(HLCDIF        const hLcdIf,
+                                    const unsigned char * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                    const unsigned char * instruction,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifReadDataBlock(HLCDIF         const hLcdIf,
+                                    unsigned char     * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+
+unsigned char   lcdif4BitFunctionSet(HLCDIF       const hLcdIf,
+                                      unsigned char     instruction);
+
+unsigned char   lcdifGetPbBusWidth(HLCDIF         const hLcdIf);
+
+void            lcdifFixNibbleSwap(HLCDIF         const hLcdIf);
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+#if defined(__18CXX) || defined(__C30) || defined(__PIC32MX__)
+#error This module is only intended for host PC builds.
+#error Use the lcdif_<compiler> module for your target instead.
+#endif
+
+
+/*******************************************************************************
+*
+*                              LCDIFHOST MODULE END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,1237 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR A PCF8574 I2C BACKPACK
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module is used to provide the interface for an HD44780 LCD display that
+* is driven from the port of a PCF8574 I2C I/O expander, as on the common LCD
+* "I2C backpack". The display is used with a 4-bit bus and its R/W pin held
+* low. Each data byte of an I2C write becomes one state of the PCF8574's port,
+* so one nibble written to the display takes two bytes: one raising E with the
+* nibble on DB7 to DB4 and one lowering it again. All the bytes of a call are
+* packed into one buffer and sent in a single I2C transaction, so writing a
+* whole string costs one START and one address byte rather than one of each
+* per pin change
+*
+* Filename : lcdif_pcf8574.c
+*
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. The display is not read, so the HD44780 module must be used in timed
+*    mode (see hd44780SetTimedMode()). Reading the busy flag through the
+*    PCF8574 costs two transactions, each with its own START, per poll
+* 2. Each port change takes nine I2C clocks, which at 100kHz or 400kHz is
+*    already longer than most instructions take to execute. When the I2C
+*    clock is known, block writes only add padding bytes if it is not. A
+*    whole string then goes out in one transaction with no time source
+*    polled between bytes
+* 3. One transaction buffer is shared by all LCD interface objects, so this
+*    module must not be called from more than one task at a time
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                               LCDIFPCF8574 MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "lcdif_pcf8574.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the LCD interface object is open and in use
+*******************************************************************************/
+#define LCDIF_OPEN          (0x01 << 7)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD interface currently owns the I2C bus
+*******************************************************************************/
+#define LCDIF_OWNPB         (0x01 << 5)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD module swaps the high/low nibble in 4-bit bus
+* mode when reading. Noted only, as the display can't be read
+*******************************************************************************/
+#define LCDIF_FIXNIBBLESWAP (0x01 << 4)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that lastOutputs holds what the PCF8574 is really driving.
+* Until then every nibble is preceded by a byte that sets up RS
+*******************************************************************************/
+#define LCDIF_OUTPUTSKNOWN  (0x01 << 3)
+
+/*******************************************************************************
+* Summary:
+* Used to indicate that the LCD interface is in use from another task
+*******************************************************************************/
+#define LCDIF_BUSY          0
+
+/*******************************************************************************
+* Summary:
+* Number of 32-bit words in the activeLcdIfObjects bitmap
+*******************************************************************************/
+#define LCDIF_SLOTWORDS     ((LCDIF_MAXOBJECTS + 31) / 32)
+
+/*******************************************************************************
+* Summary:
+* Used to indicate that the LCD interface call was successful
+*******************************************************************************/
+#define LCDIF_SUCCESS       1
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+* Local table of LCD interface objects, indexed by interface number minus one
+*******************************************************************************/
+static LCDIFOBJ * lcdIfSlots[LCDIF_MAXOBJECTS];
+
+/*******************************************************************************
+* Summary:
+* Used to note which LCD interface objects are active. Each bit in this bitmap
+* relates to one slot of lcdIfSlots.
+*******************************************************************************/
+static unsigned long activeLcdIfObjects[LCDIF_SLOTWORDS];
+
+/*******************************************************************************
+* Summary:
+* The LCD interface object that currently owns the I2C bus, or NULL
+*******************************************************************************/
+static HLCDIF i2cOwner;
+
+/*******************************************************************************
+* Summary:
+* Port states waiting to be sent to the PCF8574 in the next transaction, and
+* how many of them there are
+*******************************************************************************/
+static unsigned char i2cBuffer[LCDIF_I2CBUFFERSIZE];
+static unsigned int i2cBufferLength;
+
+/*******************************************************************************
+* Summary:
+* Cleared when the PCF8574 fails to acknowledge a transaction
+*******************************************************************************/
+static unsigned char i2cAcknowledged;
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static unsigned int     findFreeLcdIfSlot(void);
+static void             putOutputs(HLCDIF const hLcdIf, unsigned char outputs);
+static void             putNibble(HLCDIF const hLcdIf, unsigned char rs,
+                                  unsigned char nibble);
+static void             putByte(HLCDIF const hLcdIf, unsigned char rs,
+                                unsigned char value);
+static unsigned char    sendTransaction(HLCDIF const hLcdIf);
+static unsigned char    writeBlock(HLCDIF const hLcdIf, unsigned char rs,
+                                   const unsigned char * data,
+                                   unsigned char length,
+                                   unsigned int (*pGetMicroseconds)(void),
+                                   unsigned int interval);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* lcdifInit()
+*
+* Summary:
+*   Initialises the LCDIFPCF8574 module for first use
+*
+* See also:
+*   lcdifDeinit()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+* 1. The I2C peripheral itself is set up by the application
+*******************************************************************************/
+void lcdifInit(void)
+{
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
+                                        /* Currently no active LCDIF objects  */
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
+    i2cOwner = (HLCDIF) 0;
+    i2cBufferLength = 0;
+    i2cAcknowledged = 1;
+}
+
+/*******************************************************************************
+* lcdifDeinit()
+*
+* Summary:
+*   Deinitialises the LCDIFPCF8574 module after use
+*
+* See also:
+*   lcdifInit()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   None
+*******************************************************************************/
+void lcdifDeinit(void)
+{
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
+                                        /* Currently no active LCDIF objects  */
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
+    i2cOwner = (HLCDIF) 0;
+    i2cBufferLength = 0;
+    i2cAcknowledged = 1;
+}
+
+/*******************************************************************************
+* lcdifCreate()
+*
+* Summary:
+*   Creates an LCD interface for use by this module
+*
+* See also:
+*   lcdifDestroy()
+*
+* Arguments:
+*   lcdIfObj    - lcdif object to enter in the slot table
+*
+* Returns:
+*   - 1 to LCDIF_MAXOBJECTS
+*                       - number the LCD interface has been assigned if it was
+*                         possible to allocate it
+*   - 0                 - if the LCD interface allocation failed
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   1. lcdifInit() must have been called prior to calling this function
+*   2. The number assigned is the object's slot in the slot table plus one,
+*      and is always the lowest one free
+*   3. RS, R/W, E, DB7 to DB4 and the other outputs must each use different
+*      port bits
+*   4. Nothing is sent to the PCF8574 until the first write
+*******************************************************************************/
+LCDIFNUM lcdifCreate(LCDIFOBJ * const lcdIfObj)
+{
+    unsigned int slot;                  /* Slot allocated to this object      */
+    unsigned int usedOutputs;           /* Outputs wired to the display       */
+    unsigned int controlOutputs;        /* RS, R/W and E                      */
+                                        /* Check we got an object to point to */
+    if (lcdIfObj != (LCDIFOBJ *) 0)
+    {
+        if (lcdIfObj->pI2cWrite == 0 || lcdIfObj->i2cAddress > 0x7F ||
+            lcdIfObj->RS_BIT > 7 || lcdIfObj->RW_BIT > 7 ||
+            lcdIfObj->E_BIT > 7 || lcdIfObj->DATA_SHIFT > 4)
+        {
+            goto cannot_create_if;
+        }
+                                        /* No output may be used twice        */
+        usedOutputs = 0x0Fu << lcdIfObj->DATA_SHIFT;
+        controlOutputs = (1u << lcdIfObj->RS_BIT) | (1u << lcdIfObj->RW_BIT) |
+                         (1u << lcdIfObj->E_BIT);
+        if ((usedOutputs & controlOutputs) ||
+            lcdIfObj->RS_BIT == lcdIfObj->RW_BIT ||
+            lcdIfObj->RS_BIT == lcdIfObj->E_BIT ||
+            lcdIfObj->RW_BIT == lcdIfObj->E_BIT)
+        {
+            goto cannot_create_if;
+        }
+        usedOutputs |= controlOutputs;
+        if (lcdIfObj->OTHER_BITS & usedOutputs)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Find a free slot, if we haven't    */
+                                        /* allocated all the LCD interface    */
+                                        /* objects we can support             */
+        slot = findFreeLcdIfSlot();
+        if (slot >= LCDIF_MAXOBJECTS)
+        {
+            goto cannot_create_if;
+        }
+        activeLcdIfObjects[slot / 32] |= 1ul << (slot % 32);
+        lcdIfSlots[slot] = lcdIfObj;
+                                        /* Assign the interface number        */
+        lcdIfObj->lcdIfNum = slot + 1;
+                                        /* Clear the object's flags; the      */
+                                        /* port state isn't known yet         */
+        lcdIfObj->lcdIfFlags = 0;
+        lcdIfObj->lastOutputs = lcdIfObj->OTHER_BITS;
+
+        return lcdIfObj->lcdIfNum;
+    }
+cannot_create_if:
+                                        /* Couldn't create interface          */
+    return 0;
+}
+
+/*******************************************************************************
+* lcdifDestroy()
+*
+* Summary:
+*   Destroys a previously created LCD interface object
+*
+* See also:
+*   lcdifCreate()
+*
+* Arguments:
+*   lcdIfNumber - number of the LCD interface object to destroy
+*
+* Returns:
+*   - 1   - LCD interface was successfully destroyed
+*   - 0   - couldn't detroy requested LCD interface - probably still open
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   1. lcdifCreate() must have been called prior to calling this function
+*******************************************************************************/
+unsigned char lcdifDestroy(LCDIFNUM lcdIfNumber)
+{
+    unsigned int slot;                  /* Slot holding the object            */
+
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
+    {
+        slot = lcdIfNumber - 1;
+                                        /* If the slot holds an object that   */
+                                        /* is not open, simply remove it      */
+        if (lcdIfSlots[slot] != (LCDIFOBJ *) 0 &&
+            !(lcdIfSlots[slot]->lcdIfFlags & LCDIF_OPEN))
+        {
+            lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+                                        /* Also note that we have one less    */
+                                        /* active LCD interface               */
+            activeLcdIfObjects[slot / 32] &= ~(1ul << (slot % 32));
+            return 1;
+        }
+    }
+                                        /* Couldn't destroy interface         */
+    return 0;
+}
+
+/*******************************************************************************
+* lcdifOpen()
+*
+* Summary:
+*   Opens an LCD interface for use by caller and initialises an HLCDIF
+*   handle to it
+*
+* See also:
+*   lcdifClose()
+*
+* Arguments:
+*   lcdIfNumber     - number of an existing LCD interface object to use
+*
+* Returns:
+*   - NULL          - if LCD interface couldn't be opened
+*   - handle        - if LCD interface was opened properly
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have created (lcdifCreate) at least one LCD interface object
+*    before calling this function
+*******************************************************************************/
+HLCDIF lcdifOpen(LCDIFNUM lcdIfNumber)
+{
+    LCDIFOBJ * localLcdIfObj;           /* Object in the requested slot       */
+
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
+    {
+        localLcdIfObj = lcdIfSlots[lcdIfNumber - 1];
+                                        /* Check there is an object in the    */
+                                        /* slot that is not already open      */
+        if (localLcdIfObj != (LCDIFOBJ *) 0 &&
+            !(localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
+        {
+                                        /* Note that it is now in use         */
+            localLcdIfObj->lcdIfFlags |= LCDIF_OPEN;
+                                        /* Return handle to it                */
+            return localLcdIfObj;
+        }
+    }
+                                        /* Return handle to NULL otherwise    */
+    return (LCDIFOBJ *) 0;
+}
+
+/*******************************************************************************
+* lcdifClose()
+*
+* Summary:
+*   Closes an LCD interface and releases the handle to it
+*
+* See also:
+*   lcdifOpen()
+*
+* Arguments:
+*   hLcdIf          - handle to the open buffer
+*
+* Returns:
+*   - >0            - number of LCD interface object if it was was open
+*   - 0             - if the LCD interface was not open
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+LCDIFNUM lcdifClose(HLCDIF const hLcdIf)
+{
+                                        /* Check LCD interface is actually    */
+                                        /* open                               */
+    if (hLcdIf->lcdIfFlags & LCDIF_OPEN)
+    {
+                                        /* Note that this LCD interface       */
+                                        /* object is closed                   */
+        hLcdIf->lcdIfFlags &= ~LCDIF_OPEN;
+                                        /* Return LCD interface object's      */
+                                        /* interface number                   */
+        return hLcdIf->lcdIfNum;
+    }
+                                        /* Otherwise return 0 to say that     */
+                                        /* buffer object wasn't open          */
+    return (LCDIFNUM) 0;
+}
+
+/*******************************************************************************
+* lcdifGetPb()
+*
+* Summary:
+*   Attempts to aquire the I2C bus for use by the LCD interface module
+*
+* See also:
+*   lcdifReturnPb()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - 1             - this LCD interface (hLcdIf) owns the I2C bus
+*   - 0             - the I2C bus is currently in use by another LCD interface
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. All LCD interface objects are taken to share one I2C bus, each PCF8574
+*    at its own address
+*******************************************************************************/
+unsigned char lcdifGetPb(HLCDIF const hLcdIf)
+{
+    if (i2cOwner != (HLCDIF) 0 && i2cOwner != hLcdIf)
+    {
+        return 0;
+    }
+    i2cOwner = hLcdIf;
+    hLcdIf->lcdIfFlags |= LCDIF_OWNPB;
+
+    return 1;
+}
+
+/*******************************************************************************
+* lcdifReturnPb()
+*
+* Summary:
+*   Returns the I2C bus for use by other LCD interfaces
+*
+* See also:
+*   lcdifGetPb()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+void lcdifReturnPb(HLCDIF const hLcdIf)
+{
+    if (i2cOwner == hLcdIf)
+    {
+        i2cOwner = (HLCDIF) 0;
+    }
+    hLcdIf->lcdIfFlags &= ~LCDIF_OWNPB;
+}
+
+/*******************************************************************************
+* lcdifWriteData()
+*
+* Summary:
+*   Writes data to the LCD interface
+*
+* See also:
+*   lcdifReadData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the I2C bus is in use or the PCF8574 didn't
+*                     acknowledge
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. Both nibbles are sent in one I2C transaction of four or five bytes
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        putByte(hLcdIf, 1, data);
+                                        /* Inform caller if write succeeded   */
+        return sendTransaction(hLcdIf);
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadData()
+*
+* Summary:
+*   Would read data from the LCD interface. The display's R/W pin is held low,
+*   so this is not possible
+*
+* See also:
+*   lcdifWriteData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   * data          - not used
+*
+* Returns:
+*   - LCDIF_BUSY    - always
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Use the HD44780 module in timed mode so that it never reads the display
+*******************************************************************************/
+unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
+{
+    (void) hLcdIf;
+    (void) data;
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteInstruction()
+*
+* Summary:
+*   Writes an instruction to the LCD interface
+*
+* See also:
+*   lcdifReadAddress()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instruction to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the I2C bus is in use or the PCF8574 didn't
+*                     acknowledge
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. Both nibbles are sent in one I2C transaction of four or five bytes
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf,
+                                    unsigned char instruction)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        putByte(hLcdIf, 0, instruction);
+                                        /* Inform caller if write succeeded   */
+        return sendTransaction(hLcdIf);
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadAddress()
+*
+* Summary:
+*   Would read the address counter value and busy flag. The display's R/W pin
+*   is held low, so this is not possible
+*
+* See also:
+*   lcdifWriteInstruction()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   * address       - not used
+*
+* Returns:
+*   - LCDIF_BUSY    - always
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Use the HD44780 module in timed mode so that it never reads the display
+*******************************************************************************/
+unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
+                               unsigned char * const address)
+{
+    (void) hLcdIf;
+    (void) address;
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteDataBlock()
+*
+* Summary:
+*   Writes a block of data to the LCD interface, packed into as few I2C
+*   transactions as possible
+*
+* See also:
+*   lcdifWriteData(), lcdifWriteInstructionBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the I2C bus is in use or the PCF8574 didn't
+*                     acknowledge
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte
+* 3. If i2cClockKHz is set, the interval is made up of the bytes of the next
+*    write, plus padding bytes if they aren't enough, and the time source is
+*    not read. Otherwise each byte is sent in its own transaction and the time
+*    source is polled between them
+* 4. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteDataBlock(HLCDIF const hLcdIf,
+                                  const unsigned char * data,
+                                  unsigned char length,
+                                  unsigned int (*pGetMicroseconds)(void),
+                                  unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+                                        /* Inform caller if write succeeded   */
+        return writeBlock(hLcdIf, 1, data, length, pGetMicroseconds, interval);
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteInstructionBlock()
+*
+* Summary:
+*   Writes a block of instructions to the LCD interface, packed into as few
+*   I2C transactions as possible
+*
+* See also:
+*   lcdifWriteInstruction(), lcdifWriteDataBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instructions to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the I2C bus is in use or the PCF8574 didn't
+*                     acknowledge
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte
+* 3. Paced as for lcdifWriteDataBlock()
+* 4. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                         const unsigned char * instruction,
+                                         unsigned char length,
+                                         unsigned int (*pGetMicroseconds)(void),
+                                         unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+                                        /* Inform caller if write succeeded   */
+        return writeBlock(hLcdIf, 0, instruction, length, pGetMicroseconds,
+                          interval);
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadDataBlock()
+*
+* Summary:
+*   Would read a block of data from the LCD interface. The display's R/W pin
+*   is held low, so this is not possible
+*
+* See also:
+*   lcdifReadData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - not used
+*   length          - not used
+*   pGetMicroseconds - not used
+*   interval        - not used
+*
+* Returns:
+*   - LCDIF_BUSY    - always
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Set pReadDataBlock to NULL rather than use this function
+*******************************************************************************/
+unsigned char lcdifReadDataBlock(HLCDIF const hLcdIf,
+                                 unsigned char * data,
+                                 unsigned char length,
+                                 unsigned int (*pGetMicroseconds)(void),
+                                 unsigned int interval)
+{
+    (void) hLcdIf;
+    (void) data;
+    (void) length;
+    (void) pGetMicroseconds;
+    (void) interval;
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdif4BitFunctionSet()
+*
+* Summary:
+*   Writes a single nibble instruction to the LCD interface as required by the
+*   "Initialising by Instruction" sequence in 4-bit bus mode
+*
+* See also:
+*   lcdifGetPbBusWidth()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - nibble instruction to write to the LCD interface, in the
+*                     lower four bits
+*
+* Returns:
+*   - LCDIF_BUSY    - if the I2C bus is in use or the PCF8574 didn't
+*                     acknowledge
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+unsigned char lcdif4BitFunctionSet(HLCDIF const hLcdIf,
+                                   unsigned char instruction)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        putNibble(hLcdIf, 0, instruction);
+                                        /* Inform caller if write succeeded   */
+        return sendTransaction(hLcdIf);
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifGetPbBusWidth()
+*
+* Summary:
+*   Returns the width of the parallel data bus. This is necessary so that the
+*   upper layer can correctly issue the "Initialising by Instruction" sequence
+*   which is different depending on the data bus width in use
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - BUS4BITSWIDE      - always, as only four port bits carry data
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+unsigned char lcdifGetPbBusWidth(HLCDIF const hLcdIf)
+{
+    (void) hLcdIf;
+
+    return BUS4BITSWIDE;
+}
+
+/*******************************************************************************
+* lcdifFixNibbleSwap()
+*
+* Summary:
+*   Provided for compatibility with the GPIO LCD interface modules. Nibbles
+*   are only swapped when reading, so with a PCF8574 this is just noted
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   None
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+void lcdifFixNibbleSwap(HLCDIF const hLcdIf)
+{
+    hLcdIf->lcdIfFlags |= LCDIF_FIXNIBBLESWAP;
+}
+
+/*******************************************************************************
+* findFreeLcdIfSlot() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Finds the lowest free slot in the LCD interface slot table. This function
+* is private to the LCDIFPCF8574 module.
+*
+* See also:
+*   None
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   - 0 to LCDIF_MAXOBJECTS - 1
+*                   - lowest free slot
+*   - LCDIF_MAXOBJECTS
+*                   - all slots are in use
+*
+* Callers:
+*   lcdifCreate()
+*
+* Notes :
+* 1. The bitmap words are unsigned long so that they hold 32 slots with every
+*    supported compiler
+*******************************************************************************/
+static unsigned int findFreeLcdIfSlot(void)
+{
+    unsigned int word;                  /* Bitmap word being checked          */
+    unsigned int slot;                  /* Free slot found                    */
+    unsigned long freeSlots;            /* Set bits mark free slots           */
+
+    for (word = 0; word < LCDIF_SLOTWORDS; word++)
+    {
+        freeSlots = ~activeLcdIfObjects[word];
+        if (freeSlots != 0)
+        {
+                                        /* Find the lowest free slot's bit    */
+            for (slot = 0; !(freeSlots & 0x01); freeSlots >>= 1)
+            {
+                slot++;
+            }
+            slot += word * 32;
+                                        /* The last word may have bits beyond */
+                                        /* the end of the table               */
+            if (slot < LCDIF_MAXOBJECTS)
+            {
+                return slot;
+            }
+            break;
+        }
+    }
+
+    return LCDIF_MAXOBJECTS;
+}
+
+/*******************************************************************************
+* putOutputs() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Adds one state of the PCF8574's port to the transaction buffer, sending
+*   the buffer first if it is full. This function is private to the
+*   LCDIFPCF8574 module.
+*
+* See also:
+*   sendTransaction()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   outputs         - state of P7 (bit 7) to P0 (bit 0)
+*
+* Returns:
+*   None
+*
+* Callers:
+*   putNibble(), writeBlock()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void putOutputs(HLCDIF const hLcdIf, unsigned char outputs)
+{
+    if (i2cBufferLength >= LCDIF_I2CBUFFERSIZE)
+    {
+                                        /* An error is kept for the caller    */
+        if (sendTransaction(hLcdIf) != LCDIF_SUCCESS)
+        {
+            i2cAcknowledged = 0;
+        }
+    }
+    i2cBuffer[i2cBufferLength] = outputs;
+    i2cBufferLength++;
+    hLcdIf->lastOutputs = outputs;
+}
+
+/*******************************************************************************
+* putNibble() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Adds the port states for one E strobe to the transaction buffer. This
+*   function is private to the LCDIFPCF8574 module.
+*
+* See also:
+*   putByte()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line (0 = instruction, !0 = data)
+*   nibble          - value for DB7 to DB4, in the lower four bits
+*
+* Returns:
+*   None
+*
+* Callers:
+*   putByte(), lcdif4BitFunctionSet()
+*
+* Notes :
+* 1. RS must be stable before E rises (tAS), so if it changes it is given a
+*    byte of its own with E low. Otherwise the nibble goes out with E high in
+*    one byte and E falls in the next, which holds the data lines (tH)
+*******************************************************************************/
+static void putNibble(HLCDIF const hLcdIf, unsigned char rs,
+                      unsigned char nibble)
+{
+    unsigned char outputs;
+
+    outputs = hLcdIf->OTHER_BITS |
+              (unsigned char) ((nibble & 0x0F) << hLcdIf->DATA_SHIFT);
+    if (rs)
+    {
+        outputs |= (unsigned char) (1u << hLcdIf->RS_BIT);
+    }
+                                        /* Set up RS if it has to change      */
+    if (!(hLcdIf->lcdIfFlags & LCDIF_OUTPUTSKNOWN) ||
+        ((hLcdIf->lastOutputs ^ outputs) & (1u << hLcdIf->RS_BIT)))
+    {
+        putOutputs(hLcdIf, outputs);
+        hLcdIf->lcdIfFlags |= LCDIF_OUTPUTSKNOWN;
+    }
+                                        /* Then the strobe itself             */
+    putOutputs(hLcdIf, (unsigned char) (outputs | (1u << hLcdIf->E_BIT)));
+    putOutputs(hLcdIf, outputs);
+}
+
+/*******************************************************************************
+* putByte() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Adds the port states for a whole instruction or data byte to the
+*   transaction buffer, high nibble first. This function is private to the LCDIFPCF8574
+*   module.
+*
+* See also:
+*   putNibble()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line (0 = instruction, !0 = data)
+*   value           - byte to write
+*
+* Returns:
+*   None
+*
+* Callers:
+*   lcdifWriteData(), lcdifWriteInstruction(), writeBlock()
+*
+* Notes :
+*   None
+*******************************************************************************/
+static void putByte(HLCDIF const hLcdIf, unsigned char rs, unsigned char value)
+{
+    putNibble(hLcdIf, rs, (unsigned char) (value >> 4));
+    putNibble(hLcdIf, rs, value);
+}
+
+/*******************************************************************************
+* sendTransaction() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Sends the transaction buffer to the LCD interface's PCF8574 and empties
+*   it. This function is private to the LCDIFPCF8574 module.
+*
+* See also:
+*   putOutputs()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if this or an earlier transaction since the last call
+*                     wasn't acknowledged
+*   - LCDIF_SUCCESS - otherwise
+*
+* Callers:
+*   lcdifWriteData(), lcdifWriteInstruction(), lcdif4BitFunctionSet(),
+*   putOutputs(), writeBlock()
+*
+* Notes :
+* 1. The I2C write function doesn't return until the STOP has been sent
+* 2. After a failed transaction the port state is no longer known, so the
+*    next nibble sets up RS again
+*******************************************************************************/
+static unsigned char sendTransaction(HLCDIF const hLcdIf)
+{
+    unsigned char result;
+
+    if (i2cBufferLength != 0)
+    {
+        if (!hLcdIf->pI2cWrite(hLcdIf->i2cAddress, i2cBuffer, i2cBufferLength))
+        {
+            hLcdIf->lcdIfFlags &= ~LCDIF_OUTPUTSKNOWN;
+            i2cAcknowledged = 0;
+        }
+        i2cBufferLength = 0;
+    }
+
+    result = i2cAcknowledged ? LCDIF_SUCCESS : LCDIF_BUSY;
+    i2cAcknowledged = 1;
+
+    return result;
+}
+
+/*******************************************************************************
+* writeBlock() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Writes a block of instructions or data, waiting between each byte. This
+*   function is private to the LCDIFPCF8574 module.
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   rs              - state of the RS line
+*   data            - bytes to write
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source, or NULL
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PCF8574 didn't acknowledge
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Notes :
+* 1. One byte takes 9000 / i2cClockKHz microseconds to send. The next write
+*    is made at the falling edge of E two bytes after the last padding byte,
+*    so those two bytes count towards the interval. With the time source the
+*    wait is for more than interval, covering its resolution
+*******************************************************************************/
+static unsigned char writeBlock(HLCDIF const hLcdIf, unsigned char rs,
+                                const unsigned char * data,
+                                unsigned char length,
+                                unsigned int (*pGetMicroseconds)(void),
+                                unsigned int interval)
+{
+    unsigned long   padding = 0;
+    unsigned long   count;
+    unsigned int    lastWriteTime;
+                                        /* Work out the bytes that make up    */
+                                        /* the interval at this I2C clock     */
+    if (pGetMicroseconds != (unsigned int (*)(void)) 0 &&
+        hLcdIf->i2cClockKHz != 0)
+    {
+        padding = ((unsigned long) interval * hLcdIf->i2cClockKHz + 8999) /
+                  9000;
+        padding = (padding > 2) ? padding - 2 : 0;
+    }
+
+    while (length)
+    {
+        putByte(hLcdIf, rs, *data);
+        data++;
+        length--;
+                                        /* Give the LCD controller time to    */
+                                        /* execute before the next byte       */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            if (hLcdIf->i2cClockKHz != 0)
+            {
+                for (count = 0; count < padding; count++)
+                {
+                    putOutputs(hLcdIf, hLcdIf->lastOutputs);
+                }
+            }
+            else
+            {
+                if (sendTransaction(hLcdIf) != LCDIF_SUCCESS)
+                {
+                    i2cAcknowledged = 0;
+                }
+                lastWriteTime = pGetMicroseconds();
+                while ((unsigned int) (pGetMicroseconds() - lastWriteTime) <=
+                                                                    interval)
+                {
+                    ;
+                }
+            }
+        }
+    }
+
+    return sendTransaction(hLcdIf);
+}
+
+
+/*******************************************************************************
+*
+*                             LCDIFPCF8574 MODULE END
+*
+*******************************************************************************/
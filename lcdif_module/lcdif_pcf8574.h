@@ -0,0 +1,225 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR A PCF8574 I2C BACKPACK
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This file provides the necessary information required to create an LCD
+* interface for use with the HD44780 module where the display is driven from
+* the quasi-bidirectional port of a PCF8574 I2C I/O expander, as on the common
+* LCD "I2C backpack". It replaces lcdif_<compiler>.c; define LCDIF_PCF8574 on
+* the compiler command line so that the HD44780 module includes this file. The module uses no registers itself,
+* so it builds with any of the supported compilers.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : lcdif_pcf8574.h
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* See the lcdif_pcf8574.c file for the version changes and notes for this module
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                               LCDIFPCF8574 MODULE
+*
+*******************************************************************************/
+
+#ifndef __LCDIF_MODULE_PRESENT__
+#define __LCDIF_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Maximum number of LCD interface objects that can be created at the same
+* time. Define it on the compiler command line to use a different capacity
+*******************************************************************************/
+#ifndef LCDIF_MAXOBJECTS
+#define LCDIF_MAXOBJECTS    16
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Size of the buffer in which block writes are packed before being handed to
+* the I2C write function. A block that doesn't fit is sent as several
+* transactions. Lower it to suit an I2C driver with a smaller buffer
+*******************************************************************************/
+#ifndef LCDIF_I2CBUFFERSIZE
+#define LCDIF_I2CBUFFERSIZE 128
+#endif
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   This is used by the lcdifGetBusWidth function to tell upper layer the width
+* of the data bus. This is required for the "Initialising by Instruction"
+* process
+*******************************************************************************/
+#define     BUS4BITSWIDE    0
+#define     BUS8BITSWIDE    1
+
+/*******************************************************************************
+* Summary:
+*   Output numbers (P0 = 0 to P7 = 7) used by the usual LCD I2C backpack: RS
+* on P0, R/W on P1, E on P2, the backlight on P3 and DB4 to DB7 on P4 to P7
+*******************************************************************************/
+#define     LCDIF_BACKPACK_RS       0
+#define     LCDIF_BACKPACK_RW       1
+#define     LCDIF_BACKPACK_E        2
+#define     LCDIF_BACKPACK_LIGHT    0x08
+#define     LCDIF_BACKPACK_DATA     4
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type LCDIFNUM
+* Description:
+*   Used to hold the LCD interface number issued by the LCD IF Module
+*******************************************************************************/
+typedef unsigned int LCDIFNUM;
+
+/*******************************************************************************
+* New data type LCDIFOBJTYPE
+* Description:
+*   Holds the object information for each LCD interface object created. The
+* display's R/W pin is held low and DB7 to DB4 are used. The user fills in:
+* - A function that makes one I2C write transaction: a START, the 7-bit
+*   address with the write bit, each byte of data and a STOP. It must not
+*   return until the STOP has been sent, and returns 0 if the PCF8574 did not
+*   acknowledge
+* - The PCF8574's 7-bit I2C address
+* - The port bit numbers (P0 = 0 to P7 = 7) wired to RS, R/W and E
+* - The port bit number to which DB4 is wired; DB5 to DB7 follow on the next
+*   3 bits
+* - A mask of any other port bits to hold high, such as a backlight
+* - The I2C clock in kHz, so that block writes can be paced with padding
+*   bytes in one transaction, or 0 to pace them with the time source instead
+* The remaining members are private to the module.
+*******************************************************************************/
+typedef struct LCDIFOBJTYPE {
+    unsigned char                (* pI2cWrite)(unsigned char address,
+                                               const unsigned char * data,
+                                               unsigned int length);
+    unsigned char                   i2cAddress;
+    unsigned char                   RS_BIT;
+    unsigned char                   RW_BIT;
+    unsigned char                   E_BIT;
+    unsigned char                   DATA_SHIFT;
+    unsigned char                   OTHER_BITS;
+    unsigned int                    i2cClockKHz;
+    LCDIFNUM                        lcdIfNum;
+    unsigned char                   lcdIfFlags;
+    unsigned char                   lastOutputs;
+} LCDIFOBJ;
+
+/*******************************************************************************
+* New data type HLCDIF
+* Description:
+*   Holds a pointer to an LCDIF object
+*******************************************************************************/
+typedef LCDIFOBJ * HLCDIF;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            lcdifInit(void);
+void            lcdifDeinit(void);
+
+LCDIFNUM        lcdifCreate(LCDIFOBJ            * const lcdIfObj);
+unsigned char   lcdifDestroy(LCDIFNUM                   lcdIfNumber);
+
+HLCDIF          lcdifOpen(LCDIFNUM                      lcdIfNumber);
+LCDIFNUM        lcdifClose(HLCDIF                 const hLcdIf);
+
+unsigned char   lcdifGetPb(HLCDIF                 const hLcdIf);
+void            lcdifReturnPb(HLCDIF              const hLcdIf);
+
+unsigned char   lcdifWriteData(HLCDIF             const hLcdIf,
+                               unsigned char            data);
+unsigned char   lcdifReadData(HLCDIF              const hLcdIf,
+                              unsigned char     * const data);
+
+unsigned char   lcdifWriteInstruction(HLCDIF      const hLcdIf,
+                                      unsigned char     instruction);
+unsigned char   lcdifReadAddress(HLCDIF           const hLcdIf,
+                                 unsigned char  * const address);
+
+unsigned char   lcdifWriteDataBlock(HLCDIF        const hLcdIf,
+                                    const unsigned char * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                    const unsigned char * instruction,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifReadDataBlock(HLCDIF         const hLcdIf,
+                                    unsigned char     * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+
+unsigned char   lcdif4BitFunctionSet(HLCDIF       const hLcdIf,
+                                      unsigned char     instruction);
+
+unsigned char   lcdifGetPbBusWidth(HLCDIF         const hLcdIf);
+
+void            lcdifFixNibbleSwap(HLCDIF         const hLcdIf);
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+#if LCDIF_MAXOBJECTS < 1
+#error LCDIF_MAXOBJECTS must be at least 1
+#endif
+
+#if LCDIF_I2CBUFFERSIZE < 8
+#error LCDIF_I2CBUFFERSIZE must be at least 8, to hold one byte written to the
+#error display with its RS set-up byte
+#endif
+
+
+/*******************************************************************************
+*
+*                             LCDIFPCF8574 MODULE END
+*
+*******************************************************************************/
+#endif
@@ -0,0 +1,1536 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR THE PARALLEL MASTER PORT
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This module is used to provide the interface for an HD44780 LCD display, based
+* upon the Parallel Master Port (PMP) peripheral found on PIC24, dsPIC33 and
+* PIC32 microcontrollers. The PMP is used in master mode 1: PMRD/PMWR is R/W,
+* PMENB is E and PMD0 to PMD7 are DB0 to DB7. RS is driven by one of the PMP
+* address lines. The PMP makes the E strobe itself, with its width set by the
+* wait states of the LCD interface object being used, so each bus cycle costs
+* the CPU a single store or load
+*
+* Filename : lcdif_pmp.c
+*
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* 1. The PMP has no 4-bit mode, so the display must be wired for an 8-bit bus
+* 2. Reading PMDIN returns the data latched by the previous read cycle and
+*    starts a new one. To read one byte without starting a second cycle, the
+*    PMP is switched off while the latched data is collected
+* 3. On the PIC32, lcdifWriteFrame() uses Timer 2 and DMA channels 0 and 1.
+*    Each Timer 2 period match makes channel 0 copy the next PMADDR value, and
+*    its cell done event makes channel 1 copy the next byte to PMDIN. The
+*    application must not use these peripherals itself
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                                LCDIFPMP MODULE
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+#include "lcdif_pmp.h"
+
+/*******************************************************************************
+*                                 LOCAL DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the LCD interface object is open and in use
+*******************************************************************************/
+#define LCDIF_OPEN          (0x01 << 7)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD interface currently owns the peripheral bus
+*******************************************************************************/
+#define LCDIF_OWNPB         (0x01 << 5)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that the DMA channels are sending a frame for this LCD
+* interface. It keeps the PMP, but can't use it until lcdifIsFrameDone()
+*******************************************************************************/
+#define LCDIF_FRAMEACTIVE   (0x01 << 3)
+
+/*******************************************************************************
+* Summary:
+*   Used to indicate that this LCD module swaps the high/low nibble in 4-bit bus
+* mode when reading. Noted only, as the PMP bus is always 8 bits wide
+*******************************************************************************/
+#define LCDIF_FIXNIBBLESWAP (0x01 << 4)
+
+/*******************************************************************************
+* Summary:
+*   PMCON bits: PMP enable, PMWR and PMRD pins enabled, and write (E) and
+* read (R/W) strobes active high
+*******************************************************************************/
+#define LCDIF_PMCON_PMPEN   (0x01 << 15)
+#define LCDIF_PMCON_PTWREN  (0x01 << 9)
+#define LCDIF_PMCON_PTRDEN  (0x01 << 8)
+#define LCDIF_PMCON_WRSP    (0x01 << 1)
+#define LCDIF_PMCON_RDSP    (0x01 << 0)
+
+/*******************************************************************************
+* Summary:
+*   PMMODE bits: busy flag, master mode 1 and the wait state fields
+*******************************************************************************/
+#define LCDIF_PMMODE_BUSY   (0x01 << 15)
+#define LCDIF_PMMODE_MASTER1 (0x03 << 8)
+#define LCDIF_PMMODE_WAITS  0x00FF
+
+/*******************************************************************************
+* Summary:
+*   PMP data register and the switching of the PMP on and off. The PIC32 can
+* do the latter with a single store to PMCONSET or PMCONCLR
+*******************************************************************************/
+#if defined(__PIC32MX__)
+#define LCDIF_PMDIN         PMDIN
+#define LCDIF_PMPON()       (PMCONSET = LCDIF_PMCON_PMPEN)
+#define LCDIF_PMPOFF()      (PMCONCLR = LCDIF_PMCON_PMPEN)
+#else
+#define LCDIF_PMDIN         PMDIN1
+#define LCDIF_PMPON()       (PMCON |= LCDIF_PMCON_PMPEN)
+#define LCDIF_PMPOFF()      (PMCON &= ~LCDIF_PMCON_PMPEN)
+#endif
+
+/*******************************************************************************
+* Summary:
+*   T2CON, DMACON, DCHxCON, DCHxECON and DCHxINT bits used for frames: timer
+* on and its prescale field, DMA controller on, channel enabled, channel
+* started by its start IRQ, and the cell done and block done events
+*******************************************************************************/
+#if defined(__PIC32MX__)
+#define LCDIF_T2CON_ON      (0x01 << 15)
+#define LCDIF_T2CON_TCKPS   4
+#define LCDIF_DMACON_ON     (0x01 << 15)
+#define LCDIF_DCHCON_CHEN   (0x01 << 7)
+#define LCDIF_DCHECON_SIRQEN (0x01 << 4)
+#define LCDIF_DCHINT_CHCCIF (0x01 << 2)
+#define LCDIF_DCHINT_CHBCIF (0x01 << 3)
+#define LCDIF_DCHINT_CHCCIE (0x01 << 18)
+#define LCDIF_DCHINT_FLAGS  0x00FF
+#endif
+
+/*******************************************************************************
+* Summary:
+* Used to indicate that the LCD interface is in use from another task
+*******************************************************************************/
+#define LCDIF_BUSY          0
+
+/*******************************************************************************
+* Summary:
+* Number of 32-bit words in the activeLcdIfObjects bitmap
+*******************************************************************************/
+#define LCDIF_SLOTWORDS     ((LCDIF_MAXOBJECTS + 31) / 32)
+
+/*******************************************************************************
+* Summary:
+* Used to indicate that the LCD interface call was successful
+*******************************************************************************/
+#define LCDIF_SUCCESS       1
+
+/*******************************************************************************
+*                                LOCAL CONSTANTS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                LOCAL DATA TYPES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                  LOCAL TABLES
+*******************************************************************************/
+
+#if defined(__PIC32MX__)
+/*******************************************************************************
+* Summary:
+* Timer 2 input clock divide ratio, as a shift, for each TCKPS value
+*******************************************************************************/
+static const unsigned char timerPrescaleShifts[8] = { 0, 1, 2, 3, 4, 5, 6, 8 };
+#endif
+
+
+/*******************************************************************************
+*                             LOCAL GLOBAL VARIABLES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+* Local table of LCD interface objects, indexed by interface number minus one
+*******************************************************************************/
+static LCDIFOBJ * lcdIfSlots[LCDIF_MAXOBJECTS];
+
+/*******************************************************************************
+* Summary:
+* Used to note which LCD interface objects are active. Each bit in this bitmap
+* relates to one slot of lcdIfSlots.
+*******************************************************************************/
+static unsigned long activeLcdIfObjects[LCDIF_SLOTWORDS];
+
+/*******************************************************************************
+* Summary:
+* The LCD interface object that currently owns the PMP, or NULL
+*******************************************************************************/
+static HLCDIF pmpOwner;
+
+/*******************************************************************************
+*#X#                          LOCAL FUNCTION PROTOTYPES
+*******************************************************************************/
+static unsigned int     findFreeLcdIfSlot(void);
+static void             waitWhilePmpBusy(void);
+static void             writePmp(unsigned int address, unsigned char value);
+static unsigned char    readPmp(unsigned int address);
+static void             writePmpBlock(unsigned int address,
+                                      const unsigned char * data,
+                                      unsigned char length,
+                                      unsigned int (*pGetMicroseconds)(void),
+                                      unsigned int interval);
+
+
+/*******************************************************************************
+*                            LOCAL CONFIGURATION ERRORS
+*******************************************************************************/
+
+
+/*******************************************************************************
+* lcdifInit()
+*
+* Summary:
+*   Initialises the LCDIFPMP module and the PMP for first use
+*
+* See also:
+*   lcdifDeinit()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+* 1. The PMP starts with the longest wait states. Each LCD interface object
+*    puts in its own when it gets the bus
+*******************************************************************************/
+void lcdifInit(void)
+{
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
+                                        /* Currently no active LCDIF objects  */
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
+    pmpOwner = (HLCDIF) 0;
+                                        /* Set up the PMP in master mode 1    */
+                                        /* with no address lines in use yet   */
+    PMCON = 0;
+    PMMODE = LCDIF_PMMODE_MASTER1 | LCDIF_PMPWAITSTATES(3, 15, 3);
+    PMAEN = 0;
+    PMADDR = 0;
+    PMCON = LCDIF_PMCON_PTWREN | LCDIF_PMCON_PTRDEN | LCDIF_PMCON_WRSP |
+            LCDIF_PMCON_RDSP;
+    LCDIF_PMPON();
+}
+
+/*******************************************************************************
+* lcdifDeinit()
+*
+* Summary:
+*   Deinitialises the LCDIFPMP module after use and switches off the PMP
+*
+* See also:
+*   lcdifInit()
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   void
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   None
+*******************************************************************************/
+void lcdifDeinit(void)
+{
+    unsigned int slot;
+                                        /* Empty the LCDIF slot table         */
+    for (slot = 0; slot < LCDIF_MAXOBJECTS; slot++)
+    {
+        lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+    }
+                                        /* Currently no active LCDIF objects  */
+    for (slot = 0; slot < LCDIF_SLOTWORDS; slot++)
+    {
+        activeLcdIfObjects[slot] = 0;
+    }
+    pmpOwner = (HLCDIF) 0;
+#if defined(__PIC32MX__)
+                                        /* Abandon any frame being sent       */
+    T2CONCLR = LCDIF_T2CON_ON;
+    DCH0CONCLR = LCDIF_DCHCON_CHEN;
+    DCH1CONCLR = LCDIF_DCHCON_CHEN;
+#endif
+
+    PMCON = 0;
+    PMAEN = 0;
+}
+
+/*******************************************************************************
+* lcdifCreate()
+*
+* Summary:
+*   Creates an LCD interface for use by this module
+*
+* See also:
+*   lcdifDestroy()
+*
+* Arguments:
+*   lcdIfObj    - lcdif object to enter in the slot table
+*
+* Returns:
+*   - 1 to LCDIF_MAXOBJECTS
+*                       - number the LCD interface has been assigned if it was
+*                         possible to allocate it
+*   - 0                 - if the LCD interface allocation failed
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   1. lcdifInit() must have been called prior to calling this function
+*   2. The number assigned is the object's slot in the slot table plus one,
+*      and is always the lowest one free
+*   3. The address lines used for RS and for selecting the display are
+*      switched over to the PMP
+*******************************************************************************/
+LCDIFNUM lcdifCreate(LCDIFOBJ * const lcdIfObj)
+{
+    unsigned int slot;                  /* Slot allocated to this object      */
+                                        /* Check we got an object to point to */
+    if (lcdIfObj != (LCDIFOBJ *) 0)
+    {
+                                        /* RS must be one address line that   */
+                                        /* isn't used to select the display   */
+        if (lcdIfObj->rsAddress == 0 ||
+            (lcdIfObj->rsAddress & (lcdIfObj->rsAddress - 1)) != 0 ||
+            (lcdIfObj->rsAddress & lcdIfObj->selectAddress) != 0)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Only the wait state fields may be  */
+                                        /* set                                */
+        if (lcdIfObj->waitStates & ~LCDIF_PMMODE_WAITS)
+        {
+            goto cannot_create_if;
+        }
+                                        /* Find a free slot, if we haven't    */
+                                        /* allocated all the LCD interface    */
+                                        /* objects we can support             */
+        slot = findFreeLcdIfSlot();
+        if (slot >= LCDIF_MAXOBJECTS)
+        {
+            goto cannot_create_if;
+        }
+        activeLcdIfObjects[slot / 32] |= 1ul << (slot % 32);
+        lcdIfSlots[slot] = lcdIfObj;
+                                        /* Assign the interface number        */
+        lcdIfObj->lcdIfNum = slot + 1;
+                                        /* Clear the object's flags           */
+        lcdIfObj->lcdIfFlags = 0;
+                                        /* Hand the address lines to the PMP  */
+        PMAEN |= lcdIfObj->rsAddress | lcdIfObj->selectAddress;
+
+        return lcdIfObj->lcdIfNum;
+    }
+cannot_create_if:
+                                        /* Couldn't create interface          */
+    return 0;
+}
+
+/*******************************************************************************
+* lcdifDestroy()
+*
+* Summary:
+*   Destroys a previously created LCD interface object
+*
+* See also:
+*   lcdifCreate()
+*
+* Arguments:
+*   lcdIfNumber - number of the LCD interface object to destroy
+*
+* Returns:
+*   - 1   - LCD interface was successfully destroyed
+*   - 0   - couldn't detroy requested LCD interface - probably still open
+*
+* Callers:
+*   Main application code
+*
+* Notes :
+*   1. lcdifCreate() must have been called prior to calling this function
+*   2. The address lines are left with the PMP, as other objects may share
+*      them
+*******************************************************************************/
+unsigned char lcdifDestroy(LCDIFNUM lcdIfNumber)
+{
+    unsigned int slot;                  /* Slot holding the object            */
+
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
+    {
+        slot = lcdIfNumber - 1;
+                                        /* If the slot holds an object that   */
+                                        /* is not open, simply remove it      */
+        if (lcdIfSlots[slot] != (LCDIFOBJ *) 0 &&
+            !(lcdIfSlots[slot]->lcdIfFlags & LCDIF_OPEN))
+        {
+            lcdIfSlots[slot] = (LCDIFOBJ *) 0;
+                                        /* Also note that we have one less    */
+                                        /* active LCD interface               */
+            activeLcdIfObjects[slot / 32] &= ~(1ul << (slot % 32));
+            return 1;
+        }
+    }
+                                        /* Couldn't destroy interface         */
+    return 0;
+}
+
+/*******************************************************************************
+* lcdifOpen()
+*
+* Summary:
+*   Opens an LCD interface for use by caller and initialises an HLCDIF
+*   handle to it
+*
+* See also:
+*   lcdifClose()
+*
+* Arguments:
+*   lcdIfNumber     - number of an existing LCD interface object to use
+*
+* Returns:
+*   - NULL          - if LCD interface couldn't be opened
+*   - handle        - if LCD interface was opened properly
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have created (lcdifCreate) at least one LCD interface object
+*    before calling this function
+*******************************************************************************/
+HLCDIF lcdifOpen(LCDIFNUM lcdIfNumber)
+{
+    LCDIFOBJ * localLcdIfObj;           /* Object in the requested slot       */
+
+                                        /* Check the number could have been   */
+                                        /* issued                             */
+    if (lcdIfNumber != 0 && lcdIfNumber <= LCDIF_MAXOBJECTS)
+    {
+        localLcdIfObj = lcdIfSlots[lcdIfNumber - 1];
+                                        /* Check there is an object in the    */
+                                        /* slot that is not already open      */
+        if (localLcdIfObj != (LCDIFOBJ *) 0 &&
+            !(localLcdIfObj->lcdIfFlags & LCDIF_OPEN))
+        {
+                                        /* Note that it is now in use         */
+            localLcdIfObj->lcdIfFlags |= LCDIF_OPEN;
+                                        /* Return handle to it                */
+            return localLcdIfObj;
+        }
+    }
+                                        /* Return handle to NULL otherwise    */
+    return (LCDIFOBJ *) 0;
+}
+
+/*******************************************************************************
+* lcdifClose()
+*
+* Summary:
+*   Closes an LCD interface and releases the handle to it
+*
+* See also:
+*   lcdifOpen()
+*
+* Arguments:
+*   hLcdIf          - handle to the open buffer
+*
+* Returns:
+*   - >0            - number of LCD interface object if it was was open
+*   - 0             - if the LCD interface was not open
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+LCDIFNUM lcdifClose(HLCDIF const hLcdIf)
+{
+                                        /* Check LCD interface is actually    */
+                                        /* open                               */
+    if (hLcdIf->lcdIfFlags & LCDIF_OPEN)
+    {
+                                        /* Note that this LCD interface       */
+                                        /* object is closed                   */
+        hLcdIf->lcdIfFlags &= ~LCDIF_OPEN;
+                                        /* Return LCD interface object's      */
+                                        /* interface number                   */
+        return hLcdIf->lcdIfNum;
+    }
+                                        /* Otherwise return 0 to say that     */
+                                        /* buffer object wasn't open          */
+    return (LCDIFNUM) 0;
+}
+
+/*******************************************************************************
+* lcdifGetPb()
+*
+* Summary:
+*   Attempts to aquire the PMP for use by the LCD interface module, and sets
+*   it up with this LCD interface's wait states
+*
+* See also:
+*   lcdifReturnPb()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - 1             - this LCD interface (hLcdIf) owns the PMP
+*   - 0             - the PMP is currently in use by another LCD interface
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The PMP is only switched to this object's wait states once any cycle
+*    still running for the previous owner has finished
+* 3. Returns 0 while a frame is being sent for this LCD interface
+*******************************************************************************/
+unsigned char lcdifGetPb(HLCDIF const hLcdIf)
+{
+    if ((pmpOwner != (HLCDIF) 0 && pmpOwner != hLcdIf) ||
+        (hLcdIf->lcdIfFlags & LCDIF_FRAMEACTIVE))
+    {
+        return 0;
+    }
+    pmpOwner = hLcdIf;
+    hLcdIf->lcdIfFlags |= LCDIF_OWNPB;
+                                        /* Put in the wait states for this    */
+                                        /* display's controller               */
+    waitWhilePmpBusy();
+    PMMODE = (PMMODE & ~LCDIF_PMMODE_WAITS) | hLcdIf->waitStates;
+
+    return 1;
+}
+
+/*******************************************************************************
+* lcdifReturnPb()
+*
+* Summary:
+*   Returns the PMP for use by other LCD interfaces
+*
+* See also:
+*   lcdifGetPb()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   void
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. Does nothing while a frame is being sent for this LCD interface
+*******************************************************************************/
+void lcdifReturnPb(HLCDIF const hLcdIf)
+{
+    if (hLcdIf->lcdIfFlags & LCDIF_FRAMEACTIVE)
+    {
+        return;
+    }
+    if (pmpOwner == hLcdIf)
+    {
+        pmpOwner = (HLCDIF) 0;
+    }
+    hLcdIf->lcdIfFlags &= ~LCDIF_OWNPB;
+}
+
+/*******************************************************************************
+* lcdifWriteData()
+*
+* Summary:
+*   Writes data to the LCD interface
+*
+* See also:
+*   lcdifReadData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD write was started
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The PMP finishes the bus cycle on its own after this function returns
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifWriteData(HLCDIF const hLcdIf, unsigned char data)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writePmp(hLcdIf->selectAddress | hLcdIf->rsAddress, data);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadData()
+*
+* Summary:
+*   Reads data from the LCD interface. The data read will be the contents of a
+*   CGRAM address if the previous instruction set a CGRAM address. If the
+*   previous instruction set a DDRAM address, the DDRAM address will be read
+*
+* See also:
+*   lcdifWriteData()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   * data          - variable in which to store read data
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifReadData(HLCDIF const hLcdIf, unsigned char * const data)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        *data = readPmp(hLcdIf->selectAddress | hLcdIf->rsAddress);
+                                        /* Inform caller that read succeeded  */
+        return LCDIF_SUCCESS;
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteInstruction()
+*
+* Summary:
+*   Writes an instruction to the LCD interface
+*
+* See also:
+*   lcdifReadAddress()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instruction to write to the LCD interface
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD write was started
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The PMP finishes the bus cycle on its own after this function returns
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifWriteInstruction(HLCDIF const hLcdIf,
+                                    unsigned char instruction)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writePmp(hLcdIf->selectAddress, instruction);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadAddress()
+*
+* Summary:
+*   Reads address counter value and busy flag
+*
+* See also:
+*   lcdifWriteInstruction()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   * address       - variable in which to store read address value
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifReadAddress(HLCDIF const hLcdIf,
+                               unsigned char * const address)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        *address = readPmp(hLcdIf->selectAddress);
+                                        /* Inform caller that read succeeded  */
+        return LCDIF_SUCCESS;
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteDataBlock()
+*
+* Summary:
+*   Writes a block of data to the LCD interface. The PMP address is set up
+*   once for the whole block
+*
+* See also:
+*   lcdifWriteData(), lcdifWriteInstructionBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - data to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteDataBlock(HLCDIF const hLcdIf,
+                                  const unsigned char * data,
+                                  unsigned char length,
+                                  unsigned int (*pGetMicroseconds)(void),
+                                  unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writePmpBlock(hLcdIf->selectAddress | hLcdIf->rsAddress, data, length,
+                      pGetMicroseconds, interval);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifWriteInstructionBlock()
+*
+* Summary:
+*   Writes a block of instructions to the LCD interface. The PMP address is
+*   set up once for the whole block
+*
+* See also:
+*   lcdifWriteInstruction(), lcdifWriteDataBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - instructions to write to the LCD interface
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source used to pace the writes, or NULL to write
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD write completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. You must have called lcdifGetPb() successfully before calling this function
+*******************************************************************************/
+unsigned char lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                         const unsigned char * instruction,
+                                         unsigned char length,
+                                         unsigned int (*pGetMicroseconds)(void),
+                                         unsigned int interval)
+{
+                                        /* Check if we own the peripheral bus */
+    if (hLcdIf->lcdIfFlags & LCDIF_OWNPB)
+    {
+        writePmpBlock(hLcdIf->selectAddress, instruction, length,
+                      pGetMicroseconds, interval);
+                                        /* Inform caller that write succeeded */
+        return LCDIF_SUCCESS;
+    }
+                                        /* Inform caller that bus is busy     */
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifReadDataBlock()
+*
+* Summary:
+*   Reads a block of data from the LCD interface. Each read of PMDIN collects
+*   one byte and starts the PMP read cycle for the next
+*
+* See also:
+*   lcdifReadData(), lcdifWriteDataBlock()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   data            - place to store the data read
+*   length          - number of bytes to read
+*   pGetMicroseconds - time source used to pace the reads, or NULL to read
+*                     them back to back
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the LCD read completed
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready for the first byte;
+*    the busy flag is not read during the block
+* 3. The PMP is switched off for the last byte so that no read cycle is
+*    started after it, as in readPmp()
+* 4. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifReadDataBlock(HLCDIF const hLcdIf,
+                                 unsigned char * data,
+                                 unsigned char length,
+                                 unsigned int (*pGetMicroseconds)(void),
+                                 unsigned int interval)
+{
+    unsigned char value;
+    unsigned int lastReadTime;
+                                        /* Check if we own the peripheral bus */
+    if (!(hLcdIf->lcdIfFlags & LCDIF_OWNPB))
+    {
+                                        /* Inform caller that bus is busy     */
+        return LCDIF_BUSY;
+    }
+
+    if (length)
+    {
+        waitWhilePmpBusy();
+        PMADDR = hLcdIf->selectAddress | hLcdIf->rsAddress;
+                                        /* Start the first read cycle         */
+        value = LCDIF_PMDIN;
+    }
+
+    while (length)
+    {
+        waitWhilePmpBusy();
+        length--;
+                                        /* Give the LCD controller time to    */
+                                        /* move its address counter on before */
+                                        /* the next read cycle                */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            lastReadTime = pGetMicroseconds();
+            while ((unsigned int) (pGetMicroseconds() - lastReadTime) <=
+                                                                    interval)
+            {
+                ;
+            }
+        }
+                                        /* Collect the byte read, starting    */
+                                        /* the next cycle unless it is the    */
+                                        /* last                               */
+        if (length)
+        {
+            value = LCDIF_PMDIN;
+        }
+        else
+        {
+            LCDIF_PMPOFF();
+            value = LCDIF_PMDIN;
+            LCDIF_PMPON();
+        }
+        *data = value;
+        data++;
+    }
+                                        /* Inform caller that read succeeded  */
+    return LCDIF_SUCCESS;
+}
+
+/*******************************************************************************
+* lcdif4BitFunctionSet()
+*
+* Summary:
+*   Would write a single 4-bit instruction to the LCD interface during the
+*   "Initialising by Instruction" sequence of a 4-bit bus. The PMP bus is
+*   always 8 bits wide, so this is never needed
+*
+* See also:
+*   lcdifGetPbBusWidth()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   instruction     - not used
+*
+* Returns:
+*   - LCDIF_BUSY    - always
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. lcdifGetPbBusWidth() always returns BUS8BITSWIDE, so the HD44780 module
+*    never calls this function
+*******************************************************************************/
+unsigned char lcdif4BitFunctionSet(HLCDIF const hLcdIf,
+                                   unsigned char instruction)
+{
+    (void) hLcdIf;
+    (void) instruction;
+
+    return LCDIF_BUSY;
+}
+
+/*******************************************************************************
+* lcdifGetPbBusWidth()
+*
+* Summary:
+*   Returns the width of the parallel data bus. This is necessary so that the
+*   upper layer can correctly issue the "Initialising by Instruction" sequence
+*   which is different depending on the data bus width in use
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - BUS8BITSWIDE      - always, as the PMP is used with an 8-bit bus
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+unsigned char lcdifGetPbBusWidth(HLCDIF const hLcdIf)
+{
+    (void) hLcdIf;
+
+    return BUS8BITSWIDE;
+}
+
+/*******************************************************************************
+* lcdifFixNibbleSwap()
+*
+* Summary:
+*   Provided for compatibility with the GPIO LCD interface modules. Nibbles
+*   can only be swapped on a 4-bit bus, so with the PMP this is just noted
+*
+* See also:
+*   None
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   None
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+*******************************************************************************/
+void lcdifFixNibbleSwap(HLCDIF const hLcdIf)
+{
+    hLcdIf->lcdIfFlags |= LCDIF_FIXNIBBLESWAP;
+}
+
+#if defined(__PIC32MX__)
+/*******************************************************************************
+* lcdifClearFrame()
+*
+* Summary:
+*   Empties a frame so that it can be filled again
+*
+* See also:
+*   lcdifAddFrameInstruction(), lcdifAddFrameData()
+*
+* Arguments:
+*   frame           - frame to empty
+*
+* Returns:
+*   None
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. The frame must not be cleared while it is being sent
+*******************************************************************************/
+void lcdifClearFrame(LCDIFFRAME * const frame)
+{
+    frame->length = 0;
+}
+
+/*******************************************************************************
+* lcdifAddFrameInstruction()
+*
+* Summary:
+*   Adds an instruction to the end of a frame
+*
+* See also:
+*   lcdifAddFrameData(), lcdifWriteFrame()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface that is to get the
+*                     instruction
+*   frame           - frame to add to
+*   instruction     - instruction to add
+*
+* Returns:
+*   - 1             - instruction added
+*   - 0             - frame is full
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Every entry of a frame is paced by the same interval, so instructions
+*    that take longer than a data write, such as clear display, should be
+*    written with lcdifWriteInstruction() instead
+*******************************************************************************/
+unsigned char lcdifAddFrameInstruction(HLCDIF const hLcdIf,
+                                       LCDIFFRAME * const frame,
+                                       unsigned char instruction)
+{
+    if (frame->length >= LCDIF_FRAMESIZE)
+    {
+        return 0;
+    }
+
+    frame->address[frame->length] = (unsigned short) hLcdIf->selectAddress;
+    frame->data[frame->length] = instruction;
+    frame->length++;
+
+    return 1;
+}
+
+/*******************************************************************************
+* lcdifAddFrameData()
+*
+* Summary:
+*   Adds a block of data bytes to the end of a frame
+*
+* See also:
+*   lcdifAddFrameInstruction(), lcdifWriteFrame()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface that is to get the
+*                     data
+*   frame           - frame to add to
+*   data            - data bytes to add
+*   length          - number of bytes to add
+*
+* Returns:
+*   - 1             - data added
+*   - 0             - not enough room left in the frame; nothing was added
+*
+* Callers:
+*   User application
+*
+* Notes :
+*   None
+*******************************************************************************/
+unsigned char lcdifAddFrameData(HLCDIF const hLcdIf,
+                                LCDIFFRAME * const frame,
+                                const unsigned char * data,
+                                unsigned char length)
+{
+    unsigned short address;
+
+    if (length > LCDIF_FRAMESIZE - frame->length)
+    {
+        return 0;
+    }
+
+    address = (unsigned short) (hLcdIf->selectAddress | hLcdIf->rsAddress);
+    while (length)
+    {
+        frame->address[frame->length] = address;
+        frame->data[frame->length] = *data;
+        frame->length++;
+        data++;
+        length--;
+    }
+
+    return 1;
+}
+
+/*******************************************************************************
+* lcdifWriteFrame()
+*
+* Summary:
+*   Starts sending a frame with DMA. Timer 2 paces the PMP writes and the CPU
+*   is free until the frame has been sent
+*
+* See also:
+*   lcdifIsFrameDone()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*   frame           - frame to send
+*   interval        - microseconds from the start of one write to the start
+*                     of the next, which must cover the execution time of the
+*                     LCD controller in use
+*
+* Returns:
+*   - LCDIF_BUSY    - if the PMP is in use
+*   - LCDIF_SUCCESS - if the frame was started
+*
+* Callers:
+*   User application
+*
+* Notes :
+* 1. Caller must have 'created' at least one LCD interface object before
+*    calling this function
+* 2. The caller must make sure the LCD controller is ready; the first write is
+*    made one interval after this function returns
+* 3. The frame must be left as it is until lcdifIsFrameDone() returns 1.
+*    Until then the other functions of this LCD interface return LCDIF_BUSY
+* 4. The interval is rounded up to a whole number of Timer 2 counts, using
+*    the smallest prescale that gives a 16-bit period
+* 5. You must have called lcdifGetPb() successfully before calling this function
+*    to use it. If you didn't this function will return LCDIF_BUSY.
+*******************************************************************************/
+unsigned char lcdifWriteFrame(HLCDIF const hLcdIf,
+                              const LCDIFFRAME * const frame,
+                              unsigned int interval)
+{
+    unsigned long   ticks;
+    unsigned long   period;
+    unsigned char   prescale;
+                                        /* Check if we own the peripheral bus */
+    if (!(hLcdIf->lcdIfFlags & LCDIF_OWNPB))
+    {
+        return LCDIF_BUSY;
+    }
+    if (frame->length == 0)
+    {
+        return LCDIF_SUCCESS;
+    }
+                                        /* Find the timer period              */
+    ticks = (unsigned long) interval * LCDIF_PBCLOCKMHZ;
+    for (prescale = 0; prescale < 7; prescale++)
+    {
+        if ((ticks >> timerPrescaleShifts[prescale]) < 0x10000)
+        {
+            break;
+        }
+    }
+    period = (ticks + (1UL << timerPrescaleShifts[prescale]) - 1) >>
+                                            timerPrescaleShifts[prescale];
+    if (period == 0)
+    {
+        period = 1;
+    }
+    else if (period > 0x10000)
+    {
+        period = 0x10000;
+    }
+
+    waitWhilePmpBusy();
+    T2CON = 0;
+    TMR2 = 0;
+    PR2 = (unsigned int) (period - 1);
+    T2CON = (unsigned int) prescale << LCDIF_T2CON_TCKPS;
+                                        /* Channel 0 copies a PMADDR value on */
+                                        /* each timer period match            */
+    DMACONSET = LCDIF_DMACON_ON;
+    DCH0CON = 0;
+    DCH0ECON = (_TIMER_2_IRQ << 8) | LCDIF_DCHECON_SIRQEN;
+    DCH0SSA = KVA_TO_PA(frame->address);
+    DCH0DSA = KVA_TO_PA(&PMADDR);
+    DCH0SSIZ = frame->length * sizeof(frame->address[0]);
+    DCH0DSIZ = sizeof(frame->address[0]);
+    DCH0CSIZ = sizeof(frame->address[0]);
+    DCH0INT = LCDIF_DCHINT_CHCCIE;
+                                        /* Channel 1 then copies the byte to  */
+                                        /* PMDIN, making the write cycle      */
+    DCH1CON = 0;
+    DCH1ECON = (_DMA0_IRQ << 8) | LCDIF_DCHECON_SIRQEN;
+    DCH1SSA = KVA_TO_PA(frame->data);
+    DCH1DSA = KVA_TO_PA(&LCDIF_PMDIN);
+    DCH1SSIZ = frame->length;
+    DCH1DSIZ = 1;
+    DCH1CSIZ = 1;
+    DCH1INT = 0;
+
+    DCH0CONSET = LCDIF_DCHCON_CHEN;
+    DCH1CONSET = LCDIF_DCHCON_CHEN;
+                                        /* Keep the PMP but stop this LCD     */
+                                        /* interface using it meanwhile       */
+    hLcdIf->lcdIfFlags = (hLcdIf->lcdIfFlags & ~LCDIF_OWNPB) |
+                         LCDIF_FRAMEACTIVE;
+    T2CONSET = LCDIF_T2CON_ON;
+
+    return LCDIF_SUCCESS;
+}
+
+/*******************************************************************************
+* lcdifIsFrameDone()
+*
+* Summary:
+*   Checks whether the frame started by lcdifWriteFrame() has been sent, and
+*   if so gives the PMP back to this LCD interface
+*
+* See also:
+*   lcdifWriteFrame()
+*
+* Arguments:
+*   hLcdIf          - handle to the open LCD interface
+*
+* Returns:
+*   - 1             - no frame is being sent
+*   - 0             - the frame is still being sent
+*
+* Callers:
+*   User application, or its DMA channel 1 interrupt service routine
+*
+* Notes :
+* 1. Channel 1 sets its block done flag when it has started the last write.
+*    The LCD controller then still needs its execution time, so poll the
+*    busy flag before the next access, as after lcdifWriteDataBlock()
+*******************************************************************************/
+unsigned char lcdifIsFrameDone(HLCDIF const hLcdIf)
+{
+    if (!(hLcdIf->lcdIfFlags & LCDIF_FRAMEACTIVE))
+    {
+        return 1;
+    }
+    if (!(DCH1INT & LCDIF_DCHINT_CHBCIF))
+    {
+        return 0;
+    }
+                                        /* Frame sent: stop pacing and take   */
+                                        /* the PMP back                       */
+    T2CONCLR = LCDIF_T2CON_ON;
+    DCH0INTCLR = LCDIF_DCHINT_FLAGS;
+    DCH1INTCLR = LCDIF_DCHINT_FLAGS;
+    hLcdIf->lcdIfFlags = (hLcdIf->lcdIfFlags & ~LCDIF_FRAMEACTIVE) |
+                         LCDIF_OWNPB;
+
+    return 1;
+}
+#endif
+
+/*******************************************************************************
+* findFreeLcdIfSlot() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Finds the lowest free slot in the LCD interface slot table. This function
+* is private to the LCDIFPMP module.
+*
+* See also:
+*   None
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   - 0 to LCDIF_MAXOBJECTS - 1
+*                   - lowest free slot
+*   - LCDIF_MAXOBJECTS
+*                   - all slots are in use
+*
+* Callers:
+*   lcdifCreate()
+*
+* Notes :
+* 1. The bitmap words are unsigned long so that they hold 32 slots with C30
+*    as well as C32
+*******************************************************************************/
+static unsigned int findFreeLcdIfSlot(void)
+{
+    unsigned int word;                  /* Bitmap word being checked          */
+    unsigned int slot;                  /* Free slot found                    */
+    unsigned long freeSlots;            /* Set bits mark free slots           */
+
+    for (word = 0; word < LCDIF_SLOTWORDS; word++)
+    {
+        freeSlots = ~activeLcdIfObjects[word];
+        if (freeSlots != 0)
+        {
+                                        /* Find the lowest free slot's bit    */
+            for (slot = 0; !(freeSlots & 0x01); freeSlots >>= 1)
+            {
+                slot++;
+            }
+            slot += word * 32;
+                                        /* The last word may have bits beyond */
+                                        /* the end of the table               */
+            if (slot < LCDIF_MAXOBJECTS)
+            {
+                return slot;
+            }
+            break;
+        }
+    }
+
+    return LCDIF_MAXOBJECTS;
+}
+
+/*******************************************************************************
+* waitWhilePmpBusy() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Waits for the PMP to finish the bus cycle it is making. This function is
+*   private to the LCDIFPMP module.
+*
+* See also:
+*   None
+*
+* Arguments:
+*   None
+*
+* Returns:
+*   None
+*
+* Callers:
+*   lcdifGetPb(), writePmp(), readPmp(), writePmpBlock(), lcdifWriteFrame()
+*
+* Notes :
+* 1. A cycle lasts at most 24 peripheral bus clocks
+*******************************************************************************/
+static void waitWhilePmpBusy(void)
+{
+    while (PMMODE & LCDIF_PMMODE_BUSY)
+    {
+        ;
+    }
+}
+
+/*******************************************************************************
+* writePmp() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Starts a PMP write cycle. This function is private to the LCDIFPMP module.
+*
+* See also:
+*   readPmp()
+*
+* Arguments:
+*   address         - PMADDR value, selecting the display and setting RS
+*   value           - byte to write
+*
+* Returns:
+*   None
+*
+* Callers:
+*   lcdifWriteData(), lcdifWriteInstruction()
+*
+* Notes :
+* 1. PMADDR may only be changed when the PMP is not busy
+*******************************************************************************/
+static void writePmp(unsigned int address, unsigned char value)
+{
+    waitWhilePmpBusy();
+    PMADDR = address;
+    LCDIF_PMDIN = value;
+}
+
+/*******************************************************************************
+* readPmp() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Makes one PMP read cycle and returns the byte read. This function is
+*   private to the LCDIFPMP module.
+*
+* See also:
+*   writePmp()
+*
+* Arguments:
+*   address         - PMADDR value, selecting the display and setting RS
+*
+* Returns:
+*   Byte read
+*
+* Callers:
+*   lcdifReadData(), lcdifReadAddress()
+*
+* Notes :
+* 1. The first read of PMDIN only starts the cycle. The PMP is switched off
+*    for the second so that it returns the byte read without starting another
+*    cycle, which would move the HD44780's address counter on
+*******************************************************************************/
+static unsigned char readPmp(unsigned int address)
+{
+    unsigned char value;
+
+    waitWhilePmpBusy();
+    PMADDR = address;
+                                        /* Start the read cycle               */
+    value = LCDIF_PMDIN;
+    waitWhilePmpBusy();
+                                        /* Collect the byte read              */
+    LCDIF_PMPOFF();
+    value = LCDIF_PMDIN;
+    LCDIF_PMPON();
+
+    return value;
+}
+
+/*******************************************************************************
+* writePmpBlock() --PRIVATE FUNCTION--
+*
+* Summary:
+*   Writes a block of bytes with the PMP, pacing them with the time source
+*   given. This function is private to the LCDIFPMP module.
+*
+* See also:
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Arguments:
+*   address         - PMADDR value, selecting the display and setting RS
+*   data            - bytes to write
+*   length          - number of bytes to write
+*   pGetMicroseconds - time source, or NULL
+*   interval        - microseconds to leave between each byte
+*
+* Returns:
+*   None
+*
+* Callers:
+*   lcdifWriteDataBlock(), lcdifWriteInstructionBlock()
+*
+* Notes :
+* 1. The wait is for more than interval, covering the time source's resolution
+*******************************************************************************/
+static void writePmpBlock(unsigned int address, const unsigned char * data,
+                          unsigned char length,
+                          unsigned int (*pGetMicroseconds)(void),
+                          unsigned int interval)
+{
+    unsigned int lastWriteTime;
+
+    waitWhilePmpBusy();
+    PMADDR = address;
+
+    while (length)
+    {
+        waitWhilePmpBusy();
+        LCDIF_PMDIN = *data;
+        data++;
+        length--;
+                                        /* Give the LCD controller time to    */
+                                        /* execute before the next byte       */
+        if (length && pGetMicroseconds != (unsigned int (*)(void)) 0)
+        {
+            lastWriteTime = pGetMicroseconds();
+            while ((unsigned int) (pGetMicroseconds() - lastWriteTime) <=
+                                                                    interval)
+            {
+                ;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+*
+*                               LCDIFPMP MODULE END
+*
+*******************************************************************************/
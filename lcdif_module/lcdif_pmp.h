@@ -0,0 +1,296 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR THE PARALLEL MASTER PORT
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This file provides the necessary information required to create an LCD
+* interface for use with the HD44780 module using the Parallel Master Port
+* (PMP) peripheral of the PIC24, dsPIC33 and PIC32 instead of bit-banged GPIO
+* pins. The PMP generates the E strobe and R/W level itself, and one of its
+* address lines drives RS. It replaces lcdif_<compiler>.c; define LCDIF_PMP
+* on the compiler command line so that the HD44780 module includes this file.
+* On the PIC32 a whole frame of instructions and data can also be handed to
+* two DMA channels, paced by Timer 2, so that the CPU is only needed again once
+* the frame has been sent.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : lcdif_pmp.h
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* See the lcdif_pmp.c file for the version changes and notes for this module
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                                LCDIFPMP MODULE
+*
+*******************************************************************************/
+
+#ifndef __LCDIF_MODULE_PRESENT__
+#define __LCDIF_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+                                    /******************************************/
+                                    /* Microchip C32 compiler                 */
+                                    /******************************************/
+#if defined(__PIC32MX__)
+#include <p32xxxx.h>
+#include <sys/kmem.h>
+                                    /******************************************/
+                                    /* Microchip C30 compiler                 */
+                                    /******************************************/
+#elif defined(__C30)
+#if defined(__PIC24F__)
+#include <p24Fxxxx.h>
+#elif defined(__PIC24H__)
+#include <p24Hxxxx.h>
+#elif defined(__dsPIC33F__)
+#include <p33Fxxxx.h>
+#endif
+#endif
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Maximum number of LCD interface objects that can be created at the same
+* time. Define it on the compiler command line to use a different capacity
+*******************************************************************************/
+#ifndef LCDIF_MAXOBJECTS
+#define LCDIF_MAXOBJECTS    16
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Largest number of instructions and data bytes in one DMA frame. The
+* default holds all 80 characters of a 20x4 or 40x2 display plus a set DDRAM
+* address instruction for each line. PIC32 only
+*******************************************************************************/
+#ifndef LCDIF_FRAMESIZE
+#define LCDIF_FRAMESIZE     84
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Peripheral bus clock in MHz, used to set the Timer 2 period that paces a
+* DMA frame. Define it on the compiler command line to match the target.
+* PIC32 only
+*******************************************************************************/
+#ifndef LCDIF_PBCLOCKMHZ
+#define LCDIF_PBCLOCKMHZ    20
+#endif
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   This is used by the lcdifGetBusWidth function to tell upper layer the width
+* of the data bus. This is required for the "Initialising by Instruction"
+* process
+*******************************************************************************/
+#define     BUS4BITSWIDE    0
+#define     BUS8BITSWIDE    1
+
+/*******************************************************************************
+* Summary:
+*   PMADDR bits for the PMP address lines PMA0 and PMA1 (usual choices for
+* RS) and PMA14 and PMA15 (usual choices for selecting one of two displays)
+*******************************************************************************/
+#define     LCDIF_PMA0      0x0001
+#define     LCDIF_PMA1      0x0002
+#define     LCDIF_PMA14     0x4000
+#define     LCDIF_PMA15     0x8000
+
+/*******************************************************************************
+* Summary:
+*   Wait states that give an HD44780U its datasheet timing at VCC = 2.7 to
+* 4.5V (tAS 60ns, PWEH 450ns, tH 20ns) with a peripheral bus clock of up to
+* 32MHz. Slower clones need longer waits; above 32MHz, even 16 clocks are
+* too short for the E pulse of an HD44780U at these voltages
+*******************************************************************************/
+#define     LCDIF_PMPWAIT_HD44780U  LCDIF_PMPWAITSTATES(1, 15, 0)
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type LCDIFNUM
+* Description:
+*   Used to hold the LCD interface number issued by the LCD IF Module
+*******************************************************************************/
+typedef unsigned int LCDIFNUM;
+
+/*******************************************************************************
+* New data type LCDIFOBJTYPE
+* Description:
+*   Holds the object information for each LCD interface object created. The
+* user fills in:
+* - The PMADDR bits that must be set to reach this display, or 0 if the E pin
+*   is driven straight from PMENB. With two displays, each E is PMENB gated
+*   with its own address line
+* - The PMADDR bit whose address line drives RS
+* - The PMP wait states for this display's controller, made with
+*   LCDIF_PMPWAITSTATES()
+* The remaining members are private to the module.
+*******************************************************************************/
+typedef struct LCDIFOBJTYPE {
+    unsigned int                    selectAddress;
+    unsigned int                    rsAddress;
+    unsigned int                    waitStates;
+    LCDIFNUM                        lcdIfNum;
+    unsigned char                   lcdIfFlags;
+} LCDIFOBJ;
+
+/*******************************************************************************
+* New data type HLCDIF
+* Description:
+*   Holds a pointer to an LCDIF object
+*******************************************************************************/
+typedef LCDIFOBJ * HLCDIF;
+
+#if defined(__PIC32MX__)
+/*******************************************************************************
+* New data type LCDIFFRAME
+* Description:
+*   A prepared sequence of instructions and data bytes for lcdifWriteFrame().
+* Entry n is sent as a PMP write of data[n] with PMADDR set to address[n], so
+* one DMA channel can feed PMADDR and a second PMDIN. Fill it with
+* lcdifClearFrame(), lcdifAddFrameInstruction() and lcdifAddFrameData() only.
+*******************************************************************************/
+typedef struct LCDIFFRAMETYPE {
+    unsigned short                  address[LCDIF_FRAMESIZE];
+    unsigned char                   data[LCDIF_FRAMESIZE];
+    unsigned char                   length;
+} LCDIFFRAME;
+#endif
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Builds the waitStates member of an LCDIFOBJ. Each argument is the number
+* of peripheral bus clocks minus one: waitB (0 to 3) before the strobe, so RS
+* is set up, waitM (0 to 15) for the strobe itself, so the E pulse is wide
+* enough, and waitE (0 to 3) after it, so data is held
+*******************************************************************************/
+#define LCDIF_PMPWAITSTATES(waitB, waitM, waitE)                               \
+                    ((((waitB) & 0x03) << 6) | (((waitM) & 0x0F) << 2) |       \
+                     ((waitE) & 0x03))
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            lcdifInit(void);
+void            lcdifDeinit(void);
+
+LCDIFNUM        lcdifCreate(LCDIFOBJ            * const lcdIfObj);
+unsigned char   lcdifDestroy(LCDIFNUM                   lcdIfNumber);
+
+HLCDIF          lcdifOpen(LCDIFNUM                      lcdIfNumber);
+LCDIFNUM        lcdifClose(HLCDIF                 const hLcdIf);
+
+unsigned char   lcdifGetPb(HLCDIF                 const hLcdIf);
+void            lcdifReturnPb(HLCDIF              const hLcdIf);
+
+unsigned char   lcdifWriteData(HLCDIF             const hLcdIf,
+                               unsigned char            data);
+unsigned char   lcdifReadData(HLCDIF              const hLcdIf,
+                              unsigned char     * const data);
+
+unsigned char   lcdifWriteInstruction(HLCDIF      const hLcdIf,
+                                      unsigned char     instruction);
+unsigned char   lcdifReadAddress(HLCDIF           const hLcdIf,
+                                 unsigned char  * const address);
+
+unsigned char   lcdifWriteDataBlock(HLCDIF        const hLcdIf,
+                                    const unsigned char * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                    const unsigned char * instruction,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifReadDataBlock(HLCDIF         const hLcdIf,
+                                    unsigned char     * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+
+unsigned char   lcdif4BitFunctionSet(HLCDIF       const hLcdIf,
+                                      unsigned char     instruction);
+
+unsigned char   lcdifGetPbBusWidth(HLCDIF         const hLcdIf);
+
+void            lcdifFixNibbleSwap(HLCDIF         const hLcdIf);
+
+#if defined(__PIC32MX__)
+void            lcdifClearFrame(LCDIFFRAME        * const frame);
+unsigned char   lcdifAddFrameInstruction(HLCDIF   const hLcdIf,
+                                    LCDIFFRAME          * const frame,
+                                    unsigned char       instruction);
+unsigned char   lcdifAddFrameData(HLCDIF          const hLcdIf,
+                                    LCDIFFRAME          * const frame,
+                                    const unsigned char * data,
+                                    unsigned char       length);
+unsigned char   lcdifWriteFrame(HLCDIF            const hLcdIf,
+                                const LCDIFFRAME  * const frame,
+                                unsigned int            interval);
+unsigned char   lcdifIsFrameDone(HLCDIF           const hLcdIf);
+#endif
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+#if !defined(__PIC32MX__) && !defined(__C30)
+#error This module requires a PIC24, dsPIC33 or PIC32 with a PMP peripheral.
+#endif
+
+#if LCDIF_MAXOBJECTS < 1
+#error LCDIF_MAXOBJECTS must be at least 1
+#endif
+
+#if defined(__PIC32MX__) && (LCDIF_FRAMESIZE < 1 || LCDIF_FRAMESIZE > 128)
+#error LCDIF_FRAMESIZE must be between 1 and 128, as the DMA channel feeding
+#error PMADDR can move at most 256 bytes per block
+#endif
+
+
+/*******************************************************************************
+*
+*                              LCDIFPMP MODULE END
+*
+*******************************************************************************/
+#endif
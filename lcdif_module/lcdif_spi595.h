@@ -0,0 +1,217 @@
+/*******************************************************************************
+*
+* LCD INTERFACE MODULE FOR A 74HC595 SHIFT REGISTER ON SPI
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+* This file provides the necessary information required to create an LCD
+* interface for use with the HD44780 module where the display is driven from
+* the outputs of a 74HC595 shift register loaded over SPI. It replaces
+* lcdif_<compiler>.c; define LCDIF_SPI595 on the compiler command line so that
+* the HD44780 module includes this file. The module uses no registers itself,
+* so it builds with any of the supported compilers.
+* All contents within this file are 'public' and to be used by end user
+*
+* Filename : lcdif_spi595.h
+* Version : V0.01
+* Programmer(s) : Stuart Cording aka. CODINGHEAD
+*
+********************************************************************************
+* Note(s) :
+* See the lcdif_spi595.c file for the version changes and notes for this module
+*
+*******************************************************************************/
+
+/*******************************************************************************
+*
+*                               LCDIFSPI595 MODULE
+*
+*******************************************************************************/
+
+#ifndef __LCDIF_MODULE_PRESENT__
+#define __LCDIF_MODULE_PRESENT__
+
+/*******************************************************************************
+*                                 INCLUDE FILES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    EXTERNS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                             DEFAULT CONFIGURATION
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   Maximum number of LCD interface objects that can be created at the same
+* time. Define it on the compiler command line to use a different capacity
+*******************************************************************************/
+#ifndef LCDIF_MAXOBJECTS
+#define LCDIF_MAXOBJECTS    16
+#endif
+
+/*******************************************************************************
+* Summary:
+*   Size of the buffer in which block writes are packed before being handed to
+* the SPI write function. A block that doesn't fit is sent as several bursts
+*******************************************************************************/
+#ifndef LCDIF_SPIBURSTSIZE
+#define LCDIF_SPIBURSTSIZE  128
+#endif
+
+
+/*******************************************************************************
+*                                    DEFINES
+*******************************************************************************/
+
+/*******************************************************************************
+* Summary:
+*   This is used by the lcdifGetBusWidth function to tell upper layer the width
+* of the data bus. This is required for the "Initialising by Instruction"
+* process
+*******************************************************************************/
+#define     BUS4BITSWIDE    0
+#define     BUS8BITSWIDE    1
+
+/*******************************************************************************
+* Summary:
+*   Fastest SPI clock in kHz at which one byte per output change still gives
+* an HD44780U its datasheet E timing (PWEH 230ns, tcycE 500ns with two bytes
+* per E cycle). lcdifCreate() refuses objects with a faster spiClockKHz
+*******************************************************************************/
+#define     LCDIF_SPIMAXCLOCKKHZ    32000
+
+
+/*******************************************************************************
+*                                   DATA TYPES
+*******************************************************************************/
+
+/*******************************************************************************
+* New data type LCDIFNUM
+* Description:
+*   Used to hold the LCD interface number issued by the LCD IF Module
+*******************************************************************************/
+typedef unsigned int LCDIFNUM;
+
+/*******************************************************************************
+* New data type LCDIFOBJTYPE
+* Description:
+*   Holds the object information for each LCD interface object created. The
+* display's R/W pin is tied low and DB7 to DB4 are used. The user fills in:
+* - A function that sends a burst of bytes over SPI, most significant bit
+*   first, and pulses the 74HC595's RCLK after every byte (usually by wiring
+*   RCLK to a slave select the SPI peripheral pulses between bytes). It must
+*   not return until the last byte has been latched
+* - The output numbers (QA = 0 to QH = 7) of the 74HC595 wired to RS and E
+* - The output number to which DB4 is wired; DB5 to DB7 follow on the next 3
+*   outputs
+* - A mask of any other outputs to hold high, such as a backlight
+* - The SPI clock in kHz, so that block writes can be paced with padding
+*   bytes in a single burst, or 0 to pace them with the time source instead
+* The remaining members are private to the module.
+*******************************************************************************/
+typedef struct LCDIFOBJTYPE {
+    void                         (* pSpiWrite)(const unsigned char * data,
+                                               unsigned int length);
+    unsigned char                   RS_BIT;
+    unsigned char                   E_BIT;
+    unsigned char                   DATA_SHIFT;
+    unsigned char                   OTHER_BITS;
+    unsigned int                    spiClockKHz;
+    LCDIFNUM                        lcdIfNum;
+    unsigned char                   lcdIfFlags;
+    unsigned char                   lastOutputs;
+} LCDIFOBJ;
+
+/*******************************************************************************
+* New data type HLCDIF
+* Description:
+*   Holds a pointer to an LCDIF object
+*******************************************************************************/
+typedef LCDIFOBJ * HLCDIF;
+
+
+/*******************************************************************************
+*                                GLOBAL VARIABLES
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                                    MACROS
+*******************************************************************************/
+
+
+/*******************************************************************************
+*                              FUNCTION PROTOTYPES
+*******************************************************************************/
+void            lcdifInit(void);
+void            lcdifDeinit(void);
+
+LCDIFNUM        lcdifCreate(LCDIFOBJ            * const lcdIfObj);
+unsigned char   lcdifDestroy(LCDIFNUM                   lcdIfNumber);
+
+HLCDIF          lcdifOpen(LCDIFNUM                      lcdIfNumber);
+LCDIFNUM        lcdifClose(HLCDIF                 const hLcdIf);
+
+unsigned char   lcdifGetPb(HLCDIF                 const hLcdIf);
+void            lcdifReturnPb(HLCDIF              const hLcdIf);
+
+unsigned char   lcdifWriteData(HLCDIF             const hLcdIf,
+                               unsigned char            data);
+unsigned char   lcdifReadData(HLCDIF              const hLcdIf,
+                              unsigned char     * const data);
+
+unsigned char   lcdifWriteInstruction(HLCDIF      const hLcdIf,
+                                      unsigned char     instruction);
+unsigned char   lcdifReadAddress(HLCDIF           const hLcdIf,
+                                 unsigned char  * const address);
+
+unsigned char   lcdifWriteDataBlock(HLCDIF        const hLcdIf,
+                                    const unsigned char * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifWriteInstructionBlock(HLCDIF const hLcdIf,
+                                    const unsigned char * instruction,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+unsigned char   lcdifReadDataBlock(HLCDIF         const hLcdIf,
+                                    unsigned char     * data,
+                                    unsigned char       length,
+                                    unsigned int (*pGetMicroseconds)(void),
+                                    unsigned int        interval);
+
+unsigned char   lcdif4BitFunctionSet(HLCDIF       const hLcdIf,
+                                      unsigned char     instruction);
+
+unsigned char   lcdifGetPbBusWidth(HLCDIF         const hLcdIf);
+
+void            lcdifFixNibbleSwap(HLCDIF         const hLcdIf);
+
+
+/*******************************************************************************
+*                              CONFIGURATION ERRORS
+*******************************************************************************/
+#if LCDIF_MAXOBJECTS < 1
+#error LCDIF_MAXOBJECTS must be at least 1
+#endif
+
+#if LCDIF_SPIBURSTSIZE < 8
+#error LCDIF_SPIBURSTSIZE must be at least 8, to hold one byte written to the
+#error display with its RS set-up byte
+#endif
+
+
+/*******************************************************************************
+*
+*                             LCDIFSPI595 MODULE END
+*
+*******************************************************************************/
+#endif
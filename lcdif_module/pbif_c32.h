@@ -56,6 +56,16 @@
 *                             DEFAULT CONFIGURATION
 *******************************************************************************/
 
+/*******************************************************************************
+* Summary:
+*   Set to 1 to have the LCDIF module note which LCD interface holds the bus
+* mutex and count how often the mutex was taken and how often it was found in
+* use. Set to 0 to save the RAM and the few instructions it costs per access
+*******************************************************************************/
+#ifndef PBIF_MUTEXSTATS
+#define PBIF_MUTEXSTATS     0
+#endif
+
 
 /*******************************************************************************
 *                                    DEFINES
@@ -81,6 +91,16 @@
 * - A mask of 4 or 8 bits to define which of the data pins from the GPIO port
 *   are connected to the LCD interface (must be consecutive)
 * - A mutex variable used by the LCDIF module only
+* When built with PBIF_MUTEXSTATS the LCDIF module also keeps, for reading by
+* the user:
+* - The LCD interface that holds the mutex, or NULL if it is free
+* - The number of times the mutex was taken
+* - The number of times the mutex was found in use by another interface
+* When the LCDIF module is built with LCDIF_ATOMICPINS it also needs:
+* - The LATSET and LATCLR registers for the R/W and RS pins
+* - The LATINV register for the data pins
+* - The TRISSET and TRISCLR registers for the data pins
+* These may be left unset otherwise.
 *******************************************************************************/
 typedef struct PBIFOBJTYPE {
     volatile unsigned int         * RW_LAT;
@@ -91,7 +111,19 @@ typedef struct PBIFOBJTYPE {
     volatile unsigned int         * DATA_PORT;
     volatile unsigned int         * DATA_TRIS;
     unsigned int                    DATA_MASK;
-    unsigned int                    mutex;
+    volatile unsigned int           mutex;
+#if PBIF_MUTEXSTATS
+    void                  * volatile mutexOwner;
+    unsigned int                    mutexTaken;
+    volatile unsigned int           mutexContended;
+#endif
+    volatile unsigned int         * RW_LATSET;
+    volatile unsigned int         * RW_LATCLR;
+    volatile unsigned int         * RS_LATSET;
+    volatile unsigned int         * RS_LATCLR;
+    volatile unsigned int         * DATA_LATINV;
+    volatile unsigned int         * DATA_TRISSET;
+    volatile unsigned int         * DATA_TRISCLR;
 } PBIFOBJ;
 
 /*******************************************************************************
@@ -101,10 +133,14 @@ typedef struct PBIFOBJTYPE {
 * It requires the following elements:
 * - The LAT register to which the E pin is connected
 * - The bit number to which the E pin is connected (counting up from 0)
+* - The LATSET and LATCLR registers for the E pin, needed only when the LCDIF
+*   module is built with LCDIF_ATOMICPINS
 *******************************************************************************/
 typedef struct PBIFLCDENOBJTYPE {
     volatile unsigned int         * E_LAT;
     unsigned int                    E_BIT;
+    volatile unsigned int         * E_LATSET;
+    volatile unsigned int         * E_LATCLR;
 } PBIFLCDENOBJ;
 
 